@@ -0,0 +1,153 @@
+# Turns an allocation trace captured off RTT up-channel 1 back into a timeline.
+#
+# Build with -DENABLE_ALLOCATION_TRACE=ON, then capture the channel to a file, e.g.:
+#   JLinkRTTLogger -Device R7S721020 -If JTAG -Speed 4000 -RTTChannel 1 trace.bin
+# and then:
+#   python contrib/debug/alloc_trace.py trace.bin [--elf build/Debug/deluge.elf] [--timeline out.csv]
+#
+# The layout of each entry is that of AllocationTraceEntry in src/deluge/memory/allocation_trace.h
+import argparse
+import collections
+import struct
+import subprocess
+import sys
+
+ENTRY = struct.Struct("<IIIIBBBB")
+
+EVENTS = ["alloc", "dealloc", "extend", "shorten", "steal", "lost", "relocate"]
+(ALLOC, DEALLOC, EXTEND, SHORTEN, STEAL, LOST, RELOCATE) = range(len(EVENTS))
+
+# Same order as AllocationTag and the memory regions
+TAGS = ["internal", "external", "stealable", "nonaudio", "slab", "temp"]
+REGIONS = ["ext", "int", "non"]
+
+SAMPLE_RATE = 44100
+
+
+def read_entries(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) % ENTRY.size:
+        print(
+            f"warning: {len(data) % ENTRY.size} trailing bytes ignored - capture cut off mid entry?",
+            file=sys.stderr,
+        )
+    for offset in range(0, len(data) - ENTRY.size + 1, ENTRY.size):
+        yield ENTRY.unpack_from(data, offset)
+
+
+def symbolize(elf, addresses):
+    if not elf or not addresses:
+        return {}
+    addresses = sorted(addresses)
+    try:
+        out = subprocess.run(
+            ["arm-none-eabi-addr2line", "-f", "-C", "-s", "-e", elf]
+            + [hex(a) for a in addresses],
+            capture_output=True,
+            text=True,
+            check=True,
+        ).stdout.split("\n")
+    except (OSError, subprocess.CalledProcessError) as e:
+        print(f"warning: couldn't symbolize: {e}", file=sys.stderr)
+        return {}
+    return {a: f"{out[i * 2]} ({out[i * 2 + 1]})" for i, a in enumerate(addresses)}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("trace", help="raw capture of RTT channel 1")
+    parser.add_argument("--elf", help="firmware .elf, to turn caller addresses into function names")
+    parser.add_argument("--timeline", help="write live bytes per region over time to this CSV")
+    parser.add_argument("--top", type=int, default=20, help="how many callers to list")
+    args = parser.parse_args()
+
+    live = {}  # address -> (size, region, tag, caller)
+    live_bytes = [0] * len(REGIONS)
+    peak_bytes = [0] * len(REGIONS)
+    peak_time = [0] * len(REGIONS)
+    event_counts = collections.Counter()
+    tag_counts = collections.Counter()
+    caller_allocs = collections.Counter()
+    caller_bytes = collections.Counter()
+    num_lost = 0
+    num_unmatched = 0
+    timeline = open(args.timeline, "w") if args.timeline else None
+    if timeline:
+        timeline.write("seconds," + ",".join(REGIONS) + "\n")
+
+    def forget(address):
+        nonlocal num_unmatched
+        old = live.pop(address, None)
+        if old is None:
+            num_unmatched += 1
+            return None
+        live_bytes[old[1]] -= old[0]
+        return old
+
+    def remember(address, size, region, tag, caller):
+        if address in live:
+            forget(address)
+        live[address] = (size, region, tag, caller)
+        live_bytes[region] += size
+
+    for time, address, size, caller, event, region, tag, _ in read_entries(args.trace):
+        if event >= len(EVENTS) or (event != LOST and region >= len(REGIONS)):
+            print(f"warning: garbage entry at t={time}, stopping", file=sys.stderr)
+            break
+        event_counts[event] += 1
+
+        if event == ALLOC:
+            remember(address, size, region, tag, caller)
+            tag_counts[tag] += 1
+            caller_allocs[caller] += 1
+            caller_bytes[caller] += size
+        elif event == DEALLOC:
+            forget(address)
+        elif event in (EXTEND, SHORTEN):
+            old = forget(address)
+            remember(address, size, region, old[2] if old else tag, old[3] if old else caller)
+        elif event == RELOCATE:
+            # Moved by compaction - size is where it came from
+            old = forget(size)
+            if old:
+                remember(address, old[0], region, old[2], old[3])
+        elif event == STEAL:
+            # The Stealable's allocation went with it
+            forget(address)
+        elif event == LOST:
+            # We've missed some frees, so anything we think is live might not be. Peaks after this are suspect
+            num_lost += size
+            print(f"warning: {size} entries lost at {time / SAMPLE_RATE:.3f}s", file=sys.stderr)
+            continue
+
+        if live_bytes[region] > peak_bytes[region]:
+            peak_bytes[region] = live_bytes[region]
+            peak_time[region] = time
+        if timeline:
+            timeline.write(f"{time / SAMPLE_RATE:.6f}," + ",".join(str(b) for b in live_bytes) + "\n")
+
+    if timeline:
+        timeline.close()
+
+    print("events: " + ", ".join(f"{EVENTS[e]} {n}" for e, n in sorted(event_counts.items())))
+    print("allocs by tag: " + ", ".join(f"{TAGS[t] if t < len(TAGS) else t} {n}" for t, n in sorted(tag_counts.items())))
+    for r, name in enumerate(REGIONS):
+        print(
+            f"{name}: peak live {peak_bytes[r]} bytes at {peak_time[r] / SAMPLE_RATE:.3f}s, "
+            f"{live_bytes[r]} still live at end"
+        )
+    if num_lost:
+        print(f"{num_lost} entries were lost - figures above are approximate")
+    if num_unmatched:
+        print(f"{num_unmatched} frees of allocations made before the capture started (or lost)")
+
+    top = caller_bytes.most_common(args.top)
+    names = symbolize(args.elf, [c for c, _ in top])
+    print(f"\ntop {len(top)} callers by bytes allocated:")
+    for caller, total in top:
+        print(f"  {total:>10} bytes in {caller_allocs[caller]:>7} allocs  {names.get(caller, hex(caller))}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,151 @@
+# Latency figures for an SD card trace captured off RTT up-channel 2, and replay of the same pattern against a card.
+#
+# Build with -DENABLE_DISK_TRACE=ON, then capture the channel to a file, e.g.:
+#   JLinkRTTLogger -Device R7S721020 -If JTAG -Speed 4000 -RTTChannel 2 disk.bin
+# and then:
+#   python contrib/debug/disk_trace.py stats disk.bin [--timeline out.csv]
+#   python contrib/debug/disk_trace.py replay disk.bin /dev/sdX [--writes]
+#
+# Replaying reads the same runs of sectors, in the same order, from the given device, timing each. Writes are left
+# out unless --writes is given, in which case each write's sectors are read and written straight back - so the card's
+# contents don't change, but it does get written to. Needs read (and maybe write) access to the raw device.
+#
+# The layout of each entry is that of DiskTraceEntry in src/deluge/storage/disk_trace.h
+import argparse
+import mmap
+import os
+import struct
+import sys
+import time
+
+ENTRY = struct.Struct("<IIIHBB")
+
+EVENTS = ["read", "write", "lost"]
+(READ, WRITE, LOST) = range(len(EVENTS))
+
+SAMPLE_RATE = 44100
+CYCLES_PER_MS = 400000
+SECTOR_SIZE = 512
+
+PERCENTILES = [50, 90, 99, 99.9, 100]
+
+
+def read_entries(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) % ENTRY.size:
+        print(
+            f"warning: {len(data) % ENTRY.size} trailing bytes ignored - capture cut off mid entry?",
+            file=sys.stderr,
+        )
+    for offset in range(0, len(data) - ENTRY.size + 1, ENTRY.size):
+        yield ENTRY.unpack_from(data, offset)
+
+
+def percentile(sorted_values, p):
+    return sorted_values[min(len(sorted_values) - 1, int(len(sorted_values) * p / 100))]
+
+
+def print_distribution(name, latencies_ms, sizes):
+    if not latencies_ms:
+        return
+    values = sorted(latencies_ms)
+    total_ms = sum(values)
+    total_bytes = sum(sizes) * SECTOR_SIZE
+    print(
+        f"{name}: {len(values)} commands, {total_bytes // 1024} kB, "
+        f"{total_bytes / 1024 / (total_ms / 1000) if total_ms else 0:.0f} kB/s while busy"
+    )
+    print("  " + "  ".join(f"p{p} {percentile(values, p):.2f}ms" for p in PERCENTILES))
+
+
+def stats(args):
+    latencies = {READ: [], WRITE: []}
+    sizes = {READ: [], WRITE: []}
+    num_lost = 0
+    num_errors = 0
+    timeline = open(args.timeline, "w") if args.timeline else None
+    if timeline:
+        timeline.write("seconds,event,sector,count,ms\n")
+
+    for t, sector, cycles, count, event, result in read_entries(args.trace):
+        if event >= len(EVENTS):
+            print(f"warning: garbage entry at t={t}, stopping", file=sys.stderr)
+            break
+        if event == LOST:
+            num_lost += count
+            print(f"warning: {count} entries lost at {t / SAMPLE_RATE:.3f}s", file=sys.stderr)
+            continue
+        if result:
+            num_errors += 1
+        ms = cycles / CYCLES_PER_MS
+        latencies[event].append(ms)
+        sizes[event].append(count)
+        if timeline:
+            timeline.write(f"{t / SAMPLE_RATE:.6f},{EVENTS[event]},{sector},{count},{ms:.3f}\n")
+
+    if timeline:
+        timeline.close()
+
+    print_distribution("reads", latencies[READ], sizes[READ])
+    print_distribution("writes", latencies[WRITE], sizes[WRITE])
+    if num_errors:
+        print(f"{num_errors} commands failed")
+    if num_lost:
+        print(f"{num_lost} entries were lost - figures above are missing some commands")
+
+
+def replay(args):
+    flags = os.O_RDWR if args.writes else os.O_RDONLY
+    # Bypass the host's own cache where we can, or we'd mostly be timing that
+    flags |= getattr(os, "O_DIRECT", 0)
+    fd = os.open(args.device, flags)
+
+    latencies = {READ: [], WRITE: []}
+    sizes = {READ: [], WRITE: []}
+    try:
+        for _, sector, _, count, event, _ in read_entries(args.trace):
+            if event == LOST or (event == WRITE and not args.writes):
+                continue
+            length = count * SECTOR_SIZE
+            # Page-aligned, as O_DIRECT wants
+            buffer = mmap.mmap(-1, length)
+            view = memoryview(buffer)
+            start = time.perf_counter()
+            os.preadv(fd, [view], sector * SECTOR_SIZE)
+            if event == WRITE:
+                os.pwritev(fd, [view], sector * SECTOR_SIZE)
+                os.fsync(fd)
+            latencies[event].append((time.perf_counter() - start) * 1000)
+            sizes[event].append(count)
+            view.release()
+            buffer.close()
+    finally:
+        os.close(fd)
+
+    print_distribution("reads", latencies[READ], sizes[READ])
+    print_distribution("writes (read, then written back)", latencies[WRITE], sizes[WRITE])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    stats_parser = sub.add_parser("stats", help="latency distribution of a capture")
+    stats_parser.add_argument("trace", help="raw capture of RTT channel 2")
+    stats_parser.add_argument("--timeline", help="write every command and its latency to this CSV")
+
+    replay_parser = sub.add_parser("replay", help="replay a capture's commands against a card")
+    replay_parser.add_argument("trace", help="raw capture of RTT channel 2")
+    replay_parser.add_argument("device", help="the card's raw block device, e.g. /dev/sdX")
+    replay_parser.add_argument("--writes", action="store_true", help="replay writes too, writing back what's there")
+
+    args = parser.parse_args()
+    if args.command == "stats":
+        stats(args)
+    else:
+        replay(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,117 @@
+# Turns an event trace captured off RTT up-channel 3 into a timeline, and sums up how long each activity takes.
+#
+# Build with -DENABLE_EVENT_TRACE=ON, then capture the channel to a file, e.g.:
+#   JLinkRTTLogger -Device R7S721020 -If JTAG -Speed 4000 -RTTChannel 3 events.bin
+# and then:
+#   python contrib/debug/event_trace.py events.bin [--chrome trace.json]
+#
+# The JSON can be opened in https://ui.perfetto.dev or chrome://tracing. Everything happens on the one core, one
+# activity inside another (e.g. the audio routine running in the middle of a cluster load, via routineForSD()), so
+# it's all shown as one nested track.
+#
+# The layout of each entry is that of EventTraceEntry in src/deluge/io/debug/event_trace.h
+import argparse
+import json
+import struct
+import sys
+from collections import defaultdict
+
+ENTRY = struct.Struct("<IBBH")
+
+SCOPES = ["audio routine", "cluster load", "UI render", "OLED render", "MIDI flush", "card routine"]
+(ENTER, EXIT, LOST) = range(3)
+
+CYCLES_PER_US = 400
+
+
+def read_entries(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) % ENTRY.size:
+        print(
+            f"warning: {len(data) % ENTRY.size} trailing bytes ignored - capture cut off mid entry?",
+            file=sys.stderr,
+        )
+
+    # The cycle counter wraps every 10.7 seconds, but there's always something happening more often than that
+    time = 0
+    last_cycles = None
+    for offset in range(0, len(data) - ENTRY.size + 1, ENTRY.size):
+        cycles, scope, event, value = ENTRY.unpack_from(data, offset)
+        if last_cycles is not None:
+            time += (cycles - last_cycles) & 0xFFFFFFFF
+        last_cycles = cycles
+        yield time / CYCLES_PER_US, scope, event, value
+
+
+def scope_name(scope):
+    return SCOPES[scope] if scope < len(SCOPES) else f"scope {scope}"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("trace", help="raw capture of RTT channel 3")
+    parser.add_argument("--chrome", help="write a Chrome trace / Perfetto JSON timeline to this file")
+    args = parser.parse_args()
+
+    chrome_events = []
+    durations = defaultdict(list)
+    nestings = defaultdict(int)  # (outer, inner) -> how many times
+    stack = []  # (scope, start time)
+    num_lost = 0
+    num_unmatched = 0
+
+    for time, scope, event, value in read_entries(args.trace):
+        if event == LOST:
+            # Whatever was open at the time may never be seen to close, so start afresh
+            num_lost += value
+            chrome_events.append({"name": f"{value} events lost", "ph": "i", "s": "g", "ts": time, "pid": 0, "tid": 0})
+            for open_scope, _ in reversed(stack):
+                chrome_events.append({"name": scope_name(open_scope), "ph": "E", "ts": time, "pid": 0, "tid": 0})
+            stack = []
+            continue
+
+        if event == ENTER:
+            if stack:
+                nestings[(stack[-1][0], scope)] += 1
+            stack.append((scope, time))
+            chrome_events.append({"name": scope_name(scope), "ph": "B", "ts": time, "pid": 0, "tid": 0})
+            continue
+
+        # An exit should match the innermost thing still open. If it doesn't, something got lost along the way
+        if not stack or stack[-1][0] != scope:
+            num_unmatched += 1
+            continue
+        _, start = stack.pop()
+        durations[scope].append(time - start)
+        args_for_event = {"clusters": value} if value else {}
+        chrome_events.append(
+            {"name": scope_name(scope), "ph": "E", "ts": time, "pid": 0, "tid": 0, "args": args_for_event}
+        )
+
+    print(f"{'activity':16} {'count':>8} {'mean us':>10} {'p99 us':>10} {'max us':>10} {'total ms':>10}")
+    for scope in sorted(durations):
+        values = sorted(durations[scope])
+        p99 = values[min(len(values) - 1, int(len(values) * 0.99))]
+        print(
+            f"{scope_name(scope):16} {len(values):8} {sum(values) / len(values):10.1f} {p99:10.1f} "
+            f"{values[-1]:10.1f} {sum(values) / 1000:10.1f}"
+        )
+
+    if nestings:
+        print("\nactivities that happened during others:")
+        for (outer, inner), count in sorted(nestings.items(), key=lambda item: -item[1]):
+            print(f"  {scope_name(inner)} during {scope_name(outer)}: {count}")
+
+    if num_lost:
+        print(f"\n{num_lost} events were lost - RTT's buffer filled up faster than it was read")
+    if num_unmatched:
+        print(f"{num_unmatched} exits didn't match what was open")
+
+    if args.chrome:
+        with open(args.chrome, "w") as f:
+            json.dump({"traceEvents": chrome_events, "displayTimeUnit": "ns"}, f)
+
+
+if __name__ == "__main__":
+    main()
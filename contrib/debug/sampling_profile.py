@@ -0,0 +1,120 @@
+# Lists where the firmware spent its time, from a profile written to the card by the sampling profiler.
+#
+# Build with -DENABLE_SAMPLING_PROFILER=ON, send debug sysex command 7 with a data byte of 1 to start it and 0 to stop
+# it, which writes PROFILE.BIN to the card. Then, with the ELF from that same build:
+#   python contrib/debug/sampling_profile.py PROFILE.BIN build/Debug/deluge.elf [--top 40] [--lines 20]
+#
+# Each sample is the PC an MTU timer interrupt found, counted into 16 byte buckets of .text, so everything is
+# attributed to whichever function holds the start of its bucket - close enough for hot spots, but a tiny function
+# next to a hot one can pick up a stray count or two.
+#
+# The layout of the file is SamplingProfileHeader and then SamplingProfileEntrys, in
+# src/deluge/io/debug/sampling_profiler.h
+import argparse
+import bisect
+import collections
+import struct
+import subprocess
+import sys
+
+HEADER = struct.Struct("<8I")
+ENTRY = struct.Struct("<II")
+MAGIC = 0x46525044
+
+
+def read_profile(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    magic, text_start, bucket_size_log2, num_buckets, sample_rate, num_samples, num_outside, num_entries = (
+        HEADER.unpack_from(data, 0)
+    )
+    if magic != MAGIC:
+        sys.exit(f"{path} isn't a sampling profile")
+    if len(data) < HEADER.size + num_entries * ENTRY.size:
+        print("warning: file is cut short", file=sys.stderr)
+        num_entries = (len(data) - HEADER.size) // ENTRY.size
+
+    counts = {}
+    for i in range(num_entries):
+        bucket, count = ENTRY.unpack_from(data, HEADER.size + i * ENTRY.size)
+        counts[text_start + (bucket << bucket_size_log2)] = count
+    return sample_rate, num_samples, num_outside, counts
+
+
+def read_functions(elf):
+    # Sorted (address, size, name) for everything in .text
+    out = subprocess.run(
+        ["arm-none-eabi-nm", "-C", "-S", "--defined-only", elf], capture_output=True, text=True, check=True
+    ).stdout
+    functions = []
+    for line in out.splitlines():
+        parts = line.split(" ", 3)
+        if len(parts) == 4 and parts[2] in "tTwW":
+            functions.append((int(parts[0], 16), int(parts[1], 16), parts[3]))
+    functions.sort()
+    return functions
+
+
+def find_function(functions, starts, address):
+    i = bisect.bisect_right(starts, address) - 1
+    if i >= 0:
+        start, size, name = functions[i]
+        if address < start + size:
+            return name
+    return f"?? ({address:#x})"
+
+
+def get_lines(elf, addresses):
+    out = subprocess.run(
+        ["arm-none-eabi-addr2line", "-C", "-s", "-e", elf] + [hex(a) for a in addresses],
+        capture_output=True,
+        text=True,
+        check=True,
+    ).stdout.split("\n")
+    return dict(zip(addresses, out))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("profile", help="PROFILE.BIN off the card")
+    parser.add_argument("elf", help="firmware .elf of the build that made the profile")
+    parser.add_argument("--top", type=int, default=40, help="how many functions to list")
+    parser.add_argument("--lines", type=int, default=0, help="also list this many of the hottest source lines")
+    args = parser.parse_args()
+
+    sample_rate, num_samples, num_outside, counts = read_profile(args.profile)
+    if not num_samples:
+        sys.exit("no samples in profile")
+
+    try:
+        functions = read_functions(args.elf)
+    except (OSError, subprocess.CalledProcessError) as e:
+        sys.exit(f"couldn't read symbols: {e}")
+    starts = [f[0] for f in functions]
+
+    by_function = collections.Counter()
+    for address, count in counts.items():
+        by_function[find_function(functions, starts, address)] += count
+
+    print(f"{num_samples} samples over {num_samples / sample_rate:.1f} seconds")
+    if num_outside:
+        print(f"{num_outside} ({num_outside * 100 / num_samples:.1f}%) were outside .text")
+    print()
+    print(f"{'%':>6} {'samples':>8}  function")
+    for name, count in by_function.most_common(args.top):
+        print(f"{count * 100 / num_samples:6.2f} {count:8}  {name}")
+
+    if args.lines:
+        hottest = sorted(counts, key=lambda a: -counts[a])[: args.lines]
+        try:
+            lines = get_lines(args.elf, hottest)
+        except (OSError, subprocess.CalledProcessError) as e:
+            sys.exit(f"couldn't symbolize: {e}")
+        print()
+        print(f"{'%':>6} {'samples':>8}  {'address':10}  line")
+        for address in hottest:
+            print(f"{counts[address] * 100 / num_samples:6.2f} {counts[address]:8}  {address:#010x}  {lines[address]}")
+
+
+if __name__ == "__main__":
+    main()
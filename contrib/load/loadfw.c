@@ -13,6 +13,7 @@
 void usage_exit(char *name) {
 	fprintf(stderr, "usage:   %s -o output.syx {handshake} path/firmware.bin \n", name);
 	fprintf(stderr, "           (print to stdout with -o -)\n");
+	fprintf(stderr, "           (firmware can also be a compressed .lz4 image)\n");
 #ifdef USE_ALSA
 	fprintf(stderr, "send to alsa port:\n"
 			        "         %s -a {alsa_port} {handshake} path/firmware.bin \n", name);
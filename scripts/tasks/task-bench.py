@@ -0,0 +1,185 @@
+#! /usr/bin/env python3
+import argparse
+import fnmatch
+import json
+import os
+import re
+import subprocess
+import sys
+from pathlib import Path
+import util
+
+BUDGET_FILE = Path("tests/benchmark_budget.json")
+BUILD_DIR = Path("build/tests")
+RESULTS_FILE = BUILD_DIR / "benchmark_results.txt"
+BASELINE_FILE = BUILD_DIR / "benchmark_baseline.txt"
+
+# A line of the on-device DSP benchmark's output (debug sysex command 5), e.g. "bench lpf 24db 1843"
+DEVICE_LINE = re.compile(r"bench (.+) (\d+)\s*$")
+
+
+def argparser() -> argparse.ArgumentParser:
+    parser = argparse.ArgumentParser(
+        prog="bench",
+        description="Run the host benchmarks and check them against the budget and the last run",
+    )
+    parser.group = "Development"
+    parser.add_argument(
+        "-r", "--repeats", type=int, default=5, help="how many times to run each timed benchmark (best one counts)"
+    )
+    parser.add_argument(
+        "-d",
+        "--device-log",
+        help="debug output captured from the DSP benchmark on a Deluge, to check its kernels too",
+    )
+    parser.add_argument(
+        "-u",
+        "--update-budget",
+        help="write this run's figures into the budget file instead of checking against it",
+        action="store_true",
+    )
+    parser.add_argument(
+        "-B", "--no-build", help="don't (re)build the benchmarks first", action="store_true"
+    )
+    return parser
+
+
+def read_results(path: Path) -> dict:
+    results = {}
+    if path.exists():
+        for line in path.read_text().splitlines():
+            parts = line.split()
+            if len(parts) == 2:
+                results[parts[0]] = float(parts[1])
+    return results
+
+
+def write_results(path: Path, results: dict):
+    path.write_text("".join(f"{metric} {value:.2f}\n" for metric, value in sorted(results.items())))
+
+
+def read_device_log(path: str) -> dict:
+    results = {}
+    with open(path, errors="replace") as f:
+        for line in f:
+            match = DEVICE_LINE.search(line)
+            if match:
+                name = match.group(1).strip().replace(" ", "_")
+                results[f"device.{name}.cycles_per_sample_x100"] = float(match.group(2))
+    return results
+
+
+def get_tolerance(budget: dict, metric: str) -> float:
+    for pattern, tolerance in budget.get("tolerances", {}).items():
+        if fnmatch.fnmatch(metric, pattern):
+            return tolerance
+    return budget.get("tolerance_percent", 10)
+
+
+def is_over(value: float, limit: float, tolerance_percent: float) -> bool:
+    # Everything we measure is better when lower. Going up from nothing counts as over, whatever the tolerance
+    return value > limit * (1 + tolerance_percent / 100) if limit else value > 0
+
+
+def build() -> int:
+    if not (BUILD_DIR / "CMakeCache.txt").exists():
+        result = subprocess.run(["cmake", "-S", "tests", "-B", str(BUILD_DIR)], env=os.environ)
+        if result.returncode != 0:
+            return result.returncode
+    result = subprocess.run(["cmake", "--build", str(BUILD_DIR), "--target", "RunBenchmarks"], env=os.environ)
+    return result.returncode
+
+
+def run_benchmarks(repeats: int) -> int:
+    executable = BUILD_DIR / "RunBenchmarks"
+    result = subprocess.run(
+        [str(executable), "--results", str(RESULTS_FILE), str(repeats)], env=os.environ
+    )
+    return result.returncode
+
+
+def format_value(value) -> str:
+    return "-" if value is None else f"{value:.2f}"
+
+
+def compare(results: dict, previous: dict, budget: dict) -> int:
+    budgets = budget.get("budgets", {})
+    num_failed = 0
+
+    print()
+    print(f"{'metric':52} {'budget':>12} {'previous':>12} {'now':>12} {'change':>8}  status")
+    for metric in sorted(results):
+        value = results[metric]
+        limit = budgets.get(metric)
+        before = previous.get(metric)
+        tolerance = get_tolerance(budget, metric)
+
+        change = ""
+        if before:
+            change = f"{(value - before) * 100 / before:+.1f}%"
+
+        problems = []
+        if limit is not None and is_over(value, limit, tolerance):
+            problems.append("OVER BUDGET")
+        if before is not None and is_over(value, before, tolerance):
+            problems.append("REGRESSED")
+        if problems:
+            num_failed += 1
+
+        print(
+            f"{metric:52} {format_value(limit):>12} {format_value(before):>12} {format_value(value):>12} "
+            f"{change:>8}  {', '.join(problems) or 'ok'}"
+        )
+
+    for metric in sorted(set(budgets) - set(results)):
+        print(f"{metric:52} {format_value(budgets[metric]):>12} {'':>12} {'missing':>12}")
+
+    print()
+    return num_failed
+
+
+def main() -> int:
+    args = argparser().parse_args()
+    os.chdir(util.get_git_root())
+
+    if not args.no_build:
+        result = build()
+        if result != 0:
+            return result
+
+    result = run_benchmarks(args.repeats)
+    if result != 0:
+        print("RunBenchmarks failed")
+        return result
+
+    results = read_results(RESULTS_FILE)
+    if args.device_log:
+        results.update(read_device_log(args.device_log))
+
+    budget = json.loads(BUDGET_FILE.read_text()) if BUDGET_FILE.exists() else {}
+
+    if args.update_budget:
+        # Host timings depend on the machine, so they're only ever compared with the last run on the same one
+        budget["budgets"] = {
+            metric: value
+            for metric, value in sorted(results.items())
+            if not metric.startswith("host.") and not metric.endswith("_ns")
+        }
+        BUDGET_FILE.write_text(json.dumps(budget, indent=4) + "\n")
+        print(f"Wrote {len(budget['budgets'])} budgets to {BUDGET_FILE}")
+        write_results(BASELINE_FILE, results)
+        return 0
+
+    num_failed = compare(results, read_results(BASELINE_FILE), budget)
+    if num_failed:
+        # Keep the old baseline, so the regression keeps showing up until it's dealt with
+        print(f"{num_failed} figures regressed past tolerance")
+        return 1
+
+    write_results(BASELINE_FILE, results)
+    print("All within budget")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
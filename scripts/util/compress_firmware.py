@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+"""
+Compress a firmware .bin into the image format that loaders taking a compressed image expect - see
+src/deluge/util/chainload.h. The header keeps the image's code start / end / execute words where they were, and the
+LZ4 block after it is a standard one, decoded on the Deluge by lz4_decompress_block().
+"""
+
+import argparse
+import struct
+import sys
+
+OFF_USER_CODE_START = 0x20
+OFF_COMPRESSED_MAGIC = 0x2C
+COMPRESSED_HEADER_SIZE = 0x40
+COMPRESSED_IMAGE_MAGIC = 0x345A4C44  # "DLZ4"
+
+# LZ4 block format constraints
+MIN_MATCH = 4
+LAST_LITERALS = 5  # The last 5 bytes are always literals...
+MF_LIMIT = 12  # ...and the last match has to start at least 12 bytes before the end
+MAX_OFFSET = 65535
+
+
+def write_length(out, length):
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+
+def write_sequence(out, literals, offset=0, match_length=0):
+    num_literals = len(literals)
+    match_code = match_length - MIN_MATCH if offset else 0
+    out.append((min(num_literals, 15) << 4) | min(match_code, 15))
+    if num_literals >= 15:
+        write_length(out, num_literals - 15)
+    out += literals
+    if not offset:
+        return
+    out += struct.pack("<H", offset)
+    if match_code >= 15:
+        write_length(out, match_code - 15)
+
+
+def compress_block(data):
+    """Greedy LZ4 - a match is taken as soon as one's found. Slower to make than real lz4, but same format"""
+    out = bytearray()
+    last_seen = {}
+    anchor = 0
+    pos = 0
+    match_start_limit = len(data) - MF_LIMIT
+    match_end_limit = len(data) - LAST_LITERALS
+
+    while pos < match_start_limit:
+        key = data[pos : pos + MIN_MATCH]
+        candidate = last_seen.get(key)
+        last_seen[key] = pos
+        if candidate is None or pos - candidate > MAX_OFFSET:
+            pos += 1
+            continue
+
+        length = MIN_MATCH
+        while pos + length < match_end_limit and data[candidate + length] == data[pos + length]:
+            length += 1
+
+        write_sequence(out, data[anchor:pos], pos - candidate, length)
+        pos += length
+        anchor = pos
+
+    write_sequence(out, data[anchor:])
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compress a firmware .bin into an LZ4 image.")
+    parser.add_argument("input", help="firmware .bin, as objcopied from the .elf")
+    parser.add_argument("output", help="compressed image to write")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        image = f.read()
+
+    if len(image) < COMPRESSED_HEADER_SIZE:
+        sys.exit(f"{args.input} is too short to be a firmware image")
+    if struct.unpack_from("<I", image, OFF_COMPRESSED_MAGIC)[0] == COMPRESSED_IMAGE_MAGIC:
+        sys.exit(f"{args.input} is already compressed")
+
+    block = compress_block(image)
+
+    header = bytearray(COMPRESSED_HEADER_SIZE)
+    header[OFF_USER_CODE_START : OFF_USER_CODE_START + 12] = image[OFF_USER_CODE_START : OFF_USER_CODE_START + 12]
+    struct.pack_into("<III", header, OFF_COMPRESSED_MAGIC, COMPRESSED_IMAGE_MAGIC, len(block), len(image))
+
+    # Loaders send whole words
+    padding = bytes(-len(block) % 4)
+
+    with open(args.output, "wb") as f:
+        f.write(header + block + padding)
+
+    print(f"{args.output}: {len(image)} -> {COMPRESSED_HEADER_SIZE + len(block) + len(padding)} bytes")
+
+
+if __name__ == "__main__":
+    main()
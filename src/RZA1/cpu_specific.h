@@ -85,7 +85,7 @@
 // DMA --------------------------------------------------------------------------
 /*
 DMA channels:
-0:
+0: Memory copies and fills - defined below
 1:
 2: SD host - defined in sd_cfg.h
 3:
@@ -103,6 +103,8 @@ DMA channels:
 15:
 */
 
+#define MEMORY_DMA_CHANNEL 0
+
 #define OLED_SPI_DMA_CHANNEL 4
 
 #define SSI_TX_DMA_CHANNEL 6
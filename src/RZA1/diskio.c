@@ -37,6 +37,7 @@
 #include "RZA1/system/rza_io_regrw.h"
 #include "deluge/deluge.h"
 #include "deluge/drivers/uart/uart.h"
+#include "deluge/storage/disk_trace.h"
 #include "diskio.h"
 #include "ff.h"
 
@@ -65,6 +66,8 @@ uint16_t ioRegGet2(volatile uint16_t* reg, uint8_t p, uint8_t q)
 }
 
 DRESULT disk_read_without_streaming_first(BYTE pdrv, BYTE* buff, LBA_t sector, UINT count);
+DRESULT disk_read_scattered_without_streaming_first(
+    BYTE pdrv, BYTE* const* buffs, UINT sectorsPerBuff, LBA_t sector, UINT count);
 
 extern int pendingGlobalMIDICommandNumClustersWritten;
 extern int currentlySearchingForCluster;
@@ -191,16 +194,43 @@ processError:
 /* Read Sector(s)                                                        */
 /*-----------------------------------------------------------------------*/
 
+// The card gets switched to high speed mode (CMD6) when mounted if it supports it, and then clocked as fast as we can.
+// A CRC error most likely means that's too fast for this card or its contacts, so slow the clock down a notch and have
+// another go, until there are no notches left. The clock stays slowed until the card is next mounted
+static int shouldRetryAfterCRCError(int err)
+{
+    if (err != SD_ERR_CRC && err != SD_ERR_HOST_CRC)
+        return 0;
+
+    if (sd_reduce_clock(SD_PORT) != SD_OK)
+        return 0;
+
+    uartPrintln("SD CRC error - slowing clock down");
+    return 1;
+}
+
 DRESULT disk_read_without_streaming_first(BYTE pdrv, /* Physical drive nmuber to identify the drive */
     BYTE* buff,                                      /* Data buffer to store read data */
     DWORD sector,                                    /* Sector address in LBA */
     UINT count                                       /* Number of sectors to read */
 )
+{
+    return disk_read_scattered_without_streaming_first(pdrv, &buff, count, sector, count);
+}
+
+// Reads count sectors starting at sector, with the first sectorsPerBuff of them going to buffs[0], the next to buffs[1],
+// and so on - so several Clusters which sit one after the other on the card can be loaded with one command to it
+DRESULT disk_read_scattered_without_streaming_first(BYTE pdrv, /* Physical drive nmuber to identify the drive */
+    BYTE* const* buffs,                                        /* Data buffers to store read data */
+    UINT sectorsPerBuff,                                       /* Number of sectors to store in each buffer */
+    DWORD sector,                                              /* Sector address in LBA */
+    UINT count                                                 /* Total number of sectors to read */
+)
 {
 
     logAudioAction("disk_read_without_streaming_first");
 
-    BYTE err;
+    int err;
 
     if (currentlyAccessingCard)
         freezeWithError("E259"); // Operatricks got! But I think I fixed.
@@ -209,7 +239,18 @@ DRESULT disk_read_without_streaming_first(BYTE pdrv, /* Physical drive nmuber to
 
     currentlyAccessingCard = 1;
 
-    err = sd_read_sect(SD_PORT, buff, sector, count);
+#if ENABLE_DISK_TRACE
+    uint32_t traceStartTime = diskTraceBegin();
+#endif
+
+    do
+    {
+        err = sd_read_sect_scattered(SD_PORT, buffs, sectorsPerBuff, sector, count);
+    } while (shouldRetryAfterCRCError(err));
+
+#if ENABLE_DISK_TRACE
+    diskTraceEnd(DISK_TRACE_READ, sector, count, traceStartTime, err);
+#endif
 
     currentlyAccessingCard = 0;
 
@@ -244,14 +285,25 @@ DRESULT disk_write(BYTE pdrv, /* Physical drive nmuber to identify the drive */
 
     loadAnyEnqueuedClustersRoutine(); // Always ensure SD streaming is fulfilled before anything else
 
-    BYTE err;
+    int err;
 
     if (currentlyAccessingCard)
         freezeWithError("E258");
 
     currentlyAccessingCard = 1;
 
-    err = sd_write_sect(SD_PORT, buff, sector, count, 0x0001u);
+#if ENABLE_DISK_TRACE
+    uint32_t traceStartTime = diskTraceBegin();
+#endif
+
+    do
+    {
+        err = sd_write_sect(SD_PORT, buff, sector, count, 0x0001u);
+    } while (shouldRetryAfterCRCError(err));
+
+#if ENABLE_DISK_TRACE
+    diskTraceEnd(DISK_TRACE_WRITE, sector, count, traceStartTime, err);
+#endif
 
     currentlyAccessingCard = 0;
 
@@ -44,6 +44,11 @@
 #define SDCFG_IP0_BASE         0xE804E000
 #define SDCFG_IP1_BASE         0xE804E800
 
+/* ------------------------------------------------------
+  Set SDHI Clock (IMCLK) Frequency, in kHz
+--------------------------------------------------------*/
+#define SDCFG_IMCLK_KHZ        66667               /* P1 clock, which sddev_get_clockdiv() divides down */
+
 /* ------------------------------------------------------
   Set the method of check SD Status
 --------------------------------------------------------*/
@@ -196,6 +196,10 @@ extern "C" {
 #define SD_CLK_25MHz              0x0005u            /* 25MHz */
 #define SD_CLK_50MHz              0x0006u            /* 50MHz (phys spec ver1.10) */
 
+/* ---- speed mode (sd_get_type) ---- */
+#define SD_SPEED_MODE_HIGH        0x01u              /* switched to high speed by CMD6 */
+#define SD_SPEED_MODE_HIGH_SUP    0x10u              /* high speed supported */
+
 /* ---- speed class ---- */
 #define SD_SPEED_CLASS_0          0x00u              /* not defined, or less than ver2.0 */
 #define SD_SPEED_CLASS_2          0x01u              /* 2MB/sec */
@@ -245,6 +249,7 @@ int sd_format(int sd_port, int mode,int (*callback)(unsigned long,unsigned long)
 int sd_format2(int sd_port, int mode,unsigned long volserial,int (*callback)(unsigned long,unsigned long));
 int sd_mount(int sd_port, unsigned long mode,unsigned long voltage);
 int sd_read_sect(int sd_port, unsigned char *buff,unsigned long psn,long cnt);
+int sd_read_sect_scattered(int sd_port, unsigned char * const *buffs,long sectPerBuff,unsigned long psn,long cnt);
 int sd_write_sect(int sd_port, unsigned char const *buff,unsigned long psn,long cnt,int writemode);
 int sd_get_type(int sd_port, unsigned char *type,unsigned char *speed,unsigned char *capa);
 int sd_get_size(int sd_port, unsigned long *user,unsigned long *protect);
@@ -259,6 +264,8 @@ int sd_get_reg(int sd_port, unsigned char *ocr,unsigned char *cid,unsigned char
 int sd_get_rca(int sd_port, unsigned char *rca);
 int sd_get_sdstatus(int sd_port, unsigned char *sdstatus);
 int sd_get_speed(int sd_port, unsigned char *clss,unsigned char *move);
+int sd_get_clock(int sd_port, unsigned long *khz);
+int sd_reduce_clock(int sd_port);
 int sd_finalize(int sd_port);
 int sd_set_seccnt(int sd_port, short sectors);
 int sd_get_seccnt(int sd_port);
@@ -244,6 +244,7 @@ int sd_finalize(int sd_port)
  *              : resp_status : R1/R1b response status
  *              : error : error detail information
  *              : stop : compulsory stop flag
+ *              : clock_fallback : clock steps down after CRC errors
  *              : prot_sector_size : sector size (protect area)
  *              : card registers : ocr, cid, csd, dsr, rca, scr, sdstatus and
  *              : status_data
@@ -266,6 +267,7 @@ int _sd_init_hndl(SDHNDL *hndl,unsigned long mode,unsigned long voltage)
 	hndl->prot_sector_size = 0;
 	hndl->voltage = voltage;
 	hndl->speed_mode = 0;
+	hndl->clock_fallback = 0;
 	hndl->int_mode = (unsigned char)(mode & 0x1u);
 	hndl->trans_mode = (unsigned char)(mode & (SD_MODE_DMA | SD_MODE_DMA_64));
 	hndl->sup_card = (unsigned char)(mode & 0x30u);
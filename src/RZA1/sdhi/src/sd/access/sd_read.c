@@ -38,7 +38,9 @@
 #include "../../../inc/sdif.h"
 #include "../inc/access/sd.h"
 
+#include "RZA1/cache/cache.h"
 #include "RZA1/compiler/asm/inc/asm.h"
+#include "deluge/drivers/cache/dma_cache.h"
 #include "deluge/drivers/uart/uart.h"
 #include "deluge/deluge.h"
 
@@ -53,9 +55,29 @@ static int _sd_single_read(SDHNDL *hndl,unsigned char *buff,unsigned long psn
 	,int mode);
 
 
-int doActualReadRohan(int sd_port, SDHNDL *hndl, unsigned char *buff, long cnt, int mode, int dma_64) {
+/* Where sector number sect (counting from the first one of the whole read) goes, when sectPerBuff sectors go to each
+   buffer in turn */
+static unsigned char *_sd_scattered_sect_addr(unsigned char * const *buffs, long sectPerBuff, long sect)
+{
+	return buffs[sect / sectPerBuff] + (sect % sectPerBuff) * 512;
+}
+
+/* How many sectors from sect onwards go to the same buffer, up to cnt */
+static long _sd_scattered_run_length(long sectPerBuff, long sect, long cnt)
+{
+	long run = sectPerBuff - (sect % sectPerBuff);
+	return (run < cnt) ? run : cnt;
+}
+
+/* Reads cnt sectors' worth of data from the card's ongoing CMD18 - starting at sector sect of the whole read - into
+   wherever they're meant to be scattered. For DMA, the DMAC gets set up again for each buffer. The SDHI just holds
+   off the card while its FIFO is full, so the gap in between doesn't matter */
+int doActualReadRohan(int sd_port, SDHNDL *hndl, unsigned char * const *buffs, long sectPerBuff, long sect, long cnt,
+	int mode, int dma_64) {
 
-	int ret;
+	int ret = SD_OK;
+	long run;
+	unsigned char *buff;
 
 	/* ---- disable RespEnd and ILA ---- */
 	_sd_clear_int_mask(hndl,SD_INFO1_MASK_RESP,SD_INFO2_MASK_ILA);
@@ -64,7 +86,10 @@ int doActualReadRohan(int sd_port, SDHNDL *hndl, unsigned char *buff, long cnt,
 		/* enable All end, BRE and errors */
 		_sd_set_int_mask(hndl,SD_INFO1_MASK_DATA_TRNS,SD_INFO2_MASK_BRE);
 		/* software data transfer */
-		ret =_sd_software_trans(hndl,buff,cnt,SD_TRANS_READ);
+		for(; cnt > 0 && ret == SD_OK; sect += run, cnt -= run){
+			run = _sd_scattered_run_length(sectPerBuff,sect,cnt);
+			ret =_sd_software_trans(hndl,_sd_scattered_sect_addr(buffs,sectPerBuff,sect),run,SD_TRANS_READ);
+		}
 	}
 	else{	/* ==== DMA ==== */
 		/* disable card ins&rem interrupt for FIFO */
@@ -74,30 +99,44 @@ int doActualReadRohan(int sd_port, SDHNDL *hndl, unsigned char *buff, long cnt,
 		/* enable All end and errors */
 		_sd_set_int_mask(hndl,SD_INFO1_MASK_DATA_TRNS,SD_INFO2_MASK_ERR);
 
-		// If seems we have to invalidate RAM before as well as after the DMA transfer. Otherwise, there can be crackles in loaded sample data
-		// if the same small number of RAM clusters are being reused lots. Also seen a problem with some incorrect values (so a "click")
-		// coming in on a single-cycle waveform being loaded - and this was not really a reused-lots scenario - although this was using the main
-		// sector-read buffer, so maybe that counts as reuse.
-		// Guessing problem occurs because if not invalidated, there might be a cache
-		// for this memory which hasn't been written/flushed back out yet, and that happens during the DMA transfer, overwriting the audio data in actual RAM.
-		// https://support.xilinx.com/s/article/64839?language=en_US - seems to concur with this, and actually suggests that it is normal and necessary to
-		// invalidate both before and after transfer.
-		v7_dma_inv_range((intptr_t)buff, (intptr_t)(buff + cnt * 512));
-
-		/* ---- initialize DMAC ---- */
-		unsigned long reg_base_here = hndl->reg_base;
-		if(TARGET_RZ_A1 != 1 || dma_64 != SD_MODE_DMA_64) /* SD_CMD Address for 64byte transfer */
-			reg_base_here += SD_BUF0;
-
-		int result = sddev_init_dma(sd_port, (unsigned long)buff, reg_base_here, cnt*512, SD_TRANS_READ);
-
-		if (result != SD_OK) {
-			_sd_set_err(hndl,SD_ERR_CPU_IF);
-			return SD_ERR_CPU_IF;
+		// For a big enough read, one pass over the whole cache beats walking every buffer's range - see dma_cache.h
+		int wholeCacheDone = 0;
+		if (cnt * 512 >= DMA_CACHE_WHOLE_CACHE_THRESHOLD) {
+			L1_D_CacheWritebackFlushAll();
+			wholeCacheDone = 1;
 		}
 
-		/* DMA data transfer */
-		ret =_sd_dma_trans(hndl,cnt);
+		for(; cnt > 0 && ret == SD_OK; sect += run, cnt -= run){
+			run = _sd_scattered_run_length(sectPerBuff,sect,cnt);
+			buff = _sd_scattered_sect_addr(buffs,sectPerBuff,sect);
+
+			// If seems we have to invalidate RAM before as well as after the DMA transfer. Otherwise, there can be crackles in loaded sample data
+			// if the same small number of RAM clusters are being reused lots. Also seen a problem with some incorrect values (so a "click")
+			// coming in on a single-cycle waveform being loaded - and this was not really a reused-lots scenario - although this was using the main
+			// sector-read buffer, so maybe that counts as reuse.
+			// Guessing problem occurs because if not invalidated, there might be a cache
+			// for this memory which hasn't been written/flushed back out yet, and that happens during the DMA transfer, overwriting the audio data in actual RAM.
+			// https://support.xilinx.com/s/article/64839?language=en_US - seems to concur with this, and actually suggests that it is normal and necessary to
+			// invalidate both before and after transfer.
+			if (!wholeCacheDone) {
+				v7_dma_inv_range((intptr_t)buff, (intptr_t)(buff + run * 512));
+			}
+
+			/* ---- initialize DMAC ---- */
+			unsigned long reg_base_here = hndl->reg_base;
+			if(TARGET_RZ_A1 != 1 || dma_64 != SD_MODE_DMA_64) /* SD_CMD Address for 64byte transfer */
+				reg_base_here += SD_BUF0;
+
+			int result = sddev_init_dma(sd_port, (unsigned long)buff, reg_base_here, run*512, SD_TRANS_READ);
+
+			if (result != SD_OK) {
+				_sd_set_err(hndl,SD_ERR_CPU_IF);
+				return SD_ERR_CPU_IF;
+			}
+
+			/* DMA data transfer */
+			ret =_sd_dma_trans(hndl,run);
+		}
 
 		sd_outp(hndl,CC_EXT_MODE,(unsigned short)(sd_inp(hndl,CC_EXT_MODE) & ~CC_EXT_MODE_DMASDRW));
 		_sd_set_int_mask(hndl,info1_back,0);
@@ -125,10 +164,35 @@ int doActualReadRohan(int sd_port, SDHNDL *hndl, unsigned char *buff, long cnt,
  * Remark       : 
  *****************************************************************************/
 int sd_read_sect(int sd_port, unsigned char *buff,unsigned long psn,long cnt)
+{
+	return sd_read_sect_scattered(sd_port,&buff,cnt,psn,cnt);
+}
+
+/*****************************************************************************
+ * ID           :
+ * Summary      : read sector data from card into several buffers
+ * Include      : 
+ * Declaration  : int sd_read_sect_scattered(int sd_port, unsigned char * const *buffs,
+ *              : long sectPerBuff,unsigned long psn,long cnt);
+ * Functions    : as sd_read_sect, but the first sectPerBuff sectors go to
+ *              : buffs[0], the next sectPerBuff to buffs[1], and so on -
+ *              : all with as few commands to the card as sd_read_sect
+ *              : would need for one buffer.
+ * Argument     : unsigned char * const *buffs : read data buffers
+ *              : long sectPerBuff : number of sectors for each buffer
+ *              : unsigned long psn : read physical sector number
+ *              : long cnt : total number of read sectors
+ * Return       : SD_OK : end of succeed
+ *              : SD_ERR: end of error
+ * Remark       : 
+ *****************************************************************************/
+int sd_read_sect_scattered(int sd_port, unsigned char * const *buffs,long sectPerBuff,unsigned long psn,long cnt)
 {
 	
 	SDHNDL *hndl;
 	long i,j;
+	long sect = 0;	/* sectors so far, counting from the start of this read */
+	long run;
 	int ret,mode=0;
 	int mmc_lastsect=0;
 	unsigned short info1_back,opt_back;
@@ -175,8 +239,13 @@ int sd_read_sect(int sd_port, unsigned char *buff,unsigned long psn,long cnt)
 	}
 
 	/* if DMA transfer, buffer boundary is quadlet unit */
-	if((hndl->trans_mode & SD_MODE_DMA) && ((unsigned long)buff & 0x03u) == 0){
-		mode = SD_MODE_DMA;	/* set DMA mode */
+	mode = SD_MODE_DMA;
+	for(j=0; j*sectPerBuff < cnt; j++){
+		if(((unsigned long)buffs[j] & 0x03u) != 0){
+			mode = 0;
+		}
+	}
+	if((hndl->trans_mode & SD_MODE_DMA) && mode == SD_MODE_DMA){
 
 	#if		(TARGET_RZ_A1 == 1)
 		if(hndl->trans_mode & SD_MODE_DMA_64){
@@ -188,7 +257,10 @@ int sd_read_sect(int sd_port, unsigned char *buff,unsigned long psn,long cnt)
 	#endif
 	}
 
-	else uartPrintln("couldn't do DMA");
+	else{
+		mode = 0;
+		uartPrintln("couldn't do DMA");
+	}
 
 	/* transfer size is fixed (512 bytes) */
 	sd_outp(hndl,SD_SIZE,512);
@@ -212,7 +284,7 @@ int sd_read_sect(int sd_port, unsigned char *buff,unsigned long psn,long cnt)
 
 	/* ==== execute multiple transfer by 256 sectors ==== */
 	for(i=cnt; i > 0 ;
-		i-=TRANS_SECTORS,psn+=TRANS_SECTORS,buff+=TRANS_SECTORS*512){
+		i-=TRANS_SECTORS,psn+=TRANS_SECTORS,sect+=TRANS_SECTORS){
 
 		/* ---- is card existed? ---- */
 		if(_sd_check_media(hndl) != SD_OK){
@@ -232,8 +304,8 @@ int sd_read_sect(int sd_port, unsigned char *buff,unsigned long psn,long cnt)
 		if(cnt <= 2){
 			/* disable SD_SECCNT */
 			sd_outp(hndl,SD_STOP,0x0000);
-			for(j=cnt; j>0; j--,psn++,buff+=512){
-				ret = _sd_single_read(hndl,buff,psn,mode);
+			for(j=cnt; j>0; j--,psn++,sect++){
+				ret = _sd_single_read(hndl,_sd_scattered_sect_addr(buffs,sectPerBuff,sect),psn,mode);
 				if(ret != SD_OK){
 					opt_back = sd_inp(hndl,SD_OPTION);
 					#if		(TARGET_RZ_A1 == 1)
@@ -287,7 +359,7 @@ int sd_read_sect(int sd_port, unsigned char *buff,unsigned long psn,long cnt)
 			}
 		}
 
-		ret = doActualReadRohan(sd_port, hndl, buff, cnt, mode, dma_64);
+		ret = doActualReadRohan(sd_port, hndl, buffs, sectPerBuff, sect, cnt, mode, dma_64);
 
 		if(ret != SD_OK){
 			goto ErrExit;
@@ -310,7 +382,11 @@ int sd_read_sect(int sd_port, unsigned char *buff,unsigned long psn,long cnt)
 
 		if (mode != SD_MODE_SW) {
 			// Invalidate ram
-			v7_dma_inv_range((uintptr_t)buff, (uintptr_t)(buff + cnt * 512));
+			for(j=0; j<cnt; j+=run){
+				unsigned char *buff = _sd_scattered_sect_addr(buffs,sectPerBuff,sect+j);
+				run = _sd_scattered_run_length(sectPerBuff,sect+j,cnt-j);
+				v7_dma_inv_range((uintptr_t)buff, (uintptr_t)(buff + run * 512));
+			}
 		}
 
 		/* clear All end bit */
@@ -514,7 +590,7 @@ static int _sd_single_read(SDHNDL *hndl,unsigned char *buff,unsigned long psn,
 	}
 
 
-	ret = doActualReadRohan(hndl->sd_port, hndl, buff, 1, mode, dma_64);
+	ret = doActualReadRohan(hndl->sd_port, hndl, &buff, 1, 0, 1, mode, dma_64);
 
 	
 	if(ret != SD_OK){
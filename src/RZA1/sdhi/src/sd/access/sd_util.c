@@ -36,6 +36,7 @@
 *              : Jun.30.2014 ver.4.01.00 Added compliler swtich (#ifdef __CC_ARM - #endif)
 ******************************************************************************/
 #include "../../../inc/sdif.h"
+#include "../../../inc/sd_cfg.h"
 #include "../inc/access/sd.h"
 #include "deluge/deluge.h"
 
@@ -50,6 +51,33 @@ static unsigned long next;		/* Volume ID Number */
 
 static unsigned char _sd_calc_crc(unsigned char* data,int len);
 
+/*****************************************************************************
+ * ID           :
+ * Summary      : slow down clock divide ratio
+ * Include      : 
+ * Declaration  : static unsigned int _sd_slow_clockdiv(unsigned int div,int steps)
+ * Functions    : halve the clock given by div, steps times, stopping at SD_DIV_512
+ * Argument     : unsigned int div : clock divide ratio (SD_DIV_1 to SD_DIV_512)
+ *              : int steps : how many times to halve the clock
+ * Return       : slowed clock divide ratio
+ * Remark       : 
+ *****************************************************************************/
+static unsigned int _sd_slow_clockdiv(unsigned int div,int steps)
+{
+	for(; steps > 0; steps--){
+		if(div == SD_DIV_1){
+			div = SD_DIV_2;
+		}
+		else if(div == SD_DIV_2){
+			div = SD_DIV_4;
+		}
+		else if(div < SD_DIV_512){
+			div <<= 1;
+		}
+	}
+	return div;
+}
+
 /*****************************************************************************
  * ID           :
  * Summary      : control SD clock
@@ -74,6 +102,9 @@ int _sd_set_clock(SDHNDL *hndl,int clock, int enable)
 	if(enable == SD_CLOCK_ENABLE){
 		/* convert clock frequency to clock divide ratio */
 		div = sddev_get_clockdiv(hndl->sd_port, clock);
+		if(clock == (int)hndl->csd_tran_speed){
+			div = _sd_slow_clockdiv(div, hndl->clock_fallback);
+		}
 #ifdef SDIP_SUPPORT_DIV1
 		if((div > SD_DIV_512) && (div != SD_DIV_1)){
 			_sd_set_err(hndl,SD_ERR_CPU_IF);
@@ -372,6 +403,80 @@ int sd_get_type(int sd_port, unsigned char *type,unsigned char *speed,unsigned c
 	return SD_OK;
 }
 
+/*****************************************************************************
+ * ID           :
+ * Summary      : get bus clock
+ * Include      : 
+ * Declaration  : int sd_get_clock(int sd_port, unsigned long *khz);
+ * Functions    : get the SD clock frequency data is transferred at, after
+ *              : high speed switching and any slowing down by sd_reduce_clock
+ * Argument     : int sd_port : channel no (0 or 1)
+ *              : unsigned long *khz : SD clock frequency (kHz)
+ * Return       : SD_OK : end of succeed
+ *              : SD_ERR: end of error
+ * Remark       : 
+ *****************************************************************************/
+int sd_get_clock(int sd_port, unsigned long *khz)
+{
+	SDHNDL *hndl;
+	unsigned int div;
+
+	if( (sd_port != 0) && (sd_port != 1) ){
+		return SD_ERR;
+	}
+
+	hndl = _sd_get_hndls(sd_port);
+	if(hndl == 0){
+		return SD_ERR;	/* not initilized */
+	}
+
+	div = sddev_get_clockdiv(sd_port, (int)hndl->csd_tran_speed);
+	div = _sd_slow_clockdiv(div, hndl->clock_fallback);
+	if(div == SD_DIV_1){
+		*khz = SDCFG_IMCLK_KHZ;
+	}
+	else if(div == SD_DIV_2){
+		*khz = SDCFG_IMCLK_KHZ / 2;
+	}
+	else{
+		*khz = SDCFG_IMCLK_KHZ / (div << 2);
+	}
+	return SD_OK;
+}
+
+/*****************************************************************************
+ * ID           :
+ * Summary      : reduce bus clock
+ * Include      : 
+ * Declaration  : int sd_reduce_clock(int sd_port);
+ * Functions    : halve the SD clock data is transferred at, for cards which
+ *              : give CRC errors at the speed they claim to support
+ *              : stays in effect until the card is next mounted
+ * Argument     : int sd_port : channel no (0 or 1)
+ * Return       : SD_OK : end of succeed
+ *              : SD_ERR: clock is already as slow as it goes
+ * Remark       : 
+ *****************************************************************************/
+int sd_reduce_clock(int sd_port)
+{
+	SDHNDL *hndl;
+
+	if( (sd_port != 0) && (sd_port != 1) ){
+		return SD_ERR;
+	}
+
+	hndl = _sd_get_hndls(sd_port);
+	if(hndl == 0){
+		return SD_ERR;	/* not initilized */
+	}
+
+	if(hndl->clock_fallback >= SD_MAX_CLOCK_FALLBACK){
+		return SD_ERR;
+	}
+	hndl->clock_fallback++;
+	return SD_OK;
+}
+
 /*****************************************************************************
  * ID           :
  * Summary      : get card size
@@ -39,6 +39,7 @@
 #include "../inc/access/sd.h"
 
 #include "RZA1/compiler/asm/inc/asm.h"
+#include "deluge/drivers/cache/dma_cache.h"
 #include "deluge/drivers/uart/uart.h"
 
 #ifdef __CC_ARM
@@ -161,7 +162,7 @@ int _sd_write_sect(SDHNDL *hndl,unsigned char const*buff,unsigned long psn,
 		mode = SD_MODE_DMA;	/* set DMA mode */
 
 		// Flush ram
-		v7_dma_flush_range((intptr_t)buff, (intptr_t)(buff + cnt * 512));
+		dmaCacheFlush((intptr_t)buff, (intptr_t)(buff + cnt * 512));
 
 		#if		(TARGET_RZ_A1 == 1)
 		if(hndl->trans_mode & SD_MODE_DMA_64){
@@ -202,6 +202,7 @@
 /* ---- SD clock control ---- */
 #define SD_CLOCK_ENABLE		1	/* supply clock */
 #define SD_CLOCK_DISABLE	0	/* halt clock */
+#define SD_MAX_CLOCK_FALLBACK	2	/* how many times sd_reduce_clock can halve the clock */
 
 /* ---- info1 interrupt mask ---- */
 #define SD_INFO1_MASK_DET_DAT3		0x0300u		/* Card Insert and Remove (DAT3) */
@@ -467,6 +468,7 @@ typedef struct __sdhndl{				/* SD handle */
 	int				sup_if_mode;							/* supported bus width (1bit:0 4bits:1) */
 	int				partition_id;							/* Partition ID for eSD */
 	unsigned long	partition_sector_size[8];				/* CHG01 Partition sector size */
+	unsigned char	clock_fallback;							/* steps slower than csd_tran_speed, after CRC errors */
 }SDHNDL;
 
 extern SDHNDL *SDHandle[NUM_PORT];
@@ -7,13 +7,14 @@
 #define TIMER_SYSTEM_FAST 0
 #define TIMER_SYSTEM_SLOW 4
 #define TIMER_SYSTEM_SUPERFAST 1
+#define TIMER_SAMPLING_PROFILER 3 // Only used if ENABLE_SAMPLING_PROFILER
 
 #define SSI_TX_BUFFER_NUM_SAMPLES 128
 #define SSI_RX_BUFFER_NUM_SAMPLES 2048
 #define NUM_MONO_INPUT_CHANNELS (NUM_STEREO_INPUT_CHANNELS * 2)
 #define NUM_MONO_OUTPUT_CHANNELS (NUM_STEREO_OUTPUT_CHANNELS * 2)
 
-#define TRIGGER_CLOCK_INPUT_NUM_TIMES_STORED 4
+#define TRIGGER_CLOCK_INPUT_NUM_TIMES_STORED 16 // Must be a power of 2
 
 #define CACHE_LINE_SIZE 32
 
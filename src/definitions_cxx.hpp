@@ -28,6 +28,8 @@
 #define HARDWARE_TEST_MODE 0
 
 #define AUTOMATED_TESTER_ENABLED (0 && ALPHA_OR_BETA_VERSION)
+// Rather than poke at things at random, replay the fixed script in automated_tester.cpp and log how the CPU coped
+#define AUTOMATED_TESTER_SCRIPTED (1 && AUTOMATED_TESTER_ENABLED)
 
 #define ALLOW_SPAM_MODE 0 // For debugging (in buttons.cpp, audio_engine.cpp, deluge.cpp)
 
@@ -310,13 +312,26 @@ constexpr int32_t kNumModulators = 2;
 
 constexpr int32_t kMaxNumVoicesUnison = 8;
 
-// TODO: Investigate whether we can move static voices to dynamic allocation and remove these
+// Voices are allocated this many at a time. Enough slabs for kNumVoicesStatic are set up at startup and always kept,
+// and any more are given back once they've sat idle for kVoicePoolShrinkDelaySeconds
+constexpr int32_t kNumVoicesPerSlab = 8;
 constexpr int32_t kNumVoicesStatic = 24;
+constexpr int32_t kVoicePoolShrinkDelaySeconds = 10;
+// TODO: Investigate whether we can move static VoiceSamples and TimeStretchers to dynamic allocation and remove these
 constexpr int32_t kNumVoiceSamplesStatic = 20;
 constexpr int32_t kNumTimeStretchersStatic = 6;
+// Per channel-count size class. Each TimeStretcher only ever holds one buffer at a time
+constexpr int32_t kNumTimeStretcherBuffersStatic = kNumTimeStretchersStatic;
+// Stutter buffers are set up at startup, each big enough for the slowest stutter, so pressing the stutter knob never has
+// to wait on the allocator. Only one ModControllable can be stuttering at a time, as it holds UI_MODE_STUTTERING
+constexpr int32_t kNumStutterBuffersReserved = 1;
 
 constexpr int32_t kMaxNumNoteOnsPending = 64;
 
+// How far ahead of a sequenced note-on, in samples, its Sound gets the chance to ready its samples - see
+// NoteRow::prepareForUpcomingNote(). About 50mS, which is a good few Clusters' worth of loading
+constexpr int32_t kSequencedNoteLookaheadSamples = 2205;
+
 constexpr int32_t kNumUnsignedIntegersToRepPatchCables = 1;
 constexpr int32_t kMaxNumPatchCables = (kNumUnsignedIntegersToRepPatchCables * 32);
 
@@ -663,6 +678,22 @@ enum class FilterRoute {
 
 constexpr int32_t kNumFilterRoutes = util::to_underlying(FilterRoute::PARALLEL) + 1;
 
+enum class ReverbModel : uint8_t {
+	FREEVERB,
+	FDN,
+};
+
+constexpr int32_t kNumReverbModels = util::to_underlying(ReverbModel::FDN) + 1;
+
+// For the FDN reverb: HIGH is 8 delay lines, MEDIUM is 8 at half the sample rate, LOW is 4 at half the sample rate
+enum class ReverbQuality : uint8_t {
+	HIGH,
+	MEDIUM,
+	LOW,
+};
+
+constexpr int32_t kNumReverbQualities = util::to_underlying(ReverbQuality::LOW) + 1;
+
 constexpr int32_t kNumAllpassFiltersPhaser = 6;
 
 enum ErrorType {
@@ -762,6 +793,10 @@ constexpr auto kNumMIDITakeoverModes = util::to_underlying(MIDITakeoverMode::SCA
 constexpr int32_t kMIDITakeoverKnobSyncThreshold = 5;
 
 constexpr int32_t kNumClustersLoadedAhead = 2;
+// Further Clusters a SampleLowLevelReader may hold beyond those, when it's playing through them faster than the card
+// can be relied on to keep up - and how many all readers together may hold, so a big chord can't eat all the RAM
+constexpr int32_t kMaxNumClustersReadAhead = 4;
+constexpr int32_t kMaxNumClustersReadAheadTotal = 48;
 
 enum class InputMonitoringMode : uint8_t {
 	SMART,
@@ -859,6 +894,11 @@ constexpr int32_t kNumInterpolationModes = 2;
 
 constexpr int32_t kCacheByteDepth = 3;
 constexpr int32_t kCacheByteDepthMagnitude = 2; // Invalid / unused for odd numbers of bytes like 3
+// A SampleCache being read stands in for rates within 1/4096 of the ones it was made at - about half a cent, or 7mS of
+// drift over half a minute, which the next loop point or note-on puts right anyway
+constexpr int32_t kSampleCacheRateToleranceMagnitude = 12;
+// And within 1/1024, one may keep being read for a render or two, waiting for its turn to stop - see VoiceSample::render()
+constexpr int32_t kSampleCacheRateDeferMagnitude = 10;
 
 constexpr int32_t kMaxUnisonDetune = 50;
 constexpr int32_t kMaxUnisonStereoSpread = 50;
@@ -870,6 +910,8 @@ constexpr int32_t kDifferenceLPFPoles = 2;
 
 constexpr int32_t kInterpolationMaxNumSamples = 16;
 constexpr int32_t kInterpolationMaxNumSamplesMagnitude = 4;
+// Windowed sinc interpolation with just the middle of the kernel, for when the CPU is struggling
+constexpr int32_t kInterpolationReducedNumSamples = 8;
 
 enum class ClusterType {
 	EMPTY,
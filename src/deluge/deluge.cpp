@@ -53,15 +53,21 @@
 #include "gui/waveform/waveform_renderer.h"
 #include "hid/buttons.h"
 #include "hid/display/display.h"
+#include "hid/display/load_meter.h"
 #include "hid/display/seven_segment.h"
 #include "hid/encoder.h"
 #include "hid/encoders.h"
 #include "hid/led/indicator_leds.h"
 #include "hid/led/pad_leds.h"
 #include "hid/matrix/matrix_driver.h"
+#include "io/debug/boot_profile.h"
+#include "io/debug/event_trace.h"
+#include "io/debug/note_latency.h"
 #include "io/debug/print.h"
+#include "io/debug/sampling_profiler.h"
 #include "io/midi/midi_device_manager.h"
 #include "io/midi/midi_engine.h"
+#include "memory/allocation_trace.h"
 #include "memory/general_memory_allocator.h"
 #include "model/action/action_logger.h"
 #include "model/clip/instrument_clip.h"
@@ -75,10 +81,15 @@
 #include "playback/mode/session.h"
 #include "processing/engines/audio_engine.h"
 #include "processing/engines/cv_engine.h"
+#include "scheduler/task_scheduler.h"
 #include "storage/audio/audio_file_manager.h"
+#include "storage/disk_trace.h"
 #include "storage/file_item.h"
 #include "storage/flash_storage.h"
+#include "storage/performance_report.h"
+#include "storage/session_snapshot.h"
 #include "storage/storage_manager.h"
+#include "storage/sysex_file_transfer.h"
 #include "testing/hardware_testing.h"
 #include "util/container/hashtable/open_addressing_hash_table.h"
 #include "util/misc.h"
@@ -97,6 +108,7 @@ extern "C" {
 #include "RZA1/system/rza_io_regrw.h"
 #include "RZA1/uart/sio_char.h"
 #include "RZA1/usb/r_usb_basic/r_usb_basic_if.h"
+#include "drivers/dmac/dmac.h"
 #include "drivers/mtu/mtu.h"
 #include "drivers/oled/oled.h"
 #include "drivers/ssi/ssi.h"
@@ -124,6 +136,7 @@ bool allowSomeUserActionsEvenWhenInCardRoutine = false;
 
 extern "C" void timerGoneOff(void) {
 	cvEngine.updateGateOutputs();
+	AudioEngine::sendTimedMIDIOutputDue();
 	midiEngine.flushMIDI();
 }
 
@@ -324,6 +337,7 @@ bool readButtonsAndPads() {
 			ActionResult result;
 			if (Pad::isPad(util::to_underlying(value))) {
 				auto p = Pad(util::to_underlying(value));
+				Debug::NoteLatencyInput latencyInput(Debug::LatencySource::PAD);
 				result = matrixDriver.padAction(p.x, p.y, thisPadPressIsOn);
 				/* while this function takes an int32_t for velocity, 255 indicates to the downstream audition pad
 				 * function that it should use the default velocity for the instrument
@@ -511,7 +525,151 @@ extern "C" volatile uint32_t usbLock;
 
 extern "C" void usb_main_host(void);
 
+// The main loop's tasks, for taskScheduler. Their priorities and deadlines are in addMainLoopTasks()
+
+static void flushOutputsTask() {
+	// We just have to do this, regularly
+	if (display->haveOLED()) {
+		oledRoutine();
+	}
+	PIC::flush();
+}
+
+static void uiTimersTask() {
+	uiTimerManager.routine();
+}
+
+static void readInputsTask() {
+	int32_t count = 0;
+	while (readButtonsAndPads() && count < 16) {
+		if (!(count & 3)) {
+			AudioEngine::routineWithClusterLoading(true); // -----------------------------------
+		}
+		count++;
+	}
+
+	Encoders::readEncoders();
+	Encoders::interpretEncoders();
+}
+
+static void audioRecorderTask() {
+	audioRecorder.slowRoutine();
+}
+
+static void audioFileManagerTask() {
+	audioFileManager.slowRoutine();
+}
+
+static void performanceReportTask() {
+	performanceReport.routine();
+}
+
+static void launchPrefetchTask() {
+	currentPlaybackMode->prefetchUpcomingClips();
+}
+
+static void actionLoggerTask() {
+	actionLogger.slowRoutine();
+}
+
+static void loadMeterTask() {
+	deluge::hid::display::loadMeter.routine();
+}
+
+static void renderLoadOverlayTask() {
+	view.renderLoadOverlayRoutine();
+}
+
+// Slides relocatable memory together a little at a time, while the CPU has some to spare - see
+// GeneralMemoryAllocator::compactStep()
+static void compactMemoryTask() {
+	if (AudioEngine::cpuDireness) {
+		return;
+	}
+	uint32_t startCycles = Debug::readCycleCounter();
+	while (GeneralMemoryAllocator::get().compactStep() && Debug::readCycleCounter() - startCycles < 200 * Debug::uS) {}
+}
+
+#if AUTOMATED_TESTER_ENABLED
+static void automatedTesterTask() {
+	AutomatedTester::slowRoutine();
+}
+#endif
+
+// Startup doesn't wait for these - whatever's in them only matters once the user gets going
+static void readFeatureSettingsTask() {
+	runtimeFeatureSettings.readSettingsFromFile();
+	Debug::noteBootMilestone("feature settings");
+}
+
+static void readMIDIDevicesTask() {
+	MIDIDeviceManager::readDevicesFromFile(); // Hopefully we can read this file now.
+	Debug::noteBootMilestone("midi devices");
+}
+
+static void warmSessionSnapshotTask() {
+	if (sessionSnapshot.warmRoutine()) {
+		taskScheduler.addOneOffTask(&warmSessionSnapshotTask, "warm snapshot", 15, msToSamples(5));
+	}
+}
+
+// Has to come after readFeatureSettingsTask(), to know whether it's wanted
+static void resumeSessionSnapshotTask() {
+	if (sessionSnapshot.resume()) {
+		Debug::noteBootMilestone("resumed song");
+		taskScheduler.addOneOffTask(&warmSessionSnapshotTask, "warm snapshot", 15, 0);
+	}
+}
+
+static void addMainLoopTasks() {
+	// The things which have to keep happening for the Deluge to feel responsive come first
+	taskScheduler.addTask(&flushOutputsTask, "outputs", 0, 0, msToSamples(2));
+	taskScheduler.addTask(&uiTimersTask, "timers", 1, 0, msToSamples(2));
+	taskScheduler.addTask(&readInputsTask, "inputs", 2, 0, msToSamples(5));
+	taskScheduler.addTask(&doAnyPendingUIRendering, "ui render", 3, 0, msToSamples(20));
+
+	// Only actually need calling a couple of times per second, but we can't put them in uiTimerManager cos that gets
+	// called in card routine
+	taskScheduler.addTask(&audioFileManagerTask, "audio files", 10, 0, msToSamples(100));
+	taskScheduler.addTask(&AudioEngine::slowRoutine, "audio slow", 10, 0, msToSamples(100));
+	taskScheduler.addTask(&audioRecorderTask, "recorder", 10, 0, msToSamples(100));
+	taskScheduler.addTask(&launchPrefetchTask, "launch prefetch", 10, 0, msToSamples(100));
+	taskScheduler.addTask(&actionLoggerTask, "action log", 11, 0, msToSamples(100));
+	taskScheduler.addTask(&SysexFileTransfer::slowRoutine, "sysex files", 11, 0, msToSamples(100));
+	taskScheduler.addTask(&loadMeterTask, "load meter", 12, 0, msToSamples(500));
+	taskScheduler.addTask(&renderLoadOverlayTask, "track loads", 12, 0, msToSamples(500));
+	taskScheduler.addTask(&FlashStorage::routine, "flash settings", 14, msToSamples(100), msToSamples(1000));
+	taskScheduler.addTask(&performanceReportTask, "perf report", 14, msToSamples(500), msToSamples(1000));
+	taskScheduler.addTask(&compactMemoryTask, "compact memory", 18, msToSamples(20), msToSamples(1000));
+
+	taskScheduler.addOneOffTask(&readFeatureSettingsTask, "feature settings", 15, 0);
+	taskScheduler.addOneOffTask(&readMIDIDevicesTask, "midi devices", 15, 0);
+	taskScheduler.addOneOffTask(&resumeSessionSnapshotTask, "resume song", 16, 0);
+
+#if ENABLE_ALLOCATION_TRACE
+	taskScheduler.addTask(&AllocationTrace::drain, "alloc trace", 20, 0, msToSamples(100));
+#endif
+
+#if ENABLE_DISK_TRACE
+	taskScheduler.addTask(&DiskTrace::drain, "disk trace", 20, 0, msToSamples(100));
+#endif
+
+#if ENABLE_SAMPLING_PROFILER
+	taskScheduler.addTask(&Debug::SamplingProfiler::routine, "sampling profiler", 20, 0, msToSamples(1000));
+#endif
+
+#if AUTOPILOT_TEST_ENABLED
+	taskScheduler.addTask(&autoPilotStuff, "autopilot", 20, 0, msToSamples(100));
+#endif
+
+#if AUTOMATED_TESTER_ENABLED
+	taskScheduler.addTask(&automatedTesterTask, "automated tester", 20, 0, msToSamples(100));
+#endif
+}
+
 extern "C" int32_t deluge_main(void) {
+	Debug::noteBootMilestone("start");
+
 	// Piggyback off of bootloader DMA setup.
 	uint32_t oledSPIDMAConfig = (0b1101000 | (OLED_SPI_DMA_CHANNEL & 7));
 	bool have_oled = ((DMACn(OLED_SPI_DMA_CHANNEL).CHCFG_n & oledSPIDMAConfig) == oledSPIDMAConfig);
@@ -531,8 +689,6 @@ extern "C" int32_t deluge_main(void) {
 	PIC::setUARTSpeed();
 	PIC::flush();
 
-	functionsInit();
-
 #if AUTOMATED_TESTER_ENABLED
 	AutomatedTester::init();
 #endif
@@ -591,10 +747,13 @@ extern "C" int32_t deluge_main(void) {
 		setPinMux(SPI_SSL.port, SPI_SSL.pin, 3); // SSL
 		display = new deluge::hid::display::SevenSegment;
 	}
+	Debug::noteBootMilestone("display");
 
 	// Setup audio output on SSI0
 	ssiInit(0, 1);
 
+	memoryDMAInit();
+
 #if RECORD_TEST_MODE == 1
 	makeTestRecording();
 #endif
@@ -617,6 +776,7 @@ extern "C" int32_t deluge_main(void) {
 	setOutputState(CODEC.port, CODEC.pin, 1); // Enable codec
 
 	AudioEngine::init();
+	Debug::noteBootMilestone("audio engine");
 
 #if HARDWARE_TEST_MODE
 	ramTestLED();
@@ -633,6 +793,7 @@ extern "C" int32_t deluge_main(void) {
 	setPinMux(4, 6, 2);
 	setPinMux(4, 7, 2);
 	initSPIBSC(); // This will run the audio routine! Ideally, have external RAM set up by now.
+	Debug::noteBootMilestone("spibsc");
 
 	PIC::requestFirmwareVersion(); // Request PIC firmware version
 	PIC::resendButtonStates();     // Tell PIC to re-send button states
@@ -684,9 +845,10 @@ extern "C" int32_t deluge_main(void) {
 	});
 
 	FlashStorage::readSettings();
+	Debug::noteBootMilestone("flash settings");
 
+	// Just the defaults for now. What's on the card gets read once the main loop's going, by readFeatureSettingsTask()
 	runtimeFeatureSettings.init();
-	runtimeFeatureSettings.readSettingsFromFile();
 
 	usbLock = 1;
 	openUSBHost();
@@ -699,14 +861,17 @@ extern "C" int32_t deluge_main(void) {
 	}
 
 	usbLock = 0;
+	Debug::noteBootMilestone("usb");
 
 	// Ideally I'd like to repeatedly switch between host and peripheral mode anytime there's no USB connection.
 	// To do that, I'd really need to know at any point in time whether the user had just made a connection, just then, that hadn't fully
 	// initialized yet. I think I sorta have that for host, but not for peripheral yet.
 
-	MIDIDeviceManager::readDevicesFromFile(); // Hopefully we can read this file now.
+	// MIDIDevices.XML gets read by readMIDIDevicesTask(), once the main loop's going. Anything plugged in before then
+	// just gets its settings applied a moment later
 
 	setupBlankSong(); // Can only happen after settings, which includes default settings, have been read
+	Debug::noteBootMilestone("blank song");
 
 #ifdef TEST_BST
 	BST bst;
@@ -784,49 +949,13 @@ extern "C" int32_t deluge_main(void) {
 
 	uiTimerManager.setTimer(TIMER_GRAPHICS_ROUTINE, 50);
 
+	addMainLoopTasks();
+
 	Debug::println("going into main loop");
+	Debug::noteBootMilestone("main loop");
 	sdRoutineLock = false; // Allow SD routine to start happening
 
-	while (1) {
-
-		uiTimerManager.routine();
-
-		// Flush stuff - we just have to do this, regularly
-		if (display->haveOLED()) {
-			oledRoutine();
-		}
-		PIC::flush();
-
-		AudioEngine::routineWithClusterLoading(true); // -----------------------------------
-
-		int32_t count = 0;
-		while (readButtonsAndPads() && count < 16) {
-			if (!(count & 3)) {
-				AudioEngine::routineWithClusterLoading(true); // -----------------------------------
-			}
-			count++;
-		}
-
-		Encoders::readEncoders();
-		bool anything = Encoders::interpretEncoders();
-		if (anything) {
-			AudioEngine::routineWithClusterLoading(true); // -----------------------------------
-		}
-
-		doAnyPendingUIRendering();
-
-		AudioEngine::routineWithClusterLoading(true); // -----------------------------------
-
-		// Only actually needs calling a couple of times per second, but we can't put it in uiTimerManager cos that gets called in card routine
-		audioFileManager.slowRoutine();
-		AudioEngine::slowRoutine();
-
-		audioRecorder.slowRoutine();
-
-#if AUTOPILOT_TEST_ENABLED
-		autoPilotStuff();
-#endif
-	}
+	taskScheduler.run();
 
 	return 0;
 }
@@ -849,6 +978,7 @@ extern "C" void routineForSD(void) {
 	}
 
 	sdRoutineLock = true;
+	TRACE_SCOPE(CARD_ROUTINE);
 
 	AudioEngine::logAction("from routineForSD()");
 	AudioEngine::routine();
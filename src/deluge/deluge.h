@@ -27,6 +27,7 @@ extern int main(void);
 extern int32_t deluge_main(void);
 
 extern void timerGoneOff(void);
+extern void triggerClockRisingEdgeReceived(uint32_t time);
 
 extern void routineWithClusterLoading(void);
 extern void loadAnyEnqueuedClustersRoutine(void);
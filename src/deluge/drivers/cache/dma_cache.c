@@ -0,0 +1,42 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "drivers/cache/dma_cache.h"
+#include "RZA1/cache/cache.h"
+#include "RZA1/compiler/asm/inc/asm.h"
+
+// Small buffers that get DMA'd all the time - the UART transmit buffers, the SSI buffers, RTT's - are instead only ever
+// written through their UNCACHED_MIRROR_OFFSET addresses, so never need any of this
+
+void dmaCacheInvalidate(uintptr_t start, uintptr_t end) {
+	if (end - start >= DMA_CACHE_WHOLE_CACHE_THRESHOLD) {
+		// A plain invalidate by set and way would lose whatever else the CPU had written and not yet written back
+		L1_D_CacheWritebackFlushAll();
+	}
+	else {
+		v7_dma_inv_range(start, end);
+	}
+}
+
+void dmaCacheFlush(uintptr_t start, uintptr_t end) {
+	if (end - start >= DMA_CACHE_WHOLE_CACHE_THRESHOLD) {
+		L1_D_CacheWritebackFlushAll();
+	}
+	else {
+		v7_dma_flush_range(start, end);
+	}
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Cache maintenance for memory a DMA transfer is about to read or write. A range gets walked one cache line at a time,
+// so for a big enough one it's cheaper to clean and invalidate the whole L1 data cache by set and way instead. That
+// costs the same however big the transfer is, but throws away everything else that was cached too, so we only switch
+// over once the range is twice the size of the cache - the L1 data cache is 32KB
+#define DMA_CACHE_WHOLE_CACHE_THRESHOLD (64 * 1024)
+
+// Before a DMA writes to [start, end), so nothing dirty in the cache there can later get written back over what it
+// wrote. Also after, if the CPU might have speculatively fetched any of it meanwhile
+void dmaCacheInvalidate(uintptr_t start, uintptr_t end);
+
+// Before a DMA reads from [start, end), so anything still only in the cache has got to memory
+void dmaCacheFlush(uintptr_t start, uintptr_t end);
+
+#ifdef __cplusplus
+}
+#endif
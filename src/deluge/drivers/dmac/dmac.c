@@ -16,6 +16,9 @@
  */
 
 #include "drivers/dmac/dmac.h"
+#include "RZA1/intc/devdrv_intc.h"
+#include "definitions.h"
+#include "drivers/cache/dma_cache.h"
 
 void setDMARS(int32_t dmaChannel, uint32_t dmarsValue) {
 
@@ -42,3 +45,89 @@ void dmaChannelStart(const uint32_t dma_channel) {
 	DMACn(dma_channel).CHCTRL_n |= DMAC_CHCTRL_0S_SWRST; // Status clear
 	DMACn(dma_channel).CHCTRL_n |= DMAC_CHCTRL_0S_SETEN; // Enable DMA transfer
 }
+
+// Memory to memory transfers on MEMORY_DMA_CHANNEL. There's no peripheral involved, so each one's a single block,
+// kicked off by software, 32 bits at a time, with an interrupt at the end
+#define MEMORY_DMA_CONFIG                                                                                              \
+	(DMAC0_CHCFG_n_TM | (0b0010 << DMAC0_CHCFG_n_DDS_SHIFT) | (0b0010 << DMAC0_CHCFG_n_SDS_SHIFT)                      \
+	 | (0b100 << DMAC0_CHCFG_n_AM_SHIFT) | (MEMORY_DMA_CHANNEL & 7))
+
+static volatile bool memoryDMAInProgress = false;
+static MemoryDMACallback memoryDMACallback;
+static void* memoryDMACallbackContext;
+static uint32_t memoryDMADestStart;
+static uint32_t memoryDMADestEnd;
+
+// What memoryDMAFill() copies from, over and over. It's only ever written through its uncached mirror, so it never
+// needs flushing - and it gets its own cache line so nothing else's caching can drag it in dirty
+static uint32_t memoryDMAFillValue __attribute__((aligned(CACHE_LINE_SIZE)));
+
+static void memoryDMAComplete(uint32_t int_sense) {
+	DMACn(MEMORY_DMA_CHANNEL).CHCTRL_n = DMAC_CHCTRL_0S_CLREND | DMAC_CHCTRL_0S_CLRTC;
+
+	// The CPU may have speculatively pulled some of the destination into the cache while the transfer was going
+	dmaCacheInvalidate(memoryDMADestStart, memoryDMADestEnd);
+
+	memoryDMAInProgress = false;
+	if (memoryDMACallback) {
+		memoryDMACallback(memoryDMACallbackContext);
+	}
+}
+
+void memoryDMAInit(void) {
+	DCTRLn(MEMORY_DMA_CHANNEL) = 0;
+	DMACn(MEMORY_DMA_CHANNEL).CHITVL_n = 0;
+	DMACn(MEMORY_DMA_CHANNEL).CHEXT_n = 0;
+	setDMARS(MEMORY_DMA_CHANNEL, 0); // No peripheral - auto request
+
+	R_INTC_RegistIntFunc(DMA_INTERRUPT_0 + MEMORY_DMA_CHANNEL, memoryDMAComplete);
+	R_INTC_SetPriority(DMA_INTERRUPT_0 + MEMORY_DMA_CHANNEL, 13); // Whoever's waiting can wait a little longer
+	R_INTC_Enable(DMA_INTERRUPT_0 + MEMORY_DMA_CHANNEL);
+}
+
+bool memoryDMABusy(void) {
+	return memoryDMAInProgress;
+}
+
+// The destination has to cover whole cache lines, or invalidating it at the end could lose whatever the CPU had
+// written to the rest of a line meanwhile. The source just has to be word aligned. Returns false, having done
+// nothing, if the transfer can't be done like that or the channel's busy - in which case the caller should do it itself
+static bool memoryDMAStart(void* dest, uint32_t source, uint32_t numBytes, bool sourceFixed,
+                           MemoryDMACallback callback, void* context) {
+	if (memoryDMAInProgress || !numBytes || (((uint32_t)dest | numBytes) & (CACHE_LINE_SIZE - 1)) || (source & 3)) {
+		return false;
+	}
+
+	memoryDMAInProgress = true;
+	memoryDMACallback = callback;
+	memoryDMACallbackContext = context;
+	memoryDMADestStart = (uint32_t)dest;
+	memoryDMADestEnd = (uint32_t)dest + numBytes;
+
+	// Anything still only in the cache has to get to memory first, and nothing stale of the destination can be left
+	// there to get written back over what we transfer
+	if (!sourceFixed) {
+		dmaCacheFlush(source, source + numBytes);
+	}
+	dmaCacheFlush(memoryDMADestStart, memoryDMADestEnd);
+
+	DMACn(MEMORY_DMA_CHANNEL).CHCTRL_n = DMAC_CHCTRL_0S_SWRST | DMAC_CHCTRL_0S_CLRTC;
+	DMACn(MEMORY_DMA_CHANNEL).CHCFG_n = MEMORY_DMA_CONFIG | (sourceFixed ? DMAC0_CHCFG_n_SAD : 0);
+	DMACn(MEMORY_DMA_CHANNEL).N0SA_n = source;
+	DMACn(MEMORY_DMA_CHANNEL).N0DA_n = (uint32_t)dest;
+	DMACn(MEMORY_DMA_CHANNEL).N0TB_n = numBytes;
+	DMACn(MEMORY_DMA_CHANNEL).CHCTRL_n = DMAC_CHCTRL_0S_SETEN | DMAC0_CHCTRL_n_STG;
+	return true;
+}
+
+bool memoryDMACopy(void* dest, const void* source, uint32_t numBytes, MemoryDMACallback callback, void* context) {
+	return memoryDMAStart(dest, (uint32_t)source, numBytes, false, callback, context);
+}
+
+bool memoryDMAFill(void* dest, uint32_t value, uint32_t numBytes, MemoryDMACallback callback, void* context) {
+	if (memoryDMAInProgress) {
+		return false;
+	}
+	*(volatile uint32_t*)((uint32_t)&memoryDMAFillValue + UNCACHED_MIRROR_OFFSET) = value;
+	return memoryDMAStart(dest, (uint32_t)&memoryDMAFillValue, numBytes, true, callback, context);
+}
@@ -20,9 +20,18 @@
 #include "RZA1/cpu_specific.h"
 #include "RZA1/system/iobitmasks/dmac_iobitmask.h"
 #include "RZA1/system/iodefines/dmac_iodefine.h"
+#include <stdbool.h>
+#include <stdint.h>
 
 #define DMA_INTERRUPT_0 INTC_ID_DMAINT0
 
 void setDMARS(int32_t dmaChannel, uint32_t dmarsValue);
 void initDMAWithLinkDescriptor(int32_t dma_channel, const uint32_t* linkDescriptor, uint32_t dmarsValue);
 void dmaChannelStart(const uint32_t dma_channel);
+
+typedef void (*MemoryDMACallback)(void* context);
+
+void memoryDMAInit(void);
+bool memoryDMACopy(void* dest, const void* source, uint32_t numBytes, MemoryDMACallback callback, void* context);
+bool memoryDMAFill(void* dest, uint32_t value, uint32_t numBytes, MemoryDMACallback callback, void* context);
+bool memoryDMABusy(void);
@@ -17,6 +17,8 @@
 
 #include "definitions.h"
 
+#include "RZA1/compiler/asm/inc/asm.h"
+#include "RZA1/intc/devdrv_intc.h"
 #include "RZA1/oled/oled_low_level.h"
 #include "RZA1/uart/sio_char.h"
 #include "drivers/dmac/dmac.h"
@@ -116,6 +118,14 @@ void enqueueSPITransfer(int32_t destinationId, uint8_t const* image) {
 	}
 	*/
 
+	// CV values can now get enqueued from the MIDI / gate output timer ISR, so when we're not in an ISR ourselves, stop
+	// one of those cutting in between us claiming a queue position and kicking off sending.
+	bool interruptsDisabled = false;
+	if (intc_func_active == 0) {
+		__disable_irq();
+		interruptsDisabled = true;
+	}
+
 	spiTransferQueue[spiTransferQueueWritePos].destinationId = destinationId;
 	spiTransferQueue[spiTransferQueueWritePos].dataAddress = image;
 	spiTransferQueueWritePos = (spiTransferQueueWritePos + 1) & (SPI_TRANSFER_QUEUE_SIZE - 1);
@@ -125,6 +135,10 @@ void enqueueSPITransfer(int32_t destinationId, uint8_t const* image) {
 	if (!spiTransferQueueCurrentlySending && spiTransferQueueWritePos != spiTransferQueueReadPos) {
 		sendSPITransferFromQueue();
 	}
+
+	if (interruptsDisabled) {
+		__enable_irq();
+	}
 }
 
 void oledDMAInit() {
@@ -155,7 +155,7 @@ int32_t uartFlush(int32_t item) {
 	DMACn(txDmaChannels[item]).N0TB_n = num;
 	uint32_t dataAddress = (uint32_t)&txBuffers[item][prevReadPos];
 	DMACn(txDmaChannels[item]).N0SA_n = dataAddress;
-	v7_dma_flush_range(dataAddress, dataAddress + num);
+	// No need to flush anything - bufferPICUart() and friends only ever write to the buffer's uncached mirror
 
 	return 1;
 }
@@ -222,6 +222,9 @@ uint8_t uartGetChar(int32_t item, char* readData) {
 	return 1;
 }
 
+// Handed out in place of a captured time which has since been overwritten. 0 means "no time known - treat as now"
+static uint32_t unknownTiming = 0;
+
 uint32_t* uartGetCharWithTiming(int32_t timingCaptureItem, char* readData) {
 
 	int32_t item = timingCaptureItems[timingCaptureItem];
@@ -237,6 +240,16 @@ uint32_t* uartGetCharWithTiming(int32_t timingCaptureItem, char* readData) {
 
 	int32_t readPos = (uint32_t)rxBufferReadAddr[item] - ((uint32_t)rxBuffers[item]);
 
+	// The timing buffer is smaller than the data one. If we've fallen further behind than its length, this byte's
+	// timing entry has already been overwritten by a later byte's, and using that would make it look more recent than
+	// it was. Better to admit we don't know
+	int32_t numBytesWaiting = ((uint32_t)currentWritePos - (uint32_t)rxBufferReadAddr[item]) & (rxBufferSizes[item] - 1);
+	if (numBytesWaiting > timingCaptureBufferSizes[timingCaptureItem]) {
+		readPos = (readPos + 1) & (rxBufferSizes[item] - 1);
+		rxBufferReadAddr[item] = rxBuffers[item] + readPos;
+		return &unknownTiming;
+	}
+
 	uint32_t* timer =
 	    (uint32_t*)((uint32_t)&timingCaptureBuffers[timingCaptureItem]
 	                                               [readPos & (timingCaptureBufferSizes[timingCaptureItem] - 1)]
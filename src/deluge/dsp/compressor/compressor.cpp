@@ -19,7 +19,9 @@
 #include "definitions_cxx.hpp"
 #include "model/song/song.h"
 #include "playback/playback_handler.h"
+#include "processing/engines/audio_engine.h"
 #include "storage/flash_storage.h"
+#include "util/container/static_vector.hpp"
 #include "util/lookuptables/lookuptables.h"
 
 Compressor::Compressor() {
@@ -29,6 +31,8 @@ Compressor::Compressor() {
 	attack = getParamFromUserValue(Param::Static::COMPRESSOR_ATTACK, 7);
 	release = getParamFromUserValue(Param::Static::COMPRESSOR_RELEASE, 28);
 	pendingHitStrength = 0;
+	envelopeOffset = 0;
+	envelopeHeight = 0;
 
 	// I'm so sorry, this is incredibly ugly, but in order to decide the default sync level, we have to look at the current song, or even better the one being preloaded.
 	// Default sync level is used obviously for the default synth sound if no SD card inserted, but also some synth presets, possibly just older ones,
@@ -121,7 +125,72 @@ int32_t Compressor::getActualReleaseRate() {
 	return alteredRelease;
 }
 
+namespace {
+
+// Everything that goes into one Compressor::render() call, and the envelope state that comes out of it
+struct SideChainBusEntry {
+	struct Input {
+		EnvelopeStage status;
+		uint32_t pos;
+		int32_t lastValue;
+		int32_t pendingHitStrength;
+		int32_t envelopeOffset;
+		int32_t envelopeHeight;
+		int32_t attack;
+		int32_t release;
+		SyncLevel syncLevel;
+		int32_t shapeValue;
+		uint16_t numSamples;
+
+		bool operator==(Input const& other) const = default;
+	} input;
+
+	EnvelopeStage status;
+	uint32_t pos;
+	int32_t lastValue;
+	int32_t envelopeOffset;
+	int32_t envelopeHeight;
+};
+
+// When a dozen tracks are ducked off the same kick with the same attack / release / shape, their Compressors all go
+// into each render block in exactly the same state, so they'd all come out of it the same too. The first one to
+// render a block leaves its result here and the rest just copy it. Entries only last for the block they were made in,
+// since synced attack and release rates also depend on the tempo.
+deluge::static_vector<SideChainBusEntry, 8> sideChainBus;
+uint32_t sideChainBusTime = 0;
+
+} // namespace
+
 int32_t Compressor::render(uint16_t numSamples, int32_t shapeValue) {
+	if (sideChainBusTime != AudioEngine::audioSampleTimer) {
+		sideChainBusTime = AudioEngine::audioSampleTimer;
+		sideChainBus.clear();
+	}
+
+	SideChainBusEntry::Input input = {status,  pos,     lastValue, pendingHitStrength, envelopeOffset, envelopeHeight,
+	                                  attack,  release, syncLevel, shapeValue,         numSamples};
+
+	for (SideChainBusEntry const& entry : sideChainBus) {
+		if (entry.input == input) {
+			status = entry.status;
+			pos = entry.pos;
+			lastValue = entry.lastValue;
+			envelopeOffset = entry.envelopeOffset;
+			envelopeHeight = entry.envelopeHeight;
+			pendingHitStrength = 0;
+			return lastValue - ONE_Q31;
+		}
+	}
+
+	int32_t output = renderEnvelope(numSamples, shapeValue);
+
+	// If it's full, this one just doesn't get shared
+	sideChainBus.try_push_back(SideChainBusEntry{input, status, pos, lastValue, envelopeOffset, envelopeHeight});
+
+	return output;
+}
+
+int32_t Compressor::renderEnvelope(uint16_t numSamples, int32_t shapeValue) {
 
 	// Initial hit detected...
 	if (pendingHitStrength != 0) {
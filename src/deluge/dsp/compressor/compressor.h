@@ -46,6 +46,7 @@ public:
 	void registerHitRetrospectively(int32_t strength, uint32_t numSamplesAgo);
 
 private:
+	int32_t renderEnvelope(uint16_t numSamples, int32_t shapeValue);
 	int32_t getActualAttackRate();
 	int32_t getActualReleaseRate();
 };
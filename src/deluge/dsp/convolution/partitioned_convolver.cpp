@@ -0,0 +1,193 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "dsp/convolution/partitioned_convolver.h"
+#include "arm_neon.h"
+#include "definitions_cxx.hpp"
+#include "dsp/fft/fft_config_manager.h"
+#include "memory/general_memory_allocator.h"
+#include "util/functions.h"
+#include <cstring>
+
+namespace deluge::dsp {
+
+// Shared by every convolver, since only one works on a partition at a time
+static int32_t fftTimeDomain[PartitionedConvolver::kFFTSize];
+static ne10_fft_cpx_int32_t spectrumSum[PartitionedConvolver::kNumBins];
+
+PartitionedConvolver::PartitionedConvolver() {
+	fftConfig = NULL;
+	numPartitions = 0;
+	headroomMagnitude = 0;
+	spectra = NULL;
+	reset();
+}
+
+PartitionedConvolver::~PartitionedConvolver() {
+	discard();
+}
+
+void PartitionedConvolver::discard() {
+	if (spectra) {
+		delugeDealloc(spectra);
+		spectra = NULL;
+	}
+	numPartitions = 0;
+}
+
+int32_t PartitionedConvolver::setImpulseResponse(int32_t const* impulseResponse, int32_t length) {
+	discard();
+	if (length <= 0) {
+		return NO_ERROR;
+	}
+
+	fftConfig = FFTConfigManager::getConfig(kFFTSizeMagnitude);
+	if (!fftConfig) {
+		return ERROR_INSUFFICIENT_RAM;
+	}
+
+	int32_t newNumPartitions = ((length - 1) >> kPartitionSizeMagnitude) + 1;
+
+	// Room for the impulse response's spectra, then each channel's input spectra
+	spectra = (ne10_fft_cpx_int32_t*)GeneralMemoryAllocator::get().alloc(
+	    newNumPartitions * 3 * kNumBins * sizeof(ne10_fft_cpx_int32_t), NULL, false, true);
+	if (!spectra) {
+		return ERROR_INSUFFICIENT_RAM;
+	}
+
+	// No bin of the summed spectrum can be bigger than the biggest input value times the sum of the impulse response's
+	// absolute values - so scale the impulse response down until that's no more than 1. We scale back up at the end
+	uint64_t absoluteSum = 0;
+	for (int32_t i = 0; i < length; i++) {
+		absoluteSum += std::abs((int64_t)impulseResponse[i]);
+	}
+	headroomMagnitude = 0;
+	while ((absoluteSum >> headroomMagnitude) > 2147483647u) {
+		headroomMagnitude++;
+	}
+
+	for (int32_t p = 0; p < newNumPartitions; p++) {
+		int32_t const* partitionStart = &impulseResponse[p << kPartitionSizeMagnitude];
+		int32_t numSamplesThisPartition = std::min(kPartitionSize, length - (p << kPartitionSizeMagnitude));
+
+		// Each partition goes in the first half, with zeros after. Overlap-save then only keeps the second half of
+		// each inverse transform, where none of the circular convolution has wrapped around
+		for (int32_t i = 0; i < numSamplesThisPartition; i++) {
+			fftTimeDomain[i] = partitionStart[i] >> headroomMagnitude;
+		}
+		memset(&fftTimeDomain[numSamplesThisPartition], 0, (kFFTSize - numSamplesThisPartition) * sizeof(int32_t));
+
+		ne10_fft_r2c_1d_int32_neon(&spectra[p * kNumBins], fftTimeDomain, fftConfig, false);
+	}
+
+	numPartitions = newNumPartitions;
+	reset();
+	return NO_ERROR;
+}
+
+void PartitionedConvolver::reset() {
+	memset(inputHistory, 0, sizeof(inputHistory));
+	memset(output, 0, sizeof(output));
+	if (spectra) {
+		memset(&spectra[numPartitions * kNumBins], 0, numPartitions * 2 * kNumBins * sizeof(ne10_fft_cpx_int32_t));
+	}
+	newestInputSpectrum = 0;
+	posInPartition = 0;
+}
+
+void PartitionedConvolver::process(StereoSample* buffer, int32_t numSamples) {
+	if (!numPartitions) {
+		return;
+	}
+
+	StereoSample* bufferEnd = buffer + numSamples;
+	while (buffer != bufferEnd) {
+		int32_t numSamplesNow = std::min<int32_t>(kPartitionSize - posInPartition, bufferEnd - buffer);
+
+		for (int32_t i = 0; i < numSamplesNow; i++) {
+			inputHistory[0][kPartitionSize + posInPartition + i] = buffer[i].l;
+			inputHistory[1][kPartitionSize + posInPartition + i] = buffer[i].r;
+			buffer[i].l = output[0][posInPartition + i];
+			buffer[i].r = output[1][posInPartition + i];
+		}
+
+		buffer += numSamplesNow;
+		posInPartition += numSamplesNow;
+		if (posInPartition == kPartitionSize) {
+			processPartition();
+			posInPartition = 0;
+		}
+	}
+}
+
+// sum += a * b, for every bin. Each product is q31, so this is exactly what the inverse FFT needs
+[[gnu::always_inline]] static inline void multiplyAccumulateSpectra(ne10_fft_cpx_int32_t* __restrict__ sum,
+                                                                    ne10_fft_cpx_int32_t const* __restrict__ a,
+                                                                    ne10_fft_cpx_int32_t const* __restrict__ b) {
+	int32_t bin = 0;
+	for (; bin <= PartitionedConvolver::kNumBins - 4; bin += 4) {
+		int32x4x2_t aNow = vld2q_s32((int32_t const*)&a[bin]);
+		int32x4x2_t bNow = vld2q_s32((int32_t const*)&b[bin]);
+		int32x4x2_t sumNow = vld2q_s32((int32_t*)&sum[bin]);
+
+		sumNow.val[0] = vaddq_s32(sumNow.val[0], vqdmulhq_s32(aNow.val[0], bNow.val[0]));
+		sumNow.val[0] = vsubq_s32(sumNow.val[0], vqdmulhq_s32(aNow.val[1], bNow.val[1]));
+		sumNow.val[1] = vaddq_s32(sumNow.val[1], vqdmulhq_s32(aNow.val[0], bNow.val[1]));
+		sumNow.val[1] = vaddq_s32(sumNow.val[1], vqdmulhq_s32(aNow.val[1], bNow.val[0]));
+
+		vst2q_s32((int32_t*)&sum[bin], sumNow);
+	}
+
+	for (; bin < PartitionedConvolver::kNumBins; bin++) {
+		sum[bin].r += (multiply_32x32_rshift32(a[bin].r, b[bin].r) - multiply_32x32_rshift32(a[bin].i, b[bin].i)) << 1;
+		sum[bin].i += (multiply_32x32_rshift32(a[bin].r, b[bin].i) + multiply_32x32_rshift32(a[bin].i, b[bin].r)) << 1;
+	}
+}
+
+void PartitionedConvolver::processPartition() {
+	if (++newestInputSpectrum == numPartitions) {
+		newestInputSpectrum = 0;
+	}
+
+	for (int32_t c = 0; c < 2; c++) {
+		ne10_fft_cpx_int32_t* inputSpectra = &spectra[numPartitions * (1 + c) * kNumBins];
+
+		// Transform the last two partitions' worth of input. Scaled, so it can't overflow
+		memcpy(fftTimeDomain, inputHistory[c], sizeof(fftTimeDomain));
+		ne10_fft_r2c_1d_int32_neon(&inputSpectra[newestInputSpectrum * kNumBins], fftTimeDomain, fftConfig, true);
+
+		// Each partition of the impulse response gets multiplied by the input from that many partitions ago
+		memset(spectrumSum, 0, sizeof(spectrumSum));
+		int32_t inputSpectrumIndex = newestInputSpectrum;
+		for (int32_t p = 0; p < numPartitions; p++) {
+			multiplyAccumulateSpectra(spectrumSum, &spectra[p * kNumBins], &inputSpectra[inputSpectrumIndex * kNumBins]);
+			if (--inputSpectrumIndex < 0) {
+				inputSpectrumIndex = numPartitions - 1;
+			}
+		}
+
+		// Unscaled, which undoes the forward transform's scaling
+		ne10_fft_c2r_1d_int32_neon(fftTimeDomain, spectrumSum, fftConfig, false);
+		for (int32_t i = 0; i < kPartitionSize; i++) {
+			output[c][i] = lshiftAndSaturateUnknown(fftTimeDomain[kPartitionSize + i], headroomMagnitude);
+		}
+
+		memcpy(inputHistory[c], &inputHistory[c][kPartitionSize], kPartitionSize * sizeof(int32_t));
+	}
+}
+
+} // namespace deluge::dsp
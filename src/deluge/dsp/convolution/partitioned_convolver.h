@@ -0,0 +1,74 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "NE10.h"
+#include "dsp/stereo_sample.h"
+#include <cstdint>
+
+namespace deluge::dsp {
+
+/**
+ * Convolves stereo audio with an impulse response of any length, by uniformly partitioned overlap-save FFT
+ * convolution. The impulse response is cut into partitions of kPartitionSize samples, each transformed to the
+ * frequency domain once, when it's set. Each kPartitionSize samples of input then cost one forward and one inverse FFT
+ * per channel, plus a complex multiply-accumulate per bin per partition - so unlike ImpulseResponseProcessor's direct
+ * convolution, impulse responses can be hundreds of milliseconds long.
+ *
+ * The output lags the input by kPartitionSize samples.
+ */
+class PartitionedConvolver {
+public:
+	static constexpr int32_t kPartitionSizeMagnitude = 7;
+	static constexpr int32_t kPartitionSize = 1 << kPartitionSizeMagnitude;
+	static constexpr int32_t kFFTSizeMagnitude = kPartitionSizeMagnitude + 1;
+	static constexpr int32_t kFFTSize = 1 << kFFTSizeMagnitude;
+	static constexpr int32_t kNumBins = (kFFTSize >> 1) + 1;
+
+	PartitionedConvolver();
+	~PartitionedConvolver();
+
+	/// Takes the impulse response as q31, and transforms it. Returns error code
+	int32_t setImpulseResponse(int32_t const* impulseResponse, int32_t length);
+	void discard();
+	/// Forgets all input so far, so nothing rings out
+	void reset();
+	bool isActive() const { return (numPartitions != 0); }
+
+	/// Replaces the contents of the buffer with their convolution with the impulse response. Any number of samples
+	void process(StereoSample* buffer, int32_t numSamples);
+
+private:
+	void processPartition();
+
+	ne10_fft_r2c_cfg_int32_t fftConfig;
+	int32_t numPartitions;
+	int32_t headroomMagnitude; // How much the impulse response got scaled down by to make sure sums couldn't overflow
+
+	// One block of memory, containing first the impulse response's partitions, then the spectra of the last
+	// numPartitions partitions of input for each channel
+	ne10_fft_cpx_int32_t* spectra;
+	int32_t newestInputSpectrum; // The input spectra for each channel are a ring
+
+	// The last partition's input, followed by this one's as it arrives
+	int32_t inputHistory[2][kFFTSize];
+	int32_t output[2][kPartitionSize];
+	int32_t posInPartition;
+};
+
+} // namespace deluge::dsp
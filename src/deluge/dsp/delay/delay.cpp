@@ -83,7 +83,7 @@ setupSecondaryBuffer:
 			    && sizeLeftUntilBufferSwap == getAmountToWriteBeforeReadingBegins()) {
 
 				int32_t idealBufferSize = secondaryBuffer.getIdealBufferSizeFromRate(userDelayRate);
-				idealBufferSize = std::min(idealBufferSize, (int32_t)DELAY_BUFFER_MAX_SIZE);
+				idealBufferSize = std::min(idealBufferSize, DelayBuffer::getMaxSize());
 				idealBufferSize = std::max(idealBufferSize, (int32_t)DELAY_BUFFER_MIN_SIZE);
 
 				if (idealBufferSize != secondaryBuffer.size) {
@@ -16,14 +16,18 @@
 */
 
 #include "dsp/delay/delay_buffer.h"
+#include "arm_neon.h"
+#include "definitions_cxx.hpp"
 #include "dsp/stereo_sample.h"
 #include "memory/general_memory_allocator.h"
+#include "model/settings/runtime_feature_settings.h"
 #include "processing/engines/audio_engine.h"
 #include "util/functions.h"
 #include <string.h>
 
 DelayBuffer::DelayBuffer() {
 	bufferStart = 0;
+	isFromStutterReserve = false;
 }
 
 DelayBuffer::~DelayBuffer() {
@@ -31,7 +35,7 @@ DelayBuffer::~DelayBuffer() {
 }
 
 // Returns error status
-uint8_t DelayBuffer::init(uint32_t newRate, uint32_t failIfThisSize, bool includeExtraSpace) {
+uint8_t DelayBuffer::init(uint32_t newRate, uint32_t failIfThisSize, bool includeExtraSpace, bool fromStutterReserve) {
 
 	//Uart::println("init buffer");
 	nativeRate = newRate;
@@ -42,8 +46,9 @@ uint8_t DelayBuffer::init(uint32_t newRate, uint32_t failIfThisSize, bool includ
 
 	bool mustMakeRatePrecise = false;
 
-	if (size > DELAY_BUFFER_MAX_SIZE) {
-		size = DELAY_BUFFER_MAX_SIZE;
+	uint32_t maxSize = getMaxSize();
+	if (size > maxSize) {
+		size = maxSize;
 		mustMakeRatePrecise = true;
 	}
 
@@ -63,8 +68,14 @@ uint8_t DelayBuffer::init(uint32_t newRate, uint32_t failIfThisSize, bool includ
 	sizeIncludingExtra = size + (includeExtraSpace ? delaySpaceBetweenReadAndWrite : 0);
 	AudioEngine::logAction("DelayBuffer::init before");
 
-	bufferStart = (StereoSample*)GeneralMemoryAllocator::get().alloc(sizeIncludingExtra * sizeof(StereoSample), NULL,
-	                                                                 false, true);
+	if (fromStutterReserve) {
+		bufferStart = AudioEngine::solicitStutterBuffer(sizeIncludingExtra);
+	}
+	else {
+		bufferStart = (StereoSample*)GeneralMemoryAllocator::get().alloc(sizeIncludingExtra * sizeof(StereoSample),
+		                                                                 NULL, false, true);
+	}
+	isFromStutterReserve = fromStutterReserve;
 	AudioEngine::logAction("DelayBuffer::init after");
 	if (bufferStart == 0) {
 		return ERROR_INSUFFICIENT_RAM;
@@ -85,6 +96,15 @@ int32_t DelayBuffer::getIdealBufferSizeFromRate(uint32_t newRate) {
 	return (uint64_t)DELAY_BUFFER_NEUTRAL_SIZE * 16777216 / newRate;
 }
 
+// With the memory saver on, long delays get a buffer half the usual size, which then spins at half the rate - so
+// they lose the top half of their bandwidth rather than any length, much like a tape delay would
+int32_t DelayBuffer::getMaxSize() {
+	if (runtimeFeatureSettings.get(RuntimeFeatureSettingType::DelayMemorySaver) == RuntimeFeatureStateToggle::On) {
+		return DELAY_BUFFER_MAX_SIZE >> 1;
+	}
+	return DELAY_BUFFER_MAX_SIZE;
+}
+
 void DelayBuffer::makeNativeRatePrecise() {
 	nativeRate = round((double)DELAY_BUFFER_NEUTRAL_SIZE * (double)16777216 / (double)size);
 }
@@ -97,7 +117,12 @@ void DelayBuffer::makeNativeRatePreciseRelativeToOtherBuffer(DelayBuffer* otherB
 
 void DelayBuffer::discard(bool beingDestructed) {
 	if (bufferStart) {
-		delugeDealloc(bufferStart);
+		if (isFromStutterReserve) {
+			AudioEngine::stutterBufferUnassigned(bufferStart);
+		}
+		else {
+			delugeDealloc(bufferStart);
+		}
 		if (!beingDestructed) {
 			bufferStart = NULL; // If destructing, writing anything would be a waste of time
 		}
@@ -173,3 +198,152 @@ void DelayBuffer::setupForRender(int32_t userDelayRate, DelayBufferSetup* setup)
 		}
 	}
 }
+
+// Where bufferCurrentPos had got to, and strength2, for each sample of the block writeResampledBlock() is doing
+static StereoSample* blockCurrentPos[SSI_TX_BUFFER_NUM_SAMPLES];
+static int32_t blockStrength2[SSI_TX_BUFFER_NUM_SAMPLES];
+
+// Adds multiply_32x32_rshift32(toDelay, strength) << shift to both channels of writePos
+template <int32_t shift>
+[[gnu::always_inline]] static inline void addToDelayPos(StereoSample* writePos, int32x2_t toDelay, int32_t strength) {
+	int32x2_t toAdd = vshl_n_s32(vshrn_n_s64(vmull_n_s32(toDelay, strength), 32), shift);
+	vst1_s32(&writePos->l, vadd_s32(vld1_s32(&writePos->l), toAdd));
+}
+
+int32_t DelayBuffer::writeResampledBlock(int32_t const* input, int32_t numSamples, DelayBufferSetup* setup,
+                                         bool clearAsWeGo, bool* wrapped) {
+	int32_t numMovedOn = 0;
+
+	// Doing all the moving on first is only the same as doing it sample by sample if none of what we clear this block
+	// has already been written to this block. Writes land at least a few positions behind bufferCurrentPos so that's
+	// fine, unless the buffer is so small compared to how far we go that we'd get all the way back round to them.
+	if (clearAsWeGo) {
+		int32_t maxNumMovedOn = (((uint64_t)(uint32_t)setup->actualSpinRate * numSamples) >> 24) + 1;
+		if (maxNumMovedOn + delaySpaceBetweenReadAndWrite * 2 > (int32_t)sizeIncludingExtra) {
+			for (int32_t i = 0; i < numSamples; i++) {
+				longPos += setup->actualSpinRate;
+				uint8_t newShortPos = longPos >> 24;
+				uint8_t shortPosDiff = newShortPos - lastShortPos;
+				lastShortPos = newShortPos;
+				numMovedOn += shortPosDiff;
+
+				while (shortPosDiff > 0) {
+					*wrapped = clearAndMoveOn() || *wrapped;
+					shortPosDiff--;
+				}
+
+				int32_t strength2 = (longPos >> 8) & 65535;
+				writeResampled(input[i * 2], input[i * 2 + 1], 65536 - strength2, strength2, setup);
+			}
+			return numMovedOn;
+		}
+	}
+
+	for (int32_t i = 0; i < numSamples; i++) {
+		longPos += setup->actualSpinRate;
+		uint8_t newShortPos = longPos >> 24;
+		uint8_t shortPosDiff = newShortPos - lastShortPos;
+		lastShortPos = newShortPos;
+		numMovedOn += shortPosDiff;
+
+		while (shortPosDiff > 0) {
+			if (clearAsWeGo) {
+				*wrapped = clearAndMoveOn() || *wrapped;
+			}
+			else {
+				moveOn();
+			}
+			shortPosDiff--;
+		}
+
+		blockCurrentPos[i] = bufferCurrentPos;
+		blockStrength2[i] = (longPos >> 8) & 65535;
+	}
+
+	// If delay buffer spinning above sample rate. See writeResampled() for how all this works
+	if (setup->actualSpinRate >= 16777216) {
+		for (int32_t i = 0; i < numSamples; i++) {
+			int32x2_t toDelay = vld1_s32(&input[i * 2]);
+			int32_t strength2 = blockStrength2[i];
+
+			int32_t howFarRightToStart = (strength2 + (setup->spinRateForSpedUpWriting >> 8)) >> 16;
+			int32_t distanceFromMainWrite = (int32_t)howFarRightToStart << 16;
+
+			StereoSample* writePos = blockCurrentPos[i] - delaySpaceBetweenReadAndWrite + howFarRightToStart;
+			while (writePos < bufferStart)
+				writePos += sizeIncludingExtra;
+			while (writePos >= bufferEnd)
+				writePos -= sizeIncludingExtra;
+
+			while (distanceFromMainWrite != 0) {
+				int32_t strengthThisWrite =
+				    (0xFFFFFFFF >> 4) - (((distanceFromMainWrite - strength2) >> 4) * setup->divideByRate);
+				addToDelayPos<3>(writePos, toDelay, strengthThisWrite);
+				if (--writePos == bufferStart - 1)
+					writePos = bufferEnd - 1;
+				distanceFromMainWrite -= 65536;
+			}
+
+			while (true) {
+				int32_t strengthThisWrite =
+				    (0xFFFFFFFF >> 4) - (((distanceFromMainWrite + strength2) >> 4) * setup->divideByRate);
+				if (strengthThisWrite <= 0)
+					break;
+				addToDelayPos<3>(writePos, toDelay, strengthThisWrite);
+				if (--writePos == bufferStart - 1)
+					writePos = bufferEnd - 1;
+				distanceFromMainWrite += 65536;
+			}
+		}
+	}
+
+	// Or if spinning below sample rate, we write to the 4 positions from "main - 1" to "main + 2"
+	else {
+		int32x4_t strengthOffsets = {-65536 * 2, -65536, -65536, -65536 * 2};
+		int32x4_t rateMultiple = vdupq_n_s32(setup->rateMultiple);
+
+		for (int32_t i = 0; i < numSamples; i++) {
+			int32x2_t toDelay = vld1_s32(&input[i * 2]);
+			int32_t strength2 = blockStrength2[i];
+
+			// Strengths for "main - 1", "main", "main + 1" and "main + 2". Adding 0 for the ones <= 0 is the same as
+			// skipping them
+			int32x4_t strengths = {65536 - strength2, 65536 - strength2, strength2, strength2};
+			strengths = vaddq_s32(vaddq_s32(strengths, rateMultiple), strengthOffsets);
+			strengths = vmaxq_s32(strengths, vdupq_n_s32(0));
+			strengths = vmulq_n_s32(vshrq_n_s32(strengths, 2), (int32_t)setup->writeSizeAdjustment);
+
+			StereoSample* writePos = blockCurrentPos[i] - delaySpaceBetweenReadAndWrite + 2;
+			while (writePos < bufferStart)
+				writePos += sizeIncludingExtra;
+
+			// Usually all 4 are next to each other in memory, so can be done as 2 vectors of 2 StereoSamples
+			if (writePos - 3 >= bufferStart) {
+				int32x4x2_t strengthPairs = vzipq_s32(strengths, strengths);
+				int32x4_t toAdd0 = vcombine_s32(
+				    vshrn_n_s64(vmull_s32(toDelay, vget_low_s32(strengthPairs.val[0])), 32),
+				    vshrn_n_s64(vmull_s32(toDelay, vget_high_s32(strengthPairs.val[0])), 32));
+				int32x4_t toAdd1 = vcombine_s32(
+				    vshrn_n_s64(vmull_s32(toDelay, vget_low_s32(strengthPairs.val[1])), 32),
+				    vshrn_n_s64(vmull_s32(toDelay, vget_high_s32(strengthPairs.val[1])), 32));
+
+				int32_t* pos = &(writePos - 3)->l;
+				vst1q_s32(pos, vaddq_s32(vld1q_s32(pos), vshlq_n_s32(toAdd0, 2)));
+				vst1q_s32(pos + 4, vaddq_s32(vld1q_s32(pos + 4), vshlq_n_s32(toAdd1, 2)));
+			}
+
+			// Or if they wrap around the start of the buffer, one at a time
+			else {
+				int32_t strengthArray[4];
+				vst1q_s32(strengthArray, strengths);
+				for (int32_t j = 3; j >= 0; j--) {
+					addToDelayPos<2>(writePos, toDelay, strengthArray[j]);
+					if (--writePos == bufferStart - 1)
+						writePos = bufferEnd - 1;
+				}
+			}
+		}
+	}
+
+	return numMovedOn;
+}
@@ -28,6 +28,9 @@ class StereoSample;
 #define DELAY_BUFFER_MIN_SIZE 1
 #define DELAY_BUFFER_NEUTRAL_SIZE 16384
 
+// In StereoSamples, so four cache lines
+constexpr int32_t kDelayPrefetchDistance = 16;
+
 struct DelayBufferSetup {
 	int32_t actualSpinRate;           // 1 is represented as 16777216
 	int32_t spinRateForSpedUpWriting; // Normally the same as actualSpinRate, but subject to some limits for safety
@@ -40,12 +43,14 @@ class DelayBuffer {
 public:
 	DelayBuffer();
 	~DelayBuffer();
-	uint8_t init(uint32_t newRate, uint32_t failIfThisSize = 0, bool includeExtraSpace = true);
+	uint8_t init(uint32_t newRate, uint32_t failIfThisSize = 0, bool includeExtraSpace = true,
+	             bool fromStutterReserve = false);
 	void makeNativeRatePrecise();
 	void makeNativeRatePreciseRelativeToOtherBuffer(DelayBuffer* otherBuffer);
 	void discard(bool beingDestructed = false);
 	void setupForRender(int32_t rate, DelayBufferSetup* setup);
 	int32_t getIdealBufferSizeFromRate(uint32_t newRate);
+	static int32_t getMaxSize();
 	void empty();
 
 	inline bool isActive() { return (bufferStart != NULL); }
@@ -56,6 +61,10 @@ public:
 		return moveOn();
 	}
 
+	// Asks the cache for what the read position will reach a few lines from now. Running off the end of the buffer
+	// doesn't matter - a PLD never faults. For writing too, as the read loops clear as they go
+	inline void prefetch() { __builtin_prefetch(bufferCurrentPos + kDelayPrefetchDistance, 1); }
+
 	inline bool moveOn() {
 		bool wrapped = (++bufferCurrentPos == bufferEnd);
 		if (wrapped)
@@ -180,6 +189,13 @@ public:
 		}
 	}
 
+	// Moves on and does writeResampled() for a whole block of interleaved L/R input, no more than
+	// SSI_TX_BUFFER_NUM_SAMPLES long. All the moving on gets done first, noting where each sample's write goes, and
+	// then the writes get done in one go, with NEON. If clearAsWeGo, clearAndMoveOn() is used, and wrapped gets set if
+	// we wrapped. Returns how many positions we moved on by.
+	int32_t writeResampledBlock(int32_t const* input, int32_t numSamples, DelayBufferSetup* setup, bool clearAsWeGo,
+	                            bool* wrapped);
+
 	// For some reason, getting rid of this function and replacing it with the other ones causes actual delays to process like 5% slower...
 
 	inline void write(int32_t toDelayL, int32_t toDelayR, int32_t strength1, int32_t strength2,
@@ -300,4 +316,5 @@ public:
 	uint32_t size;
 	uint32_t sizeIncludingExtra;
 	bool isResampling;
+	bool isFromStutterReserve; // Memory came from AudioEngine::solicitStutterBuffer(), and goes back there
 };
@@ -21,6 +21,7 @@
 #include "dsp/filter/lpladder.h"
 #include "dsp/filter/svf.h"
 #include "dsp/timestretch/time_stretcher.h"
+#include "processing/engines/audio_engine.h"
 #include "processing/sound/sound.h"
 #include "storage/storage_manager.h"
 #include "util/functions.h"
@@ -141,6 +142,25 @@ void FilterSet::renderLongStereo(q31_t* startSample, q31_t* endSample) {
 	}
 }
 
+template <typename T>
+q31_t FilterSet::configureIfChanged(T& filter, ConfigCache& cache, q31_t frequency, q31_t resonance, FilterMode mode,
+                                    q31_t morph, q31_t filterGain) {
+	if (cache.valid && cache.frequency == frequency && cache.resonance == resonance && cache.mode == mode
+	    && cache.morph == morph && cache.gainIn == filterGain && cache.cpuDireness == AudioEngine::cpuDireness) {
+		return cache.gainOut;
+	}
+
+	cache.frequency = frequency;
+	cache.resonance = resonance;
+	cache.mode = mode;
+	cache.morph = morph;
+	cache.gainIn = filterGain;
+	cache.cpuDireness = AudioEngine::cpuDireness;
+	cache.gainOut = filter.configure(frequency, resonance, mode, morph, filterGain);
+	cache.valid = true;
+	return cache.gainOut;
+}
+
 int32_t FilterSet::setConfig(int32_t lpfFrequency, int32_t lpfResonance, bool doLPF, FilterMode lpfmode, q31_t lpfMorph,
                              int32_t hpfFrequency, int32_t hpfResonance, bool doHPF, FilterMode hpfmode, q31_t hpfMorph,
                              int32_t filterGain, FilterRoute routing, bool adjustVolumeForHPFResonance,
@@ -158,13 +178,14 @@ int32_t FilterSet::setConfig(int32_t lpfFrequency, int32_t lpfResonance, bool do
 			if (lastLPFMode_ <= kLastLadder) {
 				lpsvf.reset();
 			}
-			filterGain = lpsvf.configure(lpfFrequency, lpfResonance, lpfMode_, lpfMorph, filterGain);
+			filterGain = configureIfChanged(lpsvf, lpsvfConfig, lpfFrequency, lpfResonance, lpfMode_, lpfMorph, filterGain);
 		}
 		else {
 			if (lastLPFMode_ > kLastLadder) {
 				lpladder.reset();
 			}
-			filterGain = lpladder.configure(lpfFrequency, lpfResonance, lpfMode_, lpfMorph, filterGain);
+			filterGain =
+			    configureIfChanged(lpladder, lpladderConfig, lpfFrequency, lpfResonance, lpfMode_, lpfMorph, filterGain);
 		}
 		lastLPFMode_ = lpfMode_;
 	}
@@ -177,7 +198,8 @@ int32_t FilterSet::setConfig(int32_t lpfFrequency, int32_t lpfResonance, bool do
 	// HPF
 	if (HPFOn) {
 		if (hpfMode_ == FilterMode::HPLADDER) {
-			filterGain = hpladder.configure(hpfFrequency, hpfResonance, hpfmode, hpfMorph, filterGain);
+			filterGain =
+			    configureIfChanged(hpladder, hpladderConfig, hpfFrequency, hpfResonance, hpfmode, hpfMorph, filterGain);
 			if (lastHPFMode_ != hpfMode_) {
 				hpladder.reset();
 			}
@@ -185,7 +207,8 @@ int32_t FilterSet::setConfig(int32_t lpfFrequency, int32_t lpfResonance, bool do
 		//otherwise it's an SVF ((lpfmode == FilterMode::SVF_BAND) || (lpfmode == FilterMode::SVF_NOTCH))
 		else {
 			//invert the morph for the HPF so it goes high-band/notch-low
-			filterGain = hpsvf.configure(hpfFrequency, hpfResonance, hpfmode, ((1 << 29) - 1) - hpfMorph, filterGain);
+			filterGain = configureIfChanged(hpsvf, hpsvfConfig, hpfFrequency, hpfResonance, hpfmode,
+			                                ((1 << 29) - 1) - hpfMorph, filterGain);
 			if (lastHPFMode_ != hpfMode_) {
 				hpsvf.reset();
 			}
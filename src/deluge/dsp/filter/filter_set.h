@@ -62,10 +62,30 @@ private:
 	void renderHPFLong(q31_t* startSample, q31_t* endSample, int32_t sampleIncrement = 1);
 	void renderLadderHPF(q31_t* outputSample);
 
+	// What a filter was last configured with, and the gain that came out of that. Its coefficients only depend on
+	// these, so while they stay put - which for a static patch is always - there's no need to work them out again
+	struct ConfigCache {
+		q31_t frequency;
+		q31_t resonance;
+		q31_t morph;
+		q31_t gainIn;
+		q31_t gainOut;
+		FilterMode mode;
+		int32_t cpuDireness; // The ladder LPF decides whether to oversample from this
+		bool valid = false;
+	};
+	template <typename T>
+	q31_t configureIfChanged(T& filter, ConfigCache& cache, q31_t frequency, q31_t resonance, FilterMode mode,
+	                         q31_t morph, q31_t filterGain);
+
 	SVFilter lpsvf;
 	LpLadderFilter lpladder;
 	HpLadderFilter hpladder;
 	SVFilter hpsvf;
+	ConfigCache lpsvfConfig;
+	ConfigCache lpladderConfig;
+	ConfigCache hpladderConfig;
+	ConfigCache hpsvfConfig;
 	bool LPFOn;
 	bool HPFOn;
 };
@@ -16,6 +16,7 @@
 */
 #include "dsp/filter/lpladder.h"
 #include "definitions_cxx.hpp"
+#include "dsp/filter/stereo_lanes.h"
 #include "dsp/filter/svf.h"
 #include "io/debug/print.h"
 #include "processing/engines/audio_engine.h"
@@ -233,6 +234,10 @@ void LpLadderFilter::doFilter(q31_t* startSample, q31_t* endSample, int32_t samp
 	}
 }
 void LpLadderFilter::doFilterStereo(q31_t* startSample, q31_t* endSample) {
+	if (useStereoLanes()) {
+		doFilterStereoLanes(startSample, endSample);
+		return;
+	}
 
 	// Half ladder
 	if (lpfMode == FilterMode::TRANSISTOR_12DB) {
@@ -311,6 +316,151 @@ void LpLadderFilter::doFilterStereo(q31_t* startSample, q31_t* endSample) {
 		}
 	}
 }
+// BasicFilterComponent::doFilter(), with each channel's memory in a lane
+[[gnu::always_inline]] static inline int32x2_t doFilterLanes(int32x2_t input, int32x2_t& memory,
+                                                             int32x2_t moveability) {
+	int32x2_t a = vshl_n_s32(multiply_32x32_rshift32_rounded_lanes(vsub_s32(input, memory), moveability), 1);
+	int32x2_t b = vadd_s32(a, memory);
+	memory = vadd_s32(b, a);
+	return b;
+}
+
+// BasicFilterComponent::doAPF()
+[[gnu::always_inline]] static inline int32x2_t doAPFLanes(int32x2_t input, int32x2_t& memory,
+                                                          int32x2_t moveability) {
+	int32x2_t a = vshl_n_s32(multiply_32x32_rshift32_rounded_lanes(vsub_s32(input, memory), moveability), 1);
+	int32x2_t b = vadd_s32(a, memory);
+	memory = vadd_s32(a, b);
+	return vsub_s32(vshl_n_s32(b, 1), input);
+}
+
+// The scalar path takes a noise value for the left channel and then the right, so we do the same to get the same
+// noise in each
+[[gnu::always_inline]] static inline int32x2_t getNoiseLanes() {
+	int32x2_t noise = vdup_n_s32(getNoise() >> 2);
+	return vset_lane_s32(getNoise() >> 2, noise, 1);
+}
+
+// Same as the scalar per-sample functions below, but running left and right in the two lanes
+void LpLadderFilter::doFilterStereoLanes(q31_t* startSample, q31_t* endSample) {
+	int32x2_t noiseLastValue = {l.noiseLastValue, r.noiseLastValue};
+	int32x2_t memory1 = {l.lpfLPF1.memory, r.lpfLPF1.memory};
+	int32x2_t memory2 = {l.lpfLPF2.memory, r.lpfLPF2.memory};
+	int32x2_t memory3 = {l.lpfLPF3.memory, r.lpfLPF3.memory};
+	int32x2_t memory4 = {l.lpfLPF4.memory, r.lpfLPF4.memory};
+
+	auto getNoisyMoveability = [&](int32x2_t noise) {
+		noiseLastValue = vsra_n_s32(noiseLastValue, vsub_s32(noise, noiseLastValue), 7);
+		return vadd_s32(vdup_n_s32(moveability), multiply_32x32_rshift32_lanes(noiseLastValue, moveability));
+	};
+
+	auto scaleInputLanes = [&](int32x2_t input, int32x2_t feedbacksSum) {
+		int32x2_t temp = vshl_n_s32(
+		    multiply_32x32_rshift32_rounded_lanes(
+		        vsub_s32(input,
+		                 vshl_n_s32(multiply_32x32_rshift32_rounded_lanes(feedbacksSum, processedResonance), 3)),
+		        divideByTotalMoveabilityAndProcessedResonance),
+		    2);
+		if (morph > 0 || processedResonance > 510000000) {
+			int32x2_t extra = vshl_n_s32(multiply_32x32_rshift32_lanes(input, morph), 1);
+			temp = getTanHUnknown_lanes(vadd_s32(temp, extra), 2);
+		}
+		return temp;
+	};
+
+	auto get24dBFeedbacksSum = [&]() {
+		int32x2_t feedbacksSum = multiply_32x32_rshift32_rounded_lanes(memory1, lpf1Feedback);
+		feedbacksSum = vadd_s32(feedbacksSum, multiply_32x32_rshift32_rounded_lanes(memory2, lpf2Feedback));
+		feedbacksSum = vadd_s32(feedbacksSum, multiply_32x32_rshift32_rounded_lanes(memory3, lpf3Feedback));
+		feedbacksSum =
+		    vadd_s32(feedbacksSum, multiply_32x32_rshift32_rounded_lanes(memory4, divideBy1PlusTannedFrequency));
+		return vshl_n_s32(feedbacksSum, 2);
+	};
+
+	auto doDriveLPF = [&](int32x2_t input, int32x2_t noise) {
+		int32x2_t noisyM = getNoisyMoveability(noise);
+		int32x2_t x = scaleInputLanes(input, getTanHUnknown_lanes(get24dBFeedbacksSum(), 7));
+		int32x2_t a = doFilterLanes(x, memory1, noisyM);
+		int32x2_t b = doFilterLanes(a, memory2, noisyM);
+		int32x2_t c = doFilterLanes(b, memory3, noisyM);
+		return vshl_n_s32(doFilterLanes(c, memory4, noisyM), 1);
+	};
+
+	q31_t* currentSample = startSample;
+
+	// Half ladder
+	if (lpfMode == FilterMode::TRANSISTOR_12DB) {
+		do {
+			int32x2_t noisyM = getNoisyMoveability(getNoiseLanes());
+			int32x2_t feedbacksSum = vshl_n_s32(multiply_32x32_rshift32_rounded_lanes(memory1, lpf1Feedback), 2);
+			feedbacksSum =
+			    vadd_s32(feedbacksSum, vshl_n_s32(multiply_32x32_rshift32_rounded_lanes(memory2, lpf2Feedback), 2));
+			feedbacksSum = vadd_s32(
+			    feedbacksSum,
+			    vshl_n_s32(multiply_32x32_rshift32_rounded_lanes(memory3, divideBy1PlusTannedFrequency), 2));
+			int32x2_t x = scaleInputLanes(vld1_s32(currentSample), feedbacksSum);
+
+			int32x2_t output =
+			    doAPFLanes(doFilterLanes(doFilterLanes(x, memory1, noisyM), memory2, noisyM), memory3, noisyM);
+			vst1_s32(currentSample, vshl_n_s32(output, 1));
+			currentSample += 2;
+		} while (currentSample < endSample);
+	}
+
+	// Full ladder (regular)
+	else if (lpfMode == FilterMode::TRANSISTOR_24DB) {
+		do {
+			int32x2_t noisyM = getNoisyMoveability(getNoiseLanes());
+			int32x2_t x = scaleInputLanes(vld1_s32(currentSample), get24dBFeedbacksSum());
+
+			int32x2_t output = doFilterLanes(
+			    doFilterLanes(doFilterLanes(doFilterLanes(x, memory1, noisyM), memory2, noisyM), memory3, noisyM),
+			    memory4, noisyM);
+			vst1_s32(currentSample, vshl_n_s32(output, 1));
+			currentSample += 2;
+		} while (currentSample < endSample);
+	}
+
+	// Full ladder (drive)
+	else if (lpfMode == FilterMode::TRANSISTOR_24DB_DRIVE) {
+		if (doOversampling) {
+			do {
+				// The scalar path runs the left channel twice, then the right twice, taking a noise value each time
+				q31_t noiseL1 = getNoise() >> 2;
+				q31_t noiseL2 = getNoise() >> 2;
+				q31_t noiseR1 = getNoise() >> 2;
+				q31_t noiseR2 = getNoise() >> 2;
+				int32x2_t noise1 = {noiseL1, noiseR1};
+				int32x2_t noise2 = {noiseL2, noiseR2};
+
+				int32x2_t input = vld1_s32(currentSample);
+				doDriveLPF(input, noise1);
+				int32x2_t outputSampleToKeep = doDriveLPF(input, noise2);
+				vst1_s32(currentSample, getTanHUnknown_lanes(outputSampleToKeep, 4));
+				currentSample += 2;
+			} while (currentSample < endSample);
+		}
+		else {
+			do {
+				int32x2_t outputSampleToKeep = doDriveLPF(vld1_s32(currentSample), getNoiseLanes());
+				vst1_s32(currentSample, getTanHUnknown_lanes(outputSampleToKeep, 4));
+				currentSample += 2;
+			} while (currentSample < endSample);
+		}
+	}
+
+	l.noiseLastValue = vget_lane_s32(noiseLastValue, 0);
+	r.noiseLastValue = vget_lane_s32(noiseLastValue, 1);
+	l.lpfLPF1.memory = vget_lane_s32(memory1, 0);
+	r.lpfLPF1.memory = vget_lane_s32(memory1, 1);
+	l.lpfLPF2.memory = vget_lane_s32(memory2, 0);
+	r.lpfLPF2.memory = vget_lane_s32(memory2, 1);
+	l.lpfLPF3.memory = vget_lane_s32(memory3, 0);
+	r.lpfLPF3.memory = vget_lane_s32(memory3, 1);
+	l.lpfLPF4.memory = vget_lane_s32(memory4, 0);
+	r.lpfLPF4.memory = vget_lane_s32(memory4, 1);
+}
+
 [[gnu::always_inline]] inline q31_t LpLadderFilter::do12dBLPFOnSample(q31_t input, LpLadderState& state) {
 	// For drive filter, apply some heavily lowpassed noise to the filter frequency, to add analog-ness
 	q31_t noise = getNoise() >> 2; //storageManager.devVarA;// 2;
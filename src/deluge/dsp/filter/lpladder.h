@@ -72,6 +72,7 @@ private:
 	[[gnu::always_inline]] inline q31_t do24dBLPFOnSample(q31_t input, LpLadderState& state);
 	[[gnu::always_inline]] inline q31_t do12dBLPFOnSample(q31_t input, LpLadderState& state);
 	[[gnu::always_inline]] inline q31_t doDriveLPFOnSample(q31_t input, LpLadderState& state);
+	void doFilterStereoLanes(q31_t* startSample, q31_t* endSample);
 	//all ladders are in this class to share the basic components
 	//this differentiates between them
 	FilterMode lpfMode;
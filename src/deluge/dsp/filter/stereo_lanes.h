@@ -0,0 +1,58 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "arm_neon.h"
+#include "definitions_cxx.hpp"
+#include "model/settings/runtime_feature_settings.h"
+#include "util/functions.h"
+#include <cstdint>
+namespace deluge::dsp::filter {
+/**
+ * Versions of the helpers in util/fixedpoint.h which work on the left and right channels at once, in the two lanes of an
+ * int32x2_t. Each lane gives exactly what the scalar helper would, so a filter's stereo path can switch between the two
+ * without a change in sound.
+*/
+
+/// multiply_32x32_rshift32() on each lane
+[[gnu::always_inline]] inline int32x2_t multiply_32x32_rshift32_lanes(int32x2_t a, int32x2_t b) {
+	return vshrn_n_s64(vmull_s32(a, b), 32);
+}
+[[gnu::always_inline]] inline int32x2_t multiply_32x32_rshift32_lanes(int32x2_t a, q31_t b) {
+	return vshrn_n_s64(vmull_n_s32(a, b), 32);
+}
+
+/// multiply_32x32_rshift32_rounded() on each lane
+[[gnu::always_inline]] inline int32x2_t multiply_32x32_rshift32_rounded_lanes(int32x2_t a, int32x2_t b) {
+	return vrshrn_n_s64(vmull_s32(a, b), 32);
+}
+[[gnu::always_inline]] inline int32x2_t multiply_32x32_rshift32_rounded_lanes(int32x2_t a, q31_t b) {
+	return vrshrn_n_s64(vmull_n_s32(a, b), 32);
+}
+
+/// getTanHUnknown() on each lane. It's a table lookup, so this goes through the scalar version
+[[gnu::always_inline]] inline int32x2_t getTanHUnknown_lanes(int32x2_t input, uint32_t saturationAmount) {
+	input = vset_lane_s32(getTanHUnknown(vget_lane_s32(input, 0), saturationAmount), input, 0);
+	return vset_lane_s32(getTanHUnknown(vget_lane_s32(input, 1), saturationAmount), input, 1);
+}
+
+/// Whether stereo filters should take their two-lane path. The scalar one is kept so the two can be compared
+[[gnu::always_inline]] inline bool useStereoLanes() {
+	return runtimeFeatureSettings.get(RuntimeFeatureSettingType::VectorFilters) == RuntimeFeatureStateToggle::On;
+}
+} // namespace deluge::dsp::filter
@@ -16,6 +16,7 @@
 */
 #include "dsp/filter/svf.h"
 #include "definitions_cxx.hpp"
+#include "dsp/filter/stereo_lanes.h"
 #include "util/functions.h"
 #include <cstdint>
 namespace deluge::dsp::filter {
@@ -29,6 +30,10 @@ void SVFilter::doFilter(q31_t* startSample, q31_t* endSample, int32_t sampleIncr
 	} while (currentSample < endSample);
 }
 void SVFilter::doFilterStereo(q31_t* startSample, q31_t* endSample) {
+	if (useStereoLanes()) {
+		doFilterStereoLanes(startSample, endSample);
+		return;
+	}
 	q31_t* currentSample = startSample;
 	do {
 		q31_t outs = doSVF(*currentSample, l);
@@ -40,6 +45,54 @@ void SVFilter::doFilterStereo(q31_t* startSample, q31_t* endSample) {
 	} while (currentSample < endSample);
 }
 
+// Same as doSVF(), but with left and right in the two lanes
+void SVFilter::doFilterStereoLanes(q31_t* startSample, q31_t* endSample) {
+	int32x2_t low = {l.low, r.low};
+	int32x2_t band = {l.band, r.band};
+
+	q31_t* currentSample = startSample;
+	do {
+		int32x2_t input = multiply_32x32_rshift32_lanes(vld1_s32(currentSample), in);
+
+		low = vadd_s32(low, vshl_n_s32(multiply_32x32_rshift32_lanes(band, fc), 1));
+		int32x2_t high = vsub_s32(input, low);
+		high = vsub_s32(high, vshl_n_s32(multiply_32x32_rshift32_lanes(band, q), 1));
+		band = vadd_s32(vshl_n_s32(multiply_32x32_rshift32_lanes(high, fc), 1), band);
+
+		band = getTanHUnknown_lanes(band, 3);
+
+		int32x2_t lowi = low;
+		int32x2_t highi = high;
+		int32x2_t bandi = band;
+
+		low = vadd_s32(low, vshl_n_s32(multiply_32x32_rshift32_lanes(band, fc), 1));
+		high = vsub_s32(input, low);
+		high = vsub_s32(high, vshl_n_s32(multiply_32x32_rshift32_lanes(band, q), 1));
+		band = vadd_s32(vshl_n_s32(multiply_32x32_rshift32_lanes(high, fc), 1), band);
+
+		lowi = vadd_s32(lowi, low);
+		highi = vadd_s32(highi, high);
+		bandi = vadd_s32(bandi, band);
+
+		int32x2_t result = multiply_32x32_rshift32_rounded_lanes(lowi, c_low);
+		result = vadd_s32(result, multiply_32x32_rshift32_rounded_lanes(highi, c_high));
+		if (band_mode) {
+			result = vadd_s32(result, multiply_32x32_rshift32_rounded_lanes(bandi, c_band));
+		}
+
+		band = getTanHUnknown_lanes(band, 3);
+		result = vmul_n_s32(result, 3);
+
+		vst1_s32(currentSample, result);
+		currentSample += 2;
+	} while (currentSample < endSample);
+
+	l.low = vget_lane_s32(low, 0);
+	r.low = vget_lane_s32(low, 1);
+	l.band = vget_lane_s32(band, 0);
+	r.band = vget_lane_s32(band, 1);
+}
+
 q31_t SVFilter::setConfig(q31_t freq, q31_t res, FilterMode lpfMode, q31_t lpfMorph, q31_t filterGain) {
 	curveFrequency(freq);
 	//multiply by 1.25 to loosely correct for equivalency to ladders
@@ -41,6 +41,7 @@ private:
 		q31_t band;
 	};
 	[[gnu::always_inline]] inline q31_t doSVF(q31_t input, SVFState& state);
+	void doFilterStereoLanes(q31_t* startSample, q31_t* endSample);
 	SVFState l;
 	SVFState r;
 
@@ -16,7 +16,10 @@
 */
 
 #include "dsp/master_compressor/master_compressor.h"
+#include "arm_neon.h"
 #include "dsp/stereo_sample.h"
+#include "model/settings/runtime_feature_settings.h"
+#include <cstring>
 
 MasterCompressor::MasterCompressor() {
 	compressor.setSampleRate(kSampleRate);
@@ -28,40 +31,165 @@ MasterCompressor::MasterCompressor() {
 	makeup = 1.0;                    //value;
 	gr = 0.0;
 	wet = 1.0;
+	blockEnvdB = chunkware_simple::DC_OFFSET;
+	blockGain = 1 << 26;
+	blockAttackMs = 0;
+	blockReleaseMs = 0;
+	blockRateRunning = false;
+	lookaheadPos = 0;
+	lookaheadRunning = false;
 }
 //with floats baseline is 60-90us
 void MasterCompressor::render(StereoSample* buffer, uint16_t numSamples, int32_t masterVolumeAdjustmentL,
                               int32_t masterVolumeAdjustmentR) {
 
+	if (compressor.getThresh() >= -0.001) {
+		blockRateRunning = false;
+		lookaheadRunning = false;
+		return;
+	}
+
+	uint32_t detection = runtimeFeatureSettings.get(RuntimeFeatureSettingType::MasterCompressorDetection);
+	if (detection != RuntimeFeatureStateCompressorDetection::EveryFrame) {
+		renderBlockRate(buffer, numSamples, detection == RuntimeFeatureStateCompressorDetection::BlockRateLookahead);
+		return;
+	}
+	blockRateRunning = false;
+	lookaheadRunning = false;
+
 	StereoSample* thisSample = buffer;
 	StereoSample* bufferEnd = buffer + numSamples;
-	if (compressor.getThresh() < -0.001) {
-		do {
-			//correct for input level
-			float l = lshiftAndSaturate<5>(thisSample->l) / (float)ONE_Q31;
-			float r = lshiftAndSaturate<5>(thisSample->r) / (float)ONE_Q31;
-			float rawl = l;
-			float rawr = r;
-			compressor.process(l, r);
-			if (thisSample == bufferEnd - 1 && fabs(rawl) > 0.00000001 && fabs(rawr) > 0.00000001) {
-				gr = chunkware_simple::lin2dB(l / rawl);
-				gr = std::min(gr, chunkware_simple::lin2dB(r / rawr));
+	do {
+		//correct for input level
+		float l = lshiftAndSaturate<5>(thisSample->l) / (float)ONE_Q31;
+		float r = lshiftAndSaturate<5>(thisSample->r) / (float)ONE_Q31;
+		float rawl = l;
+		float rawr = r;
+		compressor.process(l, r);
+		if (thisSample == bufferEnd - 1 && fabs(rawl) > 0.00000001 && fabs(rawr) > 0.00000001) {
+			gr = chunkware_simple::lin2dB(l / rawl);
+			gr = std::min(gr, chunkware_simple::lin2dB(r / rawr));
+		}
+
+		l = l * makeup;
+		r = r * makeup;
+
+		if (wet < 0.9999) {
+			l = rawl * (1.0 - wet) + l * wet;
+			r = rawr * (1.0 - wet) + r * wet;
+		}
+
+		thisSample->l = l * ONE_Q31 / (1 << 5);
+		thisSample->r = r * ONE_Q31 / (1 << 5);
+
+	} while (++thisSample != bufferEnd);
+}
+
+void MasterCompressor::updateBlockCoefficients() {
+	blockAttackMs = compressor.getAttack();
+	blockReleaseMs = compressor.getRelease();
+
+	// The same as the chunkware envelope's per-sample coefficient, raised to the power of the number of frames
+	for (int32_t n = 0; n < kMasterCompressorDetectionInterval; n++) {
+		attackCoefficients[n] = exp(-1000.0 * (n + 1) / (blockAttackMs * kSampleRate));
+		releaseCoefficients[n] = exp(-1000.0 * (n + 1) / (blockReleaseMs * kSampleRate));
+	}
+}
+
+// Runs the detector and gain calculation once per detection interval rather than per frame, ramping the gain
+// linearly between them. The input scaling and transfer function are the same as in render(), but in fixed point,
+// with gain reduction, makeup and mix all folded into a single gain
+void MasterCompressor::renderBlockRate(StereoSample* buffer, uint16_t numSamples, bool lookahead) {
+	if (!blockRateRunning) {
+		blockEnvdB = chunkware_simple::DC_OFFSET;
+		blockGain = 1 << 26;
+		blockRateRunning = true;
+	}
+	if (lookahead && !lookaheadRunning) {
+		memset(lookaheadBuffer, 0, sizeof(lookaheadBuffer));
+		lookaheadPos = 0;
+	}
+	lookaheadRunning = lookahead;
+
+	if (compressor.getAttack() != blockAttackMs || compressor.getRelease() != blockReleaseMs) {
+		updateBlockCoefficients();
+	}
+
+	float threshdB = compressor.getThresh();
+	float ratio = compressor.getRatio();
+
+	StereoSample* thisSample = buffer;
+	StereoSample* bufferEnd = buffer + numSamples;
+	while (thisSample != bufferEnd) {
+		int32_t numFrames = std::min<int32_t>(kMasterCompressorDetectionInterval, bufferEnd - thisSample);
+
+		// Peak of both channels, before they go through any lookahead delay
+		int32_t peak;
+		if (numFrames == kMasterCompressorDetectionInterval) {
+			int32x4_t peakVector = vqabsq_s32(vld1q_s32(&thisSample[0].l));
+			for (int32_t i = 2; i < kMasterCompressorDetectionInterval; i += 2) {
+				peakVector = vmaxq_s32(peakVector, vqabsq_s32(vld1q_s32(&thisSample[i].l)));
+			}
+			int32x2_t peakPair = vpmax_s32(vget_low_s32(peakVector), vget_high_s32(peakVector));
+			peakPair = vpmax_s32(peakPair, peakPair);
+			peak = vget_lane_s32(peakPair, 0);
+		}
+		else {
+			peak = 0;
+			for (int32_t i = 0; i < numFrames; i++) {
+				peak = std::max(peak, std::abs(std::max(thisSample[i].l, -ONE_Q31)));
+				peak = std::max(peak, std::abs(std::max(thisSample[i].r, -ONE_Q31)));
 			}
+		}
 
-			l = l * makeup;
-			r = r * makeup;
+		// Anything over 1 << 26 hits the same saturation render() applies
+		float key = std::min(peak, 1 << 26) / (float)(1 << 26) + chunkware_simple::DC_OFFSET;
+		float overdB = std::max(chunkware_simple::lin2dB(key) - threshdB, 0.0f) + chunkware_simple::DC_OFFSET;
+		float coefficient =
+		    (overdB > blockEnvdB) ? attackCoefficients[numFrames - 1] : releaseCoefficients[numFrames - 1];
+		blockEnvdB = overdB + coefficient * (blockEnvdB - overdB);
 
-			if (wet < 0.9999) {
-				l = rawl * (1.0 - wet) + l * wet;
-				r = rawr * (1.0 - wet) + r * wet;
+		float compressedGain = chunkware_simple::dB2lin((blockEnvdB - chunkware_simple::DC_OFFSET) * (ratio - 1.0));
+		float gain = compressedGain * makeup * wet + (1.0 - wet);
+		int32_t targetGain = gain * (1 << 26);
+
+		if (lookahead) {
+			for (int32_t i = 0; i < numFrames; i++) {
+				StereoSample delayed = lookaheadBuffer[lookaheadPos];
+				lookaheadBuffer[lookaheadPos] = thisSample[i];
+				thisSample[i] = delayed;
+				lookaheadPos = (lookaheadPos + 1) & (kMasterCompressorLookaheadFrames - 1);
 			}
+		}
 
-			thisSample->l = l * ONE_Q31 / (1 << 5);
-			thisSample->r = r * ONE_Q31 / (1 << 5);
+		int32_t gainIncrement = (targetGain - blockGain) / numFrames;
+		if (numFrames == kMasterCompressorDetectionInterval) {
+			// Two frames per vector, so each pair of lanes gets one frame's gain
+			int32x4_t gainVector =
+			    vcombine_s32(vdup_n_s32(blockGain + gainIncrement), vdup_n_s32(blockGain + gainIncrement * 2));
+			int32x4_t gainVectorIncrement = vdupq_n_s32(gainIncrement * 2);
+			for (int32_t i = 0; i < kMasterCompressorDetectionInterval; i += 2) {
+				int32x4_t samples = vqshlq_n_s32(vld1q_s32(&thisSample[i].l), 5);
+				vst1q_s32(&thisSample[i].l, vqdmulhq_s32(samples, gainVector));
+				gainVector = vaddq_s32(gainVector, gainVectorIncrement);
+			}
+		}
+		else {
+			int32_t gainNow = blockGain;
+			for (int32_t i = 0; i < numFrames; i++) {
+				gainNow += gainIncrement;
+				thisSample[i].l = multiply_32x32_rshift32(lshiftAndSaturate<5>(thisSample[i].l), gainNow) << 1;
+				thisSample[i].r = multiply_32x32_rshift32(lshiftAndSaturate<5>(thisSample[i].r), gainNow) << 1;
+			}
+		}
+		blockGain = targetGain;
 
-		} while (++thisSample != bufferEnd);
+		thisSample += numFrames;
 	}
+
+	gr = (blockEnvdB - chunkware_simple::DC_OFFSET) * (ratio - 1.0);
 }
+
 void MasterCompressor::setup(int32_t attack, int32_t release, int32_t threshold, int32_t ratio, int32_t makeup,
                              int32_t mix) {
 	compressor.setAttack((float)attack / 100.0);
@@ -19,6 +19,7 @@
 
 #include "chunkware_simplecomp.h"
 #include "definitions_cxx.hpp"
+#include "dsp/stereo_sample.h"
 
 #define INLINE inline
 #include <algorithm> // for min(), max()
@@ -26,6 +27,11 @@
 #include <cmath>
 #include <cstdint>
 
+// Number of frames each detection covers in the block-rate modes. The gain ramps linearly across each one
+constexpr int32_t kMasterCompressorDetectionInterval = 8;
+// How far the audio is delayed behind the detector in lookahead mode - about 1.5ms
+constexpr int32_t kMasterCompressorLookaheadFrames = 64;
+
 class MasterCompressor {
 public:
 	MasterCompressor();
@@ -48,4 +54,21 @@ public:
 	inline float getMakeup() { return 20.0 * log10(makeup); }
 
 	chunkware_simple::SimpleComp compressor;
+
+private:
+	void renderBlockRate(StereoSample* buffer, uint16_t numSamples, bool lookahead);
+	void updateBlockCoefficients();
+
+	// Block-rate detection keeps its own envelope, since it steps by a whole detection interval at a time
+	float blockEnvdB;
+	int32_t blockGain; // Last gain applied, including makeup and mix. 1 << 26 is unity
+	float blockAttackMs;
+	float blockReleaseMs;
+	float attackCoefficients[kMasterCompressorDetectionInterval]; // Element n - 1 covers n frames
+	float releaseCoefficients[kMasterCompressorDetectionInterval];
+	bool blockRateRunning;
+
+	StereoSample lookaheadBuffer[kMasterCompressorLookaheadFrames];
+	int32_t lookaheadPos;
+	bool lookaheadRunning;
 };
@@ -0,0 +1,198 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "dsp/reverb/fdn/fdn.h"
+#include "dsp/reverb/freeverb/tuning.h"
+#include "util/functions.h"
+#include <cmath>
+#include <cstring>
+
+namespace deluge::dsp::reverb {
+
+// The delay length, in samples, over which a line's feedback equals freeverb's comb feedback for the same room size.
+// About the length of freeverb's combs, so the two decay at roughly the same rate
+constexpr float kReferenceLineLength = 1400;
+
+// Brings the output up to about the same level as freeverb's, whose 8 comb outputs per channel get summed and then go
+// through its allpasses
+constexpr int32_t kOutputGain = 8;
+
+FDN::FDN() {
+	quality = ReverbQuality::HIGH;
+	roomSize = -1; // So setParams() below doesn't think nothing's changed
+	setupLines();
+	setParams(initialroom, initialdamp, initialwidth);
+}
+
+void FDN::setupLines() {
+	bool halfRate = (quality != ReverbQuality::HIGH);
+	int32_t* buffer = memory;
+	for (int32_t i = 0; i < kMaxNumLines; i++) {
+		lines[i].buffer = buffer;
+		// At half the sample rate, half as many samples gives the same delay time
+		lines[i].length = halfRate ? (kLineLengths[i] >> 1) : kLineLengths[i];
+		buffer += kLineLengths[i];
+	}
+	mute();
+}
+
+void FDN::mute() {
+	memset(memory, 0, sizeof(memory));
+	for (int32_t i = 0; i < kMaxNumLines; i++) {
+		lines[i].pos = 0;
+		lines[i].filterstore = 0;
+	}
+	halfRatePhase = false;
+	halfRateInput = 0;
+	lastOutL = 0;
+	lastOutR = 0;
+}
+
+void FDN::setQuality(ReverbQuality newQuality) {
+	if (newQuality == quality) {
+		return;
+	}
+	quality = newQuality;
+	setupLines();
+
+	// The feedback depends on the number of lines too
+	float oldRoomSize = roomSize;
+	roomSize = -1;
+	setParams(oldRoomSize, damp / scaledamp, width);
+}
+
+void FDN::setParams(float newRoomSize, float newDamp, float newWidth) {
+	if (newRoomSize == roomSize && newDamp * scaledamp == damp && newWidth == width) {
+		return;
+	}
+	roomSize = newRoomSize;
+	damp = newDamp * scaledamp;
+	width = newWidth;
+
+	// The Hadamard mix halves everything at each of its stages, so the feedback makes up for that, less the matrix's
+	// 1 / sqrt(numLines) normalization
+	int32_t numLines = (quality == ReverbQuality::LOW) ? 4 : 8;
+	float normalization = sqrtf(numLines);
+	float feedback = roomSize * scaleroom + offsetroom;
+	for (int32_t i = 0; i < kMaxNumLines; i++) {
+		// Longer lines get less feedback per trip round them, so they all decay at the same rate
+		float lineFeedback = powf(feedback, kLineLengths[i] / kReferenceLineLength) * normalization;
+		lines[i].feedback = lineFeedback * 268435456;
+	}
+
+	damp1 = damp * 2147483647;
+	damp2 = 2147483647 - damp1;
+
+	wet2 = std::min((((float)1 - width) / 2) / (width / 2 + 0.5f) * 2147483648u, 2147483647.f);
+}
+
+template <int32_t numLines>
+[[gnu::always_inline]] inline void FDN::tick(int32_t input, int32_t* outL, int32_t* outR) {
+	int32_t mix[numLines];
+	int32_t l = 0;
+	int32_t r = 0;
+
+	for (int32_t i = 0; i < numLines; i++) {
+		DelayLine& line = lines[i];
+		int32_t output = line.buffer[line.pos];
+		line.filterstore = (multiply_32x32_rshift32_rounded(output, damp2)
+		                    + multiply_32x32_rshift32_rounded(line.filterstore, damp1))
+		                   << 1;
+		mix[i] = line.filterstore;
+		if (i & 1) {
+			r += output;
+		}
+		else {
+			l += output;
+		}
+	}
+
+	// Fast Hadamard transform, halving at each stage so nothing can overflow
+	for (int32_t h = 1; h < numLines; h <<= 1) {
+		for (int32_t i = 0; i < numLines; i += h << 1) {
+			for (int32_t j = i; j < i + h; j++) {
+				int32_t a = mix[j] >> 1;
+				int32_t b = mix[j + h] >> 1;
+				mix[j] = a + b;
+				mix[j + h] = a - b;
+			}
+		}
+	}
+
+	for (int32_t i = 0; i < numLines; i++) {
+		DelayLine& line = lines[i];
+		line.buffer[line.pos] = input + (multiply_32x32_rshift32_rounded(mix[i], line.feedback) << 4);
+		if (++line.pos >= line.length) {
+			line.pos = 0;
+		}
+	}
+
+	// Fewer lines means fewer to sum, so make up the level
+	*outL = l * (kOutputGain * kMaxNumLines / numLines);
+	*outR = r * (kOutputGain * kMaxNumLines / numLines);
+}
+
+template <int32_t numLines, bool halfRate>
+void FDN::processLines(int32_t const* input, int32_t* outputL, int32_t* outputR, int32_t numSamples) {
+	for (int32_t n = 0; n < numSamples; n++) {
+		int32_t outL;
+		int32_t outR;
+
+		if constexpr (halfRate) {
+			// Average each pair of input samples, and linearly interpolate between the outputs, which puts the output
+			// one half-rate sample late
+			if (!halfRatePhase) {
+				halfRateInput = input[n] >> 1;
+				outL = lastOutL;
+				outR = lastOutR;
+			}
+			else {
+				int32_t newOutL;
+				int32_t newOutR;
+				tick<numLines>(halfRateInput + (input[n] >> 1), &newOutL, &newOutR);
+				outL = (lastOutL >> 1) + (newOutL >> 1);
+				outR = (lastOutR >> 1) + (newOutR >> 1);
+				lastOutL = newOutL;
+				lastOutR = newOutR;
+			}
+			halfRatePhase = !halfRatePhase;
+		}
+		else {
+			tick<numLines>(input[n], &outL, &outR);
+		}
+
+		// Same as revmodel
+		outputL[n] = outL + (multiply_32x32_rshift32_rounded(outR, wet2)) << 1;
+		outputR[n] = outR + (multiply_32x32_rshift32_rounded(outL, wet2)) << 1;
+	}
+}
+
+void FDN::process(int32_t const* input, int32_t* outputL, int32_t* outputR, int32_t numSamples) {
+	switch (quality) {
+	case ReverbQuality::HIGH:
+		processLines<8, false>(input, outputL, outputR, numSamples);
+		break;
+	case ReverbQuality::MEDIUM:
+		processLines<8, true>(input, outputL, outputR, numSamples);
+		break;
+	case ReverbQuality::LOW:
+		processLines<4, true>(input, outputL, outputR, numSamples);
+		break;
+	}
+}
+
+} // namespace deluge::dsp::reverb
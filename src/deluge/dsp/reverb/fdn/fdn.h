@@ -0,0 +1,85 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "definitions_cxx.hpp"
+#include <cstdint>
+
+namespace deluge::dsp::reverb {
+
+/**
+ * A lighter alternative to freeverb: a feedback delay network of 8 (or 4) delay lines, mixed back into each other
+ * through a Hadamard matrix, each with the same damping filter as a freeverb comb. Every line is shared between both
+ * channels - the outputs are just taken from alternate lines - so even at its best quality it does much less work
+ * than freeverb's 16 combs and 8 allpasses.
+ *
+ * It takes the same room size, dampening and width values as revmodel, so either can be switched to without the
+ * reverb changing character completely.
+*/
+class FDN {
+public:
+	FDN();
+	/// Processes a block of no more than SSI_TX_BUFFER_NUM_SAMPLES
+	void process(int32_t const* input, int32_t* outputL, int32_t* outputR, int32_t numSamples);
+	void mute();
+	/// Values as taken by revmodel's setters. Cheap to call when nothing's changed
+	void setParams(float newRoomSize, float newDamp, float newWidth);
+	/// Changing the quality clears the reverb's state
+	void setQuality(ReverbQuality newQuality);
+	ReverbQuality getQuality() const { return quality; }
+
+	static constexpr int32_t kMaxNumLines = 8;
+
+private:
+	template <int32_t numLines>
+	[[gnu::always_inline]] inline void tick(int32_t input, int32_t* outL, int32_t* outR);
+	template <int32_t numLines, bool halfRate>
+	void processLines(int32_t const* input, int32_t* outputL, int32_t* outputR, int32_t numSamples);
+	void setupLines();
+
+	struct DelayLine {
+		int32_t* buffer;
+		int32_t length;
+		int32_t pos;
+		int32_t filterstore;
+		int32_t feedback; // Includes the matrix's normalization. 1 represented as 268435456
+	};
+
+	DelayLine lines[kMaxNumLines];
+	ReverbQuality quality;
+	float roomSize;
+	float damp;
+	float width;
+	int32_t damp1;
+	int32_t damp2;
+	int32_t wet2;
+
+	// For running at half the sample rate
+	bool halfRatePhase;
+	int32_t halfRateInput;
+	int32_t lastOutL;
+	int32_t lastOutR;
+
+	static constexpr int32_t kLineLengths[kMaxNumLines] = {1087, 1283, 1447, 1613, 1777, 1949, 2129, 2311};
+	static constexpr int32_t kTotalLineLength =
+	    kLineLengths[0] + kLineLengths[1] + kLineLengths[2] + kLineLengths[3] + kLineLengths[4] + kLineLengths[5]
+	    + kLineLengths[6] + kLineLengths[7];
+	int32_t memory[kTotalLineLength];
+};
+
+} // namespace deluge::dsp::reverb
@@ -22,6 +22,8 @@
 */
 
 #include "dsp/reverb/freeverb/allpass.hpp"
+#include "arm_neon.h"
+#include <algorithm>
 
 allpass::allpass() {
 	bufidx = 0;
@@ -32,6 +34,35 @@ void allpass::setbuffer(int32_t* buf, int32_t size) {
 	bufsize = size;
 }
 
+void allpass::processBlock(int32_t* samples, int32_t numSamples) {
+	// Nothing written during the block gets read back in it, so however many samples are in a row before the buffer
+	// wraps around can be done four at a time
+	while (numSamples) {
+		int32_t numNow = std::min(numSamples, bufsize - bufidx);
+		int32_t* bufferPos = &buffer[bufidx];
+
+		int32_t i = 0;
+		for (; i + 4 <= numNow; i += 4) {
+			int32x4_t input = vld1q_s32(&samples[i]);
+			int32x4_t bufout = vld1q_s32(&bufferPos[i]);
+			vst1q_s32(&bufferPos[i], vsraq_n_s32(input, bufout, 1));
+			vst1q_s32(&samples[i], vsubq_s32(bufout, input));
+		}
+		for (; i < numNow; i++) {
+			int32_t bufout = bufferPos[i];
+			bufferPos[i] = samples[i] + (bufout >> 1);
+			samples[i] = bufout - samples[i];
+		}
+
+		samples += numNow;
+		numSamples -= numNow;
+		bufidx += numNow;
+		if (bufidx >= bufsize) {
+			bufidx = 0;
+		}
+	}
+}
+
 void allpass::mute() {
 	for (int32_t i = 0; i < bufsize; i++) {
 		buffer[i] = 0;
@@ -30,6 +30,9 @@ public:
 	allpass();
 	void setbuffer(int32_t* buf, int32_t size);
 	inline int32_t process(int32_t inp);
+	// Same as calling process() on each sample in turn, replacing them with the output. numSamples must be no more than
+	// bufsize
+	void processBlock(int32_t* samples, int32_t numSamples);
 	void mute();
 	void setfeedback(float val);
 	float getfeedback();
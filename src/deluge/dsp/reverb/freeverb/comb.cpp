@@ -22,6 +22,26 @@
 */
 
 #include "dsp/reverb/freeverb/comb.hpp"
+#include "arm_neon.h"
+#include "definitions_cxx.hpp"
+#include "util/functions_quad.h"
+#include <cstring>
+
+// Each of the four combs' stretch of buffer for the block currently being processed - first what gets read out of it,
+// then what gets written back. Copied contiguous so the combs can be loaded four samples at a time and transposed into
+// lanes
+static int32_t combBlockSamples[4][SSI_TX_BUFFER_NUM_SAMPLES] __attribute__((aligned(CACHE_LINE_SIZE)));
+
+// Turns four vectors of one comb's four samples each into four vectors of one sample from each of the four combs, or
+// back again
+[[gnu::always_inline]] static inline void transpose4x4(int32x4_t* rows) {
+	int32x4x2_t t01 = vtrnq_s32(rows[0], rows[1]);
+	int32x4x2_t t23 = vtrnq_s32(rows[2], rows[3]);
+	rows[0] = vcombine_s32(vget_low_s32(t01.val[0]), vget_low_s32(t23.val[0]));
+	rows[1] = vcombine_s32(vget_low_s32(t01.val[1]), vget_low_s32(t23.val[1]));
+	rows[2] = vcombine_s32(vget_high_s32(t01.val[0]), vget_high_s32(t23.val[0]));
+	rows[3] = vcombine_s32(vget_high_s32(t01.val[1]), vget_high_s32(t23.val[1]));
+}
 
 comb::comb() {
 	filterstore = 0;
@@ -33,6 +53,85 @@ void comb::setbuffer(int32_t* buf, int32_t size) {
 	bufsize = size;
 }
 
+void comb::processBlockOfFour(comb* combs, int32_t const* input, int32_t* output, int32_t numSamples) {
+	// Copy out the part of each buffer that'll be read during this block, wrapping around if need be
+	for (int32_t c = 0; c < 4; c++) {
+		int32_t numBeforeWrap = std::min(numSamples, combs[c].bufsize - combs[c].bufidx);
+		memcpy(combBlockSamples[c], &combs[c].buffer[combs[c].bufidx], numBeforeWrap * sizeof(int32_t));
+		memcpy(&combBlockSamples[c][numBeforeWrap], combs[c].buffer, (numSamples - numBeforeWrap) * sizeof(int32_t));
+	}
+
+	// What comes out of each comb is just what was in its buffer, so those can be summed for the whole block up front
+	int32_t n = 0;
+	for (; n + 4 <= numSamples; n += 4) {
+		int32x4_t sum = vld1q_s32(&output[n]);
+		for (int32_t c = 0; c < 4; c++) {
+			sum = vaddq_s32(sum, vld1q_s32(&combBlockSamples[c][n]));
+		}
+		vst1q_s32(&output[n], sum);
+	}
+	for (; n < numSamples; n++) {
+		output[n] += combBlockSamples[0][n] + combBlockSamples[1][n] + combBlockSamples[2][n] + combBlockSamples[3][n];
+	}
+
+	int32x4_t filterstore = {combs[0].filterstore, combs[1].filterstore, combs[2].filterstore, combs[3].filterstore};
+	int32x4_t damp1 = {combs[0].damp1, combs[1].damp1, combs[2].damp1, combs[3].damp1};
+	int32x4_t damp2 = {combs[0].damp2, combs[1].damp2, combs[2].damp2, combs[3].damp2};
+	int32x4_t feedback = {combs[0].feedback, combs[1].feedback, combs[2].feedback, combs[3].feedback};
+
+	// Then the damping filter, which has to go a sample at a time, but runs all four combs at once. Each sample read
+	// out gets replaced by the one to write back
+	auto processSample = [&](int32x4_t bufout, int32_t inputSample) {
+		filterstore = vshlq_n_s32(vaddq_s32(multiply_32x32_rshift32_rounded_quad(bufout, damp2),
+		                                    multiply_32x32_rshift32_rounded_quad(filterstore, damp1)),
+		                          1);
+		return vaddq_s32(vdupq_n_s32(inputSample),
+		                 vshlq_n_s32(multiply_32x32_rshift32_rounded_quad(filterstore, feedback), 1));
+	};
+
+	n = 0;
+	for (; n + 4 <= numSamples; n += 4) {
+		int32x4_t samples[4];
+		for (int32_t c = 0; c < 4; c++) {
+			samples[c] = vld1q_s32(&combBlockSamples[c][n]);
+		}
+		transpose4x4(samples);
+		for (int32_t i = 0; i < 4; i++) {
+			samples[i] = processSample(samples[i], input[n + i]);
+		}
+		transpose4x4(samples);
+		for (int32_t c = 0; c < 4; c++) {
+			vst1q_s32(&combBlockSamples[c][n], samples[c]);
+		}
+	}
+	for (; n < numSamples; n++) {
+		int32x4_t sample = {combBlockSamples[0][n], combBlockSamples[1][n], combBlockSamples[2][n],
+		                    combBlockSamples[3][n]};
+		sample = processSample(sample, input[n]);
+		combBlockSamples[0][n] = vgetq_lane_s32(sample, 0);
+		combBlockSamples[1][n] = vgetq_lane_s32(sample, 1);
+		combBlockSamples[2][n] = vgetq_lane_s32(sample, 2);
+		combBlockSamples[3][n] = vgetq_lane_s32(sample, 3);
+	}
+
+	combs[0].filterstore = vgetq_lane_s32(filterstore, 0);
+	combs[1].filterstore = vgetq_lane_s32(filterstore, 1);
+	combs[2].filterstore = vgetq_lane_s32(filterstore, 2);
+	combs[3].filterstore = vgetq_lane_s32(filterstore, 3);
+
+	// And copy what's to be written back into the buffers
+	for (int32_t c = 0; c < 4; c++) {
+		int32_t numBeforeWrap = std::min(numSamples, combs[c].bufsize - combs[c].bufidx);
+		memcpy(&combs[c].buffer[combs[c].bufidx], combBlockSamples[c], numBeforeWrap * sizeof(int32_t));
+		memcpy(combs[c].buffer, &combBlockSamples[c][numBeforeWrap], (numSamples - numBeforeWrap) * sizeof(int32_t));
+
+		combs[c].bufidx += numSamples;
+		if (combs[c].bufidx >= combs[c].bufsize) {
+			combs[c].bufidx -= combs[c].bufsize;
+		}
+	}
+}
+
 void comb::mute() {
 	for (int32_t i = 0; i < bufsize; i++) {
 		buffer[i] = 0;
@@ -31,6 +31,10 @@ public:
 	comb();
 	void setbuffer(int32_t* buf, int32_t size);
 	inline int32_t process(int32_t inp);
+	// Runs four combs over a whole block at once, one in each NEON lane, adding all their outputs to output[]. Gives
+	// exactly what calling process() on each of them for each sample would. numSamples must be no more than
+	// SSI_TX_BUFFER_NUM_SAMPLES, and no more than any comb's buffer size, so nothing written during the block is read in it
+	static void processBlockOfFour(comb* combs, int32_t const* input, int32_t* output, int32_t numSamples);
 	void mute();
 	void setdamp(float val);
 	float getdamp();
@@ -22,6 +22,12 @@
  */
 
 #include "dsp/reverb/freeverb/revmodel.hpp"
+#include "definitions_cxx.hpp"
+#include <cstring>
+
+// The block processing relies on nothing written to a buffer during a block being read back in that same block
+static_assert(SSI_TX_BUFFER_NUM_SAMPLES <= allpasstuningL4 && SSI_TX_BUFFER_NUM_SAMPLES <= combtuningL1);
+static_assert(numcombs % 4 == 0);
 
 revmodel::revmodel() {
 	// Tie the components to their buffers
@@ -70,6 +76,31 @@ revmodel::revmodel() {
 	mute();
 }
 
+void revmodel::process(int32_t const* input, int32_t* outputL, int32_t* outputR, int32_t numSamples) {
+	memset(outputL, 0, numSamples * sizeof(int32_t));
+	memset(outputR, 0, numSamples * sizeof(int32_t));
+
+	// Accumulate comb filters in parallel
+	for (int32_t i = 0; i < numcombs; i += 4) {
+		comb::processBlockOfFour(&combL[i], input, outputL, numSamples);
+		comb::processBlockOfFour(&combR[i], input, outputR, numSamples);
+	}
+
+	// Feed through allpasses in series
+	for (int32_t i = 0; i < numallpasses; i++) {
+		allpassL[i].processBlock(outputL, numSamples);
+		allpassR[i].processBlock(outputR, numSamples);
+	}
+
+	// Calculate output
+	for (int32_t n = 0; n < numSamples; n++) {
+		int32_t outL = outputL[n];
+		int32_t outR = outputR[n];
+		outputL[n] = outL + (multiply_32x32_rshift32_rounded(outR, wet2)) << 1;
+		outputR[n] = outR + (multiply_32x32_rshift32_rounded(outL, wet2)) << 1;
+	}
+}
+
 void revmodel::mute() {
 	if (getmode() >= freezemode) {
 		return;
@@ -45,6 +45,10 @@ public:
 	void setmode(float value);
 	float getmode();
 
+	// Processes a whole block of input, no more than SSI_TX_BUFFER_NUM_SAMPLES long. Gives exactly what calling the
+	// per-sample process() below for each sample would
+	void process(int32_t const* input, int32_t* outputL, int32_t* outputR, int32_t numSamples);
+
 	inline void process(int32_t input, int32_t* outputL, int32_t* outputR) {
 		int32_t outL, outR;
 
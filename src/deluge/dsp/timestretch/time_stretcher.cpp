@@ -170,7 +170,7 @@ void TimeStretcher::beenUnassigned() {
 	unassignAllReasonsForPercCacheClusters();
 	olderPartReader.unassignAllReasons();
 	if (buffer) {
-		delugeDealloc(buffer);
+		deallocateBuffer();
 	}
 }
 
@@ -957,8 +957,7 @@ optForDirectReading:
 	// If no one's reading from the buffer anymore, stop filling it
 	if (buffer
 	    && !olderHeadReadingFromBuffer) { // olderHeadReadingFromBuffer will always be false - we set it above, at the start
-		delugeDealloc(buffer);
-		buffer = NULL;
+		deallocateBuffer();
 		Debug::println("abandoning buffer!!!!!!!!!!!!!!!!");
 	}
 
@@ -1040,8 +1039,7 @@ void TimeStretcher::reassessWhetherToBeFillingBuffer(int32_t phaseIncrement, int
 		// If no one's reading from the buffer anymore, stop filling it
 		if (!newerHeadReadingFromBuffer && !olderHeadReadingFromBuffer && bufferFillingMode == BUFFER_FILLING_NEITHER) {
 			bufferFillingMode = BUFFER_FILLING_OFF;
-			delugeDealloc(buffer);
-			buffer = NULL;
+			deallocateBuffer();
 			Debug::println("abandoning buffer!!!!!!!!!!!!!!!!");
 		}
 	}
@@ -1049,11 +1047,15 @@ void TimeStretcher::reassessWhetherToBeFillingBuffer(int32_t phaseIncrement, int
 #endif
 
 bool TimeStretcher::allocateBuffer(int32_t numChannels) {
-	buffer = (int32_t*)GeneralMemoryAllocator::get().alloc(TimeStretch::kBufferSize * sizeof(int32_t) * numChannels,
-	                                                       NULL, false, true);
+	buffer = AudioEngine::solicitTimeStretcherBuffer(numChannels);
 	return (buffer != NULL);
 }
 
+void TimeStretcher::deallocateBuffer() {
+	AudioEngine::timeStretcherBufferUnassigned(buffer);
+	buffer = NULL;
+}
+
 void TimeStretcher::readFromBuffer(int32_t* __restrict__ oscBufferPos, int32_t numSamples, int32_t numChannels,
                                    int32_t numChannelsAfterCondensing, int32_t sourceAmplitudeNow,
                                    int32_t amplitudeIncrementNow, int32_t* __restrict__ bufferReadPos) {
@@ -1174,8 +1176,7 @@ void TimeStretcher::setupCrossfadeFromCache(SampleCache* cache, int32_t cacheByt
 
 	// If we're really unlucky, allocating the buffer may have stolen from the cache
 	if (originalCacheWriteBytePos != cache->writeBytePos) {
-		delugeDealloc(buffer);
-		buffer = NULL;
+		deallocateBuffer();
 		return;
 	}
 
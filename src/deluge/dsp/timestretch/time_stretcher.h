@@ -55,6 +55,7 @@ public:
 
 	int32_t getSamplePos(int32_t playDirection);
 	bool allocateBuffer(int32_t numChannels);
+	void deallocateBuffer();
 
 	void readFromBuffer(int32_t* oscBufferPos, int32_t numSamples, int32_t numChannels,
 	                    int32_t numChannelsAfterCondensing, int32_t sourceAmplitudeNow, int32_t amplitudeIncrementNow,
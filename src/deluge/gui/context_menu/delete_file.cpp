@@ -22,6 +22,7 @@
 #include "hid/display/display.h"
 #include "hid/matrix/matrix_driver.h"
 #include "io/debug/print.h"
+#include "storage/folder_index.h"
 
 extern "C" {
 #include "fatfs/ff.h"
@@ -82,6 +83,7 @@ bool DeleteFile::acceptCurrentOption() {
 		// But we'll still go back to the Browser
 	}
 	else {
+		FolderIndex::folderChanged(filePath.get());
 		display->displayPopup(l10n::get(STRING_FOR_FILE_DELETED));
 		browser->currentFileDeleted();
 	}
@@ -341,6 +341,9 @@ PLACE_SDRAM_DATA Language english{
         {STRING_FOR_FOLDERS_CANNOT_BE_DELETED_ON_THE_DELUGE, "Folders cannot be deleted on the Deluge"},
         {STRING_FOR_ERROR_CREATING_MULTISAMPLED_INSTRUMENT, "Error creating multisampled instrument"},
         {STRING_FOR_CLIP_IS_RECORDING, "Clip is recording"},
+        {STRING_FOR_STOP_PLAYBACK_FIRST, "Stop playback first"},
+        {STRING_FOR_TURN_OFF_ARP_FIRST, "Turn off arp first"},
+        {STRING_FOR_CLIP_FROZEN, "Clip frozen"},
         {STRING_FOR_AUDIO_FILE_IS_USED_IN_CURRENT_SONG, "Audio file is used in current song"},
         {STRING_FOR_CAN_ONLY_USE_SLICER_FOR_BRAND_NEW_KIT, "Can only user slicer for brand-new kit"},
         {STRING_FOR_TEMP_FOLDER_CANT_BE_BROWSED, "TEMP folder can't be browsed"},
@@ -451,6 +454,7 @@ PLACE_SDRAM_DATA Language english{
         {STRING_FOR_ROOM_SIZE, "Room size"},
         {STRING_FOR_SUB_BANK, "Sub-bank"},
         {STRING_FOR_PLAY_DIRECTION, "Play direction"},
+        {STRING_FOR_FREEZE_CLIP, "Freeze clip"},
         {STRING_FOR_SWING_INTERVAL, "Swing interval"},
         {STRING_FOR_SHORTCUTS_VERSION, "Shortcuts version"},
         {STRING_FOR_KEYBOARD_FOR_TEXT, "Keyboard for text"},
@@ -459,6 +463,12 @@ PLACE_SDRAM_DATA Language english{
         {STRING_FOR_SAMPLE_PREVIEW, "Sample preview"},
         {STRING_FOR_PLAY_CURSOR, "Play-cursor"},
         {STRING_FOR_FIRMWARE_VERSION, "Firmware version"},
+        {STRING_FOR_CPU_PROFILE, "CPU profile"},
+        {STRING_FOR_MEMORY_TELEMETRY, "Memory"},
+        {STRING_FOR_CARD_BENCHMARK, "SD card benchmark"},
+        {STRING_FOR_VOICE_STATS, "Voice stats"},
+        {STRING_FOR_PERFORMANCE_REPORT, "Perf report"},
+        {STRING_FOR_SONG_ENGINE_PROFILE, "Song engine"},
         {STRING_FOR_COMMUNITY_FTS, "Community features"},
         {STRING_FOR_MIDI_THRU, "MIDI-thru"},
         {STRING_FOR_TAKEOVER, "TAKEOVER"},
@@ -501,6 +511,22 @@ PLACE_SDRAM_DATA Language english{
         {STRING_FOR_COMMUNITY_FEATURE_SYNC_SCALING_ACTION, "Sync Scaling Action"},
         {STRING_FOR_COMMUNITY_FEATURE_HIGHLIGHT_INCOMING_NOTES, "Highlight Incoming Notes"},
         {STRING_FOR_COMMUNITY_FEATURE_NORNS_LAYOUT, "Display Norns Layout"},
+        {STRING_FOR_COMMUNITY_FEATURE_RENDER_BLOCK_SIZE, "Render Block Size"},
+        {STRING_FOR_COMMUNITY_FEATURE_LAZY_SAMPLE_LOADING, "Lazy Sample Loading"},
+        {STRING_FOR_COMMUNITY_FEATURE_VECTOR_FILTERS, "Vector Filters"},
+        {STRING_FOR_COMMUNITY_FEATURE_MASTER_COMPRESSOR_DETECTION, "Comp Detection"},
+        {STRING_FOR_COMMUNITY_FEATURE_CONTROL_RATE, "Control Rate"},
+        {STRING_FOR_COMMUNITY_FEATURE_ECO_PITCH_SHIFT, "Eco Pitch Shift"},
+        {STRING_FOR_COMMUNITY_FEATURE_LOAD_METER, "Load Meter"},
+        {STRING_FOR_COMMUNITY_FEATURE_RESUME_LAST_SONG, "Resume Last Song"},
+        {STRING_FOR_COMMUNITY_FEATURE_TRANSCODE_SAMPLES, "Transcode Samples"},
+        {STRING_FOR_COMMUNITY_FEATURE_DELAY_MEMORY_SAVER, "Delay Memory Saver"},
+        {STRING_FOR_COMMUNITY_FEATURE_DIRECT_MONITORING, "Direct Monitoring"},
+        {STRING_FOR_COMMUNITY_FEATURE_COMPRESS_SAMPLES, "Compress Samples"},
+        {STRING_FOR_COMMUNITY_FEATURE_PERFORMANCE_REPORTS, "Performance Reports"},
+        {STRING_FOR_COMMUNITY_FEATURE_TRACK_CPU_OVERLAY, "Track CPU Overlay"},
+        {STRING_FOR_COMMUNITY_FEATURE_REPEATABLE_PROBABILITY, "Repeatable Probability"},
+        {STRING_FOR_COMMUNITY_FEATURE_ENGINE_PROFILE, "Engine Profile"},
 
         {STRING_FOR_TRACK_STILL_HAS_CLIPS_IN_SESSION, "Track still has clips in session"},
         {STRING_FOR_DELETE_ALL_TRACKS_CLIPS_FIRST, "Delete all track's clips first"},
@@ -537,6 +563,7 @@ PLACE_SDRAM_DATA Language english{
         {STRING_FOR_ARPEGGIATOR, "ARPEGGIATOR"},
         {STRING_FOR_POLYPHONY, "POLYPHONY"},
         {STRING_FOR_PRIORITY, "PRIORITY"},
+        {STRING_FOR_PARAPHONIC, "PARAPHONIC"},
         {STRING_FOR_VOICE, "VOICE"},
         {STRING_FOR_DESTINATION, "Destination"},
         {STRING_FOR_RETRIGGER_PHASE, "Retrigger phase"},
@@ -564,6 +591,10 @@ PLACE_SDRAM_DATA Language english{
         {STRING_FOR_WIDTH, "WIDTH"},
         {STRING_FOR_REVERB_WIDTH, "Reverb width"},
         {STRING_FOR_REVERB_PAN, "Reverb pan"},
+        {STRING_FOR_MODEL, "MODEL"},
+        {STRING_FOR_REVERB_MODEL, "Reverb model"},
+        {STRING_FOR_QUALITY, "QUALITY"},
+        {STRING_FOR_REVERB_QUALITY, "Reverb quality"},
         {STRING_FOR_SATURATION, "SATURATION"},
         {STRING_FOR_BANK, "BANK"},
         {STRING_FOR_MIDI_BANK, "MIDI bank"},
@@ -672,6 +703,11 @@ PLACE_SDRAM_DATA Language english{
         {STRING_FOR_CV_TRANSPOSE_MENU_TITLE, "CV* transpose"},
         {STRING_FOR_SHORTCUTS_VER_MENU_TITLE, "Shortcuts ver."},
         {STRING_FOR_FIRMWARE_VER_MENU_TITLE, "Firmware ver."},
+        {STRING_FOR_CPU_PROFILE_MENU_TITLE, "CPU profile"},
+        {STRING_FOR_MEMORY_TELEMETRY_MENU_TITLE, "Memory"},
+        {STRING_FOR_CARD_BENCHMARK_MENU_TITLE, "SD benchmark"},
+        {STRING_FOR_VOICE_STATS_MENU_TITLE, "Voice stats"},
+        {STRING_FOR_PERFORMANCE_REPORT_MENU_TITLE, "Perf report"},
         {STRING_FOR_COMMUNITY_FTS_MENU_TITLE, "Community fts."},
         {STRING_FOR_TEMPO_M_MATCH_MENU_TITLE, "Tempo m. match"},
         {STRING_FOR_T_CLOCK_INPUT_MENU_TITLE, "T. clock input"},
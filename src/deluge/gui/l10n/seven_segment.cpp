@@ -186,6 +186,9 @@ PLACE_SDRAM_DATA Language seven_segment{
         {STRING_FOR_FOLDERS_CANNOT_BE_DELETED_ON_THE_DELUGE, "CANT"},
         {STRING_FOR_ERROR_CREATING_MULTISAMPLED_INSTRUMENT, "FAIL"},
         {STRING_FOR_CLIP_IS_RECORDING, "CANT"},
+        {STRING_FOR_STOP_PLAYBACK_FIRST, "STOP"},
+        {STRING_FOR_TURN_OFF_ARP_FIRST, "ARP"},
+        {STRING_FOR_CLIP_FROZEN, "DONE"},
         {STRING_FOR_AUDIO_FILE_IS_USED_IN_CURRENT_SONG, "USED"},
         {STRING_FOR_CAN_ONLY_USE_SLICER_FOR_BRAND_NEW_KIT, "CANT"},
         {STRING_FOR_TEMP_FOLDER_CANT_BE_BROWSED, "CANT"},
@@ -293,6 +296,7 @@ PLACE_SDRAM_DATA Language seven_segment{
         {STRING_FOR_BITCRUSH, "CRUSH"},
         {STRING_FOR_SUB_BANK, "SUB"},
         {STRING_FOR_PLAY_DIRECTION, "DIRECTION"},
+        {STRING_FOR_FREEZE_CLIP, "FREZ"},
         {STRING_FOR_SWING_INTERVAL, "SWIN"},
         {STRING_FOR_SHORTCUTS_VERSION, "SHOR"},
         {STRING_FOR_KEYBOARD_FOR_TEXT, "KEYB"},
@@ -301,6 +305,12 @@ PLACE_SDRAM_DATA Language seven_segment{
         {STRING_FOR_SAMPLE_PREVIEW, "PREV"},
         {STRING_FOR_PLAY_CURSOR, "CURS"},
         {STRING_FOR_FIRMWARE_VERSION, "FIRM"},
+        {STRING_FOR_CPU_PROFILE, "CPU"},
+        {STRING_FOR_MEMORY_TELEMETRY, "MEM"},
+        {STRING_FOR_CARD_BENCHMARK, "CARD"},
+        {STRING_FOR_VOICE_STATS, "VSTA"},
+        {STRING_FOR_PERFORMANCE_REPORT, "PERF"},
+        {STRING_FOR_SONG_ENGINE_PROFILE, "SENG"},
         {STRING_FOR_COMMUNITY_FTS, "FEAT"},
         {STRING_FOR_MIDI_THRU, "THRU"},
         {STRING_FOR_TAKEOVER, "TOVR"},
@@ -343,6 +353,22 @@ PLACE_SDRAM_DATA Language seven_segment{
         {STRING_FOR_COMMUNITY_FEATURE_SYNC_SCALING_ACTION, "SCAL"},
         {STRING_FOR_COMMUNITY_FEATURE_HIGHLIGHT_INCOMING_NOTES, "HIGH"},
         {STRING_FOR_COMMUNITY_FEATURE_NORNS_LAYOUT, "NORN"},
+        {STRING_FOR_COMMUNITY_FEATURE_RENDER_BLOCK_SIZE, "BLOC"},
+        {STRING_FOR_COMMUNITY_FEATURE_LAZY_SAMPLE_LOADING, "LAZY"},
+        {STRING_FOR_COMMUNITY_FEATURE_VECTOR_FILTERS, "VFIL"},
+        {STRING_FOR_COMMUNITY_FEATURE_MASTER_COMPRESSOR_DETECTION, "CDET"},
+        {STRING_FOR_COMMUNITY_FEATURE_CONTROL_RATE, "CRAT"},
+        {STRING_FOR_COMMUNITY_FEATURE_ECO_PITCH_SHIFT, "EPSH"},
+        {STRING_FOR_COMMUNITY_FEATURE_LOAD_METER, "LOAD"},
+        {STRING_FOR_COMMUNITY_FEATURE_RESUME_LAST_SONG, "RESU"},
+        {STRING_FOR_COMMUNITY_FEATURE_TRANSCODE_SAMPLES, "TRCD"},
+        {STRING_FOR_COMMUNITY_FEATURE_DELAY_MEMORY_SAVER, "DMEM"},
+        {STRING_FOR_COMMUNITY_FEATURE_DIRECT_MONITORING, "DMON"},
+        {STRING_FOR_COMMUNITY_FEATURE_COMPRESS_SAMPLES, "CMPS"},
+        {STRING_FOR_COMMUNITY_FEATURE_PERFORMANCE_REPORTS, "PREP"},
+        {STRING_FOR_COMMUNITY_FEATURE_TRACK_CPU_OVERLAY, "TCPU"},
+        {STRING_FOR_COMMUNITY_FEATURE_REPEATABLE_PROBABILITY, "RPRB"},
+        {STRING_FOR_COMMUNITY_FEATURE_ENGINE_PROFILE, "ENGI"},
 
         {STRING_FOR_TRACK_STILL_HAS_CLIPS_IN_SESSION, "CANT"},
         {STRING_FOR_DELETE_ALL_TRACKS_CLIPS_FIRST, "CANT"},
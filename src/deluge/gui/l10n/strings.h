@@ -248,6 +248,9 @@ enum class String : size_t {
 	STRING_FOR_FOLDERS_CANNOT_BE_DELETED_ON_THE_DELUGE,
 	STRING_FOR_ERROR_CREATING_MULTISAMPLED_INSTRUMENT,
 	STRING_FOR_CLIP_IS_RECORDING,
+	STRING_FOR_STOP_PLAYBACK_FIRST,
+	STRING_FOR_TURN_OFF_ARP_FIRST,
+	STRING_FOR_CLIP_FROZEN,
 	STRING_FOR_AUDIO_FILE_IS_USED_IN_CURRENT_SONG,
 	STRING_FOR_CAN_ONLY_USE_SLICER_FOR_BRAND_NEW_KIT,
 	STRING_FOR_TEMP_FOLDER_CANT_BE_BROWSED,
@@ -358,6 +361,7 @@ enum class String : size_t {
 	STRING_FOR_BITCRUSH,
 	STRING_FOR_SUB_BANK,
 	STRING_FOR_PLAY_DIRECTION,
+	STRING_FOR_FREEZE_CLIP,
 	STRING_FOR_SWING_INTERVAL,
 	STRING_FOR_SHORTCUTS_VERSION,
 	STRING_FOR_KEYBOARD_FOR_TEXT,
@@ -366,6 +370,12 @@ enum class String : size_t {
 	STRING_FOR_SAMPLE_PREVIEW,
 	STRING_FOR_PLAY_CURSOR,
 	STRING_FOR_FIRMWARE_VERSION,
+	STRING_FOR_CPU_PROFILE,
+	STRING_FOR_MEMORY_TELEMETRY,
+	STRING_FOR_CARD_BENCHMARK,
+	STRING_FOR_VOICE_STATS,
+	STRING_FOR_PERFORMANCE_REPORT,
+	STRING_FOR_SONG_ENGINE_PROFILE,
 	STRING_FOR_COMMUNITY_FTS,
 	STRING_FOR_MIDI_THRU,
 	STRING_FOR_TAKEOVER,
@@ -407,6 +417,22 @@ enum class String : size_t {
 	STRING_FOR_COMMUNITY_FEATURE_SYNC_SCALING_ACTION,
 	STRING_FOR_COMMUNITY_FEATURE_HIGHLIGHT_INCOMING_NOTES,
 	STRING_FOR_COMMUNITY_FEATURE_NORNS_LAYOUT,
+	STRING_FOR_COMMUNITY_FEATURE_RENDER_BLOCK_SIZE,
+	STRING_FOR_COMMUNITY_FEATURE_LAZY_SAMPLE_LOADING,
+	STRING_FOR_COMMUNITY_FEATURE_VECTOR_FILTERS,
+	STRING_FOR_COMMUNITY_FEATURE_MASTER_COMPRESSOR_DETECTION,
+	STRING_FOR_COMMUNITY_FEATURE_CONTROL_RATE,
+	STRING_FOR_COMMUNITY_FEATURE_ECO_PITCH_SHIFT,
+	STRING_FOR_COMMUNITY_FEATURE_LOAD_METER,
+	STRING_FOR_COMMUNITY_FEATURE_RESUME_LAST_SONG,
+	STRING_FOR_COMMUNITY_FEATURE_TRANSCODE_SAMPLES,
+	STRING_FOR_COMMUNITY_FEATURE_DELAY_MEMORY_SAVER,
+	STRING_FOR_COMMUNITY_FEATURE_DIRECT_MONITORING,
+	STRING_FOR_COMMUNITY_FEATURE_COMPRESS_SAMPLES,
+	STRING_FOR_COMMUNITY_FEATURE_PERFORMANCE_REPORTS,
+	STRING_FOR_COMMUNITY_FEATURE_TRACK_CPU_OVERLAY,
+	STRING_FOR_COMMUNITY_FEATURE_REPEATABLE_PROBABILITY,
+	STRING_FOR_COMMUNITY_FEATURE_ENGINE_PROFILE,
 
 	STRING_FOR_TRACK_STILL_HAS_CLIPS_IN_SESSION,
 	STRING_FOR_DELETE_ALL_TRACKS_CLIPS_FIRST,
@@ -444,6 +470,7 @@ enum class String : size_t {
 	STRING_FOR_POLYPHONY,
 	STRING_FOR_PORTAMENTO,
 	STRING_FOR_PRIORITY,
+	STRING_FOR_PARAPHONIC,
 	STRING_FOR_VOICE,
 	STRING_FOR_DESTINATION,
 	STRING_FOR_RETRIGGER_PHASE,
@@ -480,6 +507,10 @@ enum class String : size_t {
 	STRING_FOR_WIDTH,
 	STRING_FOR_REVERB_WIDTH,
 	STRING_FOR_REVERB_PAN,
+	STRING_FOR_MODEL,
+	STRING_FOR_REVERB_MODEL,
+	STRING_FOR_QUALITY,
+	STRING_FOR_REVERB_QUALITY,
 	STRING_FOR_SATURATION,
 	STRING_FOR_DECIMATION,
 	STRING_FOR_BANK,
@@ -600,6 +631,11 @@ enum class String : size_t {
 	STRING_FOR_CV_TRANSPOSE_MENU_TITLE,
 	STRING_FOR_SHORTCUTS_VER_MENU_TITLE,
 	STRING_FOR_FIRMWARE_VER_MENU_TITLE,
+	STRING_FOR_CPU_PROFILE_MENU_TITLE,
+	STRING_FOR_MEMORY_TELEMETRY_MENU_TITLE,
+	STRING_FOR_CARD_BENCHMARK_MENU_TITLE,
+	STRING_FOR_VOICE_STATS_MENU_TITLE,
+	STRING_FOR_PERFORMANCE_REPORT_MENU_TITLE,
 	STRING_FOR_COMMUNITY_FTS_MENU_TITLE,
 	STRING_FOR_TEMPO_M_MATCH_MENU_TITLE,
 	STRING_FOR_T_CLOCK_INPUT_MENU_TITLE,
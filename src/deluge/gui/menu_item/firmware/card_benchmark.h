@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include "gui/menu_item/menu_item.h"
+#include "gui/ui/ui.h"
+#include "hid/display/display.h"
+#include "storage/card_benchmark.h"
+#include "util/functions.h"
+#include <string.h>
+
+namespace deluge::gui::menu_item::firmware {
+
+/// Rates the SD card for streaming when select is pressed, then shows how many voices it should keep up with, what
+/// speed its bus ended up running at, and how long its reads took.
+class CardBenchmark final : public MenuItem {
+public:
+	using MenuItem::MenuItem;
+
+	void beginSession(MenuItem* navigatedBackwardFrom) override {
+		state = State::READY;
+		refresh();
+	}
+
+	MenuItem* selectButtonPress() override {
+		display->displayLoadingAnimationText("Testing");
+		state = runCardBenchmark(&result) ? State::DONE : State::FAILED;
+		display->removeLoadingAnimation();
+		refresh();
+		return (MenuItem*)0xFFFFFFFF; // Stay here
+	}
+
+	void drawPixelsForOled() override {
+		int32_t yPixel = OLED_MAIN_TOPMOST_PIXEL + ((OLED_MAIN_HEIGHT_PIXELS == 64) ? 15 : 14);
+		char buffer[32];
+
+		switch (state) {
+		case State::READY:
+			drawLine("Press select", yPixel);
+			drawLine("to test card", yPixel);
+			break;
+
+		case State::FAILED:
+			drawLine("No card", yPixel);
+			break;
+
+		case State::DONE:
+			// e.g. "64 voices", "high speed 33.3MHz", "p95 2.10ms", "median 1.43ms", "worst 9.87ms"
+			intToString(result.numVoices, buffer);
+			strcat(buffer, " voices");
+			drawLine(buffer, yPixel);
+			writeBus(buffer);
+			drawLine(buffer, yPixel);
+			writeTime(buffer, "p95 ", result.p95Microseconds);
+			drawLine(buffer, yPixel);
+			if (OLED_MAIN_HEIGHT_PIXELS == 64) {
+				writeTime(buffer, "median ", result.medianMicroseconds);
+				drawLine(buffer, yPixel);
+				writeTime(buffer, "worst ", result.worstMicroseconds);
+				drawLine(buffer, yPixel);
+			}
+			break;
+		}
+	}
+
+private:
+	enum class State : uint8_t {
+		READY,
+		DONE,
+		FAILED,
+	};
+
+	State state = State::READY;
+	CardBenchmarkResult result;
+
+	void refresh() {
+		if (display->haveOLED()) {
+			renderUIsForOled();
+		}
+		else if (state == State::DONE) {
+			// The numeric display only has room for the rating
+			display->setTextAsNumber(result.numVoices);
+		}
+		else {
+			display->setText((state == State::FAILED) ? "FAIL" : "TEST");
+		}
+	}
+
+	// e.g. "p95 2.10ms"
+	static void writeTime(char* buffer, char const* label, uint32_t microseconds) {
+		strcpy(buffer, label);
+		char* pos = buffer + strlen(buffer);
+		intToString(microseconds / 1000, pos);
+		pos += strlen(pos);
+		*(pos++) = '.';
+		intToString((microseconds % 1000) / 10, pos, 2);
+		strcat(pos, "ms");
+	}
+
+	// e.g. "high speed 33.3MHz" - the mode the card was switched to when mounted, and the clock it's now run at
+	void writeBus(char* buffer) {
+		strcpy(buffer, result.highSpeed ? "high speed " : "default ");
+		char* pos = buffer + strlen(buffer);
+		intToString(result.busClockKHz / 1000, pos);
+		pos += strlen(pos);
+		*(pos++) = '.';
+		intToString((result.busClockKHz % 1000) / 100, pos);
+		strcat(pos, "MHz");
+	}
+
+	static void drawLine(char const* text, int32_t& yPixel) {
+		deluge::hid::display::OLED::drawString(text, kTextSpacingX, yPixel, deluge::hid::display::OLED::oledMainImage[0],
+		                                       OLED_MAIN_WIDTH_PIXELS, kTextSpacingX, kTextSpacingY);
+		yPixel += kTextSpacingY;
+	}
+};
+} // namespace deluge::gui::menu_item::firmware
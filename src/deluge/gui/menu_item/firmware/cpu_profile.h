@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include "gui/menu_item/menu_item.h"
+#include "gui/ui/ui.h"
+#include "gui/ui_timer_manager.h"
+#include "hid/display/display.h"
+#include "io/debug/cpu_profiler.h"
+#include "util/functions.h"
+#include <string.h>
+
+namespace deluge::gui::menu_item::firmware {
+
+/// Read-only page showing how much of the audio routine's real-time budget each stage is using. Refreshes itself.
+class CPUProfile final : public MenuItem {
+public:
+	using MenuItem::MenuItem;
+
+	void beginSession(MenuItem* navigatedBackwardFrom) override {
+		refresh();
+		uiTimerManager.setTimer(TIMER_UI_SPECIFIC, kRefreshTimeMS);
+	}
+
+	ActionResult timerCallback() override {
+		refresh();
+		uiTimerManager.setTimer(TIMER_UI_SPECIFIC, kRefreshTimeMS);
+		return ActionResult::DEALT_WITH;
+	}
+
+	void drawPixelsForOled() override {
+		using Debug::ProfileStage;
+		constexpr ProfileStage lines[][2] = {
+		    {ProfileStage::TOTAL, ProfileStage::SONG_RENDER},
+		    {ProfileStage::SOUND_RENDER, ProfileStage::REVERB},
+		    {ProfileStage::MASTER_COMPRESSOR, ProfileStage::SSI_OUTPUT},
+		};
+
+		int32_t yPixel = OLED_MAIN_TOPMOST_PIXEL + ((OLED_MAIN_HEIGHT_PIXELS == 64) ? 15 : 14);
+		for (auto const& line : lines) {
+			for (int32_t column = 0; column < 2; column++) {
+				char buffer[20];
+				writeStage(buffer, line[column]);
+				deluge::hid::display::OLED::drawString(buffer, kTextSpacingX + column * (OLED_MAIN_WIDTH_PIXELS >> 1),
+				                                       yPixel, deluge::hid::display::OLED::oledMainImage[0],
+				                                       OLED_MAIN_WIDTH_PIXELS, kTextSpacingX, kTextSpacingY);
+			}
+			yPixel += kTextSpacingY;
+		}
+	}
+
+private:
+	static constexpr int32_t kRefreshTimeMS = 500;
+
+	void refresh() {
+		if (display->haveOLED()) {
+			renderUIsForOled();
+		}
+		else {
+			// The numeric display only has room for the total
+			display->setTextAsNumber(Debug::cpuProfiler.getLoadPermille(Debug::ProfileStage::TOTAL) / 10);
+		}
+	}
+
+	// e.g. "sounds 35%"
+	static void writeStage(char* buffer, Debug::ProfileStage stage) {
+		strcpy(buffer, Debug::CPUProfiler::getStageName(stage));
+		char* pos = buffer + strlen(buffer);
+		*(pos++) = ' ';
+		intToString(Debug::cpuProfiler.getLoadPermille(stage) / 10, pos);
+		strcat(pos, "%");
+	}
+};
+} // namespace deluge::gui::menu_item::firmware
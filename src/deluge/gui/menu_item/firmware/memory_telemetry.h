@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include "gui/menu_item/menu_item.h"
+#include "gui/ui/ui.h"
+#include "gui/ui_timer_manager.h"
+#include "hid/display/display.h"
+#include "io/debug/memory_telemetry.h"
+#include "memory/general_memory_allocator.h"
+#include "util/functions.h"
+#include <string.h>
+
+namespace deluge::gui::menu_item::firmware {
+
+/// Read-only page showing how much free memory each region has and how fragmented it is, plus how often Stealables
+/// are being stolen. Refreshes itself. Pressing select dumps the full telemetry to the debug output.
+class MemoryTelemetry final : public MenuItem {
+public:
+	using MenuItem::MenuItem;
+
+	void beginSession(MenuItem* navigatedBackwardFrom) override {
+		refresh();
+		uiTimerManager.setTimer(TIMER_UI_SPECIFIC, kRefreshTimeMS);
+	}
+
+	ActionResult timerCallback() override {
+		refresh();
+		uiTimerManager.setTimer(TIMER_UI_SPECIFIC, kRefreshTimeMS);
+		return ActionResult::DEALT_WITH;
+	}
+
+	MenuItem* selectButtonPress() override {
+		Debug::memoryTelemetry.dump();
+		return (MenuItem*)0xFFFFFFFF; // Stay here
+	}
+
+	void drawPixelsForOled() override {
+		constexpr char const* regionNames[NUM_MEMORY_REGIONS] = {"ext", "int", "non"};
+
+		int32_t yPixel = OLED_MAIN_TOPMOST_PIXEL + ((OLED_MAIN_HEIGHT_PIXELS == 64) ? 15 : 14);
+		for (int32_t r = 0; r < NUM_MEMORY_REGIONS; r++) {
+			MemoryRegionTelemetry telemetry;
+			GeneralMemoryAllocator::get().regions[r].getTelemetry(&telemetry);
+
+			// e.g. "ext 40123K big 39936K"
+			char buffer[32];
+			strcpy(buffer, regionNames[r]);
+			char* pos = buffer + strlen(buffer);
+			pos = writeKilobytes(pos, telemetry.freeBytes);
+			strcpy(pos, " big");
+			pos = writeKilobytes(pos + 4, telemetry.largestFreeRun);
+			drawLine(buffer, yPixel);
+		}
+
+		if (OLED_MAIN_HEIGHT_PIXELS == 64) {
+			char buffer[24];
+			strcpy(buffer, "steals/s ");
+			intToString(stealsPerSecond, buffer + strlen(buffer));
+			drawLine(buffer, yPixel);
+		}
+	}
+
+private:
+	static constexpr int32_t kRefreshTimeMS = 1000;
+
+	int32_t stealsPerSecond = 0;
+
+	void refresh() {
+		stealsPerSecond = Debug::memoryTelemetry.getStealsPerSecond();
+		if (display->haveOLED()) {
+			renderUIsForOled();
+		}
+		else {
+			// The numeric display only has room for the one figure that tells you most about memory pressure
+			display->setTextAsNumber(stealsPerSecond);
+		}
+	}
+
+	static char* writeKilobytes(char* pos, uint32_t bytes) {
+		*(pos++) = ' ';
+		intToString(bytes >> 10, pos);
+		pos += strlen(pos);
+		*(pos++) = 'K';
+		*pos = 0;
+		return pos;
+	}
+
+	static void drawLine(char const* text, int32_t& yPixel) {
+		deluge::hid::display::OLED::drawString(text, kTextSpacingX, yPixel, deluge::hid::display::OLED::oledMainImage[0],
+		                                       OLED_MAIN_WIDTH_PIXELS, kTextSpacingX, kTextSpacingY);
+		yPixel += kTextSpacingY;
+	}
+};
+} // namespace deluge::gui::menu_item::firmware
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include "gui/menu_item/menu_item.h"
+#include "gui/ui/ui.h"
+#include "hid/display/display.h"
+#include "model/song/song.h"
+#include "storage/performance_report.h"
+#include <stdlib.h>
+#include <string.h>
+
+namespace deluge::gui::menu_item::firmware {
+
+/// Read-only page showing the current song's performance report, as last saved next to it on the card. Turning select
+/// scrolls through it.
+class PerformanceReport final : public MenuItem {
+public:
+	using MenuItem::MenuItem;
+
+	void beginSession(MenuItem* navigatedBackwardFrom) override {
+		numLines = 0;
+		scroll = 0;
+		if (::PerformanceReport::read(currentSong, text, sizeof(text))) {
+			// Split it into lines, in place
+			char* line = text;
+			while (*line && numLines < kMaxNumLines) {
+				lines[numLines++] = line;
+				char* end = strchr(line, '\n');
+				if (!end) {
+					break;
+				}
+				*end = 0;
+				line = end + 1;
+			}
+		}
+		refresh();
+	}
+
+	void selectEncoderAction(int32_t offset) override {
+		scroll = std::clamp<int32_t>(scroll + offset, 0, std::max<int32_t>(numLines - getNumLinesVisible(), 0));
+		refresh();
+	}
+
+	void drawPixelsForOled() override {
+		int32_t yPixel = OLED_MAIN_TOPMOST_PIXEL + ((OLED_MAIN_HEIGHT_PIXELS == 64) ? 15 : 14);
+
+		if (!numLines) {
+			drawLine("No report", yPixel);
+			return;
+		}
+		for (int32_t l = scroll; l < numLines && l < scroll + getNumLinesVisible(); l++) {
+			drawLine(lines[l], yPixel);
+		}
+	}
+
+private:
+	static constexpr int32_t kMaxNumLines = 16;
+
+	char text[kMaxPerformanceReportSize];
+	char* lines[kMaxNumLines];
+	int32_t numLines = 0;
+	int32_t scroll = 0;
+
+	static int32_t getNumLinesVisible() { return (OLED_MAIN_HEIGHT_PIXELS == 64) ? 5 : 3; }
+
+	void refresh() {
+		if (display->haveOLED()) {
+			renderUIsForOled();
+		}
+		else if (numLines) {
+			// The numeric display only has room for the one figure most worth knowing - the peak load, in percent
+			char const* peak = strstr(text, "load peak ");
+			display->setTextAsNumber(peak ? atoi(peak + 10) : 0);
+		}
+		else {
+			display->setText("NONE");
+		}
+	}
+
+	static void drawLine(char const* text, int32_t& yPixel) {
+		deluge::hid::display::OLED::drawString(text, kTextSpacingX, yPixel, deluge::hid::display::OLED::oledMainImage[0],
+		                                       OLED_MAIN_WIDTH_PIXELS, kTextSpacingX, kTextSpacingY);
+		yPixel += kTextSpacingY;
+	}
+};
+} // namespace deluge::gui::menu_item::firmware
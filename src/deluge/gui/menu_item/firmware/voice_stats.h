@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include "gui/menu_item/menu_item.h"
+#include "gui/ui/ui.h"
+#include "gui/ui_timer_manager.h"
+#include "hid/display/display.h"
+#include "processing/engines/audio_engine.h"
+#include "util/functions.h"
+#include <string.h>
+
+namespace deluge::gui::menu_item::firmware {
+
+/// Read-only page showing the AudioEngine's voice lifecycle counts - how many Voices have been culled, and how often
+/// the VoiceSample and TimeStretcher pools or the card have failed to keep up. Refreshes itself. Pressing select dumps
+/// all the counts to the debug output.
+class VoiceStats final : public MenuItem {
+public:
+	using MenuItem::MenuItem;
+
+	void beginSession(MenuItem* navigatedBackwardFrom) override {
+		refresh();
+		uiTimerManager.setTimer(TIMER_UI_SPECIFIC, kRefreshTimeMS);
+	}
+
+	ActionResult timerCallback() override {
+		refresh();
+		uiTimerManager.setTimer(TIMER_UI_SPECIFIC, kRefreshTimeMS);
+		return ActionResult::DEALT_WITH;
+	}
+
+	MenuItem* selectButtonPress() override {
+		AudioEngine::voiceStats.dump();
+		return (MenuItem*)0xFFFFFFFF; // Stay here
+	}
+
+	void drawPixelsForOled() override {
+		AudioEngine::VoiceStats const& stats = AudioEngine::voiceStats;
+
+		int32_t yPixel = OLED_MAIN_TOPMOST_PIXEL + ((OLED_MAIN_HEIGHT_PIXELS == 64) ? 15 : 14);
+		drawLine("voices", stats.numSolicited, "now", AudioEngine::getNumVoices(), yPixel);
+		drawLine("cull", stats.numHardCulls, "fast", stats.numFastReleaseCulls, yPixel);
+		drawLine("late", stats.numClusterUnderruns, "clip", stats.numAudioClipCulls, yPixel);
+
+		if (OLED_MAIN_HEIGHT_PIXELS == 64) {
+			// Overflows are only a problem when they fail, so show just those
+			drawLine("no vs", stats.numVoiceSampleFailures, "ts", stats.numTimeStretcherFailures, yPixel);
+			drawLine("max", stats.maxVoicesInUse, "pool", AudioEngine::getVoicePoolSize(), yPixel);
+		}
+	}
+
+private:
+	static constexpr int32_t kRefreshTimeMS = 1000;
+
+	void refresh() {
+		if (display->haveOLED()) {
+			renderUIsForOled();
+		}
+		else {
+			// The numeric display only has room for the one figure we most often want to know
+			display->setTextAsNumber(AudioEngine::voiceStats.getNumCulls());
+		}
+	}
+
+	// e.g. "cull 12 fast 40"
+	static void drawLine(char const* label, uint32_t number, char const* secondLabel, uint32_t secondNumber,
+	                     int32_t& yPixel) {
+		char buffer[32];
+		strcpy(buffer, label);
+		char* pos = buffer + strlen(buffer);
+		*(pos++) = ' ';
+		intToString(number, pos);
+		pos += strlen(pos);
+		*(pos++) = ' ';
+		strcpy(pos, secondLabel);
+		pos += strlen(pos);
+		*(pos++) = ' ';
+		intToString(secondNumber, pos);
+
+		deluge::hid::display::OLED::drawString(buffer, kTextSpacingX, yPixel, deluge::hid::display::OLED::oledMainImage[0],
+		                                       OLED_MAIN_WIDTH_PIXELS, kTextSpacingX, kTextSpacingY);
+		yPixel += kTextSpacingY;
+	}
+};
+} // namespace deluge::gui::menu_item::firmware
@@ -0,0 +1,81 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "freeze.h"
+#include "gui/l10n/l10n.h"
+#include "gui/ui/sound_editor.h"
+#include "gui/ui/ui.h"
+#include "hid/display/display.h"
+#include "model/clip/instrument_clip.h"
+#include "model/output.h"
+#include "model/song/song.h"
+#include "playback/playback_handler.h"
+#include "processing/engines/bounce_engine.h"
+
+namespace deluge::gui::menu_item {
+
+bool Freeze::isRelevant(Sound* sound, int32_t whichThing) {
+	Clip* clip = currentSong->currentClip;
+	return !soundEditor.editingKit() && clip && clip->type == CLIP_TYPE_INSTRUMENT
+	       && clip->output->type == InstrumentType::SYNTH && !clip->isArrangementOnlyClip();
+}
+
+void Freeze::beginSession(MenuItem* navigatedBackwardFrom) {
+	if (display->haveOLED()) {
+		renderUIsForOled();
+	}
+	else {
+		display->setText(l10n::get(l10n::String::STRING_FOR_FREEZE_CLIP));
+	}
+}
+
+MenuItem* Freeze::selectButtonPress() {
+	InstrumentClip* clip = (InstrumentClip*)currentSong->currentClip;
+
+	if (playbackHandler.isEitherClockActive()) {
+		display->displayPopup(l10n::get(l10n::String::STRING_FOR_STOP_PLAYBACK_FIRST));
+		return (MenuItem*)0xFFFFFFFF; // Stay here
+	}
+	if (!BounceEngine::canBounceClip(clip)) {
+		display->displayPopup(l10n::get(l10n::String::STRING_FOR_TURN_OFF_ARP_FIRST));
+		return (MenuItem*)0xFFFFFFFF;
+	}
+
+	display->displayLoadingAnimationText("Freezing");
+	int32_t error = BounceEngine::freezeClip(clip);
+	display->removeLoadingAnimation();
+	if (error) {
+		display->displayError(error);
+		return (MenuItem*)0xFFFFFFFF;
+	}
+
+	display->displayPopup(l10n::get(l10n::String::STRING_FOR_CLIP_FROZEN));
+	return nullptr;
+}
+
+void Freeze::drawPixelsForOled() {
+	int32_t yPixel = OLED_MAIN_TOPMOST_PIXEL + ((OLED_MAIN_HEIGHT_PIXELS == 64) ? 15 : 14);
+	deluge::hid::display::OLED::drawString("Press select", kTextSpacingX, yPixel,
+	                                       deluge::hid::display::OLED::oledMainImage[0], OLED_MAIN_WIDTH_PIXELS,
+	                                       kTextSpacingX, kTextSpacingY);
+	yPixel += kTextSpacingY;
+	deluge::hid::display::OLED::drawString("to freeze clip", kTextSpacingX, yPixel,
+	                                       deluge::hid::display::OLED::oledMainImage[0], OLED_MAIN_WIDTH_PIXELS,
+	                                       kTextSpacingX, kTextSpacingY);
+}
+
+} // namespace deluge::gui::menu_item
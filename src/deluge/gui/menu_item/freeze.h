@@ -0,0 +1,34 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "gui/menu_item/menu_item.h"
+
+namespace deluge::gui::menu_item {
+
+/// Renders the synth clip being edited to audio, offline, and swaps it for an AudioClip of that render, for when a
+/// song's got more voices going than the CPU can keep up with. See BounceEngine::freezeClip()
+class Freeze final : public MenuItem {
+public:
+	using MenuItem::MenuItem;
+	void beginSession(MenuItem* navigatedBackwardFrom) override;
+	MenuItem* selectButtonPress() override;
+	void drawPixelsForOled() override;
+	bool isRelevant(Sound* sound, int32_t whichThing) override;
+};
+} // namespace deluge::gui::menu_item
@@ -26,7 +26,10 @@ class Dampening final : public Integer {
 public:
 	using Integer::Integer;
 	void readCurrentValue() override { this->setValue(std::round(AudioEngine::reverb.getdamp() * 50)); }
-	void writeCurrentValue() override { AudioEngine::reverb.setdamp((float)this->getValue() / 50); }
+	void writeCurrentValue() override {
+		AudioEngine::reverb.setdamp((float)this->getValue() / 50);
+		AudioEngine::mustUpdateReverbParamsBeforeNextRender = true;
+	}
 	[[nodiscard]] int32_t getMaxValue() const override { return 50; }
 };
 } // namespace deluge::gui::menu_item::reverb
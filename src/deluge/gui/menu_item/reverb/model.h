@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include "definitions_cxx.hpp"
+#include "dsp/reverb/fdn/fdn.h"
+#include "gui/menu_item/selection.h"
+#include "processing/engines/audio_engine.h"
+
+namespace deluge::gui::menu_item::reverb {
+class Model final : public Selection {
+public:
+	using Selection::Selection;
+	void readCurrentValue() override { this->setValue<::ReverbModel>(AudioEngine::reverbModel); }
+	void writeCurrentValue() override {
+		auto newModel = this->getValue<::ReverbModel>();
+		if (newModel != AudioEngine::reverbModel) {
+			// Start it off from silence rather than whatever it was last left holding
+			AudioEngine::reverb.mute();
+			AudioEngine::fdnReverb.mute();
+			AudioEngine::reverbModel = newModel;
+		}
+	}
+	std::vector<std::string_view> getOptions() override { return {"FREEVERB", "FDN"}; }
+};
+} // namespace deluge::gui::menu_item::reverb
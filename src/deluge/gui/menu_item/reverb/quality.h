@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include "definitions_cxx.hpp"
+#include "dsp/reverb/fdn/fdn.h"
+#include "gui/menu_item/selection.h"
+#include "processing/engines/audio_engine.h"
+
+namespace deluge::gui::menu_item::reverb {
+class Quality final : public Selection {
+public:
+	using Selection::Selection;
+	void readCurrentValue() override { this->setValue<::ReverbQuality>(AudioEngine::fdnReverb.getQuality()); }
+	void writeCurrentValue() override { AudioEngine::fdnReverb.setQuality(this->getValue<::ReverbQuality>()); }
+	std::vector<std::string_view> getOptions() override {
+		using enum l10n::String;
+		return {l10n::getView(STRING_FOR_HIGH), l10n::getView(STRING_FOR_MEDIUM), l10n::getView(STRING_FOR_LOW)};
+	}
+	// Only the FDN reverb has a quality setting
+	bool isRelevant(Sound* sound, int32_t whichThing) override {
+		return AudioEngine::reverbModel == ::ReverbModel::FDN;
+	}
+};
+} // namespace deluge::gui::menu_item::reverb
@@ -26,7 +26,10 @@ class RoomSize final : public Integer {
 public:
 	using Integer::Integer;
 	void readCurrentValue() override { this->setValue(std::round(AudioEngine::reverb.getroomsize() * 50)); }
-	void writeCurrentValue() override { AudioEngine::reverb.setroomsize((float)this->getValue() / 50); }
+	void writeCurrentValue() override {
+		AudioEngine::reverb.setroomsize((float)this->getValue() / 50);
+		AudioEngine::mustUpdateReverbParamsBeforeNextRender = true;
+	}
 	[[nodiscard]] int32_t getMaxValue() const override { return 50; }
 };
 } // namespace deluge::gui::menu_item::reverb
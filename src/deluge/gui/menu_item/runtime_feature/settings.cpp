@@ -17,6 +17,7 @@
 
 #include "settings.h"
 #include "devSysexSetting.h"
+#include "engine_profile.h"
 #include "setting.h"
 #include "shift_is_sticky.h"
 
@@ -51,6 +52,22 @@ Setting menuHighlightIncomingNotes(RuntimeFeatureSettingType::HighlightIncomingN
 Setting menuDisplayNornsLayout(RuntimeFeatureSettingType::DisplayNornsLayout);
 ShiftIsSticky menuShiftIsSticky{};
 Setting menuLightShiftLed(RuntimeFeatureSettingType::LightShiftLed);
+Setting menuRenderBlockSize(RuntimeFeatureSettingType::RenderBlockSize);
+Setting menuLazySampleLoading(RuntimeFeatureSettingType::LazySampleLoading);
+Setting menuVectorFilters(RuntimeFeatureSettingType::VectorFilters);
+Setting menuMasterCompressorDetection(RuntimeFeatureSettingType::MasterCompressorDetection);
+Setting menuControlRate(RuntimeFeatureSettingType::ControlRate);
+Setting menuEcoPitchShift(RuntimeFeatureSettingType::EcoPitchShift);
+Setting menuLoadMeter(RuntimeFeatureSettingType::LoadMeter);
+Setting menuResumeLastSong(RuntimeFeatureSettingType::ResumeLastSong);
+Setting menuTranscodeSamples(RuntimeFeatureSettingType::TranscodeSamples);
+Setting menuDelayMemorySaver(RuntimeFeatureSettingType::DelayMemorySaver);
+Setting menuDirectMonitoring(RuntimeFeatureSettingType::DirectMonitoring);
+Setting menuCompressSamples(RuntimeFeatureSettingType::CompressSamples);
+Setting menuPerformanceReports(RuntimeFeatureSettingType::PerformanceReports);
+Setting menuTrackCpuOverlay(RuntimeFeatureSettingType::TrackCpuOverlay);
+Setting menuRepeatableProbability(RuntimeFeatureSettingType::RepeatableProbability);
+EngineProfile menuEngineProfile{};
 
 Submenu subMenuAutomation{
     l10n::String::STRING_FOR_COMMUNITY_FEATURE_AUTOMATION,
@@ -67,6 +84,10 @@ std::array<MenuItem*, RuntimeFeatureSettingType::MaxElement - kNonTopLevelSettin
     &menuPatchCableResolution,   &menuCatchNotes,         &menuDeleteUnusedKitRows, &menuAltGoldenKnobDelayParams,
     &menuQuantizedStutterRate,   &subMenuAutomation,      &menuDevSysexAllowed,     &menuSyncScalingAction,
     &menuHighlightIncomingNotes, &menuDisplayNornsLayout, &menuShiftIsSticky,       &menuLightShiftLed,
+    &menuRenderBlockSize,        &menuLazySampleLoading,  &menuVectorFilters,       &menuMasterCompressorDetection,
+    &menuControlRate,            &menuEcoPitchShift,      &menuLoadMeter,           &menuResumeLastSong,
+    &menuTranscodeSamples,       &menuDelayMemorySaver,   &menuDirectMonitoring,    &menuCompressSamples,
+    &menuPerformanceReports,     &menuTrackCpuOverlay,    &menuRepeatableProbability, &menuEngineProfile,
 };
 
 Settings::Settings(l10n::String name, l10n::String title) : menu_item::Submenu(name, title, subMenuEntries) {
@@ -0,0 +1,43 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "gui/menu_item/selection.h"
+#include "hid/display/display.h"
+#include "model/settings/runtime_feature_settings.h"
+#include "model/song/song.h"
+
+namespace deluge::gui::menu_item::song {
+
+// The engine profile this song asks for. Default goes with the one set in community features
+class EngineProfile final : public Selection {
+public:
+	using Selection::Selection;
+	void readCurrentValue() override { this->setValue(currentSong->engineProfile); }
+	void writeCurrentValue() override {
+		currentSong->engineProfile = this->getValue();
+		runtimeFeatureSettings.setSongEngineProfile(
+		    static_cast<RuntimeFeatureStateEngineProfile>(currentSong->engineProfile));
+	}
+	std::vector<std::string_view> getOptions() override {
+		if (display->haveOLED()) {
+			return {"Default", "Studio", "Live", "Max polyphony"};
+		}
+		return {"DEFA", "STUD", "LIVE", "POLY"};
+	}
+};
+} // namespace deluge::gui::menu_item::song
@@ -33,6 +33,7 @@
 #include "processing/engines/audio_engine.h"
 #include "storage/audio/audio_file_manager.h"
 #include "storage/file_item.h"
+#include "storage/folder_index.h"
 #include "storage/storage_manager.h"
 #include "util/functions.h"
 #include <cstring>
@@ -237,9 +238,16 @@ int32_t Browser::readFileItemsForFolder(char const* filePrefixHere, bool allowFo
 		return error;
 	}
 
-	FRESULT result = f_opendir(&staticDIR, currentDir.get());
-	if (result) {
-		return fresultToDelugeErrorCode(result);
+	// A big folder may have an index on the card, saving us from scanning it
+	bool usingIndex = folderIndex.openForReading(currentDir.get());
+	if (!usingIndex) {
+scanFolder:
+		FRESULT result = f_opendir(&staticDIR, currentDir.get());
+		if (result) {
+			return fresultToDelugeErrorCode(result);
+		}
+		// Having a prefix means it's a folder of numbered songs or presets
+		folderIndex.beginWriting(currentDir.get(), filePrefixHere != NULL);
 	}
 
 	/*
@@ -258,111 +266,303 @@ int32_t Browser::readFileItemsForFolder(char const* filePrefixHere, bool allowFo
 	maxNumFileItemsNow = newMaxNumFileItems;
 	filenameToStartSearchAt = filenameToStartAt;
 
-	int32_t filePrefixLength;
-
-	if (display->have7SEG()) {
-		if (filePrefixHere) {
-			filePrefixLength = strlen(filePrefixHere);
+	// If the index is sorted the same way we sort, we only need read the stretch of it we're going to show
+	if (usingIndex && (display->haveOLED() || !filePrefixHere)) {
+		bool sorted = folderIndex.isSortedFor(shouldInterpretNoteNamesForThisBrowser);
+		if (sorted) {
+			error = readFileItemsFromSortedIndex(filePrefixHere, allowFolders, allowedFileExtensionsHere);
+		}
+		if (folderIndex.readFailed) {
+			emptyFileItems();
+			usingIndex = false;
+			goto scanFolder;
+		}
+		if (sorted) {
+			folderIndex.finishReading();
+			if (error) {
+				emptyFileItems();
+			}
+			return error;
 		}
 	}
 
+	bool reachedEnd = false;
+
 	while (true) {
 		AudioEngine::logAction("while loop");
 
 		audioFileManager.loadAnyEnqueuedClusters();
 		FilePointer thisFilePointer;
-
-		result = f_readdir_get_filepointer(&staticDIR, &staticFNO, &thisFilePointer); /* Read a directory item */
-
-		if (result != FR_OK || staticFNO.fname[0] == 0) {
-			break; /* Break on error or end of dir */
-		}
-		if (staticFNO.fname[0] == '.') {
-			continue; /* Ignore dot entry */
-		}
-		bool isFolder = staticFNO.fattrib & AM_DIR;
-		if (isFolder) {
-			if (!allowFolders) {
-				continue;
+		char const* thisName;
+		bool isFolder;
+
+		if (usingIndex) {
+			thisName = folderIndex.readEntry(&isFolder, &thisFilePointer);
+			if (!thisName) {
+				// If the index turned out to be broken, forget what it gave us and scan the folder after all
+				if (folderIndex.readFailed) {
+					emptyFileItems();
+					usingIndex = false;
+					goto scanFolder;
+				}
+				break;
 			}
 		}
 		else {
-			char const* dotPos = strrchr(staticFNO.fname, '.');
-			if (!dotPos) {
-extensionNotSupported:
-				continue;
+			FRESULT result =
+			    f_readdir_get_filepointer(&staticDIR, &staticFNO, &thisFilePointer); /* Read a directory item */
+
+			if (result != FR_OK || staticFNO.fname[0] == 0) {
+				reachedEnd = (result == FR_OK);
+				break; /* Break on error or end of dir */
 			}
-			char const* fileExtension = dotPos + 1;
-			char const** thisExtension = allowedFileExtensionsHere;
-			while (strcasecmp(fileExtension, *thisExtension)) {
-				thisExtension++;
-				if (!*thisExtension) {
-					goto extensionNotSupported; // If reached end of list
-				}
+			if (staticFNO.fname[0] == '.') {
+				continue; /* Ignore dot entry */
 			}
+			thisName = staticFNO.fname;
+			isFolder = staticFNO.fattrib & AM_DIR;
+
+			// The index gets everything, whatever this particular Browser is interested in
+			folderIndex.writeEntry(thisName, isFolder, &thisFilePointer);
 		}
 
-		FileItem* thisItem = getNewFileItem();
-		if (!thisItem) {
-			error = ERROR_INSUFFICIENT_RAM;
-			break;
+		if (!isFileWanted(thisName, isFolder, allowFolders, allowedFileExtensionsHere)) {
+			continue;
 		}
-		error = thisItem->filename.set(staticFNO.fname);
+
+		error = addFileItem(thisName, isFolder, &thisFilePointer, filePrefixHere);
 		if (error) {
 			break;
 		}
-		thisItem->isFolder = isFolder;
-		thisItem->filePointer = thisFilePointer;
+	}
 
-		char const* storedFilenameChars = thisItem->filename.get();
-		if (display->have7SEG()) {
-			if (filePrefixHere) {
-				if (memcasecmp(storedFilenameChars, filePrefixHere, filePrefixLength)) {
-					goto nonNumericFile;
-				}
+	if (usingIndex) {
+		folderIndex.finishReading();
+	}
+	else {
+		f_closedir(&staticDIR);
+		// That sorts the index, which needs to be the way we'll be looking things up in it
+		shouldInterpretNoteNames = shouldInterpretNoteNamesForThisBrowser;
+		octaveStartsFromA = false;
+		folderIndex.finishWriting(reachedEnd && !error);
+	}
 
-				char* dotAddress = strrchr(storedFilenameChars, '.');
-				if (!dotAddress) {
-					goto nonNumericFile; // Shouldn't happen?
-				}
+	if (error) {
+		emptyFileItems();
+	}
 
-				int32_t dotPos = (uint32_t)dotAddress - (uint32_t)storedFilenameChars;
-				if (dotPos < filePrefixLength + 3) {
-					goto nonNumericFile;
-				}
+	return error;
+}
 
-				char const* numbersStartAddress = &storedFilenameChars[filePrefixLength];
+bool Browser::isFileWanted(char const* name, bool isFolder, bool allowFolders, char const** allowedFileExtensionsHere) {
+	if (isFolder) {
+		return allowFolders;
+	}
 
-				if (!memIsNumericChars(numbersStartAddress, 3)) {
-					goto nonNumericFile;
-				}
+	char const* dotPos = strrchr(name, '.');
+	if (!dotPos) {
+		return false;
+	}
+	char const* fileExtension = dotPos + 1;
+	for (char const** thisExtension = allowedFileExtensionsHere; *thisExtension; thisExtension++) {
+		if (!strcasecmp(fileExtension, *thisExtension)) {
+			return true;
+		}
+	}
+	return false;
+}
 
-				thisItem->displayName = numbersStartAddress;
+int32_t Browser::addFileItem(char const* name, bool isFolder, FilePointer* filePointer, char const* filePrefixHere) {
+	FileItem* thisItem = getNewFileItem();
+	if (!thisItem) {
+		return ERROR_INSUFFICIENT_RAM;
+	}
+	int32_t error = thisItem->filename.set(name);
+	if (error) {
+		return error;
+	}
+	thisItem->isFolder = isFolder;
+	thisItem->filePointer = *filePointer;
 
+	char const* storedFilenameChars = thisItem->filename.get();
+	if (display->have7SEG()) {
+		if (filePrefixHere) {
+			int32_t filePrefixLength = strlen(filePrefixHere);
+			if (memcasecmp(storedFilenameChars, filePrefixHere, filePrefixLength)) {
+				goto nonNumericFile;
+			}
+
+			char const* dotAddress = strrchr(storedFilenameChars, '.');
+			if (!dotAddress) {
+				goto nonNumericFile; // Shouldn't happen?
+			}
+
+			int32_t dotPos = (uint32_t)dotAddress - (uint32_t)storedFilenameChars;
+			if (dotPos < filePrefixLength + 3) {
+				goto nonNumericFile;
+			}
+
+			char const* numbersStartAddress = &storedFilenameChars[filePrefixLength];
+
+			if (!memIsNumericChars(numbersStartAddress, 3)) {
+				goto nonNumericFile;
+			}
+
+			thisItem->displayName = numbersStartAddress;
+
+			if (*thisItem->displayName == '0') {
+				thisItem->displayName++;
 				if (*thisItem->displayName == '0') {
 					thisItem->displayName++;
-					if (*thisItem->displayName == '0') {
-						thisItem->displayName++;
-					}
 				}
 			}
-			else {
-				goto nonNumericFile;
-			}
 		}
 		else {
+			goto nonNumericFile;
+		}
+	}
+	else {
 nonNumericFile:
-			thisItem->displayName = storedFilenameChars;
+		thisItem->displayName = storedFilenameChars;
+	}
+
+	return NO_ERROR;
+}
+
+// With an index sorted the way we sort, the FileItems we're after all come from one stretch of it, around where
+// filenameToStartSearchAt would be. So we read just that, and note whether there are more wanted entries either side
+// of it, just as if they'd been culled. That way, moving through a huge folder only ever reads a window's worth of it.
+// If the index turns out to be broken, folderIndex.readFailed gets set.
+int32_t Browser::readFileItemsFromSortedIndex(char const* filePrefixHere, bool allowFolders,
+                                              char const** allowedFileExtensionsHere) {
+	shouldInterpretNoteNames = shouldInterpretNoteNamesForThisBrowser;
+	octaveStartsFromA = false;
+
+	int32_t numEntries = folderIndex.getNumEntries();
+	int32_t searchPos;
+	if (filenameToStartSearchAt && *filenameToStartSearchAt) {
+		searchPos = folderIndex.findEntry(filenameToStartSearchAt);
+		if (searchPos < 0) {
+			return NO_ERROR;
 		}
 	}
+	else {
+		searchPos = (catalogSearchDirection == CATALOG_SEARCH_LEFT) ? numEntries : 0;
+	}
 
-	f_closedir(&staticDIR);
+	// How many FileItems we want from before searchPos, and from it onwards. One short of the maximum altogether, so
+	// nothing gets culled unless we've had to read further back than we wanted
+	int32_t numWantedBefore;
+	if (catalogSearchDirection == CATALOG_SEARCH_RIGHT) {
+		numWantedBefore = 0;
+	}
+	else if (catalogSearchDirection == CATALOG_SEARCH_LEFT) {
+		numWantedBefore = maxNumFileItemsNow - 1;
+	}
+	else {
+		numWantedBefore = maxNumFileItemsNow >> 1;
+	}
+	int32_t numWantedAfter = maxNumFileItemsNow - 1 - numWantedBefore;
 
-	if (error) {
+	// We can't read backwards, so start a bit before searchPos, and go further back if that didn't find enough
+	int32_t lookBehind = maxNumFileItemsNow << 1;
+	int32_t windowStart;
+	int32_t numFoundAfter;
+	bool anyMoreAfter;
+
+	while (true) {
+		windowStart = numWantedBefore ? std::max<int32_t>(searchPos - lookBehind, 0) : searchPos;
+		if (!folderIndex.seekToEntry(windowStart)) {
+			return NO_ERROR;
+		}
+
+		int32_t numFoundBefore = 0;
+		numFoundAfter = 0;
+		anyMoreAfter = false;
+
+		while (true) {
+			audioFileManager.loadAnyEnqueuedClusters();
+
+			bool beforeSearchPos = folderIndex.getNextEntryIndex() < searchPos;
+			if (!beforeSearchPos && !numWantedAfter) {
+				break;
+			}
+
+			bool isFolder;
+			FilePointer thisFilePointer;
+			char const* thisName = folderIndex.readEntry(&isFolder, &thisFilePointer);
+			if (!thisName) {
+				if (folderIndex.readFailed) {
+					return NO_ERROR;
+				}
+				break;
+			}
+
+			if (!isFileWanted(thisName, isFolder, allowFolders, allowedFileExtensionsHere)) {
+				continue;
+			}
+
+			// Got all we wanted after searchPos? Then this one just tells us there's more
+			if (!beforeSearchPos && numFoundAfter == numWantedAfter) {
+				anyMoreAfter = true;
+				break;
+			}
+
+			int32_t error = addFileItem(thisName, isFolder, &thisFilePointer, filePrefixHere);
+			if (error) {
+				return error;
+			}
+			if (beforeSearchPos) {
+				numFoundBefore++;
+			}
+			else {
+				numFoundAfter++;
+			}
+		}
+
+		if (numFoundBefore >= (numWantedBefore >> 1) || !windowStart) {
+			break;
+		}
 		emptyFileItems();
+		numFileItemsDeletedAtStart = 0;
+		numFileItemsDeletedAtEnd = 0;
+		firstFileItemRemaining = NULL;
+		lastFileItemRemaining = NULL;
+		lookBehind <<= 2;
 	}
 
-	return error;
+	if (anyMoreAfter) {
+		numFileItemsDeletedAtEnd = 1;
+		if (fileItems.getNumElements()) {
+			lastFileItemRemaining =
+			    ((FileItem*)fileItems.getElementAddress(fileItems.getNumElements() - 1))->displayName;
+		}
+	}
+
+	// Only say there's more before windowStart if there really is - otherwise going back would find nothing new
+	if (windowStart && !numFileItemsDeletedAtStart) {
+		if (!folderIndex.seekToEntry(0)) {
+			return NO_ERROR;
+		}
+		while (folderIndex.getNextEntryIndex() < windowStart) {
+			audioFileManager.loadAnyEnqueuedClusters();
+			bool isFolder;
+			FilePointer thisFilePointer;
+			char const* thisName = folderIndex.readEntry(&isFolder, &thisFilePointer);
+			if (!thisName) {
+				return NO_ERROR;
+			}
+			if (isFileWanted(thisName, isFolder, allowFolders, allowedFileExtensionsHere)) {
+				numFileItemsDeletedAtStart = 1;
+				if (fileItems.getNumElements()) {
+					firstFileItemRemaining = ((FileItem*)fileItems.getElementAddress(0))->displayName;
+				}
+				break;
+			}
+		}
+	}
+
+	return NO_ERROR;
 }
 
 void Browser::deleteFolderAndDuplicateItems(Availability instrumentAvailabilityRequirement) {
@@ -1656,6 +1856,7 @@ int32_t Browser::createFolder() {
 	if (result) {
 		return ERROR_SD_CARD;
 	}
+	FolderIndex::folderChanged(newDirPath.get());
 
 	error = goIntoFolder(enteredText.get());
 
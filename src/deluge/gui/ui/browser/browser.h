@@ -67,7 +67,7 @@ class Browser : public QwertyUI {
 public:
 	Browser();
 
-	void close();
+	virtual void close();
 	virtual int32_t getCurrentFilePath(String* path) = 0;
 	ActionResult buttonAction(deluge::hid::Button b, bool on, bool inCardRoutine);
 	void currentFileDeleted();
@@ -118,6 +118,11 @@ protected:
 	                                         bool allowFoldersint,
 	                                         Availability availabilityRequirement = Availability::ANY,
 	                                         int32_t newCatalogSearchDirection = CATALOG_SEARCH_RIGHT);
+	static bool isFileWanted(char const* name, bool isFolder, bool allowFolders,
+	                         char const** allowedFileExtensionsHere);
+	int32_t addFileItem(char const* name, bool isFolder, FilePointer* filePointer, char const* filePrefixHere);
+	int32_t readFileItemsFromSortedIndex(char const* filePrefixHere, bool allowFolders,
+	                                     char const** allowedFileExtensionsHere);
 
 	static int32_t
 	    fileIndexSelected; // If -1, we have not selected any real file/folder. Maybe there are no files, or maybe we're typing a new name.
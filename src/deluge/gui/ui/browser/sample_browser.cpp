@@ -53,6 +53,8 @@
 #include "model/instrument/instrument.h"
 #include "model/model_stack.h"
 #include "model/note/note_row.h"
+#include "model/sample/sample.h"
+#include "model/sample/sample_cluster.h"
 #include "model/song/song.h"
 #include "modulation/automation/auto_param.h"
 #include "modulation/params/param_manager.h"
@@ -81,6 +83,9 @@ extern "C" {
 using namespace deluge;
 using namespace gui;
 
+// How long the cursor has to stay on a file before the ones either side of it get loaded
+constexpr int32_t kNeighbourPreloadDelayMS = 150;
+
 SampleBrowser sampleBrowser{};
 
 char const* allowedFileExtensionsAudio[] = {"WAV", "AIFF", "AIF", NULL};
@@ -228,6 +233,9 @@ void SampleBrowser::folderContentsReady(int32_t entryDirection) {
 	}
 
 	previewIfPossible(entryDirection);
+
+	releaseNeighbours();
+	uiTimerManager.schedule(&neighbourPreloadTimer, kNeighbourPreloadDelayMS);
 }
 
 void SampleBrowser::currentFileChanged(int32_t movementDirection) {
@@ -246,6 +254,81 @@ void SampleBrowser::currentFileChanged(int32_t movementDirection) {
 	AudioEngine::stopAnyPreviewing();
 
 	previewIfPossible(movementDirection);
+
+	// If we've just moved on to one of the neighbours, the preview now has it, so it's fine to let go of them all. Any
+	// that haven't finished loading their Cluster yet get taken back out of the queue
+	releaseNeighbours();
+	uiTimerManager.schedule(&neighbourPreloadTimer, kNeighbourPreloadDelayMS);
+}
+
+void SampleBrowser::close() {
+	uiTimerManager.unschedule(&neighbourPreloadTimer);
+	releaseNeighbours();
+	Browser::close();
+}
+
+void SampleBrowser::neighbourPreloadTimerCallback(TimingWheelEntry* entry) {
+	// This can come from within the card routine, which is no time to go reading other files
+	if (sdRoutineLock) {
+		uiTimerManager.schedule(entry, kNeighbourPreloadDelayMS);
+		return;
+	}
+	if (getCurrentUI() != &sampleBrowser) {
+		return;
+	}
+	sampleBrowser.preloadNeighbours();
+}
+
+void SampleBrowser::preloadNeighbours() {
+	for (int32_t n = 0; n < 2; n++) {
+		if (preloadedSamples[n]) {
+			continue;
+		}
+
+		int32_t i = fileIndexSelected + (n ? 1 : -1);
+		if (fileIndexSelected < 0 || i < 0 || i >= fileItems.getNumElements()) {
+			continue;
+		}
+		FileItem* fileItem = (FileItem*)fileItems.getElementAddress(i);
+		if (fileItem->isFolder) {
+			continue;
+		}
+
+		String filePath;
+		if (getFilePath(fileItem, &filePath)) {
+			continue;
+		}
+
+		uint8_t error;
+		Sample* sample = (Sample*)audioFileManager.getAudioFileFromFilename(&filePath, true, &error,
+		                                                                    &fileItem->filePointer, AudioFileType::SAMPLE);
+		if (!sample) {
+			continue;
+		}
+
+		sample->addReason();
+		preloadedSamples[n] = sample;
+
+		int32_t clusterIndex = sample->getFirstClusterIndexWithAudioData();
+		if (clusterIndex < sample->getFirstClusterIndexWithNoAudioData()) {
+			// Lowest priority, so it never holds up anything actually sounding
+			preloadedClusters[n] =
+			    sample->clusters.getElement(clusterIndex)->getCluster(sample, clusterIndex, CLUSTER_ENQUEUE, 0xFFFFFFFF);
+		}
+	}
+}
+
+void SampleBrowser::releaseNeighbours() {
+	for (int32_t n = 0; n < 2; n++) {
+		if (preloadedClusters[n]) {
+			audioFileManager.removeReasonFromCluster(preloadedClusters[n], "E472");
+			preloadedClusters[n] = nullptr;
+		}
+		if (preloadedSamples[n]) {
+			preloadedSamples[n]->removeReason("E473");
+			preloadedSamples[n] = nullptr;
+		}
+	}
 }
 
 void SampleBrowser::exitAndNeverDeleteDrum() {
@@ -486,6 +569,10 @@ bool SampleBrowser::canImportWholeKit() {
 }
 
 int32_t SampleBrowser::getCurrentFilePath(String* path) {
+	return getFilePath(getCurrentFileItem(), path);
+}
+
+int32_t SampleBrowser::getFilePath(FileItem* fileItem, String* path) {
 	int32_t error;
 
 	path->set(&currentDir);
@@ -499,9 +586,7 @@ gotError:
 		}
 	}
 
-	FileItem* currentFileItem = getCurrentFileItem();
-
-	error = path->concatenate(&currentFileItem->filename);
+	error = path->concatenate(&fileItem->filename);
 	if (error) {
 		goto gotError;
 	}
@@ -1273,9 +1358,11 @@ removeReasonsFromSamplesAndGetOut:
 
 		filePath.concatenateAtPos(staticFNO.fname, dirWithSlashLength);
 
+		// Each file in the folder gets its own Sample, even if it's the same as one loaded from somewhere else - the
+		// Samples we get back are what get gathered up below, and their paths are what the new kit rows will use
 		Sample* newSample = (Sample*)audioFileManager.getAudioFileFromFilename(
-		    &filePath, true, &error, &thisFilePointer,
-		    AudioFileType::SAMPLE); // We really want to be able to pass a file pointer in here
+		    &filePath, true, &error, &thisFilePointer, AudioFileType::SAMPLE, false,
+		    false); // We really want to be able to pass a file pointer in here
 		if (error || !newSample) {
 			f_closedir(&staticDIR);
 			goto removeReasonsFromSamplesAndGetOut;
@@ -20,6 +20,7 @@
 #include "definitions_cxx.hpp"
 #include "gui/ui/browser/browser.h"
 #include "hid/button.h"
+#include "util/container/timing_wheel.h"
 
 extern "C" {
 
@@ -34,10 +35,13 @@ class SoundDrum;
 class NumericLayerScrollingText;
 class Source;
 class Sample;
+class Cluster;
+class FileItem;
 
 class SampleBrowser final : public Browser {
 public:
 	SampleBrowser();
+	void close() override;
 	bool getGreyoutRowsAndCols(uint32_t* cols, uint32_t* rows);
 	bool opened();
 	void focusRegained();
@@ -75,12 +79,23 @@ private:
 	bool loadAllSamplesInFolder(bool detectPitch, int32_t* getNumSamples, Sample*** getSortArea,
 	                            bool* getDoingSingleCycle = NULL, int32_t* getNumCharsInPrefix = NULL);
 	int32_t getCurrentFilePath(String* path);
+	int32_t getFilePath(FileItem* fileItem, String* path);
 	void drawKeysOverWaveform();
 	void autoDetectSideChainSending(SoundDrum* drum, Source* source, char const* fileName);
 	void possiblySetUpBlinking();
+	void preloadNeighbours();
+	void releaseNeighbours();
+	static void neighbourPreloadTimerCallback(TimingWheelEntry* entry);
 
 	bool currentlyShowingSamplePreview;
 
+	// The files either side of the one being previewed, each held loaded along with its first Cluster of audio, so
+	// moving on to one can sound it straight away. They only get loaded once the cursor has sat still for a moment -
+	// scrolling fast through a folder shouldn't mean reading every file in it
+	Sample* preloadedSamples[2] = {nullptr, nullptr};
+	Cluster* preloadedClusters[2] = {nullptr, nullptr};
+	TimingWheelEntry neighbourPreloadTimer{neighbourPreloadTimerCallback};
+
 	bool qwertyCurrentlyDrawnOnscreen; // This will linger as true even when qwertyVisible has been set to false
 };
 
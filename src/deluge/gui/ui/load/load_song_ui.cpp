@@ -33,6 +33,7 @@
 #include "memory/general_memory_allocator.h"
 #include "model/action/action_logger.h"
 #include "model/clip/instrument_clip_minder.h"
+#include "model/settings/runtime_feature_settings.h"
 #include "model/song/song.h"
 #include "modulation/params/param_manager.h"
 #include "playback/mode/arrangement.h"
@@ -56,6 +57,9 @@ void routineForSD(void);
 }
 extern void setupBlankSong();
 
+// While the next song waits to be swapped in, the rest of its samples only get loaded if they'll fit in this much
+constexpr uint32_t kSongPreloadRAMBudget = 8 * 1024 * 1024;
+
 LoadSongUI::LoadSongUI() {
 	qwertyAlwaysVisible = false;
 	filePrefix = "SONG";
@@ -236,16 +240,30 @@ void LoadSongUI::performLoad() {
 		return;
 	}
 
+	String currentFilenameWithoutExtension;
+	int32_t error = currentFileItem->getFilenameWithoutExtension(&currentFilenameWithoutExtension);
+	if (error) {
+		display->displayError(error);
+		return;
+	}
+
+	performLoadFromFile(&currentFileItem->filePointer, &currentFilenameWithoutExtension);
+}
+
+// The song's name and folder come from enteredText and currentDir, which must already be set. Returns whether the song
+// got loaded - if not, the error's been shown, and either the old song's still there, or there's a blank one
+bool LoadSongUI::performLoadFromFile(FilePointer* filePointer, String* filenameWithoutExtension) {
+
 	actionLogger.deleteAllLogs();
 
 	if (arrangement.hasPlaybackActive()) {
 		playbackHandler.switchToSession();
 	}
 
-	int32_t error = storageManager.openXMLFile(&currentFileItem->filePointer, "song");
+	int32_t error = storageManager.openXMLFile(filePointer, "song");
 	if (error) {
 		display->displayError(error);
-		return;
+		return false;
 	}
 
 	currentUIMode = UI_MODE_LOADING_SONG_ESSENTIAL_SAMPLES;
@@ -293,7 +311,7 @@ fail:
 		}
 		currentUIMode = UI_MODE_NONE;
 		display->removeWorkingAnimation();
-		return;
+		return false;
 	}
 
 	preLoadedSong = new (songMemory) Song();
@@ -313,7 +331,11 @@ gotErrorAfterCreatingSong:
 
 	// Will return false if we ran out of RAM. This isn't currently detected for while loading ParamNodes, but chances are, after failing on one of those, it'd try to
 	// load something else and that would fail.
-	error = preLoadedSong->readFromFile();
+	{
+		// Temporaries made while reading all go in one arena, which goes away in one go - even if the load fails
+		ArenaScope arenaScope(loadArena, kLoadArenaSize);
+		error = preLoadedSong->readFromFile();
+	}
 	if (error) {
 		goto gotErrorAfterCreatingSong;
 	}
@@ -328,14 +350,8 @@ gotErrorAfterCreatingSong:
 
 	preLoadedSong->dirPath.set(&currentDir);
 
-	String currentFilenameWithoutExtension;
-	error = currentFileItem->getFilenameWithoutExtension(&currentFilenameWithoutExtension);
-	if (error) {
-		goto gotErrorAfterCreatingSong;
-	}
-
 	error = audioFileManager.setupAlternateAudioFileDir(&audioFileManager.alternateAudioFileLoadPath, currentDir.get(),
-	                                                    &currentFilenameWithoutExtension);
+	                                                    filenameWithoutExtension);
 	if (error) {
 		goto gotErrorAfterCreatingSong;
 	}
@@ -345,8 +361,10 @@ gotErrorAfterCreatingSong:
 	// Do this before loading any new Samples from file, in case we were in danger of discarding any from RAM that we might actually want
 	preLoadedSong->loadAllSamples(false);
 
-	// Load samples from files, just for currently playing Sounds (or if not playing, then all Sounds)
-	if (playbackHandler.isEitherClockActive()) {
+	// Load samples from files, just for currently playing Sounds (or if not playing, then all Sounds - unless lazy,
+	// in which case just those which will play on launch, and the rest get taken care of after the swap, below)
+	if (playbackHandler.isEitherClockActive()
+	    || runtimeFeatureSettings.get(RuntimeFeatureSettingType::LazySampleLoading) == RuntimeFeatureStateToggle::On) {
 		preLoadedSong->loadCrucialSamplesOnly();
 	}
 	else {
@@ -398,9 +416,15 @@ gotErrorAfterCreatingSong:
 		}
 
 		// We're now waiting, either for the user to arm, or for the arming to launch the song-swap. Get loading all the rest of the samples which weren't needed right away.
-		// (though we might run out of RAM cos we haven't discarded all the old samples yet)
+		// But only if there's RAM to spare - otherwise they'd push the still-playing song's own sample data out, and it'd be the one to stutter before the swap.
+		// Anything skipped here gets loaded after the swap, below, once the old song's gone
 		AudioEngine::logAction("g");
-		preLoadedSong->loadAllSamples(true);
+		if (audioFileManager.getRAMSpareFromCurrentSong() >= kSongPreloadRAMBudget) {
+			preLoadedSong->loadAllSamples(true);
+		}
+		else {
+			Debug::println("not enough spare RAM to preload the rest of the next song");
+		}
 		AudioEngine::logAction("h");
 
 		// If any more waiting required before the song swap actually happens, do that
@@ -432,7 +456,8 @@ swapDone:
 
 	audioFileManager.deleteAnyTempRecordedSamplesFromMemory();
 
-	// Try one more time to load all AudioFiles - there might be more RAM free now
+	// Try one more time to load all AudioFiles - there might be more RAM free now. If loading lazily, this is where
+	// everything not needed at launch gets found - its Clusters are only enqueued, and load in the background
 	currentSong->loadAllSamples();
 	AudioEngine::logAction("l");
 	currentSong->markAllInstrumentsAsEdited();
@@ -444,6 +469,7 @@ swapDone:
 	currentUIMode = UI_MODE_NONE;
 
 	display->removeWorkingAnimation();
+	return true;
 }
 
 ActionResult LoadSongUI::timerCallback() {
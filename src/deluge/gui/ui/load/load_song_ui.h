@@ -32,6 +32,7 @@ public:
 	bool opened();
 	void selectEncoderAction(int8_t offset);
 	void performLoad();
+	bool performLoadFromFile(FilePointer* filePointer, String* filenameWithoutExtension);
 	void displayLoopsRemainingPopup();
 
 	bool deletedPartsOfOldSong;
@@ -44,8 +44,14 @@
 #include "gui/menu_item/filter/lpf_freq.h"
 #include "gui/menu_item/filter/lpf_mode.h"
 #include "gui/menu_item/filter_route.h"
+#include "gui/menu_item/firmware/card_benchmark.h"
+#include "gui/menu_item/firmware/cpu_profile.h"
+#include "gui/menu_item/firmware/memory_telemetry.h"
+#include "gui/menu_item/firmware/performance_report.h"
 #include "gui/menu_item/firmware/version.h"
+#include "gui/menu_item/firmware/voice_stats.h"
 #include "gui/menu_item/flash/status.h"
+#include "gui/menu_item/freeze.h"
 #include "gui/menu_item/fx/clipping.h"
 #include "gui/menu_item/gate/mode.h"
 #include "gui/menu_item/gate/off_time.h"
@@ -113,7 +119,9 @@
 #include "gui/menu_item/reverb/compressor/shape.h"
 #include "gui/menu_item/reverb/compressor/volume.h"
 #include "gui/menu_item/reverb/dampening.h"
+#include "gui/menu_item/reverb/model.h"
 #include "gui/menu_item/reverb/pan.h"
+#include "gui/menu_item/reverb/quality.h"
 #include "gui/menu_item/reverb/room_size.h"
 #include "gui/menu_item/reverb/width.h"
 #include "gui/menu_item/runtime_feature/setting.h"
@@ -148,6 +156,7 @@
 #include "gui/menu_item/submenu/filter.h"
 #include "gui/menu_item/submenu/modulator.h"
 #include "gui/menu_item/submenu_referring_to_one_thing.h"
+#include "gui/menu_item/song/engine_profile.h"
 #include "gui/menu_item/swing/interval.h"
 #include "gui/menu_item/sync_level.h"
 #include "gui/menu_item/sync_level/relative_to_song.h"
@@ -164,6 +173,7 @@
 #include "gui/menu_item/unpatched_param/pan.h"
 #include "gui/menu_item/unpatched_param/updating_reverb_params.h"
 #include "gui/menu_item/value.h"
+#include "gui/menu_item/voice/paraphonic.h"
 #include "gui/menu_item/voice/polyphony.h"
 #include "gui/menu_item/voice/priority.h"
 #include "processing/sound/sound.h"
@@ -311,8 +321,10 @@ submenu::Arpeggiator arpMenu{
 voice::Polyphony polyphonyMenu{STRING_FOR_POLYPHONY};
 UnpatchedParam portaMenu{STRING_FOR_PORTAMENTO, ::Param::Unpatched::Sound::PORTAMENTO};
 voice::Priority priorityMenu{STRING_FOR_PRIORITY};
+voice::Paraphonic paraphonicMenu{STRING_FOR_PARAPHONIC};
 
-Submenu voiceMenu{STRING_FOR_VOICE, {&polyphonyMenu, &unisonMenu, &portaMenu, &arpMenu, &priorityMenu}};
+Submenu voiceMenu{STRING_FOR_VOICE,
+                  {&polyphonyMenu, &unisonMenu, &portaMenu, &arpMenu, &priorityMenu, &paraphonicMenu}};
 
 // Modulator menu -----------------------------------------------------------------------
 
@@ -450,6 +462,8 @@ reverb::RoomSize reverbRoomSizeMenu{STRING_FOR_ROOM_SIZE};
 reverb::Dampening reverbDampeningMenu{STRING_FOR_DAMPENING};
 reverb::Width reverbWidthMenu{STRING_FOR_WIDTH, STRING_FOR_REVERB_WIDTH};
 reverb::Pan reverbPanMenu{STRING_FOR_PAN, STRING_FOR_REVERB_PAN};
+reverb::Model reverbModelMenu{STRING_FOR_MODEL, STRING_FOR_REVERB_MODEL};
+reverb::Quality reverbQualityMenu{STRING_FOR_QUALITY, STRING_FOR_REVERB_QUALITY};
 
 Submenu reverbMenu{
     STRING_FOR_REVERB,
@@ -459,6 +473,8 @@ Submenu reverbMenu{
         &reverbDampeningMenu,
         &reverbWidthMenu,
         &reverbPanMenu,
+        &reverbModelMenu,
+        &reverbQualityMenu,
         &reverbCompressorMenu,
     },
 };
@@ -492,6 +508,7 @@ midi::PGM midiPGMMenu{STRING_FOR_PGM, STRING_FOR_MIDI_PGM_NUMB_MENU_TITLE};
 // Clip-level stuff --------------------------------------------------------------------------
 
 sequence::Direction sequenceDirectionMenu{STRING_FOR_PLAY_DIRECTION};
+menu_item::Freeze freezeMenu{STRING_FOR_FREEZE_CLIP};
 
 // AudioClip stuff ---------------------------------------------------------------------------
 
@@ -590,6 +607,8 @@ Submenu audioClipReverbMenu{
         &reverbDampeningMenu,
         &reverbWidthMenu,
         &reverbPanMenu,
+        &reverbModelMenu,
+        &reverbQualityMenu,
         &reverbCompressorMenu,
     },
 };
@@ -695,6 +714,14 @@ flash::Status flashStatusMenu{STRING_FOR_PLAY_CURSOR};
 
 firmware::Version firmwareVersionMenu{STRING_FOR_FIRMWARE_VERSION, STRING_FOR_FIRMWARE_VER_MENU_TITLE};
 
+firmware::CPUProfile cpuProfileMenu{STRING_FOR_CPU_PROFILE, STRING_FOR_CPU_PROFILE_MENU_TITLE};
+firmware::MemoryTelemetry memoryTelemetryMenu{STRING_FOR_MEMORY_TELEMETRY, STRING_FOR_MEMORY_TELEMETRY_MENU_TITLE};
+firmware::CardBenchmark cardBenchmarkMenu{STRING_FOR_CARD_BENCHMARK, STRING_FOR_CARD_BENCHMARK_MENU_TITLE};
+firmware::VoiceStats voiceStatsMenu{STRING_FOR_VOICE_STATS, STRING_FOR_VOICE_STATS_MENU_TITLE};
+firmware::PerformanceReport performanceReportMenu{STRING_FOR_PERFORMANCE_REPORT,
+                                                  STRING_FOR_PERFORMANCE_REPORT_MENU_TITLE};
+song::EngineProfile songEngineProfileMenu{STRING_FOR_SONG_ENGINE_PROFILE};
+
 runtime_feature::Settings runtimeFeatureSettingsMenu{STRING_FOR_COMMUNITY_FTS, STRING_FOR_COMMUNITY_FTS_MENU_TITLE};
 
 // CV menu
@@ -911,6 +938,7 @@ menu_item::Submenu soundEditorRootMenu{
         &panMenu,
         &patchCablesMenu,
         &sequenceDirectionMenu,
+        &freezeMenu,
     },
 };
 
@@ -955,12 +983,18 @@ Submenu settingsRootMenu{
         &midiMenu,
         &defaultsSubmenu,
         &swingIntervalMenu,
+        &songEngineProfileMenu,
         &padsSubmenu,
         &sampleBrowserPreviewModeMenu,
         &flashStatusMenu,
         &recordSubmenu,
         &runtimeFeatureSettingsMenu,
         &firmwareVersionMenu,
+        &cpuProfileMenu,
+        &memoryTelemetryMenu,
+        &cardBenchmarkMenu,
+        &voiceStatsMenu,
+        &performanceReportMenu,
     },
 };
 
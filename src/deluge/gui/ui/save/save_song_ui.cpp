@@ -30,6 +30,8 @@
 #include "model/sample/sample.h"
 #include "model/song/song.h"
 #include "storage/audio/audio_file_manager.h"
+#include "storage/folder_index.h"
+#include "storage/session_snapshot.h"
 #include "storage/storage_manager.h"
 #include "util/functions.h"
 #include "util/lookuptables/lookuptables.h"
@@ -188,6 +190,8 @@ gotError:
 					FRESULT result =
 					    f_rename(((Sample*)audioFile)->tempFilePathForRecording.get(), audioFile->filePath.get());
 					if (result == FR_OK) {
+						FolderIndex::folderChanged(((Sample*)audioFile)->tempFilePathForRecording.get());
+						FolderIndex::folderChanged(audioFile->filePath.get());
 						((Sample*)audioFile)->tempFilePathForRecording.clear();
 					}
 					else {
@@ -453,6 +457,7 @@ cardError:
 		if (result != FR_OK) {
 			goto cardError;
 		}
+		FolderIndex::folderChanged(filePath.get());
 	}
 
 	display->removeWorkingAnimation();
@@ -466,6 +471,8 @@ cardError:
 	// While we're at it, save MIDI devices if there's anything new to save.
 	MIDIDeviceManager::writeDevicesToFile();
 
+	sessionSnapshot.write(filePath.get());
+
 	close();
 	return true;
 }
@@ -405,14 +405,16 @@ ActionResult Slicer::buttonAction(deluge::hid::Button b, bool on, bool inCardRou
 			numClips = numManualSlice;
 			doSlice();
 			Kit* kit = (Kit*)currentSong->currentClip->output;
+			MultisampleRange* firstRange =
+			    (MultisampleRange*)((SoundDrum*)kit->firstDrum)->sources[0].getOrCreateFirstRange();
 			for (int32_t i = 0; i < numManualSlice; i++) {
 				Drum* drum = kit->getDrumFromIndex(i);
 				SoundDrum* soundDrum = (SoundDrum*)drum;
 				MultisampleRange* range = (MultisampleRange*)soundDrum->sources[0].getOrCreateFirstRange();
-				Sample* sample = (Sample*)range->sampleHolder.audioFile;
-				range->sampleHolder.startPos = manualSlicePoints[i].startPos;
-				range->sampleHolder.endPos = (i == numManualSlice - 1) ? waveformBasicNavigator.sample->lengthInSamples
-				                                                       : this->manualSlicePoints[i + 1].startPos;
+				uint64_t endPos = (i == numManualSlice - 1) ? waveformBasicNavigator.sample->lengthInSamples
+				                                            : this->manualSlicePoints[i + 1].startPos;
+				range->sampleHolder.setupAsSliceOf(&firstRange->sampleHolder, manualSlicePoints[i].startPos, endPos,
+				                                   soundDrum->sources[0].sampleControls.reversed);
 				range->sampleHolder.transpose = manualSlicePoints[i].transpose;
 			}
 		}
@@ -712,14 +714,12 @@ ramError2:
 			kit->addDrum(newDrum);
 			newDrum->setupAsSample(&paramManager);
 
-			range->sampleHolder.startPos = nextDrumStart;
+			uint64_t startPos = nextDrumStart;
 			nextDrumStart = (uint64_t)lengthInSamples * (i + 1) / numClips;
-			range->sampleHolder.endPos = nextDrumStart;
 
 			newDrum->sources[0].repeatMode = (lengthMSPerSlice < 2002) ? SampleRepeatMode::ONCE : SampleRepeatMode::CUT;
 
-			range->sampleHolder.filePath.set(&sample->filePath);
-			range->sampleHolder.loadFile(false, false, true);
+			range->sampleHolder.setupAsSliceOf(&firstRange->sampleHolder, startPos, nextDrumStart, false);
 
 			if (doEnvelopes) {
 				paramManager.getPatchedParamSet()->params[Param::Local::ENV_0_ATTACK].setCurrentValueBasicForSetup(
@@ -417,7 +417,7 @@ void SoundEditor::exitCompletely() {
 
 		display->displayLoadingAnimationText("Saving settings");
 
-		FlashStorage::writeSettings();
+		FlashStorage::requestWriteSettings();
 		MIDIDeviceManager::writeDevicesToFile();
 		runtimeFeatureSettings.writeSettingsToFile();
 		display->removeWorkingAnimation();
@@ -1144,6 +1144,9 @@ doMIDIOrCV:
 	}
 
 	if (currentSound) {
+		char modelStackMemory[MODEL_STACK_MAX_SIZE];
+		currentSound->ensurePatchingSetUp(getCurrentModelStack(modelStackMemory));
+
 		currentSourceIndex = sourceIndex;
 		currentSource = &currentSound->sources[currentSourceIndex];
 		currentSampleControls = &currentSource->sampleControls;
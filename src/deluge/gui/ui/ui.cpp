@@ -23,7 +23,9 @@
 #include "hid/display/display.h"
 #include "hid/led/pad_leds.h"
 #include "hid/matrix/matrix_driver.h"
+#include "io/debug/event_trace.h"
 #include "io/debug/print.h"
+#include "processing/engines/audio_engine.h"
 
 extern "C" {
 #include "RZA1/uart/sio_char.h"
@@ -252,6 +254,7 @@ void nullifyUIs() {
 }
 
 void renderUIsForOled() {
+	TRACE_SCOPE(OLED_RENDER);
 	int32_t u = numUIsOpen - 1;
 	while (u && uiNavigationHierarchy[u]->oledShowsUIUnderneath) {
 		u--;
@@ -270,15 +273,34 @@ void renderUIsForOled() {
 uint32_t whichMainRowsNeedRendering = 0;
 uint32_t whichSideRowsNeedRendering = 0;
 
+// When whatever's in whichMainRowsNeedRendering and whichSideRowsNeedRendering first started waiting, in
+// audioSampleTimer units. Only valid while either is non-zero
+uint32_t timeRenderingBecamePending;
+
+// When the audio routine is struggling, pending rendering waits for it to recover - but never longer than this
+constexpr int32_t kMaxUIRenderingDeferral = kSampleRate / 20;
+constexpr int32_t kCPUDirenessToDeferUIRendering = 8;
+
 void clearPendingUIRendering() {
 	whichMainRowsNeedRendering = whichSideRowsNeedRendering = 0;
 }
 
-void renderingNeededRegardlessOfUI(uint32_t whichMainRows, uint32_t whichSideRows) {
+bool anyMainPadRenderingPending() {
+	return whichMainRowsNeedRendering;
+}
+
+static void addPendingUIRendering(uint32_t whichMainRows, uint32_t whichSideRows) {
+	if (!whichMainRowsNeedRendering && !whichSideRowsNeedRendering) {
+		timeRenderingBecamePending = AudioEngine::audioSampleTimer;
+	}
 	whichMainRowsNeedRendering |= whichMainRows;
 	whichSideRowsNeedRendering |= whichSideRows;
 }
 
+void renderingNeededRegardlessOfUI(uint32_t whichMainRows, uint32_t whichSideRows) {
+	addPendingUIRendering(whichMainRows, whichSideRows);
+}
+
 void uiNeedsRendering(UI* ui, uint32_t whichMainRows, uint32_t whichSideRows) {
 
 	// We might be in the middle of an audio routine or something, so just see whether the selected bit of the UI is visible
@@ -286,8 +308,7 @@ void uiNeedsRendering(UI* ui, uint32_t whichMainRows, uint32_t whichSideRows) {
 	for (int32_t u = numUIsOpen - 1; u >= 0; u--) {
 		UI* thisUI = uiNavigationHierarchy[u];
 		if (ui == thisUI) {
-			whichMainRowsNeedRendering |= whichMainRows;
-			whichSideRowsNeedRendering |= whichSideRows;
+			addPendingUIRendering(whichMainRows, whichSideRows);
 			break;
 		}
 
@@ -324,6 +345,15 @@ void doAnyPendingUIRendering() {
 		return; // Trialling the *2 to fix flickering when flicking through presets very fast
 	}
 
+	// If the audio routine is close to running out of time, give it a moment to get through this - the next lot of
+	// requests just get merged in with what's waiting
+	int32_t direness = AudioEngine::cpuDireness;
+	uint32_t timeWaiting = AudioEngine::audioSampleTimer - timeRenderingBecamePending;
+	if (direness >= kCPUDirenessToDeferUIRendering && timeWaiting < kMaxUIRenderingDeferral) {
+		return;
+	}
+
+	TRACE_SCOPE(UI_RENDER);
 	pendingUIRenderingLock = true;
 
 	// Make a local copy of our instructions
@@ -333,6 +363,20 @@ void doAnyPendingUIRendering() {
 	// Clear the overall instructions - so it may now be written to again during this function call
 	whichMainRowsNeedRendering = whichSideRowsNeedRendering = 0;
 
+	// And the harder the audio routine's working, the fewer main rows we render now, leaving the rest for the next
+	// time round the main loop, with audio rendered in between. Nothing gets sent till they're all done
+	int32_t maxMainRowsNow = kDisplayHeight >> (direness >> 2);
+	if (maxMainRowsNow < kDisplayHeight) {
+		uint32_t mainRowsLater = mainRowsNow & ((1 << kDisplayHeight) - 1);
+		mainRowsNow = 0;
+		for (int32_t numRows = 0; mainRowsLater && numRows < maxMainRowsNow; numRows++) {
+			uint32_t lowestRow = mainRowsLater & -mainRowsLater;
+			mainRowsNow |= lowestRow;
+			mainRowsLater &= ~lowestRow;
+		}
+		whichMainRowsNeedRendering = mainRowsLater; // Still pending since timeRenderingBecamePending
+	}
+
 	for (int32_t u = numUIsOpen - 1; u >= 0; u--) {
 
 		if (!mainRowsNow && !sideRowsNow) {
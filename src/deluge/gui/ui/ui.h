@@ -159,6 +159,7 @@ void getUIGreyoutRowsAndCols(uint32_t* cols, uint32_t* rows);
 void uiNeedsRendering(UI* ui, uint32_t whichMainRows = 0xFFFFFFFF, uint32_t whichSideRows = 0xFFFFFFFF);
 void renderingNeededRegardlessOfUI(uint32_t whichMainRows = 0xFFFFFFFF, uint32_t whichSideRows = 0xFFFFFFFF);
 void clearPendingUIRendering();
+bool anyMainPadRenderingPending();
 
 void doAnyPendingUIRendering();
 
@@ -45,144 +45,131 @@ extern void inputRoutine();
 extern void batteryLEDBlink();
 
 UITimerManager::UITimerManager() {
-	timeNextEvent = 2147483647;
-
 	for (int32_t i = 0; i < NUM_TIMERS; i++) {
-		timers[i].active = false;
+		timers[i].callback = timerCallback;
 	}
 }
 
 void UITimerManager::routine() {
+	wheel.advance(AudioEngine::audioSampleTimer);
+}
 
-	int32_t timeTilNextEvent = (uint32_t)(timeNextEvent - AudioEngine::audioSampleTimer);
-	if (timeTilNextEvent >= 0) {
-		return;
-	}
+void UITimerManager::timerCallback(TimingWheelEntry* entry) {
+	uiTimerManager.timerFired(entry - uiTimerManager.timers);
+}
 
-	for (int32_t i = 0; i < NUM_TIMERS; i++) {
-		if (timers[i].active) {
-
-			int32_t timeTil = (uint32_t)(timers[i].triggerTime - AudioEngine::audioSampleTimer);
-			if (timeTil < 0) {
-
-				timers[i].active = false;
-
-				switch (i) {
-
-				case TIMER_TAP_TEMPO_SWITCH_OFF:
-					playbackHandler.tapTempoAutoSwitchOff();
-					break;
-
-				case TIMER_MIDI_LEARN_FLASH:
-					view.midiLearnFlash();
-					break;
-
-				case TIMER_DEFAULT_ROOT_NOTE:
-					if (getCurrentUI() == &instrumentClipView || getCurrentUI() == &automationInstrumentClipView) {
-						instrumentClipView.flashDefaultRootNote();
-					}
-					else if (getCurrentUI() == &keyboardScreen) {
-						keyboardScreen.flashDefaultRootNote();
-					}
-					break;
-
-				case TIMER_PLAY_ENABLE_FLASH:
-					if (getRootUI() == &sessionView) {
-						sessionView.flashPlayRoutine();
-					}
-					break;
-
-				case TIMER_DISPLAY:
-					if (display->haveOLED()) {
-						auto* oled = static_cast<deluge::hid::display::OLED*>(display);
-						oled->timerRoutine();
-					}
-					else {
-						display->timerRoutine();
-					}
-
-					break;
-
-				case TIMER_LED_BLINK:
-				case TIMER_LED_BLINK_TYPE_1:
-					indicator_leds::ledBlinkTimeout(i - TIMER_LED_BLINK);
-					break;
-
-				case TIMER_LEVEL_INDICATOR_BLINK:
-					indicator_leds::blinkKnobIndicatorLevelTimeout();
-					break;
-
-				case TIMER_SHORTCUT_BLINK:
-					soundEditor.blinkShortcut();
-					break;
-
-				case TIMER_MATRIX_DRIVER:
-					PadLEDs::timerRoutine();
-					break;
-
-				case TIMER_UI_SPECIFIC: {
-					ActionResult result = getCurrentUI()->timerCallback();
-					if (result == ActionResult::REMIND_ME_OUTSIDE_CARD_ROUTINE) {
-						timers[i].active = true; // Come back soon and try again.
-					}
-					break;
-				}
-
-				case TIMER_DISPLAY_AUTOMATION:
-					if ((getCurrentUI() == &automationInstrumentClipView)
-					    && !automationInstrumentClipView.isOnAutomationOverview()) {
-
-						automationInstrumentClipView.displayAutomation();
-					}
-
-					else {
-						view.displayAutomation();
-					}
-					break;
-
-				case TIMER_READ_INPUTS:
-					inputRoutine();
-					break;
-
-				case TIMER_BATT_LED_BLINK:
-					batteryLEDBlink();
-					break;
-
-				case TIMER_GRAPHICS_ROUTINE:
-					if (uartGetTxBufferSpace(UART_ITEM_PIC_PADS) > kNumBytesInColUpdateMessage) {
-						getCurrentUI()->graphicsRoutine();
-					}
-					setTimer(TIMER_GRAPHICS_ROUTINE, 15);
-					break;
-
-				case TIMER_OLED_LOW_LEVEL:
-					if (display->haveOLED()) {
-						oledLowLevelTimerCallback();
-					}
-					break;
-
-				case TIMER_OLED_CONSOLE:
-					if (display->haveOLED()) {
-						auto* oled = static_cast<deluge::hid::display::OLED*>(display);
-						oled->consoleTimerEvent();
-					}
-					break;
-
-				case TIMER_OLED_SCROLLING_AND_BLINKING:
-					if (display->haveOLED()) {
-						deluge::hid::display::OLED::scrollingAndBlinkingTimerEvent();
-					}
-					break;
-
-				case TIMER_SYSEX_DISPLAY:
-					HIDSysex::sendDisplayIfChanged();
-					break;
-				}
-			}
+void UITimerManager::timerFired(int32_t i) {
+	switch (i) {
+
+	case TIMER_TAP_TEMPO_SWITCH_OFF:
+		playbackHandler.tapTempoAutoSwitchOff();
+		break;
+
+	case TIMER_MIDI_LEARN_FLASH:
+		view.midiLearnFlash();
+		break;
+
+	case TIMER_DEFAULT_ROOT_NOTE:
+		if (getCurrentUI() == &instrumentClipView || getCurrentUI() == &automationInstrumentClipView) {
+			instrumentClipView.flashDefaultRootNote();
+		}
+		else if (getCurrentUI() == &keyboardScreen) {
+			keyboardScreen.flashDefaultRootNote();
 		}
+		break;
+
+	case TIMER_PLAY_ENABLE_FLASH:
+		if (getRootUI() == &sessionView) {
+			sessionView.flashPlayRoutine();
+		}
+		break;
+
+	case TIMER_DISPLAY:
+		if (display->haveOLED()) {
+			auto* oled = static_cast<deluge::hid::display::OLED*>(display);
+			oled->timerRoutine();
+		}
+		else {
+			display->timerRoutine();
+		}
+
+		break;
+
+	case TIMER_LED_BLINK:
+	case TIMER_LED_BLINK_TYPE_1:
+		indicator_leds::ledBlinkTimeout(i - TIMER_LED_BLINK);
+		break;
+
+	case TIMER_LEVEL_INDICATOR_BLINK:
+		indicator_leds::blinkKnobIndicatorLevelTimeout();
+		break;
+
+	case TIMER_SHORTCUT_BLINK:
+		soundEditor.blinkShortcut();
+		break;
+
+	case TIMER_MATRIX_DRIVER:
+		PadLEDs::timerRoutine();
+		break;
+
+	case TIMER_UI_SPECIFIC: {
+		ActionResult result = getCurrentUI()->timerCallback();
+		if (result == ActionResult::REMIND_ME_OUTSIDE_CARD_ROUTINE) {
+			setTimerSamples(i, 0); // Come back soon and try again.
+		}
+		break;
 	}
 
-	workOutNextEventTime();
+	case TIMER_DISPLAY_AUTOMATION:
+		if ((getCurrentUI() == &automationInstrumentClipView)
+		    && !automationInstrumentClipView.isOnAutomationOverview()) {
+
+			automationInstrumentClipView.displayAutomation();
+		}
+
+		else {
+			view.displayAutomation();
+		}
+		break;
+
+	case TIMER_READ_INPUTS:
+		inputRoutine();
+		break;
+
+	case TIMER_BATT_LED_BLINK:
+		batteryLEDBlink();
+		break;
+
+	case TIMER_GRAPHICS_ROUTINE:
+		if (uartGetTxBufferSpace(UART_ITEM_PIC_PADS) > kNumBytesInColUpdateMessage) {
+			getCurrentUI()->graphicsRoutine();
+		}
+		setTimer(TIMER_GRAPHICS_ROUTINE, 15);
+		break;
+
+	case TIMER_OLED_LOW_LEVEL:
+		if (display->haveOLED()) {
+			oledLowLevelTimerCallback();
+		}
+		break;
+
+	case TIMER_OLED_CONSOLE:
+		if (display->haveOLED()) {
+			auto* oled = static_cast<deluge::hid::display::OLED*>(display);
+			oled->consoleTimerEvent();
+		}
+		break;
+
+	case TIMER_OLED_SCROLLING_AND_BLINKING:
+		if (display->haveOLED()) {
+			deluge::hid::display::OLED::scrollingAndBlinkingTimerEvent();
+		}
+		break;
+
+	case TIMER_SYSEX_DISPLAY:
+		HIDSysex::sendDisplayIfChanged();
+		break;
+	}
 }
 
 void UITimerManager::setTimer(int32_t i, int32_t ms) {
@@ -190,41 +177,21 @@ void UITimerManager::setTimer(int32_t i, int32_t ms) {
 }
 
 void UITimerManager::setTimerSamples(int32_t i, int32_t samples) {
-	timers[i].triggerTime = AudioEngine::audioSampleTimer + samples;
-	timers[i].active = true;
-
-	int32_t oldTimeTilNextEvent = (uint32_t)(timeNextEvent - AudioEngine::audioSampleTimer);
-	if (samples < oldTimeTilNextEvent) {
-		timeNextEvent = timers[i].triggerTime;
-	}
+	wheel.schedule(&timers[i], AudioEngine::audioSampleTimer, samples);
 }
 
 void UITimerManager::setTimerByOtherTimer(int32_t i, int32_t j) {
-	timers[i].triggerTime = timers[j].triggerTime;
-	timers[i].active = true;
+	wheel.scheduleAlongside(&timers[i], &timers[j]);
 }
 
 void UITimerManager::unsetTimer(int32_t i) {
-	timers[i].active = false;
-	workOutNextEventTime();
+	wheel.unschedule(&timers[i]);
 }
 
 bool UITimerManager::isTimerSet(int32_t i) {
-	return timers[i].active;
+	return timers[i].isScheduled();
 }
 
-void UITimerManager::workOutNextEventTime() {
-
-	int32_t timeTilNextEvent = 2147483647;
-
-	for (int32_t i = 0; i < NUM_TIMERS; i++) {
-		if (timers[i].active) {
-			int32_t timeTil = timers[i].triggerTime - AudioEngine::audioSampleTimer;
-			if (timeTil < timeTilNextEvent) {
-				timeTilNextEvent = timeTil;
-			}
-		}
-	}
-
-	timeNextEvent = AudioEngine::audioSampleTimer + (uint32_t)timeTilNextEvent;
+void UITimerManager::scheduleSamples(TimingWheelEntry* entry, int32_t samples) {
+	wheel.schedule(entry, AudioEngine::audioSampleTimer, samples);
 }
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "definitions_cxx.hpp"
+#include "util/container/timing_wheel.h"
 
 #define TIMER_DISPLAY 0
 #define TIMER_MIDI_LEARN_FLASH 1
@@ -40,10 +41,8 @@
 #define TIMER_SYSEX_DISPLAY 18
 #define NUM_TIMERS 19
 
-struct Timer {
-	bool active;
-	uint32_t triggerTime;
-};
+// Ticks of 16 samples - plenty fine enough for anything on the UI side
+constexpr int32_t kUITimerTickMagnitude = 4;
 
 class UITimerManager {
 public:
@@ -57,11 +56,18 @@ public:
 	bool isTimerSet(int32_t i);
 	void setTimerByOtherTimer(int32_t i, int32_t j);
 
-	Timer timers[NUM_TIMERS];
+	// For anything else wanting calling back after a while, rather than checking the time in its slowRoutine(). The
+	// callback happens from routine(), so not from within the audio routine, but possibly from within the card routine
+	void schedule(TimingWheelEntry* entry, int32_t ms) { scheduleSamples(entry, ms * 44); }
+	void scheduleSamples(TimingWheelEntry* entry, int32_t samples);
+	void unschedule(TimingWheelEntry* entry) { wheel.unschedule(entry); }
 
 private:
-	uint32_t timeNextEvent;
-	void workOutNextEventTime();
+	static void timerCallback(TimingWheelEntry* entry);
+	void timerFired(int32_t i);
+
+	TimingWheelEntry timers[NUM_TIMERS];
+	TimingWheel wheel{kUITimerTickMagnitude};
 };
 
 extern UITimerManager uiTimerManager;
@@ -91,6 +91,12 @@ ArrangerView::ArrangerView() {
 	lastInteractedOutputIndex = 0;
 	lastInteractedPos = -1;
 	lastInteractedSection = 0;
+
+	for (auto& row : rowCache) {
+		row.output = NULL;
+	}
+	rowCacheXScroll = 0;
+	rowCacheXZoom = 0;
 }
 
 void ArrangerView::renderOLED(uint8_t image[][OLED_MAIN_WIDTH_PIXELS]) {
@@ -2053,13 +2059,52 @@ bool ArrangerView::renderMainPads(uint32_t whichRows, uint8_t image[][kDisplayWi
 
 	PadLEDs::renderingLock = false;
 
-	if (whichRowsCouldntBeRendered && image == PadLEDs::image) {
-		uiNeedsRendering(this, whichRowsCouldntBeRendered, 0);
+	if (image == PadLEDs::image) {
+		if (whichRowsCouldntBeRendered) {
+			uiNeedsRendering(this, whichRowsCouldntBeRendered, 0);
+		}
+		if (occupancyMask) {
+			rememberRenderedRows(whichRows & ~whichRowsCouldntBeRendered, image, occupancyMask);
+		}
 	}
 
 	return true;
 }
 
+// Keeps a copy of rows just rendered to the pads, for setupScroll()
+void ArrangerView::rememberRenderedRows(uint32_t whichRows, uint8_t image[][kDisplayWidth + kSideBarWidth][3],
+                                        uint8_t occupancyMask[][kDisplayWidth + kSideBarWidth]) {
+	int32_t xScroll = currentSong->xScroll[NAVIGATION_ARRANGEMENT];
+	uint32_t xZoom = currentSong->xZoom[NAVIGATION_ARRANGEMENT];
+
+	// A ClipInstance being dragged isn't really there yet, and one being recorded keeps growing
+	bool worthKeeping =
+	    (currentUIMode != UI_MODE_HOLDING_ARRANGEMENT_ROW && playbackHandler.recording != RECORDING_ARRANGEMENT);
+
+	if (!worthKeeping || xScroll != rowCacheXScroll || xZoom != rowCacheXZoom) {
+		for (auto& row : rowCache) {
+			row.output = NULL;
+		}
+		rowCacheXScroll = xScroll;
+		rowCacheXZoom = xZoom;
+	}
+
+	if (!worthKeeping) {
+		return;
+	}
+
+	for (int32_t yDisplay = 0; yDisplay < kDisplayHeight; yDisplay++) {
+		if (whichRows & (1 << yDisplay)) {
+			ArrangerRowCache* row = &rowCache[yDisplay];
+			row->output = outputsOnScreen[yDisplay];
+			if (row->output) {
+				memcpy(row->image, image[yDisplay], kDisplayWidth * 3);
+				memcpy(row->occupancyMask, occupancyMask[yDisplay], kDisplayWidth);
+			}
+		}
+	}
+}
+
 // Returns false if can't because in card routine
 // occupancyMask can be NULL
 bool ArrangerView::renderRow(ModelStack* modelStack, int32_t yDisplay, int32_t xScroll, uint32_t xZoom,
@@ -2095,6 +2140,7 @@ bool ArrangerView::renderRow(ModelStack* modelStack, int32_t yDisplay, int32_t x
 	if (!success) {
 		return false;
 	}
+	view.addRenderLoadOverlay(output, imageThisRow, renderWidth);
 
 	if (drawGhostClipInstanceHere) {
 
@@ -2138,13 +2184,15 @@ bool ArrangerView::renderRow(ModelStack* modelStack, int32_t yDisplay, int32_t x
 // Lock rendering before calling this
 // Returns false if can't because in card routine
 // occupancyMask can be NULL
+// Only renders from square xStart up to renderWidth
 bool ArrangerView::renderRowForOutput(ModelStack* modelStack, Output* output, int32_t xScroll, uint32_t xZoom,
-                                      uint8_t* image, uint8_t occupancyMask[], int32_t renderWidth, int32_t ignoreI) {
+                                      uint8_t* image, uint8_t occupancyMask[], int32_t renderWidth, int32_t ignoreI,
+                                      int32_t xStart) {
 
-	uint8_t* imageNow = image;
+	uint8_t* imageNow = image + xStart * 3;
 	uint8_t* const imageEnd = image + renderWidth * 3;
 
-	int32_t firstXDisplayNotLeftOf0 = 0;
+	int32_t firstXDisplayNotLeftOf0 = xStart;
 
 	if (!output->clipInstances.getNumElements()) {
 		while (imageNow < imageEnd) {
@@ -2165,8 +2213,8 @@ bool ArrangerView::renderRowForOutput(ModelStack* modelStack, Output* output, in
 
 	output->clipInstances.searchMultiple(&searchTerms[firstXDisplayNotLeftOf0], renderWidth - firstXDisplayNotLeftOf0);
 
-	int32_t farLeftPos = getPosFromSquare(firstXDisplayNotLeftOf0, xScroll, xZoom);
-	int32_t squareStartPos = farLeftPos;
+	int32_t farLeftPos = getPosFromSquare(0, xScroll, xZoom);
+	int32_t squareStartPos = getPosFromSquare(firstXDisplayNotLeftOf0, xScroll, xZoom);
 
 	int32_t xDisplay = firstXDisplayNotLeftOf0;
 
@@ -2857,6 +2905,8 @@ ActionResult ArrangerView::verticalScrollOneSquare(int32_t direction) {
 			lower->next = output->next;
 			output->next = lower;
 		}
+
+		currentSong->midiInputRoutingChanged(); // Keep offering incoming MIDI in the same order as the list
 	}
 
 	// Or if dragging ClipInstance vertically
@@ -3128,6 +3178,77 @@ void ArrangerView::tellMatrixDriverWhichRowsContainSomethingZoomable() {
 	}
 }
 
+bool ArrangerView::setupScroll(uint32_t oldScroll) {
+	if (setupScrollFromRowCache()) {
+		memset(PadLEDs::transitionTakingPlaceOnRow, 1, sizeof(PadLEDs::transitionTakingPlaceOnRow));
+		return true;
+	}
+	return TimelineView::setupScroll(oldScroll);
+}
+
+// Scrolling doesn't change the arrangement, so if we've still got what each row looked like last time it was rendered,
+// we can shift that along and only render the squares coming into view - which with lots of long ClipInstances can be
+// most of the work. Renders into the same place as TimelineView::setupScroll(). Returns false if we can't
+bool ArrangerView::setupScrollFromRowCache() {
+	int32_t xScroll = currentSong->xScroll[NAVIGATION_ARRANGEMENT];
+	uint32_t xZoom = currentSong->xZoom[NAVIGATION_ARRANGEMENT];
+
+	if (xZoom != rowCacheXZoom || anyMainPadRenderingPending() || currentUIMode == UI_MODE_HOLDING_ARRANGEMENT_ROW
+	    || playbackHandler.recording == RECORDING_ARRANGEMENT) {
+		return false;
+	}
+
+	int32_t scrollDifference = xScroll - rowCacheXScroll;
+	if (scrollDifference % (int32_t)xZoom) {
+		return false;
+	}
+	int32_t squaresMoved = scrollDifference / (int32_t)xZoom;
+	if (!squaresMoved || squaresMoved >= kDisplayWidth || squaresMoved <= -kDisplayWidth) {
+		return false;
+	}
+
+	for (int32_t yDisplay = 0; yDisplay < kDisplayHeight; yDisplay++) {
+		if (outputsOnScreen[yDisplay] && rowCache[yDisplay].output != outputsOnScreen[yDisplay]) {
+			return false;
+		}
+	}
+
+	int32_t numSquaresKept = kDisplayWidth - std::abs(squaresMoved);
+	int32_t keepFrom = (squaresMoved > 0) ? squaresMoved : 0;
+	int32_t keepTo = (squaresMoved > 0) ? 0 : -squaresMoved;
+	int32_t newFrom = (squaresMoved > 0) ? numSquaresKept : 0;
+	int32_t newTo = (squaresMoved > 0) ? kDisplayWidth : -squaresMoved;
+
+	char modelStackMemory[MODEL_STACK_MAX_SIZE];
+	ModelStack* modelStack = setupModelStackWithSong(modelStackMemory, currentSong);
+
+	PadLEDs::renderingLock = true;
+
+	for (int32_t yDisplay = 0; yDisplay < kDisplayHeight; yDisplay++) {
+		uint8_t* image = PadLEDs::imageStore[yDisplay][0];
+		uint8_t* occupancyMask = PadLEDs::occupancyMaskStore[kDisplayHeight + yDisplay];
+		Output* output = outputsOnScreen[yDisplay];
+
+		if (!output) {
+			memset(image, 0, kDisplayWidth * 3);
+			continue;
+		}
+
+		memcpy(&image[keepTo * 3], rowCache[yDisplay].image[keepFrom], numSquaresKept * 3);
+		memcpy(&occupancyMask[keepTo], &rowCache[yDisplay].occupancyMask[keepFrom], numSquaresKept);
+
+		bool success =
+		    renderRowForOutput(modelStack, output, xScroll, xZoom, image, occupancyMask, newTo, -2, newFrom);
+		if (!success) {
+			PadLEDs::renderingLock = false;
+			return false;
+		}
+	}
+
+	PadLEDs::renderingLock = false;
+	return true;
+}
+
 void ArrangerView::scrollFinished() {
 	TimelineView::scrollFinished();
 	reassessWhetherDoingAutoScroll();
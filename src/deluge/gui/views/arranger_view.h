@@ -35,6 +35,13 @@ class Drum;
 class ModelStack;
 class ModelStackWithNoteRow;
 
+// The last render of one Output's row, for ArrangerView::setupScroll()
+struct ArrangerRowCache {
+	Output* output; // NULL if nothing's cached
+	uint8_t image[kDisplayWidth][3];
+	uint8_t occupancyMask[kDisplayWidth];
+};
+
 class ArrangerView final : public TimelineView {
 public:
 	ArrangerView();
@@ -69,6 +76,7 @@ public:
 	bool supportsTriplets() { return false; }
 	bool putDraggedClipInstanceInNewPosition(Output* output);
 	void tellMatrixDriverWhichRowsContainSomethingZoomable();
+	bool setupScroll(uint32_t oldScroll) override;
 	void scrollFinished();
 	void notifyPlaybackBegun();
 	uint32_t getGreyedOutRowsNotRepresentingOutput(Output* output);
@@ -135,7 +143,17 @@ private:
 	void goToSongView();
 	void changeOutputToAudio();
 	bool renderRowForOutput(ModelStack* modelStack, Output* output, int32_t xScroll, uint32_t xZoom, uint8_t* image,
-	                        uint8_t occupancyMask[], int32_t renderWidth, int32_t ignoreI);
+	                        uint8_t occupancyMask[], int32_t renderWidth, int32_t ignoreI, int32_t xStart = 0);
+	void rememberRenderedRows(uint32_t whichRows, uint8_t image[][kDisplayWidth + kSideBarWidth][3],
+	                          uint8_t occupancyMask[][kDisplayWidth + kSideBarWidth]);
+	bool setupScrollFromRowCache();
+
+	// What's been rendered to the pads for each Output on screen, at rowCacheXScroll and rowCacheXZoom - so a
+	// horizontal scroll only has to render the squares it brings into view. Only trusted when no other rendering's
+	// pending, as anything which changes the arrangement asks for a re-render
+	ArrangerRowCache rowCache[kDisplayHeight];
+	int32_t rowCacheXScroll;
+	uint32_t rowCacheXZoom;
 	Instrument* createNewInstrument(InstrumentType newInstrumentType, bool* instrumentAlreadyInSong);
 	void changeOutputToInstrument(InstrumentType newInstrumentType);
 	uint32_t doActualRender(int32_t xScroll, uint32_t xZoom, uint32_t whichRows, uint8_t* image,
@@ -69,6 +69,7 @@ inline Sample* getSample() {
 }
 
 bool AudioClipView::opened() {
+	getClip()->loadDeferredSample();
 	mustRedrawTickSquares = true;
 	uiNeedsRendering(this);
 
@@ -589,19 +589,44 @@ void AutomationInstrumentClipView::performActualRender(uint32_t whichRows, uint8
 	char modelStackMemory[MODEL_STACK_MAX_SIZE];
 	ModelStackWithTimelineCounter* modelStack = currentSong->setupModelStackWithCurrentClip(modelStackMemory);
 
+	bool canAutomate = instrument->type != InstrumentType::CV
+	                   && !(instrument->type == InstrumentType::KIT && !instrumentClipView.getAffectEntire()
+	                        && !((Kit*)instrument)->selectedDrum);
+
+	//every row of the automation editor shows the same value for each column, and getting one means searching
+	//through the param's nodes - so get each column's just the once here, rather than again for every row
+	ModelStackWithAutoParam* modelStackWithParam = nullptr;
+	int32_t effectiveLength = 0;
+	int32_t knobPosForColumn[kDisplayWidth];
+
+	if (canAutomate && !isOnAutomationOverview()) {
+		effectiveLength = getEffectiveLength(modelStack);
+		modelStackWithParam =
+		    getModelStackWithParam(modelStack, clip, clip->lastSelectedParamID, clip->lastSelectedParamKind);
+
+		if (modelStackWithParam && modelStackWithParam->autoParam) {
+			for (int32_t xDisplay = 0; xDisplay < kDisplayWidth; xDisplay++) {
+				uint32_t squareStart = getMiddlePosFromSquare(xDisplay, effectiveLength);
+				knobPosForColumn[xDisplay] = getParameterKnobPos(modelStackWithParam, squareStart) + kKnobPosOffset;
+			}
+		}
+	}
+
 	for (int32_t yDisplay = 0; yDisplay < kDisplayHeight; yDisplay++) {
 
 		uint8_t* occupancyMaskOfRow = occupancyMask[yDisplay];
 
-		if (instrument->type != InstrumentType::CV
-		    && !(instrument->type == InstrumentType::KIT && !instrumentClipView.getAffectEntire()
-		         && !((Kit*)instrument)->selectedDrum)) {
+		if (canAutomate) {
 
 			//if parameter has been selected, show Automation Editor
 			if (!isOnAutomationOverview()) {
 
-				renderAutomationEditor(modelStack, clip, instrument, image + (yDisplay * imageWidth * 3),
-				                       occupancyMaskOfRow, renderWidth, xScroll, xZoom, yDisplay, drawUndefinedArea);
+				if (modelStackWithParam && modelStackWithParam->autoParam) {
+					renderAutomationEditor(clip, image + (yDisplay * imageWidth * 3), occupancyMaskOfRow, renderWidth,
+					                       xScroll, xZoom, yDisplay, drawUndefinedArea,
+					                       modelStackWithParam->autoParam->isAutomated(), knobPosForColumn,
+					                       effectiveLength);
+				}
 			}
 
 			//if not editing a parameter, show Automation Overview
@@ -705,42 +730,33 @@ void AutomationInstrumentClipView::renderAutomationOverview(ModelStackWithTimeli
 	}
 }
 
-//gets the length of the clip, renders the pads corresponding to current parameter values set up to the clip length
+//renders the pads corresponding to current parameter values set up to the clip length, from the knobPos for each
+//column worked out in performActualRender
 //renders the undefined area of the clip that the user can't interact with
-void AutomationInstrumentClipView::renderAutomationEditor(ModelStackWithTimelineCounter* modelStack,
-                                                          InstrumentClip* clip, Instrument* instrument, uint8_t* image,
+void AutomationInstrumentClipView::renderAutomationEditor(InstrumentClip* clip, uint8_t* image,
                                                           uint8_t occupancyMask[], int32_t renderWidth, int32_t xScroll,
-                                                          uint32_t xZoom, int32_t yDisplay, bool drawUndefinedArea) {
-
-	ModelStackWithAutoParam* modelStackWithParam =
-	    getModelStackWithParam(modelStack, clip, clip->lastSelectedParamID, clip->lastSelectedParamKind);
-
-	if (modelStackWithParam && modelStackWithParam->autoParam) {
-
-		renderRow(modelStack, modelStackWithParam, image, occupancyMask, yDisplay,
-		          modelStackWithParam->autoParam->isAutomated());
+                                                          uint32_t xZoom, int32_t yDisplay, bool drawUndefinedArea,
+                                                          bool isAutomated, int32_t const knobPosForColumn[],
+                                                          int32_t effectiveLength) {
 
-		if (drawUndefinedArea == true) {
+	renderRow(image, occupancyMask, yDisplay, isAutomated, knobPosForColumn);
 
-			int32_t effectiveLength = getEffectiveLength(modelStack);
+	if (drawUndefinedArea == true) {
 
-			clip->drawUndefinedArea(xScroll, xZoom, effectiveLength, image, occupancyMask, renderWidth, this,
-			                        currentSong->tripletsOn);
-		}
+		clip->drawUndefinedArea(xScroll, xZoom, effectiveLength, image, occupancyMask, renderWidth, this,
+		                        currentSong->tripletsOn);
 	}
 }
 
 //this function started off as a copy of the renderRow function from the NoteRow class - I replaced "notes" with "nodes"
 //it worked for the most part, but there was bugs so I removed the buggy code and inserted my alternative rendering method
 //which always works. hoping to bring back the other code once I've worked out the bugs.
-void AutomationInstrumentClipView::renderRow(ModelStackWithTimelineCounter* modelStack,
-                                             ModelStackWithAutoParam* modelStackWithParam, uint8_t* image,
-                                             uint8_t occupancyMask[], int32_t yDisplay, bool isAutomated) {
+void AutomationInstrumentClipView::renderRow(uint8_t* image, uint8_t occupancyMask[], int32_t yDisplay,
+                                             bool isAutomated, int32_t const knobPosForColumn[]) {
 
 	for (int32_t xDisplay = 0; xDisplay < kDisplayWidth; xDisplay++) {
 
-		uint32_t squareStart = getMiddlePosFromSquare(modelStack, xDisplay);
-		int32_t knobPos = getParameterKnobPos(modelStackWithParam, squareStart) + kKnobPosOffset;
+		int32_t knobPos = knobPosForColumn[xDisplay];
 
 		uint8_t* pixel = image + (xDisplay * 3);
 
@@ -3023,8 +3039,11 @@ int32_t AutomationInstrumentClipView::getEffectiveLength(ModelStackWithTimelineC
 //as that is the most accurate value that represents that square
 uint32_t AutomationInstrumentClipView::getMiddlePosFromSquare(ModelStackWithTimelineCounter* modelStack,
                                                               int32_t xDisplay) {
-	int32_t effectiveLength = getEffectiveLength(modelStack);
+	return getMiddlePosFromSquare(xDisplay, getEffectiveLength(modelStack));
+}
 
+//same as above, for when you've already got the effective length
+uint32_t AutomationInstrumentClipView::getMiddlePosFromSquare(int32_t xDisplay, int32_t effectiveLength) {
 	uint32_t squareStart = getPosFromSquare(xDisplay);
 	uint32_t squareWidth = instrumentClipView.getSquareWidth(xDisplay, effectiveLength);
 	if (squareWidth != 3) {
@@ -123,11 +123,11 @@ private:
 	void renderAutomationOverview(ModelStackWithTimelineCounter* modelStack, InstrumentClip* clip,
 	                              Instrument* instrument, uint8_t* image, uint8_t occupancyMask[],
 	                              int32_t yDisplay = 0);
-	void renderAutomationEditor(ModelStackWithTimelineCounter* modelStack, InstrumentClip* clip, Instrument* instrument,
-	                            uint8_t* image, uint8_t occupancyMask[], int32_t renderWidth, int32_t xScroll,
-	                            uint32_t xZoom, int32_t yDisplay = 0, bool drawUndefinedArea = true);
-	void renderRow(ModelStackWithTimelineCounter* modelStack, ModelStackWithAutoParam* modelStackWithParam,
-	               uint8_t* image, uint8_t occupancyMask[], int32_t yDisplay = 0, bool isAutomated = false);
+	void renderAutomationEditor(InstrumentClip* clip, uint8_t* image, uint8_t occupancyMask[], int32_t renderWidth,
+	                            int32_t xScroll, uint32_t xZoom, int32_t yDisplay, bool drawUndefinedArea,
+	                            bool isAutomated, int32_t const knobPosForColumn[], int32_t effectiveLength);
+	void renderRow(uint8_t* image, uint8_t occupancyMask[], int32_t yDisplay, bool isAutomated,
+	               int32_t const knobPosForColumn[]);
 	void renderLove(uint8_t* image, uint8_t occupancyMask[], int32_t yDisplay = 0);
 
 	//Enter/Exit Scale Mode
@@ -150,6 +150,7 @@ private:
 	                                                Param::Kind paramKind = Param::Kind::NONE);
 	int32_t getEffectiveLength(ModelStackWithTimelineCounter* modelStack);
 	uint32_t getMiddlePosFromSquare(ModelStackWithTimelineCounter* modelStack, int32_t xDisplay);
+	uint32_t getMiddlePosFromSquare(int32_t xDisplay, int32_t effectiveLength);
 
 	void getParameterName(char* parameterName);
 	int32_t getParameterKnobPos(ModelStackWithAutoParam* modelStack, uint32_t pos);
@@ -103,6 +103,7 @@ InstrumentClipView::InstrumentClipView() {
 		numEditPadPressesPerNoteRowOnScreen[yDisplay] = 0;
 		lastAuditionedVelocityOnScreen[yDisplay] = 255;
 		auditionPadIsPressed[yDisplay] = 0;
+		renderedRowCache[yDisplay].noteRow = NULL;
 	}
 
 	auditioningSilently = false;
@@ -5119,10 +5120,8 @@ void InstrumentClipView::performActualRender(uint32_t whichRows, uint8_t* image,
 
 			// Otherwise render the row
 			else {
-				noteRow->renderRow(this, rowColour[yDisplay], rowTailColour[yDisplay], rowBlurColour[yDisplay], image,
-				                   occupancyMaskOfRow, true, modelStackWithNoteRow->getLoopLength(),
-				                   clip->allowNoteTails(modelStackWithNoteRow), renderWidth, xScroll, xZoom, 0,
-				                   renderWidth, false);
+				renderNoteRowUsingCache(yDisplay, noteRow, modelStackWithNoteRow, image, occupancyMaskOfRow, xScroll,
+				                        xZoom, renderWidth);
 			}
 
 			if (drawUndefinedArea) {
@@ -5137,6 +5136,59 @@ void InstrumentClipView::performActualRender(uint32_t whichRows, uint8_t* image,
 	}
 }
 
+// Re-renders after scrolls and zooms, and whole-grid re-renders for changes to other rows or the sidebar, often find
+// nothing's changed for a row since it was last drawn - so check before going through its Notes square by square
+void InstrumentClipView::renderNoteRowUsingCache(int32_t yDisplay, NoteRow* noteRow, ModelStackWithNoteRow* modelStack,
+                                                 uint8_t* image, uint8_t* occupancyMask, int32_t xScroll,
+                                                 uint32_t xZoom, int32_t renderWidth) {
+	InstrumentClip* clip = getCurrentClip();
+	uint32_t effectiveLength = modelStack->getLoopLength();
+	bool allowNoteTails = clip->allowNoteTails(modelStack);
+
+	if (renderWidth > kDisplayWidth) {
+		noteRow->renderRow(this, rowColour[yDisplay], rowTailColour[yDisplay], rowBlurColour[yDisplay], image,
+		                   occupancyMask, true, effectiveLength, allowNoteTails, renderWidth, xScroll, xZoom, 0,
+		                   renderWidth, false);
+		return;
+	}
+
+	RenderedRowCache* cache = &renderedRowCache[yDisplay];
+	uint32_t tripletsLevel = inTripletsView() ? currentSong->tripletsLevel : 0;
+	bool fillModeActive = currentSong->isFillModeActive();
+	uint32_t notesChecksum = noteRow->getRenderChecksum(getPosFromSquare(0, xScroll, xZoom),
+	                                                    getPosFromSquare(kDisplayWidth, xScroll, xZoom));
+
+	if (cache->noteRow != noteRow || cache->xScroll != xScroll || cache->xZoom != xZoom
+	    || cache->tripletsLevel != tripletsLevel || cache->effectiveLength != effectiveLength
+	    || cache->notesChecksum != notesChecksum || cache->allowNoteTails != allowNoteTails
+	    || cache->fillModeActive != fillModeActive || memcmp(cache->colours[0], rowColour[yDisplay], 3)
+	    || memcmp(cache->colours[1], rowTailColour[yDisplay], 3)
+	    || memcmp(cache->colours[2], rowBlurColour[yDisplay], 3)) {
+
+		// Always render the full width, so the cache is good for any renderWidth up to that
+		noteRow->renderRow(this, rowColour[yDisplay], rowTailColour[yDisplay], rowBlurColour[yDisplay],
+		                   &cache->image[0][0], cache->occupancyMask, true, effectiveLength, allowNoteTails,
+		                   kDisplayWidth, xScroll, xZoom, 0, kDisplayWidth, false);
+
+		cache->noteRow = noteRow;
+		cache->xScroll = xScroll;
+		cache->xZoom = xZoom;
+		cache->tripletsLevel = tripletsLevel;
+		cache->effectiveLength = effectiveLength;
+		cache->notesChecksum = notesChecksum;
+		cache->allowNoteTails = allowNoteTails;
+		cache->fillModeActive = fillModeActive;
+		memcpy(cache->colours[0], rowColour[yDisplay], 3);
+		memcpy(cache->colours[1], rowTailColour[yDisplay], 3);
+		memcpy(cache->colours[2], rowBlurColour[yDisplay], 3);
+	}
+
+	memcpy(image, cache->image, renderWidth * 3);
+	if (occupancyMask) {
+		memcpy(occupancyMask, cache->occupancyMask, renderWidth);
+	}
+}
+
 void InstrumentClipView::playbackEnded() {
 
 	// Easter egg - if user's holding down a note, we want it to be edit-auditioned again now
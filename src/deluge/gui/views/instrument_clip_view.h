@@ -56,6 +56,22 @@ struct EditPadPress {
 	uint32_t intendedLength; // For "blurred squares", means length of square
 };
 
+// What NoteRow::renderRow() last drew for one row of the grid, along with everything it was drawn from, so rendering
+// that row again with nothing changed can just copy it
+struct RenderedRowCache {
+	NoteRow* noteRow; // NULL if nothing's cached
+	int32_t xScroll;
+	uint32_t xZoom;
+	uint32_t tripletsLevel; // 0 if not in triplets view
+	uint32_t effectiveLength;
+	uint32_t notesChecksum;
+	uint8_t colours[3][3]; // Main, tail, blur
+	bool allowNoteTails;
+	bool fillModeActive;
+	uint8_t image[kDisplayWidth][3];
+	uint8_t occupancyMask[kDisplayWidth];
+};
+
 #define MPE_RECORD_LENGTH_FOR_NOTE_EDITING 3
 #define MPE_RECORD_INTERVAL_TIME (kSampleRate >> 2) // 250ms
 
@@ -205,6 +221,12 @@ private:
 	uint8_t rowTailColour[kDisplayHeight][3];
 	uint8_t rowBlurColour[kDisplayHeight][3];
 
+	RenderedRowCache renderedRowCache[kDisplayHeight];
+
+	void renderNoteRowUsingCache(int32_t yDisplay, NoteRow* noteRow, ModelStackWithNoteRow* modelStack,
+	                             uint8_t* image, uint8_t* occupancyMask, int32_t xScroll, uint32_t xZoom,
+	                             int32_t renderWidth);
+
 	Drum* getNextDrum(Drum* oldDrum, bool mayBeNone = false);
 	Drum* flipThroughAvailableDrums(int32_t newOffset, Drum* drum, bool mayBeNone = false);
 	NoteRow* createNewNoteRowForKit(ModelStackWithTimelineCounter* modelStack, int32_t yDisplay,
@@ -2385,6 +2385,7 @@ bool SessionView::renderRow(ModelStack* modelStack, uint8_t yDisplay,
 				                                                     currentSong->xZoom[NAVIGATION_CLIP]),
 				                                  currentSong->xZoom[NAVIGATION_CLIP], thisImage[0], thisOccupancyMask,
 				                                  drawUndefinedArea);
+				view.addRenderLoadOverlay(clip->output, thisImage[0], kDisplayWidth);
 			}
 
 			if (view.thingPressedForMidiLearn == MidiLearn::MELODIC_INSTRUMENT_INPUT && view.midiLearnFlashOn
@@ -3021,6 +3022,7 @@ bool SessionView::gridRenderMainPads(uint32_t whichRows, uint8_t image[][kDispla
 		if (x >= 0 && y >= 0) {
 			occupancyMask[y][x] = 64;
 			gridRenderClipColor(clip, image[y][x]);
+			view.addRenderLoadOverlay(clip->output, image[y][x], 1);
 		}
 	}
 
@@ -77,6 +77,7 @@
 #include "storage/file_item.h"
 #include "storage/flash_storage.h"
 #include "storage/storage_manager.h"
+#include <algorithm>
 
 extern "C" {
 #include "RZA1/uart/sio_char.h"
@@ -442,9 +443,7 @@ possiblyRevert:
 
 void View::endMIDILearn() {
 	if (shouldSaveSettingsAfterMidiLearn) {
-		if (!AudioEngine::audioRoutineLocked) {
-			FlashStorage::writeSettings(); // Rare case where we could have been called during audio routine
-		}
+		FlashStorage::requestWriteSettings(); // Could have been called during audio routine, so can't write now
 	}
 	uiTimerManager.unsetTimer(TIMER_MIDI_LEARN_FLASH);
 	midiLearnFlashOn = false;
@@ -569,6 +568,9 @@ void View::endMidiLearnPressSession(MidiLearn newThingPressed) {
 
 	learnedThing = NULL;
 
+	// Whatever was pressed may have just been learned or unlearned
+	currentSong->midiInputRoutingChanged();
+
 	// And, store the actual change
 	thingPressedForMidiLearn = newThingPressed;
 }
@@ -625,6 +627,7 @@ recordDetailsOfLearnedThing:
 			learnedThing->device = fromDevice;
 			learnedThing->channelOrZone = channelOrZone;
 			learnedThing->noteOrCC = note;
+			currentSong->midiInputRoutingChanged();
 			break;
 
 		case MidiLearn::MELODIC_INSTRUMENT_INPUT:
@@ -715,6 +718,7 @@ isMPEZone:
 
 			learnedThing->channelOrZone = channelOrZone;
 			learnedThing->device = fromDevice;
+			currentSong->midiInputRoutingChanged();
 			melodicInstrumentPressedForMIDILearn->beenEdited(false); // Why again?
 
 			if (melodicInstrumentPressedForMIDILearn->type == InstrumentType::SYNTH) {
@@ -764,6 +768,7 @@ void View::ccReceivedForMIDILearn(MIDIDevice* fromDevice, int32_t channel, int32
 				if (highestMIDIChannelSeenWhileLearning < lowestMIDIChannelSeenWhileLearning) {
 					learnedThing->device = fromDevice;
 					learnedThing->channelOrZone = channel;
+					currentSong->midiInputRoutingChanged();
 					((Instrument*)currentSong->currentClip->output)->beenEdited(false);
 				}
 			}
@@ -1295,6 +1300,7 @@ void View::cycleThroughReverbPresets() {
 
 	AudioEngine::reverb.setroomsize((float)presetReverbRoomSize[newPreset] / 50);
 	AudioEngine::reverb.setdamp((float)presetReverbDampening[newPreset] / 50);
+	AudioEngine::mustUpdateReverbParamsBeforeNextRender = true;
 
 	display->displayPopup(deluge::l10n::get(presetReverbNames[newPreset]));
 }
@@ -1901,6 +1907,51 @@ void View::instrumentChanged(ModelStackWithTimelineCounter* modelStack, Instrume
 	    modelStack->getTimelineCounter()); // Do a redraw. Obviously the Clip is the same
 }
 
+// A track taking this much of the render time is as red as the overlay gets
+constexpr int32_t kRenderLoadOverlayFullPermille = 333;
+
+// Called from the main loop a few times a second. Keeps every Output's render load up to date - even while the overlay's
+// off, so it's right as soon as it's turned on - and redraws session or arranger view if any has changed enough to show
+void View::renderLoadOverlayRoutine() {
+	uint32_t numSamples = AudioEngine::audioSampleTimer - timeRenderLoadsLastSampled;
+	timeRenderLoadsLastSampled = AudioEngine::audioSampleTimer;
+
+	if (!currentSong || !currentSong->updateOutputRenderLoads(numSamples)) {
+		return;
+	}
+	if (runtimeFeatureSettings.get(RuntimeFeatureSettingType::TrackCpuOverlay) != RuntimeFeatureStateToggle::On) {
+		return;
+	}
+	UI* currentUI = getCurrentUI();
+	if (currentUI == &sessionView || currentUI == &arrangerView) {
+		uiNeedsRendering(currentUI, 0xFFFFFFFF, 0);
+	}
+}
+
+// Blends the lit ones of numSquares pads towards red, by how much of the render time output's been taking, for the
+// Track CPU Overlay community setting. Each pad keeps its brightness, and at least a quarter of its own colour
+void View::addRenderLoadOverlay(Output* output, uint8_t* image, int32_t numSquares) {
+	if (runtimeFeatureSettings.get(RuntimeFeatureSettingType::TrackCpuOverlay) != RuntimeFeatureStateToggle::On) {
+		return;
+	}
+
+	int32_t strength = std::min<int32_t>(output->renderLoadPermille, kRenderLoadOverlayFullPermille) * 192
+	                   / kRenderLoadOverlayFullPermille;
+	if (!strength) {
+		return;
+	}
+
+	for (uint8_t* square = image; square < image + numSquares * 3; square += 3) {
+		int32_t brightness = std::max({square[0], square[1], square[2]});
+		if (!brightness) {
+			continue;
+		}
+		square[0] = (square[0] * (256 - strength) + brightness * strength) >> 8;
+		square[1] = (square[1] * (256 - strength)) >> 8;
+		square[2] = (square[2] * (256 - strength)) >> 8;
+	}
+}
+
 void View::getClipMuteSquareColour(Clip* clip, uint8_t thisColour[], bool dimInactivePads, bool allowMIDIFlash) {
 
 	if (currentUIMode == UI_MODE_VIEWING_RECORD_ARMING && clip && clip->armedForRecording) {
@@ -87,6 +87,8 @@ public:
 	void endMIDILearn();
 	void getClipMuteSquareColour(Clip* clip, uint8_t thisColour[], bool dimInactivePads = false,
 	                             bool allowMIDIFlash = true);
+	void addRenderLoadOverlay(Output* output, uint8_t* image, int32_t numSquares);
+	void renderLoadOverlayRoutine();
 	ActionResult clipStatusPadAction(Clip* clip, bool on, int32_t yDisplayIfInSessionView = -1);
 	void flashPlayEnable();
 	void flashPlayDisable();
@@ -114,6 +116,7 @@ public:
 	bool blinkOn;
 
 	uint32_t timeSaveButtonPressed;
+	uint32_t timeRenderLoadsLastSampled = 0;
 
 	int32_t modNoteRowId;
 	uint32_t modPos;
@@ -26,6 +26,7 @@
 #include "io/debug/print.h"
 #include "model/instrument/instrument.h"
 #include "model/sample/sample.h"
+#include "model/sample/sample_peak_pyramid.h"
 #include "model/sample/sample_recorder.h"
 #include "model/voice/voice_sample.h"
 #include "processing/engines/audio_engine.h"
@@ -296,6 +297,21 @@ bool WaveformRenderer::findPeaksPerCol(Sample* sample, int64_t xScrollSamples, u
 			continue;
 		}
 
+		// Zoomed out this far, the Sample's peak pyramid can give the whole column's min and max without reading any
+		// audio. If it hasn't got one yet, ask for one to be built in the background, and read the audio for now
+		if (!recorder && xZoomSamples >= (1 << kPeakPyramidLevelMagnitudes[0])) {
+			if (sample->peakPyramid) {
+				if (sample->peakPyramid->getPeaks(colStartSample, colEndSample,
+				                                  std::min<uint64_t>(xZoomSamples, 2147483647), &data->minPerCol[col],
+				                                  &data->maxPerCol[col])) {
+					continue;
+				}
+			}
+			else if (!sample->peakPyramidRequested) {
+				sample->peakPyramidRequested = audioFileManager.requestPeakPyramidBuild(sample);
+			}
+		}
+
 		int32_t colStartByte =
 		    colStartSample * sample->numChannels * sample->byteDepth + sample->audioDataStartPosBytes;
 		int32_t colEndByte = colEndSample * sample->numChannels * sample->byteDepth + sample->audioDataStartPosBytes;
@@ -0,0 +1,176 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "hid/display/load_meter.h"
+#include "gui/ui/ui.h"
+#include "hid/display/display.h"
+#include "hid/display/oled.h"
+#include "hid/display/seven_segment.h"
+#include "io/debug/cpu_profiler.h"
+#include "memory/general_memory_allocator.h"
+#include "model/settings/runtime_feature_settings.h"
+#include "processing/engines/audio_engine.h"
+#include <algorithm>
+
+namespace deluge::hid::display {
+
+LoadMeter loadMeter{};
+
+constexpr uint32_t kSampleInterval = kSampleRate / 4;
+constexpr int32_t kSamplesPerMemorySample = 4;
+
+// Each bar is 2 pixels high, with a pixel's gap between them, filling the 8 pixels below the top of the title text
+constexpr int32_t kBarLength = 16;
+constexpr int32_t kMeterMinX = OLED_MAIN_WIDTH_PIXELS - kBarLength;
+constexpr int32_t kNumBars = 3;
+
+// How bad the worst figure has to be to light each successive 7SEG dot, from the left
+constexpr int32_t kDotThresholds[kNumericDisplayLength] = {600, 750, 900, 1000};
+
+bool LoadMeter::isEnabled() {
+	return runtimeFeatureSettings.get(RuntimeFeatureSettingType::LoadMeter) == RuntimeFeatureStateToggle::On;
+}
+
+// Goes straight up to a new peak, but takes a couple of seconds to fall away from one, so a brief spike doesn't just
+// flicker past
+int32_t LoadMeter::smooth(int32_t smoothed, int32_t newValue) {
+	if (newValue >= smoothed) {
+		return newValue;
+	}
+	return (smoothed * 3 + newValue) >> 2;
+}
+
+int32_t LoadMeter::getBarLength(int32_t permille) {
+	return std::clamp<int32_t>((permille * kBarLength + 500) / 1000, 0, kBarLength);
+}
+
+int32_t LoadMeter::getNumDots() {
+	int32_t worst = std::max({cpuPermille, voicePermille, memoryPermille});
+	int32_t numDots = 0;
+	while (numDots < kNumericDisplayLength && worst >= kDotThresholds[numDots]) {
+		numDots++;
+	}
+	return numDots;
+}
+
+void LoadMeter::routine() {
+	bool enabled = isEnabled();
+	if (!enabled) {
+		if (wasEnabled) {
+			// Get rid of what's still showing
+			wasEnabled = false;
+			if (::display->haveOLED()) {
+				renderUIsForOled();
+			}
+			else {
+				static_cast<SevenSegment*>(::display)->render();
+			}
+		}
+		return;
+	}
+
+	if (wasEnabled && (int32_t)(AudioEngine::audioSampleTimer - timeLastSampled) < (int32_t)kSampleInterval) {
+		return;
+	}
+	timeLastSampled = AudioEngine::audioSampleTimer;
+
+	int32_t barsBefore[kNumBars] = {getBarLength(cpuPermille), getBarLength(voicePermille),
+	                                getBarLength(memoryPermille)};
+	int32_t dotsBefore = getNumDots();
+
+	// Render time against what it had, over the profiler's last window. If the engine's already got dire enough to be
+	// thinking about culling, that's as full as it gets
+	int32_t newCpuPermille = Debug::cpuProfiler.getLoadPermille(Debug::ProfileStage::TOTAL);
+	if (AudioEngine::cpuDireness) {
+		newCpuPermille = std::max<int32_t>(newCpuPermille, 1000);
+	}
+	cpuPermille = smooth(cpuPermille, newCpuPermille);
+
+	int32_t newVoicePermille = AudioEngine::getVoiceBudgetPermille();
+	voicePermille = (newVoicePermille < 0) ? -1 : smooth(std::max<int32_t>(voicePermille, 0), newVoicePermille);
+
+	if (--samplesUntilMemory <= 0) {
+		samplesUntilMemory = kSamplesPerMemorySample;
+
+		MemoryRegion& region = GeneralMemoryAllocator::get().regions[MEMORY_REGION_SDRAM];
+		MemoryRegionTelemetry telemetry;
+		region.getTelemetry(&telemetry);
+		uint64_t headroom = telemetry.freeBytes;
+		for (int32_t q = 0; q < NUM_STEALABLE_QUEUES; q++) {
+			headroom += telemetry.stealableBytes[q];
+		}
+		uint32_t regionSize = region.end - region.start;
+		headroom = std::min<uint64_t>(headroom, regionSize);
+		memoryPermille = 1000 - (int32_t)((headroom * 1000) / regionSize);
+	}
+
+	bool changed = !wasEnabled || getNumDots() != dotsBefore || getBarLength(cpuPermille) != barsBefore[0]
+	               || getBarLength(voicePermille) != barsBefore[1] || getBarLength(memoryPermille) != barsBefore[2];
+	wasEnabled = true;
+	if (!changed) {
+		return;
+	}
+
+	if (::display->haveOLED()) {
+		// The meter gets drawn onto whatever's already there on the way out
+		OLED::sendMainImage();
+	}
+	else {
+		static_cast<SevenSegment*>(::display)->render();
+	}
+}
+
+void LoadMeter::drawOnOLED(uint8_t image[][OLED_MAIN_WIDTH_PIXELS]) {
+	if (!wasEnabled) {
+		return;
+	}
+
+	int32_t minY = OLED_MAIN_TOPMOST_PIXEL + ((OLED_MAIN_HEIGHT_PIXELS == 64) ? 0 : 1) + 1;
+
+	// Leave a pixel's gap to the left, in case a long title runs up to us
+	OLED::clearAreaExact(kMeterMinX - 2, minY - 1, OLED_MAIN_WIDTH_PIXELS - 1, minY + kNumBars * 3 - 1, image);
+
+	int32_t const barLengths[kNumBars] = {getBarLength(cpuPermille), getBarLength(voicePermille),
+	                                      getBarLength(memoryPermille)};
+	for (int32_t b = 0; b < kNumBars; b++) {
+		int32_t y = minY + b * 3;
+		for (int32_t x = 0; x < kBarLength; x++) {
+			int32_t pixelX = kMeterMinX + x;
+			if (x < barLengths[b]) {
+				image[y >> 3][pixelX] |= 1 << (y & 7);
+				image[(y + 1) >> 3][pixelX] |= 1 << ((y + 1) & 7);
+			}
+			// Dotted along the bottom where it's empty, so the scale's visible. Full scale gets a solid end
+			else if (!(x & 3) || x == kBarLength - 1) {
+				image[(y + 1) >> 3][pixelX] |= 1 << ((y + 1) & 7);
+			}
+		}
+	}
+}
+
+void LoadMeter::addDotsTo7SEG(uint8_t* segments) {
+	if (!wasEnabled) {
+		return;
+	}
+
+	int32_t numDots = getNumDots();
+	for (int32_t i = 0; i < numDots; i++) {
+		segments[i] |= 0b10000000;
+	}
+}
+
+} // namespace deluge::hid::display
@@ -0,0 +1,63 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "definitions_cxx.hpp"
+#include <cstdint>
+
+namespace deluge::hid::display {
+
+/// The optional always-on load indicator (the Load Meter community setting), for seeing how close we are to culling
+/// before it happens. Keeps three figures, each in tenths of a percent of where trouble starts: the audio routine's
+/// render time against the time it had, the active voices' cost against the budget solicitVoice() culls at, and how
+/// much of SDRAM is neither free nor stealable. On OLED these are three little bars at the right of the title bar; on
+/// 7SEG, the worst of them lights up to four dots.
+///
+/// All the figures are ones already being worked out elsewhere, and they're only looked at a few times a second (the
+/// memory one, which has to walk the stealable queues, just once a second), so the meter costs next to nothing.
+class LoadMeter {
+public:
+	/// Call from the main loop. Only does anything when the meter's on and it's time for a new sample, and only
+	/// redraws if that's changed what's shown
+	void routine();
+
+	/// Draws the meter into the top right of image, if it's on. Called on every OLED image on its way out
+	void drawOnOLED(uint8_t image[][OLED_MAIN_WIDTH_PIXELS]);
+
+	/// Lights the meter's dots in segments, if it's on. Called on every 7SEG image on its way out
+	void addDotsTo7SEG(uint8_t* segments);
+
+	bool isEnabled();
+
+private:
+	int32_t getNumDots();
+	int32_t getBarLength(int32_t permille);
+	static int32_t smooth(int32_t smoothed, int32_t newValue);
+
+	int32_t cpuPermille = 0;
+	int32_t voicePermille = -1; // -1 means there's no voice budget yet, because we've never had to cull
+	int32_t memoryPermille = 0;
+
+	uint32_t timeLastSampled = 0;
+	int32_t samplesUntilMemory = 0;
+	bool wasEnabled = false;
+};
+
+extern LoadMeter loadMeter;
+
+} // namespace deluge::hid::display
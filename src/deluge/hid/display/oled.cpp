@@ -22,9 +22,11 @@
 #include "drivers/pic/pic.h"
 #include "gui/ui_timer_manager.h"
 #include "hid/display/display.h"
+#include "hid/display/load_meter.h"
 #include "hid/display/oled.h"
 #include "hid/hid_sysex.h"
 #include "processing/engines/audio_engine.h"
+#include "storage/storage_manager.h"
 #include "util/d_string.h"
 #include <string.h>
 #include <string_view>
@@ -52,6 +54,11 @@ uint8_t OLED::oledMainPopupImage[OLED_MAIN_HEIGHT_PIXELS >> 3][OLED_MAIN_WIDTH_P
 
 uint8_t (*OLED::oledCurrentImage)[OLED_MAIN_WIDTH_PIXELS] __attribute__((aligned(CACHE_LINE_SIZE))) = oledMainImage;
 
+// What we last actually sent to the OLED, so an unchanged image needn't be sent again
+uint8_t oledLastSentImage[OLED_MAIN_HEIGHT_PIXELS >> 3][OLED_MAIN_WIDTH_PIXELS]
+    __attribute__((aligned(alignof(int32_t))));
+bool oledLastSentImageValid = false;
+
 int32_t workingAnimationCount;
 char const* workingAnimationText; // NULL means animation not active
 
@@ -401,6 +408,77 @@ void OLED::drawStringCentredShrinkIfNecessary(char const* string, int32_t pixelY
 	drawStringFixedLength(string, length, pixelX, pixelY, image, imageWidth, textWidth, textHeight);
 }
 
+// Each font's glyphs, decoded to one word per column with the top pixel in bit 0, so a whole column can be shifted
+// into place and ORed into the image at once, rather than pieced together a byte at a time for each row of the display.
+// Filled in the first time each font gets used.
+constexpr int32_t kNumFonts = 4;
+constexpr int32_t kNumGlyphs = '~' - 26 - 0x20 + 1; // Lowercase chars have been snipped out of the tables
+constexpr int32_t kGlyphCacheNumColumns = 2560;     // Between all the fonts. They need about 2400
+
+uint32_t glyphCacheColumns[kGlyphCacheNumColumns];
+int32_t glyphCacheNumColumnsUsed = 0;
+uint32_t const* glyphCacheFontColumns[kNumFonts] = {nullptr};
+
+// Returns where the font's columns start, indexed by glyph_index / bytesPerCol, or nullptr if they don't fit
+static uint32_t const* getGlyphColumns(int32_t fontIndex, lv_font_glyph_dsc_t const* descriptors, uint8_t const* font,
+                                       int32_t bytesPerCol) {
+	if (glyphCacheFontColumns[fontIndex]) {
+		return glyphCacheFontColumns[fontIndex];
+	}
+
+	int32_t numColumns = 0;
+	for (int32_t g = 0; g < kNumGlyphs; g++) {
+		numColumns = std::max<int32_t>(numColumns, descriptors[g].glyph_index / bytesPerCol + descriptors[g].w_px);
+	}
+	if (glyphCacheNumColumnsUsed + numColumns > kGlyphCacheNumColumns) {
+		return nullptr;
+	}
+
+	uint32_t* columns = &glyphCacheColumns[glyphCacheNumColumnsUsed];
+	for (int32_t g = 0; g < kNumGlyphs; g++) {
+		uint8_t const* graphicPos = &font[descriptors[g].glyph_index];
+		uint32_t* columnPos = &columns[descriptors[g].glyph_index / bytesPerCol];
+		for (int32_t x = 0; x < descriptors[g].w_px; x++) {
+			uint32_t column = 0;
+			for (int32_t b = 0; b < bytesPerCol; b++) {
+				column |= (uint32_t)*(graphicPos++) << (b << 3);
+			}
+			*(columnPos++) = column;
+		}
+	}
+
+	glyphCacheNumColumnsUsed += numColumns;
+	glyphCacheFontColumns[fontIndex] = columns;
+	return columns;
+}
+
+// Like drawGraphicMultiLine(), but taking one word per column - so up to 32 pixels tall, shifted by up to 7 - and going
+// a column at a time. Draws every display row which the height touches, as that does.
+void OLED::drawGraphicColumns(uint32_t const* columns, int32_t startX, int32_t startY, int32_t width, uint8_t* image,
+                              int32_t height) {
+	if (width > OLED_MAIN_WIDTH_PIXELS - startX) {
+		width = OLED_MAIN_WIDTH_PIXELS - startX;
+	}
+
+	int32_t firstRowOnDisplay = startY >> 3;
+	int32_t lastRowOnDisplay = std::min((startY + height - 1) >> 3, (OLED_MAIN_HEIGHT_PIXELS >> 3) - 1);
+	int32_t numRows = lastRowOnDisplay - firstRowOnDisplay + 1;
+	int32_t yOffset = startY & 7;
+
+	uint8_t* __restrict__ currentPos = &image[firstRowOnDisplay * OLED_MAIN_WIDTH_PIXELS + startX];
+	uint32_t const* const endColumn = columns + width;
+
+	while (columns < endColumn) {
+		uint32_t data = *(columns++) << yOffset;
+		uint8_t* __restrict__ rowPos = currentPos++;
+		for (int32_t r = 0; r < numRows && data; r++) {
+			*rowPos |= data;
+			data >>= 8;
+			rowPos += OLED_MAIN_WIDTH_PIXELS;
+		}
+	}
+}
+
 #define DO_CHARACTER_SCALING 0
 
 void OLED::drawChar(uint8_t theChar, int32_t pixelX, int32_t pixelY, uint8_t* image, int32_t imageWidth,
@@ -424,9 +502,10 @@ void OLED::drawChar(uint8_t theChar, int32_t pixelX, int32_t pixelY, uint8_t* im
 		return;
 	}
 
-	lv_font_glyph_dsc_t const* descriptor;
+	lv_font_glyph_dsc_t const* descriptors;
 	uint8_t const* font;
 	int32_t fontNativeHeight;
+	int32_t fontIndex;
 
 	switch (textHeight) {
 	case 9:
@@ -436,31 +515,35 @@ void OLED::drawChar(uint8_t theChar, int32_t pixelX, int32_t pixelY, uint8_t* im
 		[[fallthrough]];
 	case 8:
 		textHeight = 7;
-		descriptor = font_apple_desc;
+		descriptors = font_apple_desc;
 		font = font_apple;
 		fontNativeHeight = 8;
+		fontIndex = 0;
 		break;
 	case 10:
 		textHeight = 9;
-		descriptor = font_metric_bold_9px_desc;
+		descriptors = font_metric_bold_9px_desc;
 		font = font_metric_bold_9px;
 		fontNativeHeight = 9;
+		fontIndex = 1;
 		break;
 	case 13:
-		descriptor = font_metric_bold_13px_desc;
+		descriptors = font_metric_bold_13px_desc;
 		font = font_metric_bold_13px;
 		fontNativeHeight = 13;
+		fontIndex = 2;
 		break;
 	case 20:
 		[[fallthrough]];
 	default:
 		fontNativeHeight = 20;
-		descriptor = font_metric_bold_20px_desc;
+		descriptors = font_metric_bold_20px_desc;
 		font = font_metric_bold_20px;
+		fontIndex = 3;
 		break;
 	}
 
-	descriptor += charIndex;
+	lv_font_glyph_dsc_t const* descriptor = descriptors + charIndex;
 
 #if DO_CHARACTER_SCALING
 	int32_t scaledFontWidth =
@@ -478,8 +561,15 @@ void OLED::drawChar(uint8_t theChar, int32_t pixelX, int32_t pixelY, uint8_t* im
 	int32_t bytesPerCol = ((textHeight - 1) >> 3) + 1;
 
 	int32_t textWidth = descriptor->w_px - scrollPos;
-	drawGraphicMultiLine(&font[descriptor->glyph_index + scrollPos * bytesPerCol], pixelX, pixelY, textWidth, image,
-	                     textHeight, bytesPerCol);
+	uint32_t const* columns = getGlyphColumns(fontIndex, descriptors, font, bytesPerCol);
+	if (columns) {
+		drawGraphicColumns(&columns[descriptor->glyph_index / bytesPerCol + scrollPos], pixelX, pixelY, textWidth,
+		                   image, textHeight);
+	}
+	else {
+		drawGraphicMultiLine(&font[descriptor->glyph_index + scrollPos * bytesPerCol], pixelX, pixelY, textWidth,
+		                     image, textHeight, bytesPerCol);
+	}
 }
 
 void OLED::drawScreenTitle(std::string_view title) {
@@ -699,6 +789,7 @@ void copyBackgroundAroundForeground(uint8_t backgroundImage[][OLED_MAIN_WIDTH_PI
 
 void OLED::sendMainImage() {
 
+	loadMeter.drawOnOLED(oledMainImage);
 	oledCurrentImage = oledMainImage;
 
 	if (numConsoleItems) {
@@ -719,6 +810,17 @@ void OLED::sendMainImage() {
 	uartPrintNumber((uint16_t)(renderStopTime - renderStartTime));
 #endif
 
+	// Lots of redraws - e.g. every step of a knob turn that doesn't change the displayed value, or a blink or scroll
+	// that's redrawn the same thing - end up with the exact same image. Each send means waiting on the PIC to select
+	// and deselect the OLED, and a cache flush and DMA transfer of the whole image, so skip those when nothing's
+	// changed. The OLED only takes whole-image transfers from us (we can't change its address window without the PIC
+	// switching it to command mode), so it's all or nothing.
+	if (oledLastSentImageValid && !memcmp(oledLastSentImage, oledCurrentImage[0], sizeof(oledLastSentImage))) {
+		return;
+	}
+	memcpy(oledLastSentImage, oledCurrentImage[0], sizeof(oledLastSentImage));
+	oledLastSentImageValid = true;
+
 	enqueueSPITransfer(0, oledCurrentImage[0]);
 	HIDSysex::sendDisplayIfChanged();
 }
@@ -885,6 +987,15 @@ void updateWorkingAnimation() {
 	}
 
 	error = textNow.concatenate(buffer);
+
+	// If it's a file being read that we're waiting on, say how far through it's got
+	int32_t progress = storageManager.getXMLReadProgressPermille();
+	if (progress >= 0) {
+		intToString(progress / 10, buffer, 1);
+		textNow.concatenate(" ");
+		textNow.concatenate(buffer);
+		textNow.concatenate("%");
+	}
 	OLED::popupText(textNow.get(), true, DisplayPopupType::GENERAL);
 }
 
@@ -1293,6 +1404,7 @@ void OLED::freezeWithError(char const* text) {
 	}
 	oledWaitingForMessage = 256;
 	spiTransferQueueCurrentlySending = false;
+	oledLastSentImageValid = false; // We sent the error message behind sendMainImage()'s back
 
 	clearMainImage();
 	OLED::popupText("Operation resumed. Save to new file then reboot.", false, DisplayPopupType::GENERAL);
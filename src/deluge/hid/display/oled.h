@@ -59,6 +59,8 @@ public:
 	                     int32_t endX = OLED_MAIN_WIDTH_PIXELS);
 	static void drawGraphicMultiLine(uint8_t const* graphic, int32_t startX, int32_t startY, int32_t width,
 	                                 uint8_t* image, int32_t height = 8, int32_t numBytesTall = 1);
+	static void drawGraphicColumns(uint32_t const* columns, int32_t startX, int32_t startY, int32_t width,
+	                               uint8_t* image, int32_t height);
 	static void drawScreenTitle(std::string_view text);
 
 	static void setupBlink(int32_t minX, int32_t width, int32_t minY, int32_t maxY, bool shouldBlinkImmediately);
@@ -19,6 +19,7 @@
 #include "definitions_cxx.hpp"
 #include "drivers/pic/pic.h"
 #include "gui/ui_timer_manager.h"
+#include "hid/display/load_meter.h"
 #include "hid/display/numeric_layer/numeric_layer_basic_text.h"
 #include "hid/display/numeric_layer/numeric_layer_loading_animation.h"
 #include "hid/display/numeric_layer/numeric_layer_scroll_transition.h"
@@ -533,6 +534,7 @@ void SevenSegment::render() {
 
 	std::array<uint8_t, kNumericDisplayLength> segments;
 	layer->render(segments.data());
+	loadMeter.addDotsTo7SEG(segments.data());
 	lastDisplay_ = segments;
 
 	PIC::update7SEG(segments);
@@ -27,6 +27,7 @@
 #include "model/settings/runtime_feature_settings.h"
 #include "playback/playback_handler.h"
 #include "processing/engines/audio_engine.h"
+#include "processing/engines/engine_command_queue.h"
 #include "util/functions.h"
 #include <new>
 
@@ -166,6 +167,9 @@ checkResult:
 	}
 
 	if (!inCardRoutine || currentUIMode == UI_MODE_LOADING_SONG_UNESSENTIAL_SAMPLES_ARMED) {
+		// Turns from previous calls only get acted on once the audio's moved on a block
+		engineCommandQueue.applyPending();
+
 		// Mod knobs
 		for (int32_t e = 0; e < 2; e++) {
 
@@ -183,7 +187,8 @@ checkResult:
 
 					// Do it, only if
 					if (encoders[ENCODER_MOD_0 - e].encPos + modEncoderInitialTurnDirection[e] != 0) {
-						getCurrentUI()->modEncoderAction(e, encoders[ENCODER_MOD_0 - e].encPos);
+						engineCommandQueue.push(
+						    {EngineCommandType::MOD_ENCODER, (uint8_t)e, encoders[ENCODER_MOD_0 - e].encPos});
 						modEncoderInitialTurnDirection[e] = 0;
 					}
 
@@ -111,6 +111,18 @@ uint32_t transitionStartTime;
 uint32_t greyoutCols;
 uint32_t greyoutRows;
 
+// What we last sent the PIC for each pair of columns - its smallest unit of update - so redraws needn't resend pairs
+// that haven't changed. Bit n of lastSentColumnPairsValid says whether pair n is trustworthy. Anything which makes the
+// PIC change its own copy (scrolling, flashing) has to call forgetSentColours().
+std::array<Colour, kDisplayHeight * 2> lastSentColumnPairs[(kDisplayWidth + kSideBarWidth) >> 1];
+uint32_t lastSentColumnPairsValid = 0;
+
+// How each row of a zoom animation gets rendered, worked out from the in- and out-images on its first frame. Either
+// kZoomRowRender, kZoomRowBlank if both are black so it stays black throughout, or the number of an earlier row whose
+// images and pin square are the same, so it'll always come out the same as that
+int8_t zoomRowSources[kDisplayHeight];
+bool zoomRowSourcesValid = false;
+
 void init() {
 	memset(slowFlashSquares, 255, sizeof(slowFlashSquares));
 }
@@ -251,7 +263,21 @@ void sortLedsForCol(int32_t x) {
 	for (size_t y = 0; y < kDisplayHeight; y++) {
 		doubleColumn[total++] = prepareColour(x + 1, y, Colour::fromArray(image[y][x + 1]));
 	}
-	PIC::setColourForTwoColumns((x >> 1), doubleColumn);
+
+	int32_t pair = x >> 1;
+	std::array<Colour, kDisplayHeight * 2>& lastSent = lastSentColumnPairs[pair];
+	if ((lastSentColumnPairsValid & (1 << pair))
+	    && !memcmp(lastSent.data(), doubleColumn.data(), sizeof(Colour) * kDisplayHeight * 2)) {
+		return;
+	}
+	lastSent = doubleColumn;
+	lastSentColumnPairsValid |= (1 << pair);
+
+	PIC::setColourForTwoColumns(pair, doubleColumn);
+}
+
+void forgetSentColours() {
+	lastSentColumnPairsValid = 0;
 }
 
 const uint8_t flashColours[3][3] = {
@@ -1085,19 +1111,61 @@ void renderZoom() {
 	    interpolateTable(fine, 10, expTableSmall); // This could be changed to run on a bigger number of bits in input
 	inImageTimesBiggerThanNormal = increaseMagnitude(inImageTimesBiggerThanNormal, coarse - 14);
 
+	if (!zoomRowSourcesValid) {
+		workOutZoomRowSources();
+		zoomRowSourcesValid = true;
+	}
+
 	renderZoomWithProgress(inImageTimesBiggerThanNormal, sineValue, &imageStore[0][0][0],
 	                       &imageStore[kDisplayHeight][0][0], 0, 0, kDisplayWidth, kDisplayWidth,
-	                       kDisplayWidth + kSideBarWidth, kDisplayWidth + kSideBarWidth);
+	                       kDisplayWidth + kSideBarWidth, kDisplayWidth + kSideBarWidth, zoomRowSources);
 
 	sendOutMainPadColours();
 	uiTimerManager.setTimer(TIMER_MATRIX_DRIVER, UI_MS_PER_REFRESH);
 }
 
-// inImageFadeAmount is how much of the in-image we'll see, out of 65536
+// The in- and out-images stay the same for the whole of a zoom, so rows which will come out black, or the same as
+// another row, on every frame can be found just the once
+void workOutZoomRowSources() {
+	for (int32_t yDisplay = 0; yDisplay < kDisplayHeight; yDisplay++) {
+		zoomRowSources[yDisplay] = kZoomRowRender;
+		if (!transitionTakingPlaceOnRow[yDisplay]) {
+			continue;
+		}
+
+		uint8_t const* inRow = imageStore[yDisplay][0];
+		uint8_t const* outRow = imageStore[kDisplayHeight + yDisplay][0];
+
+		bool anyLit = false;
+		for (int32_t i = 0; i < kDisplayWidth * 3; i++) {
+			if (inRow[i] | outRow[i]) {
+				anyLit = true;
+				break;
+			}
+		}
+		if (!anyLit) {
+			zoomRowSources[yDisplay] = kZoomRowBlank;
+			continue;
+		}
+
+		for (int32_t otherY = 0; otherY < yDisplay; otherY++) {
+			if (zoomRowSources[otherY] == kZoomRowRender && zoomPinSquare[otherY] == zoomPinSquare[yDisplay]
+			    && !memcmp(imageStore[otherY][0], inRow, kDisplayWidth * 3)
+			    && !memcmp(imageStore[kDisplayHeight + otherY][0], outRow, kDisplayWidth * 3)) {
+				zoomRowSources[yDisplay] = otherY;
+				break;
+			}
+		}
+	}
+}
+
+// inImageFadeAmount is how much of the in-image we'll see, out of 65536. rowSources, if supplied, is as worked out by
+// workOutZoomRowSources()
 void renderZoomWithProgress(int32_t inImageTimesBiggerThanNative, uint32_t inImageFadeAmount,
                             uint8_t* __restrict__ innerImage, uint8_t* __restrict__ outerImage,
                             int32_t innerImageLeftEdge, int32_t outerImageLeftEdge, int32_t innerImageRightEdge,
-                            int32_t outerImageRightEdge, int32_t innerImageTotalWidth, int32_t outerImageTotalWidth) {
+                            int32_t outerImageRightEdge, int32_t innerImageTotalWidth, int32_t outerImageTotalWidth,
+                            int8_t const* rowSources) {
 
 	uint32_t outImageTimesBiggerThanNative = inImageTimesBiggerThanNative << zoomMagnitude;
 
@@ -1121,7 +1189,16 @@ void renderZoomWithProgress(int32_t inImageTimesBiggerThanNative, uint32_t inIma
 
 	// Go through each row
 	for (int32_t yDisplay = 0; yDisplay < kDisplayHeight; yDisplay++) {
-		if (transitionTakingPlaceOnRow[yDisplay]) {
+		if (transitionTakingPlaceOnRow[yDisplay] && rowSources && rowSources[yDisplay] != kZoomRowRender) {
+			if (rowSources[yDisplay] == kZoomRowBlank) {
+				memset(PadLEDs::image[yDisplay], 0, kDisplayWidth * 3);
+			}
+			else {
+				memcpy(PadLEDs::image[yDisplay], PadLEDs::image[rowSources[yDisplay]], kDisplayWidth * 3);
+			}
+		}
+
+		else if (transitionTakingPlaceOnRow[yDisplay]) {
 
 			// If this row doesn't have the same pin-square as the last, we have to calculate some stuff. Otherwise, this can be reused.
 			if (zoomPinSquare[yDisplay] != lastZoomPinSquareDone) {
@@ -1256,19 +1333,19 @@ void horizontal::renderScroll() {
 	int32_t copyCol = (scrollDirection > 0) ? squaresScrolled - 1 : areaToScroll - squaresScrolled;
 	int32_t startSquare = (scrollDirection > 0) ? 0 : areaToScroll - 1;
 	int32_t endSquare = (scrollDirection > 0) ? areaToScroll - 1 : 0;
+	int32_t leftmostSquareMoving = std::min(startSquare, endSquare);
 	for (int32_t row = 0; row < kDisplayHeight; row++) {
 		if (transitionTakingPlaceOnRow[row]) {
-			for (int32_t colour = 0; colour < 3; colour++) {
-				for (int32_t x = startSquare; x != endSquare; x += scrollDirection) {
-					PadLEDs::image[row][x][colour] = PadLEDs::image[row][x + scrollDirection][colour];
-				}
-				// And, bring in a col from the temp image
-				if (scrollingIntoNothing) {
-					PadLEDs::image[row][endSquare][colour] = 0;
-				}
-				else {
-					PadLEDs::image[row][endSquare][colour] = imageStore[row][copyCol][colour];
-				}
+			// Shift the row along in one go
+			memmove(PadLEDs::image[row][leftmostSquareMoving + (scrollDirection < 0)],
+			        PadLEDs::image[row][leftmostSquareMoving + (scrollDirection > 0)], (areaToScroll - 1) * 3);
+
+			// And, bring in a col from the temp image
+			if (scrollingIntoNothing) {
+				memset(PadLEDs::image[row][endSquare], 0, 3);
+			}
+			else {
+				memcpy(PadLEDs::image[row][endSquare], imageStore[row][copyCol], 3);
 			}
 
 			PIC::sendScrollRow(row, prepareColour(endSquare, row, Colour::fromArray(image[row][endSquare])));
@@ -1277,6 +1354,7 @@ void horizontal::renderScroll() {
 
 	PIC::doneSendingRows();
 	PIC::flush();
+	forgetSentColours();
 
 	if (squaresScrolled >= areaToScroll) {
 		getCurrentUI()->scrollFinished();
@@ -1301,6 +1379,7 @@ void horizontal::setupScroll(int8_t thisScrollDirection, uint8_t thisAreaToScrol
 		flags |= 2;
 	}
 	PIC::setupHorizontalScroll(flags);
+	forgetSentColours();
 	renderScroll();
 }
 
@@ -1330,6 +1409,7 @@ void vertical::renderScroll() {
 	}
 	PIC::doVerticalScroll(scrollDirection > 0, colours);
 	PIC::flush();
+	forgetSentColours();
 }
 
 void vertical::setupScroll(int8_t thisScrollDirection, bool scrollIntoNothing) {
@@ -1355,6 +1435,7 @@ void renderFade(int32_t progress) {
 
 void recordTransitionBegin(uint32_t newTransitionLength) {
 	clearPendingUIRendering();
+	zoomRowSourcesValid = false;
 	transitionLength = newTransitionLength * 44;
 	transitionStartTime = AudioEngine::audioSampleTimer;
 }
@@ -59,6 +59,7 @@ extern int8_t zoomMagnitude;
 
 void init();
 void sortLedsForCol(int32_t x);
+void forgetSentColours();
 void writeToSideBar(uint8_t sideBarX, uint8_t yDisplay, uint8_t red, uint8_t green, uint8_t blue);
 void renderInstrumentClipCollapseAnimation(int32_t xStart, int32_t xEnd, int32_t progress);
 void renderClipExpandOrCollapse();
@@ -80,11 +81,15 @@ void changeRefreshTime(int32_t offset);
 void changeDimmerInterval(int32_t offset);
 void setDimmerInterval(int32_t newInterval);
 
+constexpr int8_t kZoomRowRender = -1;
+constexpr int8_t kZoomRowBlank = -2;
+
 void renderZoom();
+void workOutZoomRowSources();
 void renderZoomWithProgress(int32_t inImageTimesBiggerThanNative, uint32_t inImageFadeAmount, uint8_t* innerImage,
                             uint8_t* outerImage, int32_t innerImageLeftEdge, int32_t outerImageLeftEdge,
                             int32_t innerImageRightEdge, int32_t outerImageRightEdge, int32_t innerImageTotalWidth,
-                            int32_t outerImageTotalWidth);
+                            int32_t outerImageTotalWidth, int8_t const* rowSources = nullptr);
 
 namespace horizontal {
 void setupScroll(int8_t thisScrollDirection, uint8_t thisAreaToScroll, bool scrollIntoNothing = false,
@@ -118,6 +123,7 @@ void setGreyoutAmount(float newAmount);
 
 static inline void flashMainPad(int32_t x, int32_t y, int32_t colour = 0) {
 	auto idx = y + (x * kDisplayHeight);
+	forgetSentColours();
 	if (colour > 0) {
 		PIC::flashMainPadWithColourIdx(idx, colour);
 		return;
@@ -0,0 +1,55 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "io/debug/boot_profile.h"
+#include "io/debug/print.h"
+
+namespace Debug {
+
+namespace {
+struct BootMilestone {
+	char const* name;
+	uint32_t cycles;
+};
+
+BootMilestone milestones[kMaxNumBootMilestones];
+int32_t numMilestones = 0;
+} // namespace
+
+void noteBootMilestone(char const* name) {
+	if (numMilestones >= kMaxNumBootMilestones) {
+		return;
+	}
+	if (!numMilestones) {
+		init(); // Make sure the cycle counter's running
+	}
+	milestones[numMilestones++] = {.name = name, .cycles = readCycleCounter()};
+}
+
+void dumpBootMilestones() {
+	// e.g. "boot midi devices 1630 +212", in milliseconds
+	for (int32_t m = 0; m < numMilestones; m++) {
+		print("boot ");
+		print(milestones[m].name);
+		print(" ");
+		print((int32_t)((milestones[m].cycles - milestones[0].cycles) / mS));
+		print(" +");
+		println((int32_t)((milestones[m].cycles - milestones[m ? m - 1 : 0].cycles) / mS));
+	}
+}
+
+} // namespace Debug
@@ -0,0 +1,40 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/*
+ * Timings of the steps of startup, from deluge_main() being entered, so we can see what's keeping a Deluge that's been
+ * power-cycled mid-gig from making sound again. Each milestone is just a name and the cycle counter at the time it was
+ * passed; they're printed with debug sysex command 9. The cycle counter wraps after 10.7 seconds, which startup is
+ * nowhere near, but a milestone noted that long after it would come out wrong.
+ */
+
+namespace Debug {
+
+constexpr int32_t kMaxNumBootMilestones = 16;
+
+/// Note that startup's got as far as this. name must be a string literal, or otherwise outlive us. The first call is
+/// the zero that the rest are timed from. Any past kMaxNumBootMilestones are ignored
+void noteBootMilestone(char const* name);
+
+/// Prints each milestone, with how long after the first one it was passed and how long since the previous one
+void dumpBootMilestones();
+
+} // namespace Debug
@@ -0,0 +1,137 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "io/debug/cpu_profiler.h"
+#include "definitions.h"
+#include "model/settings/runtime_feature_settings.h"
+#include "util/functions.h"
+#include <string.h>
+
+namespace Debug {
+
+CPUProfiler cpuProfiler{};
+
+char const* CPUProfiler::getStageName(ProfileStage stage) {
+	switch (stage) {
+	case ProfileStage::TOTAL:
+		return "total";
+	case ProfileStage::SONG_RENDER:
+		return "song";
+	case ProfileStage::SOUND_RENDER:
+		return "sounds";
+	case ProfileStage::REVERB:
+		return "reverb";
+	case ProfileStage::MASTER_COMPRESSOR:
+		return "mcomp";
+	case ProfileStage::SSI_OUTPUT:
+		return "output";
+	default:
+		return "";
+	}
+}
+
+void CPUProfiler::beginRoutine() {
+	routineStartTime = readCycleCounter();
+}
+
+void CPUProfiler::endRoutine(int32_t numSamples) {
+	uint32_t timeNow = readCycleCounter();
+	lastRoutineCycles = timeNow - routineStartTime;
+	accumulatedCycles[static_cast<int32_t>(ProfileStage::TOTAL)] += lastRoutineCycles;
+	numSamplesThisWindow += numSamples;
+
+	// The first call just starts the first window, and makes sure the PMU is actually counting
+	if (!windowActive) {
+		Debug::init();
+		windowActive = true;
+		windowStartTime = timeNow;
+		numSamplesThisWindow = 0;
+		memset(accumulatedCycles, 0, sizeof(accumulatedCycles));
+		return;
+	}
+
+	if (timeNow - windowStartTime >= sec) {
+		finishWindow(timeNow);
+	}
+}
+
+// How long what's in the TX buffer lasts once it's full
+constexpr uint32_t kTxBufferCycles = SSI_TX_BUFFER_NUM_SAMPLES * kCyclesPerSample;
+
+void CPUProfiler::noteRenderLag(int32_t numSamplesBehind) {
+	uint32_t timeNow = readCycleCounter();
+
+	// The last render filled the buffer right up to where the DMA was then. If the buffer's whole length has played out
+	// since, the DMA has lapped us - which numSamplesBehind, being worked out modulo the buffer's length, can't show
+	if (haveRendered && timeNow - lastRenderTime > kTxBufferCycles) {
+		numUnderruns++;
+		numSamplesBehind = SSI_TX_BUFFER_NUM_SAMPLES;
+	}
+	lastRenderTime = timeNow;
+	haveRendered = windowActive; // Until then, the PMU might not have been counting
+
+	if (numSamplesBehind > worstRenderLagThisWindow) {
+		worstRenderLagThisWindow = numSamplesBehind;
+	}
+}
+
+void CPUProfiler::finishWindow(uint32_t timeNow) {
+	uint64_t budget = (uint64_t)numSamplesThisWindow * kCyclesPerSample;
+
+	for (int32_t s = 0; s < kNumProfileStages; s++) {
+		loadPermille[s] = budget ? (int32_t)(((uint64_t)accumulatedCycles[s] * 1000) / budget) : 0;
+		accumulatedCycles[s] = 0;
+	}
+
+	numSamplesThisWindow = 0;
+	windowStartTime = timeNow;
+	worstRenderLag = worstRenderLagThisWindow;
+	worstRenderLagThisWindow = 0;
+
+	if (streaming) {
+		// One line per window, like "prof total 612 song 480 sounds 355 ...", in tenths of a percent
+		char buffer[160];
+		strcpy(buffer, "prof");
+		char* pos = buffer + 4;
+		for (int32_t s = 0; s < kNumProfileStages; s++) {
+			*(pos++) = ' ';
+			strcpy(pos, getStageName(static_cast<ProfileStage>(s)));
+			pos += strlen(pos);
+			*(pos++) = ' ';
+			intToString(loadPermille[s], pos);
+			pos += strlen(pos);
+		}
+
+		// Then e.g. "lag 37 xruns 0" - the most samples the routine got behind by, and underruns since startup
+		strcpy(pos, " lag ");
+		pos += strlen(pos);
+		intToString(worstRenderLag, pos);
+		pos += strlen(pos);
+		strcpy(pos, " xruns ");
+		pos += strlen(pos);
+		intToString(numUnderruns, pos);
+		pos += strlen(pos);
+
+		// And which engine profile these figures are for, e.g. "engine live"
+		strcpy(pos, " engine ");
+		pos += strlen(pos);
+		strcpy(pos, RuntimeFeatureSettings::getEngineProfileName(runtimeFeatureSettings.getActiveEngineProfile()).data());
+		println(buffer);
+	}
+}
+
+} // namespace Debug
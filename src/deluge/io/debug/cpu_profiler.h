@@ -0,0 +1,117 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "io/debug/print.h"
+#include <cstdint>
+
+namespace Debug {
+
+/// The parts of AudioEngine::routine() we keep separate cycle totals for. Stages may nest (e.g. SOUND_RENDER happens
+/// inside SONG_RENDER), so they don't add up to TOTAL.
+enum class ProfileStage : uint8_t {
+	TOTAL,
+	SONG_RENDER,
+	SOUND_RENDER,
+	REVERB,
+	MASTER_COMPRESSOR,
+	SSI_OUTPUT,
+	NUM_STAGES,
+};
+
+constexpr int32_t kNumProfileStages = static_cast<int32_t>(ProfileStage::NUM_STAGES);
+
+/// Cycle budget for rendering one sample, at 400MHz and 44.1kHz
+constexpr uint32_t kCyclesPerSample = sec / 44100;
+
+/// Per-stage cycle accounting for the audio routine. Every stage accumulates PMU cycles over a window of about one
+/// second (like AverageDT), after which the window's totals are turned into a load figure - the proportion of the
+/// real-time budget for the samples rendered in that window - which the UI can read out at any time. Alongside that, it
+/// keeps track of how close the routine's getting to being too late, and how often it has been. If streaming is on,
+/// each window is also printed, which goes out over RTT or sysex depending on where debug output is going.
+class CPUProfiler {
+public:
+	CPUProfiler() = default;
+
+	[[gnu::always_inline]] inline uint32_t beginStage() { return readCycleCounter(); }
+
+	[[gnu::always_inline]] inline void endStage(ProfileStage stage, uint32_t startTime) {
+		accumulatedCycles[static_cast<int32_t>(stage)] += readCycleCounter() - startTime;
+	}
+
+	void beginRoutine();
+	void endRoutine(int32_t numSamples);
+
+	/// Call each time the routine's about to render, with how far the SSI DMA had got ahead of what was last rendered
+	void noteRenderLag(int32_t numSamplesBehind);
+
+	/// In tenths of a percent of the available time
+	[[nodiscard]] int32_t getLoadPermille(ProfileStage stage) const {
+		return loadPermille[static_cast<int32_t>(stage)];
+	}
+
+	/// How long the most recent call to the audio routine took, in cycles
+	[[nodiscard]] uint32_t getLastRoutineCycles() const { return lastRoutineCycles; }
+
+	/// The furthest behind the DMA the routine found itself over the last window, in samples. The TX buffer's length
+	/// minus this is how much slack there was
+	[[nodiscard]] int32_t getWorstRenderLag() const { return worstRenderLag; }
+
+	/// How many times since startup the routine was left so long that the DMA had gone all the way round the TX buffer
+	/// and started playing old audio again
+	[[nodiscard]] uint32_t getNumUnderruns() const { return numUnderruns; }
+
+	void setStreaming(bool newStreaming) { streaming = newStreaming; }
+	[[nodiscard]] bool isStreaming() const { return streaming; }
+
+	static char const* getStageName(ProfileStage stage);
+
+private:
+	void finishWindow(uint32_t timeNow);
+
+	uint32_t accumulatedCycles[kNumProfileStages] = {0};
+	int32_t loadPermille[kNumProfileStages] = {0};
+	uint32_t numSamplesThisWindow = 0;
+	uint32_t windowStartTime = 0;
+	uint32_t routineStartTime = 0;
+	uint32_t lastRoutineCycles = 0;
+	uint32_t lastRenderTime = 0;
+	int32_t worstRenderLagThisWindow = 0;
+	int32_t worstRenderLag = 0;
+	uint32_t numUnderruns = 0;
+	bool windowActive = false;
+	bool haveRendered = false;
+	bool streaming = false;
+};
+
+/// Times the enclosing scope as one stage
+class ProfileScope {
+public:
+	ProfileScope(CPUProfiler& profiler, ProfileStage stage)
+	    : profiler(profiler), stage(stage), startTime(profiler.beginStage()) {}
+	~ProfileScope() { profiler.endStage(stage, startTime); }
+
+private:
+	CPUProfiler& profiler;
+	ProfileStage stage;
+	uint32_t startTime;
+};
+
+extern CPUProfiler cpuProfiler;
+
+} // namespace Debug
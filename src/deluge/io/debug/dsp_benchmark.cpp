@@ -0,0 +1,297 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "io/debug/dsp_benchmark.h"
+#include "definitions_cxx.hpp"
+#include "dsp/delay/delay_buffer.h"
+#include "dsp/filter/filter_set.h"
+#include "dsp/master_compressor/master_compressor.h"
+#include "dsp/reverb/fdn/fdn.h"
+#include "dsp/reverb/freeverb/revmodel.hpp"
+#include "dsp/stereo_sample.h"
+#include "io/debug/print.h"
+#include "memory/general_memory_allocator.h"
+#include "model/sample/sample.h"
+#include "model/sample/sample_low_level_reader.h"
+#include "util/functions.h"
+#include "util/functions_quad.h"
+#include <string.h>
+
+namespace Debug {
+
+namespace {
+
+constexpr int32_t kBlockSize = SSI_TX_BUFFER_NUM_SAMPLES;
+constexpr int32_t kNumBlocks = 64;
+constexpr int32_t kNumGoes = 4;
+
+// Fixed input, the same every run. Mono kernels get the left channel
+StereoSample inputBlock[kBlockSize];
+StereoSample workBlock[kBlockSize];
+int32_t monoWorkBlock[kBlockSize];
+int32_t outputL[kBlockSize];
+int32_t outputR[kBlockSize];
+
+volatile int32_t sink;
+
+void makeInput() {
+	uint32_t seed = 1;
+	uint32_t phase = 0;
+	for (int32_t i = 0; i < kBlockSize; i++) {
+		seed = seed * 1664525 + 1013904223;
+		phase += 0x03000000;
+		// A sine with a bit of noise on it, at about -6dB, so filters and compressors have something to chew on
+		inputBlock[i].l = (getSine(phase) >> 1) + ((int32_t)seed >> 5);
+		inputBlock[i].r = (getSine(phase + 0x40000000) >> 1) - ((int32_t)seed >> 5);
+	}
+}
+
+void copyInput() {
+	memcpy(workBlock, inputBlock, sizeof(workBlock));
+	for (int32_t i = 0; i < kBlockSize; i++) {
+		monoWorkBlock[i] = inputBlock[i].l;
+	}
+}
+
+// Runs the kernel over kNumBlocks blocks, a few times over, and prints the quickest in hundredths of a cycle per
+// sample. The copy of the input in before each block isn't counted
+template <typename Kernel>
+void timeKernel(char const* name, Kernel kernel) {
+	uint32_t bestCycles = 0xFFFFFFFF;
+	for (int32_t g = 0; g < kNumGoes; g++) {
+		uint32_t cycles = 0;
+		for (int32_t b = 0; b < kNumBlocks; b++) {
+			copyInput();
+			uint32_t startTime = readCycleCounter();
+			kernel();
+			cycles += readCycleCounter() - startTime;
+		}
+		if (cycles < bestCycles) {
+			bestCycles = cycles;
+		}
+	}
+
+	char buffer[64];
+	strcpy(buffer, "bench ");
+	strcat(buffer, name);
+	strcat(buffer, " ");
+	char* pos = buffer + strlen(buffer);
+	intToString((int32_t)(((uint64_t)bestCycles * 100) / (kNumBlocks * kBlockSize)), pos);
+	println(buffer);
+}
+
+void benchFilters() {
+	using deluge::dsp::filter::FilterSet;
+	FilterSet filterSet;
+	constexpr char const* lpfNames[kNumLPFModes] = {"lpf 12db", "lpf 24db", "lpf drive", "lpf svf band",
+	                                                "lpf svf notch"};
+	constexpr char const* hpfNames[kNumHPFModes] = {"hpf svf band", "hpf svf notch", "hpf ladder"};
+
+	for (int32_t m = 0; m < kNumLPFModes; m++) {
+		filterSet.reset();
+		filterSet.setConfig(1 << 29, 1 << 29, true, static_cast<FilterMode>(m), 0, 0, 0, false, FilterMode::OFF, 0,
+		                    1 << 27, FilterRoute::HIGH_TO_LOW);
+		timeKernel(lpfNames[m],
+		           [&]() { filterSet.renderLong(monoWorkBlock, &monoWorkBlock[kBlockSize], kBlockSize); });
+	}
+
+	for (int32_t m = 0; m < kNumHPFModes; m++) {
+		filterSet.reset();
+		filterSet.setConfig(0, 0, false, FilterMode::OFF, 0, 1 << 28, 1 << 29, true,
+		                    static_cast<FilterMode>(kFirstHPFMode + m), 0, 1 << 27, FilterRoute::HIGH_TO_LOW);
+		timeKernel(hpfNames[m],
+		           [&]() { filterSet.renderLong(monoWorkBlock, &monoWorkBlock[kBlockSize], kBlockSize); });
+	}
+
+	filterSet.reset();
+	filterSet.setConfig(1 << 29, 1 << 29, true, FilterMode::TRANSISTOR_24DB, 0, 1 << 28, 1 << 29, true,
+	                    FilterMode::HPLADDER, 0, 1 << 27, FilterRoute::HIGH_TO_LOW);
+	timeKernel("filters stereo", [&]() { filterSet.renderLongStereo(&workBlock[0].l, &workBlock[kBlockSize].l); });
+}
+
+void benchReverbs() {
+	int32_t monoInput[kBlockSize];
+	for (int32_t i = 0; i < kBlockSize; i++) {
+		monoInput[i] = inputBlock[i].l >> 1;
+	}
+
+	revmodel* freeverb = new revmodel();
+	if (freeverb) {
+		freeverb->setroomsize(0.7);
+		freeverb->setdamp(0.5);
+		freeverb->setwidth(1);
+		timeKernel("freeverb", [&]() { freeverb->process(monoInput, outputL, outputR, kBlockSize); });
+		delete freeverb;
+	}
+
+	using deluge::dsp::reverb::FDN;
+	FDN* fdn = new FDN();
+	if (fdn) {
+		fdn->setParams(0.7, 0.5, 1);
+		constexpr char const* qualityNames[kNumReverbQualities] = {"fdn high", "fdn medium", "fdn low"};
+		for (int32_t q = 0; q < kNumReverbQualities; q++) {
+			fdn->setQuality(static_cast<ReverbQuality>(q));
+			timeKernel(qualityNames[q], [&]() { fdn->process(monoInput, outputL, outputR, kBlockSize); });
+		}
+		delete fdn;
+	}
+}
+
+// The delay's native-rate path: read where we are, write input plus feedback back in, move on
+void benchDelay() {
+	DelayBuffer buffer;
+	if (buffer.init(16777216)) {
+		return;
+	}
+	buffer.empty();
+
+	timeKernel("delay native", [&]() {
+		for (int32_t i = 0; i < kBlockSize; i++) {
+			int32_t fromDelayL = buffer.bufferCurrentPos->l;
+			int32_t fromDelayR = buffer.bufferCurrentPos->r;
+			buffer.prefetch();
+			buffer.writeNative(workBlock[i].l + (fromDelayR >> 1), workBlock[i].r + (fromDelayL >> 1));
+			buffer.moveOn();
+			outputL[i] = fromDelayL;
+			outputR[i] = fromDelayR;
+		}
+	});
+}
+
+// Plays 24-bit stereo through a stretch of SDRAM several times the size of the L2 cache, the way
+// SampleLowLevelReader::readSamplesNative() does through a Cluster, each way, and then 16-bit forwards. "no pld" has
+// the prefetch distance at zero, so the PLDs still get issued but don't reach ahead of the reads
+void benchSampleReading() {
+	constexpr int32_t kReadAreaSize = 1 << 20;
+	constexpr int32_t kBytesPerSample = 6;
+	constexpr int32_t kBytesPerBlock = kBlockSize * kBytesPerSample;
+
+	char* area = (char*)GeneralMemoryAllocator::get().alloc(kReadAreaSize);
+	if (!area) {
+		return;
+	}
+	memset(area, 0, kReadAreaSize);
+
+	Sample* sample = new Sample();
+	if (!sample) {
+		GeneralMemoryAllocator::get().dealloc(area);
+		return;
+	}
+	sample->numChannels = 2;
+	sample->byteDepth = 3;
+	sample->bitMask = 0xFFFFFF00;
+
+	SampleLowLevelReader reader;
+	int32_t const distanceForward = SampleLowLevelReader::prefetchDistanceForward;
+	int32_t const distanceReverse = SampleLowLevelReader::prefetchDistanceReverse;
+
+	// Leave room at both ends for the 32-bit reads, which go a byte past the sample
+	char* const firstPos = area + CACHE_LINE_SIZE;
+	char* const lastPos = area + kReadAreaSize - CACHE_LINE_SIZE;
+
+	for (int32_t withPrefetch = 0; withPrefetch < 2; withPrefetch++) {
+		SampleLowLevelReader::prefetchDistanceForward = withPrefetch ? distanceForward : 0;
+		SampleLowLevelReader::prefetchDistanceReverse = withPrefetch ? distanceReverse : 0;
+
+		reader.currentPlayPos = firstPos;
+		timeKernel(withPrefetch ? "sample fwd" : "sample fwd no pld", [&]() {
+			if (reader.currentPlayPos + kBytesPerBlock > lastPos) {
+				reader.currentPlayPos = firstPos;
+			}
+			int32_t* bufferPos = &workBlock[0].l;
+			int32_t amplitude = 1 << 30;
+			reader.readSamplesNative(&bufferPos, kBlockSize, sample, kBytesPerSample, 2, 2, &amplitude, 0);
+		});
+
+		reader.currentPlayPos = lastPos;
+		timeKernel(withPrefetch ? "sample rev" : "sample rev no pld", [&]() {
+			if (reader.currentPlayPos - kBytesPerBlock < firstPos) {
+				reader.currentPlayPos = lastPos;
+			}
+			int32_t* bufferPos = &workBlock[0].l;
+			int32_t amplitude = 1 << 30;
+			reader.readSamplesNative(&bufferPos, kBlockSize, sample, -kBytesPerSample, 2, 2, &amplitude, 0);
+		});
+	}
+
+	SampleLowLevelReader::prefetchDistanceForward = distanceForward;
+	SampleLowLevelReader::prefetchDistanceReverse = distanceReverse;
+
+	// And 16-bit, which goes through the vectorized path differently
+	sample->byteDepth = 2;
+	sample->bitMask = 0xFFFF0000;
+	reader.currentPlayPos = firstPos;
+	timeKernel("sample fwd 16", [&]() {
+		if (reader.currentPlayPos + kBlockSize * 4 > lastPos) {
+			reader.currentPlayPos = firstPos;
+		}
+		int32_t* bufferPos = &workBlock[0].l;
+		int32_t amplitude = 1 << 30;
+		reader.readSamplesNative(&bufferPos, kBlockSize, sample, 4, 2, 2, &amplitude, 0);
+	});
+
+	delete sample;
+	GeneralMemoryAllocator::get().dealloc(area);
+}
+
+void benchMasterCompressor() {
+	MasterCompressor* compressor = new MasterCompressor();
+	if (compressor) {
+		compressor->setup(1000, 10000, -1200, 400, 0, 100);
+		timeKernel("master comp", [&]() { compressor->render(workBlock, kBlockSize, 1 << 27, 1 << 27); });
+		delete compressor;
+	}
+}
+
+// The oscillators' sine lookups, one lane and four at a time, as the sine and FM paths in Voice use them
+void benchSines() {
+	timeKernel("sine", [&]() {
+		uint32_t phase = 0;
+		for (int32_t i = 0; i < kBlockSize; i++) {
+			outputL[i] = getSine(phase + (workBlock[i].l >> 4));
+			phase += 0x01234567;
+		}
+	});
+
+	timeKernel("sine quad", [&]() {
+		uint32x4_t phase = {0, 0x01234567, 0x02468ACE, 0x0369D035};
+		uint32x4_t phaseIncrement = vdupq_n_u32(0x048D159C);
+		for (int32_t i = 0; i < kBlockSize; i += 4) {
+			int32x4_t modulation = vshrq_n_s32(vld2q_s32(&workBlock[i].l).val[0], 4);
+			vst1q_s32(&outputL[i], getSine_quad(vaddq_u32(phase, vreinterpretq_u32_s32(modulation))));
+			phase = vaddq_u32(phase, phaseIncrement);
+		}
+	});
+
+	sink = outputL[kBlockSize - 1];
+}
+
+} // namespace
+
+void runDSPBenchmarks() {
+	init(); // Make sure the PMU is counting
+	makeInput();
+
+	benchFilters();
+	benchReverbs();
+	benchDelay();
+	benchSampleReading();
+	benchMasterCompressor();
+	benchSines();
+}
+
+} // namespace Debug
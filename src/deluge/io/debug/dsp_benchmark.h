@@ -0,0 +1,30 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace Debug {
+
+/// Times each DSP kernel on its own, over the same fixed blocks of input every time, and prints cycles per sample
+/// for each - in hundredths, e.g. "bench lpf 24db 1843" is 18.43 cycles per sample. Each kernel gets a few goes and
+/// the quickest one is what's printed, to keep interrupts out of the figures. Works on its own instances, so the
+/// song's sound is untouched, but it takes a good fraction of a second - only for when someone's asked for it.
+void runDSPBenchmarks();
+
+} // namespace Debug
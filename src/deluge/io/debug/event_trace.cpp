@@ -0,0 +1,64 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "io/debug/event_trace.h"
+
+#if ENABLE_EVENT_TRACE && !defined(IN_UNIT_TESTS)
+
+#include "RTT/SEGGER_RTT.h"
+#include "io/debug/print.h"
+#include <algorithm>
+
+namespace Debug::EventTrace {
+
+// The audio routine alone gives a couple of thousand events a second, so leave room for the host to fall a bit behind
+constexpr uint32_t kRTTBufferSize = 2048 * sizeof(EventTraceEntry);
+
+constexpr unsigned kRTTChannel = 3;
+
+char rttBuffer[kRTTBufferSize];
+bool rttConfigured = false;
+uint32_t numLost = 0;
+
+void record(TraceScope scope, TraceEvent event, uint16_t data) {
+	if (!rttConfigured) {
+		SEGGER_RTT_ConfigUpBuffer(kRTTChannel, "EventTrace", rttBuffer, kRTTBufferSize, SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+		rttConfigured = true;
+	}
+
+	EventTraceEntry entries[2];
+	int32_t numEntries = 0;
+
+	// Say what got dropped first, if anything, so the host knows not to trust what's either side of the gap
+	if (numLost) {
+		entries[0] = {readCycleCounter(), scope, TraceEvent::LOST, (uint16_t)std::min<uint32_t>(numLost, 0xFFFF)};
+		numEntries++;
+	}
+	entries[numEntries++] = {readCycleCounter(), scope, event, data};
+
+	// In NO_BLOCK_SKIP mode, it's all or nothing
+	if (SEGGER_RTT_Write(kRTTChannel, entries, numEntries * sizeof(EventTraceEntry))) {
+		numLost = 0;
+	}
+	else {
+		numLost++;
+	}
+}
+
+} // namespace Debug::EventTrace
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/*
+ * A timeline of when the firmware's main activities start and finish, for seeing how they get in each other's way -
+ * e.g. a UI render landing while clusters are loading. Only built in with ENABLE_EVENT_TRACE (which needs RTT). Each
+ * enter and exit is a raw EventTraceEntry written straight into RTT up-channel 3. Unlike the allocation and disk
+ * traces, there's no ring for the main loop to drain, as the long card operations that hold up the main loop are just
+ * what we want to see - so recording never blocks, and if RTT's full, the event's dropped and a LOST entry says how
+ * many were. contrib/debug/event_trace.py turns a capture into a Chrome trace / Perfetto timeline.
+ */
+
+namespace Debug {
+
+enum class TraceScope : uint8_t {
+	AUDIO_ROUTINE, // Just the calls to AudioEngine::routine() which actually render
+	CLUSTER_LOAD,  // data is how many Clusters were read at once
+	UI_RENDER,
+	OLED_RENDER,
+	MIDI_FLUSH,
+	CARD_ROUTINE, // routineForSD(), i.e. what gets done while waiting on the card
+	NUM_SCOPES,
+};
+
+enum class TraceEvent : uint8_t {
+	ENTER,
+	EXIT,
+	LOST, // data is how many events got dropped
+};
+
+struct EventTraceEntry {
+	uint32_t cycles; // At 400MHz - wraps every 10.7 seconds
+	TraceScope scope;
+	TraceEvent event;
+	uint16_t data;
+};
+
+static_assert(sizeof(EventTraceEntry) == 8, "event_trace.py relies on this layout");
+
+#if ENABLE_EVENT_TRACE && !defined(IN_UNIT_TESTS)
+namespace EventTrace {
+void record(TraceScope scope, TraceEvent event, uint16_t data = 0);
+} // namespace EventTrace
+
+/// Records the enclosing scope as one span
+class EventTraceScope {
+public:
+	EventTraceScope(TraceScope scope) : scope(scope) { EventTrace::record(scope, TraceEvent::ENTER); }
+	~EventTraceScope() { EventTrace::record(scope, TraceEvent::EXIT); }
+
+private:
+	TraceScope scope;
+};
+
+#define TRACE_SCOPE(scope) Debug::EventTraceScope eventTraceScope(Debug::TraceScope::scope)
+#define TRACE_BEGIN(scope) Debug::EventTrace::record(Debug::TraceScope::scope, Debug::TraceEvent::ENTER)
+#define TRACE_END(scope, data) Debug::EventTrace::record(Debug::TraceScope::scope, Debug::TraceEvent::EXIT, (data))
+#else
+#define TRACE_SCOPE(scope)
+#define TRACE_BEGIN(scope)
+#define TRACE_END(scope, data)
+#endif
+
+} // namespace Debug
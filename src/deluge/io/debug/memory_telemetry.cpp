@@ -0,0 +1,139 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "io/debug/memory_telemetry.h"
+#include "io/debug/print.h"
+#include "memory/general_memory_allocator.h"
+#include "processing/engines/audio_engine.h"
+#include "util/functions.h"
+#include <string.h>
+
+namespace Debug {
+
+MemoryTelemetry memoryTelemetry{};
+
+char const* MemoryTelemetry::getRegionName(int32_t region) {
+	switch (region) {
+	case MEMORY_REGION_SDRAM:
+		return "external";
+	case MEMORY_REGION_INTERNAL:
+		return "internal";
+	case MEMORY_REGION_NONAUDIO:
+		return "nonaudio";
+	default:
+		return "";
+	}
+}
+
+uint32_t MemoryTelemetry::getTotalSteals() {
+	uint32_t total = 0;
+	for (int32_t r = 0; r < NUM_MEMORY_REGIONS; r++) {
+		total += GeneralMemoryAllocator::get().regions[r].cache_manager().num_steals();
+	}
+	return total;
+}
+
+int32_t MemoryTelemetry::getStealsPerSecond() {
+	uint32_t timeNow = AudioEngine::audioSampleTimer;
+	uint32_t timeElapsed = timeNow - windowStartTime;
+	if (timeElapsed >= kSampleRate) {
+		uint32_t numSteals = getTotalSteals();
+		// Only meaningful once we've had a first window
+		if (windowStartTime) {
+			stealsPerSecond = (int32_t)(((uint64_t)(numSteals - numStealsAtWindowStart) * kSampleRate) / timeElapsed);
+		}
+		numStealsAtWindowStart = numSteals;
+		windowStartTime = timeNow;
+	}
+	return stealsPerSecond;
+}
+
+// Appends " <label> <number>" to a line being built
+static char* appendNumber(char* pos, char const* label, int32_t number) {
+	*(pos++) = ' ';
+	strcpy(pos, label);
+	pos += strlen(pos);
+	*(pos++) = ' ';
+	intToString(number, pos);
+	return pos + strlen(pos);
+}
+
+void MemoryTelemetry::dump() {
+	char buffer[192];
+
+	for (int32_t r = 0; r < NUM_MEMORY_REGIONS; r++) {
+		MemoryRegionTelemetry telemetry;
+		GeneralMemoryAllocator::get().regions[r].getTelemetry(&telemetry);
+
+		// e.g. "mem external free 41230120 spaces 87 largest 40894464 steals 12"
+		strcpy(buffer, "mem ");
+		strcat(buffer, getRegionName(r));
+		char* pos = buffer + strlen(buffer);
+		pos = appendNumber(pos, "free", telemetry.freeBytes);
+		pos = appendNumber(pos, "spaces", telemetry.numFreeSpaces);
+		pos = appendNumber(pos, "largest", telemetry.largestFreeRun);
+		pos = appendNumber(pos, "steals", telemetry.numSteals);
+		println(buffer);
+
+		// Empty space counts by size - under 64B, under 256B, and so on up by 4x
+		strcpy(buffer, "mem ");
+		strcat(buffer, getRegionName(r));
+		strcat(buffer, " hist");
+		pos = buffer + strlen(buffer);
+		for (int32_t b = 0; b < kNumFreeSpaceSizeBuckets; b++) {
+			*(pos++) = ' ';
+			intToString(telemetry.freeSpaceHistogram[b], pos);
+			pos += strlen(pos);
+		}
+		println(buffer);
+
+		// Stealable bytes, per reclamation queue
+		strcpy(buffer, "mem ");
+		strcat(buffer, getRegionName(r));
+		strcat(buffer, " stealable");
+		pos = buffer + strlen(buffer);
+		for (int32_t q = 0; q < NUM_STEALABLE_QUEUES; q++) {
+			*(pos++) = ' ';
+			intToString(telemetry.stealableBytes[q], pos);
+			pos += strlen(pos);
+		}
+		println(buffer);
+	}
+
+	constexpr char const* tagNames[kNumAllocationTags] = {"internal", "external", "stealable",
+	                                                      "nonaudio", "slab",     "temp"};
+	strcpy(buffer, "mem allocs");
+	char* pos = buffer + strlen(buffer);
+	for (int32_t t = 0; t < kNumAllocationTags; t++) {
+		pos = appendNumber(pos, tagNames[t],
+		                   GeneralMemoryAllocator::get().getNumAllocations(static_cast<AllocationTag>(t)));
+	}
+	pos = appendNumber(pos, "steals/s", getStealsPerSecond());
+	pos = appendNumber(pos, "relocations", GeneralMemoryAllocator::get().getNumRelocations());
+	println(buffer);
+
+	// TimeStretcher buffer pool, e.g. "mem tsbuf mono 2 stereo 6 of 6 overflows 3"
+	strcpy(buffer, "mem tsbuf");
+	pos = buffer + strlen(buffer);
+	pos = appendNumber(pos, "mono", AudioEngine::getNumTimeStretcherBuffersInUse(1));
+	pos = appendNumber(pos, "stereo", AudioEngine::getNumTimeStretcherBuffersInUse(2));
+	pos = appendNumber(pos, "of", kNumTimeStretcherBuffersStatic);
+	pos = appendNumber(pos, "overflows", AudioEngine::getNumTimeStretcherBufferOverflows());
+	println(buffer);
+}
+
+} // namespace Debug
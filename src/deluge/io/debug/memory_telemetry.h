@@ -0,0 +1,51 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace Debug {
+
+/// Heap occupancy and fragmentation figures for the firmware's MemoryRegions, for the MEMORY menu and for dumping over
+/// RTT (or sysex, wherever debug output is going). Everything here walks whole lists, so keep it out of the audio
+/// routine.
+class MemoryTelemetry {
+public:
+	MemoryTelemetry() = default;
+
+	/// Print everything - per region, the free space histogram, largest free run and stealable bytes per queue, then
+	/// allocation counts per tag, and how full the TimeStretcher buffer pool is
+	void dump();
+
+	/// Steals per second, across all regions, measured over the last window of at least a second. Calling this is
+	/// what moves the window along.
+	int32_t getStealsPerSecond();
+
+	static char const* getRegionName(int32_t region);
+
+private:
+	uint32_t getTotalSteals();
+
+	uint32_t windowStartTime = 0;
+	uint32_t numStealsAtWindowStart = 0;
+	int32_t stealsPerSecond = 0;
+};
+
+extern MemoryTelemetry memoryTelemetry;
+
+} // namespace Debug
@@ -0,0 +1,97 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "io/debug/note_latency.h"
+#include "io/debug/cpu_profiler.h"
+#include "io/debug/print.h"
+#include <algorithm>
+
+namespace Debug {
+
+NoteLatency noteLatency{};
+
+void NoteLatency::beginInput(LatencySource source) {
+	currentSource = source;
+	inputTime = readCycleCounter();
+}
+
+void NoteLatency::beginRender(int32_t numSamplesQueued) {
+	renderTime = readCycleCounter();
+	renderNumSamplesQueued = numSamplesQueued;
+}
+
+void NoteLatency::voiceSounded(LatencySource source, uint32_t voiceInputTime) {
+	// The render can't really have started before the input, but in case the Voice got its timestamp from outside a
+	// render - e.g. while the audio routine was being called from within the input's handling - don't count it
+	int32_t renderDelay = (int32_t)(renderTime - voiceInputTime);
+	if (renderDelay < 0) {
+		return;
+	}
+	uint32_t latencyUS = ((uint32_t)renderDelay + renderNumSamplesQueued * kCyclesPerSample) / uS;
+	if (latencyUS > kMaxLatencyMS * 1000) {
+		return;
+	}
+
+	SourceStats& s = stats[static_cast<int32_t>(source)];
+	if (!s.numNotes || latencyUS < s.minUS) {
+		s.minUS = latencyUS;
+	}
+	s.maxUS = std::max(s.maxUS, latencyUS);
+	s.totalUS += latencyUS;
+	s.numNotes++;
+	s.histogram[std::min<uint32_t>(latencyUS / 1000, kNumLatencyBuckets - 1)]++;
+}
+
+void NoteLatency::dump() const {
+	constexpr char const* sourceNames[kNumLatencySources] = {"", "pad", "midi din", "midi usb"};
+
+	// e.g. "latency pad notes 57 min 3120 mean 5230 max 9870" in microseconds, then
+	// "latency pad hist 0 0 0 4 21 ..." with 1ms per bucket
+	for (int32_t source = 1; source < kNumLatencySources; source++) {
+		SourceStats const& s = stats[source];
+		if (!s.numNotes) {
+			continue;
+		}
+		print("latency ");
+		print(sourceNames[source]);
+		print(" notes ");
+		print((int32_t)s.numNotes);
+		print(" min ");
+		print((int32_t)s.minUS);
+		print(" mean ");
+		print((int32_t)(s.totalUS / s.numNotes));
+		print(" max ");
+		println((int32_t)s.maxUS);
+
+		print("latency ");
+		print(sourceNames[source]);
+		print(" hist");
+		for (int32_t b = 0; b < kNumLatencyBuckets; b++) {
+			print(" ");
+			print((int32_t)s.histogram[b]);
+		}
+		println("");
+	}
+}
+
+void NoteLatency::reset() {
+	for (SourceStats& s : stats) {
+		s = {};
+	}
+}
+
+} // namespace Debug
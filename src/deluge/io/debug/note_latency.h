@@ -0,0 +1,96 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/*
+ * How long it takes from a note being played live - a pad pressed, or a note-on arriving over MIDI - to its sound
+ * leaving the Deluge. Whatever handles the input brackets it with a NoteLatencyInput, and any Voice that gets noteOn()
+ * meanwhile takes the timestamp. The first time that Voice renders something that isn't silence, the time since is
+ * counted into a histogram for where the note came from, along with what was already queued in the SSI TX buffer
+ * ahead of that render, as that has to play out first. Sequenced and arpeggiated notes aren't inputs, so don't count.
+ * It's always on, like VoiceStats - a few cycles per live note. Printed with debug sysex command 10.
+ *
+ * MIDI gets its timestamp when the message is parsed, not when its bytes arrived, so the time it spent sitting in the
+ * UART or USB buffer isn't included. The cycle counter wraps after 10.7 seconds, which a Voice that stays silent for
+ * that long - e.g. one with a very long attack - would get wrong, so anything over kMaxLatencyMS is thrown away.
+ */
+
+namespace Debug {
+
+enum class LatencySource : uint8_t {
+	NONE,
+	PAD,
+	MIDI_DIN,
+	MIDI_USB,
+	NUM_SOURCES,
+};
+
+constexpr int32_t kNumLatencySources = static_cast<int32_t>(LatencySource::NUM_SOURCES);
+constexpr int32_t kNumLatencyBuckets = 32; // 1ms each, with the last one for everything from 31ms on
+constexpr int32_t kMaxLatencyMS = 1000;
+
+class NoteLatency {
+public:
+	NoteLatency() = default;
+
+	void beginInput(LatencySource source);
+	void endInput() { currentSource = LatencySource::NONE; }
+
+	/// What a Voice getting noteOn() right now should remember - NONE if no live input's being handled
+	[[nodiscard]] LatencySource getInputSource() const { return currentSource; }
+	[[nodiscard]] uint32_t getInputTime() const { return inputTime; }
+
+	/// Call each time the audio routine's about to render, with how many samples are still queued to go out before
+	/// what it renders will be heard
+	void beginRender(int32_t numSamplesQueued);
+
+	/// A Voice with a timestamp has rendered its first non-silent output
+	void voiceSounded(LatencySource source, uint32_t inputTime);
+
+	/// Prints, for each source that's had any notes, their count, min, mean and max in microseconds, then the histogram
+	void dump() const;
+	void reset();
+
+private:
+	struct SourceStats {
+		uint32_t numNotes;
+		uint64_t totalUS;
+		uint32_t minUS;
+		uint32_t maxUS;
+		uint32_t histogram[kNumLatencyBuckets];
+	};
+
+	SourceStats stats[kNumLatencySources] = {};
+	uint32_t inputTime = 0;
+	uint32_t renderTime = 0;
+	int32_t renderNumSamplesQueued = 0;
+	LatencySource currentSource = LatencySource::NONE;
+};
+
+extern NoteLatency noteLatency;
+
+/// Marks the enclosing scope as handling a live input
+class NoteLatencyInput {
+public:
+	NoteLatencyInput(LatencySource source) { noteLatency.beginInput(source); }
+	~NoteLatencyInput() { noteLatency.endInput(); }
+};
+
+} // namespace Debug
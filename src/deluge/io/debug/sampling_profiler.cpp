@@ -0,0 +1,200 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "io/debug/sampling_profiler.h"
+
+#if ENABLE_SAMPLING_PROFILER && !defined(IN_UNIT_TESTS)
+
+#include "definitions.h"
+#include "fatfs/ff.h"
+#include "io/debug/print.h"
+#include "memory/general_memory_allocator.h"
+#include "storage/folder_index.h"
+#include <string.h>
+
+extern "C" {
+#include "RZA1/intc/devdrv_intc.h"
+#include "drivers/mtu/mtu.h"
+}
+
+// From the linker script
+extern uint32_t _stext;
+extern uint32_t _etext;
+
+namespace Debug::SamplingProfiler {
+
+constexpr uint32_t kMagic = 0x46525044; // "DPRF", little-endian
+
+// 4 instructions each - fine enough to tell functions, and mostly the loops within them, apart
+constexpr uint32_t kBucketSizeLog2 = 4;
+
+// The timer counts at P0/64, 528 ticks per ms, so this gives about 4kHz. It's prime so the sampling can't lock into
+// step with anything periodic, like the audio routine coming round every 128 samples
+constexpr uint16_t kTimerPeriod = 131;
+constexpr uint32_t kSampleRate = 528000 / kTimerPeriod;
+
+// Above everything but USB's DMA, so we get to see into the other interrupts too
+constexpr uint8_t kInterruptPriority = 4;
+
+uint32_t* histogram = nullptr;
+uint32_t numBuckets = 0;
+volatile uint32_t numSamples = 0;
+volatile uint32_t numOutside = 0;
+bool running = false;
+bool writePending = false;
+
+// irq_handler (in irqfiq_handler.S) pushes the interrupted PC and then SPSR onto the IRQ mode stack before switching to
+// system mode to call us. Any interrupt that's come in on top of us since will have popped its own off again by now,
+// so ours are on top - we just have to briefly go into IRQ mode to see where that is
+[[gnu::always_inline]] static inline uint32_t getInterruptedPC() {
+	uint32_t irqStackPointer;
+	asm volatile("cpsid i\n"
+	             "cps #0x12\n"
+	             "mov %0, sp\n"
+	             "cps #0x1F\n"
+	             "cpsie i\n"
+	             : "=r"(irqStackPointer)
+	             :
+	             : "memory");
+	return ((uint32_t*)irqStackPointer)[1];
+}
+
+static void timerInterrupt(uint32_t intSense) {
+	timerClearCompareMatchTGRA(TIMER_SAMPLING_PROFILER);
+
+	// Anything before .text wraps round to a huge bucket number, so gets counted as outside too
+	uint32_t bucket = (getInterruptedPC() - (uint32_t)&_stext) >> kBucketSizeLog2;
+	if (bucket < numBuckets) {
+		histogram[bucket]++;
+	}
+	else {
+		numOutside++;
+	}
+	numSamples++;
+}
+
+bool start() {
+	if (running) {
+		return true;
+	}
+
+	// A profile that's been stopped but not written yet just gets thrown away
+	writePending = false;
+
+	if (!histogram) {
+		numBuckets = (((uint32_t)&_etext - (uint32_t)&_stext) >> kBucketSizeLog2) + 1;
+		histogram = (uint32_t*)GeneralMemoryAllocator::get().alloc(numBuckets * sizeof(uint32_t));
+		if (!histogram) {
+			println("sampling profiler: not enough memory");
+			return false;
+		}
+	}
+	memset(histogram, 0, numBuckets * sizeof(uint32_t));
+	numSamples = 0;
+	numOutside = 0;
+
+	disableTimer(TIMER_SAMPLING_PROFILER);
+	*TCNT[TIMER_SAMPLING_PROFILER] = 0u;
+	timerClearCompareMatchTGRA(TIMER_SAMPLING_PROFILER);
+	timerEnableInterruptsTGRA(TIMER_SAMPLING_PROFILER);
+	timerControlSetup(TIMER_SAMPLING_PROFILER, 1, 64);
+	*TGRA[TIMER_SAMPLING_PROFILER] = kTimerPeriod - 1;
+
+	R_INTC_RegistIntFunc(INTC_ID_TGIA[TIMER_SAMPLING_PROFILER], &timerInterrupt);
+	R_INTC_SetPriority(INTC_ID_TGIA[TIMER_SAMPLING_PROFILER], kInterruptPriority);
+	R_INTC_Enable(INTC_ID_TGIA[TIMER_SAMPLING_PROFILER]);
+
+	running = true;
+	enableTimer(TIMER_SAMPLING_PROFILER);
+	return true;
+}
+
+void stop() {
+	if (!running) {
+		return;
+	}
+	disableTimer(TIMER_SAMPLING_PROFILER);
+	R_INTC_Disable(INTC_ID_TGIA[TIMER_SAMPLING_PROFILER]);
+	timerDisableInterruptsTGRA(TIMER_SAMPLING_PROFILER);
+	running = false;
+
+	// Writing to the card might happen to be the thing we've just interrupted, so leave it for the main loop
+	writePending = true;
+}
+
+bool isRunning() {
+	return running;
+}
+
+static void writeProfile() {
+	FIL file;
+	if (f_open(&file, kSamplingProfilePath, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK) {
+		println("sampling profiler: couldn't create profile file");
+		return;
+	}
+	FolderIndex::folderChanged(kSamplingProfilePath);
+
+	SamplingProfileHeader header = {
+	    kMagic, (uint32_t)&_stext, kBucketSizeLog2, numBuckets, kSampleRate, numSamples, numOutside, 0,
+	};
+	for (uint32_t b = 0; b < numBuckets; b++) {
+		header.numEntries += (histogram[b] != 0);
+	}
+
+	UINT bytesWritten;
+	FRESULT result = f_write(&file, &header, sizeof(header), &bytesWritten);
+
+	// Most of .text never gets hit, so only the buckets that did are written, a card-friendly chunk at a time
+	SamplingProfileEntry entries[64];
+	int32_t numEntries = 0;
+	for (uint32_t b = 0; b < numBuckets && result == FR_OK; b++) {
+		if (histogram[b]) {
+			entries[numEntries++] = {b, histogram[b]};
+		}
+		if (numEntries == 64 || (b == numBuckets - 1 && numEntries)) {
+			result = f_write(&file, entries, numEntries * sizeof(SamplingProfileEntry), &bytesWritten);
+			numEntries = 0;
+		}
+	}
+
+	f_close(&file);
+
+	if (result == FR_OK) {
+		print("sampling profiler: wrote ");
+		print((int32_t)numSamples);
+		println(" samples");
+	}
+	else {
+		println("sampling profiler: couldn't write profile file");
+	}
+}
+
+void routine() {
+	if (!writePending) {
+		return;
+	}
+	writePending = false;
+
+	writeProfile();
+
+	GeneralMemoryAllocator::get().dealloc(histogram);
+	histogram = nullptr;
+}
+
+} // namespace Debug::SamplingProfiler
+
+#endif
@@ -0,0 +1,70 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/*
+ * A statistical profiler for the whole firmware, for finding hot spots nobody thought to put a ProfileScope or
+ * TRACE_SCOPE around. Only built in with ENABLE_SAMPLING_PROFILER. While it's running, MTU2 channel 3 interrupts about
+ * 4000 times a second, and each time the PC that was interrupted goes into a histogram of .text, in 16 byte buckets.
+ * The interrupt is prioritised above everything but USB's DMA, so time spent in other interrupts shows up too. When it's
+ * stopped, the main loop writes the non-empty buckets to kSamplingProfilePath on the card, and
+ * contrib/debug/sampling_profile.py symbolises that against the ELF. Started and stopped with debug sysex command 7.
+ */
+
+namespace Debug {
+
+constexpr char const* kSamplingProfilePath = "PROFILE.BIN";
+
+/// What the profile file starts with. numEntries SamplingProfileEntrys follow it
+struct SamplingProfileHeader {
+	uint32_t magic;          // "DPRF"
+	uint32_t textStart;      // Where bucket 0 starts
+	uint32_t bucketSizeLog2;
+	uint32_t numBuckets;
+	uint32_t sampleRate;     // Samples per second
+	uint32_t numSamples;
+	uint32_t numOutside;     // Samples where the PC wasn't in .text at all
+	uint32_t numEntries;
+};
+
+struct SamplingProfileEntry {
+	uint32_t bucket;
+	uint32_t count;
+};
+
+static_assert(sizeof(SamplingProfileHeader) == 32, "sampling_profile.py relies on this layout");
+static_assert(sizeof(SamplingProfileEntry) == 8, "sampling_profile.py relies on this layout");
+
+#if ENABLE_SAMPLING_PROFILER && !defined(IN_UNIT_TESTS)
+namespace SamplingProfiler {
+/// Starts sampling from an empty histogram. Returns false if there wasn't the memory for one
+bool start();
+
+/// Stops sampling. The profile's written out by the next routine()
+void stop();
+
+/// Call from the main loop
+void routine();
+
+bool isRunning();
+} // namespace SamplingProfiler
+#endif
+
+} // namespace Debug
@@ -18,11 +18,19 @@
 #include "io/debug/sysex.h"
 #include "gui/l10n/l10n.h"
 #include "hid/display/oled.h"
+#include "io/debug/boot_profile.h"
+#include "io/debug/cpu_profiler.h"
+#include "io/debug/dsp_benchmark.h"
+#include "io/debug/memory_telemetry.h"
+#include "io/debug/note_latency.h"
 #include "io/debug/print.h"
+#include "io/debug/sampling_profiler.h"
 #include "io/midi/midi_device.h"
 #include "io/midi/midi_engine.h"
 #include "memory/general_memory_allocator.h"
 #include "model/settings/runtime_feature_settings.h"
+#include "processing/engines/audio_engine.h"
+#include "scheduler/task_scheduler.h"
 #include "util/chainload.h"
 #include "util/functions.h"
 #include "util/pack.h"
@@ -55,6 +63,48 @@ void Debug::sysexReceived(MIDIDevice* device, uint8_t* data, int32_t len) {
 #endif
 		break;
 
+	case 3:
+		cpuProfiler.setStreaming(data[4] == 1);
+		break;
+
+	case 4:
+		memoryTelemetry.dump();
+		break;
+
+	case 5:
+		runDSPBenchmarks();
+		break;
+
+	case 6:
+		AudioEngine::voiceStats.dump();
+		break;
+
+	case 7:
+#if ENABLE_SAMPLING_PROFILER
+		if (data[4] == 1) {
+			SamplingProfiler::start();
+		}
+		else if (data[4] == 0) {
+			SamplingProfiler::stop();
+		}
+#endif
+		break;
+
+	case 8:
+		taskScheduler.dumpStats();
+		break;
+
+	case 9:
+		dumpBootMilestones();
+		break;
+
+	case 10:
+		noteLatency.dump();
+		if (data[4] == 1) {
+			noteLatency.reset();
+		}
+		break;
+
 	default:
 		break;
 	}
@@ -88,13 +138,24 @@ void Debug::sysexDebugPrint(MIDIDevice* device, const char* msg, bool nl) {
 static uint8_t* load_buf;
 static size_t load_bufsize;
 static size_t load_codesize;
+static bool load_compressed;
+static size_t load_imagesize; // Only for compressed images - what they decompress to
 
 static void firstPacket(uint8_t* data, int32_t len) {
 	uint8_t tmpbuf[0x40] __attribute__((aligned(CACHE_LINE_SIZE)));
 	unpack_7bit_to_8bit(tmpbuf, 0x40, data + 11, 0x4a);
-	uint32_t user_code_start = *(uint32_t*)(tmpbuf + OFF_USER_CODE_START);
-	uint32_t user_code_end = *(uint32_t*)(tmpbuf + OFF_USER_CODE_END);
-	load_codesize = (int32_t)(user_code_end - user_code_start);
+	load_compressed = (*(uint32_t*)(tmpbuf + OFF_COMPRESSED_MAGIC) == COMPRESSED_IMAGE_MAGIC);
+	if (load_compressed) {
+		// What comes over is just the header and the LZ4 block, padded to a whole word like any image
+		uint32_t compressed_size = *(uint32_t*)(tmpbuf + OFF_COMPRESSED_SIZE);
+		load_codesize = COMPRESSED_HEADER_SIZE + ((compressed_size + 3) & ~3);
+		load_imagesize = *(uint32_t*)(tmpbuf + OFF_DECOMPRESSED_SIZE);
+	}
+	else {
+		uint32_t user_code_start = *(uint32_t*)(tmpbuf + OFF_USER_CODE_START);
+		uint32_t user_code_end = *(uint32_t*)(tmpbuf + OFF_USER_CODE_END);
+		load_codesize = (int32_t)(user_code_end - user_code_start);
+	}
 	if (load_bufsize < load_codesize) {
 		if (load_buf != nullptr) {
 			delugeDealloc(load_buf);
@@ -169,6 +230,22 @@ void Debug::loadCheckAndRun(uint8_t* data, int32_t len) {
 		return;
 	}
 
+	if (load_compressed) {
+		// Decompressing only takes a few mS, so it's done here in one go rather than packet by packet as they arrive.
+		// Kept out of on-chip RAM, where the new image gets copied to
+		uint8_t* image_buf = (uint8_t*)GeneralMemoryAllocator::get().alloc(load_imagesize, NULL, false, false);
+		if (image_buf == nullptr) {
+			return;
+		}
+
+		chainload_from_compressed_buf(load_buf, load_codesize, image_buf, load_imagesize);
+
+		// If we're still here, it didn't decompress to a valid image
+		delugeDealloc(image_buf);
+		display->displayPopup(deluge::l10n::get(deluge::l10n::String::STRING_FOR_CHECKSUM_FAIL));
+		return;
+	}
+
 	chainload_from_buf(load_buf, load_codesize);
 }
 #endif
@@ -22,6 +22,8 @@
 #include "gui/ui/sound_editor.h"
 #include "hid/display/display.h"
 #include "hid/hid_sysex.h"
+#include "io/debug/event_trace.h"
+#include "io/debug/note_latency.h"
 #include "io/debug/print.h"
 #include "io/debug/sysex.h"
 #include "io/midi/midi_device.h"
@@ -29,6 +31,7 @@
 #include "model/song/song.h"
 #include "playback/mode/playback_mode.h"
 #include "processing/engines/audio_engine.h"
+#include "storage/sysex_file_transfer.h"
 #include "util/functions.h"
 #include <string.h>
 
@@ -82,42 +85,36 @@ void usbSendCompleteAsHost(int32_t ip) {
 
 	connectedDevice->numBytesSendingNow = 0; // We just do this instead from caller on A1 (see comment above)
 
-	// check if there was more to send on the same device, then resume sending
+	// Refill this device's transfer buffer from its ring buffer, if more got queued up while that transfer was going
 	bool has_more = connectedDevice->consumeSendData();
-	if (has_more) {
-		// TODO: do some cooperative scheduling here. so if there is a flood of data
-		// on connected device 1 and we just want to send a few notes on device 2,
-		// make sure device 2 ges a fair shot now and then
-
-		flushUSBMIDIToHostedDevice(ip, midiDeviceNum, true);
-		return;
-	}
-
-	// If that was the last device we were going to send to, that send's been done, so we can just get out.
-	if (midiDeviceNum == stopSendingAfterDeviceNum[ip]) {
-		anyUSBSendingStillHappening[ip] = 0;
-		return;
-	}
 
+	// Take turns: if any other device has a batch waiting, it gets sent before this one's next batch. Otherwise, a
+	// flood of data to one device on a hub (e.g. dense CC automation) would hold up everything for the others.
+	// numBytesSendingNow is nonzero exactly for devices with a batch consumed but not yet sent
+	int32_t d = midiDeviceNum;
 	while (true) {
-		midiDeviceNum++;
-		if (midiDeviceNum >= MAX_NUM_USB_MIDI_DEVICES) {
-			midiDeviceNum -= MAX_NUM_USB_MIDI_DEVICES;
+		d++;
+		if (d >= MAX_NUM_USB_MIDI_DEVICES) {
+			d -= MAX_NUM_USB_MIDI_DEVICES;
 		}
-		connectedDevice = &connectedUSBMIDIDevices[ip][midiDeviceNum];
-		if (connectedDevice->device && connectedDevice->numBytesSendingNow) {
-			// If here, we got a connected device, so flush
-			flushUSBMIDIToHostedDevice(ip, midiDeviceNum);
-			return;
+		if (d == midiDeviceNum) {
+			break;
 		}
-		if (midiDeviceNum
-		    == stopSendingAfterDeviceNum
-		        [ip]) { // If reached end of devices and last one got disconnected in the interim (very rare)
-			usbDeviceNumBeingSentToNow[ip] = stopSendingAfterDeviceNum[ip];
-			anyUSBSendingStillHappening[ip] = 0;
+		ConnectedUSBMIDIDevice* otherDevice = &connectedUSBMIDIDevices[ip][d];
+		if (otherDevice->device && otherDevice->numBytesSendingNow) {
+			flushUSBMIDIToHostedDevice(ip, d);
 			return;
 		}
 	}
+
+	// No one else waiting, so carry on with the same device. The pipe's still set up for it
+	if (has_more) {
+		flushUSBMIDIToHostedDevice(ip, midiDeviceNum, true);
+		return;
+	}
+
+	usbDeviceNumBeingSentToNow[ip] = stopSendingAfterDeviceNum[ip];
+	anyUSBSendingStillHappening[ip] = 0;
 }
 
 // We now bypass calling this for successful as peripheral on A1 (see usb_pstd_bemp_pipe_process_rohan_midi())
@@ -217,6 +214,7 @@ MidiEngine::MidiEngine() {
 	numSerialMidiInput = 0;
 	lastStatusByteSent = 0;
 	currentlyReceivingSysExSerial = false;
+	writingToOutputBuffers = false;
 	midiThru = false;
 	midiTakeover = MIDITakeoverMode::JUMP;
 
@@ -269,11 +267,13 @@ void flushUSBMIDIToHostedDevice(int32_t ip, int32_t d, bool resume) {
 			                                g_usb_hmidi_tmp_ep_tbl[USB_CFG_USE_USBIP][d], connectedDevice->sq);
 		}
 
-		connectedDevice->sq = !connectedDevice->sq;
-
 		g_p_usb_pipe[pipeNumber] = &g_usb_midi_send_utr[USB_CFG_USE_USBIP];
 	}
 
+	// Host-mode transfers are capped at one packet (see consumeSendData()), so each one flips the data toggle. That
+	// has to be tracked on resumed sends too, now that sends to different devices get interleaved
+	connectedDevice->sq = !connectedDevice->sq;
+
 	usb_send_start_rohan(&g_usb_midi_send_utr[USB_CFG_USE_USBIP], pipeNumber, connectedDevice->dataSendingNow,
 	                     connectedDevice->numBytesSendingNow);
 }
@@ -478,6 +478,8 @@ void MidiEngine::sendPolyphonicAftertouch(int32_t channel, uint8_t value, uint8_
 
 void MidiEngine::sendMidi(uint8_t statusType, uint8_t channel, uint8_t data1, uint8_t data2, int32_t filter,
                           bool sendUSB) {
+	writingToOutputBuffers = true;
+
 	// Send USB MIDI
 	if (sendUSB) {
 		sendUsbMidi(statusType, channel, data1, data2, filter);
@@ -487,6 +489,49 @@ void MidiEngine::sendMidi(uint8_t statusType, uint8_t channel, uint8_t data1, ui
 	if (statusType == 0x0F || MIDIDeviceManager::dinMIDIPorts.wantsToOutputMIDIOnChannel(channel, filter)) {
 		sendSerialMidi(statusType, channel, data1, data2);
 	}
+
+	writingToOutputBuffers = false;
+}
+
+void MidiEngine::sendMidiAtTime(uint32_t time, uint8_t statusType, uint8_t channel, uint8_t data1, uint8_t data2,
+                                int32_t filter, bool sendUSB) {
+	TimedMIDIMessage message;
+	message.time = time;
+	message.filter = filter;
+	message.statusType = statusType;
+	message.channel = channel;
+	message.data1 = data1;
+	message.data2 = data2;
+	message.sendUSB = sendUSB;
+
+	// If the queue's full, sending it early beats not sending it at all
+	if (!timedOutputQueue.push(message)) {
+		sendMidi(statusType, channel, data1, data2, filter, sendUSB);
+	}
+}
+
+void MidiEngine::sendClockAtTime(uint32_t time, bool sendUSB) {
+	sendMidiAtTime(time, 0x0F, 0x08, 0, 0, kMIDIOutputFilterNoMPE, sendUSB);
+}
+
+// Only to be called from the MIDI / gate output timer ISR. Moves every queued message due by the given time into the
+// output buffers. Returns false if it couldn't because the interrupted code was itself writing to those buffers -
+// the caller should try again very shortly.
+bool MidiEngine::sendTimedOutputDueBy(uint32_t time) {
+	if (writingToOutputBuffers) {
+		return false;
+	}
+
+	// Messages are queued in time order, so we can stop at the first one that's not yet due
+	while (!timedOutputQueue.empty()) {
+		TimedMIDIMessage& message = timedOutputQueue.front();
+		if ((int32_t)(message.time - time) > 0) {
+			break;
+		}
+		sendMidi(message.statusType, message.channel, message.data1, message.data2, message.filter, message.sendUSB);
+		timedOutputQueue.pop();
+	}
+	return true;
 }
 
 uint32_t setupUSBMessage(uint8_t statusType, uint8_t channel, uint8_t data1, uint8_t data2) {
@@ -544,6 +589,7 @@ void MidiEngine::sendUsbMidi(uint8_t statusType, uint8_t channel, uint8_t data1,
 
 // Warning - this will sometimes (not always) be called in an ISR
 void MidiEngine::flushMIDI() {
+	TRACE_SCOPE(MIDI_FLUSH);
 	flushUSBMIDIOutput();
 	uartFlushIfNotSending(UART_ITEM_MIDI);
 }
@@ -761,6 +807,10 @@ void MidiEngine::midiSysexReceived(MIDIDevice* device, uint8_t* data, int32_t le
 			Debug::sysexReceived(device, data, len);
 			break;
 
+		case 4:
+			SysexFileTransfer::sysexReceived(device, data, len);
+			break;
+
 		case 0x7f: // PONG, reserved
 		default:
 			break;
@@ -949,7 +999,10 @@ void MidiEngine::midiMessageReceived(MIDIDevice* fromDevice, uint8_t statusType,
 				}
 				// No break
 
-			case 0x08: // Note off, and note on continues here too
+			case 0x08: { // Note off, and note on continues here too
+				Debug::NoteLatencyInput latencyInput(fromDevice == &MIDIDeviceManager::dinMIDIPorts
+				                                         ? Debug::LatencySource::MIDI_DIN
+				                                         : Debug::LatencySource::MIDI_USB);
 				playbackHandler.noteMessageReceived(fromDevice, statusType & 1, channel, data1, data2,
 				                                    &shouldDoMidiThruNow);
 #if MISSING_MESSAGE_CHECK
@@ -958,6 +1011,7 @@ void MidiEngine::midiMessageReceived(MIDIDevice* fromDevice, uint8_t statusType,
 				lastWasNoteOn = statusType & 1;
 #endif
 				break;
+			}
 
 			case 0x0A: // Polyphonic aftertouch
 				playbackHandler.aftertouchReceived(fromDevice, channel, data2, data1, &shouldDoMidiThruNow);
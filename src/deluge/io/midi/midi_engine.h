@@ -22,9 +22,13 @@
 #include "definitions_cxx.hpp"
 #include "io/midi/learned_midi.h"
 #include "playback/playback_handler.h"
+#include "util/container/spsc_queue.h"
 
 class MIDIDevice;
 
+// Enough for a few MIDI clock-out ticks falling mid-window, plus headroom.
+constexpr int32_t kTimedMIDIOutputQueueSize = 16;
+
 class MidiEngine {
 public:
 	MidiEngine();
@@ -55,6 +59,17 @@ public:
 	void sendChannelAftertouch(int32_t channel, uint8_t value, int32_t filter);
 	void sendPolyphonicAftertouch(int32_t channel, uint8_t value, uint8_t noteCode, int32_t filter);
 	bool anythingInOutputBuffer();
+
+	// For messages which belong at a specific point in the audio window being rendered, rather than right at its start.
+	// They're held back, stamped with their time in AudioEngine::audioSampleTimer terms, and only put into the output
+	// buffers once the MIDI / gate output timer says the audio output has reached that point.
+	void sendMidiAtTime(uint32_t time, uint8_t statusType, uint8_t channel, uint8_t data1 = 0, uint8_t data2 = 0,
+	                    int32_t filter = kMIDIOutputFilterNoMPE, bool sendUSB = true);
+	void sendClockAtTime(uint32_t time, bool sendUSB = true);
+	bool anythingInTimedOutputQueue() { return !timedOutputQueue.empty(); }
+	uint32_t getNextTimedOutputTime() { return timedOutputQueue.front().time; }
+	bool sendTimedOutputDueBy(uint32_t time);
+
 	void setupUSBHostReceiveTransfer(int32_t ip, int32_t midiDeviceNum);
 	void flushUSBMIDIOutput();
 
@@ -75,6 +90,22 @@ private:
 
 	bool currentlyReceivingSysExSerial;
 
+	struct TimedMIDIMessage {
+		uint32_t time;
+		int32_t filter;
+		uint8_t statusType;
+		uint8_t channel;
+		uint8_t data1;
+		uint8_t data2;
+		bool sendUSB;
+	};
+
+	// Pushed to only by the audio routine and popped only by the timer ISR
+	SPSCQueue<TimedMIDIMessage, kTimedMIDIOutputQueueSize> timedOutputQueue;
+
+	// Set while sendMidi() is part-way through writing to the output buffers, which the timer ISR mustn't touch then
+	volatile bool writingToOutputBuffers;
+
 	int32_t getMidiMessageLength(uint8_t statusuint8_t);
 	void midiMessageReceived(MIDIDevice* fromDevice, uint8_t statusType, uint8_t channel, uint8_t data1, uint8_t data2,
 	                         uint32_t* timer = NULL);
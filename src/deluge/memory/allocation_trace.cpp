@@ -0,0 +1,94 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "memory/allocation_trace.h"
+
+#if ENABLE_ALLOCATION_TRACE && !defined(IN_UNIT_TESTS)
+
+#include "RTT/SEGGER_RTT.h"
+#include "memory/general_memory_allocator.h"
+#include "processing/engines/audio_engine.h"
+#include <algorithm>
+
+namespace AllocationTrace {
+
+// Must be a power of 2
+constexpr uint32_t kNumEntries = 1024;
+
+// What RTT itself buffers for the host to pick up - a few drains' worth
+constexpr uint32_t kRTTBufferSize = 256 * sizeof(AllocationTraceEntry);
+
+constexpr unsigned kRTTChannel = 1;
+
+AllocationTraceEntry entries[kNumEntries];
+uint32_t numWritten = 0; // Both these just keep counting up, and get wrapped when used as indexes
+uint32_t numDrained = 0;
+uint32_t numLost = 0;
+
+char rttBuffer[kRTTBufferSize];
+bool rttConfigured = false;
+
+void record(AllocationTraceEvent event, void* address, uint32_t size, uint8_t tag, void* caller) {
+	if (numWritten - numDrained >= kNumEntries) {
+		numLost++;
+		return;
+	}
+
+	AllocationTraceEntry& entry = entries[numWritten & (kNumEntries - 1)];
+	entry.time = AudioEngine::audioSampleTimer;
+	entry.address = (uint32_t)address;
+	entry.size = size;
+	entry.caller = (uint32_t)caller;
+	entry.event = event;
+	entry.region = GeneralMemoryAllocator::get().getRegion(address);
+	entry.tag = tag;
+	entry.reserved = 0;
+	numWritten++;
+}
+
+// Sends as many whole entries as RTT has room for. Ones it can't fit stay in the ring for next time.
+void drain() {
+	if (!rttConfigured) {
+		SEGGER_RTT_ConfigUpBuffer(kRTTChannel, "AllocTrace", rttBuffer, kRTTBufferSize, SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+		rttConfigured = true;
+	}
+
+	uint32_t numCanSend = SEGGER_RTT_GetAvailWriteSpace(kRTTChannel) / sizeof(AllocationTraceEntry);
+
+	if (numLost && numCanSend) {
+		AllocationTraceEntry lostEntry = {};
+		lostEntry.time = AudioEngine::audioSampleTimer;
+		lostEntry.size = numLost;
+		lostEntry.event = AllocationTraceEvent::LOST;
+		SEGGER_RTT_Write(kRTTChannel, &lostEntry, sizeof(lostEntry));
+		numLost = 0;
+		numCanSend--;
+	}
+
+	while (numCanSend && numDrained != numWritten) {
+		// Up to the end of the ring, or of what's been written, whichever comes first
+		uint32_t startIndex = numDrained & (kNumEntries - 1);
+		uint32_t numHere = std::min({numWritten - numDrained, kNumEntries - startIndex, numCanSend});
+		SEGGER_RTT_Write(kRTTChannel, &entries[startIndex], numHere * sizeof(AllocationTraceEntry));
+		numDrained += numHere;
+		numCanSend -= numHere;
+	}
+}
+
+} // namespace AllocationTrace
+
+#endif
@@ -0,0 +1,65 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+/*
+ * A low-overhead record of everything the GeneralMemoryAllocator does, for digging into fragmentation and memory
+ * glitches after the fact. Only built in with ENABLE_ALLOCATION_TRACE (which needs RTT). Each event goes into a fixed
+ * ring buffer, and the main loop drains that, as raw AllocationTraceEntrys, out over RTT up-channel 1 - leaving
+ * channel 0 for the usual text. contrib/debug/alloc_trace.py turns a capture of that channel back into a timeline.
+ * If the ring fills up faster than it's drained, entries are dropped and a LOST entry says how many.
+ */
+
+enum class AllocationTraceEvent : uint8_t {
+	ALLOC,
+	DEALLOC,
+	EXTEND,  // size is the new total size
+	SHORTEN, // size is the new total size
+	STEAL,
+	LOST,     // size is how many entries got dropped
+	RELOCATE, // address is the new address, and size is the old one
+};
+
+struct AllocationTraceEntry {
+	uint32_t time; // In audio samples
+	uint32_t address;
+	uint32_t size;
+	uint32_t caller; // Return address of whatever called into the allocator
+	AllocationTraceEvent event;
+	uint8_t region;
+	uint8_t tag; // An AllocationTag, for ALLOC events
+	uint8_t reserved;
+};
+
+static_assert(sizeof(AllocationTraceEntry) == 20, "alloc_trace.py relies on this layout");
+
+#if ENABLE_ALLOCATION_TRACE && !defined(IN_UNIT_TESTS)
+namespace AllocationTrace {
+void record(AllocationTraceEvent event, void* address, uint32_t size, uint8_t tag, void* caller);
+void drain();
+} // namespace AllocationTrace
+
+// A macro, so the caller it records is the one of the function it's used in
+#define TRACE_ALLOCATION(event, address, size, tag)                                                                    \
+	AllocationTrace::record(AllocationTraceEvent::event, (void*)(address), (size), (uint8_t)(tag),                     \
+	                        __builtin_return_address(0))
+#else
+#define TRACE_ALLOCATION(event, address, size, tag)
+#endif
@@ -0,0 +1,84 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "memory/arena_allocator.h"
+#include "memory/general_memory_allocator.h"
+#include <string.h>
+
+ArenaAllocator loadArena{};
+
+bool ArenaAllocator::begin(uint32_t size) {
+	uint32_t allocatedSize;
+	void* block = GeneralMemoryAllocator::get().alloc(size, &allocatedSize, false, false);
+	if (!block) {
+		return false;
+	}
+	blockStart = (uint32_t)block;
+	blockEnd = blockStart + allocatedSize;
+	nextFree = blockStart;
+	return true;
+}
+
+void ArenaAllocator::end() {
+	if (!blockStart) {
+		return;
+	}
+	void* block = (void*)blockStart;
+	blockStart = 0;
+	blockEnd = 0;
+	nextFree = 0;
+	GeneralMemoryAllocator::get().dealloc(block);
+}
+
+// Returns NULL if there's no room left, in which case the caller is expected to fall back on ordinary allocation
+void* ArenaAllocator::alloc(uint32_t requiredSize) {
+	requiredSize = (requiredSize + 3) & ~(uint32_t)3;
+	if (!blockStart || nextFree + 4 + requiredSize > blockEnd || requiredSize > SPACE_SIZE_MASK) {
+		return nullptr;
+	}
+	uint32_t* header = (uint32_t*)nextFree;
+	*header = SPACE_HEADER_ALLOCATED | requiredSize;
+	nextFree += 4 + requiredSize;
+	return header + 1;
+}
+
+void* ArenaAllocator::commit(void* address, uint32_t size) {
+	void* newMemory = GeneralMemoryAllocator::get().alloc(size, NULL, false, true);
+	if (newMemory) {
+		memcpy(newMemory, address, size);
+	}
+	return newMemory;
+}
+
+ArenaScope::ArenaScope(ArenaAllocator& newArena, uint32_t size) {
+	GeneralMemoryAllocator& gma = GeneralMemoryAllocator::get();
+	if (gma.activeArena) {
+		return;
+	}
+	// If we couldn't get a block, temporaries just come from ordinary memory like they always did
+	if (newArena.begin(size)) {
+		arena = &newArena;
+		gma.activeArena = arena;
+	}
+}
+
+ArenaScope::~ArenaScope() {
+	if (arena) {
+		GeneralMemoryAllocator::get().activeArena = nullptr;
+		arena->end();
+	}
+}
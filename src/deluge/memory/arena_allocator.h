@@ -0,0 +1,69 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+// How much a load's arena asks for from SDRAM up front
+constexpr uint32_t kLoadArenaSize = 64 * 1024;
+
+/*
+ * An arena hands out memory for temporaries from one big block, by just bumping a pointer along it. Freeing an
+ * individual allocation does nothing - the whole block goes back to the MemoryRegion in one go when the arena ends.
+ * That makes lots of short-lived little allocations nearly free, stops them fragmenting the region, and means code
+ * that gets abandoned half way through (like a failed or cancelled load) has nothing to unwind.
+ *
+ * Each allocation still gets a 4-byte header like any other, so getAllocatedSize() works, but arena memory can't be
+ * shortened or extended. Anything that needs to outlive the arena has to be copied out with commit().
+ */
+class ArenaAllocator {
+public:
+	ArenaAllocator() = default;
+
+	bool begin(uint32_t size);
+	void end();
+	[[nodiscard]] bool isActive() const { return blockStart != 0; }
+
+	void* alloc(uint32_t requiredSize);
+
+	/// Copies an allocation out into ordinary memory that will survive the arena ending. Returns NULL if out of RAM.
+	void* commit(void* address, uint32_t size);
+
+	[[nodiscard]] inline bool contains(void* address) const {
+		return (uint32_t)address >= blockStart && (uint32_t)address < blockEnd;
+	}
+
+private:
+	uint32_t blockStart = 0;
+	uint32_t blockEnd = 0;
+	uint32_t nextFree = 0;
+};
+
+/// Makes the given arena the one GeneralMemoryAllocator::allocTemporary() uses, for as long as this object lives. If
+/// an arena is already active - say, an instrument being loaded as part of a song - that one just carries on being used.
+class ArenaScope {
+public:
+	ArenaScope(ArenaAllocator& newArena, uint32_t size);
+	~ArenaScope();
+
+private:
+	ArenaAllocator* arena = nullptr;
+};
+
+/// The arena that song and preset loading use
+extern ArenaAllocator loadArena;
@@ -3,11 +3,22 @@
 #include "memory/memory_region.h"
 #include "memory/stealable.h"
 #include "processing/engines/audio_engine.h"
+#include <algorithm>
 #include <tuple>
 
 extern bool skipConsistencyCheck;
 uint32_t currentTraversalNo = 0;
 
+// How many adequate Stealables in a queue ReclaimMemory() will compare before just taking the best of them
+constexpr int32_t kMaxReclaimCandidates = 8;
+
+// How much one cluster read of reload cost counts for, against each place further along the queue a Stealable is
+constexpr uint32_t kStealCostWeight = 4;
+
+// How many spaces each way MeasureRun() looks before giving up. Runs really are only ever a few spaces long, as empty
+// neighbours get merged.
+constexpr int32_t kMaxRunMeasureSteps = 4;
+
 // Size 0 means don't care, just get any memory.
 uint32_t CacheManager::ReclaimMemory(MemoryRegion& region, int32_t totalSizeNeeded, void* thingNotToStealFrom,
                                      int32_t* __restrict__ foundSpaceSize) {
@@ -44,9 +55,26 @@ uint32_t CacheManager::ReclaimMemory(MemoryRegion& region, int32_t totalSizeNeed
 		}
 
 		uint32_t longestRunSeenInThisQueue = 0;
+		bool reachedEndOfQueue = true;
+
+		// Rather than just taking the first adequate Stealable, we weigh up the first few for how much it'd cost to get
+		// back what we'd steal - which for ones needing neighbouring memory too may include things from other queues.
+		// Being further from the least-recently-queued end of the queue costs a little too.
+		Stealable* bestStealable = nullptr;
+		uint32_t bestScore = 0xFFFFFFFF;
+		bool bestNeedsNeighbours = false;
+		int32_t numCandidates = 0;
 
 		stealable = static_cast<Stealable*>(reclamation_queue_[q].getFirst());
 		while (stealable != nullptr) {
+			// Once nothing further along could beat the best so far - as everything costs at least 1 to reload - stop
+			if (bestStealable
+			    && (numCandidates >= kMaxReclaimCandidates
+			        || bestScore <= kStealCostWeight * (q + 2) + numCandidates)) {
+				reachedEndOfQueue = false;
+				break;
+			}
+
 			// If we've already looked at this one as part of a bigger run, move on
 			uint32_t lastTraversalQueue = stealable->lastTraversalNo - traversalNumberBeforeQueues;
 			if (lastTraversalQueue <= q) {
@@ -108,46 +136,83 @@ uint32_t CacheManager::ReclaimMemory(MemoryRegion& region, int32_t totalSizeNeed
 
 			// How much additional space would we need on top of this Stealable?
 			int32_t amountToExtend = totalSizeNeeded - spaceSize;
+			uint32_t stealCost = GetStealCost(stealable);
+
+			// If that one Stealable alone isn't big enough, see if available neighbouring memory adds up to make enough
+			// in total - just exploring for now, and finding out what else we'd have to steal
+			if (amountToExtend > 0) {
+				NeighbouringMemoryGrabAttemptResult result =
+				    region.attemptToGrabNeighbouringMemory(stealable, spaceSize, amountToExtend, amountToExtend,
+				                                           thingNotToStealFrom, currentTraversalNo, true, true);
+
+				// If that couldn't be done, move on to next Stealable to assess
+				if (!result.address) {
+					if (result.longestRunFound > longestRunSeenInThisQueue) {
+						longestRunSeenInThisQueue = result.longestRunFound;
+					}
+					stealable = static_cast<Stealable*>(reclamation_queue_[q].getNext(stealable));
+					continue;
+				}
+				stealCost += result.stealCost;
+			}
+
+			// Whichever we don't pick will still be here next time, so count it as a run we saw
+			uint32_t runLength = std::max<uint32_t>(spaceSize, totalSizeNeeded);
+			if (runLength > longestRunSeenInThisQueue) {
+				longestRunSeenInThisQueue = runLength;
+			}
 
+			uint32_t score = stealCost * kStealCostWeight + numCandidates;
+			numCandidates++;
+			if (score < bestScore) {
+				bestScore = score;
+				bestStealable = stealable;
+				bestNeedsNeighbours = (amountToExtend > 0);
+			}
+
+			stealable = static_cast<Stealable*>(reclamation_queue_[q].getNext(stealable));
+		}
+
+		if (bestStealable) {
+			stealable = bestStealable;
+			uint32_t* __restrict__ header = (uint32_t*)((uint32_t)stealable - 4);
+			spaceSize = (*header & SPACE_SIZE_MASK);
 			newSpaceAddress = (uint32_t)stealable;
 
 			// If that one Stealable alone was big enough, that's great
-			if (amountToExtend <= 0) {
+			if (!bestNeedsNeighbours) {
 				found = true;
-				break;
 			}
 
-			// Otherwise, see if available neighbouring memory adds up to make enough in total
-			NeighbouringMemoryGrabAttemptResult result = region.attemptToGrabNeighbouringMemory(
-			    stealable, spaceSize, amountToExtend, amountToExtend, thingNotToStealFrom, currentTraversalNo, true);
-
-			// We also told that function to steal the initial main Stealable we are looking at, once it has ascertained that there is enough memory in total.
-			// Previously I attempted to have it steal everything but that central Stealable, and we would steal that afterwards, down below, but this could go wrong
-			// as thefts occurring in the above call to attemptToGrabNeighbouringMemory() could themselves cause other memory to be deallocated or shortened -
-			// and what if this happened to our main, central Stealable before we actually steal it?
-			// This was certainly a problem in automated testing, though I haven't quite wrapped my head around whether this would quite occur under real operation -
-			// but oh well, there is no harm in taking the safe option.
-
-			// If that couldn't be done (in which case the original, central Stealable won't have been stolen either), move on to next Stealable to assess
-			if (!result.address) {
-				if (result.longestRunFound > longestRunSeenInThisQueue) {
-					longestRunSeenInThisQueue = result.longestRunFound;
+			// Otherwise, grab the neighbouring memory for real this time
+			else {
+				int32_t amountToExtend = totalSizeNeeded - spaceSize;
+				NeighbouringMemoryGrabAttemptResult result = region.attemptToGrabNeighbouringMemory(
+				    stealable, spaceSize, amountToExtend, amountToExtend, thingNotToStealFrom, currentTraversalNo, true);
+
+				// We also told that function to steal the initial main Stealable we are looking at, once it has ascertained that there is enough memory in total.
+				// Previously I attempted to have it steal everything but that central Stealable, and we would steal that afterwards, down below, but this could go wrong
+				// as thefts occurring in the above call to attemptToGrabNeighbouringMemory() could themselves cause other memory to be deallocated or shortened -
+				// and what if this happened to our main, central Stealable before we actually steal it?
+				// This was certainly a problem in automated testing, though I haven't quite wrapped my head around whether this would quite occur under real operation -
+				// but oh well, there is no harm in taking the safe option.
+
+				// Nothing's changed since we explored, so this should always work - but if not, the original, central
+				// Stealable won't have been stolen either, and we just carry on to the next queue
+				if (result.address) {
+					newSpaceAddress = result.address;
+					spaceSize += result.amountsExtended[0] + result.amountsExtended[1];
+
+					Debug::println("stole and grabbed neighbouring stuff too...........");
+					stolen = true;
 				}
-				stealable = static_cast<Stealable*>(reclamation_queue_[q].getNext(stealable));
-				continue;
 			}
-
-			newSpaceAddress = result.address;
-
-			spaceSize += result.amountsExtended[0] + result.amountsExtended[1];
-
-			Debug::println("stole and grabbed neighbouring stuff too...........");
-			stolen = true;
-			break;
 		}
 
-		// End of that particular queue - so go to the next one
-		longest_runs_[q] = longestRunSeenInThisQueue;
+		// Only if we actually looked at everything in this queue do we know its longest run
+		if (reachedEndOfQueue) {
+			longest_runs_[q] = longestRunSeenInThisQueue;
+		}
 		currentTraversalNo++;
 	}
 
@@ -163,6 +228,7 @@ uint32_t CacheManager::ReclaimMemory(MemoryRegion& region, int32_t totalSizeNeed
 		// Warning - for perc cache Cluster, stealing one can cause it to want to allocate more memory for its list of zones
 		stealable->steal("i007");
 		stealable->~Stealable();
+		RecordSteal(stealable, spaceSize);
 	}
 
 	// At this point we have either found or stolen to be true
@@ -175,3 +241,65 @@ uint32_t CacheManager::ReclaimMemory(MemoryRegion& region, int32_t totalSizeNeed
 
 	return newSpaceAddress;
 }
+
+int32_t CacheManager::GetQueueIndex(Stealable* stealable) {
+	BidirectionalLinkedList* list = stealable->list;
+	if (list < reclamation_queue_.data() || list >= reclamation_queue_.data() + NUM_STEALABLE_QUEUES) {
+		return -1;
+	}
+	return list - reclamation_queue_.data();
+}
+
+uint32_t CacheManager::GetStealCost(Stealable* stealable) {
+	// Things in later queues are more likely to be wanted again soon, so stealing them costs more
+	int32_t q = GetQueueIndex(stealable);
+	return stealable->getReloadCost() * (q + 2);
+}
+
+uint32_t CacheManager::MeasureRun(Stealable* stealable) {
+	uint32_t* __restrict__ header = (uint32_t*)((uint32_t)stealable - 4);
+	uint32_t run = (*header & SPACE_SIZE_MASK);
+
+	// Every MemoryRegion starts and ends with an allocated-type header, so we can't walk off either end
+	uint32_t* __restrict__ lookRight = (uint32_t*)((uint32_t)stealable + run + 4);
+	for (int32_t i = 0; i < kMaxRunMeasureSteps && (*lookRight & SPACE_TYPE_MASK) != SPACE_HEADER_ALLOCATED; i++) {
+		uint32_t spaceSize = (*lookRight & SPACE_SIZE_MASK);
+		run += spaceSize + 8;
+		lookRight = (uint32_t*)((uint32_t)lookRight + spaceSize + 8);
+	}
+
+	uint32_t* __restrict__ lookLeft = (uint32_t*)((uint32_t)stealable - 8);
+	for (int32_t i = 0; i < kMaxRunMeasureSteps && (*lookLeft & SPACE_TYPE_MASK) != SPACE_HEADER_ALLOCATED; i++) {
+		uint32_t spaceSize = (*lookLeft & SPACE_SIZE_MASK);
+		run += spaceSize + 8;
+		lookLeft = (uint32_t*)((uint32_t)lookLeft - spaceSize - 8);
+	}
+
+	return run;
+}
+
+void CacheManager::NoteRunChanged(Stealable* stealable) {
+	int32_t q = GetQueueIndex(stealable);
+	if (q < 0) {
+		return;
+	}
+	uint32_t run = MeasureRun(stealable);
+	if (run > longest_runs_[q]) {
+		longest_runs_[q] = run;
+	}
+}
+
+uint32_t CacheManager::GetStealableBytes(size_t q, int32_t* num_stealables) {
+	uint32_t total = 0;
+	int32_t num = 0;
+	for (auto* stealable = static_cast<Stealable*>(reclamation_queue_[q].getFirst()); stealable != nullptr;
+	     stealable = static_cast<Stealable*>(reclamation_queue_[q].getNext(stealable))) {
+		uint32_t* __restrict__ header = (uint32_t*)((uint32_t)stealable - 4);
+		total += (*header & SPACE_SIZE_MASK) + 8;
+		num++;
+	}
+	if (num_stealables != nullptr) {
+		*num_stealables = num;
+	}
+	return total;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "definitions_cxx.hpp"
+#include "memory/allocation_trace.h"
 #include "memory/stealable.h"
 #include "util/container/list/bidirectional_linked_list.h"
 #include <array>
@@ -18,17 +19,42 @@ public:
 
 	void QueueForReclamation(size_t q, Stealable* stealable) {
 		reclamation_queue_[q].addToEnd(stealable);
-		longest_runs_[q] = 0xFFFFFFFF; // TODO: actually investigate neighbouring memory "run".
+		NoteRunChanged(stealable);
 	}
 
+	/// Call when memory next to a queued Stealable has been freed, so the run of reclaimable memory it's part of may
+	/// have got longer
+	void NoteRunChanged(Stealable* stealable);
+
+	/// What it'd cost to steal this - its reload cost, weighted by how likely its queue says it is to be wanted again
+	uint32_t GetStealCost(Stealable* stealable);
+
 	uint32_t ReclaimMemory(MemoryRegion& region, int32_t totalSizeNeeded, void* thingNotToStealFrom,
 	                       int32_t* __restrict__ foundSpaceSize);
 
+	/// Total size, headers included, of everything waiting in queue q to be stolen. Walks the whole queue, so is only
+	/// for telemetry - don't call it from anything time-critical.
+	uint32_t GetStealableBytes(size_t q, int32_t* num_stealables = nullptr);
+
+	void RecordSteal(void* address, uint32_t size) {
+		num_steals_++;
+		TRACE_ALLOCATION(STEAL, address, size, 0);
+	}
+
+	/// How many Stealables have had their memory stolen since startup
+	[[nodiscard]] uint32_t num_steals() const { return num_steals_; }
+
 private:
+	int32_t GetQueueIndex(Stealable* stealable);
+	static uint32_t MeasureRun(Stealable* stealable);
+
 	std::array<BidirectionalLinkedList, NUM_STEALABLE_QUEUES> reclamation_queue_;
 
 	// Keeps track, semi-accurately, of biggest runs of memory that could be stolen. In a perfect world, we'd have a second
 	// index on stealableClusterQueues[q], for run length. Although even that wouldn't automatically reflect changes to run
-	// lengths as neighbouring memory is allocated.
-	std::array<uint32_t, NUM_STEALABLE_QUEUES> longest_runs_;
+	// lengths as neighbouring memory is allocated. Raised whenever something is queued or has memory freed next to it,
+	// and set back to what was actually seen whenever ReclaimMemory() gets to the end of a queue.
+	std::array<uint32_t, NUM_STEALABLE_QUEUES> longest_runs_{};
+
+	uint32_t num_steals_ = 0;
 };
@@ -17,8 +17,10 @@
 
 #include "memory/general_memory_allocator.h"
 #include "definitions_cxx.hpp"
+#include "memory/allocation_trace.h"
 #include "hid/display/display.h"
 #include "io/debug/print.h"
+#include "memory/relocatable.h"
 #include "memory/stealable.h"
 #include "processing/engines/audio_engine.h"
 #include "storage/cluster/cluster.h"
@@ -44,6 +46,7 @@ GeneralMemoryAllocator::GeneralMemoryAllocator() {
 	                                      EXTERNAL_MEMORY_END - RESERVED_NONAUDIO_ALLOCATOR, EXTERNAL_MEMORY_END);
 	regions[MEMORY_REGION_INTERNAL].setup(emptySpacesMemoryInternal, sizeof(emptySpacesMemoryInternal),
 	                                      (uint32_t)&__heap_start, (uint32_t)&program_stack_start);
+	nonAudioSlabs.setup(&regions[MEMORY_REGION_NONAUDIO]);
 
 #if ALPHA_OR_BETA_VERSION
 	regions[MEMORY_REGION_SDRAM].name = "external";
@@ -104,12 +107,59 @@ void* GeneralMemoryAllocator::allocNonAudio(uint32_t requiredSize) {
 		//numericDriver.freezeWithError("M998");
 		return nullptr;
 	}
+	countAllocation(AllocationTag::NON_AUDIO);
+	TRACE_ALLOCATION(ALLOC, address, getAllocatedSize(address), AllocationTag::NON_AUDIO);
 	return address;
 }
 void GeneralMemoryAllocator::deallocNonAudio(void* address) {
+	if (activeArena && activeArena->contains(address)) {
+		return; // Goes when the whole arena does
+	}
+	TRACE_ALLOCATION(DEALLOC, address, 0, 0);
+	if (SlabAllocator::isSlabAllocation(address)) {
+		nonAudioSlabs.dealloc(address);
+		return;
+	}
 	return regions[MEMORY_REGION_NONAUDIO].dealloc(address);
 }
 
+// Like allocNonAudio(), but small sizes come out of the slab allocator - which is faster and doesn't fragment the region.
+// Memory from here may be given back with dealloc() or deallocNonAudio() as usual, but can't be shortened or extended,
+// and its size has to be got with SlabAllocator::getAllocatedSize() instead of ours.
+void* GeneralMemoryAllocator::allocNonAudioSmall(uint32_t requiredSize) {
+	if (requiredSize > kMaxSlabObjectSize) {
+		return allocNonAudio(requiredSize);
+	}
+
+	if (lock) {
+		return NULL;
+	}
+
+	lock = true;
+	void* address = nonAudioSlabs.alloc(requiredSize);
+	lock = false;
+	if (address) {
+		countAllocation(AllocationTag::SLAB);
+		TRACE_ALLOCATION(ALLOC, address, requiredSize, AllocationTag::SLAB);
+	}
+	return address;
+}
+
+// For things that won't outlive whatever's going on right now. While an ArenaScope is active - e.g. during a song or
+// preset load - these come out of its arena, and freeing them early is optional; otherwise it's just a normal alloc().
+// Either way, don't shorten or extend them.
+void* GeneralMemoryAllocator::allocTemporary(uint32_t requiredSize) {
+	if (activeArena) {
+		void* address = activeArena->alloc(requiredSize);
+		if (address) {
+			countAllocation(AllocationTag::TEMPORARY);
+			TRACE_ALLOCATION(ALLOC, address, getAllocatedSize(address), AllocationTag::TEMPORARY);
+			return address;
+		}
+	}
+	return alloc(requiredSize, NULL, false, true);
+}
+
 // Watch the heck out - in the older V3.1 branch, this had one less argument - makeStealable was missing - so in code from there, thingNotToStealFrom could be interpreted as makeStealable!
 // requiredSize 0 means get biggest allocation available.
 void* GeneralMemoryAllocator::alloc(uint32_t requiredSize, uint32_t* getAllocatedSize, bool mayDeleteFirstUndoAction,
@@ -132,6 +182,9 @@ void* GeneralMemoryAllocator::alloc(uint32_t requiredSize, uint32_t* getAllocate
 		//uint16_t endTime = *TCNT[TIMER_SYSTEM_FAST];
 		lock = false;
 		if (address) {
+			countAllocation(makeStealable ? AllocationTag::STEALABLE : AllocationTag::INTERNAL);
+			TRACE_ALLOCATION(ALLOC, address, this->getAllocatedSize(address),
+			                 makeStealable ? AllocationTag::STEALABLE : AllocationTag::INTERNAL);
 
 			/*
 			uint16_t timeTaken = endTime - startTime;
@@ -166,6 +219,11 @@ void* GeneralMemoryAllocator::alloc(uint32_t requiredSize, uint32_t* getAllocate
 	void* address = regions[MEMORY_REGION_SDRAM].alloc(requiredSize, getAllocatedSize, makeStealable,
 	                                                   thingNotToStealFrom, getBiggestAllocationPossible);
 	lock = false;
+	if (address) {
+		countAllocation(makeStealable ? AllocationTag::STEALABLE : AllocationTag::EXTERNAL);
+		TRACE_ALLOCATION(ALLOC, address, this->getAllocatedSize(address),
+		                 makeStealable ? AllocationTag::STEALABLE : AllocationTag::EXTERNAL);
+	}
 	return address;
 }
 
@@ -192,13 +250,23 @@ int32_t GeneralMemoryAllocator::getRegion(void* address) {
 
 // Returns new size
 uint32_t GeneralMemoryAllocator::shortenRight(void* address, uint32_t newSize) {
-	return regions[getRegion(address)].shortenRight(address, newSize);
+	newSize = regions[getRegion(address)].shortenRight(address, newSize);
+	TRACE_ALLOCATION(SHORTEN, address, newSize, 0);
+	return newSize;
 }
 
 // Returns how much it was shortened by
 uint32_t GeneralMemoryAllocator::shortenLeft(void* address, uint32_t amountToShorten,
                                              uint32_t numBytesToMoveRightIfSuccessful) {
-	return regions[getRegion(address)].shortenLeft(address, amountToShorten, numBytesToMoveRightIfSuccessful);
+	uint32_t amountShortened =
+	    regions[getRegion(address)].shortenLeft(address, amountToShorten, numBytesToMoveRightIfSuccessful);
+	// It's moved, so what the trace sees is the old allocation going and a new one appearing
+	if (amountShortened) {
+		TRACE_ALLOCATION(DEALLOC, address, 0, 0);
+		TRACE_ALLOCATION(ALLOC, (uint32_t)address + amountShortened, getAllocatedSize((char*)address + amountShortened),
+		                 0);
+	}
+	return amountShortened;
 }
 
 void GeneralMemoryAllocator::extend(void* address, uint32_t minAmountToExtend, uint32_t idealAmountToExtend,
@@ -216,13 +284,33 @@ void GeneralMemoryAllocator::extend(void* address, uint32_t minAmountToExtend, u
 	regions[getRegion(address)].extend(address, minAmountToExtend, idealAmountToExtend, getAmountExtendedLeft,
 	                                   getAmountExtendedRight, thingNotToStealFrom);
 	lock = false;
+
+	// Extending left moves the start, so what the trace sees then is the old allocation going and a new one appearing
+	if (*getAmountExtendedLeft) {
+		void* newAddress = (char*)address - *getAmountExtendedLeft;
+		TRACE_ALLOCATION(DEALLOC, address, 0, 0);
+		TRACE_ALLOCATION(ALLOC, newAddress, getAllocatedSize(newAddress), 0);
+	}
+	else if (*getAmountExtendedRight) {
+		TRACE_ALLOCATION(EXTEND, address, getAllocatedSize(address), 0);
+	}
 }
 
 uint32_t GeneralMemoryAllocator::extendRightAsMuchAsEasilyPossible(void* address) {
-	return regions[getRegion(address)].extendRightAsMuchAsEasilyPossible(address);
+	uint32_t newSize = regions[getRegion(address)].extendRightAsMuchAsEasilyPossible(address);
+	TRACE_ALLOCATION(EXTEND, address, newSize, 0);
+	return newSize;
 }
 
 void GeneralMemoryAllocator::dealloc(void* address) {
+	if (activeArena && activeArena->contains(address)) {
+		return; // Goes when the whole arena does
+	}
+	TRACE_ALLOCATION(DEALLOC, address, 0, 0);
+	if (SlabAllocator::isSlabAllocation(address)) {
+		nonAudioSlabs.dealloc(address);
+		return;
+	}
 	return regions[getRegion(address)].dealloc(address);
 }
 
@@ -236,6 +324,59 @@ void GeneralMemoryAllocator::putStealableInAppropriateQueue(Stealable* stealable
 	putStealableInQueue(stealable, q);
 }
 
+void GeneralMemoryAllocator::registerRelocatable(Relocatable* relocatable) {
+	relocatable->remove();
+	relocatables.addToEnd(relocatable);
+}
+
+// Visits the Relocatables in turn, starting from where the last call left off, until one of them gets moved or
+// they've all been looked at once. Each call is quick, so the caller can keep calling it for as long as it can spare.
+// Returns false when it's got to the end of a round without moving anything more, so it's not worth calling again
+// until things have had a chance to change.
+bool GeneralMemoryAllocator::compactStep() {
+	if (lock) {
+		return false;
+	}
+
+	if (!numRelocatablesToVisit) {
+		numRelocatablesToVisit = relocatables.getNum();
+		if (!numRelocatablesToVisit) {
+			return false;
+		}
+	}
+
+	while (numRelocatablesToVisit) {
+		numRelocatablesToVisit--;
+
+		// Rotate the list, so the next call carries on from here, however the list changes in between
+		Relocatable* relocatable = (Relocatable*)relocatables.getFirst();
+		if (!relocatable) { // Some went away since the round started
+			numRelocatablesToVisit = 0;
+			break;
+		}
+		relocatable->remove();
+		relocatables.addToEnd(relocatable);
+
+		void* address = relocatable->getRelocatableMemory();
+		if (!address) {
+			continue;
+		}
+
+		lock = true;
+		void* newAddress = regions[getRegion(address)].slideLeft(address, kMaxRelocationSize);
+		lock = false;
+
+		if (newAddress) {
+			relocatable->memoryRelocated(newAddress);
+			numRelocations++;
+			TRACE_ALLOCATION(RELOCATE, newAddress, (uint32_t)address, 0);
+			return true;
+		}
+	}
+
+	return false;
+}
+
 #if TEST_GENERAL_MEMORY_ALLOCATION
 
 #define NUM_TEST_ALLOCATIONS 512
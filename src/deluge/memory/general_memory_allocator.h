@@ -17,7 +17,9 @@
 
 #pragma once
 
+#include "memory/arena_allocator.h"
 #include "memory/memory_region.h"
+#include "memory/slab_allocator.h"
 
 #define MEMORY_REGION_SDRAM 0
 #define MEMORY_REGION_INTERNAL 1
@@ -25,6 +27,23 @@
 #define NUM_MEMORY_REGIONS 3
 constexpr uint32_t RESERVED_NONAUDIO_ALLOCATOR = 0x00100000;
 class Stealable;
+class Relocatable;
+
+// Compaction won't move anything bigger than this, so that each move stays quick
+constexpr uint32_t kMaxRelocationSize = 16384;
+
+// Which kind of caller each allocation came from, so telemetry can count them separately
+enum class AllocationTag : uint8_t {
+	INTERNAL,  // alloc() that landed in on-chip RAM
+	EXTERNAL,  // alloc() that landed in SDRAM
+	STEALABLE, // alloc() with makeStealable, in either region
+	NON_AUDIO,
+	SLAB,      // allocNonAudioSmall() that fitted in a slab
+	TEMPORARY, // allocTemporary() that fitted in the active arena
+	NUM_TAGS,
+};
+
+constexpr int32_t kNumAllocationTags = static_cast<int32_t>(AllocationTag::NUM_TAGS);
 
 /*
  * ======================= MEMORY ALLOCATION ========================
@@ -54,6 +73,12 @@ class Stealable;
  * case where a neighbouring region of memory is chosen for allocation (or itself being stolen) when
  * the allocation requires that the object in question have its memory stolen too in order to make
  * up a large enough allocation.
+ *
+ * Over a long session, allocations coming and going leave the empty space in ever smaller pieces between the
+ * ones which stay, until big allocations can't find anywhere to go despite there being plenty free in total.
+ * Much of what stays a long time is ResizeableArray memory, which nothing but its owner points to - so owners of
+ * memory like that can register as Relocatable, and when the main loop has nothing better to do, compactStep()
+ * slides their allocations left into empty space, to join it up with the empty space on their other side.
  */
 
 class GeneralMemoryAllocator {
@@ -65,6 +90,8 @@ public:
 	void dealloc(void* address);
 	void* allocNonAudio(uint32_t requiredSize);
 	void deallocNonAudio(void* address);
+	void* allocNonAudioSmall(uint32_t requiredSize);
+	void* allocTemporary(uint32_t requiredSize);
 	uint32_t shortenRight(void* address, uint32_t newSize);
 	uint32_t shortenLeft(void* address, uint32_t amountToShorten, uint32_t numBytesToMoveRightIfSuccessful = 0);
 	void extend(void* address, uint32_t minAmountToExtend, uint32_t idealAmountToExtend,
@@ -80,7 +107,18 @@ public:
 	void putStealableInQueue(Stealable* stealable, int32_t q);
 	void putStealableInAppropriateQueue(Stealable* stealable);
 
+	void registerRelocatable(Relocatable* relocatable);
+	bool compactStep();
+
+	/// How many allocations compaction has moved since startup
+	uint32_t getNumRelocations() { return numRelocations; }
+
+	/// How many successful allocations there have been of this kind since startup
+	uint32_t getNumAllocations(AllocationTag tag) { return numAllocationsByTag[static_cast<int32_t>(tag)]; }
+
 	MemoryRegion regions[NUM_MEMORY_REGIONS];
+	SlabAllocator nonAudioSlabs;
+	ArenaAllocator* activeArena = nullptr; // See ArenaScope
 
 	bool lock;
 
@@ -91,6 +129,13 @@ public:
 
 private:
 	void checkEverythingOk(char const* errorString);
+	void countAllocation(AllocationTag tag) { numAllocationsByTag[static_cast<int32_t>(tag)]++; }
+
+	uint32_t numAllocationsByTag[kNumAllocationTags] = {0};
+
+	BidirectionalLinkedList relocatables;
+	int32_t numRelocatablesToVisit = 0; // Before compactStep() has been round all of them once
+	uint32_t numRelocations = 0;
 };
 
 extern "C" {
@@ -92,6 +92,35 @@ void MemoryRegion::verifyMemoryNotFree(void* address, uint32_t spaceSize) {
 	}
 }
 
+void MemoryRegion::getTelemetry(MemoryRegionTelemetry* telemetry) {
+	*telemetry = {};
+	telemetry->numFreeSpaces = emptySpaces.getNumElements();
+
+	for (int32_t i = 0; i < telemetry->numFreeSpaces; i++) {
+		EmptySpaceRecord* emptySpaceRecord = (EmptySpaceRecord*)emptySpaces.getElementAddress(i);
+		telemetry->freeBytes += emptySpaceRecord->length;
+
+		int32_t bucket = 0;
+		uint32_t bucketLimit = kSmallestFreeSpaceBucketLimit;
+		while (bucket < kNumFreeSpaceSizeBuckets - 1 && emptySpaceRecord->length >= bucketLimit) {
+			bucket++;
+			bucketLimit <<= 2;
+		}
+		telemetry->freeSpaceHistogram[bucket]++;
+	}
+
+	// emptySpaces is sorted by length, so the biggest is the last one
+	if (telemetry->numFreeSpaces) {
+		telemetry->largestFreeRun =
+		    ((EmptySpaceRecord*)emptySpaces.getElementAddress(telemetry->numFreeSpaces - 1))->length;
+	}
+
+	for (int32_t q = 0; q < NUM_STEALABLE_QUEUES; q++) {
+		telemetry->stealableBytes[q] = cache_manager_.GetStealableBytes(q, &telemetry->numStealables[q]);
+	}
+	telemetry->numSteals = cache_manager_.num_steals();
+}
+
 // Okay this is me being experimental and trying something you're not supposed to do - using static variables in place of stack ones within a function.
 // It seemed to give a slight speed up, but it's probably quite circumstantial, and I wouldn't normally do this.
 static EmptySpaceRecord emptySpaceToLeft;
@@ -466,6 +495,54 @@ uint32_t MemoryRegion::shortenLeft(void* address, uint32_t amountToShorten, uint
 	return amountShortened;
 }
 
+// Moves an allocation, contents and all, left into the empty space directly before it, so that space ends up after it
+// instead - which is only worth doing when there's empty space there too for it to merge with. Only for plain
+// allocations no bigger than maxSize, since this is done while there's nothing better to do but still mustn't take
+// long. Returns the allocation's new address, or NULL if it was left where it was.
+void* MemoryRegion::slideLeft(void* address, uint32_t maxSize) {
+	uint32_t* __restrict__ header = (uint32_t*)((uint32_t)address - 4);
+	uint32_t allocatedSize = *header & SPACE_SIZE_MASK;
+
+	if ((*header & SPACE_TYPE_MASK) != SPACE_HEADER_ALLOCATED || allocatedSize > maxSize) {
+		return NULL;
+	}
+
+	uint32_t* __restrict__ lookLeft = (uint32_t*)((uint32_t)address - 8);
+	uint32_t* __restrict__ lookRight = (uint32_t*)((uint32_t)address + allocatedSize + 4);
+	if ((*lookLeft & SPACE_TYPE_MASK) != SPACE_HEADER_EMPTY || (*lookRight & SPACE_TYPE_MASK) != SPACE_HEADER_EMPTY) {
+		return NULL;
+	}
+
+	EmptySpaceRecord emptySpace;
+	emptySpace.length = *lookLeft & SPACE_SIZE_MASK;
+	emptySpace.address = (uint32_t)address - emptySpace.length - 8;
+
+	// It might not have a record, if the array was full when it was made
+	int32_t i = emptySpaces.searchMultiWordExact((uint32_t*)&emptySpace);
+	if (i != -1) {
+		emptySpaces.deleteAtIndex(i);
+	}
+
+	// Any Stealable beyond the empty space on the right is about to have more reclaimable memory next to it
+	uint32_t* __restrict__ beyondRight = (uint32_t*)((uint32_t)lookRight + (*lookRight & SPACE_SIZE_MASK) + 8);
+	Stealable* stealableToRight =
+	    ((*beyondRight & SPACE_TYPE_MASK) == SPACE_HEADER_STEALABLE) ? (Stealable*)(beyondRight + 1) : nullptr;
+
+	memmove((void*)emptySpace.address, address, allocatedSize);
+
+	header = (uint32_t*)(emptySpace.address - 4);
+	*header = SPACE_HEADER_ALLOCATED | allocatedSize;
+	*(uint32_t*)(emptySpace.address + allocatedSize) = *header;
+
+	markSpaceAsEmpty(emptySpace.address + allocatedSize + 8, emptySpace.length, false, true);
+
+	if (stealableToRight) {
+		cache_manager_.NoteRunChanged(stealableToRight);
+	}
+
+	return (void*)emptySpace.address;
+}
+
 void MemoryRegion::writeTempHeadersBeforeASteal(uint32_t newStartAddress, uint32_t newSize) {
 
 	uint32_t headerValue = SPACE_HEADER_ALLOCATED | newSize;
@@ -499,6 +576,7 @@ uint32_t MemoryRegion::extendRightAsMuchAsEasilyPossible(void* address) {
 		}
 		stealable->steal("E446");
 		stealable->~Stealable();
+		cache_manager_.RecordSteal(stealable, emptySpaceHereSizeWithoutHeaders);
 	}
 
 	else if (spaceType == SPACE_HEADER_EMPTY) {
@@ -532,7 +610,7 @@ finished:
 // Returns new space start address, or NULL if couldn't grab enough memory.
 NeighbouringMemoryGrabAttemptResult MemoryRegion::attemptToGrabNeighbouringMemory(
     void* originalSpaceAddress, int32_t originalSpaceSize, int32_t minAmountToExtend, int32_t idealAmountToExtend,
-    void* thingNotToStealFrom, uint32_t markWithTraversalNo, bool originalSpaceNeedsStealing) {
+    void* thingNotToStealFrom, uint32_t markWithTraversalNo, bool originalSpaceNeedsStealing, bool justExploring) {
 
 	NeighbouringMemoryGrabAttemptResult toReturn;
 
@@ -540,6 +618,7 @@ NeighbouringMemoryGrabAttemptResult MemoryRegion::attemptToGrabNeighbouringMemor
 
 	toReturn.amountsExtended[0] = 0;
 	toReturn.amountsExtended[1] = 0;
+	toReturn.stealCost = 0;
 
 	// Go through twice - once not actually grabbing but just exploring, and then a second time actually grabbing
 	for (int32_t actuallyGrabbing = 0; actuallyGrabbing < 2; actuallyGrabbing++) {
@@ -547,6 +626,7 @@ NeighbouringMemoryGrabAttemptResult MemoryRegion::attemptToGrabNeighbouringMemor
 		if (actuallyGrabbing && originalSpaceNeedsStealing) {
 			((Stealable*)originalSpaceAddress)->steal("E417"); // Jensg still getting.
 			((Stealable*)originalSpaceAddress)->~Stealable();
+			cache_manager_.RecordSteal(originalSpaceAddress, originalSpaceSize);
 		}
 
 		uint32_t amountOfExtraSpaceFoundSoFar = 0;
@@ -590,8 +670,11 @@ tryNotStealingFirst:
 #endif
 						break;
 					}
-					if (!actuallyGrabbing && markWithTraversalNo) {
-						stealable->lastTraversalNo = markWithTraversalNo;
+					if (!actuallyGrabbing) {
+						if (markWithTraversalNo) {
+							stealable->lastTraversalNo = markWithTraversalNo;
+						}
+						toReturn.stealCost += cache_manager_.GetStealCost(stealable);
 					}
 					// No break
 
@@ -633,6 +716,7 @@ tryNotStealingFirst:
 
 							stealable->steal("E418"); // Jensg still getting.
 							stealable->~Stealable();
+							cache_manager_.RecordSteal(stealable, emptySpaceHereSizeWithoutHeaders);
 						}
 
 						// Can only change these after potentially putting those temp headers in, above
@@ -685,6 +769,11 @@ tryNotStealingFirst:
 		}
 
 gotEnoughMemory : {}
+		// If we were only asked whether there's enough, and what it would cost, we're done - nothing's been touched
+		if (justExploring) {
+			return toReturn;
+		}
+
 		// There's a small chance it will have found a bit less memory the second time through if stealing an allocation resulted in another little bit of memory being freed,
 		// that adding onto the discovered amount, and getting us less of a surplus while still reaching the desired (well actually the min) amount
 	}
@@ -790,8 +879,32 @@ void MemoryRegion::dealloc(void* address) {
 	}
 #endif
 
+	// Once this is empty, it and any empty space either side of it add to the run of reclaimable memory that any
+	// Stealable beyond them is part of - so find those now, while the headers still tell us the way
+	uint32_t* __restrict__ lookLeft = (uint32_t*)((uint32_t)address - 8);
+	if ((*lookLeft & SPACE_TYPE_MASK) == SPACE_HEADER_EMPTY) {
+		lookLeft = (uint32_t*)((uint32_t)lookLeft - (*lookLeft & SPACE_SIZE_MASK) - 8);
+	}
+	Stealable* stealableToLeft = ((*lookLeft & SPACE_TYPE_MASK) == SPACE_HEADER_STEALABLE)
+	                                 ? (Stealable*)((uint32_t)lookLeft - (*lookLeft & SPACE_SIZE_MASK))
+	                                 : nullptr;
+
+	uint32_t* __restrict__ lookRight = (uint32_t*)((uint32_t)address + spaceSize + 4);
+	if ((*lookRight & SPACE_TYPE_MASK) == SPACE_HEADER_EMPTY) {
+		lookRight = (uint32_t*)((uint32_t)lookRight + (*lookRight & SPACE_SIZE_MASK) + 8);
+	}
+	Stealable* stealableToRight =
+	    ((*lookRight & SPACE_TYPE_MASK) == SPACE_HEADER_STEALABLE) ? (Stealable*)(lookRight + 1) : nullptr;
+
 	markSpaceAsEmpty((uint32_t)address, spaceSize);
 
+	if (stealableToLeft) {
+		cache_manager_.NoteRunChanged(stealableToLeft);
+	}
+	if (stealableToRight) {
+		cache_manager_.NoteRunChanged(stealableToRight);
+	}
+
 	/*
 	uint16_t endTime = *TCNT[TIMER_SYSTEM_FAST];
 	uint16_t timeTaken = endTime - startTime;
@@ -31,15 +31,34 @@ struct NeighbouringMemoryGrabAttemptResult {
 	uint32_t address; // 0 means didn't grab / not found.
 	int32_t amountsExtended[2];
 	uint32_t longestRunFound; // Only valid if didn't return some space.
+	uint32_t stealCost;       // Of everything that would be stolen besides the original space. Only valid if exploring.
 };
 
 #define SPACE_HEADER_EMPTY 0
 #define SPACE_HEADER_STEALABLE 0x40000000
 #define SPACE_HEADER_ALLOCATED 0x80000000
+#define SPACE_HEADER_SLAB 0xC0000000 // Only ever found inside a slab - see SlabAllocator
 
 #define SPACE_TYPE_MASK 0xC0000000u
 #define SPACE_SIZE_MASK 0x3FFFFFFFu
 
+// Empty spaces get counted into buckets of under 64 bytes, under 256, under 1K, and so on up by 4x, with the last
+// bucket taking everything bigger
+constexpr int32_t kNumFreeSpaceSizeBuckets = 8;
+constexpr uint32_t kSmallestFreeSpaceBucketLimit = 64;
+
+// A snapshot of how full and how fragmented a MemoryRegion is. Only for telemetry - filling one in walks all the
+// region's empty spaces and stealables.
+struct MemoryRegionTelemetry {
+	uint32_t freeBytes;
+	uint32_t largestFreeRun;
+	int32_t numFreeSpaces;
+	int32_t freeSpaceHistogram[kNumFreeSpaceSizeBuckets];
+	uint32_t stealableBytes[NUM_STEALABLE_QUEUES];
+	int32_t numStealables[NUM_STEALABLE_QUEUES];
+	uint32_t numSteals;
+};
+
 class MemoryRegion {
 public:
 	MemoryRegion();
@@ -51,8 +70,10 @@ public:
 	void extend(void* address, uint32_t minAmountToExtend, uint32_t idealAmountToExtend,
 	            uint32_t* getAmountExtendedLeft, uint32_t* getAmountExtendedRight, void* thingNotToStealFrom);
 	uint32_t extendRightAsMuchAsEasilyPossible(void* spaceAddress);
+	void* slideLeft(void* address, uint32_t maxSize);
 	void dealloc(void* address);
 	void verifyMemoryNotFree(void* address, uint32_t spaceSize);
+	void getTelemetry(MemoryRegionTelemetry* telemetry);
 
 	uint32_t start;
 	uint32_t end;
@@ -73,7 +94,8 @@ private:
 	NeighbouringMemoryGrabAttemptResult
 	attemptToGrabNeighbouringMemory(void* originalSpaceAddress, int32_t originalSpaceSize, int32_t minAmountToExtend,
 	                                int32_t idealAmountToExtend, void* thingNotToStealFrom,
-	                                uint32_t markWithTraversalNo = 0, bool originalSpaceNeedsStealing = false);
+	                                uint32_t markWithTraversalNo = 0, bool originalSpaceNeedsStealing = false,
+	                                bool justExploring = false);
 
 	void writeTempHeadersBeforeASteal(uint32_t newStartAddress, uint32_t newSize);
 	void sanityCheck();
@@ -4,8 +4,8 @@
 //todo - make this work in unit tests, need to remove hard coded addresses in GMA
 #if !defined IN_UNIT_TESTS
 void* operator new(std::size_t n) noexcept(false) {
-	//allocate on external RAM
-	return GeneralMemoryAllocator::get().allocNonAudio(n);
+	//allocate on external RAM. Lots of little objects get made this way, so small ones go in slabs
+	return GeneralMemoryAllocator::get().allocNonAudioSmall(n);
 }
 
 void operator delete(void* p) {
@@ -0,0 +1,49 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "util/container/array/resizeable_array.h"
+#include "util/container/list/bidirectional_linked_list.h"
+
+// Please see explanation of compaction at GeneralMemoryAllocator::compact()
+
+// Something which holds the one and only pointer to an allocation, so the allocator is free to move that allocation
+// when it's got nothing better to do, to slide empty space together. Register it with
+// GeneralMemoryAllocator::registerRelocatable() - it takes itself off that list when destructed.
+class Relocatable : public BidirectionalLinkedListNode {
+public:
+	Relocatable() = default;
+
+	// The start of the allocation, or NULL if there isn't one right now or it mustn't move at the moment
+	virtual void* getRelocatableMemory() = 0;
+	// The allocation, contents and all, is now at newMemory, and the old address is no longer valid
+	virtual void memoryRelocated(void* newMemory) = 0;
+};
+
+// For a ResizeableArray which nothing keeps pointers into from one main loop task to the next. Sits alongside the
+// array in whatever owns it.
+class RelocatableArray final : public Relocatable {
+public:
+	RelocatableArray(ResizeableArray& array) : array(array) {}
+
+	void* getRelocatableMemory() override { return array.getRelocatableMemory(); }
+	void memoryRelocated(void* newMemory) override { array.memoryRelocated(newMemory); }
+
+private:
+	ResizeableArray& array;
+};
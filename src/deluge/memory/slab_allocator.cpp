@@ -0,0 +1,145 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "memory/slab_allocator.h"
+
+void SlabAllocator::setup(MemoryRegion* newRegion) {
+	region = newRegion;
+	for (int32_t c = 0; c < kNumSlabSizeClasses; c++) {
+		sizeClasses[c].firstSlabWithFreeSlots = nullptr;
+		sizeClasses[c].numSlabs = 0;
+	}
+}
+
+int32_t SlabAllocator::getSizeClass(uint32_t size) {
+	for (int32_t c = 0; c < kNumSlabSizeClasses; c++) {
+		if (size <= kSlabSizeClasses[c]) {
+			return c;
+		}
+	}
+	return -1;
+}
+
+// Returns NULL if too big for any size class, or if the region couldn't give us a new slab
+void* SlabAllocator::alloc(uint32_t requiredSize) {
+	int32_t c = getSizeClass(requiredSize);
+	if (c < 0) {
+		return nullptr;
+	}
+
+	Slab* slab = sizeClasses[c].firstSlabWithFreeSlots;
+	if (!slab) {
+		slab = newSlab(c);
+		if (!slab) {
+			return nullptr;
+		}
+	}
+
+	uint32_t* slot = (uint32_t*)slab->firstFreeSlot;
+	slab->firstFreeSlot = *(void**)(slot + 1);
+	slab->numSlotsUsed++;
+	if (!slab->firstFreeSlot) {
+		unlinkSlab(slab);
+	}
+
+	*slot = SPACE_HEADER_SLAB | ((uint32_t)slot - (uint32_t)slab);
+	return slot + 1;
+}
+
+void SlabAllocator::dealloc(void* address) {
+	uint32_t* slot = (uint32_t*)address - 1;
+	Slab* slab = (Slab*)((uint32_t)slot - (*slot & SPACE_SIZE_MASK));
+
+	*(void**)address = slab->firstFreeSlot;
+	slab->firstFreeSlot = slot;
+	slab->numSlotsUsed--;
+
+	if (!slab->hasFreeSlots) {
+		linkSlab(slab);
+	}
+
+	// If it's empty, give it back - unless it's the only slab with space, in which case we'd likely just want it again
+	else if (!slab->numSlotsUsed && (slab->prev || slab->next)) {
+		unlinkSlab(slab);
+		sizeClasses[slab->sizeClass].numSlabs--;
+		region->dealloc(slab);
+	}
+}
+
+// How big the slot at address is, which may be more than was asked for. The header just says where the slot is, so
+// GeneralMemoryAllocator::getAllocatedSize() can't be used for these
+uint32_t SlabAllocator::getAllocatedSize(void* address) {
+	uint32_t* slot = (uint32_t*)address - 1;
+	Slab* slab = (Slab*)((uint32_t)slot - (*slot & SPACE_SIZE_MASK));
+	return kSlabSizeClasses[slab->sizeClass];
+}
+
+SlabAllocator::Slab* SlabAllocator::newSlab(int32_t sizeClass) {
+	uint32_t allocatedSize;
+	void* memory = region->alloc(kSlabSize, &allocatedSize, false, NULL, false);
+	if (!memory) {
+		return nullptr;
+	}
+
+	Slab* slab = (Slab*)memory;
+	slab->sizeClass = sizeClass;
+	slab->numSlotsUsed = 0;
+	slab->hasFreeSlots = false;
+
+	// Chain all the slots together into the free list
+	uint32_t slotSize = getSlotSize(sizeClass);
+	int32_t numSlots = (allocatedSize - sizeof(Slab)) / slotSize;
+	uint32_t slotAddress = (uint32_t)memory + sizeof(Slab);
+	slab->firstFreeSlot = (void*)slotAddress;
+	for (int32_t s = 0; s < numSlots; s++) {
+		uint32_t nextSlotAddress = (s == numSlots - 1) ? 0 : slotAddress + slotSize;
+		*(void**)(slotAddress + 4) = (void*)nextSlotAddress;
+		slotAddress += slotSize;
+	}
+
+	sizeClasses[sizeClass].numSlabs++;
+	linkSlab(slab);
+	return slab;
+}
+
+void SlabAllocator::linkSlab(Slab* slab) {
+	SizeClass& sizeClass = sizeClasses[slab->sizeClass];
+	slab->prev = nullptr;
+	slab->next = sizeClass.firstSlabWithFreeSlots;
+	if (slab->next) {
+		slab->next->prev = slab;
+	}
+	sizeClass.firstSlabWithFreeSlots = slab;
+	slab->hasFreeSlots = true;
+}
+
+void SlabAllocator::unlinkSlab(Slab* slab) {
+	if (slab->prev) {
+		slab->prev->next = slab->next;
+	}
+	else {
+		sizeClasses[slab->sizeClass].firstSlabWithFreeSlots = slab->next;
+	}
+	if (slab->next) {
+		slab->next->prev = slab->prev;
+	}
+	slab->hasFreeSlots = false;
+}
+
+int32_t SlabAllocator::getNumSlabs(int32_t sizeClass) {
+	return sizeClasses[sizeClass].numSlabs;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "memory/memory_region.h"
+#include <cstdint>
+
+// Size classes, in bytes, that small allocations get rounded up to. Anything bigger goes straight to the MemoryRegion
+constexpr uint32_t kSlabSizeClasses[] = {16, 24, 32, 48, 64, 96, 128, 192, 256};
+constexpr int32_t kNumSlabSizeClasses = sizeof(kSlabSizeClasses) / sizeof(kSlabSizeClasses[0]);
+constexpr uint32_t kMaxSlabObjectSize = kSlabSizeClasses[kNumSlabSizeClasses - 1];
+
+// How much we ask the MemoryRegion for each time a size class needs a new slab
+constexpr uint32_t kSlabSize = 4096;
+
+/*
+ * Small objects get allocated out of "slabs" - each slab is one ordinary allocation from a MemoryRegion, chopped up
+ * into equal-sized slots for one size class. Allocating and freeing are O(1), with no searching of emptySpaces, and
+ * lots of little short-lived objects no longer get scattered all over the region fragmenting it.
+ *
+ * Each slot begins with a 4-byte header with the type bits set to SPACE_HEADER_SLAB, which no MemoryRegion space ever
+ * has, so dealloc() can tell slab objects apart. The rest of the header says where in its slab the slot is, so the
+ * slab can be found without searching. A slab is given back to the region once all its slots are free, unless it's
+ * the only one its size class has with space.
+ */
+class SlabAllocator {
+public:
+	SlabAllocator() = default;
+	void setup(MemoryRegion* newRegion);
+
+	void* alloc(uint32_t requiredSize);
+	void dealloc(void* address);
+
+	static inline bool isSlabAllocation(void* address) {
+		return (*((uint32_t*)address - 1) & SPACE_TYPE_MASK) == SPACE_HEADER_SLAB;
+	}
+	static uint32_t getAllocatedSize(void* address);
+
+	// Just for debugging and tests
+	int32_t getNumSlabs(int32_t sizeClass);
+
+private:
+	struct Slab {
+		Slab* prev; // Both within the list of slabs with free slots, for our size class
+		Slab* next;
+		void* firstFreeSlot;
+		uint16_t numSlotsUsed;
+		uint8_t sizeClass;
+		bool hasFreeSlots; // Whether we're in the list
+	};
+
+	struct SizeClass {
+		Slab* firstSlabWithFreeSlots;
+		int32_t numSlabs;
+	};
+
+	Slab* newSlab(int32_t sizeClass);
+	void linkSlab(Slab* slab);
+	void unlinkSlab(Slab* slab);
+
+	static int32_t getSizeClass(uint32_t size);
+	static uint32_t getSlotSize(int32_t sizeClass) { return kSlabSizeClasses[sizeClass] + 4; }
+
+	MemoryRegion* region = nullptr;
+	SizeClass sizeClasses[kNumSlabSizeClasses] = {};
+};
@@ -29,5 +29,9 @@ public:
 	virtual void steal(char const* errorCode) = 0; // You gotta also call the destructor after this.
 	virtual int32_t getAppropriateQueue() = 0;
 
+	// Roughly how much work it'd be to get this back once stolen, in SD card cluster reads. CacheManager uses this
+	// to prefer stealing things that are cheap to bring back.
+	virtual uint32_t getReloadCost() { return 1; }
+
 	uint32_t lastTraversalNo = 0xFFFFFFFF;
 };
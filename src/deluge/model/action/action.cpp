@@ -62,6 +62,18 @@ void Action::prepareForDestruction(int32_t whichQueueActionIn, Song* song) {
 	}
 }
 
+// Approximate - doesn't count things like Clips which were deleted but are being kept around in case of undo
+uint32_t Action::getMemoryUsage() {
+	uint32_t memoryUsage = GeneralMemoryAllocator::get().getAllocatedSize(this);
+	if (clipStates) {
+		memoryUsage += GeneralMemoryAllocator::get().getAllocatedSize(clipStates);
+	}
+	for (Consequence* consequence = firstConsequence; consequence; consequence = consequence->next) {
+		memoryUsage += consequence->getMemoryUsage();
+	}
+	return memoryUsage;
+}
+
 void Action::deleteAllConsequences(int32_t whichQueueActionIn, Song* song, bool destructing) {
 	Consequence* currentConsequence = firstConsequence;
 	while (currentConsequence) {
@@ -92,6 +92,7 @@ public:
 	bool recordClipExistenceChange(Song* song, ClipArray* clipArray, Clip* clip, ExistenceChangeType type);
 	void recordAudioClipSampleChange(AudioClip* clip);
 	void deleteAllConsequences(int32_t whichQueueActionIn, Song* song, bool destructing = false);
+	uint32_t getMemoryUsage();
 
 	uint8_t type;
 	bool openForAdditions;
@@ -53,6 +53,8 @@ ActionLogger actionLogger{};
 ActionLogger::ActionLogger() {
 	firstAction[BEFORE] = NULL;
 	firstAction[AFTER] = NULL;
+	memoryBudget = kDefaultUndoMemoryBudget;
+	mightBeOverMemoryBudget = false;
 }
 
 void ActionLogger::deleteLastActionIfEmpty() {
@@ -80,6 +82,8 @@ Action* ActionLogger::getNewAction(int32_t newActionType, int32_t addToExistingI
 
 	deleteLog(AFTER);
 
+	mightBeOverMemoryBudget = true; // Whatever the caller's about to add, slowRoutine() will check it
+
 	// If not on a View, not allowed!
 	if (getCurrentUI() != getRootUI()) {
 		return NULL;
@@ -726,6 +730,50 @@ void ActionLogger::closeActionUnlessCreatedJustNow(int32_t actionType) {
 	}
 }
 
+uint32_t ActionLogger::getMemoryUsage() {
+	uint32_t memoryUsage = 0;
+	for (int32_t time = BEFORE; time <= AFTER; time++) {
+		for (Action* action = firstAction[time]; action; action = action->nextAction) {
+			memoryUsage += action->getMemoryUsage();
+		}
+	}
+	return memoryUsage;
+}
+
+// Deletes the oldest undoable Action - but never the most recent one, which might still be open for additions
+void ActionLogger::deleteOldestAction() {
+	if (!firstAction[BEFORE] || !firstAction[BEFORE]->nextAction) {
+		return;
+	}
+
+	Action** prevPointer = &firstAction[BEFORE]->nextAction;
+	while ((*prevPointer)->nextAction) {
+		prevPointer = &(*prevPointer)->nextAction;
+	}
+
+	Action* toDelete = *prevPointer;
+	*prevPointer = NULL;
+
+	toDelete->prepareForDestruction(BEFORE, currentSong);
+	toDelete->~Action();
+	delugeDealloc(toDelete);
+}
+
+// Call from the main loop, not the card routine. Trims the undo history to memoryBudget - one Action per call, so
+// that deleting a long history never holds anything else up for long.
+void ActionLogger::slowRoutine() {
+	if (!mightBeOverMemoryBudget) {
+		return;
+	}
+
+	if (getMemoryUsage() > memoryBudget && firstAction[BEFORE] && firstAction[BEFORE]->nextAction) {
+		deleteOldestAction(); // And we'll come back next time to see if that was enough
+	}
+	else {
+		mightBeOverMemoryBudget = false;
+	}
+}
+
 void ActionLogger::deleteAllLogs() {
 	deleteLog(BEFORE);
 	deleteLog(AFTER);
@@ -29,6 +29,9 @@ class ModelStack;
 #define ACTION_ADDITION_ALLOWED 1
 #define ACTION_ADDITION_ALLOWED_ONLY_IF_NO_TIME_PASSED 2
 
+// Once the undo history uses more memory than this, slowRoutine() gradually deletes its oldest Actions
+constexpr uint32_t kDefaultUndoMemoryBudget = 2 * 1024 * 1024;
+
 class ActionLogger {
 public:
 	ActionLogger();
@@ -48,13 +51,19 @@ public:
 	bool undoJustOneConsequencePerNoteRow(ModelStack* modelStack);
 	bool allowedToDoReversion();
 	void notifyClipRecordingAborted(Clip* clip);
+	void slowRoutine();
+	uint32_t getMemoryUsage();
 
 	Action* firstAction[2];
+	uint32_t memoryBudget;
 
 private:
 	void revertAction(Action* action, bool updateVisually, bool doNavigation, TimeType time);
 	void deleteLastActionIfEmpty();
 	void deleteLastAction();
+	void deleteOldestAction();
+
+	bool mightBeOverMemoryBudget;
 };
 
 extern ActionLogger actionLogger;
@@ -63,6 +63,7 @@ AudioClip::AudioClip() : Clip(CLIP_TYPE_AUDIO) {
 
 	voicePriority = VoicePriority::MEDIUM;
 	attack = -2147483648;
+	sampleLoadDeferred = false;
 }
 
 AudioClip::~AudioClip() {
@@ -106,6 +107,7 @@ int32_t AudioClip::clone(ModelStackWithTimelineCounter* modelStack, bool shouldF
 	newClip->voicePriority = voicePriority;
 
 	newClip->sampleHolder.beenClonedFrom(&sampleHolder, sampleControls.reversed);
+	newClip->sampleLoadDeferred = sampleLoadDeferred;
 
 	return NO_ERROR;
 }
@@ -1040,6 +1042,7 @@ someError:
 
 		else if (!strcmp(tagName, "filePath")) {
 			storageManager.readTagOrAttributeValueString(&sampleHolder.filePath);
+			sampleHolder.filePath.intern();
 		}
 
 		else if (!strcmp(tagName, "overdubsShouldCloneAudioTrack")) {
@@ -1112,12 +1115,23 @@ int32_t AudioClip::claimOutput(ModelStackWithTimelineCounter* modelStack) {
 }
 
 void AudioClip::loadSample(bool mayActuallyReadFile) {
+	if (mayActuallyReadFile) {
+		sampleLoadDeferred = false;
+	}
 	int32_t error = sampleHolder.loadFile(sampleControls.reversed, false, mayActuallyReadFile);
 	if (error) {
 		display->displayError(error);
 	}
 }
 
+// For when something's about to need the Sample - editing the Clip, or the arranger getting near it
+void AudioClip::loadDeferredSample() {
+	if (sampleLoadDeferred) {
+		AudioEngine::logAction("AudioClip::loadDeferredSample");
+		loadSample(true);
+	}
+}
+
 // Keeps same ParamManager
 int32_t AudioClip::changeOutput(ModelStackWithTimelineCounter* modelStack, Output* newOutput) {
 	detachAudioClipFromOutput(modelStack->song, false, true);
@@ -1242,6 +1256,14 @@ bool AudioClip::shiftHorizontally(ModelStackWithTimelineCounter* modelStack, int
 	return true;
 }
 
+// Only AudioClips are worth doing this for - a Kit or synth plays its samples from the start, which is always held,
+// and while one of those notes plays on, it keeps the card ahead of itself
+void AudioClip::prefetchForLaunch() {
+	if (sampleHolder.audioFile && !getCurrentlyRecordingLinearly()) {
+		sampleHolder.prefetchClusterAfterStart(sampleControls.reversed);
+	}
+}
+
 uint64_t AudioClip::getCullImmunity() {
 	uint32_t distanceFromEnd = loopLength - getLivePos();
 	// We're gonna cull time-stretching ones first
@@ -48,6 +48,7 @@ public:
 	                       int32_t xEnd = kDisplayWidth, bool allowBlur = true, bool drawRepeats = false);
 	int32_t claimOutput(ModelStackWithTimelineCounter* modelStack);
 	void loadSample(bool mayActuallyReadFile);
+	void loadDeferredSample();
 	bool wantsToBeginLinearRecording(Song* song);
 	bool isAbandonedOverdub();
 	void finishLinearRecording(ModelStackWithTimelineCounter* modelStack, Clip* nextPendingLoop,
@@ -68,6 +69,7 @@ public:
 	void getScrollAndZoomInSamples(int32_t xScroll, int32_t xZoom, int64_t* xScrollSamples, int64_t* xZoomSamples);
 	void clear(Action* action, ModelStackWithTimelineCounter* modelStack);
 	bool getCurrentlyRecordingLinearly();
+	void prefetchForLaunch();
 	void abortRecording();
 	void setupPlaybackBounds();
 	uint64_t getCullImmunity();
@@ -106,6 +108,10 @@ public:
 	bool doingLateStart;
 	bool maySetupCache;
 
+	// Set when Song::loadAllSamples() left the file unread because this Clip's first ClipInstance is far off in the
+	// arrangement - the arranger reads it as playback approaches. Until then, sampleHolder only has the filePath
+	bool sampleLoadDeferred;
+
 protected:
 	bool cloneOutput(ModelStackWithTimelineCounter* modelStack);
 
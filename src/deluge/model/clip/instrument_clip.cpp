@@ -65,6 +65,7 @@
 #include "util/d_string.h"
 #include "util/functions.h"
 #include "util/lookuptables/lookuptables.h"
+#include <algorithm>
 #include <math.h>
 #include <new>
 
@@ -78,6 +79,16 @@ InstrumentClip::InstrumentClip(Song* song) : Clip(CLIP_TYPE_INSTRUMENT) {
 	midiPGM = 128;  // Means none
 
 	currentlyRecordingLinearly = false;
+	noteRowCursorGeneration = 0;
+	noteRowEventQueue = NULL;
+	noteRowEventQueueSize = 0;
+	noteRowEventQueueCapacity = 0;
+	noteRowEventQueueNumNoteRows = 0;
+	noteRowEventQueueGeneration = 0;
+	noteRowTickCount = 0;
+	noteRowTickCountLoopEnd = 0;
+	noteRowTickCountLastFullPass = 0;
+	probabilityRandomState = getNoise();
 
 	if (song) {
 		colourOffset -= song->rootNote;
@@ -129,6 +140,10 @@ InstrumentClip::~InstrumentClip() {
 	// Whereas, for AudioClips, it's made sure that all linear recording is stopped first
 
 	deleteBackedUpParamManagerMIDI();
+
+	if (noteRowEventQueue) {
+		delugeDealloc(noteRowEventQueue);
+	}
 }
 
 void InstrumentClip::deleteBackedUpParamManagerMIDI() {
@@ -397,6 +412,9 @@ void InstrumentClip::setPos(ModelStackWithTimelineCounter* modelStack, int32_t n
 	Clip::setPos(modelStack, newPos, useActualPosForParamManagers); // This will also call our own virtual expectEvent()
 
 	noteRowsNumTicksBehindClip = 0;
+	for (int32_t i = 0; i < noteRows.getNumElements(); i++) {
+		noteRows.getElement(i)->lastProcessedNoteRowTick = noteRowTickCount;
+	}
 
 	Clip::setPosForParamManagers(
 	    modelStack,
@@ -699,6 +717,11 @@ void InstrumentClip::pingpongOccurred(ModelStackWithTimelineCounter* modelStack)
 	}
 }
 
+// std::push_heap() and friends make max-heaps, so this gives us a min-heap
+static bool noteRowEventIsLater(NoteRowEvent const& a, NoteRowEvent const& b) {
+	return a.tick - b.tick > 0;
+}
+
 void InstrumentClip::processCurrentPos(ModelStackWithTimelineCounter* modelStack, uint32_t ticksSinceLast) {
 
 	Clip::processCurrentPos(modelStack, ticksSinceLast);
@@ -726,19 +749,75 @@ void InstrumentClip::processCurrentPos(ModelStackWithTimelineCounter* modelStack
 		    pendingNoteOnList; // Making this static, which it really should have always been, actually didn't help max stack usage at all somehow...
 		pendingNoteOnList.count = 0;
 
-		for (int32_t i = 0; i < noteRows.getNumElements(); i++) {
-			NoteRow* thisNoteRow = noteRows.getElement(i);
+		int32_t numNoteRows = noteRows.getNumElements();
+
+		// Visit every NoteRow if we've reached the loop point - NoteRows without their own play pos rely on that to
+		// look for their first note again - or if anything might have changed since the queue was built
+		bool visitAll = (noteRowTickCount - noteRowTickCountLoopEnd >= 0)
+		                || noteRowEventQueueGeneration != noteRowCursorGeneration
+		                || noteRowEventQueueNumNoteRows != numNoteRows;
+
+		// Otherwise, just take the NoteRows whose events are due off the queue. If any entry no longer matches its
+		// NoteRow, the NoteRows must have been shuffled about, so visit them all after all
+		int32_t numDue = 0;
+		if (!visitAll) {
+			while (noteRowEventQueueSize > numDue && noteRowTickCount - noteRowEventQueue[0].tick >= 0) {
+				NoteRowEvent event = noteRowEventQueue[0];
+				std::pop_heap(noteRowEventQueue, noteRowEventQueue + noteRowEventQueueSize - numDue,
+				              noteRowEventIsLater);
+				numDue++;
+				noteRowEventQueue[noteRowEventQueueSize - numDue] = event; // Keep the due ones at the end
+				if (event.noteRowIndex >= numNoteRows
+				    || noteRows.getElement(event.noteRowIndex)->nextEventNoteRowTick != event.tick) {
+					visitAll = true;
+					break;
+				}
+			}
+		}
 
-			ModelStackWithNoteRow* modelStackWithNoteRow =
-			    modelStack->addNoteRow(getNoteRowId(thisNoteRow, i), thisNoteRow);
+		noteRowTickCountLoopEnd = noteRowTickCount + ticksTilNextNoteRowEvent;
+
+		if (visitAll) {
+			// Anything processing the NoteRows does that calls expectEvent() will mean we visit them all again next time
+			noteRowEventQueueGeneration = noteRowCursorGeneration;
+			noteRowEventQueueNumNoteRows = numNoteRows;
+			noteRowEventQueueSize = 0;
+
+			if (noteRowEventQueueCapacity < numNoteRows) {
+				if (noteRowEventQueue) {
+					delugeDealloc(noteRowEventQueue);
+				}
+				noteRowEventQueue =
+				    (NoteRowEvent*)GeneralMemoryAllocator::get().alloc(numNoteRows * sizeof(NoteRowEvent));
+				noteRowEventQueueCapacity = noteRowEventQueue ? numNoteRows : 0;
+				if (!noteRowEventQueue) {
+					noteRowEventQueueNumNoteRows = -1; // No queue, so we'll just have to visit them all every time
+				}
+			}
+
+			for (int32_t i = 0; i < numNoteRows; i++) {
+				int32_t noteRowTicksTilNextEvent = processNoteRowCurrentPos(modelStack, i, &pendingNoteOnList);
+				scheduleNoteRowEvent(i, noteRowTicksTilNextEvent);
+			}
+
+			noteRowTickCountLastFullPass = noteRowTickCount;
+		}
 
-			int32_t noteRowTicksTilNextEvent =
-			    thisNoteRow->processCurrentPos(modelStackWithNoteRow, noteRowsNumTicksBehindClip, &pendingNoteOnList);
-			if (noteRowTicksTilNextEvent < ticksTilNextNoteRowEvent) {
-				ticksTilNextNoteRowEvent = noteRowTicksTilNextEvent;
+		else {
+			int32_t firstDue = noteRowEventQueueSize - numDue;
+			noteRowEventQueueSize = firstDue;
+			for (int32_t d = 0; d < numDue; d++) {
+				int32_t i = noteRowEventQueue[firstDue + d].noteRowIndex;
+				int32_t noteRowTicksTilNextEvent = processNoteRowCurrentPos(modelStack, i, &pendingNoteOnList);
+				scheduleNoteRowEvent(i, noteRowTicksTilNextEvent);
 			}
 		}
 
+		if (noteRowEventQueueSize) {
+			ticksTilNextNoteRowEvent =
+			    std::min<int32_t>(ticksTilNextNoteRowEvent, noteRowEventQueue[0].tick - noteRowTickCount);
+		}
+
 		noteRowsNumTicksBehindClip = 0;
 
 		// Count up how many of each probability there are
@@ -773,7 +852,7 @@ void InstrumentClip::processCurrentPos(ModelStackWithTimelineCounter* modelStack
 		doingSumTo100 = (probabilitySum == kNumProbabilityValues);
 
 		if (doingSumTo100) {
-			int32_t probabilityValueForSummers = ((uint32_t)getRandom255() * kNumProbabilityValues) >> 8;
+			int32_t probabilityValueForSummers = ((uint32_t)getProbabilityRandom255() * kNumProbabilityValues) >> 8;
 
 			int32_t probabilitySumSecondPass = 0;
 
@@ -873,7 +952,7 @@ doNewProbability:
 
 							// Otherwise, decide it now
 							else {
-								int32_t probabilityValue = ((uint32_t)getRandom255() * kNumProbabilityValues) >> 8;
+								int32_t probabilityValue = ((uint32_t)getProbabilityRandom255() * kNumProbabilityValues) >> 8;
 								conditionPassed = (probabilityValue < probability);
 
 								lastProbabilities[kNumProbabilityValues - probability] = !conditionPassed;
@@ -904,6 +983,58 @@ doNewProbability:
 	}
 }
 
+// Returns how many ticks until this NoteRow next needs processing
+int32_t InstrumentClip::processNoteRowCurrentPos(ModelStackWithTimelineCounter* modelStack, int32_t i,
+                                                 PendingNoteOnList* pendingNoteOnList) {
+	NoteRow* thisNoteRow = noteRows.getElement(i);
+
+	ModelStackWithNoteRow* modelStackWithNoteRow = modelStack->addNoteRow(getNoteRowId(thisNoteRow, i), thisNoteRow);
+
+	// Every NoteRow was visited on the last full pass, so if this one seems to have been visited before that, it must
+	// be new (or cloned from another Clip), and we go by when the Clip was last processed instead
+	int32_t ticksSinceLast = noteRowTickCount - thisNoteRow->lastProcessedNoteRowTick;
+	if (ticksSinceLast < 0 || ticksSinceLast > noteRowTickCount - noteRowTickCountLastFullPass) {
+		ticksSinceLast = noteRowsNumTicksBehindClip;
+	}
+	thisNoteRow->lastProcessedNoteRowTick = noteRowTickCount;
+
+	int32_t ticksTilNextEvent = thisNoteRow->processCurrentPos(modelStackWithNoteRow, ticksSinceLast, pendingNoteOnList);
+
+	// A NoteRow with its own play pos has to come back when that reaches its end, even if there's no event there
+	if (thisNoteRow->hasIndependentPlayPos()) {
+		int32_t pos = modelStackWithNoteRow->getLastProcessedPos();
+		int32_t effectiveLength = modelStackWithNoteRow->getLoopLength();
+		int32_t ticksTilEnd;
+		if (modelStackWithNoteRow->isCurrentlyPlayingReversed()) {
+			ticksTilEnd = pos ? pos : effectiveLength;
+		}
+		else {
+			ticksTilEnd = effectiveLength - pos;
+		}
+		ticksTilNextEvent = std::min(ticksTilNextEvent, ticksTilEnd);
+	}
+
+	return ticksTilNextEvent;
+}
+
+// NoteRows whose next event won't come before the Clip's loop point don't need to go in the queue
+void InstrumentClip::scheduleNoteRowEvent(int32_t i, int32_t ticksTilNextEvent) {
+	ticksTilNextNoteRowEvent = std::min(ticksTilNextNoteRowEvent, ticksTilNextEvent);
+
+	if (ticksTilNextEvent >= noteRowTickCountLoopEnd - noteRowTickCount) {
+		return;
+	}
+
+	if (noteRowEventQueueSize >= noteRowEventQueueCapacity) {
+		return; // Only if the queue couldn't be allocated - and then we visit everything each time anyway
+	}
+
+	int32_t tick = noteRowTickCount + ticksTilNextEvent;
+	noteRows.getElement(i)->nextEventNoteRowTick = tick;
+	noteRowEventQueue[noteRowEventQueueSize++] = {tick, i};
+	std::push_heap(noteRowEventQueue, noteRowEventQueue + noteRowEventQueueSize, noteRowEventIsLater);
+}
+
 void InstrumentClip::sendPendingNoteOn(ModelStackWithTimelineCounter* modelStack, PendingNoteOn* pendingNoteOn) {
 
 	ModelStackWithNoteRow* modelStackWithNoteRow =
@@ -2366,6 +2497,7 @@ someError:
 
 		else if (!strcmp(tagName, "instrumentPresetFolder")) {
 			storageManager.readTagOrAttributeValueString(&instrumentPresetDirPath);
+			instrumentPresetDirPath.intern();
 			dirPathHasBeenSpecified = true;
 		}
 
@@ -4166,6 +4298,7 @@ returnNull:
 
 void InstrumentClip::expectEvent() {
 	ticksTilNextNoteRowEvent = 0;
+	noteRowCursorGeneration++;
 	Clip::expectEvent();
 }
 
@@ -4176,8 +4309,8 @@ void InstrumentClip::instrumentBeenEdited() {
 // May return NULL NoteRow - you must check for that.
 ModelStackWithNoteRow* InstrumentClip::duplicateModelStackForClipBeingRecordedFrom(ModelStackWithNoteRow* modelStack,
                                                                                    char* otherModelStackMemory) {
-	copyModelStack(otherModelStackMemory, modelStack, sizeof(ModelStackWithNoteRowId));
-	ModelStackWithNoteRowId* otherModelStack = (ModelStackWithNoteRowId*)otherModelStackMemory;
+	ModelStackWithNoteRowId* otherModelStack =
+	    copyModelStack<ModelStackWithNoteRowId>(otherModelStackMemory, modelStack);
 	otherModelStack->setTimelineCounter(beingRecordedFromClip);
 	ModelStackWithNoteRow* otherModelStackWithNoteRow = otherModelStack->automaticallyAddNoteRowFromId();
 	return otherModelStackWithNoteRow;
@@ -4474,6 +4607,7 @@ void InstrumentClip::incrementPos(ModelStackWithTimelineCounter* modelStack, int
 
 	ticksTilNextNoteRowEvent -= numTicks; // We're one tick closer to the next event...
 	noteRowsNumTicksBehindClip += numTicks;
+	noteRowTickCount += numTicks;
 
 	if (ticksTilNextNoteRowEvent <= 0) {
 
@@ -47,6 +47,13 @@ class ModelStackWithModControllable;
 class ModelStackWithNoteRow;
 
 struct PendingNoteOn;
+struct PendingNoteOnList;
+
+// An entry in InstrumentClip's queue of upcoming NoteRow events
+struct NoteRowEvent {
+	int32_t tick; // In terms of InstrumentClip::noteRowTickCount
+	int32_t noteRowIndex;
+};
 
 extern uint8_t undefinedColour[];
 
@@ -118,6 +125,29 @@ public:
 
 	int32_t ticksTilNextNoteRowEvent;
 	int32_t noteRowsNumTicksBehindClip;
+	// Bumped by expectEvent(), so each NoteRow's next-note cursor, and the NoteRow event queue, know they're stale
+	uint32_t noteRowCursorGeneration;
+
+	// Min-heap of when each NoteRow next needs processing, so that processCurrentPos() only has to visit the ones whose
+	// next note or automation event has arrived. NoteRows whose next event is past the Clip's loop point aren't in it:
+	// all NoteRows get visited at the loop point anyway, and whenever expectEvent() has been called, since either of
+	// those could change anything.
+	NoteRowEvent* noteRowEventQueue;
+	int32_t noteRowEventQueueSize;
+	int32_t noteRowEventQueueCapacity;
+	int32_t noteRowEventQueueNumNoteRows; // How many NoteRows there were when it was built
+	uint32_t noteRowEventQueueGeneration;
+	int32_t noteRowTickCount;        // Ticks the NoteRows have been moved on by, in total. Wraps, which is fine
+	int32_t noteRowTickCountLoopEnd; // When the Clip next reaches its loop point
+	int32_t noteRowTickCountLastFullPass;
+
+	// Note probabilities are decided with this rather than the global generator, which the audio routine's forever
+	// drawing from too - so nothing else can change which way they go. See Song::seedClipProbabilities()
+	uint32_t probabilityRandomState;
+	uint8_t getProbabilityRandom255() {
+		probabilityRandomState = 69069 * probabilityRandomState + 1234567; // Same as CONG
+		return probabilityRandomState >> 24;
+	}
 
 	LearnedMIDI
 	    soundMidiCommand; // This is now handled by the Instrument, but for loading old songs, we need to capture and store this
@@ -257,6 +287,9 @@ private:
 	void deleteEmptyNoteRowsAtEitherEnd(bool onlyIfNoDrum, ModelStackWithTimelineCounter* modelStack,
 	                                    bool mustKeepLastOne = true, bool keepOnesWithMIDIInput = true);
 	void sendPendingNoteOn(ModelStackWithTimelineCounter* modelStack, PendingNoteOn* pendingNoteOn);
+	int32_t processNoteRowCurrentPos(ModelStackWithTimelineCounter* modelStack, int32_t i,
+	                                 PendingNoteOnList* pendingNoteOnList);
+	void scheduleNoteRowEvent(int32_t i, int32_t ticksTilNextEvent);
 	int32_t undoUnassignmentOfAllNoteRowsFromDrums(ModelStackWithTimelineCounter* modelStack);
 	void deleteBackedUpParamManagerMIDI();
 	bool possiblyDeleteEmptyNoteRow(NoteRow* noteRow, bool onlyIfNoDrum, Song* song, bool onlyIfNonNumeric = false,
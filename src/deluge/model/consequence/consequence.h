@@ -38,6 +38,7 @@ public:
 
 	virtual void prepareForDestruction(int32_t whichQueueActionIn, Song* song) {}
 	virtual int32_t revert(TimeType time, ModelStack* modelStack) = 0;
+	virtual uint32_t getMemoryUsage(); // Approximate - for trimming the undo history
 	Consequence* next;
 	uint8_t type;
 };
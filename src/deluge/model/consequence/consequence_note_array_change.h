@@ -28,6 +28,7 @@ public:
 	ConsequenceNoteArrayChange(InstrumentClip* newClip, int32_t newNoteRowId, NoteVector* newNoteVector,
 	                           bool stealData);
 	int32_t revert(TimeType time, ModelStack* modelStack);
+	uint32_t getMemoryUsage() { return Consequence::getMemoryUsage() + backedUpNoteVector.getMemoryUsage(); }
 
 	InstrumentClip* clip;
 	int32_t noteRowId;
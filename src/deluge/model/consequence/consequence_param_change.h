@@ -26,6 +26,7 @@ class ConsequenceParamChange final : public Consequence {
 public:
 	ConsequenceParamChange(ModelStackWithAutoParam const* modelStack, bool stealData);
 	int32_t revert(TimeType time, ModelStack* modelStackWithSong);
+	uint32_t getMemoryUsage() { return Consequence::getMemoryUsage() + state.nodes.getMemoryUsage(); }
 
 	union {
 		char modelStackMemory[MODEL_STACK_MAX_SIZE];
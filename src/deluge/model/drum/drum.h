@@ -58,6 +58,7 @@ public:
 	int8_t lastExpressionInputsReceived[2][kNumExpressionDimensions];
 
 	Drum* next;
+	Drum* nextInMIDINoteBucket; // See Kit::getFirstDrumInMIDINoteBucket()
 
 	LearnedMIDI midiInput;
 	LearnedMIDI muteMIDICommand;
@@ -51,6 +51,7 @@
 Kit::Kit() : Instrument(InstrumentType::KIT), drumsWithRenderingActive(sizeof(Drum*)) {
 	firstDrum = NULL;
 	selectedDrum = NULL;
+	drumMIDINoteBucketsGeneration = 0;
 }
 
 Kit::~Kit() {
@@ -152,7 +153,12 @@ bool Kit::writeDataToFile(Clip* clipForSavingOutputOnly, Song* song) {
 		}
 	}
 
-	// Then, write remaining Drums (or all Drums in the case of saving Song) whose order we didn't take from a NoteRow
+	// Then, write remaining Drums (or all Drums in the case of saving Song) whose order we didn't take from a NoteRow.
+	// We'll want to know for each one whether any NoteRow has it, so index them all at once. If there's not enough RAM
+	// for that, findNoteRowForDrum() just searches the Clips each time instead.
+	OpenAddressingHashTableWith32bitKeyAnd32bitValue drumNoteRowIndex;
+	song->buildDrumNoteRowIndex(this, &drumNoteRowIndex);
+
 	Drum** prevPointer = &firstDrum;
 	while (true) {
 
@@ -218,10 +224,13 @@ moveOn:
 		prevPointer = &thisDrum->next;
 	}
 
+	song->stopUsingDrumNoteRowIndex();
+
 	storageManager.writeClosingTag("soundSources");
 
 	*newLastDrum = firstDrum;
 	firstDrum = newFirstDrum;
+	drumMIDINoteBucketsGeneration = 0; // They've been reordered
 
 	if (selectedDrumIndex != -1) {
 		storageManager.writeTag((char*)"selectedDrumIndex", selectedDrumIndex);
@@ -398,6 +407,7 @@ void Kit::addDrum(Drum* newDrum) {
 	*prevPointer = newDrum;
 
 	newDrum->kit = this;
+	drumMIDINoteBucketsGeneration = 0;
 }
 
 void Kit::removeDrum(Drum* drum) {
@@ -407,6 +417,8 @@ void Kit::removeDrum(Drum* drum) {
 }
 
 void Kit::removeDrumFromLinkedList(Drum* drum) {
+	drumMIDINoteBucketsGeneration = 0;
+
 	Drum** prevPointer = &firstDrum;
 	while (*prevPointer) {
 		if (*prevPointer == drum) {
@@ -418,6 +430,8 @@ void Kit::removeDrumFromLinkedList(Drum* drum) {
 }
 
 void Kit::drumRemoved(Drum* drum) {
+	drumMIDINoteBucketsGeneration = 0;
+
 	if (selectedDrum == drum) {
 		selectedDrum = NULL;
 	}
@@ -749,7 +763,7 @@ void Kit::setupWithoutActiveClip(ModelStack* modelStack) {
 }
 
 // Accepts a ModelStack with NULL TimelineCounter
-void Kit::setupPatching(ModelStackWithTimelineCounter* modelStack) {
+void Kit::setupPatching(ModelStackWithTimelineCounter* modelStack, bool putOff) {
 
 	InstrumentClip* clip = (InstrumentClip*)modelStack->getTimelineCounterAllowNull();
 
@@ -775,8 +789,13 @@ void Kit::setupPatching(ModelStackWithTimelineCounter* modelStack) {
 				ModelStackWithParamCollection* modelStackWithParamCollection =
 				    modelStackWithThreeMainThings->addParamCollectionSummary(
 				        thisNoteRow->paramManager.getPatchCableSetSummary());
-				((PatchCableSet*)modelStackWithParamCollection->paramCollection)
-				    ->setupPatching(modelStackWithParamCollection);
+				PatchCableSet* patchCableSet = (PatchCableSet*)modelStackWithParamCollection->paramCollection;
+				if (putOff) {
+					patchCableSet->setupPatchingLater(modelStackWithParamCollection);
+				}
+				else {
+					patchCableSet->setupPatching(modelStackWithParamCollection);
+				}
 			}
 		}
 	}
@@ -806,8 +825,13 @@ void Kit::setupPatching(ModelStackWithTimelineCounter* modelStack) {
 				ModelStackWithParamCollection* modelStackWithParamCollection =
 				    modelStackWithThreeMainThings->addParamCollectionSummary(paramManager->getPatchCableSetSummary());
 
-				((PatchCableSet*)modelStackWithParamCollection->paramCollection)
-				    ->setupPatching(modelStackWithParamCollection);
+				PatchCableSet* patchCableSet = (PatchCableSet*)modelStackWithParamCollection->paramCollection;
+				if (putOff) {
+					patchCableSet->setupPatchingLater(modelStackWithParamCollection);
+				}
+				else {
+					patchCableSet->setupPatching(modelStackWithParamCollection);
+				}
 			}
 		}
 	}
@@ -994,6 +1018,32 @@ void Kit::getThingWithMostReverb(Sound** soundWithMostReverb, ParamManager** par
 	}
 }
 
+void Kit::buildDrumMIDINoteBuckets() {
+	Drum** lastInBucket[kNumDrumMIDINoteBuckets];
+	for (int32_t b = 0; b < kNumDrumMIDINoteBuckets; b++) {
+		drumMIDINoteBuckets[b] = NULL;
+		lastInBucket[b] = &drumMIDINoteBuckets[b];
+	}
+
+	for (Drum* thisDrum = firstDrum; thisDrum; thisDrum = thisDrum->next) {
+		thisDrum->nextInMIDINoteBucket = NULL;
+		if (thisDrum->midiInput.containsSomething()) {
+			int32_t b = thisDrum->midiInput.noteOrCC & (kNumDrumMIDINoteBuckets - 1);
+			*lastInBucket[b] = thisDrum;
+			lastInBucket[b] = &thisDrum->nextInMIDINoteBucket;
+		}
+	}
+
+	drumMIDINoteBucketsGeneration = Song::midiInputRoutingGeneration;
+}
+
+Drum* Kit::getFirstDrumInMIDINoteBucket(int32_t note) {
+	if (drumMIDINoteBucketsGeneration != Song::midiInputRoutingGeneration) {
+		buildDrumMIDINoteBuckets();
+	}
+	return drumMIDINoteBuckets[note & (kNumDrumMIDINoteBuckets - 1)];
+}
+
 void Kit::offerReceivedNote(ModelStackWithTimelineCounter* modelStack, MIDIDevice* fromDevice, bool on, int32_t channel,
                             int32_t note, int32_t velocity, bool shouldRecordNotes, bool* doingMidiThru) {
 
@@ -1007,7 +1057,7 @@ void Kit::offerReceivedNote(ModelStackWithTimelineCounter* modelStack, MIDIDevic
 	    && currentSong->isClipActive(instrumentClip); // Even if this comes out as false here, there are some
 	                                                  // special cases below where we might insist on making
 	                                                  // it true
-	for (Drum* thisDrum = firstDrum; thisDrum; thisDrum = thisDrum->next) {
+	for (Drum* thisDrum = getFirstDrumInMIDINoteBucket(note); thisDrum; thisDrum = thisDrum->nextInMIDINoteBucket) {
 
 		// If this is the "input" command, to sound / audition the Drum...
 		// Returns true if midi channel and note match the learned midi note
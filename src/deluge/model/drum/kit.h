@@ -28,6 +28,8 @@ class Sound;
 class SoundDrum;
 class NoteRow;
 class GateDrum;
+
+constexpr int32_t kNumDrumMIDINoteBuckets = 32; // Must be a power of 2
 class ModelStack;
 class ModelStackWithNoteRow;
 
@@ -69,7 +71,7 @@ public:
 	SoundDrum* getDrumFromName(char const* name, bool onlyIfNoNoteRow = false);
 	int32_t makeDrumNameUnique(String* name, int32_t startAtNumber);
 	bool setActiveClip(ModelStackWithTimelineCounter* modelStack, PgmChangeSend maySendMIDIPGMs);
-	void setupPatching(ModelStackWithTimelineCounter* modelStack);
+	void setupPatching(ModelStackWithTimelineCounter* modelStack, bool putOff = false);
 	void compensateInstrumentVolumeForResonance(ParamManagerForTimeline* paramManager, Song* song);
 	void deleteBackedUpParamManagers(Song* song);
 	void prepareForHibernationOrDeletion();
@@ -101,9 +103,12 @@ public:
 	                                   int32_t reverbAmountAdjust, int32_t sideChainHitPending,
 	                                   bool shouldLimitDelayFeedback, bool isClipActive, int32_t pitchAdjust,
 	                                   int32_t amplitudeAtStart, int32_t amplitudeAtEnd);
+	bool hasInputToRender(bool isClipActive) { return drumsWithRenderingActive.getNumElements(); }
 
 	char const* getXMLTag() { return "kit"; }
 
+	Drum* getFirstDrumInMIDINoteBucket(int32_t note);
+
 	Drum* firstDrum;
 	Drum* selectedDrum;
 
@@ -119,4 +124,14 @@ private:
 
 	void removeDrumFromLinkedList(Drum* drum);
 	void drumRemoved(Drum* drum);
+	void buildDrumMIDINoteBuckets();
+
+	// The Drums whose inputs are learned to each note, so an incoming one needn't be offered to every Drum in turn -
+	// which, for finger drumming into a big Kit, it otherwise would. Bucket b chains, through
+	// Drum::nextInMIDINoteBucket and in the same order as the Drums themselves, those learned to any note n with
+	// (n & (kNumDrumMIDINoteBuckets - 1)) == b - so callers must still check the Drum's input matches. Built the first
+	// time it's needed after Song::midiInputRoutingChanged(), or a Drum joining or leaving - 0 here means that's
+	// happened.
+	Drum* drumMIDINoteBuckets[kNumDrumMIDINoteBuckets];
+	uint32_t drumMIDINoteBucketsGeneration;
 };
@@ -721,7 +721,7 @@ ModFXType GlobalEffectable::getActiveModFXType(ParamManager* paramManager) {
 }
 
 void GlobalEffectable::setupDelayWorkingState(DelayWorkingState* delayWorkingState, ParamManager* paramManager,
-                                              bool shouldLimitDelayFeedback) {
+                                              bool shouldLimitDelayFeedback, bool anySoundComingIn) {
 
 	UnpatchedParamSet* unpatchedParams = paramManager->getUnpatchedParamSet();
 
@@ -735,7 +735,7 @@ void GlobalEffectable::setupDelayWorkingState(DelayWorkingState* delayWorkingSta
 	delayWorkingState->userDelayRate = getFinalParameterValueExp(
 	    paramNeutralValues[Param::Global::DELAY_RATE],
 	    cableToExpParamShortcut(unpatchedParams->getValue(Param::Unpatched::GlobalEffectable::DELAY_RATE)));
-	delay.setupWorkingState(delayWorkingState);
+	delay.setupWorkingState(delayWorkingState, anySoundComingIn);
 }
 
 void GlobalEffectable::processFXForGlobalEffectable(StereoSample* inputBuffer, int32_t numSamples,
@@ -770,24 +770,10 @@ void GlobalEffectable::processFXForGlobalEffectable(StereoSample* inputBuffer, i
 				memset(modFXBuffer, 0, kModFXBufferSize * sizeof(StereoSample));
 			}
 		}
-		if (modFXGrainBuffer) {
-			delugeDealloc(modFXGrainBuffer);
-			modFXGrainBuffer = NULL;
-		}
+		releaseGrainBuffer();
 	}
 	else if (modFXTypeNow == ModFXType::GRAIN) {
-		if (!modFXGrainBuffer) {
-			modFXGrainBuffer = (StereoSample*)GeneralMemoryAllocator::get().alloc(
-			    kModFXGrainBufferSize * sizeof(StereoSample), NULL, false, true);
-			if (!modFXGrainBuffer) {
-				modFXTypeNow = ModFXType::NONE;
-			}
-			for (int i = 0; i < 8; i++) {
-				grains[i].length = 0;
-			}
-			grainInitialized = false;
-			modFXGrainBufferWriteIndex = 0;
-		}
+		// The grain buffer gets claimed in processFX()
 		if (modFXBuffer) {
 			delugeDealloc(modFXBuffer);
 			modFXBuffer = NULL;
@@ -798,10 +784,7 @@ void GlobalEffectable::processFXForGlobalEffectable(StereoSample* inputBuffer, i
 			delugeDealloc(modFXBuffer);
 			modFXBuffer = NULL;
 		}
-		if (modFXGrainBuffer) {
-			delugeDealloc(modFXGrainBuffer);
-			modFXGrainBuffer = NULL;
-		}
+		releaseGrainBuffer();
 	}
 
 	processFX(inputBuffer, numSamples, modFXTypeNow, modFXRate, modFXDepth, delayWorkingState, postFXVolume,
@@ -53,7 +53,7 @@ public:
 	char const* paramToString(uint8_t param);
 	int32_t stringToParam(char const* string);
 	void setupDelayWorkingState(DelayWorkingState* delayWorkingState, ParamManager* paramManager,
-	                            bool shouldLimitDelayFeedback = false);
+	                            bool shouldLimitDelayFeedback = false, bool anySoundComingIn = true);
 
 	dsp::filter::FilterSet filterSet;
 	ModFXParam currentModFXParam;
@@ -24,6 +24,7 @@
 #include "model/action/action_logger.h"
 #include "modulation/params/param_manager.h"
 #include "processing/engines/audio_engine.h"
+#include "processing/engines/render_scratch.h"
 #include "storage/storage_manager.h"
 #include <string.h>
 //#include <algorithm>
@@ -46,6 +47,9 @@ GlobalEffectableForClip::GlobalEffectableForClip() {
 
 	lastSaturationTanHWorkingValue[0] = 2147483648;
 	lastSaturationTanHWorkingValue[1] = 2147483648;
+
+	skippingFXRendering = false;
+	startSkippingFXRenderingAtTime = 0;
 }
 
 // Beware - unlike usual, modelStack might have a NULL timelineCounter.
@@ -79,8 +83,10 @@ void GlobalEffectableForClip::renderOutput(ModelStackWithTimelineCounter* modelS
 	int32_t pitchAdjust = getFinalParameterValueExp(
 	    16777216, unpatchedParams->getValue(Param::Unpatched::GlobalEffectable::PITCH_ADJUST) >> 3);
 
+	bool inputComing = hasInputToRender(isClipActive);
+
 	DelayWorkingState delayWorkingState;
-	setupDelayWorkingState(&delayWorkingState, paramManagerForClip, shouldLimitDelayFeedback);
+	setupDelayWorkingState(&delayWorkingState, paramManagerForClip, shouldLimitDelayFeedback, inputComing);
 
 	setupFilterSetConfig(&volumePostFX, paramManagerForClip);
 
@@ -109,7 +115,11 @@ void GlobalEffectableForClip::renderOutput(ModelStackWithTimelineCounter* modelS
 		       >> 16); // This is tied to getParamNeutralValue(Param::Global::VOLUME_POST_REVERB_SEND) returning 134217728
 	}
 
-	static StereoSample globalEffectableBuffer[SSI_TX_BUFFER_NUM_SAMPLES] __attribute__((aligned(CACHE_LINE_SIZE)));
+	ScratchBuffer<StereoSample> globalEffectableScratch(SSI_TX_BUFFER_NUM_SAMPLES);
+	StereoSample* globalEffectableBuffer = globalEffectableScratch.get();
+	if (!globalEffectableBuffer) {
+		return;
+	}
 
 	bool canRenderDirectlyIntoSongBuffer =
 	    !isKit() && !filterSet.isOn() && !delayWorkingState.doDelay && (!pan || !AudioEngine::renderInStereo)
@@ -149,25 +159,29 @@ void GlobalEffectableForClip::renderOutput(ModelStackWithTimelineCounter* modelS
 
 	else {
 doNormal:
-		memset(globalEffectableBuffer, 0, sizeof(StereoSample) * numSamples);
+		// If the FX chain's asleep and nothing's going to be rendered, the buffer's already as empty as it's going to get
+		if (inputComing || !skippingFXRendering) {
+			memset(globalEffectableBuffer, 0, sizeof(StereoSample) * numSamples);
+		}
 
 		// Render actual Drums / AudioClip
 		rendered = renderGlobalEffectableForClip(
 		    modelStack, globalEffectableBuffer, NULL, numSamples, reverbBuffer, reverbAmountAdjustForDrums,
 		    sideChainHitPending, shouldLimitDelayFeedback, isClipActive, pitchAdjust, 134217728, 134217728);
 
-		// Render saturation
-		if (clippingAmount) {
-			StereoSample const* const bufferEnd = globalEffectableBuffer + numSamples;
+		// If there's no input and all the tails have died away, there's no need to run a bunch of processing on an empty buffer
+		if (!reassessFXRenderSkipping(rendered, getActiveModFXType(paramManagerForClip))) {
 
-			StereoSample* __restrict__ currentSample = globalEffectableBuffer;
-			do {
-				saturate(&currentSample->l, &lastSaturationTanHWorkingValue[0]);
-				saturate(&currentSample->r, &lastSaturationTanHWorkingValue[1]);
-			} while (++currentSample != bufferEnd);
-		}
-		//otherwise we can run a bunch of processing on an empty buffer
-		if (isClipActive | rendered) {
+			// Render saturation
+			if (clippingAmount) {
+				StereoSample const* const bufferEnd = globalEffectableBuffer + numSamples;
+
+				StereoSample* __restrict__ currentSample = globalEffectableBuffer;
+				do {
+					saturate(&currentSample->l, &lastSaturationTanHWorkingValue[0]);
+					saturate(&currentSample->r, &lastSaturationTanHWorkingValue[1]);
+				} while (++currentSample != bufferEnd);
+			}
 
 			// Render filters
 			processFilters(globalEffectableBuffer, numSamples);
@@ -203,6 +217,37 @@ doNormal:
 	}
 }
 
+// Returns whether the FX chain can be skipped this time. Like Sound::reassessRenderSkippingStatus(), we only start
+// skipping once there's no input, the delay has run out of repeats, stutter is off, and the mod FX (or just the
+// filters and EQ if there are no mod FX) have had time to ring out.
+bool GlobalEffectableForClip::reassessFXRenderSkipping(bool gotInput, ModFXType modFXType) {
+	if (gotInput || delay.repeatsUntilAbandon || stutterer.status != STUTTERER_STATUS_OFF) {
+		skippingFXRendering = false;
+		startSkippingFXRenderingAtTime = 0;
+		return false;
+	}
+
+	if (skippingFXRendering) {
+		return true;
+	}
+
+	// If we didn't start the wait-time yet, start it now. Filters and EQ get a little time too
+	if (!startSkippingFXRenderingAtTime) {
+		int32_t waitSamples = std::max(getModFXTailLength(modFXType), (int32_t)(20 * 44));
+		startSkippingFXRenderingAtTime = AudioEngine::audioSampleTimer + waitSamples;
+	}
+
+	// Or if already waiting, see if the wait is over yet
+	else if ((int32_t)(AudioEngine::audioSampleTimer - startSkippingFXRenderingAtTime) >= 0) {
+		startSkippingFXRenderingAtTime = 0;
+		skippingFXRendering = true;
+		clearModFXMemory(); // So nothing left over from the tail comes back when we start rendering again
+		return true;
+	}
+
+	return false;
+}
+
 int32_t GlobalEffectableForClip::getSidechainVolumeAmountAsPatchCableDepth(ParamManager* paramManager) {
 	int32_t sidechainVolumeParam =
 	    paramManager->getUnpatchedParamSet()->getValue(Param::Unpatched::GlobalEffectable::SIDECHAIN_VOLUME);
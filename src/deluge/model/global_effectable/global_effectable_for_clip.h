@@ -52,6 +52,10 @@ public:
 	int32_t postReverbVolumeLastTime;
 	uint32_t lastSaturationTanHWorkingValue[2];
 
+	// Whether the FX chain has gone quiet and is being left out of rendering until some input comes in again
+	bool skippingFXRendering;
+	uint32_t startSkippingFXRenderingAtTime; // Valid only if not 0. Allows the FX tails to decay before we skip
+
 protected:
 	int32_t getParameterFromKnob(int32_t whichModEncoder) final;
 	void renderOutput(ModelStackWithTimelineCounter* modelStack, ParamManager* paramManagerForClip,
@@ -67,4 +71,11 @@ protected:
 	                                           int32_t amplitudeAtEnd) = 0;
 
 	virtual bool willRenderAsOneChannelOnlyWhichWillNeedCopying() { return false; }
+
+	// Whether renderGlobalEffectableForClip() is going to put any sound in the buffer this time. Needs to be known
+	// before rendering, so the delay can decide whether to keep its buffers
+	virtual bool hasInputToRender(bool isClipActive) = 0;
+
+private:
+	bool reassessFXRenderSkipping(bool gotInput, ModFXType modFXType);
 };
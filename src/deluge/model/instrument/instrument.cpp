@@ -129,6 +129,7 @@ bool Instrument::readTagFromFile(char const* tagName) {
 
 	else if (!strcmp(tagName, "presetFolder")) {
 		storageManager.readTagOrAttributeValueString(&dirPath);
+		dirPath.intern();
 	}
 
 	else {
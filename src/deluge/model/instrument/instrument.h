@@ -53,8 +53,10 @@ public:
 
 	virtual bool doAnySoundsUseCC(uint8_t channel, uint8_t ccNumber, uint8_t value) { return false; }
 	virtual void beenEdited(bool shouldMoveToEmptySlot = true);
-	virtual void setupPatching(ModelStackWithTimelineCounter* modelStack) {
-	} // You must call this when an Instrument comes into existence or something... for every Clip, not just for the activeClip
+	// You must call this when an Instrument comes into existence or something... for every Clip, not just for the
+	// activeClip. With putOff, each Sound's patching is only marked as needing setting up when it's first used - see
+	// PatchCableSet::setupPatchingLater()
+	virtual void setupPatching(ModelStackWithTimelineCounter* modelStack, bool putOff = false) {}
 	void deleteAnyInstancesOfClip(InstrumentClip* clip);
 
 	//virtual void writeInstrumentDataToFile(bool savingSong, char const* slotName = "presetSlot", char const* subSlotName = "presetSubSlot");
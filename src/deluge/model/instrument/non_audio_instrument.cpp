@@ -34,7 +34,8 @@ void NonAudioInstrument::renderOutput(ModelStack* modelStack, StereoSample* star
 	if (activeClip) {
 		InstrumentClip* activeInstrumentClip = (InstrumentClip*)activeClip;
 
-		if (activeInstrumentClip->arpSettings.mode != ArpMode::OFF) {
+		// Nothing to do, not even working out the rate, if no notes are held
+		if (activeInstrumentClip->arpSettings.mode != ArpMode::OFF && arpeggiator.hasAnyInputNotesActive()) {
 			uint32_t gateThreshold = activeInstrumentClip->arpeggiatorGate + 2147483648;
 
 			uint32_t phaseIncrement = activeInstrumentClip->arpSettings.getPhaseIncrement(
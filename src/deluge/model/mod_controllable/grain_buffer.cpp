@@ -0,0 +1,74 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "model/mod_controllable/grain_buffer.h"
+#include "definitions_cxx.hpp"
+#include "dsp/stereo_sample.h"
+#include "hid/display/display.h"
+#include "memory/general_memory_allocator.h"
+#include <new>
+
+GrainBuffer* GrainBuffer::firstIdle = nullptr;
+
+GrainBuffer* GrainBuffer::claim() {
+	GrainBuffer* buffer = firstIdle;
+	if (buffer) {
+		firstIdle = buffer->nextIdle;
+		buffer->remove(); // From its stealable queue
+		buffer->inUse = true;
+		return buffer;
+	}
+
+	void* memory = GeneralMemoryAllocator::get().alloc(sizeof(GrainBuffer) + kModFXGrainBufferSize * sizeof(StereoSample),
+	                                                   NULL, false, false, true);
+	if (!memory) {
+		return NULL;
+	}
+	return new (memory) GrainBuffer();
+}
+
+void GrainBuffer::release() {
+	inUse = false;
+	nextIdle = firstIdle;
+	firstIdle = this;
+	GeneralMemoryAllocator::get().putStealableInAppropriateQueue(this);
+}
+
+// Until it's released, someone's recording into it
+bool GrainBuffer::mayBeStolen(void* thingNotToStealFrom) {
+	return !inUse;
+}
+
+void GrainBuffer::steal(char const* errorCode) {
+#if ALPHA_OR_BETA_VERSION
+	if (inUse) {
+		display->freezeWithError("E471");
+	}
+#endif
+
+	// Take ourselves out of the pool - our caller deallocates us
+	GrainBuffer** prevPointer = &firstIdle;
+	while (*prevPointer != this) {
+		prevPointer = &(*prevPointer)->nextIdle;
+	}
+	*prevPointer = nextIdle;
+}
+
+// Nothing in it's worth keeping, so it can go before anything else
+int32_t GrainBuffer::getAppropriateQueue() {
+	return STEALABLE_QUEUE_NO_SONG_SAMPLE_DATA;
+}
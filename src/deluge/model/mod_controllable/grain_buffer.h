@@ -0,0 +1,48 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "memory/stealable.h"
+
+class StereoSample;
+
+// The buffer the grain mod FX records into and plays grains back from, big enough for kModFXGrainBufferSize frames.
+// These are shared out from a pool: a ModControllableAudio claims one when it starts rendering grain, and releases it
+// when it stops. A released one waits in a stealable queue to be claimed again, and costs nothing to steal, since
+// whoever claims one starts recording afresh anyway.
+class GrainBuffer final : public Stealable {
+public:
+	// Returns NULL if there's no RAM for one
+	static GrainBuffer* claim();
+	void release();
+
+	StereoSample* getSamples() { return (StereoSample*)(this + 1); }
+
+	bool mayBeStolen(void* thingNotToStealFrom = nullptr);
+	void steal(char const* errorCode);
+	int32_t getAppropriateQueue();
+	uint32_t getReloadCost() override { return 0; }
+
+private:
+	GrainBuffer() = default;
+
+	bool inUse = true;
+	GrainBuffer* nextIdle = nullptr;
+
+	static GrainBuffer* firstIdle;
+};
@@ -16,8 +16,10 @@
  */
 
 #include "model/mod_controllable/mod_controllable_audio.h"
+#include "arm_neon.h"
 #include "definitions_cxx.hpp"
 #include "deluge/model/settings/runtime_feature_settings.h"
+#include "dsp/filter/stereo_lanes.h"
 #include "gui/l10n/l10n.h"
 #include "gui/views/session_view.h"
 #include "gui/views/view.h"
@@ -27,6 +29,7 @@
 #include "io/midi/midi_engine.h"
 #include "memory/general_memory_allocator.h"
 #include "model/clip/instrument_clip.h"
+#include "model/mod_controllable/grain_buffer.h"
 #include "model/model_stack.h"
 #include "model/note/note_row.h"
 #include "model/song/song.h"
@@ -38,6 +41,7 @@
 #include "processing/sound/sound.h"
 #include "storage/storage_manager.h"
 #include "util/fast_fixed_math.h"
+#include "util/functions_quad.h"
 #include "util/misc.h"
 #include <string.h>
 extern "C" {}
@@ -93,9 +97,7 @@ ModControllableAudio::~ModControllableAudio() {
 	if (modFXBuffer) {
 		delugeDealloc(modFXBuffer);
 	}
-	if (modFXGrainBuffer) {
-		delugeDealloc(modFXGrainBuffer);
-	}
+	releaseGrainBuffer();
 }
 
 void ModControllableAudio::cloneFrom(ModControllableAudio* other) {
@@ -108,6 +110,9 @@ void ModControllableAudio::cloneFrom(ModControllableAudio* other) {
 	filterRoute = other->filterRoute;
 	compressor.cloneFrom(&other->compressor);
 	midiKnobArray.cloneFrom(&other->midiKnobArray); // Could fail if no RAM... not too big a concern
+	if (currentSong) {
+		currentSong->learnedMIDIKnobsChanged();
+	}
 	delay.cloneFrom(&other->delay);
 }
 
@@ -149,13 +154,17 @@ void ModControllableAudio::processFX(StereoSample* buffer, int32_t numSamples, M
 
 	StereoSample* bufferEnd = buffer + numSamples;
 
+	if (modFXType == ModFXType::GRAIN && !claimGrainBuffer()) {
+		modFXType = ModFXType::NONE;
+	}
+
 	// Mod FX -----------------------------------------------------------------------------------
 	if (modFXType != ModFXType::NONE) {
 
 		LFOType modFXLFOWaveType;
 		int32_t modFXDelayOffset;
 		int32_t thisModFXDelayDepth;
-		int32_t feedback;
+		int32_t feedback = 0;
 
 		if (modFXType == ModFXType::FLANGER || modFXType == ModFXType::PHASER) {
 
@@ -249,36 +258,15 @@ void ModControllableAudio::processFX(StereoSample* buffer, int32_t numSamples, M
 			grainFeedbackVol = grainVol >> 3;
 		}
 
-		StereoSample* currentSample = buffer;
-		do {
-
-			int32_t lfoOutput = modFXLFO.render(1, modFXLFOWaveType, modFXRate);
-
-			if (modFXType == ModFXType::PHASER) {
-
-				// "1" is sorta represented by 1073741824 here
-				int32_t _a1 =
-				    1073741824
-				    - multiply_32x32_rshift32_rounded((((uint32_t)lfoOutput + (uint32_t)2147483648) >> 1), modFXDepth);
-
-				phaserMemory.l = currentSample->l + (multiply_32x32_rshift32_rounded(phaserMemory.l, feedback) << 1);
-				phaserMemory.r = currentSample->r + (multiply_32x32_rshift32_rounded(phaserMemory.r, feedback) << 1);
-
-				// Do the allpass filters
-				for (auto& sample : allpassMemory) {
-					StereoSample whatWasInput = phaserMemory;
-
-					phaserMemory.l = (multiply_32x32_rshift32_rounded(phaserMemory.l, -_a1) << 2) + sample.l;
-					sample.l = (multiply_32x32_rshift32_rounded(phaserMemory.l, _a1) << 2) + whatWasInput.l;
-
-					phaserMemory.r = (multiply_32x32_rshift32_rounded(phaserMemory.r, -_a1) << 2) + sample.r;
-					sample.r = (multiply_32x32_rshift32_rounded(phaserMemory.r, _a1) << 2) + whatWasInput.r;
-				}
+		if (modFXType == ModFXType::PHASER) {
+			processPhaser(buffer, numSamples, modFXRate, modFXDepth, feedback);
+		}
+		else if (modFXType == ModFXType::GRAIN) {
+			modFXLFO.tick(numSamples, modFXRate);
 
-				currentSample->l += phaserMemory.l;
-				currentSample->r += phaserMemory.r;
-			}
-			else if (modFXType == ModFXType::GRAIN) {
+			StereoSample* grainSamples = modFXGrainBuffer->getSamples();
+			StereoSample* currentSample = buffer;
+			do {
 
 				int32_t writeIndex = modFXGrainBufferWriteIndex & kModFXGrainBufferIndexMask; // % kModFXGrainBufferSize
 				if (modFXGrainBufferWriteIndex % grainRate == 0) {
@@ -398,9 +386,9 @@ void ModControllableAudio::processFX(StereoSample* buffer, int32_t numSamples, M
 						    (grains[i].startPoint + delta + kModFXGrainBufferSize) & kModFXGrainBufferIndexMask;
 
 						grains_l = multiply_accumulate_32x32_rshift32_rounded(
-						    grains_l, multiply_32x32_rshift32(modFXGrainBuffer[pos].l, vol) << 0, grains[i].panVolL);
+						    grains_l, multiply_32x32_rshift32(grainSamples[pos].l, vol) << 0, grains[i].panVolL);
 						grains_r = multiply_accumulate_32x32_rshift32_rounded(
-						    grains_r, multiply_32x32_rshift32(modFXGrainBuffer[pos].r, vol) << 0, grains[i].panVolR);
+						    grains_r, multiply_32x32_rshift32(grainSamples[pos].r, vol) << 0, grains[i].panVolR);
 
 						grains[i].counter++;
 						if (grains[i].counter >= grains[i].length) {
@@ -412,9 +400,9 @@ void ModControllableAudio::processFX(StereoSample* buffer, int32_t numSamples, M
 				grains_l <<= 3;
 				grains_r <<= 3;
 				//Feedback (Below grainFeedbackVol means "grainVol >> 4")
-				modFXGrainBuffer[writeIndex].l =
+				grainSamples[writeIndex].l =
 				    multiply_accumulate_32x32_rshift32_rounded(currentSample->l, grains_l, grainFeedbackVol);
-				modFXGrainBuffer[writeIndex].r =
+				grainSamples[writeIndex].r =
 				    multiply_accumulate_32x32_rshift32_rounded(currentSample->r, grains_r, grainFeedbackVol);
 				//WET and DRY Vol
 				currentSample->l = add_saturation(multiply_32x32_rshift32(currentSample->l, grainDryVol) << 1,
@@ -422,56 +410,13 @@ void ModControllableAudio::processFX(StereoSample* buffer, int32_t numSamples, M
 				currentSample->r = add_saturation(multiply_32x32_rshift32(currentSample->r, grainDryVol) << 1,
 				                                  multiply_32x32_rshift32(grains_r, grainVol) << 1);
 				modFXGrainBufferWriteIndex++;
-			}
-			else {
-
-				int32_t delayTime = multiply_32x32_rshift32(lfoOutput, thisModFXDelayDepth) + modFXDelayOffset;
-
-				int32_t strength2 = (delayTime & 65535) << 15;
-				int32_t strength1 = (65535 << 15) - strength2;
-				int32_t sample1Pos = modFXBufferWriteIndex - ((delayTime) >> 16);
-
-				int32_t scaledValue1L =
-				    multiply_32x32_rshift32_rounded(modFXBuffer[sample1Pos & kModFXBufferIndexMask].l, strength1);
-				int32_t scaledValue2L =
-				    multiply_32x32_rshift32_rounded(modFXBuffer[(sample1Pos - 1) & kModFXBufferIndexMask].l, strength2);
-				int32_t modFXOutputL = scaledValue1L + scaledValue2L;
-
-				if (modFXType == ModFXType::CHORUS_STEREO) {
-					delayTime = multiply_32x32_rshift32(lfoOutput, -thisModFXDelayDepth) + modFXDelayOffset;
-					strength2 = (delayTime & 65535) << 15;
-					strength1 = (65535 << 15) - strength2;
-					sample1Pos = modFXBufferWriteIndex - ((delayTime) >> 16);
-				}
-
-				int32_t scaledValue1R =
-				    multiply_32x32_rshift32_rounded(modFXBuffer[sample1Pos & kModFXBufferIndexMask].r, strength1);
-				int32_t scaledValue2R =
-				    multiply_32x32_rshift32_rounded(modFXBuffer[(sample1Pos - 1) & kModFXBufferIndexMask].r, strength2);
-				int32_t modFXOutputR = scaledValue1R + scaledValue2R;
-
-				if (modFXType == ModFXType::FLANGER) {
-					modFXOutputL = multiply_32x32_rshift32_rounded(modFXOutputL, feedback) << 2;
-					modFXBuffer[modFXBufferWriteIndex].l = modFXOutputL + currentSample->l; // Feedback
-					modFXOutputR = multiply_32x32_rshift32_rounded(modFXOutputR, feedback) << 2;
-					modFXBuffer[modFXBufferWriteIndex].r = modFXOutputR + currentSample->r; // Feedback
-				}
-
-				else { // Chorus
-					modFXOutputL <<= 1;
-					modFXBuffer[modFXBufferWriteIndex].l = currentSample->l; // Feedback
-					modFXOutputR <<= 1;
-					modFXBuffer[modFXBufferWriteIndex].r = currentSample->r; // Feedback
-				}
-
-				currentSample->l += modFXOutputL;
-				currentSample->r += modFXOutputR;
-				modFXBufferWriteIndex = (modFXBufferWriteIndex + 1) & kModFXBufferIndexMask;
-			}
-		} while (++currentSample != bufferEnd);
-		if (modFXType == ModFXType::GRAIN) {
+			} while (++currentSample != bufferEnd);
 			AudioEngine::logAction("grain end");
 		}
+		else {
+			processModFXDelayLine(buffer, numSamples, modFXType, modFXRate, modFXLFOWaveType, modFXDelayOffset,
+			                      thisModFXDelayDepth, feedback);
+		}
 	}
 
 	// EQ -------------------------------------------------------------------------------------
@@ -496,10 +441,7 @@ void ModControllableAudio::processFX(StereoSample* buffer, int32_t numSamples, M
 			trebleFreq = getExp(700000000, (unpatchedParams->getValue(Param::Unpatched::TREBLE_FREQ) >> 5) * 6);
 		}
 
-		StereoSample* currentSample = buffer;
-		do {
-			doEQ(thisDoBass, thisDoTreble, &currentSample->l, &currentSample->r, bassAmount, trebleAmount);
-		} while (++currentSample != bufferEnd);
+		processEQ(buffer, numSamples, thisDoBass, thisDoTreble, bassAmount, trebleAmount);
 	}
 
 	// Delay ----------------------------------------------------------------------------------
@@ -578,6 +520,7 @@ void ModControllableAudio::processFX(StereoSample* buffer, int32_t numSamples, M
 
 				int32_t* workingBufferPos = delayWorkingBuffer;
 				do {
+					delay.primaryBuffer.prefetch();
 					wrapped = delay.primaryBuffer.clearAndMoveOn() || wrapped;
 					workingBufferPos[0] = delay.primaryBuffer.bufferCurrentPos->l;
 					workingBufferPos[1] = delay.primaryBuffer.bufferCurrentPos->r;
@@ -591,6 +534,8 @@ void ModControllableAudio::processFX(StereoSample* buffer, int32_t numSamples, M
 
 				int32_t* workingBufferPos = delayWorkingBuffer;
 				do {
+					delay.primaryBuffer.prefetch();
+
 					// Move forward, and clear buffer as we go
 					delay.primaryBuffer.longPos += delayPrimarySetup.actualSpinRate;
 					uint8_t newShortPos = delay.primaryBuffer.longPos >> 24;
@@ -769,29 +714,8 @@ void ModControllableAudio::processFX(StereoSample* buffer, int32_t numSamples, M
 				delay.primaryBuffer.longPos = primaryBufferOldLongPos;
 				delay.primaryBuffer.lastShortPos = primaryBufferOldLastShortPos;
 
-				int32_t* workingBufferPos = delayWorkingBuffer;
-
-				do {
-
-					// Move forward, and clear buffer as we go
-					delay.primaryBuffer.longPos += delayPrimarySetup.actualSpinRate;
-					uint8_t newShortPos = delay.primaryBuffer.longPos >> 24;
-					uint8_t shortPosDiff = newShortPos - delay.primaryBuffer.lastShortPos;
-					delay.primaryBuffer.lastShortPos = newShortPos;
-
-					while (shortPosDiff > 0) {
-						delay.primaryBuffer.moveOn();
-						shortPosDiff--;
-					}
-
-					int32_t primaryStrength2 = (delay.primaryBuffer.longPos >> 8) & 65535;
-					int32_t primaryStrength1 = 65536 - primaryStrength2;
-
-					delay.primaryBuffer.writeResampled(workingBufferPos[0], workingBufferPos[1], primaryStrength1,
-					                                   primaryStrength2, &delayPrimarySetup);
-
-					workingBufferPos += 2;
-				} while (workingBufferPos != workingBufferEnd);
+				delay.primaryBuffer.writeResampledBlock(delayWorkingBuffer, numSamples, &delayPrimarySetup, false,
+				                                        &wrapped);
 			}
 		}
 
@@ -820,29 +744,8 @@ void ModControllableAudio::processFX(StereoSample* buffer, int32_t numSamples, M
 			// Resampled
 			else {
 
-				int32_t* workingBufferPos = delayWorkingBuffer;
-				do {
-					// Move forward, and clear buffer as we go
-					delay.secondaryBuffer.longPos += delaySecondarySetup.actualSpinRate;
-					uint8_t newShortPos = delay.secondaryBuffer.longPos >> 24;
-					uint8_t shortPosDiff = newShortPos - delay.secondaryBuffer.lastShortPos;
-					delay.secondaryBuffer.lastShortPos = newShortPos;
-
-					while (shortPosDiff > 0) {
-						wrapped = delay.secondaryBuffer.clearAndMoveOn() || wrapped;
-						delay.sizeLeftUntilBufferSwap--;
-						shortPosDiff--;
-					}
-
-					int32_t secondaryStrength2 = (delay.secondaryBuffer.longPos >> 8) & 65535;
-					int32_t secondaryStrength1 = 65536 - secondaryStrength2;
-
-					// Write to secondary buffer
-					delay.secondaryBuffer.writeResampled(workingBufferPos[0], workingBufferPos[1], secondaryStrength1,
-					                                     secondaryStrength2, &delaySecondarySetup);
-
-					workingBufferPos += 2;
-				} while (workingBufferPos != workingBufferEnd);
+				delay.sizeLeftUntilBufferSwap -= delay.secondaryBuffer.writeResampledBlock(
+				    delayWorkingBuffer, numSamples, &delaySecondarySetup, true, &wrapped);
 			}
 
 			if (delay.sizeLeftUntilBufferSwap < 0) {
@@ -856,6 +759,200 @@ void ModControllableAudio::processFX(StereoSample* buffer, int32_t numSamples, M
 	}
 }
 
+// Gathers two frames' worth of taps, {L, R, L, R}, with each channel reading from its own position
+[[gnu::always_inline]] static inline int32x4_t gatherModFXTaps(StereoSample const* modFXBuffer, int32_t const* posL,
+                                                               int32_t const* posR, int32_t frame, int32_t offset) {
+	int32x4_t taps = vdupq_n_s32(0);
+	taps = vld1q_lane_s32(&modFXBuffer[(posL[frame] - offset) & kModFXBufferIndexMask].l, taps, 0);
+	taps = vld1q_lane_s32(&modFXBuffer[(posR[frame] - offset) & kModFXBufferIndexMask].r, taps, 1);
+	taps = vld1q_lane_s32(&modFXBuffer[(posL[frame + 1] - offset) & kModFXBufferIndexMask].l, taps, 2);
+	return vld1q_lane_s32(&modFXBuffer[(posR[frame + 1] - offset) & kModFXBufferIndexMask].r, taps, 3);
+}
+
+// Chorus and flanger. The LFO is rendered for the whole block first, then each group of four samples has its delay
+// times worked out and its taps gathered together. That's only safe while the delay is between 4 and 511 samples, so
+// that no tap lands on a sample written earlier in the same group - outside that, the group goes one sample at a time
+void ModControllableAudio::processModFXDelayLine(StereoSample* buffer, int32_t numSamples, ModFXType modFXType,
+                                                 int32_t modFXRate, LFOType lfoWaveType, int32_t delayOffset,
+                                                 int32_t delayDepth, int32_t feedback) {
+
+	auto processSample = [&](StereoSample* currentSample, int32_t lfoOutput) {
+
+		int32_t delayTime = multiply_32x32_rshift32(lfoOutput, delayDepth) + delayOffset;
+
+		int32_t strength2 = (delayTime & 65535) << 15;
+		int32_t strength1 = (65535 << 15) - strength2;
+		int32_t sample1Pos = modFXBufferWriteIndex - ((delayTime) >> 16);
+
+		int32_t scaledValue1L =
+		    multiply_32x32_rshift32_rounded(modFXBuffer[sample1Pos & kModFXBufferIndexMask].l, strength1);
+		int32_t scaledValue2L =
+		    multiply_32x32_rshift32_rounded(modFXBuffer[(sample1Pos - 1) & kModFXBufferIndexMask].l, strength2);
+		int32_t modFXOutputL = scaledValue1L + scaledValue2L;
+
+		if (modFXType == ModFXType::CHORUS_STEREO) {
+			delayTime = multiply_32x32_rshift32(lfoOutput, -delayDepth) + delayOffset;
+			strength2 = (delayTime & 65535) << 15;
+			strength1 = (65535 << 15) - strength2;
+			sample1Pos = modFXBufferWriteIndex - ((delayTime) >> 16);
+		}
+
+		int32_t scaledValue1R =
+		    multiply_32x32_rshift32_rounded(modFXBuffer[sample1Pos & kModFXBufferIndexMask].r, strength1);
+		int32_t scaledValue2R =
+		    multiply_32x32_rshift32_rounded(modFXBuffer[(sample1Pos - 1) & kModFXBufferIndexMask].r, strength2);
+		int32_t modFXOutputR = scaledValue1R + scaledValue2R;
+
+		if (modFXType == ModFXType::FLANGER) {
+			modFXOutputL = multiply_32x32_rshift32_rounded(modFXOutputL, feedback) << 2;
+			modFXBuffer[modFXBufferWriteIndex].l = modFXOutputL + currentSample->l; // Feedback
+			modFXOutputR = multiply_32x32_rshift32_rounded(modFXOutputR, feedback) << 2;
+			modFXBuffer[modFXBufferWriteIndex].r = modFXOutputR + currentSample->r; // Feedback
+		}
+
+		else { // Chorus
+			modFXOutputL <<= 1;
+			modFXBuffer[modFXBufferWriteIndex].l = currentSample->l; // Feedback
+			modFXOutputR <<= 1;
+			modFXBuffer[modFXBufferWriteIndex].r = currentSample->r; // Feedback
+		}
+
+		currentSample->l += modFXOutputL;
+		currentSample->r += modFXOutputR;
+		modFXBufferWriteIndex = (modFXBufferWriteIndex + 1) & kModFXBufferIndexMask;
+
+	};
+
+	static const int32_t frameOffsets[4] = {0, 1, 2, 3};
+	int32_t lfoValues[SSI_TX_BUFFER_NUM_SAMPLES];
+	int32_t posL[4];
+	int32_t posR[4];
+
+	StereoSample* bufferEnd = buffer + numSamples;
+	while (buffer != bufferEnd) {
+		int32_t numSamplesNow = std::min<int32_t>(SSI_TX_BUFFER_NUM_SAMPLES, bufferEnd - buffer);
+		modFXLFO.renderBlock(lfoValues, numSamplesNow, lfoWaveType, modFXRate);
+
+		int32_t i = 0;
+		for (; i <= numSamplesNow - 4; i += 4) {
+			int32x4_t lfoOutput = vld1q_s32(&lfoValues[i]);
+			int32x4_t delayOffsetVector = vdupq_n_s32(delayOffset);
+			int32x4_t delayTimeL = vaddq_s32(multiply_32x32_rshift32_quad(lfoOutput, delayDepth), delayOffsetVector);
+			int32x4_t delayTimeR = delayTimeL;
+			if (modFXType == ModFXType::CHORUS_STEREO) {
+				delayTimeR = vaddq_s32(multiply_32x32_rshift32_quad(lfoOutput, -delayDepth), delayOffsetVector);
+			}
+
+			int32x4_t wholeSamplesL = vshrq_n_s32(delayTimeL, 16);
+			int32x4_t wholeSamplesR = vshrq_n_s32(delayTimeR, 16);
+			int32x4_t minWholeSamples = vminq_s32(wholeSamplesL, wholeSamplesR);
+			int32x4_t maxWholeSamples = vmaxq_s32(wholeSamplesL, wholeSamplesR);
+			int32x2_t minPair = vpmin_s32(vget_low_s32(minWholeSamples), vget_high_s32(minWholeSamples));
+			int32x2_t maxPair = vpmax_s32(vget_low_s32(maxWholeSamples), vget_high_s32(maxWholeSamples));
+			minPair = vpmin_s32(minPair, minPair);
+			maxPair = vpmax_s32(maxPair, maxPair);
+			if (vget_lane_s32(minPair, 0) < 4 || vget_lane_s32(maxPair, 0) > kModFXBufferIndexMask) {
+				for (int32_t j = i; j < i + 4; j++) {
+					processSample(&buffer[j], lfoValues[j]);
+				}
+				continue;
+			}
+
+			int32x4_t writeIndices = vaddq_s32(vdupq_n_s32(modFXBufferWriteIndex), vld1q_s32(frameOffsets));
+			vst1q_s32(posL, vsubq_s32(writeIndices, wholeSamplesL));
+			vst1q_s32(posR, vsubq_s32(writeIndices, wholeSamplesR));
+
+			int32x4_t strength2L = vshlq_n_s32(vandq_s32(delayTimeL, vdupq_n_s32(65535)), 15);
+			int32x4_t strength2R = vshlq_n_s32(vandq_s32(delayTimeR, vdupq_n_s32(65535)), 15);
+			int32x4x2_t strength1 = vzipq_s32(vsubq_s32(vdupq_n_s32(65535 << 15), strength2L),
+			                                  vsubq_s32(vdupq_n_s32(65535 << 15), strength2R));
+			int32x4x2_t strength2 = vzipq_s32(strength2L, strength2R);
+
+			// All the reading has to happen before any of the writing
+			int32x4_t taps1[2] = {gatherModFXTaps(modFXBuffer, posL, posR, 0, 0),
+			                      gatherModFXTaps(modFXBuffer, posL, posR, 2, 0)};
+			int32x4_t taps2[2] = {gatherModFXTaps(modFXBuffer, posL, posR, 0, 1),
+			                      gatherModFXTaps(modFXBuffer, posL, posR, 2, 1)};
+
+			for (int32_t h = 0; h < 2; h++) {
+				int32x4_t modFXOutput = vaddq_s32(multiply_32x32_rshift32_rounded_quad(taps1[h], strength1.val[h]),
+				                                  multiply_32x32_rshift32_rounded_quad(taps2[h], strength2.val[h]));
+				int32x4_t input = vld1q_s32(&buffer[i + h * 2].l);
+				int32x4_t toWrite;
+
+				if (modFXType == ModFXType::FLANGER) {
+					modFXOutput = multiply_32x32_rshift32_rounded_quad(modFXOutput, vdupq_n_s32(feedback));
+					modFXOutput = vshlq_n_s32(modFXOutput, 2);
+					toWrite = vaddq_s32(modFXOutput, input); // Feedback
+				}
+				else { // Chorus
+					modFXOutput = vshlq_n_s32(modFXOutput, 1);
+					toWrite = input;
+				}
+
+				int32_t writeIndex = modFXBufferWriteIndex + h * 2;
+				vst1_s32(&modFXBuffer[writeIndex & kModFXBufferIndexMask].l, vget_low_s32(toWrite));
+				vst1_s32(&modFXBuffer[(writeIndex + 1) & kModFXBufferIndexMask].l, vget_high_s32(toWrite));
+				vst1q_s32(&buffer[i + h * 2].l, vaddq_s32(input, modFXOutput));
+			}
+			modFXBufferWriteIndex = (modFXBufferWriteIndex + 4) & kModFXBufferIndexMask;
+		}
+
+		for (; i < numSamplesNow; i++) {
+			processSample(&buffer[i], lfoValues[i]);
+		}
+
+		buffer += numSamplesNow;
+	}
+}
+
+// The allpass cascade is one long dependency chain per channel, so the left and right channels go through it side by
+// side in the two lanes of a vector
+void ModControllableAudio::processPhaser(StereoSample* buffer, int32_t numSamples, int32_t modFXRate,
+                                         int32_t modFXDepth, int32_t feedback) {
+	using namespace deluge::dsp::filter;
+
+	int32_t lfoValues[SSI_TX_BUFFER_NUM_SAMPLES];
+
+	int32x2_t memory = vld1_s32(&phaserMemory.l);
+	int32x2_t allpass[kNumAllpassFiltersPhaser];
+	for (int32_t f = 0; f < kNumAllpassFiltersPhaser; f++) {
+		allpass[f] = vld1_s32(&allpassMemory[f].l);
+	}
+
+	StereoSample* bufferEnd = buffer + numSamples;
+	while (buffer != bufferEnd) {
+		int32_t numSamplesNow = std::min<int32_t>(SSI_TX_BUFFER_NUM_SAMPLES, bufferEnd - buffer);
+		modFXLFO.renderBlock(lfoValues, numSamplesNow, LFOType::SINE, modFXRate);
+
+		for (int32_t i = 0; i < numSamplesNow; i++) {
+			// "1" is sorta represented by 1073741824 here
+			int32_t _a1 =
+			    1073741824
+			    - multiply_32x32_rshift32_rounded((((uint32_t)lfoValues[i] + (uint32_t)2147483648) >> 1), modFXDepth);
+
+			int32x2_t input = vld1_s32(&buffer[i].l);
+			memory = vadd_s32(input, vshl_n_s32(multiply_32x32_rshift32_rounded_lanes(memory, feedback), 1));
+
+			// Do the allpass filters
+			for (auto& sample : allpass) {
+				int32x2_t whatWasInput = memory;
+				memory = vadd_s32(vshl_n_s32(multiply_32x32_rshift32_rounded_lanes(memory, -_a1), 2), sample);
+				sample = vadd_s32(vshl_n_s32(multiply_32x32_rshift32_rounded_lanes(memory, _a1), 2), whatWasInput);
+			}
+
+			vst1_s32(&buffer[i].l, vadd_s32(input, memory));
+		}
+
+		buffer += numSamplesNow;
+	}
+
+	vst1_s32(&phaserMemory.l, memory);
+	for (int32_t f = 0; f < kNumAllpassFiltersPhaser; f++) {
+		vst1_s32(&allpassMemory[f].l, allpass[f]);
+	}
+}
+
 void ModControllableAudio::processReverbSendAndVolume(StereoSample* buffer, int32_t numSamples, int32_t* reverbBuffer,
                                                       int32_t postFXVolume, int32_t postReverbVolume,
                                                       int32_t reverbSendAmount, int32_t pan, bool doAmplitudeIncrement,
@@ -926,6 +1023,8 @@ bool ModControllableAudio::isSRREnabled(ParamManager* paramManager) {
 
 void ModControllableAudio::processSRRAndBitcrushing(StereoSample* buffer, int32_t numSamples, int32_t* postFXVolume,
                                                     ParamManager* paramManager) {
+	using namespace deluge::dsp::filter;
+
 	StereoSample const* const bufferEnd = buffer + numSamples;
 
 	uint32_t bitCrushMaskForSRR = 0xFFFFFFFF;
@@ -943,11 +1042,15 @@ void ModControllableAudio::processSRRAndBitcrushing(StereoSample* buffer, int32_
 		// If not also doing SRR
 		if (!srrEnabled) {
 			uint32_t mask = 0xFFFFFFFF << (19 + (positivePreset));
+			int32x4_t maskVector = vdupq_n_s32(mask);
 			StereoSample* __restrict__ currentSample = buffer;
-			do {
+			for (; currentSample <= bufferEnd - 2; currentSample += 2) {
+				vst1q_s32(&currentSample->l, vandq_s32(vld1q_s32(&currentSample->l), maskVector));
+			}
+			if (currentSample != bufferEnd) {
 				currentSample->l &= mask;
 				currentSample->r &= mask;
-			} while (++currentSample != bufferEnd);
+			}
 		}
 
 		else {
@@ -974,8 +1077,16 @@ void ModControllableAudio::processSRRAndBitcrushing(StereoSample* buffer, int32_
 		int32_t highSampleRateIncrement = ((uint32_t)0xFFFFFFFF / (lowSampleRateIncrement >> 6)) << 6;
 		//int32_t highSampleRateIncrement = getExp(4194304, -(int32_t)(positivePreset >> 3)); // This would work too
 
+		// Both channels are interpolated side by side, in the two lanes of a vector. Any bitcrushing happens in here
+		// too, on the grabbed samples, so it doesn't need a pass of its own
+		int32x2_t last = vld1_s32(&lastSample.l);
+		int32x2_t grabbed = vld1_s32(&grabbedSample.l);
+		int32x2_t lastGrabbed = vld1_s32(&lastGrabbedSample.l);
+		int32x2_t bitCrushMask = vdup_n_s32(bitCrushMaskForSRR);
+
 		StereoSample* currentSample = buffer;
 		do {
+			int32x2_t input = vld1_s32(&currentSample->l);
 
 			// Convert down.
 			// If time to "grab" another sample for down-conversion...
@@ -983,13 +1094,10 @@ void ModControllableAudio::processSRRAndBitcrushing(StereoSample* buffer, int32_
 				int32_t strength2 = lowSampleRatePos;
 				int32_t strength1 = 4194303 - strength2;
 
-				lastGrabbedSample = grabbedSample; // What was current is now last
-				grabbedSample.l = multiply_32x32_rshift32_rounded(lastSample.l, strength1 << 9)
-				                  + multiply_32x32_rshift32_rounded(currentSample->l, strength2 << 9);
-				grabbedSample.r = multiply_32x32_rshift32_rounded(lastSample.r, strength1 << 9)
-				                  + multiply_32x32_rshift32_rounded(currentSample->r, strength2 << 9);
-				grabbedSample.l &= bitCrushMaskForSRR;
-				grabbedSample.r &= bitCrushMaskForSRR;
+				lastGrabbed = grabbed; // What was current is now last
+				grabbed = vadd_s32(multiply_32x32_rshift32_rounded_lanes(last, strength1 << 9),
+				                   multiply_32x32_rshift32_rounded_lanes(input, strength2 << 9));
+				grabbed = vand_s32(grabbed, bitCrushMask);
 
 				// Set the "time" at which we want to "grab" our next sample for down-conversion.
 				lowSampleRatePos += lowSampleRateIncrement;
@@ -1000,22 +1108,23 @@ void ModControllableAudio::processSRRAndBitcrushing(StereoSample* buffer, int32_
 				    multiply_32x32_rshift32_rounded(lowSampleRatePos & 4194303, highSampleRateIncrement << 8) << 2;
 			}
 			lowSampleRatePos -= 4194304; // We're one step closer to grabbing our next sample for down-conversion
-			lastSample = *currentSample;
+			last = input;
 
 			// Convert up
 			int32_t strength2 =
 			    std::min(highSampleRatePos,
 			             (uint32_t)4194303); // Would only overshoot if we raised the sample rate during playback
 			int32_t strength1 = 4194303 - strength2;
-			currentSample->l = (multiply_32x32_rshift32_rounded(lastGrabbedSample.l, strength1 << 9)
-			                    + multiply_32x32_rshift32_rounded(grabbedSample.l, strength2 << 9))
-			                   << 2;
-			currentSample->r = (multiply_32x32_rshift32_rounded(lastGrabbedSample.r, strength1 << 9)
-			                    + multiply_32x32_rshift32_rounded(grabbedSample.r, strength2 << 9))
-			                   << 2;
+			int32x2_t output = vadd_s32(multiply_32x32_rshift32_rounded_lanes(lastGrabbed, strength1 << 9),
+			                            multiply_32x32_rshift32_rounded_lanes(grabbed, strength2 << 9));
+			vst1_s32(&currentSample->l, vshl_n_s32(output, 2));
 
 			highSampleRatePos += highSampleRateIncrement;
 		} while (++currentSample != bufferEnd);
+
+		vst1_s32(&lastSample.l, last);
+		vst1_s32(&grabbedSample.l, grabbed);
+		vst1_s32(&lastGrabbedSample.l, lastGrabbed);
 	}
 	else {
 		sampleRateReductionOnLastTime = false;
@@ -1091,6 +1200,8 @@ void ModControllableAudio::processStutter(StereoSample* buffer, int32_t numSampl
 			int32_t strength1;
 			int32_t strength2;
 
+			stutterer.buffer.prefetch();
+
 			// Non-resampling read
 			if (!stutterer.buffer.isResampling) {
 				stutterer.buffer.moveOn();
@@ -1184,37 +1295,47 @@ void ModControllableAudio::initializeSecondaryDelayBuffer(int32_t newNativeRate,
 	}
 }
 
-inline void ModControllableAudio::doEQ(bool doBass, bool doTreble, int32_t* inputL, int32_t* inputR, int32_t bassAmount,
-                                       int32_t trebleAmount) {
-	int32_t trebleOnlyL;
-	int32_t trebleOnlyR;
+// Both channels go through the shelves side by side, in the two lanes of a vector
+void ModControllableAudio::processEQ(StereoSample* buffer, int32_t numSamples, bool doBass, bool doTreble,
+                                     int32_t bassAmount, int32_t trebleAmount) {
+	using namespace deluge::dsp::filter;
 
-	if (doTreble) {
-		int32_t distanceToGoL = *inputL - withoutTrebleL;
-		int32_t distanceToGoR = *inputR - withoutTrebleR;
-		withoutTrebleL += multiply_32x32_rshift32(distanceToGoL, trebleFreq) << 1;
-		withoutTrebleR += multiply_32x32_rshift32(distanceToGoR, trebleFreq) << 1;
-		trebleOnlyL = *inputL - withoutTrebleL;
-		trebleOnlyR = *inputR - withoutTrebleR;
-		*inputL = withoutTrebleL; // Input now has had the treble removed. Or is this bad?
-		*inputR = withoutTrebleR; // Input now has had the treble removed. Or is this bad?
-	}
+	int32x2_t withoutTreble = vset_lane_s32(withoutTrebleR, vdup_n_s32(withoutTrebleL), 1);
+	int32x2_t bassOnly = vset_lane_s32(bassOnlyR, vdup_n_s32(bassOnlyL), 1);
 
-	if (doBass) {
-		int32_t distanceToGoL = *inputL - bassOnlyL;
-		int32_t distanceToGoR = *inputR - bassOnlyR;
-		bassOnlyL += multiply_32x32_rshift32(distanceToGoL, bassFreq); // 33554432
-		bassOnlyR += multiply_32x32_rshift32(distanceToGoR, bassFreq); // 33554432
-	}
+	StereoSample* currentSample = buffer;
+	StereoSample* bufferEnd = buffer + numSamples;
+	do {
+		int32x2_t input = vld1_s32(&currentSample->l);
+		int32x2_t trebleOnly;
+
+		if (doTreble) {
+			int32x2_t distanceToGo = vsub_s32(input, withoutTreble);
+			withoutTreble =
+			    vadd_s32(withoutTreble, vshl_n_s32(multiply_32x32_rshift32_lanes(distanceToGo, trebleFreq), 1));
+			trebleOnly = vsub_s32(input, withoutTreble);
+			input = withoutTreble; // Input now has had the treble removed. Or is this bad?
+		}
 
-	if (doTreble) {
-		*inputL += (multiply_32x32_rshift32(trebleOnlyL, trebleAmount) << 3);
-		*inputR += (multiply_32x32_rshift32(trebleOnlyR, trebleAmount) << 3);
-	}
-	if (doBass) {
-		*inputL += (multiply_32x32_rshift32(bassOnlyL, bassAmount) << 3);
-		*inputR += (multiply_32x32_rshift32(bassOnlyR, bassAmount) << 3);
-	}
+		if (doBass) {
+			int32x2_t distanceToGo = vsub_s32(input, bassOnly);
+			bassOnly = vadd_s32(bassOnly, multiply_32x32_rshift32_lanes(distanceToGo, bassFreq)); // 33554432
+		}
+
+		if (doTreble) {
+			input = vadd_s32(input, vshl_n_s32(multiply_32x32_rshift32_lanes(trebleOnly, trebleAmount), 3));
+		}
+		if (doBass) {
+			input = vadd_s32(input, vshl_n_s32(multiply_32x32_rshift32_lanes(bassOnly, bassAmount), 3));
+		}
+
+		vst1_s32(&currentSample->l, input);
+	} while (++currentSample != bufferEnd);
+
+	withoutTrebleL = vget_lane_s32(withoutTreble, 0);
+	withoutTrebleR = vget_lane_s32(withoutTreble, 1);
+	bassOnlyL = vget_lane_s32(bassOnly, 0);
+	bassOnlyR = vget_lane_s32(bassOnly, 1);
 }
 
 void ModControllableAudio::writeAttributesToFile() {
@@ -1519,6 +1640,9 @@ doReadPatchedParam:
 				if (p != Param::Global::NONE && p != Param::PLACEHOLDER_RANGE) {
 					MIDIKnob* newKnob = midiKnobArray.insertKnobAtEnd();
 					if (newKnob) {
+						if (currentSong) {
+							currentSong->learnedMIDIKnobsChanged();
+						}
 						newKnob->midiInput.device = device;
 						newKnob->midiInput.channelOrZone = channel;
 						newKnob->midiInput.noteOrCC = ccNumber;
@@ -1885,7 +2009,8 @@ void ModControllableAudio::beginStutter(ParamManagerForTimeline* paramManager) {
 	}
 
 	// You'd think I should apply "false" here, to make it not add extra space to the buffer, but somehow this seems to sound as good if not better (in terms of ticking / crackling)...
-	bool error = stutterer.buffer.init(getStutterRate(paramManager), 0, true);
+	// The memory comes from the reserve the AudioEngine keeps, so this doesn't have to go to the allocator mid-gesture
+	bool error = stutterer.buffer.init(getStutterRate(paramManager), 0, true, true);
 	if (error == NO_ERROR) {
 		stutterer.status = STUTTERER_STATUS_RECORDING;
 		stutterer.sizeLeftUntilRecordFinished = stutterer.buffer.size;
@@ -2075,6 +2200,46 @@ void ModControllableAudio::switchHPFMode() {
 void ModControllableAudio::wontBeRenderedForAWhile() {
 	delay.discardBuffers();
 	endStutter(NULL);
+	releaseGrainBuffer();
+}
+
+// Grain buffers are only held while being rendered with - see GrainBuffer. Whatever we'd recorded before is gone, so
+// start over. Returns false if there's no RAM for one
+bool ModControllableAudio::claimGrainBuffer() {
+	if (modFXGrainBuffer) {
+		return true;
+	}
+	modFXGrainBuffer = GrainBuffer::claim();
+	if (!modFXGrainBuffer) {
+		return false;
+	}
+	for (int i = 0; i < 8; i++) {
+		grains[i].length = 0;
+	}
+	grainInitialized = false;
+	modFXGrainBufferWriteIndex = 0;
+	return true;
+}
+
+void ModControllableAudio::releaseGrainBuffer() {
+	if (modFXGrainBuffer) {
+		modFXGrainBuffer->release();
+		modFXGrainBuffer = NULL;
+	}
+}
+
+int32_t ModControllableAudio::getModFXTailLength(ModFXType type) {
+	switch (type) {
+	case ModFXType::NONE:
+		return 0;
+	case ModFXType::CHORUS:
+	case ModFXType::CHORUS_STEREO:
+		return 20 * 44; // 20mS
+	case ModFXType::GRAIN:
+		return 350 * 441; // 3.5S
+	default:
+		return 90 * 441; // 900mS. Lots is required for feeding-back flanger or phaser
+	}
 }
 
 void ModControllableAudio::clearModFXMemory() {
@@ -2153,6 +2318,9 @@ midiKnobFound:
 		knob->midiInput.device = fromDevice;
 		knob->paramDescriptor = paramDescriptor;
 		knob->relative = (whichKnob != 128); // Guess that it's relative, unless this is a pitch-bend "knob"
+		if (song) {
+			song->learnedMIDIKnobsChanged();
+		}
 	}
 
 	if (overwroteExistingKnob) {
@@ -52,6 +52,7 @@ struct Grain {
 	int32_t panVolR; //0 - 1073741823
 };
 
+class GrainBuffer;
 class Knob;
 class MIDIDevice;
 class ModelStackWithTimelineCounter;
@@ -131,7 +132,7 @@ public:
 	LFO modFXLFO;
 
 	//Grain
-	StereoSample* modFXGrainBuffer;
+	GrainBuffer* modFXGrainBuffer;
 	uint32_t modFXGrainBufferWriteIndex;
 	int32_t grainSize;
 	int32_t grainRate;
@@ -169,10 +170,20 @@ protected:
 	void switchLPFMode();
 	void switchHPFMode();
 	void clearModFXMemory();
+	bool claimGrainBuffer();
+	void releaseGrainBuffer();
+
+	/// How many samples the given mod FX can keep sounding for after its input goes silent
+	static int32_t getModFXTailLength(ModFXType type);
 
 private:
+	void processModFXDelayLine(StereoSample* buffer, int32_t numSamples, ModFXType modFXType, int32_t modFXRate,
+	                           LFOType lfoWaveType, int32_t delayOffset, int32_t delayDepth, int32_t feedback);
+	void processPhaser(StereoSample* buffer, int32_t numSamples, int32_t modFXRate, int32_t modFXDepth,
+	                   int32_t feedback);
 	void initializeSecondaryDelayBuffer(int32_t newNativeRate, bool makeNativeRatePreciseRelativeToOtherBuffer);
-	void doEQ(bool doBass, bool doTreble, int32_t* inputL, int32_t* inputR, int32_t bassAmount, int32_t trebleAmount);
+	void processEQ(StereoSample* buffer, int32_t numSamples, bool doBass, bool doTreble, int32_t bassAmount,
+	               int32_t trebleAmount);
 	ModelStackWithThreeMainThings* addNoteRowIndexAndStuff(ModelStackWithTimelineCounter* modelStack,
 	                                                       int32_t noteRowIndex);
 };
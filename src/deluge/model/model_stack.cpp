@@ -211,6 +211,3 @@ bool ModelStackWithSoundFlags::checkSourceEverActive(int32_t s) {
 	return flagValue;
 }
 
-void copyModelStack(void* newMemory, void const* oldMemory, int32_t size) {
-	memcpy(newMemory, oldMemory, size);
-}
@@ -19,6 +19,7 @@
 
 #include "hid/display/display.h"
 #include "modulation/params/param_manager.h"
+#include <string.h>
 
 class Song;
 class ModControllable;
@@ -298,6 +299,7 @@ public:
 };
 
 #define MODEL_STACK_MAX_SIZE sizeof(ModelStackWithAutoParam)
+static_assert(sizeof(ModelStackWithVoice) <= MODEL_STACK_MAX_SIZE, "ModelStack memory must fit the deepest level");
 
 inline ModelStack* setupModelStackWithSong(void* memory, Song* newSong) {
 	ModelStack* modelStack = (ModelStack*)memory;
@@ -485,7 +487,19 @@ inline ModelStackWithVoice* ModelStackWithSoundFlags::addVoice(Voice* voice) con
 	return toReturn;
 }
 
-void copyModelStack(void* newMemory, void const* oldMemory, int32_t size);
+// Copies the bottom part of a ModelStack, up to and including the level that size is the sizeof(). Callers always give a
+// sizeof(), so being inline this comes out as a few word copies rather than a call into memcpy()
+inline void copyModelStack(void* newMemory, void const* oldMemory, int32_t size) {
+	memcpy(newMemory, oldMemory, size);
+}
+
+// Same, but with the level to copy up to given as a type, and giving back the copy as that type. The compiler checks that
+// the ModelStack being copied actually has that level
+template <class ModelStackType>
+inline ModelStackType* copyModelStack(void* newMemory, ModelStackType const* oldModelStack) {
+	memcpy(newMemory, oldModelStack, sizeof(ModelStackType));
+	return (ModelStackType*)newMemory;
+}
 
 /*
 
@@ -63,6 +63,9 @@ NoteRow::NoteRow(int16_t newY) {
 	firstOldDrumName = NULL;
 	soundingStatus = STATUS_OFF;
 	skipNextNote = false;
+	nextNoteEventCursorValid = false;
+	lastProcessedNoteRowTick = 0;
+	nextEventNoteRowTick = 0;
 	probabilityValue = kNumProbabilityValues;
 	loopLengthIfIndependent = 0;
 	sequenceDirectionMode = SequenceDirection::OBEY_PARENT;
@@ -95,6 +98,7 @@ int32_t NoteRow::beenCloned(ModelStackWithNoteRow* modelStack, bool shouldFlatte
 
 	firstOldDrumName = NULL;
 	skipNextNote = false;
+	nextNoteEventCursorValid = false;
 	//soundingStatus = STATUS_OFF;
 
 	int32_t effectiveLength = modelStack->getLoopLength();
@@ -365,7 +369,7 @@ int32_t NoteRow::addCorrespondingNotes(int32_t targetPos, int32_t newNotesLength
 
 	// Allocate all the working memory we're going to need for this operation - that's arrays for searchPos and resultingIndexes
 	int32_t* __restrict__ searchTerms =
-	    (int32_t*)GeneralMemoryAllocator::get().alloc(numScreensToAddNoteOn * sizeof(int32_t), NULL, false, true);
+	    (int32_t*)GeneralMemoryAllocator::get().allocTemporary(numScreensToAddNoteOn * sizeof(int32_t));
 	if (!searchTerms) {
 		return ERROR_INSUFFICIENT_RAM;
 	}
@@ -663,7 +667,7 @@ int32_t NoteRow::clearArea(int32_t areaStart, int32_t areaWidth, ModelStackWithN
 
 	// Allocate all the working memory we're going to need for this operation - that's arrays for searchPos and resultingIndexes
 	int32_t* __restrict__ searchTerms =
-	    (int32_t*)GeneralMemoryAllocator::get().alloc(numScreens * 2 * sizeof(int32_t), NULL, false, true);
+	    (int32_t*)GeneralMemoryAllocator::get().allocTemporary(numScreens * 2 * sizeof(int32_t));
 	if (!searchTerms) {
 		return ERROR_INSUFFICIENT_RAM;
 	}
@@ -958,7 +962,7 @@ int32_t NoteRow::editNoteRepeatAcrossAllScreens(int32_t editPos, int32_t squareW
 
 	// Allocate all the working memory we're going to need for this operation - that's arrays for searchPos and resultingIndexes
 	int32_t* __restrict__ searchTerms =
-	    (int32_t*)GeneralMemoryAllocator::get().alloc(numScreens * 2 * sizeof(int32_t), NULL, false, true);
+	    (int32_t*)GeneralMemoryAllocator::get().allocTemporary(numScreens * 2 * sizeof(int32_t));
 	if (!searchTerms) {
 		return ERROR_INSUFFICIENT_RAM;
 	}
@@ -1155,7 +1159,7 @@ int32_t NoteRow::nudgeNotesAcrossAllScreens(int32_t editPos, ModelStackWithNoteR
 
 	// Allocate all the working memory we're going to need for this operation - that's arrays for searchPos and resultingIndexes
 	int32_t* __restrict__ searchTerms =
-	    (int32_t*)GeneralMemoryAllocator::get().alloc(numScreens * 2 * sizeof(int32_t), NULL, false, true);
+	    (int32_t*)GeneralMemoryAllocator::get().allocTemporary(numScreens * 2 * sizeof(int32_t));
 	if (!searchTerms) {
 		return ERROR_INSUFFICIENT_RAM;
 	}
@@ -1434,7 +1438,7 @@ int32_t NoteRow::changeNotesAcrossAllScreens(int32_t editPos, ModelStackWithNote
 
 	// Allocate all the working memory we're going to need for this operation - that's arrays for searchPos and resultingIndexes
 	int32_t* __restrict__ searchTerms =
-	    (int32_t*)GeneralMemoryAllocator::get().alloc(numScreens * sizeof(int32_t), NULL, false, true);
+	    (int32_t*)GeneralMemoryAllocator::get().allocTemporary(numScreens * sizeof(int32_t));
 	if (!searchTerms) {
 		return ERROR_INSUFFICIENT_RAM;
 	}
@@ -1660,6 +1664,34 @@ void NoteRow::renderRow(TimelineView* editorScreen, uint8_t rowColour[], uint8_t
 	    != xEnd); // This will only do another repeat if we'd modified xEndNow, which can only happen if drawRepeats
 }
 
+// A cheap checksum of all the Notes renderRow() would look at, without drawRepeats, to draw the stretch from startPos
+// to endPos - so a caller can tell whether drawing it again could come out any different
+uint32_t NoteRow::getRenderChecksum(int32_t startPos, int32_t endPos) {
+	int32_t numNotes = notes.getNumElements();
+	uint32_t checksum = numNotes;
+	if (!numNotes) {
+		return checksum;
+	}
+
+	auto addNote = [&checksum](Note* note) {
+		checksum = (checksum ^ note->pos) * 16777619;
+		checksum = (checksum ^ note->length) * 16777619;
+		checksum = (checksum ^ note->probability) * 16777619;
+	};
+
+	// From the last Note starting before the stretch, whose tail might reach into it, to the last one starting in it
+	int32_t iStart = std::max<int32_t>(notes.search(startPos, LESS), 0);
+	int32_t iEnd = notes.search(endPos, LESS);
+	for (int32_t i = iStart; i <= iEnd; i++) {
+		addNote(notes.getElement(i));
+	}
+
+	// And the very last one, whose tail might wrap round to the start
+	addNote(notes.getLast());
+
+	return checksum;
+}
+
 SequenceDirection NoteRow::getEffectiveSequenceDirectionMode(ModelStackWithNoteRow const* modelStack) {
 	if (sequenceDirectionMode == SequenceDirection::OBEY_PARENT) {
 		return ((Clip*)modelStack->getTimelineCounter())->sequenceDirectionMode;
@@ -1774,6 +1806,22 @@ int32_t NoteRow::processCurrentPos(ModelStackWithNoteRow* modelStack, int32_t ti
 
 	int32_t ticksTilNextNoteEvent = 2147483647;
 	int32_t effectiveCurrentPos = modelStack->getLastProcessedPos(); // May have got incremented above
+	int32_t cursorPos = effectiveCurrentPos;
+
+	// Most of the time, the cursor tells us there's nothing due yet
+	if (nextNoteEventCursorValid && !didPingpong && !skipNextNote
+	    && nextNoteEventCursorGeneration == clip->noteRowCursorGeneration
+	    && nextNoteEventCursorReversed == playingReversedNow && nextNoteEventCursorSoundingStatus == soundingStatus
+	    && effectiveCurrentPos
+	           == nextNoteEventCursorPos + (playingReversedNow ? -ticksSinceLast : ticksSinceLast)) {
+		ticksTilNextNoteEvent = nextNoteEventCursorTicksTil - ticksSinceLast;
+		if (ticksTilNextNoteEvent > 0) {
+			nextNoteEventCursorPos = effectiveCurrentPos;
+			nextNoteEventCursorTicksTil = ticksTilNextNoteEvent;
+			return std::min(ticksTilNextNoteEvent, ticksTilNextParamManagerEvent);
+		}
+		ticksTilNextNoteEvent = 2147483647;
+	}
 
 	if (muted) {
 noFurtherNotes:
@@ -2008,14 +2056,45 @@ gotValidNoteIndex:
 					    nextNote->length; // Want this even if we're "skipping" playing the note (why exactly?)
 				}
 
+				// Or if it's not due yet, maybe it's soon enough to get ready for
+				else if (!skipNextNote) {
+					prepareForUpcomingNote(modelStack, newTicksTil);
+				}
+
 				ticksTilNextNoteEvent = newTicksTil;
 			}
 		}
 	}
 
+	nextNoteEventCursorValid = !muted; // Muted ones have nothing to search anyway
+	nextNoteEventCursorReversed = playingReversedNow;
+	nextNoteEventCursorSoundingStatus = soundingStatus;
+	nextNoteEventCursorPos = cursorPos;
+	nextNoteEventCursorTicksTil = ticksTilNextNoteEvent;
+	nextNoteEventCursorGeneration = clip->noteRowCursorGeneration;
+
 	return std::min(ticksTilNextNoteEvent, ticksTilNextParamManagerEvent);
 }
 
+// Sequenced notes are known about ahead of time, so if the next one's due within kSequencedNoteLookaheadSamples, let its
+// Sound do what it can for it now rather than all at once on the tick it starts - see Sound::prepareForUpcomingNote()
+void NoteRow::prepareForUpcomingNote(ModelStackWithNoteRow* modelStack, int32_t ticksTil) {
+	uint32_t timePerTick = playbackHandler.getTimePerInternalTick();
+	if ((uint64_t)ticksTil * timePerTick > kSequencedNoteLookaheadSamples) {
+		return;
+	}
+
+	Clip* clip = (Clip*)modelStack->getTimelineCounter();
+	Output* output = clip->output;
+
+	if (output->type == InstrumentType::SYNTH) {
+		((SoundInstrument*)output)->prepareForUpcomingNote(&clip->paramManager, getNoteCode());
+	}
+	else if (output->type == InstrumentType::KIT && drum && drum->type == DrumType::SOUND) {
+		((SoundDrum*)drum)->prepareForUpcomingNote(&paramManager, kNoteForDrum);
+	}
+}
+
 bool NoteRow::isAuditioning(ModelStackWithNoteRow* modelStack) {
 	Clip* clip = (Clip*)modelStack->getTimelineCounter();
 	Output* output = clip->output;
@@ -3523,35 +3602,81 @@ bool NoteRow::paste(ModelStackWithNoteRow* modelStack, CopiedNoteRow* copiedNote
 		                                                     modelStack->noteRowId, &notes, false);
 	}
 
-	// TODO: this could be done without all these many inserts, and could be improved further by "stealing" the data into the action, above
-	for (int32_t n = 0; n < copiedNoteRow->numNotes; n++) {
+	// Work out where the copied Notes land, first just to count them and see where they'll go, so the whole lot can be
+	// inserted at once - one shift of whatever comes after, and at most one reallocation, however many there are.
+	// TODO: this could be improved further by "stealing" the data into the action, above
+	int32_t xScroll = modelStack->song->xScroll[NAVIGATION_CLIP];
+	int32_t numToPaste = 0;
+	int32_t firstPos = 0;
+	int32_t lastPos = 0;
 
-		Note* noteSource = &copiedNoteRow->notes[n];
+	for (int32_t pass = 0; pass < 2; pass++) {
+		int32_t noteDestI = 0;
+		minPos = 0;
 
-		int32_t newPos =
-		    modelStack->song->xScroll[NAVIGATION_CLIP] + (int32_t)roundf((float)noteSource->pos * scaleFactor);
+		if (pass == 1) {
+			if (!numToPaste) {
+				return true;
+			}
+
+			noteDestI = notes.search(firstPos, GREATER_OR_EQUAL);
 
-		// Make sure that with dividing and rounding, we're not overlapping the previous note - or past the end of the screen / Clip
-		if (newPos < minPos || newPos >= maxPos) {
-			continue;
+			// The caller has normally cleared the area first. If it hasn't, something's in the way, so it'll have to
+			// be the old way - each Note inserted at its own key
+			bool areaClear = (noteDestI >= notes.getNumElements() || notes.getKeyAtIndex(noteDestI) > lastPos);
+			if (areaClear) {
+				if (notes.insertAtIndex(noteDestI, numToPaste)) {
+					return false;
+				}
+			}
+			else {
+				noteDestI = -1;
+			}
 		}
 
-		int32_t newLength = roundf((float)noteSource->length * scaleFactor);
-		newLength = std::max(newLength, (int32_t)1);
-		newLength = std::min(newLength, maxPos - newPos);
+		for (int32_t n = 0; n < copiedNoteRow->numNotes; n++) {
 
-		int32_t noteDestI = notes.insertAtKey(newPos);
-		Note* noteDest = notes.getElement(noteDestI);
-		if (!noteDest) {
-			return false;
-		}
+			Note* noteSource = &copiedNoteRow->notes[n];
+
+			int32_t newPos = xScroll + (int32_t)roundf((float)noteSource->pos * scaleFactor);
+
+			// Make sure that with dividing and rounding, we're not overlapping the previous note - or past the end of the screen / Clip
+			if (newPos < minPos || newPos >= maxPos) {
+				continue;
+			}
+
+			int32_t newLength = roundf((float)noteSource->length * scaleFactor);
+			newLength = std::max(newLength, (int32_t)1);
+			newLength = std::min(newLength, maxPos - newPos);
 
-		noteDest->length = newLength;
-		noteDest->velocity = noteSource->velocity;
-		noteDest->probability = noteSource->probability;
-		noteDest->lift = noteSource->lift;
+			minPos = newPos + newLength;
 
-		minPos = newPos + newLength;
+			if (pass == 0) {
+				if (!numToPaste) {
+					firstPos = newPos;
+				}
+				lastPos = newPos;
+				numToPaste++;
+				continue;
+			}
+
+			Note* noteDest;
+			if (noteDestI == -1) {
+				noteDest = notes.getElement(notes.insertAtKey(newPos));
+				if (!noteDest) {
+					return false;
+				}
+			}
+			else {
+				noteDest = notes.getElement(noteDestI++);
+				noteDest->pos = newPos;
+			}
+
+			noteDest->length = newLength;
+			noteDest->velocity = noteSource->velocity;
+			noteDest->probability = noteSource->probability;
+			noteDest->lift = noteSource->lift;
+		}
 	}
 	return true;
 }
@@ -3568,6 +3693,9 @@ void NoteRow::giveMidiCommandsToDrum() {
 	if (midiInput.containsSomething()) {
 		if (!drum->midiInput.containsSomething()) {
 			drum->midiInput = midiInput;
+			if (currentSong) { // Could be NULL, if we're loading the first Song
+				currentSong->midiInputRoutingChanged();
+			}
 		}
 		midiInput.clear();
 	}
@@ -3580,6 +3708,9 @@ void NoteRow::grabMidiCommandsFromDrum() {
 
 		midiInput = drum->midiInput;
 		drum->midiInput.clear();
+		if (currentSong) {
+			currentSong->midiInputRoutingChanged();
+		}
 	}
 }
 
@@ -72,6 +72,7 @@ public:
 	void renderRow(TimelineView* editorScreen, uint8_t[], uint8_t[], uint8_t[], uint8_t* image, uint8_t[], bool,
 	               uint32_t, bool allowNoteTails, int32_t imageWidth, int32_t xScroll, uint32_t xZoom,
 	               int32_t xStart = 0, int32_t xEnd = kDisplayWidth, bool drawRepeats = false);
+	uint32_t getRenderChecksum(int32_t startPos, int32_t endPos);
 	void deleteNoteByPos(ModelStackWithNoteRow* modelStack, int32_t pos, Action* action);
 	void stopCurrentlyPlayingNote(ModelStackWithNoteRow* modelStack, bool actuallySoundChange = true,
 	                              Note* note = NULL);
@@ -123,6 +124,21 @@ public:
 
 	bool
 	    skipNextNote; // To be used if we recorded a note which was quantized forwards, and we have to remember not to play it
+
+	// Where processCurrentPos() last found the next note event to be, so that calls before it's due can return straight
+	// away without searching the notes. Only trusted if playback has moved on by exactly the ticks we were told since,
+	// nothing about this NoteRow's state has changed, and the Clip hasn't had expectEvent() called - which every edit to
+	// a playing Clip does
+	bool nextNoteEventCursorValid;
+	bool nextNoteEventCursorReversed;
+	uint8_t nextNoteEventCursorSoundingStatus;
+	int32_t nextNoteEventCursorPos;
+	int32_t nextNoteEventCursorTicksTil;
+	uint32_t nextNoteEventCursorGeneration;
+
+	// In terms of the parent InstrumentClip's noteRowTickCount
+	int32_t lastProcessedNoteRowTick;
+	int32_t nextEventNoteRowTick;
 	int32_t getDefaultProbability(ModelStackWithNoteRow* ModelStack);
 	int32_t attemptNoteAdd(int32_t pos, int32_t length, int32_t velocity, int32_t probability,
 	                       ModelStackWithNoteRow* modelStack, Action* action);
@@ -176,6 +192,7 @@ public:
 	                                     int32_t whichExpressionDimension, bool forDrum);
 	void setSequenceDirectionMode(ModelStackWithNoteRow* modelStack, SequenceDirection newMode);
 	bool isAuditioning(ModelStackWithNoteRow* modelStack);
+	void prepareForUpcomingNote(ModelStackWithNoteRow* modelStack, int32_t ticksTil);
 
 private:
 	void noteOn();
@@ -28,6 +28,7 @@
 #include "playback/playback_handler.h"
 #include "processing/engines/audio_engine.h"
 #include "storage/storage_manager.h"
+#include <algorithm>
 #include <new>
 
 Output::Output(InstrumentType newType) : type(newType) {
@@ -209,6 +210,9 @@ bool Output::writeDataToFile(Clip* clipForSavingOutputOnly, Song* song) {
 		storageManager.writeAttribute("isArmedForRecording", armedForRecording);
 		storageManager.writeAttribute("activeModFunction", modKnobMode);
 		storageManager.writeAttribute("colour", colour);
+		if (groupBus) {
+			storageManager.writeAttribute("groupBus", groupBus);
+		}
 
 		if (clipInstances.getNumElements()) {
 			storageManager.write("\n");
@@ -286,6 +290,10 @@ bool Output::readTagFromFile(char const* tagName) {
 		colour = storageManager.readTagOrAttributeValueInt();
 	}
 
+	else if (!strcmp(tagName, "groupBus")) {
+		groupBus = std::clamp<int32_t>(storageManager.readTagOrAttributeValueInt(), 0, kNumGroupBuses);
+	}
+
 	else if (!strcmp(tagName, "trackInstances") || !strcmp(tagName, "clipInstances")) {
 
 		char buffer[9];
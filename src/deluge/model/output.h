@@ -57,6 +57,11 @@ public:
 	bool wasCreatedForAutoOverdub;
 	bool armedForRecording;
 	int16_t colour{0};
+	uint8_t groupBus{0}; // Which GroupBus we're rendered into, from 1. 0 means straight into the Song's own
+
+	uint64_t renderCycles{0}; // Spent in renderOutput() since PerformanceReport last cleared it
+	uint32_t renderCyclesSinceLoadSample{0};
+	int16_t renderLoadPermille{0}; // Smoothed share of the render time there was - see Song::updateOutputRenderLoads()
 
 	uint8_t modKnobMode;
 
@@ -24,14 +24,18 @@
 #include "io/debug/print.h"
 #include "memory/general_memory_allocator.h"
 #include "model/sample/sample_cache.h"
+#include "model/sample/sample_peak_pyramid.h"
 #include "model/sample/sample_perc_cache_zone.h"
 #include "processing/engines/audio_engine.h"
 #include "storage/audio/audio_file_manager.h"
 #include "storage/cluster/cluster.h"
+#include "storage/folder_index.h"
 #include "storage/multi_range/multisample_range.h"
 #include "storage/storage_manager.h"
 #include "util/functions.h"
+#include "util/functions_quad.h"
 #include "util/lookuptables/lookuptables.h"
+#include "util/sample_codec.h"
 #include <cstdint>
 #include <math.h>
 #include <new>
@@ -70,6 +74,7 @@ Sample::Sample()
 	audioDataStartPosBytes = 0;
 	lengthInSamples = 0;
 	rawDataFormat = RAW_DATA_FINE;
+	rawDataLShift = 0;
 	midiNote = MIDI_NOTE_UNSET;
 	partOfFolderBeingLoaded = false;
 
@@ -82,6 +87,19 @@ Sample::Sample()
 	percCacheClusters[0] = NULL;
 	percCacheClusters[1] = NULL;
 
+	percCacheAnalysisRequested = false;
+
+	peakPyramid = NULL;
+	peakPyramidRequested = false;
+
+	loadedFromTranscode = false;
+	transcodeRequested = false;
+	compressedBlocks = NULL;
+
+	contentFileSize = 0;
+	contentLastClusterCRCKnown = false;
+	inContentIndex = false;
+
 	fileLoopStartSamples = 0;
 	fileLoopEndSamples = 0;
 	midiNoteFromFile = -1;
@@ -104,12 +122,38 @@ int32_t Sample::initialize(int32_t newNumClusters) {
 }
 
 Sample::~Sample() {
+	audioFileManager.cancelPrefetches(this);
+
 	for (int32_t c = 0; c < clusters.getNumElements(); c++) {
 		clusters.getElement(c)->~SampleCluster();
 	}
 
 	deletePercCache(true);
 
+	if (percCacheAnalysisRequested) {
+		audioFileManager.cancelPercCacheAnalysis(this);
+	}
+
+	if (peakPyramid) {
+		peakPyramid->~SamplePeakPyramid();
+		delugeDealloc(peakPyramid);
+	}
+	else if (peakPyramidRequested) {
+		audioFileManager.cancelPeakPyramidBuild(this);
+	}
+
+	if (transcodeRequested) {
+		audioFileManager.cancelTranscode(this);
+	}
+
+	if (compressedBlocks) {
+		delugeDealloc(compressedBlocks);
+	}
+
+	if (inContentIndex) {
+		audioFileManager.removeSampleFromContentIndex(this);
+	}
+
 	for (int32_t i = 0; i < caches.getNumElements(); i++) {
 		SampleCacheElement* element = (SampleCacheElement*)caches.getElementAddress(i);
 		element->cache->~SampleCache();
@@ -197,6 +241,17 @@ SampleCache* Sample::getOrCreateCache(SampleHolder* sampleHolder, int32_t phaseI
 		return element->cache;
 	}
 
+	// Or one made at near enough the same rates will do just as well - which, while the tempo's ramping, saves making
+	// a new one for every note
+	for (int32_t j = 0; j < caches.getNumElements(); j++) {
+		SampleCache* cache = ((SampleCacheElement*)caches.getElementAddress(j))->cache;
+		if (cache->skipSamplesAtStart == skipSamplesAtStart && cache->reversed == reversed
+		    && cache->ratesWithin(phaseIncrement, timeStretchRatio, kSampleCacheRateToleranceMagnitude)) {
+			*created = false;
+			return cache;
+		}
+	}
+
 	// Or if still here, it didn't already exist.
 	if (!mayCreate) {
 		return NULL;
@@ -235,7 +290,8 @@ SampleCache* Sample::getOrCreateCache(SampleHolder* sampleHolder, int32_t phaseI
 	}
 
 	SampleCache* samplePitchAdjustment = new (memory)
-	    SampleCache(this, numClusters, lengthInBytesCached, phaseIncrement, timeStretchRatio, skipSamplesAtStart);
+	    SampleCache(this, numClusters, lengthInBytesCached, phaseIncrement, timeStretchRatio, skipSamplesAtStart,
+	                reversed);
 
 	SampleCacheElement* element = (SampleCacheElement*)caches.getElementAddress(i);
 	element->phaseIncrement = phaseIncrement;
@@ -290,6 +346,11 @@ int32_t Sample::fillPercCache(TimeStretcher* timeStretcher, int32_t startPosSamp
 		}
 	}
 
+	// The first time it's needed forwards, ask for the whole thing to be worked out (or loaded) in the background
+	if (!reversed && !percCacheAnalysisRequested) {
+		percCacheAnalysisRequested = audioFileManager.requestPercCacheAnalysis(this);
+	}
+
 	LOCK_ENTRY
 
 	AudioEngine::logAction("fillPercCache");
@@ -715,6 +776,740 @@ getOut:
 	return error; // Usually it'll be NO_ERROR.
 }
 
+// Perc cache files are sidecar files (see AudioFile::getSidecarFilePath()) ending ".perc", their data being the
+// forwards perc cache
+constexpr uint32_t kPercCacheFileMagic = 0x43525044; // "DPRC"
+constexpr uint16_t kPercCacheFileVersion = 1;
+
+int32_t Sample::getPercCacheSize() {
+	// One byte for each kPercBufferReductionSize samples, and we can't allocate less than 1 byte
+	return std::max<int32_t>(((lengthInSamples - 1) >> kPercBufferReductionMagnitude) + 1, 1);
+}
+
+// Works out the forwards perc cache for the whole Sample in one go - or loads it from the card if that's been done
+// before - so time-stretching doesn't have to fill it bit by bit during playback. Only for Samples short enough for
+// their perc cache to live in percCacheMemory: longer ones use stealable perc cache Clusters, which would have to be
+// filled lazily again as soon as they got stolen. Must be called from the main loop, not the audio routine, as it reads
+// the whole Sample. Returns error
+int32_t Sample::analysePercCache() {
+	if (unloadable || !lengthInSamples || !tempFilePathForRecording.isEmpty()) {
+		return NO_ERROR;
+	}
+
+	int32_t cacheSize = getPercCacheSize();
+	if (cacheSize >= (audioFileManager.clusterSize >> 1)) {
+		return NO_ERROR; // It'll be done with perc cache Clusters
+	}
+
+	uint8_t* cache = (uint8_t*)GeneralMemoryAllocator::get().alloc(cacheSize);
+	if (!cache) {
+		return ERROR_INSUFFICIENT_RAM;
+	}
+
+	String percCacheFilePath;
+	int32_t error = getSidecarFilePath(&percCacheFilePath, ".perc");
+	if (error) {
+		goto getOut;
+	}
+
+	// The audio routine keeps running while we read, and mustn't be able to throw us away
+	addReason();
+
+	if (!readSidecarFile(percCacheFilePath.get(), kPercCacheFileMagic, kPercCacheFileVersion, cache, cacheSize)) {
+		error = computePercCache(cache);
+		if (!error) {
+			writeSidecarFile(percCacheFilePath.get(), kPercCacheFileMagic, kPercCacheFileVersion, cache, cacheSize);
+		}
+	}
+
+	removeReason("E453");
+
+	if (error) {
+		goto getOut;
+	}
+
+	// Swap it in for anything the audio routine filled in meanwhile. No audio rendering can happen during this bit
+	if (percCacheMemory[0]) {
+		delugeDealloc(percCacheMemory[0]);
+	}
+	percCacheMemory[0] = cache;
+	percCacheZones[0].empty();
+
+	error = percCacheZones[0].insertAtIndex(0);
+	if (error) {
+		return error; // Fine - it'll just get filled lazily again, into our new memory
+	}
+
+	{
+		SamplePercCacheZone* percCacheZone = new (percCacheZones[0].getElementAddress(0)) SamplePercCacheZone(0);
+		percCacheZone->endPos = lengthInSamples;
+	}
+	return NO_ERROR;
+
+getOut:
+	delugeDealloc(cache);
+	return error;
+}
+
+// Does the same sums as fillPercCache(), but from the very start of the Sample right through to its end
+int32_t Sample::computePercCache(uint8_t* cache) {
+	int32_t bytesPerSample = numChannels * byteDepth;
+	uint32_t bytePos = audioDataStartPosBytes;
+	int32_t clusterIndex = -1;
+	Cluster* cluster = NULL;
+
+	int32_t lastSampleRead = 0;
+	int32_t lastAngle = 0;
+	int32_t angleLPFMem[kDifferenceLPFPoles] = {0};
+
+	for (uint32_t pos = 0; pos < lengthInSamples; pos++) {
+
+		int32_t clusterIndexHere = bytePos >> audioFileManager.clusterSizeMagnitude;
+		if (clusterIndexHere != clusterIndex) {
+			if (cluster) {
+				audioFileManager.removeReasonFromCluster(cluster, "E454");
+			}
+			uint8_t error = NO_ERROR;
+			cluster = clusters.getElement(clusterIndexHere)
+			              ->getCluster(this, clusterIndexHere, CLUSTER_LOAD_IMMEDIATELY, 0xFFFFFFFF, &error);
+			if (!cluster) {
+				return error ? error : ERROR_UNSPECIFIED;
+			}
+			clusterIndex = clusterIndexHere;
+		}
+
+		if (!(pos & 255)) {
+			AudioEngine::routineWithClusterLoading(); // -----------------------------------
+		}
+
+		char* currentPos = &cluster->data[bytePos & (audioFileManager.clusterSize - 1)] - 4 + byteDepth;
+		int32_t thisSampleRead = *(int32_t*)currentPos >> 2;
+		if (numChannels == 2) {
+			thisSampleRead += *(int32_t*)(currentPos + byteDepth) >> 2;
+		}
+		bytePos += bytesPerSample;
+
+		int32_t angle = thisSampleRead - lastSampleRead;
+		lastSampleRead = thisSampleRead;
+		if (angle < 0) {
+			angle = -angle;
+		}
+
+		for (auto& pole : angleLPFMem) {
+			int32_t distanceToGo = angle - pole;
+			pole += distanceToGo >> 9;
+			angle = pole;
+		}
+
+		// Each perc cache value is taken halfway through its kPercBufferReductionSize samples, as fillPercCache() does
+		uint32_t posAfter = pos + 1;
+		if ((posAfter & (kPercBufferReductionSize - 1)) == (kPercBufferReductionSize >> 1)) {
+			int32_t difference = angle - lastAngle;
+			if (difference < 0) {
+				difference = -difference;
+			}
+
+			int32_t percussiveness = ((uint64_t)difference * 262144 / angle) >> 1;
+			cache[posAfter >> kPercBufferReductionMagnitude] = getTanH<23>(percussiveness);
+		}
+
+		lastAngle = angle;
+	}
+
+	if (cluster) {
+		audioFileManager.removeReasonFromCluster(cluster, "E454");
+	}
+
+	// Any value the loop above didn't reach (only ever the last, for a short tail) copies the one before
+	int32_t cacheSize = getPercCacheSize();
+	int32_t numValuesDone = (lengthInSamples + (kPercBufferReductionSize >> 1)) >> kPercBufferReductionMagnitude;
+	for (int32_t i = numValuesDone; i < cacheSize; i++) {
+		cache[i] = i ? cache[i - 1] : 0;
+	}
+
+	return NO_ERROR;
+}
+
+// Peak pyramid files are sidecar files too, named as for perc caches but ending ".peaks", their data being the levels
+// in order, as in memory
+constexpr uint32_t kPeakPyramidFileMagic = 0x4b415044; // "DPAK"
+constexpr uint16_t kPeakPyramidFileVersion = 1;
+
+// Works out the min and max of the whole Sample at each of the peak pyramid's granularities - or loads them from the
+// card if that's been done before - so WaveformRenderer needn't read through it all each time it's drawn zoomed out.
+// Like analysePercCache(), must be called from the main loop, as it reads the whole Sample. Unlike there, a Sample
+// recorded this session is fine once its recording is finished - it just doesn't get a file, as it might not have its
+// final name yet. Returns error
+int32_t Sample::buildPeakPyramid() {
+	if (peakPyramid || unloadable || !lengthInSamples) {
+		return NO_ERROR;
+	}
+
+	int32_t dataSize = SamplePeakPyramid::getDataSize(lengthInSamples);
+
+	// Stealable, but it doesn't go in a queue to be stolen till it's filled in
+	void* memory = GeneralMemoryAllocator::get().alloc(dataSize + sizeof(SamplePeakPyramid), NULL, false, false, true);
+	if (!memory) {
+		peakPyramidRequested = false;
+		return ERROR_INSUFFICIENT_RAM;
+	}
+
+	SamplePeakPyramid* newPeakPyramid = new (memory) SamplePeakPyramid(this);
+	uint8_t* peaks = (uint8_t*)newPeakPyramid->getLevel(0);
+
+	String peakPyramidFilePath;
+	bool useFile = tempFilePathForRecording.isEmpty();
+	int32_t error = NO_ERROR;
+	if (useFile) {
+		error = getSidecarFilePath(&peakPyramidFilePath, ".peaks");
+		if (error) {
+			goto getOut;
+		}
+	}
+
+	// The audio routine keeps running while we read, and mustn't be able to throw us away
+	addReason();
+
+	if (!useFile
+	    || !readSidecarFile(peakPyramidFilePath.get(), kPeakPyramidFileMagic, kPeakPyramidFileVersion, peaks,
+	                        dataSize)) {
+		error = computePeakPyramid((int8_t*)peaks);
+		if (!error && useFile) {
+			writeSidecarFile(peakPyramidFilePath.get(), kPeakPyramidFileMagic, kPeakPyramidFileVersion, peaks,
+			                 dataSize);
+		}
+	}
+
+	removeReason("E457");
+
+	if (error) {
+		goto getOut;
+	}
+
+	peakPyramid = newPeakPyramid;
+	GeneralMemoryAllocator::get().putStealableInAppropriateQueue(peakPyramid);
+	return NO_ERROR;
+
+getOut:
+	newPeakPyramid->~SamplePeakPyramid();
+	delugeDealloc(memory);
+	peakPyramidRequested = false;
+	return error;
+}
+
+// Our caller deallocates it
+void Sample::peakPyramidStolen() {
+	peakPyramid = NULL;
+	peakPyramidRequested = false;
+}
+
+// Does the finest level straight from the audio - reading both channels, as WaveformRenderer::findPeaksPerCol()
+// does - then each coarser one from the one before
+int32_t Sample::computePeakPyramid(int8_t* peaks) {
+	int32_t bytesPerSample = numChannels * byteDepth;
+	uint32_t bytePos = audioDataStartPosBytes;
+	int32_t clusterIndex = -1;
+	Cluster* cluster = NULL;
+
+	int32_t magnitude = kPeakPyramidLevelMagnitudes[0];
+	int32_t minHere = 2147483647;
+	int32_t maxHere = -2147483648;
+
+	for (uint32_t pos = 0; pos < lengthInSamples; pos++) {
+
+		int32_t clusterIndexHere = bytePos >> audioFileManager.clusterSizeMagnitude;
+		if (clusterIndexHere != clusterIndex) {
+			if (cluster) {
+				audioFileManager.removeReasonFromCluster(cluster, "E458");
+			}
+			uint8_t error = NO_ERROR;
+			cluster = clusters.getElement(clusterIndexHere)
+			              ->getCluster(this, clusterIndexHere, CLUSTER_LOAD_IMMEDIATELY, 0xFFFFFFFF, &error);
+			if (!cluster) {
+				return error ? error : ERROR_UNSPECIFIED;
+			}
+			clusterIndex = clusterIndexHere;
+		}
+
+		if (!(pos & 255)) {
+			AudioEngine::routineWithClusterLoading(); // -----------------------------------
+		}
+
+		char* currentPos = &cluster->data[bytePos & (audioFileManager.clusterSize - 1)] - 4 + byteDepth;
+		for (int32_t c = 0; c < numChannels; c++) {
+			int32_t value = *(int32_t*)(currentPos + c * byteDepth);
+			minHere = std::min(minHere, value);
+			maxHere = std::max(maxHere, value);
+		}
+		bytePos += bytesPerSample;
+
+		uint32_t posAfter = pos + 1;
+		if (!(posAfter & ((1 << magnitude) - 1)) || posAfter == lengthInSamples) {
+			int32_t entry = pos >> magnitude;
+
+			// Make rounding be towards 0, as for SampleCluster::minValue and maxValue
+			int8_t smallMin = minHere >> 24;
+			int8_t smallMax = maxHere >> 24;
+			if (smallMin < 0) {
+				smallMin++;
+			}
+			if (smallMax < 0) {
+				smallMax++;
+			}
+			peaks[entry << 1] = smallMin;
+			peaks[(entry << 1) + 1] = smallMax;
+
+			minHere = 2147483647;
+			maxHere = -2147483648;
+		}
+	}
+
+	if (cluster) {
+		audioFileManager.removeReasonFromCluster(cluster, "E458");
+	}
+
+	int8_t* finerLevel = peaks;
+	for (int32_t l = 1; l < kNumPeakPyramidLevels; l++) {
+		int32_t numFinerEntries = SamplePeakPyramid::getNumEntries(lengthInSamples, l - 1);
+		int32_t numEntries = SamplePeakPyramid::getNumEntries(lengthInSamples, l);
+		int32_t finerPerEntryMagnitude = kPeakPyramidLevelMagnitudes[l] - kPeakPyramidLevelMagnitudes[l - 1];
+		int8_t* level = finerLevel + (numFinerEntries << 1);
+
+		for (int32_t e = 0; e < numEntries; e++) {
+			int32_t finerStart = e << finerPerEntryMagnitude;
+			int32_t finerEnd = std::min(finerStart + (1 << finerPerEntryMagnitude), numFinerEntries);
+			int8_t minEntry = 127;
+			int8_t maxEntry = -128;
+			for (int32_t f = finerStart; f < finerEnd; f++) {
+				minEntry = std::min(minEntry, finerLevel[f << 1]);
+				maxEntry = std::max(maxEntry, finerLevel[(f << 1) + 1]);
+			}
+			level[e << 1] = minEntry;
+			level[(e << 1) + 1] = maxEntry;
+		}
+
+		finerLevel = level;
+	}
+
+	return NO_ERROR;
+}
+
+// Writes a native copy of this Sample's file - little-endian PCM, with floats as 32-bit ints and 8-bit widened to 16-bit
+// as WAV has no signed 8-bit - for AudioFileManager to load in its place from then on, so no conversion's needed as
+// each Cluster loads. Only what the Deluge reads from the file is kept: the format, loop points, MIDI note and any
+// wavetable cycle size. Like buildPeakPyramid(), must be called from the main loop, as it reads the whole file. Returns
+// error
+int32_t Sample::writeTranscode() {
+	if (audioFileManager.isCompressionEnabled() && mayBeCompressed()) {
+		return writeCompressedTranscode();
+	}
+
+	if (!rawDataFormat || unloadable || !lengthInSamples) {
+		return NO_ERROR;
+	}
+
+	char transcodeFilePath[kTranscodeFilePathMaxLength];
+	if (!audioFileManager.getTranscodeFilePath(filePath.get(), transcodeFilePath)) {
+		return ERROR_FILE_NOT_FOUND;
+	}
+
+	// Written under a temporary name, so a half-written one can never be found and loaded
+	char tempFilePath[kTranscodeFilePathMaxLength];
+	strcpy(tempFilePath, transcodeFilePath);
+	strcpy(&tempFilePath[strlen(tempFilePath) - 3], "TMP");
+
+	bool widening = (rawDataFormat == RAW_DATA_UNSIGNED_8);
+	int32_t newByteDepth = widening ? 2 : byteDepth;
+	uint32_t newDataLength = audioDataLengthBytes * (widening ? 2 : 1);
+	bool writeSampleChunk = fileLoopEndSamples || midiNoteFromFile >= 0;
+	bool writeWaveTableChunk = fileExplicitlySpecifiesSelfAsWaveTable && waveTableCycleSize < 10000;
+
+	FIL source;
+	FRESULT result = f_open(&source, filePath.get(), FA_READ);
+	if (result != FR_OK) {
+		return ERROR_FILE_UNREADABLE;
+	}
+	result = f_lseek(&source, audioDataStartPosBytes);
+	if (result != FR_OK) {
+		f_close(&source);
+		return ERROR_FILE_UNREADABLE;
+	}
+
+	FIL file;
+	result = f_open(&file, tempFilePath, FA_CREATE_ALWAYS | FA_WRITE);
+	if (result == FR_NO_PATH) {
+		f_mkdir(kTranscodeFolder);
+		result = f_open(&file, tempFilePath, FA_CREATE_ALWAYS | FA_WRITE);
+	}
+	if (result != FR_OK) {
+		f_close(&source);
+		return ERROR_SD_CARD;
+	}
+
+	// The audio routine keeps running while we read and write, and mustn't be able to throw us away
+	addReason();
+
+	int32_t error = NO_ERROR;
+	char* buffer = storageManager.fileClusterBuffer;
+	uint8_t* pos = (uint8_t*)buffer;
+	UINT bytesWritten;
+	UINT headerSize;
+
+	auto put16 = [&](uint16_t value) {
+		memcpy(pos, &value, 2);
+		pos += 2;
+	};
+	auto put32 = [&](uint32_t value) {
+		memcpy(pos, &value, 4);
+		pos += 4;
+	};
+
+	uint32_t riffLength = 4 + 8 + 16 + 8 + newDataLength + (newDataLength & 1);
+	if (writeSampleChunk) {
+		riffLength += 8 + 60;
+	}
+	if (writeWaveTableChunk) {
+		riffLength += 8 + 8;
+	}
+
+	put32(charsToIntegerConstant('R', 'I', 'F', 'F'));
+	put32(riffLength);
+	put32(charsToIntegerConstant('W', 'A', 'V', 'E'));
+
+	put32(charsToIntegerConstant('f', 'm', 't', ' '));
+	put32(16);
+	put16(WAV_FORMAT_PCM);
+	put16(numChannels);
+	put32(sampleRate);
+	put32(sampleRate * numChannels * newByteDepth);
+	put16(numChannels * newByteDepth);
+	put16(newByteDepth * 8);
+
+	if (writeSampleChunk) {
+		int32_t note = 0;
+		uint32_t noteFraction = 0;
+		if (midiNoteFromFile >= 0) {
+			note = (int32_t)midiNoteFromFile;
+			noteFraction = (uint32_t)((midiNoteFromFile - note) * 4294967296.0);
+		}
+		put32(charsToIntegerConstant('s', 'm', 'p', 'l'));
+		put32(60);
+		put32(0);                       // Manufacturer
+		put32(0);                       // Product
+		put32(1000000000 / sampleRate); // Sample period in nanoseconds
+		put32(note);
+		put32(noteFraction);
+		put32(0); // SMPTE format
+		put32(0); // SMPTE offset
+		put32(fileLoopEndSamples ? 1 : 0);
+		put32(0); // Sampler data
+		put32(0); // Loop ID
+		put32(0); // Loop type
+		put32(fileLoopStartSamples);
+		put32(fileLoopEndSamples);
+		put32(0); // Fraction
+		put32(0); // Play count
+	}
+
+	// Serum's "clm " chunk, with the cycle size as four digits
+	if (writeWaveTableChunk) {
+		put32(charsToIntegerConstant('c', 'l', 'm', ' '));
+		put32(7);
+		memcpy(pos, "<!>", 3);
+		intToString(waveTableCycleSize, (char*)pos + 3, 4);
+		pos += 8;
+	}
+
+	put32(charsToIntegerConstant('d', 'a', 't', 'a'));
+	put32(newDataLength);
+
+	headerSize = pos - (uint8_t*)buffer;
+	result = f_write(&file, buffer, headerSize, &bytesWritten);
+	if (result != FR_OK || bytesWritten != headerSize) {
+		error = ERROR_WRITE_FAIL;
+		goto getOut;
+	}
+
+	{
+		// Half a Cluster at a time, leaving room to widen 8-bit in place
+		int32_t bytesPerSample = byteDepth * numChannels;
+		UINT bytesPerChunk = (audioFileManager.clusterSize >> 1) / bytesPerSample * bytesPerSample;
+
+		for (uint64_t bytesDone = 0; bytesDone < audioDataLengthBytes;) {
+			UINT bytesNow = std::min<uint64_t>(audioDataLengthBytes - bytesDone, bytesPerChunk);
+			UINT bytesRead;
+			result = f_read(&source, buffer, bytesNow, &bytesRead);
+			if (result != FR_OK || bytesRead != bytesNow) {
+				error = ERROR_FILE_UNREADABLE;
+				goto getOut;
+			}
+			bytesDone += bytesNow;
+
+			if (rawDataIs24Bit()) {
+				convert24BitData((uint8_t*)buffer, (uint8_t*)buffer + bytesNow);
+			}
+			else {
+				convertData((int32_t*)buffer, (bytesNow + 3) >> 2);
+			}
+
+			// Working backwards, each byte becomes the top of a 16-bit value without treading on one still to do
+			if (widening) {
+				for (int32_t i = bytesNow - 1; i >= 0; i--) {
+					buffer[(i << 1) + 1] = buffer[i];
+					buffer[i << 1] = 0;
+				}
+				bytesNow <<= 1;
+			}
+
+			// RIFF chunks are padded to an even length
+			if (bytesDone >= audioDataLengthBytes && (newDataLength & 1)) {
+				buffer[bytesNow++] = 0;
+			}
+
+			result = f_write(&file, buffer, bytesNow, &bytesWritten);
+			if (result != FR_OK || bytesWritten != bytesNow) {
+				error = ERROR_WRITE_FAIL;
+				goto getOut;
+			}
+
+			AudioEngine::routineWithClusterLoading(); // -----------------------------------
+		}
+	}
+
+getOut:
+	f_close(&source);
+	if (f_close(&file) != FR_OK && !error) {
+		error = ERROR_WRITE_FAIL;
+	}
+
+	if (!error) {
+		f_unlink(transcodeFilePath); // In case there's somehow one there already
+		if (f_rename(tempFilePath, transcodeFilePath) != FR_OK) {
+			error = ERROR_SD_CARD;
+		}
+	}
+	if (error) {
+		f_unlink(tempFilePath);
+	}
+	FolderIndex::folderChanged(transcodeFilePath);
+
+	removeReason("E460");
+	return error;
+}
+
+// Whether writeCompressedTranscode() can do anything with this. Floats, and 8 or 32-bit ints, are left to
+// writeTranscode(), as ever
+bool Sample::mayBeCompressed() {
+	if (compressedBlocks || unloadable || !lengthInSamples || audioDataLengthBytes == 0x8FFFFFFFFFFFFFFF) {
+		return false;
+	}
+	if (byteDepth == 2) {
+		return (rawDataFormat == RAW_DATA_FINE || rawDataFormat == RAW_DATA_ENDIANNESS_WRONG_16);
+	}
+	if (byteDepth == 3) {
+		return (rawDataFormat == RAW_DATA_FINE || rawDataFormat == RAW_DATA_ENDIANNESS_WRONG_24
+		        || rawDataFormat == RAW_DATA_LSHIFTED_24);
+	}
+	return false;
+}
+
+// The frames with any of their bytes in a Cluster - which is what that Cluster's block of a compressed transcode holds
+void Sample::getFramesTouchingCluster(int32_t clusterIndex, uint32_t* firstFrame, uint32_t* endFrame) {
+	uint32_t bytesPerFrame = byteDepth * numChannels;
+	uint32_t clusterStart = clusterIndex << audioFileManager.clusterSizeMagnitude;
+	uint32_t start = std::max(clusterStart, audioDataStartPosBytes) - audioDataStartPosBytes;
+	uint32_t end = std::min<uint64_t>(clusterStart + audioFileManager.clusterSize,
+	                                  audioDataStartPosBytes + audioDataLengthBytes)
+	               - audioDataStartPosBytes;
+	*firstFrame = start / bytesPerFrame;
+	*endFrame = (end + bytesPerFrame - 1) / bytesPerFrame;
+}
+
+// Writes a compressed copy of this Sample's file - see CompressedSampleHeader and util/sample_codec.h - for
+// AudioFileManager to load in its place from then on, so each Cluster takes around half the reading from the card, for
+// a little decoding. Big-endian data gets swapped round on the way, but our own recordings stay as they are on the card
+// and still get normalised as they load. Like writeTranscode(), must be called from the main loop. Returns error
+int32_t Sample::writeCompressedTranscode() {
+	char compressedFilePath[kTranscodeFilePathMaxLength];
+	if (!audioFileManager.getTranscodeFilePath(filePath.get(), compressedFilePath, true)) {
+		return ERROR_FILE_NOT_FOUND;
+	}
+
+	// If this was loaded from its native transcode, the audio data's where it is in that
+	char transcodeFilePath[kTranscodeFilePathMaxLength];
+	char const* sourceFilePath = filePath.get();
+	if (loadedFromTranscode) {
+		if (!audioFileManager.getTranscodeFilePath(filePath.get(), transcodeFilePath)) {
+			return ERROR_FILE_NOT_FOUND;
+		}
+		sourceFilePath = transcodeFilePath;
+	}
+
+	// Written under a temporary name, so a half-written one can never be found and loaded
+	char tempFilePath[kTranscodeFilePathMaxLength];
+	strcpy(tempFilePath, compressedFilePath);
+	strcpy(&tempFilePath[strlen(tempFilePath) - 3], "TMP");
+
+	uint32_t clusterSize = audioFileManager.clusterSize;
+	int32_t bytesPerFrame = byteDepth * numChannels;
+	int32_t numBlocks = ((audioDataStartPosBytes + audioDataLengthBytes - 1) >> audioFileManager.clusterSizeMagnitude) + 1;
+	uint32_t tableSize = (numBlocks + 1) * sizeof(uint32_t);
+	uint32_t headerNumSectors = ((sizeof(CompressedSampleHeader) + tableSize - 1) >> 9) + 1;
+
+	// One Cluster's worth of frames, plus the partial ones at either end. Then a block, then the table
+	uint32_t pcmBufferSize = (clusterSize + bytesPerFrame * 2 + 3) & ~(uint32_t)3;
+	uint8_t* memory = (uint8_t*)GeneralMemoryAllocator::get().alloc(pcmBufferSize + clusterSize + tableSize);
+	if (!memory) {
+		return ERROR_INSUFFICIENT_RAM;
+	}
+	uint8_t* pcm = memory;
+	uint8_t* block = memory + pcmBufferSize;
+	uint32_t* table = (uint32_t*)(block + clusterSize);
+
+	FIL source;
+	FRESULT result = f_open(&source, sourceFilePath, FA_READ);
+	if (result != FR_OK) {
+		delugeDealloc(memory);
+		return ERROR_FILE_UNREADABLE;
+	}
+
+	FIL file;
+	result = f_open(&file, tempFilePath, FA_CREATE_ALWAYS | FA_WRITE);
+	if (result == FR_NO_PATH) {
+		f_mkdir(kTranscodeFolder);
+		result = f_open(&file, tempFilePath, FA_CREATE_ALWAYS | FA_WRITE);
+	}
+	if (result != FR_OK) {
+		f_close(&source);
+		delugeDealloc(memory);
+		return ERROR_SD_CARD;
+	}
+
+	// The audio routine keeps running while we read and write, and mustn't be able to throw us away
+	addReason();
+
+	int32_t error = NO_ERROR;
+	UINT bytesWritten;
+	uint32_t sector = headerNumSectors;
+
+	// The header goes first, with the table left empty til the end
+	CompressedSampleHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = kCompressedSampleMagic;
+	header.version = kCompressedSampleVersion;
+	header.numChannels = numChannels;
+	header.byteDepth = byteDepth;
+	header.sampleRate = sampleRate;
+	header.clusterSize = clusterSize;
+	header.audioDataStartPosBytes = audioDataStartPosBytes;
+	header.audioDataLengthBytes = audioDataLengthBytes;
+	header.fileLoopStartSamples = fileLoopStartSamples;
+	header.fileLoopEndSamples = fileLoopEndSamples;
+	header.midiNoteFromFile = midiNoteFromFile;
+	header.waveTableCycleSize = waveTableCycleSize;
+	header.fileExplicitlySpecifiesSelfAsWaveTable = fileExplicitlySpecifiesSelfAsWaveTable;
+	header.rawDataLShift = (rawDataFormat == RAW_DATA_LSHIFTED_24) ? rawDataLShift : 0;
+	header.numBlocks = numBlocks;
+
+	memset(block, 0, clusterSize);
+	memcpy(block, &header, sizeof(header));
+	for (uint32_t s = 0; s < headerNumSectors;) {
+		uint32_t numSectorsNow = std::min(headerNumSectors - s, clusterSize >> 9);
+		result = f_write(&file, block, numSectorsNow << 9, &bytesWritten);
+		if (result != FR_OK || bytesWritten != numSectorsNow << 9) {
+			error = ERROR_WRITE_FAIL;
+			goto getOut;
+		}
+		memset(block, 0, sizeof(header));
+		s += numSectorsNow;
+	}
+
+	for (int32_t b = 0; b < numBlocks; b++) {
+		uint32_t firstFrame, endFrame;
+		getFramesTouchingCluster(b, &firstFrame, &endFrame);
+		uint32_t pcmStart = audioDataStartPosBytes + firstFrame * bytesPerFrame;
+		UINT pcmBytes = (endFrame - firstFrame) * bytesPerFrame;
+
+		UINT bytesRead;
+		result = f_lseek(&source, pcmStart);
+		if (result == FR_OK) {
+			result = f_read(&source, pcm, pcmBytes, &bytesRead);
+		}
+		if (result != FR_OK || bytesRead != pcmBytes) {
+			error = ERROR_FILE_UNREADABLE;
+			goto getOut;
+		}
+
+		if (rawDataFormat == RAW_DATA_ENDIANNESS_WRONG_24) {
+			convert24BitData(pcm, pcm + pcmBytes);
+		}
+		else if (rawDataFormat == RAW_DATA_ENDIANNESS_WRONG_16) {
+			convertData((int32_t*)pcm, (pcmBytes + 3) >> 2);
+		}
+
+		// It's only worth it if it saves at least a sector
+		uint32_t clusterStart = b << audioFileManager.clusterSizeMagnitude;
+		uint32_t clusterEnd = std::min<uint64_t>(clusterStart + clusterSize, audioDataStartPosBytes + audioDataLengthBytes);
+		uint32_t verbatimNumSectors = ((clusterEnd - clusterStart - 1) >> 9) + 1;
+		uint32_t numBytes = encodeSampleBlock(pcm, endFrame - firstFrame, numChannels, byteDepth, block,
+		                                      (verbatimNumSectors - 1) << 9);
+		uint32_t numSectors;
+		if (numBytes) {
+			numSectors = ((numBytes - 1) >> 9) + 1;
+			memset(block + numBytes, 0, (numSectors << 9) - numBytes);
+			table[b] = sector;
+		}
+
+		// Or the Cluster's worth of PCM as it'll be in the Cluster, with nothing before the audio data starts
+		else {
+			numSectors = verbatimNumSectors;
+			memset(block, 0, numSectors << 9);
+			uint32_t copyStart = std::max(clusterStart, audioDataStartPosBytes);
+			memcpy(block + copyStart - clusterStart, pcm + copyStart - pcmStart, clusterEnd - copyStart);
+			table[b] = sector | kCompressedBlockVerbatim;
+		}
+
+		result = f_write(&file, block, numSectors << 9, &bytesWritten);
+		if (result != FR_OK || bytesWritten != numSectors << 9) {
+			error = ERROR_WRITE_FAIL;
+			goto getOut;
+		}
+		sector += numSectors;
+
+		AudioEngine::routineWithClusterLoading(); // -----------------------------------
+	}
+
+	table[numBlocks] = sector;
+	result = f_lseek(&file, sizeof(header));
+	if (result == FR_OK) {
+		result = f_write(&file, table, tableSize, &bytesWritten);
+	}
+	if (result != FR_OK || bytesWritten != tableSize) {
+		error = ERROR_WRITE_FAIL;
+	}
+
+getOut:
+	f_close(&source);
+	if (f_close(&file) != FR_OK && !error) {
+		error = ERROR_WRITE_FAIL;
+	}
+
+	if (!error) {
+		f_unlink(compressedFilePath); // In case there's somehow one there already
+		if (f_rename(tempFilePath, compressedFilePath) != FR_OK) {
+			error = ERROR_SD_CARD;
+		}
+	}
+	if (error) {
+		f_unlink(tempFilePath);
+	}
+	FolderIndex::folderChanged(compressedFilePath);
+
+	delugeDealloc(memory);
+	removeReason("E474");
+	return error;
+}
+
 bool Sample::getAveragesForCrossfade(int32_t* totals, int32_t startBytePos, int32_t crossfadeLengthSamples,
                                      int32_t playDirection, int32_t lengthToAverageEach) {
 
@@ -1021,9 +1816,9 @@ void Sample::workOutMIDINote(bool doingSingleCycle, float minFreqHz, float maxFr
 			midiNote = midiNoteFromFile;
 		}
 
-		// And finally, detect the pitch the hard way
+		// And finally, detect the pitch the hard way - or find out what it came to last time
 		else {
-			freq = determinePitch(doingSingleCycle, minFreqHz, maxFreqHz, doPrimeTest);
+			freq = loadOrDeterminePitch(minFreqHz, maxFreqHz, doPrimeTest);
 
 			if (freq == 0) { // Error
 				midiNote = MIDI_NOTE_ERROR;
@@ -1040,6 +1835,43 @@ calculateMIDINote:
 	//Debug::printlnfloat(midiNote);
 }
 
+// Pitch files are sidecar files too, ending ".pitch", holding determinePitch()'s result along with the arguments it
+// was given, since the sample browser asks with different ones depending on what the Sample's being used for
+constexpr uint32_t kPitchFileMagic = 0x54495044; // "DPIT"
+constexpr uint16_t kPitchFileVersion = 1;
+
+struct PitchFileData {
+	float minFreqHz;
+	float maxFreqHz;
+	uint32_t doPrimeTest;
+	float freq;
+};
+
+// Returns 0 if error
+float Sample::loadOrDeterminePitch(float minFreqHz, float maxFreqHz, bool doPrimeTest) {
+
+	// A Sample recorded this session might not have its final name yet
+	String pitchFilePath;
+	bool useFile = tempFilePathForRecording.isEmpty() && !getSidecarFilePath(&pitchFilePath, ".pitch");
+
+	PitchFileData data;
+	if (useFile && readSidecarFile(pitchFilePath.get(), kPitchFileMagic, kPitchFileVersion, (uint8_t*)&data,
+	                               sizeof(data))) {
+		if (data.minFreqHz == minFreqHz && data.maxFreqHz == maxFreqHz && data.doPrimeTest == doPrimeTest) {
+			return data.freq;
+		}
+	}
+
+	float freq = determinePitch(false, minFreqHz, maxFreqHz, doPrimeTest);
+
+	// Not if there was an error, which could just have been running out of RAM this time
+	if (useFile && freq != 0) {
+		data = {minFreqHz, maxFreqHz, doPrimeTest, freq};
+		writeSidecarFile(pitchFilePath.get(), kPitchFileMagic, kPitchFileVersion, (uint8_t const*)&data, sizeof(data));
+	}
+	return freq;
+}
+
 uint32_t Sample::getLengthInMSec() {
 	return (uint64_t)(lengthInSamples - 1) * 1000 / sampleRate + 1;
 }
@@ -1256,6 +2088,10 @@ examineHarmonic:
 constexpr int32_t kMinAccurateFrequency = (1638400 >> (kPitchDetectWindowSizeMagnitude));
 constexpr int32_t kMaxLengthDoublings = (16 - kPitchDetectWindowSizeMagnitude);
 
+// How far into the file to look for where the sound starts before giving up, so a long file that's quiet or silent at
+// the start can't have us read all the way through it, maybe twice
+constexpr int32_t kPitchDetectMaxSecondsToFindStart = 8;
+
 // We want a fairly small window. Any bigger, and it'll fail to find the tones in short, percussive yet tonal sounds.
 // Or if we were to go much smaller than this, we might incorrectly see low frequencies.
 // Already, this is too small to very accurately pick up low frequencies, so when one is detected, a second pass is done on downsampled (squished in) audio data, to pick it up more accurately
@@ -1323,6 +2159,8 @@ startAgain:
 
 	// Load the sample into memory
 	int32_t currentOffset = beginningOffsetForPitchDetection;
+	uint64_t startSearchEndOffset =
+	    currentOffset + (uint64_t)sampleRate * kPitchDetectMaxSecondsToFindStart * numChannels * byteDepth;
 	uint32_t currentClusterIndex = currentOffset >> audioFileManager.clusterSizeMagnitude;
 	int32_t writeIndex = 0;
 
@@ -1382,6 +2220,12 @@ continueWhileLoop:
 				goto doneReading;
 			}
 
+			// Or if we've looked far enough for the start of the sound. If there was some sound, we'll go again below
+			// with a threshold it does reach
+			if (!beginningOffsetForPitchDetectionFound && currentOffset >= startSearchEndOffset) {
+				goto doneReading;
+			}
+
 			uint32_t newClusterIndex = currentOffset >> audioFileManager.clusterSizeMagnitude;
 
 			// If passed Cluster end...
@@ -1696,6 +2540,118 @@ void Sample::convertDataOnAnyClustersIfNecessary() {
 	}
 }
 
+// Runs kernel over numQuads lots of four values from pos, which needn't be aligned, and returns where it got to
+template <typename Kernel>
+static uint8_t* convertQuads(uint8_t* pos, int32_t numQuads, Kernel kernel) {
+	for (int32_t i = 0; i < numQuads; i++) {
+		uint32x4_t values = vreinterpretq_u32_u8(vld1q_u8(pos));
+		vst1q_u8(pos, vreinterpretq_u8_u32(kernel(values)));
+		pos += 16;
+	}
+	return pos;
+}
+
+// convertOneData() on numValues consecutive values from pos - four at a time with NEON, and then the odd few one by one
+void Sample::convertData(int32_t* pos, int32_t numValues) {
+	uint8_t* bytes = (uint8_t*)pos;
+	int32_t numQuads = numValues >> 2;
+
+	switch (rawDataFormat) {
+	case RAW_DATA_FLOAT:
+		bytes = convertQuads(bytes, numQuads,
+		                     [](uint32x4_t values) { return vreinterpretq_u32_s32(convertFloatToInt_quad(values)); });
+		break;
+
+	case RAW_DATA_ENDIANNESS_WRONG_32:
+		bytes = convertQuads(bytes, numQuads, swapEndianness32_quad);
+		break;
+
+	case RAW_DATA_ENDIANNESS_WRONG_16:
+		bytes = convertQuads(bytes, numQuads, swapEndianness2x16_quad);
+		break;
+
+	case RAW_DATA_UNSIGNED_8:
+		bytes = convertQuads(bytes, numQuads,
+		                     [](uint32x4_t values) { return veorq_u32(values, vdupq_n_u32(0x80808080)); });
+		break;
+
+	default:
+		return;
+	}
+
+	for (int32_t i = 0; i < (numValues & 3); i++) {
+		convertOneData((int32_t*)bytes);
+		bytes += 4;
+	}
+}
+
+// convertOne24BitValue() on every value that starts before endPos, and returns where it got to
+uint8_t* Sample::convert24BitData(uint8_t* pos, uint8_t const* endPos) {
+	if (rawDataFormat == RAW_DATA_ENDIANNESS_WRONG_24) {
+		while (pos + 45 < endPos) {
+			swapEndianness24_x16(pos);
+			pos += 48;
+		}
+	}
+
+	while (pos < endPos) {
+		convertOne24BitValue(pos);
+		pos += 3;
+	}
+	return pos;
+}
+
+// For when rawDataFormat changes while there's still unconverted data in RAM - which is only ever our own recordings,
+// once finalizing them decides they need normalising. As if each loaded Cluster had only now been loaded, in order,
+// including the values that straddle the boundaries between neighbouring ones
+void Sample::convertLoadedClustersToNewFormat() {
+	if (!rawDataIs24Bit()) {
+		return;
+	}
+
+	int32_t startCluster = getFirstClusterIndexWithAudioData();
+	int32_t endCluster = getFirstClusterIndexWithNoAudioData();
+	int32_t clusterSize = audioFileManager.clusterSize;
+
+	for (int32_t c = startCluster; c < endCluster; c++) {
+		Cluster* cluster = clusters.getElement(c)->cluster;
+		if (cluster && cluster->loaded) {
+			audioFileManager.addReasonToCluster(cluster);
+			cluster->convertDataIfNecessary();
+			cluster->extraBytesAtStartConverted = false;
+			cluster->extraBytesAtEndConverted = false;
+		}
+	}
+
+	// Each neighbouring pair now has one value across the boundary that nothing's converted yet, which the later
+	// Cluster's first few bytes still hold unconverted
+	for (int32_t c = startCluster + 1; c < endCluster; c++) {
+		Cluster* prevCluster = clusters.getElement(c - 1)->cluster;
+		Cluster* cluster = clusters.getElement(c)->cluster;
+		if (!prevCluster || !prevCluster->loaded || !cluster || !cluster->loaded) {
+			continue;
+		}
+
+		memcpy(&prevCluster->data[clusterSize], cluster->data, 7);
+
+		int32_t bytesUnconvertedBeforeCluster = (c * clusterSize - audioDataStartPosBytes) % 3;
+		if (bytesUnconvertedBeforeCluster) {
+			convertOne24BitValue((uint8_t*)&prevCluster->data[clusterSize - bytesUnconvertedBeforeCluster]);
+			memcpy(cluster->data, &prevCluster->data[clusterSize], 2);
+		}
+
+		prevCluster->extraBytesAtEndConverted = true;
+		cluster->extraBytesAtStartConverted = true;
+	}
+
+	for (int32_t c = startCluster; c < endCluster; c++) {
+		Cluster* cluster = clusters.getElement(c)->cluster;
+		if (cluster && cluster->loaded) {
+			audioFileManager.removeReasonFromCluster(cluster, "E467");
+		}
+	}
+}
+
 int32_t Sample::getMaxPeakFromZero() {
 	// Comes out one >> of the value we actually want
 	int32_t halfValue = std::abs(getFoundValueCentrePoint() >> 1) + (maxValueFound >> 2) - (minValueFound >> 2);
@@ -1752,7 +2708,7 @@ void Sample::numReasonsDecreasedToZero(char const* errorCode) {
 
 			numClusterReasons += cluster->numReasonsToBeLoaded;
 
-			if (cluster == audioFileManager.clusterBeingLoaded) {
+			if (audioFileManager.isClusterBeingLoaded(cluster)) {
 				numClusterReasons--;
 			}
 		}
@@ -1767,7 +2723,7 @@ void Sample::numReasonsDecreasedToZero(char const* errorCode) {
 			if (cluster) {
 				Debug::print(cluster->numReasonsToBeLoaded);
 
-				if (cluster == audioFileManager.clusterBeingLoaded) {
+				if (audioFileManager.isClusterBeingLoaded(cluster)) {
 					Debug::println(" (loading)");
 				}
 				else if (!cluster->loaded) {
@@ -34,6 +34,7 @@
 #define RAW_DATA_ENDIANNESS_WRONG_16 3
 #define RAW_DATA_ENDIANNESS_WRONG_24 4
 #define RAW_DATA_ENDIANNESS_WRONG_32 5
+#define RAW_DATA_LSHIFTED_24 6 // Our own recordings, normalised by rawDataLShift as they load rather than on the card
 
 #define MIDI_NOTE_UNSET -999
 #define MIDI_NOTE_ERROR -1000
@@ -43,6 +44,17 @@ class SampleCache;
 class MultisampleRange;
 class TimeStretcher;
 class SampleHolder;
+class SamplePeakPyramid;
+
+// Where on the card one Cluster's block of a compressed transcode is. It can run off the end of one of the file's
+// clusters into the next, which could be anywhere
+struct CompressedBlock {
+	uint32_t sdAddress;
+	uint32_t sdAddressAfterBreak;
+	uint16_t numSectors;
+	uint16_t numSectorsBeforeBreak;
+	bool verbatim; // Just the PCM, as it wouldn't compress
+};
 
 class Sample final : public AudioFile {
 public:
@@ -64,6 +76,9 @@ public:
 	                      int32_t playDirection, int32_t maxNumSamplesToProcess);
 	void percCacheClusterStolen(Cluster* cluster);
 	void deletePercCache(bool beingDestructed = false);
+	int32_t analysePercCache();
+	int32_t buildPeakPyramid();
+	void peakPyramidStolen();
 	uint8_t* prepareToReadPercCache(int32_t pixellatedPos, int32_t playDirection, int32_t* earliestPixellatedPos,
 	                                int32_t* latestPixellatedPos);
 	bool getAveragesForCrossfade(int32_t* totals, int32_t startBytePos, int32_t crossfadeLengthSamples,
@@ -92,6 +107,33 @@ public:
 			*value ^= 0x80808080;
 		}
 	}
+	void convertData(int32_t* pos, int32_t numValues);
+
+	inline bool rawDataIs24Bit() {
+		return (rawDataFormat == RAW_DATA_ENDIANNESS_WRONG_24 || rawDataFormat == RAW_DATA_LSHIFTED_24);
+	}
+
+	// The 3-byte equivalent of convertOneData(), for the formats above
+	inline void convertOne24BitValue(uint8_t* pos) {
+		if (rawDataFormat == RAW_DATA_ENDIANNESS_WRONG_24) {
+			uint8_t temp = pos[0];
+			pos[0] = pos[2];
+			pos[2] = temp;
+		}
+		else {
+			int32_t value = ((uint32_t)pos[0] << 8) | ((uint32_t)pos[1] << 16) | ((uint32_t)pos[2] << 24);
+			value <<= rawDataLShift;
+			pos[0] = value >> 8;
+			pos[1] = value >> 16;
+			pos[2] = value >> 24;
+		}
+	}
+	uint8_t* convert24BitData(uint8_t* pos, uint8_t const* endPos);
+	void convertLoadedClustersToNewFormat();
+	int32_t writeTranscode();
+	int32_t writeCompressedTranscode();
+	bool mayBeCompressed();
+	void getFramesTouchingCluster(int32_t clusterIndex, uint32_t* firstFrame, uint32_t* endFrame);
 
 	String tempFilePathForRecording;
 	uint8_t byteDepth;
@@ -109,6 +151,7 @@ public:
 	float midiNoteFromFile; // -1 means none
 
 	uint8_t rawDataFormat;
+	uint8_t rawDataLShift; // For RAW_DATA_LSHIFTED_24
 
 	bool
 	    unloadable; // Only gets set to true if user has re-inserted the card and the sample appears to have been deleted / moved / modified
@@ -134,6 +177,31 @@ public:
 	Cluster** percCacheClusters[2]; // One for each play-direction: 0=forwards; 1=reversed
 	int32_t numPercCacheClusters;
 
+	// Whether analysePercCache() has been asked for yet. Stays true once it's done, or has failed
+	bool percCacheAnalysisRequested;
+
+	SamplePeakPyramid* peakPyramid; // NULL if not built yet, or stolen
+
+	// Whether buildPeakPyramid() has been asked for yet. Goes back to false if the pyramid gets stolen
+	bool peakPyramidRequested;
+
+	// Whether this was loaded from a native copy of its file, rather than the file itself
+	bool loadedFromTranscode;
+
+	// Whether writeTranscode() has been asked for yet
+	bool transcodeRequested;
+
+	// One for each Cluster, if this was loaded from a compressed transcode. NULL otherwise
+	CompressedBlock* compressedBlocks;
+
+	// For AudioFileManager to tell when the same file's been found at another path. contentFileSize is 0 until the
+	// first Cluster's CRC is known
+	uint32_t contentFileSize;
+	uint32_t contentFirstClusterCRC;
+	uint32_t contentLastClusterCRC;
+	bool contentLastClusterCRCKnown;
+	bool inContentIndex;
+
 	int32_t beginningOffsetForPitchDetection;
 	bool beginningOffsetForPitchDetectionFound;
 
@@ -147,6 +215,11 @@ protected:
 #endif
 
 private:
+	int32_t getPercCacheSize();
+	int32_t computePercCache(uint8_t* cache);
+	int32_t computePeakPyramid(int8_t* peaks);
+	float loadOrDeterminePitch(float minFreqHz, float maxFreqHz, bool doPrimeTest);
+
 	int32_t investigateFundamentalPitch(int32_t fundamentalIndexProvided, int32_t tableSize, int32_t* heightTable,
 	                                    uint64_t* sumTable, float* floatIndexTable, float* getFreq,
 	                                    int32_t numDoublings, bool doPrimeTest);
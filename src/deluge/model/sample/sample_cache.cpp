@@ -22,9 +22,15 @@
 #include "model/sample/sample.h"
 #include "storage/audio/audio_file_manager.h"
 #include "storage/cluster/cluster.h"
+#include "storage/folder_index.h"
+#include "storage/storage_manager.h"
+#include "util/functions.h"
+#include "util/pack.h"
+#include <string.h>
 
 SampleCache::SampleCache(Sample* newSample, int32_t newNumClusters, int32_t newWaveformLengthBytes,
-                         int32_t newPhaseIncrement, int32_t newTimeStretchRatio, int32_t newSkipSamplesAtStart) {
+                         int32_t newPhaseIncrement, int32_t newTimeStretchRatio, int32_t newSkipSamplesAtStart,
+                         bool newReversed) {
 	sample = newSample;
 	phaseIncrement = newPhaseIncrement;
 	timeStretchRatio = newTimeStretchRatio;
@@ -34,6 +40,11 @@ SampleCache::SampleCache(Sample* newSample, int32_t newNumClusters, int32_t newW
 #endif
 	waveformLengthBytes = newWaveformLengthBytes;
 	skipSamplesAtStart = newSkipSamplesAtStart;
+	reversed = newReversed;
+	cardState = SampleCacheCardState::UNKNOWN;
+	cardAccessRequested = false;
+	saveToCardWanted = false;
+	cardWriteBytePos = 0;
 	/*
 	for (int32_t i = 0; i < numClusters; i++) {
 		clusters[i] = NULL; // We don't actually have to initialize these, since writeBytePos tells us how many are "valid"
@@ -42,6 +53,9 @@ SampleCache::SampleCache(Sample* newSample, int32_t newNumClusters, int32_t newW
 }
 
 SampleCache::~SampleCache() {
+	if (cardAccessRequested) {
+		audioFileManager.cancelSampleCacheCardAccess(this);
+	}
 	unlinkClusters(0, true);
 }
 
@@ -234,3 +248,281 @@ int32_t SampleCache::getNumExistentClusters(int32_t thisWriteBytePos) {
 
 	return numExistentClusters;
 }
+
+// SampleCaches get saved to the card once written right to their end, so that once their Clusters have been stolen -
+// or after a reboot - they can be read back in rather than rendered all over again. The files live in a hidden folder,
+// named from a CRC of the Sample's file path, then the phase increment, time-stretch ratio, skip and direction.
+// Layout, all little-endian:
+//   header: 'DSMC', uint16 version, uint16 Sample file date, uint16 Sample file time, uint8 numChannels,
+//           uint8 reversed, uint32 Sample file size, int32 phaseIncrement, int32 timeStretchRatio,
+//           int32 skipSamplesAtStart, int32 writeBytePos
+//   then each Cluster's data, including the (bytesPerSample - 1) extra usable bytes after it
+constexpr char const* kSampleCacheFolder = "/.SAMPLE_CACHE";
+constexpr uint32_t kSampleCacheFileMagic = 0x434D5344; // "DSMC"
+constexpr uint16_t kSampleCacheFileVersion = 1;
+constexpr int32_t kSampleCacheFileHeaderSize = 32;
+constexpr int32_t kSampleCacheFilePathMaxLength = 64;
+
+// Called from the audio routine when a voice has finished writing this cache, up to its end or loop end point
+void SampleCache::writingReachedEnd() {
+	if (cardState == SampleCacheCardState::PRESENT && cardWriteBytePos >= writeBytePos) {
+		return;
+	}
+	saveToCardWanted = true;
+	requestCardAccess();
+}
+
+// Called from the audio routine when a voice starts using this cache. If there's more of it on the card than we've got
+// in RAM, it'll get read back in from slowRoutine() - meanwhile the voice just carries on rendering as usual
+void SampleCache::considerRestoringFromCard() {
+	if (cardState == SampleCacheCardState::ABSENT
+	    || (cardState == SampleCacheCardState::PRESENT && writeBytePos >= cardWriteBytePos)) {
+		return;
+	}
+	requestCardAccess();
+}
+
+void SampleCache::requestCardAccess() {
+	if (!cardAccessRequested) {
+		cardAccessRequested = audioFileManager.requestSampleCacheCardAccess(this);
+	}
+}
+
+// Called by AudioFileManager::slowRoutine(), not the audio routine. The audio routine keeps running while the card is
+// read or written though, so it may steal or write to our Clusters at any point we access the card
+void SampleCache::doCardAccess() {
+	cardAccessRequested = false;
+
+	// A recording's file isn't finished yet, and its filePath isn't even where it'll end up
+	if (sample->unloadable || !sample->tempFilePathForRecording.isEmpty()) {
+		return;
+	}
+
+	char cardFilePath[kSampleCacheFilePathMaxLength];
+	getCardFilePath(cardFilePath);
+
+	sample->addReason(); // So it can't be thrown away while we're busy
+
+	if (cardState == SampleCacheCardState::UNKNOWN
+	    || (cardState == SampleCacheCardState::PRESENT && writeBytePos < cardWriteBytePos)) {
+		restoreFromCard(cardFilePath);
+	}
+
+	if (saveToCardWanted) {
+		saveToCardWanted = false;
+		if (cardState != SampleCacheCardState::PRESENT || cardWriteBytePos < writeBytePos) {
+			saveToCard(cardFilePath);
+		}
+	}
+
+	sample->removeReason("E455");
+}
+
+void SampleCache::getCardFilePath(char* cardFilePath) {
+	strcpy(cardFilePath, kSampleCacheFolder);
+	char* pos = cardFilePath + strlen(kSampleCacheFolder);
+	*(pos++) = '/';
+
+	uint32_t keyWords[4];
+	keyWords[0] = get_crc((uint8_t*)sample->filePath.get(), sample->filePath.getLength());
+	keyWords[1] = phaseIncrement;
+	keyWords[2] = timeStretchRatio;
+	keyWords[3] = skipSamplesAtStart;
+	for (int32_t i = 0; i < 4; i++) {
+		intToHex(keyWords[i], pos);
+		pos += 8;
+		*(pos++) = (i < 3) ? '_' : (reversed ? 'R' : 'F');
+	}
+	strcpy(pos, ".cache");
+}
+
+// Looks for this cache on the card, and if there's more of it there than in RAM, reads it all into new Clusters and
+// swaps them in for ours
+void SampleCache::restoreFromCard(char const* cardFilePath) {
+	FRESULT result = f_stat(sample->filePath.get(), &staticFNO);
+	if (result != FR_OK) {
+		cardState = SampleCacheCardState::ABSENT;
+		return;
+	}
+
+	FIL file;
+	result = f_open(&file, cardFilePath, FA_READ);
+	if (result != FR_OK) {
+		cardState = SampleCacheCardState::ABSENT;
+		return;
+	}
+
+	int32_t bytesPerSample = sample->numChannels * kCacheByteDepth;
+	UINT bytesPerCluster = audioFileManager.clusterSize + bytesPerSample - 1;
+	Cluster** newClusters = NULL;
+	int32_t numNewClusters = 0;
+	int32_t numClustersToRead;
+
+	char header[kSampleCacheFileHeaderSize];
+	UINT bytesRead;
+	result = f_read(&file, header, kSampleCacheFileHeaderSize, &bytesRead);
+	if (result != FR_OK || bytesRead != kSampleCacheFileHeaderSize) {
+		goto stale;
+	}
+
+	{
+		uint32_t magic, fileSize;
+		uint16_t version, date, time;
+		int32_t storedPhaseIncrement, storedTimeStretchRatio, storedSkipSamplesAtStart, storedWriteBytePos;
+		memcpy(&magic, &header[0], 4);
+		memcpy(&version, &header[4], 2);
+		memcpy(&date, &header[6], 2);
+		memcpy(&time, &header[8], 2);
+		memcpy(&fileSize, &header[12], 4);
+		memcpy(&storedPhaseIncrement, &header[16], 4);
+		memcpy(&storedTimeStretchRatio, &header[20], 4);
+		memcpy(&storedSkipSamplesAtStart, &header[24], 4);
+		memcpy(&storedWriteBytePos, &header[28], 4);
+
+		// The CRC in the filename could clash, so check everything
+		if (magic != kSampleCacheFileMagic || version != kSampleCacheFileVersion || date != staticFNO.fdate
+		    || time != staticFNO.ftime || fileSize != staticFNO.fsize || header[10] != sample->numChannels
+		    || header[11] != reversed || storedPhaseIncrement != phaseIncrement
+		    || storedTimeStretchRatio != timeStretchRatio || storedSkipSamplesAtStart != skipSamplesAtStart
+		    || storedWriteBytePos <= 0 || storedWriteBytePos > waveformLengthBytes
+		    || storedWriteBytePos % bytesPerSample) {
+			goto stale;
+		}
+
+		cardState = SampleCacheCardState::PRESENT;
+		cardWriteBytePos = storedWriteBytePos;
+	}
+
+	if (writeBytePos >= cardWriteBytePos) {
+		goto getOut; // Nothing to gain. Probably we were just finding out what's there
+	}
+
+	numClustersToRead = getNumExistentClusters(cardWriteBytePos);
+	newClusters =
+	    (Cluster**)GeneralMemoryAllocator::get().alloc(numClustersToRead * sizeof(Cluster*), NULL, false, false);
+	if (!newClusters) {
+		goto getOut;
+	}
+
+	// These aren't in any stealable queue til we swap them in, so can't be stolen while the card's being read
+	while (numNewClusters < numClustersToRead) {
+		Cluster* cluster = audioFileManager.allocateCluster(ClusterType::SAMPLE_CACHE, false, this);
+		if (!cluster) {
+			Debug::println("no RAM to restore cache");
+			goto getOut;
+		}
+		cluster->clusterIndex = numNewClusters;
+		cluster->sampleCache = this;
+		newClusters[numNewClusters++] = cluster;
+
+		result = f_read(&file, cluster->data, bytesPerCluster, &bytesRead);
+		if (result != FR_OK || bytesRead != bytesPerCluster) {
+			goto stale;
+		}
+	}
+
+	f_close(&file);
+
+	// A voice might have written further than the card's copy meanwhile. Otherwise, swap ours in. Any voice that was
+	// writing will see writeBytePos is ahead of it and switch to reading
+	if (writeBytePos < cardWriteBytePos) {
+		unlinkClusters(0, false);
+		for (int32_t i = 0; i < numNewClusters; i++) {
+			clusters[i] = newClusters[i];
+		}
+		writeBytePos = cardWriteBytePos;
+		for (int32_t i = 0; i < numNewClusters; i++) {
+			prioritizeNotStealingCluster(i); // Puts them in their queue, in the usual order
+		}
+		numNewClusters = 0;
+		Debug::println("cache restored from card");
+	}
+	goto freeNewClusters;
+
+stale:
+	cardState = SampleCacheCardState::ABSENT; // So it'll get overwritten next time we save
+
+getOut:
+	f_close(&file);
+
+freeNewClusters:
+	for (int32_t i = 0; i < numNewClusters; i++) {
+		audioFileManager.deallocateCluster(newClusters[i]);
+	}
+	if (newClusters) {
+		delugeDealloc(newClusters);
+	}
+}
+
+// If this fails, e.g. because the card is write-protected, that's fine - the cache just gets rendered again next time
+void SampleCache::saveToCard(char const* cardFilePath) {
+	int32_t bytesToSave = writeBytePos;
+	if (!bytesToSave) {
+		return;
+	}
+
+	FRESULT result = f_stat(sample->filePath.get(), &staticFNO);
+	if (result != FR_OK) {
+		return;
+	}
+
+	char header[kSampleCacheFileHeaderSize];
+	uint32_t magic = kSampleCacheFileMagic;
+	uint16_t version = kSampleCacheFileVersion;
+	uint32_t fileSize = staticFNO.fsize;
+	memcpy(&header[0], &magic, 4);
+	memcpy(&header[4], &version, 2);
+	memcpy(&header[6], &staticFNO.fdate, 2);
+	memcpy(&header[8], &staticFNO.ftime, 2);
+	header[10] = sample->numChannels;
+	header[11] = reversed;
+	memcpy(&header[12], &fileSize, 4);
+	memcpy(&header[16], &phaseIncrement, 4);
+	memcpy(&header[20], &timeStretchRatio, 4);
+	memcpy(&header[24], &skipSamplesAtStart, 4);
+	memcpy(&header[28], &bytesToSave, 4);
+
+	FIL file;
+	result = f_open(&file, cardFilePath, FA_CREATE_ALWAYS | FA_WRITE);
+	if (result == FR_NO_PATH) {
+		f_mkdir(kSampleCacheFolder);
+		result = f_open(&file, cardFilePath, FA_CREATE_ALWAYS | FA_WRITE);
+	}
+	if (result != FR_OK) {
+		return;
+	}
+	FolderIndex::folderChanged(cardFilePath);
+
+	// Until it's complete, the file's no good to anyone
+	cardState = SampleCacheCardState::ABSENT;
+
+	int32_t bytesPerSample = sample->numChannels * kCacheByteDepth;
+	UINT bytesPerCluster = audioFileManager.clusterSize + bytesPerSample - 1;
+	int32_t numClustersToSave = getNumExistentClusters(bytesToSave);
+
+	UINT bytesWritten;
+	result = f_write(&file, header, kSampleCacheFileHeaderSize, &bytesWritten);
+	if (result != FR_OK || bytesWritten != kSampleCacheFileHeaderSize) {
+		goto fail;
+	}
+
+	for (int32_t i = 0; i < numClustersToSave; i++) {
+		result = f_write(&file, clusters[i]->data, bytesPerCluster, &bytesWritten);
+
+		// If the audio routine stole this Cluster while that was happening, what got written can't be trusted
+		if (result != FR_OK || bytesWritten != bytesPerCluster || writeBytePos < bytesToSave) {
+			goto fail;
+		}
+	}
+
+	if (f_close(&file) == FR_OK) {
+		cardState = SampleCacheCardState::PRESENT;
+		cardWriteBytePos = bytesToSave;
+		Debug::println("cache saved to card");
+		return;
+	}
+
+fail:
+	f_close(&file);
+	f_unlink(cardFilePath); // Don't leave a half-written one
+}
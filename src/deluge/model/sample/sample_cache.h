@@ -19,19 +19,40 @@
 
 #include "definitions_cxx.hpp"
 #include <cstdint>
+#include <cstdlib>
 
 class Sample;
 class Cluster;
 
+// Whether a SampleCache has a copy saved on the card, which it can be restored from after its Clusters get stolen
+enum class SampleCacheCardState : uint8_t {
+	UNKNOWN, // Haven't looked yet
+	ABSENT,
+	PRESENT,
+};
+
 class SampleCache {
 public:
 	SampleCache(Sample* newSample, int32_t newNumClusters, int32_t newWaveformLengthBytes, int32_t newPhaseIncrement,
-	            int32_t newTimeStretchRatio, int32_t newSkipSamplesAtStart);
+	            int32_t newTimeStretchRatio, int32_t newSkipSamplesAtStart, bool newReversed);
 	~SampleCache();
 	void clusterStolen(int32_t clusterIndex);
 	bool setupNewCluster(int32_t cachedClusterIndex);
 	Cluster* getCluster(int32_t clusterIndex);
 	void setWriteBytePos(int32_t newWriteBytePos);
+	void writingReachedEnd();
+	void considerRestoringFromCard();
+	void doCardAccess();
+
+	// Whether both rates are within 1 / (1 << toleranceMagnitude) of the ones this was made at. A tempo ramp, or an
+	// external clock wobbling about, changes a synced sample's rates a little at a time, and a cache which only did for
+	// exactly its own would get thrown away - and live time-stretching set up again - at every one of those changes.
+	// A rate that's exactly neutral has to match exactly though, as VoiceSample goes by that to know how to stop
+	// reading a cache once it gets to the end of what's been written
+	bool ratesWithin(int32_t otherPhaseIncrement, int32_t otherTimeStretchRatio, int32_t toleranceMagnitude) {
+		return rateWithin(otherPhaseIncrement, phaseIncrement, toleranceMagnitude)
+		       && rateWithin(otherTimeStretchRatio, timeStretchRatio, toleranceMagnitude);
+	}
 
 	int32_t writeBytePos;
 #if ALPHA_OR_BETA_VERSION
@@ -42,11 +63,28 @@ public:
 	int32_t phaseIncrement;
 	int32_t timeStretchRatio;
 	int32_t skipSamplesAtStart;
+	bool reversed;
+
+	SampleCacheCardState cardState;
+	bool cardAccessRequested; // Whether we're in AudioFileManager's queue for doCardAccess() to be called
+	bool saveToCardWanted;
+	int32_t cardWriteBytePos; // How much the copy on the card holds, when cardState is PRESENT
 
 private:
+	static bool rateWithin(int32_t rate, int32_t ownRate, int32_t toleranceMagnitude) {
+		if (rate == 16777216 || ownRate == 16777216) {
+			return rate == ownRate;
+		}
+		return std::abs(rate - ownRate) <= (ownRate >> toleranceMagnitude);
+	}
+
 	void unlinkClusters(int32_t startAtIndex, bool beingDestructed);
 	int32_t getNumExistentClusters(int32_t thisWriteBytePos);
 	void prioritizeNotStealingCluster(int32_t clusterIndex);
+	void requestCardAccess();
+	void getCardFilePath(char* cardFilePath);
+	void restoreFromCard(char const* cardFilePath);
+	void saveToCard(char const* cardFilePath);
 
 	// This has to be last!!!
 	Cluster* clusters[1]; // These are not initialized, and are only "valid" as far as writeBytePos dictates
@@ -26,7 +26,10 @@ SampleControls::SampleControls() {
 	reversed = false;
 }
 
-int32_t SampleControls::getInterpolationBufferSize(int32_t phaseIncrement) {
+// inaudibility is how much less a drop in quality would be noticed for this voice than usual - e.g. because it's quiet
+// or releasing. It makes us treat the CPU as being that much more dire, so those voices get stepped down first, and
+// stepping voices down to cheaper interpolation comes well before any have to be culled.
+int32_t SampleControls::getInterpolationBufferSize(int32_t phaseIncrement, int32_t inaudibility) {
 	if (interpolationMode == InterpolationMode::LINEAR) {
 useLinearInterpolation:
 		return 2;
@@ -35,14 +38,20 @@ useLinearInterpolation:
 
 		// If CPU dire...
 		if (AudioEngine::cpuDireness) {
+			int32_t direness = AudioEngine::cpuDireness + inaudibility;
 			int32_t octave =
 			    getMagnitudeOld(phaseIncrement); // Unstretched, and the first octave going up from that, would be '25'
 			if (octave
 			    >= 26
-			           - (AudioEngine::cpuDireness
+			           - (direness
 			              >> 2)) { // So, under max direness (14), everything from octave 23 up will be linearly interpolated. That's from 2 octaves down, upward
 				goto useLinearInterpolation;
 			}
+
+			// And before that, a shorter kernel. Under max direness, from octave 21 up
+			if (octave >= 28 - (direness >> 1)) {
+				return kInterpolationReducedNumSamples;
+			}
 		}
 
 		return kInterpolationMaxNumSamples;
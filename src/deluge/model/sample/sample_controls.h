@@ -23,7 +23,7 @@
 class SampleControls {
 public:
 	SampleControls();
-	int32_t getInterpolationBufferSize(int32_t phaseIncrement);
+	int32_t getInterpolationBufferSize(int32_t phaseIncrement, int32_t inaudibility = 0);
 
 	InterpolationMode interpolationMode;
 	bool pitchAndSpeedAreIndependent;
@@ -62,6 +62,28 @@ void SampleHolder::beenClonedFrom(SampleHolder* other, bool reversed) {
 	waveformViewZoom = other->waveformViewZoom;
 }
 
+// Makes this play just part of the same Sample as parent. That Sample, its Clusters and its file path are all shared,
+// rather than going looking for the file again - all each slice has of its own is its range, and the reasons it has on
+// the Clusters at its start. Where slices are close enough together to start in the same Cluster, that's just more
+// reasons on that one Cluster
+void SampleHolder::setupAsSliceOf(SampleHolder* parent, uint64_t newStartPos, uint64_t newEndPos, bool reversed) {
+	if (!parent->audioFile) {
+		return;
+	}
+
+	startPos = newStartPos;
+	endPos = newEndPos;
+
+	if (audioFile == parent->audioFile) {
+		// Just moved, so swap the reasons over to wherever it starts now
+		claimClusterReasons(reversed);
+	}
+	else {
+		filePath.set(&parent->filePath);
+		setAudioFile(parent->audioFile, reversed);
+	}
+}
+
 void SampleHolder::unassignAllClusterReasons(bool beingDestructed) {
 	for (int32_t l = 0; l < kNumClustersLoadedAhead; l++) {
 		if (clustersForStart[l]) {
@@ -138,6 +160,31 @@ void SampleHolder::setAudioFile(AudioFile* newSample, bool reversed, bool manual
 	}
 }
 
+// The Clusters at the start are always held already, so this gets the one after them on its way too - for when we
+// know we're likely to be played soon, and a longer play shouldn't have to wait on the card once it gets past them
+void SampleHolder::prefetchClusterAfterStart(bool reversed) {
+	Sample* sample = (Sample*)audioFile;
+	if (!sample) {
+		return;
+	}
+
+	Cluster* lastHeld = NULL;
+	for (int32_t l = 0; l < kNumClustersLoadedAhead && clustersForStart[l]; l++) {
+		lastHeld = clustersForStart[l];
+	}
+	if (!lastHeld) {
+		return;
+	}
+
+	int32_t clusterIndex = lastHeld->clusterIndex + (reversed ? -1 : 1);
+	if (clusterIndex < sample->getFirstClusterIndexWithAudioData()
+	    || clusterIndex >= sample->getFirstClusterIndexWithNoAudioData()) {
+		return;
+	}
+
+	audioFileManager.prefetchCluster(sample, clusterIndex);
+}
+
 constexpr int32_t kMarkerSamplesBeforeToClaim = 150;
 
 // Reassesses which Clusters we want to be a "reason" for.
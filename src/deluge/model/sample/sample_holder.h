@@ -36,7 +36,9 @@ public:
 	int64_t getEndPos(bool forTimeStretching = false);
 	int64_t getDurationInSamples(bool forTimeStretching = false);
 	void beenClonedFrom(SampleHolder* other, bool reversed);
+	void setupAsSliceOf(SampleHolder* parent, uint64_t newStartPos, uint64_t newEndPos, bool reversed);
 	virtual void claimClusterReasons(bool reversed, int32_t clusterLoadInstruction = CLUSTER_ENQUEUE);
+	void prefetchClusterAfterStart(bool reversed);
 	int32_t getLengthInSamplesAtSystemSampleRate(bool forTimeStretching = false);
 	void setAudioFile(AudioFile* newAudioFile, bool reversed = false, bool manuallySelected = false,
 	                  int32_t clusterLoadInstruction = CLUSTER_ENQUEUE);
@@ -25,15 +25,25 @@
 #include "model/sample/sample.h"
 #include "model/voice/voice.h"
 #include "model/voice/voice_sample_playback_guide.h"
+#include "processing/engines/audio_engine.h"
 #include "storage/audio/audio_file_manager.h"
 #include "storage/cluster/cluster.h"
 
 #include "arm_neon.h"
 
+int32_t SampleLowLevelReader::numReadAheadClustersTotal = 0;
+
+// Four and eight cache lines. A PLD never faults, so it doesn't matter that these reach past the end of the Cluster
+int32_t SampleLowLevelReader::prefetchDistanceForward = 4 * CACHE_LINE_SIZE;
+int32_t SampleLowLevelReader::prefetchDistanceReverse = 8 * CACHE_LINE_SIZE;
+
 SampleLowLevelReader::SampleLowLevelReader() {
+	interpolationBufferPos = 0;
 	for (int32_t l = 0; l < kNumClustersLoadedAhead; l++) {
 		clusters[l] = NULL;
 	}
+	numReadAheadClusters = 0;
+	readAheadPhaseIncrement = 16777216;
 }
 
 SampleLowLevelReader::~SampleLowLevelReader() {
@@ -47,6 +57,82 @@ void SampleLowLevelReader::unassignAllReasons() {
 			clusters[l] = NULL;
 		}
 	}
+	unassignReadAhead();
+}
+
+void SampleLowLevelReader::unassignReadAhead() {
+	for (int32_t l = 0; l < numReadAheadClusters; l++) {
+		audioFileManager.removeReasonFromCluster(readAheadClusters[l], "E464");
+	}
+	numReadAheadClustersTotal -= numReadAheadClusters;
+	numReadAheadClusters = 0;
+}
+
+// clusters[] always covers the one we're in and the next, so the next has a whole Cluster's worth of playback to get
+// loaded in. That's plenty at normal speed, but pitched up a couple of octaves, or if the card's being slow, it's not -
+// so work out how many Clusters we'll get through while one loads, going by how long they've been taking lately, with
+// some margin, and ask for that many more
+int32_t SampleLowLevelReader::getNumClustersReadAheadWanted(Sample* sample) {
+	uint64_t loadTimeInSamples =
+	    (uint64_t)audioFileManager.averageClusterLoadCycles * 2 * kSampleRate / (Debug::mS * 1000);
+	uint64_t bytesDuringLoad =
+	    (loadTimeInSamples * sample->numChannels * sample->byteDepth * (uint32_t)readAheadPhaseIncrement) >> 24;
+	int32_t clustersDuringLoad = (bytesDuringLoad >> audioFileManager.clusterSizeMagnitude) + 1;
+
+	return std::clamp<int32_t>(clustersDuringLoad - (kNumClustersLoadedAhead - 1), 0, kMaxNumClustersReadAhead);
+}
+
+// Call after clusters[] has been set up or moved on. Drops any that clusters[] has caught up with, and gets more if
+// we now want them
+void SampleLowLevelReader::topUpReadAhead(SamplePlaybackGuide* guide, Sample* sample, int32_t priorityRating) {
+	Cluster* lastCluster = NULL;
+	for (int32_t l = 0; l < kNumClustersLoadedAhead && clusters[l]; l++) {
+		lastCluster = clusters[l];
+	}
+	if (!lastCluster) {
+		unassignReadAhead();
+		return;
+	}
+
+	int32_t numCaughtUp = 0;
+	while (numCaughtUp < numReadAheadClusters
+	       && ((int32_t)readAheadClusters[numCaughtUp]->clusterIndex - (int32_t)lastCluster->clusterIndex)
+	                  * guide->playDirection
+	              <= 0) {
+		audioFileManager.removeReasonFromCluster(readAheadClusters[numCaughtUp], "E465");
+		numCaughtUp++;
+	}
+	if (numCaughtUp) {
+		numReadAheadClusters -= numCaughtUp;
+		numReadAheadClustersTotal -= numCaughtUp;
+		memmove(&readAheadClusters[0], &readAheadClusters[numCaughtUp], numReadAheadClusters * sizeof(Cluster*));
+	}
+
+	int32_t numWanted = getNumClustersReadAheadWanted(sample);
+
+	while (numReadAheadClusters > numWanted) {
+		numReadAheadClusters--;
+		numReadAheadClustersTotal--;
+		audioFileManager.removeReasonFromCluster(readAheadClusters[numReadAheadClusters], "E466");
+	}
+
+	int32_t finalClusterIndex = guide->getFinalClusterIndex(sample, shouldObeyMarkers());
+	while (numReadAheadClusters < numWanted && numReadAheadClustersTotal < kMaxNumClustersReadAheadTotal) {
+		Cluster* furthest = numReadAheadClusters ? readAheadClusters[numReadAheadClusters - 1] : lastCluster;
+		int32_t clusterIndex = furthest->clusterIndex + guide->playDirection;
+		if ((clusterIndex - finalClusterIndex) * guide->playDirection > 0) {
+			break;
+		}
+
+		// If that fails (no free RAM), we just carry on with what we've got
+		Cluster* cluster =
+		    sample->clusters.getElement(clusterIndex)->getCluster(sample, clusterIndex, CLUSTER_ENQUEUE, priorityRating);
+		if (!cluster) {
+			break;
+		}
+		readAheadClusters[numReadAheadClusters++] = cluster;
+		numReadAheadClustersTotal++;
+	}
 }
 
 // Relative to audio file start, including WAV file header.
@@ -332,6 +418,7 @@ bool SampleLowLevelReader::assignClusters(SamplePlaybackGuide* guide, Sample* sa
 		clusterIndex += guide->playDirection;
 	}
 
+	topUpReadAhead(guide, sample, priorityRating);
 	return true;
 }
 
@@ -363,6 +450,7 @@ bool SampleLowLevelReader::moveOnToNextCluster(SamplePlaybackGuide* guide, Sampl
 	}
 
 	if (!clusters[0]->loaded) {
+		AudioEngine::voiceStats.numClusterUnderruns++;
 		Debug::print("late ");
 		Debug::print(clusters[0]->sample->filePath.get());
 		Debug::print(" p ");
@@ -400,6 +488,8 @@ bool SampleLowLevelReader::moveOnToNextCluster(SamplePlaybackGuide* guide, Sampl
 		}
 	}
 
+	topUpReadAhead(guide, sample, priorityRating);
+
 	setupForPlayPosMovedIntoNewCluster(guide, sample,
 	                                   bytePosWithinOldCluster - audioFileManager.clusterSize * guide->playDirection,
 	                                   sample->byteDepth);
@@ -455,6 +545,17 @@ bool SampleLowLevelReader::changeClusterIfNecessary(SamplePlaybackGuide* guide,
 		}
 #endif
 	}
+
+	// If we're over halfway through this Cluster and the next one still isn't loaded, we're about to run dry - so get
+	// the card to load that one before anything else
+	if (reassessmentAction == REASSESSMENT_ACTION_NEXT_CLUSTER && clusters[1] && !clusters[1]->loaded) {
+		int32_t bytesLeft =
+		    (int32_t)((uint32_t)reassessmentLocation - (uint32_t)currentPlayPos) * guide->playDirection;
+		if (bytesLeft < (int32_t)(audioFileManager.clusterSize >> 1)) {
+			audioFileManager.prioritizeCluster(clusters[1]);
+		}
+	}
+
 	return true;
 }
 
@@ -467,9 +568,9 @@ void SampleLowLevelReader::fillInterpolationBufferRetrospectively(Sample* sample
 
 		if (!clusters[0]) {
 justWriteZeros:
-			interpolationBuffer[0][0][i] = 0;
+			setInterpolationBufferValue(0, i, 0);
 			if (sample->numChannels == 2) {
-				interpolationBuffer[1][0][i] = 0;
+				setInterpolationBufferValue(1, i, 0);
 			}
 		}
 
@@ -481,10 +582,10 @@ justWriteZeros:
 
 			// If there was valid audio data there...
 			if (bytesPastClusterStart >= 0) {
-				interpolationBuffer[0][0][i] = *(int16_t*)(thisPlayPos + 2);
+				setInterpolationBufferValue(0, i, *(int16_t*)(thisPlayPos + 2));
 
 				if (sample->numChannels == 2) {
-					interpolationBuffer[1][0][i] = *(int16_t*)(thisPlayPos + 2 + sample->byteDepth);
+					setInterpolationBufferValue(1, i, *(int16_t*)(thisPlayPos + 2 + sample->byteDepth));
 				}
 			}
 
@@ -503,9 +604,9 @@ bool SampleLowLevelReader::fillInterpolationBufferForward(SamplePlaybackGuide* g
 
 		if (!clusters[0]) {
 doZeroesFillingBuffer:
-			interpolationBuffer[0][0][i] = 0;
+			setInterpolationBufferValue(0, i, 0);
 			if (sample->numChannels == 2) {
-				interpolationBuffer[1][0][i] = 0;
+				setInterpolationBufferValue(1, i, 0);
 			}
 			currentPlayPos++;
 			if ((uint32_t)currentPlayPos >= interpolationBufferSize) {
@@ -520,9 +621,9 @@ doZeroesFillingBuffer:
 				goto doZeroesFillingBuffer;
 			}
 
-			interpolationBuffer[0][0][i] = *(int16_t*)(currentPlayPos + 2);
+			setInterpolationBufferValue(0, i, *(int16_t*)(currentPlayPos + 2));
 			if (sample->numChannels == 2) {
-				interpolationBuffer[1][0][i] = *(int16_t*)(currentPlayPos + 2 + sample->byteDepth);
+				setInterpolationBufferValue(1, i, *(int16_t*)(currentPlayPos + 2 + sample->byteDepth));
 			}
 
 			// And move forward one more
@@ -569,6 +670,8 @@ bool SampleLowLevelReader::considerUpcomingWindow(SamplePlaybackGuide* guide, Sa
 		display->freezeWithError("E228");
 	}
 
+	readAheadPhaseIncrement = phaseIncrement;
+
 	int32_t bytesPerSample = sample->numChannels * sample->byteDepth;
 
 	// Interpolating
@@ -618,9 +721,9 @@ bool SampleLowLevelReader::considerUpcomingWindow(SamplePlaybackGuide* guide, Sa
 				int32_t offset = difference >> 1;
 
 				for (int32_t i = 0; i < interpolationBufferSize; i++) {
-					interpolationBuffer[0][0][i] = interpolationBuffer[0][0][i + offset];
+					setInterpolationBufferValue(0, i, getInterpolationBufferValue(0, i + offset));
 					if (sample->numChannels == 2) {
-						interpolationBuffer[1][0][i] = interpolationBuffer[1][0][i + offset];
+						setInterpolationBufferValue(1, i, getInterpolationBufferValue(1, i + offset));
 					}
 				}
 
@@ -650,9 +753,9 @@ bool SampleLowLevelReader::considerUpcomingWindow(SamplePlaybackGuide* guide, Sa
 				int32_t offset = difference >> 1;
 
 				for (int32_t i = 0; i < interpolationBufferSizeLastTime; i++) {
-					interpolationBuffer[0][0][i + offset] = interpolationBuffer[0][0][i];
+					setInterpolationBufferValue(0, i + offset, getInterpolationBufferValue(0, i));
 					if (sample->numChannels == 2) {
-						interpolationBuffer[1][0][i + offset] = interpolationBuffer[1][0][i];
+						setInterpolationBufferValue(1, i + offset, getInterpolationBufferValue(1, i));
 					}
 				}
 
@@ -665,9 +768,9 @@ bool SampleLowLevelReader::considerUpcomingWindow(SamplePlaybackGuide* guide, Sa
 
 				// If still here, fill far end with zeros. Not perfect, but it'll do.
 				for (int32_t i = (interpolationBufferSize - offset); i < interpolationBufferSize; i++) {
-					interpolationBuffer[0][0][i] = 0;
+					setInterpolationBufferValue(0, i, 0);
 					if (sample->numChannels == 2) {
-						interpolationBuffer[1][0][i] = 0;
+						setInterpolationBufferValue(1, i, 0);
 					}
 				}
 
@@ -871,42 +974,24 @@ doZeroes:
 	return true;
 }
 
-#pragma GCC push_options
-#pragma GCC optimize("no-tree-loop-distribute-patterns")
 void SampleLowLevelReader::bufferIndividualSampleForInterpolation(uint32_t bitMask, int32_t numChannels,
                                                                   int32_t byteDepth, char* __restrict__ playPosNow) {
+	advanceInterpolationBuffer(1);
 
-	// This works better than using memmoves. Ideally we'd switch this off if not smoothly interpolating - check that that's actually more efficient though
-	for (int32_t i = kInterpolationMaxNumSamples - 1; i >= 1; i--) {
-		interpolationBuffer[0][0][i] = interpolationBuffer[0][0][i - 1];
-		if (numChannels == 2) {
-			interpolationBuffer[1][0][i] = interpolationBuffer[1][0][i - 1];
-		}
-	}
-
-	interpolationBuffer[0][0][0] = *(int16_t*)(playPosNow + 2);
+	setInterpolationBufferValue(0, 0, *(int16_t*)(playPosNow + 2));
 
 	if (numChannels == 2) {
-		interpolationBuffer[1][0][0] = *(int16_t*)(playPosNow + 2 + byteDepth);
+		setInterpolationBufferValue(1, 0, *(int16_t*)(playPosNow + 2 + byteDepth));
 	}
 }
 
-#pragma GCC pop_options
-
 void SampleLowLevelReader::bufferZeroForInterpolation(int32_t numChannels) {
+	advanceInterpolationBuffer(1);
 
-	// This works better than using memmoves. Ideally we'd switch this off if not smoothly interpolating - check that that's actually more efficient though
-	for (int32_t i = kInterpolationMaxNumSamples - 1; i >= 1; i--) {
-		interpolationBuffer[0][0][i] = interpolationBuffer[0][0][i - 1];
-		if (numChannels == 2) {
-			interpolationBuffer[1][0][i] = interpolationBuffer[1][0][i - 1];
-		}
-	}
-
-	interpolationBuffer[0][0][0] = 0;
+	setInterpolationBufferValue(0, 0, 0);
 
 	if (numChannels == 2) {
-		interpolationBuffer[1][0][0] = 0;
+		setInterpolationBufferValue(1, 0, 0);
 	}
 
 	currentPlayPos++;
@@ -943,29 +1028,29 @@ void SampleLowLevelReader::jumpForwardLinear(int32_t numChannels, int32_t byteDe
 
 		if (numChannels == 2) {
 			if (numSamplesToJumpForward >= 2) {
-				interpolationBuffer[0][0][1] = *(int16_t*)(currentPlayPos + 2);
-				interpolationBuffer[1][0][1] = *(int16_t*)(currentPlayPos + 2 + byteDepth);
+				setInterpolationBufferValue(0, 1, *(int16_t*)(currentPlayPos + 2));
+				setInterpolationBufferValue(1, 1, *(int16_t*)(currentPlayPos + 2 + byteDepth));
 				currentPlayPos += jumpAmount;
 			}
 			else {
-				interpolationBuffer[0][0][1] = interpolationBuffer[0][0][0];
-				interpolationBuffer[1][0][1] = interpolationBuffer[1][0][0];
+				setInterpolationBufferValue(0, 1, getInterpolationBufferValue(0, 0));
+				setInterpolationBufferValue(1, 1, getInterpolationBufferValue(1, 0));
 			}
-			interpolationBuffer[1][0][0] = *(int16_t*)(currentPlayPos + 2 + byteDepth);
+			setInterpolationBufferValue(1, 0, *(int16_t*)(currentPlayPos + 2 + byteDepth));
 		}
 
 		else {
 			if (numSamplesToJumpForward >= 2) {
-				interpolationBuffer[0][0][1] = *(int16_t*)(currentPlayPos + 2);
+				setInterpolationBufferValue(0, 1, *(int16_t*)(currentPlayPos + 2));
 				currentPlayPos += jumpAmount;
 			}
 			else {
-				interpolationBuffer[0][0][1] = interpolationBuffer[0][0][0];
+				setInterpolationBufferValue(0, 1, getInterpolationBufferValue(0, 0));
 			}
 		}
 
 		// Putting these down here did speed things up!
-		interpolationBuffer[0][0][0] = *(int16_t*)(currentPlayPos + 2);
+		setInterpolationBufferValue(0, 0, *(int16_t*)(currentPlayPos + 2));
 		currentPlayPos += jumpAmount;
 	}
 }
@@ -975,13 +1060,132 @@ void SampleLowLevelReader::jumpForwardLinear(int32_t numChannels, int32_t byteDe
 	((24 + kInterpolationMaxNumSamplesMagnitude) - 16 - numBitsInTableSize                                             \
 	 + 1) // that's (numBitsInInput - 16 - numBitsInTableSize); = 4 for now
 
+// Same as dsp/interpolation/interpolate.h, but reading the history straight out of our ring, and with stereo doing
+// both channels in the same pass
 void SampleLowLevelReader::interpolate(int32_t* __restrict__ sampleRead, int32_t numChannelsNow, int32_t whichKernel) {
-#include "dsp/interpolation/interpolate.h"
+#if rshiftAmount >= 0
+	uint32_t rshifted = oscPos >> rshiftAmount;
+#else
+	uint32_t rshifted = oscPos << (-rshiftAmount);
+#endif
+
+	int16_t strength2 = rshifted & 32767;
+
+	int32_t progressSmall = oscPos >> (24 + kInterpolationMaxNumSamplesMagnitude - numBitsInTableSize);
+
+	int16x8_t kernelVector[kInterpolationMaxNumSamples >> 3];
+
+	for (int32_t i = 0; i < (kInterpolationMaxNumSamples >> 3); i++) {
+		int16x8_t value1 = vld1q_s16(&windowedSincKernel[whichKernel][progressSmall][i << 3]);
+		int16x8_t value2 = vld1q_s16(&windowedSincKernel[whichKernel][progressSmall + 1][i << 3]);
+		int16x8_t difference = vsubq_s16(value2, value1);
+		int16x8_t multipliedDifference = vqdmulhq_n_s16(difference, strength2);
+		kernelVector[i] = vaddq_s16(value1, multipliedDifference);
+	}
+
+	int16_t const* __restrict__ historyL = &interpolationBuffer[0][interpolationBufferPos];
+
+	if (numChannelsNow == 2) {
+		int16_t const* __restrict__ historyR = &interpolationBuffer[1][interpolationBufferPos];
+
+		int32x4_t multipliedL;
+		int32x4_t multipliedR;
+
+		for (int32_t i = 0; i < (kInterpolationMaxNumSamples >> 3); i++) {
+			int16x8_t valuesL = vld1q_s16(historyL + (i << 3));
+			int16x8_t valuesR = vld1q_s16(historyR + (i << 3));
+
+			if (i == 0) {
+				multipliedL = vmull_s16(vget_low_s16(kernelVector[i]), vget_low_s16(valuesL));
+				multipliedR = vmull_s16(vget_low_s16(kernelVector[i]), vget_low_s16(valuesR));
+			}
+			else {
+				multipliedL = vmlal_s16(multipliedL, vget_low_s16(kernelVector[i]), vget_low_s16(valuesL));
+				multipliedR = vmlal_s16(multipliedR, vget_low_s16(kernelVector[i]), vget_low_s16(valuesR));
+			}
+
+			multipliedL = vmlal_s16(multipliedL, vget_high_s16(kernelVector[i]), vget_high_s16(valuesL));
+			multipliedR = vmlal_s16(multipliedR, vget_high_s16(kernelVector[i]), vget_high_s16(valuesR));
+		}
+
+		int32x2_t twosiesL = vadd_s32(vget_high_s32(multipliedL), vget_low_s32(multipliedL));
+		int32x2_t twosiesR = vadd_s32(vget_high_s32(multipliedR), vget_low_s32(multipliedR));
+
+		vst1_s32(sampleRead, vpadd_s32(twosiesL, twosiesR));
+	}
+
+	else {
+		int32x4_t multiplied;
+
+		for (int32_t i = 0; i < (kInterpolationMaxNumSamples >> 3); i++) {
+			int16x8_t values = vld1q_s16(historyL + (i << 3));
+
+			if (i == 0) {
+				multiplied = vmull_s16(vget_low_s16(kernelVector[i]), vget_low_s16(values));
+			}
+			else {
+				multiplied = vmlal_s16(multiplied, vget_low_s16(kernelVector[i]), vget_low_s16(values));
+			}
+
+			multiplied = vmlal_s16(multiplied, vget_high_s16(kernelVector[i]), vget_high_s16(values));
+		}
+
+		int32x2_t twosies = vadd_s32(vget_high_s32(multiplied), vget_low_s32(multiplied));
+
+		sampleRead[0] = vget_lane_s32(twosies, 0) + vget_lane_s32(twosies, 1);
+	}
+}
+
+// With a buffer of kInterpolationReducedNumSamples, which holds what would be the middle of the full-sized one, so
+// just the middle of the kernel gets applied
+void SampleLowLevelReader::interpolateReduced(int32_t* __restrict__ sampleRead, int32_t numChannelsNow,
+                                              int32_t whichKernel) {
+	constexpr int32_t kFirstTap = (kInterpolationMaxNumSamples - kInterpolationReducedNumSamples) >> 1;
+
+#if rshiftAmount >= 0
+	uint32_t rshifted = oscPos >> rshiftAmount;
+#else
+	uint32_t rshifted = oscPos << (-rshiftAmount);
+#endif
+
+	int16_t strength2 = rshifted & 32767;
+
+	int32_t progressSmall = oscPos >> (24 + kInterpolationMaxNumSamplesMagnitude - numBitsInTableSize);
+
+	int16x8_t value1 = vld1q_s16(&windowedSincKernel[whichKernel][progressSmall][kFirstTap]);
+	int16x8_t value2 = vld1q_s16(&windowedSincKernel[whichKernel][progressSmall + 1][kFirstTap]);
+	int16x8_t difference = vsubq_s16(value2, value1);
+	int16x8_t multipliedDifference = vqdmulhq_n_s16(difference, strength2);
+	int16x8_t kernelVector = vaddq_s16(value1, multipliedDifference);
+
+	int16x8_t valuesL = vld1q_s16(&interpolationBuffer[0][interpolationBufferPos]);
+	int32x4_t multipliedL = vmull_s16(vget_low_s16(kernelVector), vget_low_s16(valuesL));
+	multipliedL = vmlal_s16(multipliedL, vget_high_s16(kernelVector), vget_high_s16(valuesL));
+	int32x2_t twosiesL = vadd_s32(vget_high_s32(multipliedL), vget_low_s32(multipliedL));
+
+	if (numChannelsNow == 2) {
+		int16x8_t valuesR = vld1q_s16(&interpolationBuffer[1][interpolationBufferPos]);
+		int32x4_t multipliedR = vmull_s16(vget_low_s16(kernelVector), vget_low_s16(valuesR));
+		multipliedR = vmlal_s16(multipliedR, vget_high_s16(kernelVector), vget_high_s16(valuesR));
+		int32x2_t twosiesR = vadd_s32(vget_high_s32(multipliedR), vget_low_s32(multipliedR));
+
+		vst1_s32(sampleRead, vpadd_s32(twosiesL, twosiesR));
+	}
+	else {
+		sampleRead[0] = vget_lane_s32(twosiesL, 0) + vget_lane_s32(twosiesL, 1);
+	}
 }
 
 void SampleLowLevelReader::interpolateLinear(int32_t* __restrict__ sampleRead, int32_t numChannelsNow,
                                              int32_t whichKernel) {
-#include "dsp/interpolation/interpolate_linear.h"
+	int16_t strength2 = oscPos >> 9;
+	int16_t strength1 = 32767 - strength2;
+
+	sampleRead[0] = (getInterpolationBufferValue(0, 1) * strength1) + (getInterpolationBufferValue(0, 0) * strength2);
+	if (numChannelsNow == 2) {
+		sampleRead[1] =
+		    (getInterpolationBufferValue(1, 1) * strength1) + (getInterpolationBufferValue(1, 0) * strength2);
+	}
 }
 
 // This stuff is in its own function here rather than in Voice because for some reason it's faster
@@ -1009,6 +1213,7 @@ void SampleLowLevelReader::readSamplesResampled(int32_t** __restrict__ oscBuffer
 	if (interpolationBufferSize > 2) {
 
 		char* __restrict__ currentPlayPosNow = currentPlayPos + 2;
+		int32_t const prefetchDistance = getPrefetchDistance(jumpAmount);
 
 		if (!*doneAnySamplesYet) {
 			*doneAnySamplesYet = true;
@@ -1018,6 +1223,7 @@ void SampleLowLevelReader::readSamplesResampled(int32_t** __restrict__ oscBuffer
 		do {
 
 			if (__builtin_expect(stillGotActualData, 1)) {
+				__builtin_prefetch(currentPlayPosNow + prefetchDistance);
 
 				oscPos += phaseIncrement;
 				int32_t numSamplesToJumpForward = oscPos >> 24;
@@ -1032,21 +1238,15 @@ void SampleLowLevelReader::readSamplesResampled(int32_t** __restrict__ oscBuffer
 
 					int16_t sourceL = *(int16_t*)currentPlayPosNow;
 
-					for (int32_t i = kInterpolationMaxNumSamples - 1; i >= numSamplesToJumpForward; i--) {
-						interpolationBuffer[0][0][i] = interpolationBuffer[0][0][i - numSamplesToJumpForward];
-					}
+					advanceInterpolationBuffer(numSamplesToJumpForward);
 
 					if (numChannels == 2) {
-						for (int32_t i = kInterpolationMaxNumSamples - 1; i >= numSamplesToJumpForward; i--) {
-							interpolationBuffer[1][0][i] = interpolationBuffer[1][0][i - numSamplesToJumpForward];
-						}
-
 						numSamplesToJumpForward--;
 
 						while (true) {
-							interpolationBuffer[0][0][numSamplesToJumpForward] = sourceL;
-							interpolationBuffer[1][0][numSamplesToJumpForward] =
-							    *(int16_t*)(currentPlayPosNow + byteDepth);
+							setInterpolationBufferValue(0, numSamplesToJumpForward, sourceL);
+							setInterpolationBufferValue(1, numSamplesToJumpForward,
+							                            *(int16_t*)(currentPlayPosNow + byteDepth));
 							currentPlayPosNow += jumpAmount;
 							if (!numSamplesToJumpForward) {
 								goto skipFirstSmooth;
@@ -1062,7 +1262,7 @@ void SampleLowLevelReader::readSamplesResampled(int32_t** __restrict__ oscBuffer
 
 						while (true) {
 							currentPlayPosNow += jumpAmount;
-							interpolationBuffer[0][0][numSamplesToJumpForward] = sourceL;
+							setInterpolationBufferValue(0, numSamplesToJumpForward, sourceL);
 							if (!numSamplesToJumpForward) {
 								goto skipFirstSmooth;
 							}
@@ -1078,7 +1278,12 @@ void SampleLowLevelReader::readSamplesResampled(int32_t** __restrict__ oscBuffer
 
 skipFirstSmooth:
 			int32_t sampleRead[2];
-			interpolate(sampleRead, numChannels, whichKernel);
+			if (interpolationBufferSize == kInterpolationMaxNumSamples) {
+				interpolate(sampleRead, numChannels, whichKernel);
+			}
+			else {
+				interpolateReduced(sampleRead, numChannels, whichKernel);
+			}
 
 			int32_t existingValueL = *oscBufferPosNow;
 
@@ -1124,6 +1329,8 @@ skipFirstSmooth:
 
 	// Linear interpolation
 	else {
+		int32_t const prefetchDistance = getPrefetchDistance(jumpAmount);
+
 		if (!*doneAnySamplesYet) {
 			*doneAnySamplesYet = true;
 			goto skipFirstLinear;
@@ -1131,6 +1338,7 @@ skipFirstSmooth:
 
 		do {
 			if (stillGotActualData) {
+				__builtin_prefetch(currentPlayPos + prefetchDistance);
 				jumpForwardLinear(numChannels, byteDepth, bitMask, jumpAmount, phaseIncrement);
 			}
 			else {
@@ -1172,6 +1380,81 @@ skipFirstLinear:
 	}
 }
 
+// The next 8 values - 4 stereo frames or 8 mono samples - starting at pos, which is where the first one actually
+// begins, each with the sample in the top bits just like readSamplesNative()'s 32-bit reads give
+template <int32_t byteDepth>
+[[gnu::always_inline]] static inline void loadEightSamples(char const* pos, int32x4_t* first, int32x4_t* second) {
+	if constexpr (byteDepth == 2) {
+		int16x8_t values = vreinterpretq_s16_u8(vld1q_u8((uint8_t const*)pos));
+		*first = vshll_n_s16(vget_low_s16(values), 16);
+		*second = vshll_n_s16(vget_high_s16(values), 16);
+	}
+	else {
+		// Split into each one's low, middle and high bytes, then put back together a byte further up, with a 0 below
+		uint8x8x3_t bytes = vld3_u8((uint8_t const*)pos);
+		uint8x8x2_t lowHalves = vzip_u8(vdup_n_u8(0), bytes.val[0]);
+		uint8x8x2_t highHalves = vzip_u8(bytes.val[1], bytes.val[2]);
+		uint16x8x2_t words = vzipq_u16(vreinterpretq_u16_u8(vcombine_u8(lowHalves.val[0], lowHalves.val[1])),
+		                               vreinterpretq_u16_u8(vcombine_u8(highHalves.val[0], highHalves.val[1])));
+		*first = vreinterpretq_s32_u16(words.val[0]);
+		*second = vreinterpretq_s32_u16(words.val[1]);
+	}
+}
+
+// Forwards, with no condensing, 8 values at a time: the samples are already interleaved the same as the buffer is, so
+// it's just a matter of lining the amplitude ramp up with them. Moves the play position, buffer position and amplitude on
+// past however many whole blocks there were, leaving the rest for the scalar loop. Exactly the same result as it gives
+template <int32_t byteDepth>
+static void readSamplesNativeVectorized(char* __restrict__* currentPlayPos, int32_t* __restrict__* bufferPos,
+                                        int32_t numSamplesTotal, int32_t numChannels, int32_t* amplitude,
+                                        int32_t amplitudeIncrement, int32_t prefetchDistance) {
+	int32_t const samplesPerBlock = 8 >> (numChannels - 1);
+	int32_t const numBlocks = numSamplesTotal / samplesPerBlock;
+	if (!numBlocks) {
+		return;
+	}
+
+	int32_t const bytesPerBlock = byteDepth * 8;
+	// The 32-bit reads are from 4 - byteDepth bytes before each sample actually begins
+	char const* __restrict__ pos = *currentPlayPos + 4 - byteDepth;
+	int32_t* __restrict__ output = *bufferPos;
+
+	// The scalar loop adds the increment before using the amplitude, so the first sample gets one increment's worth
+	int32_t amplitudes[8];
+	for (int32_t i = 0; i < 8; i++) {
+		amplitudes[i] = *amplitude + amplitudeIncrement * ((i >> (numChannels - 1)) + 1);
+	}
+	int32x4_t amplitudeFirst = vld1q_s32(&amplitudes[0]);
+	int32x4_t amplitudeSecond = vld1q_s32(&amplitudes[4]);
+	int32x4_t const amplitudeStep = vdupq_n_s32(amplitudeIncrement * samplesPerBlock);
+
+	for (int32_t b = 0; b < numBlocks; b++) {
+		__builtin_prefetch(pos + prefetchDistance);
+
+		int32x4_t samplesFirst;
+		int32x4_t samplesSecond;
+		loadEightSamples<byteDepth>(pos, &samplesFirst, &samplesSecond);
+		pos += bytesPerBlock;
+
+		// There's always a spare bit at the bottom of the samples, so halving them and then doubling multiplying gives
+		// exactly smmlar's rounded (sample * amplitude) >> 32
+		int32x4_t outputFirst = vld1q_s32(output);
+		int32x4_t outputSecond = vld1q_s32(output + 4);
+		outputFirst = vaddq_s32(outputFirst, vqrdmulhq_s32(vshrq_n_s32(samplesFirst, 1), amplitudeFirst));
+		outputSecond = vaddq_s32(outputSecond, vqrdmulhq_s32(vshrq_n_s32(samplesSecond, 1), amplitudeSecond));
+		vst1q_s32(output, outputFirst);
+		vst1q_s32(output + 4, outputSecond);
+		output += 8;
+
+		amplitudeFirst = vaddq_s32(amplitudeFirst, amplitudeStep);
+		amplitudeSecond = vaddq_s32(amplitudeSecond, amplitudeStep);
+	}
+
+	*amplitude += amplitudeIncrement * numBlocks * samplesPerBlock;
+	*currentPlayPos += numBlocks * bytesPerBlock;
+	*bufferPos = output;
+}
+
 void SampleLowLevelReader::readSamplesNative(int32_t** __restrict__ bufferPos, int32_t numSamplesTotal, Sample* sample,
                                              int32_t jumpAmount, int32_t numChannels,
                                              int32_t numChannelsAfterCondensing, int32_t* __restrict__ amplitude,
@@ -1184,8 +1467,25 @@ void SampleLowLevelReader::readSamplesNative(int32_t** __restrict__ bufferPos, i
 
 	int32_t const byteDepth = sample->byteDepth;
 	uint32_t const bitMask = sample->bitMask;
+	int32_t const prefetchDistance = getPrefetchDistance(jumpAmount);
+
+	// Playing forwards, which is nearly always, with nothing to condense, most of it can be done with NEON
+	if (jumpAmount == byteDepth * numChannels && numChannelsAfterCondensing == numChannels) {
+		if (byteDepth == 2) {
+			readSamplesNativeVectorized<2>(&currentPlayPosNow, &bufferPosNow, numSamplesTotal, numChannels, amplitude,
+			                               amplitudeIncrement, prefetchDistance);
+		}
+		else if (byteDepth == 3) {
+			readSamplesNativeVectorized<3>(&currentPlayPosNow, &bufferPosNow, numSamplesTotal, numChannels, amplitude,
+			                               amplitudeIncrement, prefetchDistance);
+		}
+	}
+
+	while (bufferPosNow != bufferEndNow) {
+		// One per sample rather than one per cache line - working out when we've crossed into a new line costs more
+		// than the PLDs for a line that's already on its way
+		__builtin_prefetch(currentPlayPosNow + prefetchDistance);
 
-	do {
 		int32_t sampleReadL = *(int32_t*)currentPlayPosNow;
 
 		int32_t existingValueL = *bufferPosNow;
@@ -1216,7 +1516,7 @@ void SampleLowLevelReader::readSamplesNative(int32_t** __restrict__ bufferPos, i
 			*bufferPosNow = multiply_accumulate_32x32_rshift32_rounded(existingValueR, sampleReadR, *amplitude);
 			bufferPosNow++;
 		}
-	} while (bufferPosNow != bufferEndNow);
+	}
 
 	*bufferPos = bufferPosNow;
 	currentPlayPos = currentPlayPosNow;
@@ -1267,6 +1567,15 @@ bool SampleLowLevelReader::readSamplesForTimeStretching(
 
 void SampleLowLevelReader::cloneFrom(SampleLowLevelReader* other, bool stealReasons) {
 
+	// Read-ahead only comes across if it's being stolen - otherwise we'll just get our own next time we move on
+	unassignReadAhead();
+	if (stealReasons) {
+		memcpy(readAheadClusters, other->readAheadClusters, other->numReadAheadClusters * sizeof(Cluster*));
+		numReadAheadClusters = other->numReadAheadClusters;
+		other->numReadAheadClusters = 0;
+	}
+	readAheadPhaseIncrement = other->readAheadPhaseIncrement;
+
 	for (int32_t l = 0; l < kNumClustersLoadedAhead; l++) {
 		if (clusters[l]) {
 			audioFileManager.removeReasonFromCluster(clusters[l], "E131");
@@ -1285,6 +1594,7 @@ void SampleLowLevelReader::cloneFrom(SampleLowLevelReader* other, bool stealReas
 	}
 
 	memcpy(interpolationBuffer, other->interpolationBuffer, sizeof(interpolationBuffer));
+	interpolationBufferPos = other->interpolationBufferPos;
 
 	oscPos = other->oscPos;
 	currentPlayPos = other->currentPlayPos;
@@ -23,8 +23,6 @@
 #define REASSESSMENT_ACTION_STOP_OR_LOOP 0
 #define REASSESSMENT_ACTION_NEXT_CLUSTER 1
 
-typedef __simd64_int16_t int16x4_t;
-
 class VoiceSamplePlaybackGuide;
 class Voice;
 class Sample;
@@ -42,6 +40,7 @@ public:
 	                       int32_t phaseIncrement);
 	void jumpForwardZeroes(int32_t bufferSize, int32_t numChannels, int32_t phaseIncrement);
 	void interpolate(int32_t* sampleRead, int32_t numChannels, int32_t whichKernel);
+	void interpolateReduced(int32_t* sampleRead, int32_t numChannels, int32_t whichKernel);
 	void interpolateLinear(int32_t* sampleRead, int32_t numChannels, int32_t whichKernel);
 	void fillInterpolationBufferRetrospectively(Sample* sample, int32_t bufferSize, int32_t startI,
 	                                            int32_t playDirection);
@@ -98,12 +97,54 @@ public:
 	uint8_t reassessmentAction;
 	int8_t interpolationBufferSizeLastTime; // 0 if was previously switched off
 
-	int16x4_t interpolationBuffer[2][kInterpolationMaxNumSamples >> 2];
+	// The last kInterpolationMaxNumSamples values read for each channel, as a ring going backwards from
+	// interpolationBufferPos. Each value is stored twice, kInterpolationMaxNumSamples apart, so the whole history can
+	// always be read in one go, newest first, starting at interpolationBufferPos.
+	int16_t interpolationBuffer[2][kInterpolationMaxNumSamples * 2];
+	uint8_t interpolationBufferPos;
+
+	// age 0 is the newest value
+	inline int16_t getInterpolationBufferValue(int32_t channel, int32_t age) {
+		return interpolationBuffer[channel][interpolationBufferPos + age];
+	}
+
+	inline void setInterpolationBufferValue(int32_t channel, int32_t age, int16_t value) {
+		int32_t pos = (interpolationBufferPos + age) & (kInterpolationMaxNumSamples - 1);
+		interpolationBuffer[channel][pos] = value;
+		interpolationBuffer[channel][pos + kInterpolationMaxNumSamples] = value;
+	}
+
+	// Ages everything by numSamples, which must be no more than kInterpolationMaxNumSamples. The values with ages
+	// below numSamples are then the oldest ones, and need setting.
+	inline void advanceInterpolationBuffer(int32_t numSamples) {
+		interpolationBufferPos = (interpolationBufferPos - numSamples) & (kInterpolationMaxNumSamples - 1);
+	}
 
 	Cluster* clusters[kNumClustersLoadedAhead];
 
+	// Beyond clusters[], in play order - however many more getNumClustersReadAheadWanted() reckons we need
+	Cluster* readAheadClusters[kMaxNumClustersReadAhead];
+	int32_t numReadAheadClusters;
+	int32_t readAheadPhaseIncrement; // As last seen by considerUpcomingWindow()
+
+	static int32_t numReadAheadClustersTotal;
+
+	// How far ahead of the play position, in bytes, the read loops ask the cache for sample data with a PLD. The
+	// Cortex-A9's own prefetcher only really picks up ascending streams, so reverse playback needs to reach further.
+	// Not constants so the DSP benchmark can try others
+	static int32_t prefetchDistanceForward;
+	static int32_t prefetchDistanceReverse;
+
+	// jumpAmount's sign is the play direction
+	static inline int32_t getPrefetchDistance(int32_t jumpAmount) {
+		return (jumpAmount >= 0) ? prefetchDistanceForward : -prefetchDistanceReverse;
+	}
+
 private:
 	bool assignClusters(SamplePlaybackGuide* guide, Sample* sample, int32_t clusterIndex, int32_t priorityRating);
+	int32_t getNumClustersReadAheadWanted(Sample* sample);
+	void topUpReadAhead(SamplePlaybackGuide* guide, Sample* sample, int32_t priorityRating);
+	void unassignReadAhead();
 	bool fillInterpolationBufferForward(SamplePlaybackGuide* guide, Sample* sample, int32_t interpolationBufferSize,
 	                                    bool loopingAtLowLevel, int32_t numSpacesToFill, int32_t priorityRating);
 };
@@ -0,0 +1,98 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "model/sample/sample_peak_pyramid.h"
+#include "definitions_cxx.hpp"
+#include "model/sample/sample.h"
+#include "storage/audio/audio_file_manager.h"
+#include <algorithm>
+
+SamplePeakPyramid::SamplePeakPyramid(Sample* newSample) {
+	sample = newSample;
+}
+
+// Nothing else depends on us - the Sample just goes back to reading its audio to draw it. But not while we're still
+// being filled in, before the Sample has been given us
+bool SamplePeakPyramid::mayBeStolen(void* thingNotToStealFrom) {
+	return (sample->peakPyramid == this);
+}
+
+void SamplePeakPyramid::steal(char const* errorCode) {
+	sample->peakPyramidStolen();
+}
+
+// Same standing as a perc cache: compacted data which takes reading the whole Sample to work out again
+int32_t SamplePeakPyramid::getAppropriateQueue() {
+	return sample->numReasonsToBeLoaded ? STEALABLE_QUEUE_CURRENT_SONG_SAMPLE_DATA_PERC_CACHE
+	                                    : STEALABLE_QUEUE_NO_SONG_SAMPLE_DATA_PERC_CACHE;
+}
+
+// Assume the worst - that there's no file on the card and the whole Sample has to be read again
+uint32_t SamplePeakPyramid::getReloadCost() {
+	return ((sample->lengthInSamples * sample->numChannels * sample->byteDepth) >> audioFileManager.clusterSizeMagnitude)
+	       + 1;
+}
+
+int8_t* SamplePeakPyramid::getLevel(int32_t level) {
+	int8_t* peaks = (int8_t*)(this + 1);
+	for (int32_t l = 0; l < level; l++) {
+		peaks += getNumEntries(sample->lengthInSamples, l) << 1;
+	}
+	return peaks;
+}
+
+int32_t SamplePeakPyramid::getNumEntries(uint64_t lengthInSamples, int32_t level) {
+	int32_t magnitude = kPeakPyramidLevelMagnitudes[level];
+	return (lengthInSamples + (1 << magnitude) - 1) >> magnitude;
+}
+
+int32_t SamplePeakPyramid::getDataSize(uint64_t lengthInSamples) {
+	int32_t size = 0;
+	for (int32_t l = 0; l < kNumPeakPyramidLevels; l++) {
+		size += getNumEntries(lengthInSamples, l) << 1;
+	}
+	return size;
+}
+
+// Gets the min and max, scaled up to full 32-bit range, of the samples from startSample to endSample (exclusive), from
+// the coarsest level no coarser than maxGranularity. The edges get rounded outwards to that level's entries. Returns
+// false if even the finest level is too coarse
+bool SamplePeakPyramid::getPeaks(int32_t startSample, int32_t endSample, int32_t maxGranularity, int32_t* min,
+                                 int32_t* max) {
+	int32_t level = kNumPeakPyramidLevels - 1;
+	while ((1 << kPeakPyramidLevelMagnitudes[level]) > maxGranularity) {
+		if (!level) {
+			return false;
+		}
+		level--;
+	}
+
+	int32_t magnitude = kPeakPyramidLevelMagnitudes[level];
+	int8_t* peaks = getLevel(level);
+	int32_t endEntry = std::min((endSample - 1) >> magnitude, getNumEntries(sample->lengthInSamples, level) - 1);
+
+	int32_t minHere = 127;
+	int32_t maxHere = -128;
+	for (int32_t e = startSample >> magnitude; e <= endEntry; e++) {
+		minHere = std::min<int32_t>(minHere, peaks[e << 1]);
+		maxHere = std::max<int32_t>(maxHere, peaks[(e << 1) + 1]);
+	}
+
+	*min = minHere << 24;
+	*max = maxHere << 24;
+	return true;
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "memory/stealable.h"
+#include <cstdint>
+
+class Sample;
+
+constexpr int32_t kNumPeakPyramidLevels = 3;
+
+// Each level has one min and one max for every (1 << its magnitude) samples
+constexpr int32_t kPeakPyramidLevelMagnitudes[kNumPeakPyramidLevels] = {8, 12, 16};
+
+// The min and max of a Sample's waveform at a few fixed granularities, so WaveformRenderer can draw it zoomed out
+// without reading all the audio in. Lives in one stealable allocation: this object, then each level in turn, each
+// being pairs of int8 min and max, scaled like SampleCluster::minValue and maxValue. Both channels count.
+class SamplePeakPyramid final : public Stealable {
+public:
+	SamplePeakPyramid(Sample* newSample);
+
+	bool mayBeStolen(void* thingNotToStealFrom = nullptr);
+	void steal(char const* errorCode);
+	int32_t getAppropriateQueue();
+	uint32_t getReloadCost() override;
+
+	bool getPeaks(int32_t startSample, int32_t endSample, int32_t maxGranularity, int32_t* min, int32_t* max);
+	int8_t* getLevel(int32_t level);
+
+	static int32_t getNumEntries(uint64_t lengthInSamples, int32_t level);
+	static int32_t getDataSize(uint64_t lengthInSamples);
+
+	Sample* sample;
+};
@@ -29,6 +29,7 @@
 #include "processing/engines/audio_engine.h"
 #include "storage/audio/audio_file_manager.h"
 #include "storage/cluster/cluster.h"
+#include "storage/folder_index.h"
 #include "storage/storage_manager.h"
 #include "util/functions.h"
 #include "util/misc.h"
@@ -63,6 +64,7 @@ SampleRecorder::SampleRecorder() {
 	currentRecordClusterIndex =
 	    -1; // Put things in valid state so if we get destructed before any recording, it's all ok
 	firstUnwrittenClusterIndex = 0;
+	numClustersReserved = 0;
 }
 
 SampleRecorder::~SampleRecorder() {
@@ -161,7 +163,7 @@ gotError:
 	currentRecordCluster->numReasonsHeldBySampleRecorder++;
 
 	// Give the sample some stuff
-	sample->audioDataStartPosBytes = recordingExtraMargins ? 112 : 44;
+	sample->audioDataStartPosBytes = recordingExtraMargins ? 124 : 56;
 	sample->byteDepth = 3;
 	sample->numChannels = newNumChannels;
 	sample->lengthInSamples = 0x8FFFFFFFFFFFFFFF;
@@ -297,6 +299,11 @@ gotError:
 		writeInt32(&writePos, 0);                            // Play count - 0 means continuous
 	}
 
+	// Normalisation chunk - our own. Left at 0 unless finalizeRecordedFile() decides to normalise ---------------
+	writeInt32(&writePos, 0x6e676c64); // "dlgn"
+	writeInt32(&writePos, 4);          // Chunk size
+	writeInt32(&writePos, 0);          // Left-shift to apply to all values as they're read
+
 	// Data chunk ------------------------------------------------------
 	writeInt32(&writePos, 0x61746164);                          // "data"
 	writeInt32(&writePos, audioDataLengthBytesAsWrittenToFile); // Chunk size
@@ -345,6 +352,7 @@ aborted:
 		if (!filePathCreated.isEmpty()) {
 
 			FRESULT result = f_unlink(filePathCreated.get());
+			FolderIndex::folderChanged(filePathCreated.get());
 
 			// If this was the most recent recording in this category, tick the counter backwards - so long as
 			// either the delete was successful or it was for an AudioClip, which means the file is in the TEMP folder and can be overwritten anyway
@@ -423,6 +431,9 @@ aborted:
 				goto aborted; // In case aborted during
 			}
 
+			fileSectorBuffer.attach(&file);
+			reserveContiguousExtent();
+
 			// Ok, the Sample still exists.
 			sample->filePath.set(&filePath);                                 // Can't fail!
 			sample->tempFilePathForRecording.set(&tempFilePathForRecording); // Can't fail!
@@ -435,22 +446,16 @@ aborted:
 			haveAddedSampleToArray = true;
 		}
 
-		// Might want to write just one cluster
+		// Completed clusters are left for writeCompletedClusters(), which the AudioEngine calls for every recorder in
+		// turn, in the order they'll go on the card. Until they're all written, it's too soon to finalize
 		if (firstUnwrittenClusterIndex < currentRecordClusterIndex) {
-			errorToReturn = writeOneCompletedCluster();
+			goto allDoneForNow;
+		}
+	}
 
-			if (errorToReturn) {
+	if (errorToReturn) {
 gotError:
-				hadCardError = true;
-			}
-
-			else {
-				// If more clusters still to write, come back later to do them
-				if (true || firstUnwrittenClusterIndex < currentRecordClusterIndex) {
-					goto allDoneForNow;
-				}
-			}
-		}
+		hadCardError = true;
 	}
 
 	// If we've actually finished recording...
@@ -481,6 +486,44 @@ allDoneForNow:
 	return errorToReturn;
 }
 
+bool SampleRecorder::hasCompletedClustersToWrite() {
+	return (status < RECORDER_STATUS_COMPLETE && !hadCardError && haveAddedSampleToArray
+	        && firstUnwrittenClusterIndex < currentRecordClusterIndex);
+}
+
+// Where on the card the next completed cluster will go. Past the reserved extent, FatFs picks as it goes, but it'll
+// most likely be the cluster after the last one. 0xFFFFFFFF if there's no telling
+uint32_t SampleRecorder::getNextWriteSector() {
+	FATFS* fs = &fileSystemStuff.fileSystem;
+	if (firstUnwrittenClusterIndex < numClustersReserved) {
+		return reservedExtentFirstSector + firstUnwrittenClusterIndex * fs->csize;
+	}
+	if (file.clust >= 2) {
+		return clst2sect(fs, file.clust) + fs->csize;
+	}
+	return 0xFFFFFFFF;
+}
+
+// Writes up to maxNumClusters of the completed clusters, one after the other - so within the reserved extent, to
+// consecutive sectors
+int32_t SampleRecorder::writeCompletedClusters(int32_t maxNumClusters) {
+	while (maxNumClusters-- && firstUnwrittenClusterIndex < currentRecordClusterIndex) {
+
+		// Could have been aborted while the card was busy with the last one
+		if (status == RECORDER_STATUS_ABORTED) {
+			break;
+		}
+
+		int32_t error = writeOneCompletedCluster();
+		if (error) {
+			hadCardError = true;
+			return error;
+		}
+	}
+
+	return NO_ERROR;
+}
+
 int32_t SampleRecorder::writeAnyCompletedClusters() {
 	while (firstUnwrittenClusterIndex < currentRecordClusterIndex) {
 
@@ -585,6 +628,14 @@ int32_t SampleRecorder::finalizeRecordedFile() {
 		currentRecordCluster = NULL; // But currentRecordClusterIndex now refers to a cluster that'll never exist
 	}
 
+	// If everything fit in our reserved extent, the file is still the size of the whole extent
+	if (numClustersReserved && firstUnwrittenClusterIndex <= numClustersReserved) {
+		int32_t error = truncateFileDownToSize(bytesWrittenToReservedExtent);
+		if (error) {
+			return error;
+		}
+	}
+
 	uint32_t idealFileSizeBeforeAction = sample->audioDataStartPosBytes + sample->audioDataLengthBytes;
 	uint32_t dataLengthBeforeAction = sample->audioDataLengthBytes;
 
@@ -592,9 +643,10 @@ int32_t SampleRecorder::finalizeRecordedFile() {
 	int32_t action = 0;
 	int32_t lshiftAmount = 0;
 
-	if (allowFileAlterationAfter
-	    && idealFileSizeBeforeAction <= 67108864) { // Arbitrarily, don't alter files bigger than 64MB
-		if (recordingNumChannels == 1) {
+	if (allowFileAlterationAfter) {
+		// Removing a channel rewrites the whole file, so arbitrarily, don't do that to files bigger than 64MB.
+		// Normalising costs nothing extra whatever the size
+		if (recordingNumChannels == 1 || idealFileSizeBeforeAction > 67108864) {
 			action = 0;
 		}
 		else {
@@ -628,13 +680,15 @@ int32_t SampleRecorder::finalizeRecordedFile() {
 		for (lshiftAmount = 0; ((uint32_t)2147483648 >> (lshiftAmount + 1)) > maxPeak; lshiftAmount++) {}
 	}
 	uint32_t dataLengthAfterAction = action ? (dataLengthBeforeAction >> 1) : dataLengthBeforeAction;
+	bool wroteLShift = false;
 
 	// TODO: in a perfect world, where we're not deleting a channel, we'd go backwards from the last Cluster, because that's the most likely to still be in memory
 
-	// If some processing of the recorded audio data needs to happen...
-	if (lshiftAmount || action) {
+	// If a channel needs removing, that means rewriting the whole file - and any normalising gets done along the way
+	if (action) {
 
 		FRESULT result = f_close(&file);
+		fileSectorBuffer.release();
 		if (result) {
 			return ERROR_SD_CARD;
 		}
@@ -645,7 +699,8 @@ int32_t SampleRecorder::finalizeRecordedFile() {
 		}
 	}
 
-	// Or if no action or shifting was required...
+	// Otherwise, normalising is just noted in the header, along with the final length, and done as each Cluster loads -
+	// so it's only ever the first sector that gets written again
 	else {
 
 		// If we made the file too long, because we then compensated for button latency and are throwing away the last little bit, then truncate it
@@ -658,13 +713,14 @@ int32_t SampleRecorder::finalizeRecordedFile() {
 		}
 
 		FRESULT result = f_close(&file);
+		fileSectorBuffer.release();
 		if (result) {
 			return ERROR_SD_CARD;
 		}
 
 		// If the actual audio data length we ended up with is not the same as was written in the headers in the first cluster (very likely; various reasons)
 		if (sample->audioDataLengthBytes != audioDataLengthBytesAsWrittenToFile
-		    || (recordingExtraMargins && sample->fileLoopEndSamples != loopEndSampleAsWrittenToFile)) {
+		    || (recordingExtraMargins && sample->fileLoopEndSamples != loopEndSampleAsWrittenToFile) || lshiftAmount) {
 
 			// Update data length as written in first cluster
 			SampleCluster* firstSampleCluster = sample->clusters.getElement(0);
@@ -687,11 +743,14 @@ int32_t SampleRecorder::finalizeRecordedFile() {
 				audioDataLengthBytesAsWrittenToFile = sample->audioDataLengthBytes;
 				loopEndSampleAsWrittenToFile = sample->fileLoopEndSamples;
 				updateDataLengthInFirstCluster(cluster);
+				*(uint32_t*)&cluster->data[sample->audioDataStartPosBytes - 12] = lshiftAmount;
 
 				// Write just that one first sector back to the card
-				disk_write(0, (BYTE*)cluster->data, firstSampleCluster->sdAddress, 1);
+				DRESULT diskResult = disk_write(0, (BYTE*)cluster->data, firstSampleCluster->sdAddress, 1);
 
-				// If that failed, well, that's a shame, but we don't need to do anything
+				// If that failed, well, that's a shame, but we don't need to do anything - other than not normalise
+				// what's in RAM either, so the audio doesn't change when the file's next loaded
+				wroteLShift = (diskResult == RES_OK);
 
 				// Some bug-hunting
 				if (!cluster->numReasonsHeldBySampleRecorder) {
@@ -711,6 +770,12 @@ int32_t SampleRecorder::finalizeRecordedFile() {
 	    * (sample->byteDepth
 	       * sample->numChannels); // Ensure whole number of samples (surely it already would be though?)
 
+	if (wroteLShift && lshiftAmount) {
+		sample->rawDataFormat = RAW_DATA_LSHIFTED_24;
+		sample->rawDataLShift = lshiftAmount;
+		sample->convertLoadedClustersToNewFormat();
+	}
+
 	if (sample->tempFilePathForRecording.isEmpty()) {
 		sampleBrowser.lastFilePathLoaded.set(&sample->filePath);
 	}
@@ -735,12 +800,65 @@ void SampleRecorder::updateDataLengthInFirstCluster(Cluster* cluster) {
 
 extern int32_t pendingGlobalMIDICommandNumClustersWritten;
 
+// Most recordings are shorter than this. If one isn't, once it's used this up it just carries on growing the normal way
+constexpr uint32_t kRecordingExtentToReserve = 64 << 20;
+
+// Call straight after creating the file. If there's no contiguous free space big enough, we just don't get an extent
+void SampleRecorder::reserveContiguousExtent() {
+	numClustersReserved = 0;
+
+	FATFS* fs = &fileSystemStuff.fileSystem;
+	uint32_t bytesPerCluster = (uint32_t)fs->csize << 9;
+	uint32_t numClustersWanted = kRecordingExtentToReserve / bytesPerCluster;
+
+	// Don't take more than half of what's left, so other things being recorded at the same time still have room
+	if (fs->free_clst <= fs->n_fatent - 2) {
+		numClustersWanted = std::min<uint32_t>(numClustersWanted, fs->free_clst >> 1);
+	}
+	if (!numClustersWanted) {
+		return;
+	}
+
+	FRESULT result = f_expand(&file, (FSIZE_t)numClustersWanted * bytesPerCluster, 1);
+	if (result != FR_OK) {
+		Debug::println("no contiguous extent for recording");
+		return;
+	}
+
+	reservedExtentFirstSector = clst2sect(fs, file.obj.sclust);
+	numClustersReserved = numClustersWanted;
+	bytesWrittenToReservedExtent = 0;
+}
+
 // You'll want to remove the "reason" after calling this
 int32_t SampleRecorder::writeCluster(int32_t clusterIndex, int32_t numBytes) {
 	//Debug::println("writeCluster");
 
 	SampleCluster* sampleCluster = sample->clusters.getElement(clusterIndex);
 
+	if (clusterIndex < numClustersReserved) {
+		uint32_t sdAddress = reservedExtentFirstSector + clusterIndex * fileSystemStuff.fileSystem.csize;
+		DRESULT result =
+		    disk_write(0, (BYTE*)sampleCluster->cluster->data, sdAddress, ((uint32_t)numBytes + 511) >> 9);
+		if (result != RES_OK) {
+			return ERROR_SD_CARD;
+		}
+
+		// MUST re-get this - see below
+		sampleCluster = sample->clusters.getElement(clusterIndex);
+		sampleCluster->sdAddress = sdAddress;
+		bytesWrittenToReservedExtent = (clusterIndex << audioFileManager.clusterSizeMagnitude) + numBytes;
+		return NO_ERROR;
+	}
+
+	// If we've just run past the end of the extent, FatFs needs to carry on from there
+	if (numClustersReserved && clusterIndex == numClustersReserved) {
+		FRESULT result = f_lseek(&file, (FSIZE_t)numClustersReserved << audioFileManager.clusterSizeMagnitude);
+		if (result) {
+			return ERROR_SD_CARD;
+		}
+	}
+
 	UINT numBytesWritten;
 	FRESULT result = f_write(&file, sampleCluster->cluster->data, numBytes, &numBytesWritten);
 
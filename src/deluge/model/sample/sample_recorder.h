@@ -19,6 +19,7 @@
 
 #include "definitions_cxx.hpp"
 #include "dsp/stereo_sample.h"
+#include "storage/file_sector_buffer.h"
 #include "util/d_string.h"
 #include <cstdint>
 
@@ -49,6 +50,9 @@ public:
 	              bool shouldRecordExtraMargins, AudioRecordingFolder newFolderID, int32_t buttonPressLatency);
 	void feedAudio(int32_t* inputAddress, int32_t numSamples, bool applyGain = false);
 	int32_t cardRoutine();
+	bool hasCompletedClustersToWrite();
+	uint32_t getNextWriteSector();
+	int32_t writeCompletedClusters(int32_t maxNumClusters);
 	void endSyncedRecording(int32_t buttonLatencyForTempolessRecording);
 	bool inputLooksDifferential();
 	bool inputHasNoRightChannel();
@@ -116,10 +120,18 @@ public:
 	int32_t* sourcePos;
 
 	FIL file;
+	FileSectorBuffer fileSectorBuffer; // Just while file is open for recording
+
+	// If we managed to reserve a contiguous run of clusters for the file up front, Clusters falling within it get
+	// written straight to their sectors, without FatFs having to follow or grow the FAT chain
+	uint32_t reservedExtentFirstSector;
+	int32_t numClustersReserved;
+	uint32_t bytesWrittenToReservedExtent;
 
 private:
 	void setExtraBytesOnPreviousCluster(Cluster* currentCluster, int32_t currentClusterIndex);
 	int32_t writeCluster(int32_t clusterIndex, int32_t numBytes);
+	void reserveContiguousExtent();
 	int32_t alterFile(int32_t action, int32_t lshiftAmount, uint32_t idealFileSizeBeforeAction,
 	                  uint64_t dataLengthAfterAction);
 	int32_t finalizeRecordedFile();
@@ -21,6 +21,7 @@
 #include "hid/display/display.h"
 #include "storage/storage_manager.h"
 #include "util/d_string.h"
+#include <algorithm>
 #include <cstring>
 #include <string_view>
 
@@ -77,6 +78,124 @@ static void SetupSyncScalingActionSetting(RuntimeFeatureSetting& setting, std::s
 	};
 }
 
+static void SetupRenderBlockSizeSetting(RuntimeFeatureSetting& setting, std::string_view displayName,
+                                        std::string_view xmlName, RuntimeFeatureStateRenderBlockSize def) {
+	setting.displayName = displayName;
+	setting.xmlName = xmlName;
+	setting.value = static_cast<uint32_t>(def);
+
+	setting.options = {
+	    {
+	        .displayName = display->haveOLED() ? "Variable" : "VARI",
+	        .value = RuntimeFeatureStateRenderBlockSize::Variable,
+	    },
+	    {
+	        .displayName = "32",
+	        .value = RuntimeFeatureStateRenderBlockSize::Block32,
+	    },
+	    {
+	        .displayName = "64",
+	        .value = RuntimeFeatureStateRenderBlockSize::Block64,
+	    },
+	};
+}
+
+static void SetupCompressorDetectionSetting(RuntimeFeatureSetting& setting, std::string_view displayName,
+                                            std::string_view xmlName, RuntimeFeatureStateCompressorDetection def) {
+	setting.displayName = displayName;
+	setting.xmlName = xmlName;
+	setting.value = static_cast<uint32_t>(def);
+
+	setting.options = {
+	    {
+	        .displayName = display->haveOLED() ? "Every sample" : "SAMP",
+	        .value = RuntimeFeatureStateCompressorDetection::EveryFrame,
+	    },
+	    {
+	        .displayName = display->haveOLED() ? "Block" : "BLOC",
+	        .value = RuntimeFeatureStateCompressorDetection::BlockRate,
+	    },
+	    {
+	        .displayName = display->haveOLED() ? "Lookahead" : "LOOK",
+	        .value = RuntimeFeatureStateCompressorDetection::BlockRateLookahead,
+	    },
+	};
+}
+
+static void SetupControlRateSetting(RuntimeFeatureSetting& setting, std::string_view displayName,
+                                    std::string_view xmlName, RuntimeFeatureStateControlRate def) {
+	setting.displayName = displayName;
+	setting.xmlName = xmlName;
+	setting.value = static_cast<uint32_t>(def);
+
+	setting.options = {
+	    {
+	        .displayName = display->haveOLED() ? "Window" : "WIND",
+	        .value = RuntimeFeatureStateControlRate::ControlRateWindow,
+	    },
+	    {
+	        .displayName = "32",
+	        .value = RuntimeFeatureStateControlRate::ControlRate32,
+	    },
+	    {
+	        .displayName = "16",
+	        .value = RuntimeFeatureStateControlRate::ControlRate16,
+	    },
+	};
+}
+
+static void SetupEngineProfileSetting(RuntimeFeatureSetting& setting, std::string_view displayName,
+                                      std::string_view xmlName, RuntimeFeatureStateEngineProfile def) {
+	setting.displayName = displayName;
+	setting.xmlName = xmlName;
+	setting.value = static_cast<uint32_t>(def);
+
+	setting.options = {
+	    {
+	        .displayName = display->haveOLED() ? "Custom" : "CUST",
+	        .value = RuntimeFeatureStateEngineProfile::EngineCustom,
+	    },
+	    {
+	        .displayName = display->haveOLED() ? "Studio" : "STUD",
+	        .value = RuntimeFeatureStateEngineProfile::EngineStudio,
+	    },
+	    {
+	        .displayName = display->haveOLED() ? "Live" : "LIVE",
+	        .value = RuntimeFeatureStateEngineProfile::EngineLive,
+	    },
+	    {
+	        .displayName = display->haveOLED() ? "Max polyphony" : "POLY",
+	        .value = RuntimeFeatureStateEngineProfile::EngineMaxPolyphony,
+	    },
+	};
+}
+
+struct EngineProfileDefinition {
+	std::string_view name;
+	int32_t cullSampleLimit;
+	std::array<uint32_t, kEngineProfileSettings.size()> values; // For each of kEngineProfileSettings
+};
+
+// Studio spends CPU on smoother modulation and compression, and culls at the original point. Live renders in steady
+// blocks, takes the cheaper options where they're hard to hear, and culls sooner, so there's headroom before anything
+// glitches. Max Polyphony takes every cheaper option and lets the audio get further behind before culling
+static constexpr EngineProfileDefinition engineProfiles[kNumEngineProfiles] = {
+    {"custom", 40, {}},
+    {"studio",
+     40,
+     {RuntimeFeatureStateRenderBlockSize::Variable, RuntimeFeatureStateControlRate::ControlRate16,
+      RuntimeFeatureStateCompressorDetection::EveryFrame, RuntimeFeatureStateToggle::Off,
+      RuntimeFeatureStateToggle::On}},
+    {"live",
+     34,
+     {RuntimeFeatureStateRenderBlockSize::Block64, RuntimeFeatureStateControlRate::ControlRate32,
+      RuntimeFeatureStateCompressorDetection::BlockRate, RuntimeFeatureStateToggle::On, RuntimeFeatureStateToggle::On}},
+    {"max polyphony",
+     46,
+     {RuntimeFeatureStateRenderBlockSize::Variable, RuntimeFeatureStateControlRate::ControlRateWindow,
+      RuntimeFeatureStateCompressorDetection::BlockRate, RuntimeFeatureStateToggle::On, RuntimeFeatureStateToggle::On}},
+};
+
 void RuntimeFeatureSettings::init() {
 	using enum deluge::l10n::String;
 	// Drum randomizer
@@ -155,6 +274,142 @@ void RuntimeFeatureSettings::init() {
 	// LightShiftLed
 	SetupOnOffSetting(settings[RuntimeFeatureSettingType::LightShiftLed], "Light Shift", "lightShift",
 	                  RuntimeFeatureStateToggle::Off);
+
+	// RenderBlockSize
+	SetupRenderBlockSizeSetting(settings[RuntimeFeatureSettingType::RenderBlockSize],
+	                            deluge::l10n::getView(STRING_FOR_COMMUNITY_FEATURE_RENDER_BLOCK_SIZE), "renderBlockSize",
+	                            RuntimeFeatureStateRenderBlockSize::Variable);
+
+	// LazySampleLoading
+	SetupOnOffSetting(settings[RuntimeFeatureSettingType::LazySampleLoading],
+	                  deluge::l10n::getView(STRING_FOR_COMMUNITY_FEATURE_LAZY_SAMPLE_LOADING), "lazySampleLoading",
+	                  RuntimeFeatureStateToggle::Off);
+
+	// VectorFilters
+	SetupOnOffSetting(settings[RuntimeFeatureSettingType::VectorFilters],
+	                  deluge::l10n::getView(STRING_FOR_COMMUNITY_FEATURE_VECTOR_FILTERS), "vectorFilters",
+	                  RuntimeFeatureStateToggle::Off);
+
+	// MasterCompressorDetection
+	SetupCompressorDetectionSetting(
+	    settings[RuntimeFeatureSettingType::MasterCompressorDetection],
+	    deluge::l10n::getView(STRING_FOR_COMMUNITY_FEATURE_MASTER_COMPRESSOR_DETECTION), "masterCompressorDetection",
+	    RuntimeFeatureStateCompressorDetection::EveryFrame);
+
+	// ControlRate
+	SetupControlRateSetting(settings[RuntimeFeatureSettingType::ControlRate],
+	                        deluge::l10n::getView(STRING_FOR_COMMUNITY_FEATURE_CONTROL_RATE), "controlRate",
+	                        RuntimeFeatureStateControlRate::ControlRateWindow);
+
+	// EcoPitchShift
+	SetupOnOffSetting(settings[RuntimeFeatureSettingType::EcoPitchShift],
+	                  deluge::l10n::getView(STRING_FOR_COMMUNITY_FEATURE_ECO_PITCH_SHIFT), "ecoPitchShift",
+	                  RuntimeFeatureStateToggle::Off);
+
+	// LoadMeter
+	SetupOnOffSetting(settings[RuntimeFeatureSettingType::LoadMeter],
+	                  deluge::l10n::getView(STRING_FOR_COMMUNITY_FEATURE_LOAD_METER), "loadMeter",
+	                  RuntimeFeatureStateToggle::Off);
+
+	// ResumeLastSong
+	SetupOnOffSetting(settings[RuntimeFeatureSettingType::ResumeLastSong],
+	                  deluge::l10n::getView(STRING_FOR_COMMUNITY_FEATURE_RESUME_LAST_SONG), "resumeLastSong",
+	                  RuntimeFeatureStateToggle::Off);
+
+	// TranscodeSamples
+	SetupOnOffSetting(settings[RuntimeFeatureSettingType::TranscodeSamples],
+	                  deluge::l10n::getView(STRING_FOR_COMMUNITY_FEATURE_TRANSCODE_SAMPLES), "transcodeSamples",
+	                  RuntimeFeatureStateToggle::Off);
+
+	// DelayMemorySaver
+	SetupOnOffSetting(settings[RuntimeFeatureSettingType::DelayMemorySaver],
+	                  deluge::l10n::getView(STRING_FOR_COMMUNITY_FEATURE_DELAY_MEMORY_SAVER), "delayMemorySaver",
+	                  RuntimeFeatureStateToggle::Off);
+
+	// DirectMonitoring
+	SetupOnOffSetting(settings[RuntimeFeatureSettingType::DirectMonitoring],
+	                  deluge::l10n::getView(STRING_FOR_COMMUNITY_FEATURE_DIRECT_MONITORING), "directMonitoring",
+	                  RuntimeFeatureStateToggle::Off);
+
+	// CompressSamples
+	SetupOnOffSetting(settings[RuntimeFeatureSettingType::CompressSamples],
+	                  deluge::l10n::getView(STRING_FOR_COMMUNITY_FEATURE_COMPRESS_SAMPLES), "compressSamples",
+	                  RuntimeFeatureStateToggle::Off);
+
+	// PerformanceReports
+	SetupOnOffSetting(settings[RuntimeFeatureSettingType::PerformanceReports],
+	                  deluge::l10n::getView(STRING_FOR_COMMUNITY_FEATURE_PERFORMANCE_REPORTS), "performanceReports",
+	                  RuntimeFeatureStateToggle::Off);
+
+	// TrackCpuOverlay
+	SetupOnOffSetting(settings[RuntimeFeatureSettingType::TrackCpuOverlay],
+	                  deluge::l10n::getView(STRING_FOR_COMMUNITY_FEATURE_TRACK_CPU_OVERLAY), "trackCpuOverlay",
+	                  RuntimeFeatureStateToggle::Off);
+
+	// RepeatableProbability
+	SetupOnOffSetting(settings[RuntimeFeatureSettingType::RepeatableProbability],
+	                  deluge::l10n::getView(STRING_FOR_COMMUNITY_FEATURE_REPEATABLE_PROBABILITY),
+	                  "repeatableProbability", RuntimeFeatureStateToggle::Off);
+
+	// EngineProfile
+	SetupEngineProfileSetting(settings[RuntimeFeatureSettingType::EngineProfile],
+	                          deluge::l10n::getView(STRING_FOR_COMMUNITY_FEATURE_ENGINE_PROFILE), "engineProfile",
+	                          RuntimeFeatureStateEngineProfile::EngineCustom);
+}
+
+void RuntimeFeatureSettings::applyEngineProfile(RuntimeFeatureStateEngineProfile profile) {
+	if (profile == EngineCustom || profile >= kNumEngineProfiles) {
+		return;
+	}
+	for (int32_t i = 0; i < kEngineProfileSettings.size(); i++) {
+		uint32_t value = engineProfiles[profile].values[i];
+		if (songEngineProfile != EngineCustom) {
+			valuesBeforeSongEngineProfile[i] = value;
+		}
+		else {
+			settings[kEngineProfileSettings[i]].value = value;
+		}
+	}
+}
+
+void RuntimeFeatureSettings::setSongEngineProfile(RuntimeFeatureStateEngineProfile profile) {
+	if (profile >= kNumEngineProfiles) {
+		profile = EngineCustom;
+	}
+
+	if (songEngineProfile == EngineCustom && profile != EngineCustom) {
+		for (int32_t i = 0; i < kEngineProfileSettings.size(); i++) {
+			valuesBeforeSongEngineProfile[i] = settings[kEngineProfileSettings[i]].value;
+		}
+	}
+	else if (songEngineProfile != EngineCustom && profile == EngineCustom) {
+		for (int32_t i = 0; i < kEngineProfileSettings.size(); i++) {
+			settings[kEngineProfileSettings[i]].value = valuesBeforeSongEngineProfile[i];
+		}
+	}
+
+	if (profile != EngineCustom) {
+		for (int32_t i = 0; i < kEngineProfileSettings.size(); i++) {
+			settings[kEngineProfileSettings[i]].value = engineProfiles[profile].values[i];
+		}
+	}
+	songEngineProfile = profile;
+}
+
+RuntimeFeatureStateEngineProfile RuntimeFeatureSettings::getActiveEngineProfile() {
+	if (songEngineProfile != EngineCustom) {
+		return songEngineProfile;
+	}
+	uint32_t profile = settings[RuntimeFeatureSettingType::EngineProfile].value;
+	return (profile < kNumEngineProfiles) ? static_cast<RuntimeFeatureStateEngineProfile>(profile) : EngineCustom;
+}
+
+int32_t RuntimeFeatureSettings::getCullSampleLimit() {
+	return engineProfiles[getActiveEngineProfile()].cullSampleLimit;
+}
+
+std::string_view RuntimeFeatureSettings::getEngineProfileName(RuntimeFeatureStateEngineProfile profile) {
+	return engineProfiles[(profile < kNumEngineProfiles) ? profile : EngineCustom].name;
 }
 
 void RuntimeFeatureSettings::readSettingsFromFile() {
@@ -233,10 +488,21 @@ void RuntimeFeatureSettings::writeSettingsToFile() {
 	storageManager.writeEarliestCompatibleFirmwareVersion("4.1.3");
 	storageManager.writeOpeningTagEnd();
 
-	for (auto& setting : settings) {
+	for (uint32_t type = 0; type < RuntimeFeatureSettingType::MaxElement; type++) {
+		RuntimeFeatureSetting& setting = settings[type];
+		uint32_t value = setting.value;
+
+		// A song's engine profile is only for while it's loaded, so save what it'll put back
+		if (songEngineProfile != EngineCustom) {
+			auto covered = std::find(kEngineProfileSettings.begin(), kEngineProfileSettings.end(), type);
+			if (covered != kEngineProfileSettings.end()) {
+				value = valuesBeforeSongEngineProfile[covered - kEngineProfileSettings.begin()];
+			}
+		}
+
 		storageManager.writeOpeningTagBeginning(TAG_RUNTIME_FEATURE_SETTING);
 		storageManager.writeAttribute(TAG_RUNTIME_FEATURE_SETTING_ATTR_NAME, setting.xmlName.data(), false);
-		storageManager.writeAttribute(TAG_RUNTIME_FEATURE_SETTING_ATTR_VALUE, setting.value, false);
+		storageManager.writeAttribute(TAG_RUNTIME_FEATURE_SETTING_ATTR_VALUE, value, false);
 		storageManager.writeOpeningTagEnd(false);
 		storageManager.writeClosingTag(TAG_RUNTIME_FEATURE_SETTING, false);
 	}
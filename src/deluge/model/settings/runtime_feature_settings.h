@@ -36,6 +36,24 @@ enum RuntimeFeatureStateToggle : uint32_t { Off = 0, On = 1 };
 // Declare additional enums for specific multi state settings (e.g. like RuntimeFeatureStateTrackLaunchStyle)
 enum RuntimeFeatureStateSyncScalingAction : uint32_t { SyncScaling = 0, Fill = 1 };
 
+// Value is the number of samples in each block, or 0 for the original variable-length windows
+enum RuntimeFeatureStateRenderBlockSize : uint32_t { Variable = 0, Block32 = 32, Block64 = 64 };
+
+enum RuntimeFeatureStateCompressorDetection : uint32_t { EveryFrame = 0, BlockRate = 1, BlockRateLookahead = 2 };
+
+// Value is the number of samples between each voice's modulation updates, or 0 for once per render window
+enum RuntimeFeatureStateControlRate : uint32_t { ControlRateWindow = 0, ControlRate32 = 32, ControlRate16 = 16 };
+
+// Each sets all the settings in kEngineProfileSettings, and how far behind the audio can get before voices are culled.
+// Custom is the original behaviour, where those are each left as they've been set
+enum RuntimeFeatureStateEngineProfile : uint32_t {
+	EngineCustom = 0,
+	EngineStudio = 1,
+	EngineLive = 2,
+	EngineMaxPolyphony = 3,
+};
+constexpr int32_t kNumEngineProfiles = 4;
+
 /// Every setting needs to be declared in here
 enum RuntimeFeatureSettingType : uint32_t {
 	DrumRandomizer,
@@ -57,9 +75,30 @@ enum RuntimeFeatureSettingType : uint32_t {
 	DisplayNornsLayout,
 	ShiftIsSticky,
 	LightShiftLed,
+	RenderBlockSize,
+	LazySampleLoading,
+	VectorFilters,
+	MasterCompressorDetection,
+	ControlRate,
+	EcoPitchShift,
+	LoadMeter,
+	ResumeLastSong,
+	TranscodeSamples,
+	DelayMemorySaver,
+	DirectMonitoring,
+	CompressSamples,
+	PerformanceReports,
+	TrackCpuOverlay,
+	RepeatableProbability,
+	EngineProfile,
 	MaxElement // Keep as boundary
 };
 
+/// The settings an engine profile chooses
+constexpr std::array<RuntimeFeatureSettingType, 5> kEngineProfileSettings{
+    RenderBlockSize, ControlRate, MasterCompressorDetection, EcoPitchShift, VectorFilters,
+};
+
 /// Definition for selectable options
 struct RuntimeFeatureSettingOption {
 	std::string_view displayName;
@@ -95,12 +134,31 @@ public:
 	void readSettingsFromFile();
 	void writeSettingsToFile();
 
+	/// Sets the settings an engine profile covers to its choices for them. Custom leaves them as they are. While a
+	/// song's own profile is in use, this sets what will be put back when it stops being
+	void applyEngineProfile(RuntimeFeatureStateEngineProfile profile);
+
+	/// Call when a song becomes the current one, with the profile it asks for. Custom means it doesn't ask for one,
+	/// and puts back whatever the song before it changed
+	void setSongEngineProfile(RuntimeFeatureStateEngineProfile profile);
+
+	/// The song's profile if it has one, or else the one set in the menu
+	RuntimeFeatureStateEngineProfile getActiveEngineProfile();
+
+	/// How many samples a render can be asked for before voices start getting culled
+	int32_t getCullSampleLimit();
+
+	static std::string_view getEngineProfileName(RuntimeFeatureStateEngineProfile profile);
+
 protected:
 	std::array<RuntimeFeatureSetting, RuntimeFeatureSettingType::MaxElement> settings = {};
 
 private:
 	ResizeableArray unknownSettings;
 
+	RuntimeFeatureStateEngineProfile songEngineProfile = EngineCustom;
+	std::array<uint32_t, kEngineProfileSettings.size()> valuesBeforeSongEngineProfile;
+
 public:
 	friend class deluge::gui::menu_item::runtime_feature::Setting;
 	friend class deluge::gui::menu_item::runtime_feature::Settings;
@@ -0,0 +1,87 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "model/song/group_bus.h"
+#include "dsp/stereo_sample.h"
+#include "modulation/params/param_set.h"
+#include "processing/engines/audio_engine.h"
+#include "storage/storage_manager.h"
+#include "util/functions.h"
+
+int32_t GroupBus::init() {
+	int32_t error = paramManager.setupUnpatched();
+	if (error) {
+		return error;
+	}
+	GlobalEffectable::initParams(&paramManager);
+	return NO_ERROR;
+}
+
+// Much like GlobalEffectableForClip::renderOutput(), minus the rendering of the Clip itself - busBuffer already has
+// everything routed to us in it. Adds the result to outputBuffer
+void GroupBus::render(StereoSample* busBuffer, StereoSample* outputBuffer, int32_t numSamples, int32_t* reverbBuffer,
+                      int32_t reverbAmountAdjust) {
+	UnpatchedParamSet* unpatchedParams = paramManager.getUnpatchedParamSet();
+
+	// Same as for AudioOutputs, which comes out at exactly unity at the default volume
+	int32_t volumeAdjustment = getFinalParameterValueVolume(
+	    134217728, cableToLinearParamShortcut(unpatchedParams->getValue(Param::Unpatched::GlobalEffectable::VOLUME)));
+	volumeAdjustment >>= 1;
+	int32_t volumePostFX = volumeAdjustment + multiply_32x32_rshift32_rounded(volumeAdjustment, 471633397);
+
+	DelayWorkingState delayWorkingState;
+	effectable.setupDelayWorkingState(&delayWorkingState, &paramManager);
+	effectable.setupFilterSetConfig(&volumePostFX, &paramManager);
+
+	int32_t reverbSendAmount = getFinalParameterValueVolume(
+	    reverbAmountAdjust,
+	    cableToLinearParamShortcut(unpatchedParams->getValue(Param::Unpatched::GlobalEffectable::REVERB_SEND_AMOUNT)));
+	int32_t pan = unpatchedParams->getValue(Param::Unpatched::GlobalEffectable::PAN) >> 1;
+
+	effectable.processFilters(busBuffer, numSamples);
+	effectable.processSRRAndBitcrushing(busBuffer, numSamples, &volumePostFX, &paramManager);
+	effectable.processFXForGlobalEffectable(busBuffer, numSamples, &volumePostFX, &paramManager, &delayWorkingState,
+	                                        8);
+	effectable.processReverbSendAndVolume(busBuffer, numSamples, reverbBuffer, volumePostFX,
+	                                      paramNeutralValues[Param::Global::VOLUME_POST_REVERB_SEND],
+	                                      reverbSendAmount, pan);
+	addAudio(busBuffer, outputBuffer, numSamples);
+}
+
+void GroupBus::writeToFile(int32_t index) {
+	storageManager.writeOpeningTagBeginning("groupBus");
+	storageManager.writeAttribute("index", index);
+	effectable.writeAttributesToFile(false);
+	storageManager.writeOpeningTagEnd();
+	effectable.writeTagsToFile(&paramManager, false);
+	storageManager.writeClosingTag("groupBus");
+}
+
+// The "index" attribute has already been read, by the Song
+int32_t GroupBus::readFromFile(Song* song) {
+	char const* tagName;
+	while (*(tagName = storageManager.readNextTagOrAttributeName())) {
+		int32_t result = effectable.readTagFromFile(tagName, &paramManager, 2147483647, song);
+		if (result == RESULT_TAG_UNUSED) {
+			storageManager.exitTag();
+		}
+		else if (result != NO_ERROR) {
+			return result;
+		}
+	}
+	return NO_ERROR;
+}
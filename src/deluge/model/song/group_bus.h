@@ -0,0 +1,45 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "model/global_effectable/global_effectable.h"
+#include "modulation/params/param_manager.h"
+#include <cstdint>
+
+class Song;
+class StereoSample;
+
+constexpr int32_t kNumGroupBuses = 4;
+
+/*
+ * A bus that any number of Outputs can be routed into (see Output::groupBus), with one FX chain and volume of its own,
+ * which get rendered once over everything routed there. So a bunch of layered parts can share one delay, mod FX,
+ * filter etc. rather than each paying for its own. Its output goes on to the Song's, just as an Output's would.
+ */
+class GroupBus {
+public:
+	int32_t init();
+	void render(StereoSample* busBuffer, StereoSample* outputBuffer, int32_t numSamples, int32_t* reverbBuffer,
+	            int32_t reverbAmountAdjust);
+
+	void writeToFile(int32_t index);
+	int32_t readFromFile(Song* song);
+
+	GlobalEffectable effectable;
+	ParamManagerForTimeline paramManager;
+};
@@ -18,6 +18,7 @@
 #include "model/song/song.h"
 #include "definitions_cxx.hpp"
 #include "dsp/master_compressor/master_compressor.h"
+#include "dsp/reverb/fdn/fdn.h"
 #include "dsp/reverb/freeverb/revmodel.hpp"
 #include "gui/l10n/l10n.h"
 #include "gui/ui/browser/browser.h"
@@ -31,6 +32,7 @@
 #include "hid/led/indicator_leds.h"
 #include "hid/led/pad_leds.h"
 #include "hid/matrix/matrix_driver.h"
+#include "io/debug/cpu_profiler.h"
 #include "io/debug/print.h"
 #include "io/midi/midi_device.h"
 #include "io/midi/midi_device_manager.h"
@@ -59,6 +61,7 @@
 #include "processing/audio_output.h"
 #include "processing/engines/audio_engine.h"
 #include "processing/engines/cv_engine.h"
+#include "processing/engines/render_scratch.h"
 #include "processing/sound/sound_drum.h"
 #include "processing/sound/sound_instrument.h"
 #include "storage/audio/audio_file_manager.h"
@@ -66,6 +69,7 @@
 #include "storage/flash_storage.h"
 #include "storage/storage_manager.h"
 #include "util/functions.h"
+#include <ctype.h>
 #include <new>
 #include <string.h>
 
@@ -75,8 +79,16 @@ extern "C" {
 
 using namespace deluge;
 
+uint32_t Song::midiInputRoutingGeneration = 1;
+
 Song::Song() : backedUpParamManagers(sizeof(BackedUpParamManager)) {
 	outputClipInstanceListIsCurrentlyInvalid = false;
+	drumNoteRowIndex = NULL;
+	drumNoteRowIndexKit = NULL;
+	drumNoteRowIndexStopTraversalAtClip = NULL;
+	audioOutputNameIndex = NULL;
+	learnedMIDIKnobIndexValid = false;
+	midiInputRoutingValid = false;
 	insideWorldTickMagnitude = FlashStorage::defaultMagnitude;
 	insideWorldTickMagnitudeOffsetFromBPM = 0;
 	syncScalingClip = NULL;
@@ -112,6 +124,8 @@ Song::Song() : backedUpParamManagers(sizeof(BackedUpParamManager)) {
 
 	swingInterval = 8 - insideWorldTickMagnitude; // 16th notes
 
+	engineProfile = RuntimeFeatureStateEngineProfile::EngineCustom;
+
 	songViewYScroll = 1 - kDisplayHeight;
 	arrangementYScroll = -kDisplayHeight;
 
@@ -132,6 +146,8 @@ Song::Song() : backedUpParamManagers(sizeof(BackedUpParamManager)) {
 	reverbDamp = (float)36 / 50;
 	reverbWidth = 1;
 	reverbPan = 0;
+	reverbModel = ReverbModel::FREEVERB;
+	reverbQuality = ReverbQuality::HIGH;
 	reverbCompressorVolume = getParamFromUserValue(Param::Static::COMPRESSOR_VOLUME, -1);
 	reverbCompressorShape = -601295438;
 	reverbCompressorSync = SYNC_LEVEL_8TH;
@@ -145,6 +161,10 @@ Song::Song() : backedUpParamManagers(sizeof(BackedUpParamManager)) {
 	AudioEngine::mastercompressor.gr = 0.0;
 
 	dirPath.set("SONGS");
+
+	GeneralMemoryAllocator::get().registerRelocatable(&relocatableSessionClips);
+	GeneralMemoryAllocator::get().registerRelocatable(&relocatableArrangementOnlyClips);
+	GeneralMemoryAllocator::get().registerRelocatable(&relocatableBackedUpParamManagers);
 }
 
 Song::~Song() {
@@ -178,6 +198,13 @@ Song::~Song() {
 	deleteAllOutputs((Output**)&firstHibernatingInstrument);
 
 	deleteHibernatingMIDIInstrument();
+
+	for (GroupBus* bus : groupBuses) {
+		if (bus) {
+			bus->~GroupBus();
+			delugeDealloc(bus);
+		}
+	}
 }
 
 #include "gui/menu_item/integer_range.h"
@@ -213,6 +240,7 @@ void Song::deleteAllOutputs(Output** prevPointer) {
 		AudioEngine::routineWithClusterLoading(); // -----------------------------------
 		Output* toDelete = *prevPointer;
 		*prevPointer = toDelete->next;
+		midiInputRoutingChanged();
 
 		void* toDealloc = dynamic_cast<void*>(toDelete);
 		toDelete->~Output();
@@ -1088,6 +1116,10 @@ weAreInArrangementEditorOrInClipInstance:
 	storageManager.writeAttribute("affectEntire", affectEntire);
 	storageManager.writeAttribute("activeModFunction", globalEffectable.modKnobMode);
 
+	if (engineProfile != RuntimeFeatureStateEngineProfile::EngineCustom) {
+		storageManager.writeAttribute("engineProfile", engineProfile);
+	}
+
 	globalEffectable.writeAttributesToFile(false);
 
 	storageManager
@@ -1112,6 +1144,8 @@ weAreInArrangementEditorOrInClipInstance:
 	storageManager.writeAttribute("dampening", dampening);
 	storageManager.writeAttribute("width", width);
 	storageManager.writeAttribute("pan", AudioEngine::reverbPan);
+	storageManager.writeAttribute("model", util::to_underlying(AudioEngine::reverbModel));
+	storageManager.writeAttribute("quality", util::to_underlying(AudioEngine::fdnReverb.getQuality()));
 	storageManager.writeOpeningTagEnd();
 
 	storageManager.writeOpeningTagBeginning("compressor");
@@ -1151,6 +1185,20 @@ weAreInArrangementEditorOrInClipInstance:
 	GlobalEffectableForClip::writeParamTagsToFile(&paramManager, true, valuesForOverride);
 	storageManager.writeClosingTag("songParams");
 
+	bool anyGroupBuses = false;
+	for (int32_t b = 0; b < kNumGroupBuses; b++) {
+		if (groupBuses[b]) {
+			if (!anyGroupBuses) {
+				storageManager.writeOpeningTag("groupBuses");
+				anyGroupBuses = true;
+			}
+			groupBuses[b]->writeToFile(b + 1);
+		}
+	}
+	if (anyGroupBuses) {
+		storageManager.writeClosingTag("groupBuses");
+	}
+
 	storageManager.writeOpeningTag("instruments");
 	for (Output* thisOutput = firstOutput; thisOutput; thisOutput = thisOutput->next) {
 		thisOutput->writeToFile(NULL, this);
@@ -1250,6 +1298,20 @@ int32_t Song::readFromFile() {
 					reverbPan = storageManager.readTagOrAttributeValueInt();
 					storageManager.exitTag("pan");
 				}
+				else if (!strcmp(tagName, "model")) {
+					int32_t model = storageManager.readTagOrAttributeValueInt();
+					if (model >= 0 && model < kNumReverbModels) {
+						reverbModel = static_cast<ReverbModel>(model);
+					}
+					storageManager.exitTag("model");
+				}
+				else if (!strcmp(tagName, "quality")) {
+					int32_t quality = storageManager.readTagOrAttributeValueInt();
+					if (quality >= 0 && quality < kNumReverbQualities) {
+						reverbQuality = static_cast<ReverbQuality>(quality);
+					}
+					storageManager.exitTag("quality");
+				}
 				else if (!strcmp(tagName, "compressor")) {
 					while (*(tagName = storageManager.readNextTagOrAttributeName())) {
 						if (!strcmp(tagName, "attack")) {
@@ -1482,6 +1544,14 @@ unknownTag:
 				storageManager.exitTag("affectEntire");
 			}
 
+			else if (!strcmp(tagName, "engineProfile")) {
+				engineProfile = storageManager.readTagOrAttributeValueInt();
+				if (engineProfile >= kNumEngineProfiles) {
+					engineProfile = RuntimeFeatureStateEngineProfile::EngineCustom;
+				}
+				storageManager.exitTag("engineProfile");
+			}
+
 			else if (!strcmp(tagName, "masterCompressor")
 			         && runtimeFeatureSettings.get(RuntimeFeatureSettingType::MasterCompressorFx)
 			                == RuntimeFeatureStateToggle::On) {
@@ -1681,6 +1751,35 @@ loadOutput:
 				storageManager.exitTag("songParams");
 			}
 
+			else if (!strcmp(tagName, "groupBuses")) {
+				while (*(tagName = storageManager.readNextTagOrAttributeName())) {
+					if (!strcmp(tagName, "groupBus")) {
+						// Its index always gets written first
+						GroupBus* bus = NULL;
+						tagName = storageManager.readNextTagOrAttributeName();
+						if (!strcmp(tagName, "index")) {
+							int32_t number = storageManager.readTagOrAttributeValueInt();
+							storageManager.exitTag("index");
+							bus = getOrCreateGroupBus(number);
+							if (!bus && number > 0 && number <= kNumGroupBuses) {
+								return ERROR_INSUFFICIENT_RAM;
+							}
+						}
+						else if (*tagName) {
+							storageManager.exitTag();
+						}
+						if (bus) {
+							int32_t error = bus->readFromFile(this);
+							if (error) {
+								return error;
+							}
+						}
+					}
+					storageManager.exitTag();
+				}
+				storageManager.exitTag("groupBuses");
+			}
+
 			else if (!strcmp(tagName, "tracks") || !strcmp(tagName, "sessionClips")) {
 				int32_t error = readClipsFromFile(&sessionClips);
 				if (error) {
@@ -1737,6 +1836,17 @@ loadOutput:
 	char modelStackMemory[MODEL_STACK_MAX_SIZE];
 	ModelStack* modelStack = setupModelStackWithSong(modelStackMemory, this);
 
+	// Each Clip claiming its Output would otherwise search all the Clips before it for each of its Drums, and all
+	// Outputs for its AudioOutput, so index those as we go. If we run out of RAM for either index, we just go without.
+	OpenAddressingHashTableWith32bitKeyAnd32bitValue drumNoteRowIndexWhileLoading;
+	OpenAddressingHashTableWith32bitKeyAnd32bitValue audioOutputNameIndexWhileLoading;
+	drumNoteRowIndex = &drumNoteRowIndexWhileLoading;
+	drumNoteRowIndexKit = NULL;
+	audioOutputNameIndex = &audioOutputNameIndexWhileLoading;
+	if (!buildAudioOutputNameIndex()) {
+		audioOutputNameIndex = NULL;
+	}
+
 	int32_t count = 0;
 	// Match all Clips up with their Output
 	// For each Clip in session and arranger
@@ -1753,11 +1863,19 @@ traverseClips:
 
 		ModelStackWithTimelineCounter* modelStackWithTimelineCounter = modelStack->addTimelineCounter(thisClip);
 
+		// The index holds the NoteRows of all the Clips before this one - which is what claimOutput() asks for
+		drumNoteRowIndexStopTraversalAtClip = thisClip;
 		int32_t error = thisClip->claimOutput(modelStackWithTimelineCounter);
 		if (error) {
+			stopUsingDrumNoteRowIndex();
+			audioOutputNameIndex = NULL;
 			return error;
 		}
 
+		if (drumNoteRowIndex && !addClipToDrumNoteRowIndex(thisClip)) {
+			stopUsingDrumNoteRowIndex();
+		}
+
 		// Correct different non-synced rates of old song files
 		// In a perfect world, we'd do this for Kits, MIDI and CV too
 		if (storageManager.firmwareVersionOfFileBeingRead < FIRMWARE_1P5P0_PREBETA
@@ -1775,6 +1893,9 @@ traverseClips:
 		goto traverseClips;
 	}
 
+	stopUsingDrumNoteRowIndex();
+	audioOutputNameIndex = NULL;
+
 	AudioEngine::logAction("matched up");
 
 	AudioEngine::routineWithClusterLoading(); // -----------------------------------
@@ -1977,6 +2098,11 @@ readClip:
 // Needs to be in a separate function than the above because the main song XML file needs to be closed first before this is called, because this will open other (sample) files
 void Song::loadAllSamples(bool mayActuallyReadFiles) {
 
+	int32_t deferFrom = -1;
+	if (runtimeFeatureSettings.get(RuntimeFeatureSettingType::LazySampleLoading) == RuntimeFeatureStateToggle::On) {
+		deferFrom = xScroll[NAVIGATION_ARRANGEMENT] + getBarLength() * kArrangementSampleLoadAheadBars;
+	}
+
 	for (Output* thisOutput = firstOutput; thisOutput; thisOutput = thisOutput->next) {
 		thisOutput->loadAllAudioFiles(mayActuallyReadFiles);
 	}
@@ -1995,6 +2121,13 @@ traverseClips:
 
 		Clip* clip = clipArray->getClipAtIndex(c);
 		if (clip->type == CLIP_TYPE_AUDIO) {
+			// When loading lazily, leave files for far-off arrangement-only Clips to the arranger. They may still be
+			// claimed from RAM above, which costs nothing
+			if (mayActuallyReadFiles && clipArray == &arrangementOnlyClips && deferFrom != -1
+			    && !((AudioClip*)clip)->sampleHolder.audioFile && getFirstClipInstancePos(clip) >= deferFrom) {
+				((AudioClip*)clip)->sampleLoadDeferred = true;
+				continue;
+			}
 			((AudioClip*)clip)->loadSample(mayActuallyReadFiles);
 		}
 	}
@@ -2004,6 +2137,41 @@ traverseClips:
 	}
 }
 
+// Gives every InstrumentClip's note probabilities a fresh sequence for this playback. With the Repeatable Probability
+// community setting on, that's the same sequence every time, going by where the Clip is in the Song, so a song full of
+// probability plays out identically each time it's played from the same place - which is what you want when comparing
+// its CPU use between builds
+void Song::seedClipProbabilities() {
+	bool repeatable =
+	    runtimeFeatureSettings.get(RuntimeFeatureSettingType::RepeatableProbability) == RuntimeFeatureStateToggle::On;
+	uint32_t seed = 0;
+
+	ClipArray* clipArray = &sessionClips;
+traverseClips:
+	for (int32_t c = 0; c < clipArray->getNumElements(); c++) {
+		Clip* clip = clipArray->getClipAtIndex(c);
+		seed += 0x9E3779B9; // Spread neighbouring Clips' seeds well apart
+		if (clip->type == CLIP_TYPE_INSTRUMENT) {
+			((InstrumentClip*)clip)->probabilityRandomState = repeatable ? seed : (uint32_t)getNoise();
+		}
+	}
+	if (clipArray != &arrangementOnlyClips) {
+		clipArray = &arrangementOnlyClips;
+		goto traverseClips;
+	}
+}
+
+// Returns -1 if the Clip isn't placed in the arrangement at all
+int32_t Song::getFirstClipInstancePos(Clip* clip) {
+	for (int32_t i = 0; i < clip->output->clipInstances.getNumElements(); i++) {
+		ClipInstance* clipInstance = clip->output->clipInstances.getElement(i);
+		if (clipInstance->clip == clip) {
+			return clipInstance->pos;
+		}
+	}
+	return -1;
+}
+
 void Song::loadCrucialSamplesOnly() {
 
 	for (Output* thisOutput = firstOutput; thisOutput; thisOutput = thisOutput->next) {
@@ -2095,16 +2263,34 @@ void Song::renderAudio(StereoSample* outputBuffer, int32_t numSamples, int32_t*
 	ModelStack* modelStack = setupModelStackWithSong(modelStackMemory, this);
 
 	for (Output* output = firstOutput; output; output = output->next) {
-		if (!output->inValidState) {
+		if (output->inValidState && !getGroupBus(output->groupBus)) {
+			renderOutput(output, modelStack, outputBuffer, numSamples, reverbBuffer, volumePostFX >> 1,
+			             sideChainHitPending);
+		}
+	}
+
+	// Then each GroupBus, with everything routed to it summed first
+	for (int32_t b = 0; b < kNumGroupBuses; b++) {
+		GroupBus* bus = groupBuses[b];
+		if (!bus) {
 			continue;
 		}
 
-		bool isClipActiveNow = (output->activeClip && isClipActive(output->activeClip->getClipBeingRecordedFrom()));
+		ScratchBuffer<StereoSample> busScratch(numSamples);
+		StereoSample* busBuffer = busScratch.get();
+		if (!busBuffer) {
+			break;
+		}
+		memset(busBuffer, 0, sizeof(StereoSample) * numSamples);
 
-		//AudioEngine::logAction("outp->render");
-		output->renderOutput(modelStack, outputBuffer, outputBuffer + numSamples, numSamples, reverbBuffer,
-		                     volumePostFX >> 1, sideChainHitPending, !isClipActiveNow, isClipActiveNow);
-		//AudioEngine::logAction("/outp->render");
+		for (Output* output = firstOutput; output; output = output->next) {
+			if (output->inValidState && output->groupBus == b + 1) {
+				renderOutput(output, modelStack, busBuffer, numSamples, reverbBuffer, volumePostFX >> 1,
+				             sideChainHitPending);
+			}
+		}
+
+		bus->render(busBuffer, outputBuffer, numSamples, reverbBuffer, volumePostFX >> 1);
 	}
 
 	// If recording the "MIX", this is the place where we want to grab it - before any master FX or volume applied
@@ -2148,6 +2334,76 @@ void Song::renderAudio(StereoSample* outputBuffer, int32_t numSamples, int32_t*
 	}
 }
 
+void Song::renderOutput(Output* output, ModelStack* modelStack, StereoSample* outputBuffer, int32_t numSamples,
+                        int32_t* reverbBuffer, int32_t reverbAmountAdjust, int32_t sideChainHitPending) {
+	bool isClipActiveNow = (output->activeClip && isClipActive(output->activeClip->getClipBeingRecordedFrom()));
+
+	//AudioEngine::logAction("outp->render");
+	uint32_t startTime = Debug::readCycleCounter();
+	output->renderOutput(modelStack, outputBuffer, outputBuffer + numSamples, numSamples, reverbBuffer,
+	                     reverbAmountAdjust, sideChainHitPending, !isClipActiveNow, isClipActiveNow);
+	uint32_t cycles = Debug::readCycleCounter() - startTime;
+	output->renderCycles += cycles;
+	output->renderCyclesSinceLoadSample += cycles;
+	//AudioEngine::logAction("/outp->render");
+}
+
+// Turns what each Output has spent in renderOutput() over the last numSamples into a share of the render time there
+// was, for the track CPU overlay. Like the load meter, goes straight up to a new peak but falls away slowly. Called
+// from the main loop so the divides stay out of the audio routine. Returns whether any Output's figure moved enough to
+// be worth redrawing for
+bool Song::updateOutputRenderLoads(uint32_t numSamples) {
+	if (!numSamples) {
+		return false;
+	}
+	uint64_t budget = (uint64_t)numSamples * Debug::kCyclesPerSample;
+	bool anyChanged = false;
+
+	for (Output* output = firstOutput; output; output = output->next) {
+		int32_t newPermille = std::min<uint64_t>((uint64_t)output->renderCyclesSinceLoadSample * 1000 / budget, 1000);
+		output->renderCyclesSinceLoadSample = 0;
+
+		int32_t smoothed = output->renderLoadPermille;
+		smoothed = (newPermille >= smoothed) ? newPermille : (smoothed * 3 + newPermille) >> 2;
+		if ((smoothed >> 6) != (output->renderLoadPermille >> 6)) {
+			anyChanged = true;
+		}
+		output->renderLoadPermille = smoothed;
+	}
+	return anyChanged;
+}
+
+// number is from 1, as in Output::groupBus. Returns NULL for 0, or if that bus doesn't exist
+GroupBus* Song::getGroupBus(int32_t number) {
+	if (number <= 0 || number > kNumGroupBuses) {
+		return NULL;
+	}
+	return groupBuses[number - 1];
+}
+
+// Returns NULL if there's no RAM
+GroupBus* Song::getOrCreateGroupBus(int32_t number) {
+	if (number <= 0 || number > kNumGroupBuses) {
+		return NULL;
+	}
+	if (groupBuses[number - 1]) {
+		return groupBuses[number - 1];
+	}
+
+	void* memory = GeneralMemoryAllocator::get().alloc(sizeof(GroupBus), NULL, false, true);
+	if (!memory) {
+		return NULL;
+	}
+	GroupBus* bus = new (memory) GroupBus();
+	if (bus->init() != NO_ERROR) {
+		bus->~GroupBus();
+		delugeDealloc(memory);
+		return NULL;
+	}
+	groupBuses[number - 1] = bus;
+	return bus;
+}
+
 void Song::setTimePerTimerTick(uint64_t newTimeBig, bool shouldLogAction) {
 
 	if (shouldLogAction) {
@@ -2206,6 +2462,12 @@ void Song::resyncLFOsAndArpeggiators() {
 
 NoteRow* Song::findNoteRowForDrum(Kit* kit, Drum* drum, Clip* stopTraversalAtClip) {
 
+	if (drumNoteRowIndex && (!drumNoteRowIndexKit || drumNoteRowIndexKit == kit)
+	    && stopTraversalAtClip == drumNoteRowIndexStopTraversalAtClip) {
+		uint32_t* noteRow = drumNoteRowIndex->lookupValue((uint32_t)drum);
+		return noteRow ? (NoteRow*)*noteRow : NULL;
+	}
+
 	// If currently swapping an Instrument, it can't be assumed that all arranger-only Clips for this Instrument are in its clipInstances, which otherwise is a nice time-saver
 
 	// For each Clip in session and arranger for specific Output - but if currentlySwappingInstrument, use master list for arranger Clips
@@ -2257,6 +2519,196 @@ traverseClips:
 	return NULL;
 }
 
+// Adds each of the Clip's Drums which isn't in the index yet. Returns false if there wasn't enough RAM
+bool Song::addClipToDrumNoteRowIndex(Clip* clip) {
+	if (clip->type != CLIP_TYPE_INSTRUMENT || clip->output->type != InstrumentType::KIT) {
+		return true;
+	}
+	InstrumentClip* instrumentClip = (InstrumentClip*)clip;
+	for (int32_t i = 0; i < instrumentClip->noteRows.getNumElements(); i++) {
+		NoteRow* noteRow = instrumentClip->noteRows.getElement(i);
+		if (noteRow->drum) {
+			if (!drumNoteRowIndex->insertValueIfNotAlreadyPresent((uint32_t)noteRow->drum, (uint32_t)noteRow)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// Indexes, for findNoteRowForDrum(), the first NoteRow for each of the Kit's Drums, in the same order that function
+// would look through the Clips. Only valid until NoteRows or Clips next change - call stopUsingDrumNoteRowIndex()
+// before then, and before index goes out of scope. Returns false, and doesn't use the index, if not enough RAM.
+bool Song::buildDrumNoteRowIndex(Kit* kit, OpenAddressingHashTableWith32bitKeyAnd32bitValue* index) {
+	drumNoteRowIndex = index;
+	drumNoteRowIndexKit = kit;
+	drumNoteRowIndexStopTraversalAtClip = NULL;
+
+	ClipArray* clipArray = &sessionClips;
+	bool doingClipsProvidedByOutput = false;
+decideNumElements:
+	int32_t numElements = clipArray->getNumElements();
+traverseClips:
+	for (int32_t c = 0; c < numElements; c++) {
+		Clip* clip;
+		if (!doingClipsProvidedByOutput) {
+			clip = clipArray->getClipAtIndex(c);
+			if (clip->output != kit) {
+				continue;
+			}
+		}
+		else {
+			ClipInstance* clipInstance = kit->clipInstances.getElement(c);
+			if (!clipInstance->clip || !clipInstance->clip->isArrangementOnlyClip()) {
+				continue;
+			}
+			clip = clipInstance->clip;
+		}
+
+		if (!addClipToDrumNoteRowIndex(clip)) {
+			stopUsingDrumNoteRowIndex();
+			return false;
+		}
+	}
+	if (!doingClipsProvidedByOutput && clipArray == &sessionClips) {
+		if (outputClipInstanceListIsCurrentlyInvalid) {
+			clipArray = &arrangementOnlyClips;
+			goto decideNumElements;
+		}
+		else {
+			doingClipsProvidedByOutput = true;
+			numElements = kit->clipInstances.getNumElements();
+			goto traverseClips;
+		}
+	}
+
+	return true;
+}
+
+void Song::stopUsingDrumNoteRowIndex() {
+	drumNoteRowIndex = NULL;
+	drumNoteRowIndexKit = NULL;
+	drumNoteRowIndexStopTraversalAtClip = NULL;
+}
+
+bool Song::anyMIDIKnobLearnedTo(int32_t channel, int32_t noteOrCC) {
+	if (channel < 0 || channel >= 16 || noteOrCC < 0 || noteOrCC > 128) {
+		return true; // Not something the index covers, so the caller will have to look
+	}
+	if (!learnedMIDIKnobIndexValid) {
+		buildLearnedMIDIKnobIndex();
+	}
+	return (learnedMIDIKnobIndex[channel][noteOrCC >> 5] >> (noteOrCC & 31)) & 1;
+}
+
+void Song::buildLearnedMIDIKnobIndex() {
+	memset(learnedMIDIKnobIndex, 0, sizeof(learnedMIDIKnobIndex));
+
+	// Hibernating Instruments too, since they can come back into use without any of their knobs changing
+	addOutputsToLearnedMIDIKnobIndex(firstOutput);
+	addOutputsToLearnedMIDIKnobIndex(firstHibernatingInstrument);
+
+	learnedMIDIKnobIndexValid = true;
+}
+
+void Song::addOutputsToLearnedMIDIKnobIndex(Output* firstOutputInList) {
+	for (Output* output = firstOutputInList; output; output = output->next) {
+		switch (output->type) {
+		case InstrumentType::SYNTH:
+			addToLearnedMIDIKnobIndex((SoundInstrument*)output);
+			break;
+
+		case InstrumentType::KIT:
+			addToLearnedMIDIKnobIndex((Kit*)output);
+			for (Drum* drum = ((Kit*)output)->firstDrum; drum; drum = drum->next) {
+				if (drum->type == DrumType::SOUND) {
+					addToLearnedMIDIKnobIndex((SoundDrum*)drum);
+				}
+			}
+			break;
+
+		case InstrumentType::AUDIO:
+			addToLearnedMIDIKnobIndex((AudioOutput*)output);
+			break;
+
+		default: // MIDI and CV Instruments don't have MIDIKnobs
+			break;
+		}
+	}
+}
+
+void Song::addToLearnedMIDIKnobIndex(ModControllableAudio* modControllable) {
+	for (int32_t k = 0; k < modControllable->midiKnobArray.getNumElements(); k++) {
+		LearnedMIDI* midiInput = &modControllable->midiKnobArray.getElement(k)->midiInput;
+		int32_t channel = midiInput->channelOrZone;
+		int32_t noteOrCC = midiInput->noteOrCC;
+		if (channel >= 0 && channel < 16 && noteOrCC >= 0 && noteOrCC <= 128) {
+			learnedMIDIKnobIndex[channel][noteOrCC >> 5] |= (uint32_t)1 << (noteOrCC & 31);
+		}
+	}
+}
+
+// Returns NULL if the caller should just offer the message to every Output instead
+Output** Song::getOutputsListeningToMIDIChannel(MIDIDevice* fromDevice, int32_t channel, int32_t* numOutputs) {
+	if (!midiInputRoutingValid) {
+		buildMIDIInputRouting();
+	}
+	if (midiInputRoutingOverflowed) {
+		return NULL;
+	}
+
+	// Same conversion MelodicInstrument::checkMatch() and LearnedMIDI::equalsChannelAllowMPE() do
+	int32_t channelOrZone = fromDevice->ports[MIDI_DIRECTION_INPUT_TO_DELUGE].channelToZone(channel);
+	if (channelOrZone < 0 || channelOrZone >= kNumMIDIInputChannelsAndZones) {
+		return NULL;
+	}
+
+	*numOutputs = midiInputRoutingStart[channelOrZone + 1] - midiInputRoutingStart[channelOrZone];
+	return &midiInputRouting[midiInputRoutingStart[channelOrZone]];
+}
+
+static bool outputListensToMIDIChannelOrZone(Output* output, int32_t channelOrZone) {
+	switch (output->type) {
+	case InstrumentType::SYNTH:
+	case InstrumentType::MIDI_OUT:
+	case InstrumentType::CV:
+		return (((MelodicInstrument*)output)->midiInput.channelOrZone == channelOrZone);
+
+	case InstrumentType::KIT:
+		for (Drum* drum = ((Kit*)output)->firstDrum; drum; drum = drum->next) {
+			if (drum->midiInput.channelOrZone == channelOrZone) {
+				return true;
+			}
+		}
+		return false;
+
+	default: // AudioOutputs don't take MIDI input
+		return false;
+	}
+}
+
+void Song::buildMIDIInputRouting() {
+	int32_t numRoutes = 0;
+	midiInputRoutingOverflowed = false;
+
+	for (int32_t c = 0; c < kNumMIDIInputChannelsAndZones; c++) {
+		midiInputRoutingStart[c] = numRoutes;
+		for (Output* output = firstOutput; output; output = output->next) {
+			if (outputListensToMIDIChannelOrZone(output, c)) {
+				if (numRoutes >= kMaxNumMIDIInputRoutes) {
+					midiInputRoutingOverflowed = true;
+					goto doneBuilding;
+				}
+				midiInputRouting[numRoutes++] = output;
+			}
+		}
+	}
+
+doneBuilding:
+	midiInputRoutingStart[kNumMIDIInputChannelsAndZones] = numRoutes;
+	midiInputRoutingValid = true;
+}
+
 ParamManagerForTimeline* Song::findParamManagerForDrum(Kit* kit, Drum* drum, Clip* stopTraversalAtClip) {
 	NoteRow* noteRow = findNoteRowForDrum(kit, drum, stopTraversalAtClip);
 	if (!noteRow) {
@@ -2328,7 +2780,7 @@ traverseClips:
 				    modelStackWithNoteRow->addOtherTwoThings(drum, &noteRow->paramManager));
 
 				((PatchCableSet*)modelStackWithParamCollection->paramCollection)
-				    ->setupPatching(modelStackWithParamCollection);
+				    ->refreshPatching(modelStackWithParamCollection);
 			}
 		}
 	}
@@ -2388,7 +2840,7 @@ traverseClips:
 		ModelStackWithParamCollection* modelStackWithParamCollection =
 		    clip->paramManager.getPatchCableSet(modelStackWithThreeMainThings);
 
-		((PatchCableSet*)modelStackWithParamCollection->paramCollection)->setupPatching(modelStackWithParamCollection);
+		((PatchCableSet*)modelStackWithParamCollection->paramCollection)->refreshPatching(modelStackWithParamCollection);
 	}
 	if (!doingArrangementClips) {
 		doingArrangementClips = true;
@@ -2444,7 +2896,7 @@ traverseClips:
 		PatchCableSet* patchCableSet = (PatchCableSet*)modelStackWithParamCollection->paramCollection;
 
 		patchCableSet->grabVelocityToLevelFromMIDIDeviceDefinitely(device);
-		patchCableSet->setupPatching(modelStackWithParamCollection);
+		patchCableSet->refreshPatching(modelStackWithParamCollection);
 	}
 	if (!doingArrangementClips) {
 		doingArrangementClips = true;
@@ -2509,7 +2961,7 @@ traverseClips:
 		PatchCableSet* patchCableSet = (PatchCableSet*)modelStackWithParamCollection->paramCollection;
 
 		patchCableSet->grabVelocityToLevelFromMIDIDeviceDefinitely(device);
-		patchCableSet->setupPatching(modelStackWithParamCollection);
+		patchCableSet->refreshPatching(modelStackWithParamCollection);
 	}
 	if (!doingArrangementClips) {
 		doingArrangementClips = true;
@@ -2551,7 +3003,7 @@ traverseClips:
 				PatchCableSet* patchCableSet = (PatchCableSet*)modelStackWithParamCollection->paramCollection;
 				patchCableSet->grabVelocityToLevelFromMIDIDeviceDefinitely(device);
 
-				patchCableSet->setupPatching(modelStackWithParamCollection);
+				patchCableSet->refreshPatching(modelStackWithParamCollection);
 			}
 		}
 
@@ -2579,7 +3031,7 @@ traverseClips:
 					PatchCableSet* patchCableSet = (PatchCableSet*)modelStackWithParamCollection->paramCollection;
 
 					patchCableSet->grabVelocityToLevelFromMIDIDeviceDefinitely(device);
-					patchCableSet->setupPatching(modelStackWithParamCollection);
+					patchCableSet->refreshPatching(modelStackWithParamCollection);
 				}
 			}
 		}
@@ -2901,6 +3353,8 @@ void Song::addOutput(Output* output, bool atStart) {
 		anyOutputsSoloingInArrangement = true;
 	}
 
+	midiInputRoutingChanged();
+
 	// Must resync LFOs - these (if synced) will roll even when no activeClip
 	if (playbackHandler.isEitherClockActive() && this == currentSong) {
 		output->resyncLFOs();
@@ -2951,6 +3405,7 @@ int32_t Song::removeOutputFromMainList(
 	}
 
 	*prevPointer = output->next;
+	midiInputRoutingChanged();
 
 	AudioEngine::mustUpdateReverbParamsBeforeNextRender = true;
 
@@ -3005,9 +3460,12 @@ void Song::replaceInstrument(Instrument* oldOutput, Instrument* newOutput, bool
 	for (prevPointer = &firstOutput; *prevPointer != oldOutput; prevPointer = &(*prevPointer)->next) {}
 	newOutput->next = oldOutput->next;
 	*prevPointer = oldOutput->next;
+	midiInputRoutingChanged();
 
 	Clip* favourClipForCloningParamManager = NULL;
 
+	newOutput->groupBus = oldOutput->groupBus;
+
 	// Migrate input MIDI channel / device. Putting this up here before any calls to changeInstrument() is good, because
 	// then if a default velocity is set, for the MIDIDevice, that gets grabbed by the Clip's ParamManager during that call.
 	if (newOutput->type != InstrumentType::KIT && oldOutput->type != InstrumentType::KIT) {
@@ -3089,6 +3547,7 @@ traverseClips:
 
 	// Put the newInstrument into the master list
 	*prevPointer = newOutput;
+	midiInputRoutingChanged();
 
 	AudioEngine::mustUpdateReverbParamsBeforeNextRender = true;
 }
@@ -3219,7 +3678,39 @@ void Song::markAllInstrumentsAsEdited() {
 	}
 }
 
+static uint32_t hashOutputName(char const* name) {
+	uint32_t hash = 2166136261u; // FNV-1a
+	for (; *name; name++) {
+		hash = (hash ^ (uint8_t)tolower(*name)) * 16777619u;
+	}
+	return (hash == 0xFFFFFFFF) ? 0 : hash; // That one means an empty bucket
+}
+
+// Indexes each AudioOutput by its name's hash, for getAudioOutputFromName(). Returns false if not enough RAM
+bool Song::buildAudioOutputNameIndex() {
+	for (Output* thisOutput = firstOutput; thisOutput; thisOutput = thisOutput->next) {
+		if (thisOutput->type == InstrumentType::AUDIO) {
+			if (!audioOutputNameIndex->insertValueIfNotAlreadyPresent(hashOutputName(thisOutput->name.get()),
+			                                                          (uint32_t)thisOutput)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
 AudioOutput* Song::getAudioOutputFromName(String* name) {
+	if (audioOutputNameIndex) {
+		uint32_t* output = audioOutputNameIndex->lookupValue(hashOutputName(name->get()));
+		if (!output) {
+			return NULL;
+		}
+		if (((AudioOutput*)*output)->name.equalsCaseIrrespective(name)) {
+			return (AudioOutput*)*output;
+		}
+		// Otherwise it's just another name with the same hash, so have a proper look
+	}
+
 	for (Output* thisOutput = firstOutput; thisOutput; thisOutput = thisOutput->next) {
 		if (thisOutput->type == InstrumentType::AUDIO) {
 			if (thisOutput->name.equalsCaseIrrespective(name)) {
@@ -3351,7 +3842,9 @@ traverseClips:
 		// TODO: we probably don't need to call this so often anymore?
 		AudioEngine::routineWithClusterLoading(); // -----------------------------------
 		AudioEngine::logAction("aaa4.26");
-		((Instrument*)instrumentClip->output)->setupPatching(modelStackWithTimelineCounter);
+		// Big songs can have hundreds of kit drums, most of which won't be played or edited for a while, if at all -
+		// so each one's patching only gets set up when it is
+		((Instrument*)instrumentClip->output)->setupPatching(modelStackWithTimelineCounter, true);
 		AudioEngine::logAction("aaa4.27");
 	}
 	if (clipArray != &arrangementOnlyClips) {
@@ -4804,6 +5297,7 @@ void Song::replaceOutputLowLevel(Output* newOutput, Output* oldOutput) {
 	for (prevPointer = &firstOutput; *prevPointer != oldOutput; prevPointer = &(*prevPointer)->next) {}
 	newOutput->next = oldOutput->next;
 	*prevPointer = newOutput;
+	midiInputRoutingChanged();
 
 	// Migrate all ClipInstances from oldInstrument to newInstrument
 	newOutput->clipInstances.swapStateWith(&oldOutput->clipInstances);
@@ -19,12 +19,15 @@
 
 #include "definitions_cxx.hpp"
 #include "io/midi/learned_midi.h"
+#include "memory/relocatable.h"
 #include "model/clip/clip_array.h"
 #include "model/global_effectable/global_effectable_for_song.h"
+#include "model/song/group_bus.h"
 #include "model/timeline_counter.h"
 #include "modulation/params/param_manager.h"
 #include "storage/flash_storage.h"
 #include "util/container/array/ordered_resizeable_array_with_multi_word_key.h"
+#include "util/container/hashtable/open_addressing_hash_table.h"
 #include "util/d_string.h"
 
 class MidiCommand;
@@ -45,8 +48,13 @@ class MIDIInstrument;
 class NoteRow;
 class Output;
 class AudioOutput;
+class ModControllableAudio;
 class ModelStack;
 class ModelStackWithTimelineCounter;
+class MIDIDevice;
+
+constexpr int32_t kMaxNumMIDIInputRoutes = 64;
+constexpr int32_t kNumMIDIInputChannelsAndZones = 18; // 16 channels, then the lower and upper MPE zones
 
 class Section {
 public:
@@ -122,6 +130,11 @@ public:
 
 	GlobalEffectableForSong globalEffectable;
 
+	// Only the ones in use exist - see getGroupBus()
+	GroupBus* groupBuses[kNumGroupBuses] = {};
+	GroupBus* getGroupBus(int32_t number);
+	GroupBus* getOrCreateGroupBus(int32_t number);
+
 	ClipArray sessionClips;
 	ClipArray arrangementOnlyClips;
 
@@ -155,6 +168,8 @@ public:
 	int8_t swingAmount;
 	uint8_t swingInterval;
 
+	uint8_t engineProfile; // A RuntimeFeatureStateEngineProfile, or EngineCustom to go with the community feature's
+
 	Section sections[kMaxNumSections];
 
 	// Scales
@@ -191,6 +206,14 @@ public:
 
 	bool inClipMinderViewOnLoad; // Temp variable only valid while loading Song
 
+	// Temporary indexes for findNoteRowForDrum() and getAudioOutputFromName(), set up while loading or saving, when
+	// they'd otherwise be called for every Drum or AudioClip. Too much changes the rest of the time for these to be
+	// worth keeping up to date.
+	OpenAddressingHashTableWith32bitKeyAnd32bitValue* drumNoteRowIndex; // Drum* -> first NoteRow* for it
+	Kit* drumNoteRowIndexKit; // NULL means the index covers all Kits
+	Clip* drumNoteRowIndexStopTraversalAtClip;
+	OpenAddressingHashTableWith32bitKeyAnd32bitValue* audioOutputNameIndex; // Name hash -> first AudioOutput*
+
 	int32_t unautomatedParamValues[kMaxNumUnpatchedParams];
 
 	String dirPath;
@@ -207,9 +230,14 @@ public:
 	int32_t readFromFile();
 	void writeToFile();
 	void loadAllSamples(bool mayActuallyReadFiles = true);
+	int32_t getFirstClipInstancePos(Clip* clip);
+	void seedClipProbabilities();
 	bool modeContainsYNoteWithinOctave(uint8_t yNoteWithinOctave);
 	void renderAudio(StereoSample* outputBuffer, int32_t numSamples, int32_t* reverbBuffer,
 	                 int32_t sideChainHitPending);
+	void renderOutput(Output* output, ModelStack* modelStack, StereoSample* outputBuffer, int32_t numSamples,
+	                  int32_t* reverbBuffer, int32_t reverbAmountAdjust, int32_t sideChainHitPending);
+	bool updateOutputRenderLoads(uint32_t numSamples);
 	bool isYNoteAllowed(int32_t yNote, bool inKeyMode);
 	Clip* syncScalingClip;
 	void setTimePerTimerTick(uint64_t newTimeBig, bool shouldLogAction = false);
@@ -260,6 +288,18 @@ public:
 	void deleteHibernatingMIDIInstrument();
 	MIDIInstrument* grabHibernatingMIDIInstrument(int32_t newSlot, int32_t newSubSlot);
 	NoteRow* findNoteRowForDrum(Kit* kit, Drum* drum, Clip* stopTraversalAtClip = NULL);
+	bool buildDrumNoteRowIndex(Kit* kit, OpenAddressingHashTableWith32bitKeyAnd32bitValue* index);
+	void stopUsingDrumNoteRowIndex();
+
+	bool anyMIDIKnobLearnedTo(int32_t channel, int32_t noteOrCC);
+	void learnedMIDIKnobsChanged() { learnedMIDIKnobIndexValid = false; }
+
+	Output** getOutputsListeningToMIDIChannel(MIDIDevice* fromDevice, int32_t channel, int32_t* numOutputs);
+	void midiInputRoutingChanged() {
+		midiInputRoutingValid = false;
+		midiInputRoutingGeneration++; // Tells Kits too - see Kit::drumMIDINoteBuckets
+	}
+	static uint32_t midiInputRoutingGeneration; // Starts at 1, so a Kit's 0 never matches it
 
 	bool anyOutputsSoloingInArrangement;
 	bool getAnyOutputsSoloingInArrangement();
@@ -320,6 +360,8 @@ public:
 	float reverbDamp;
 	float reverbWidth;
 	int32_t reverbPan;
+	ReverbModel reverbModel;
+	ReverbQuality reverbQuality;
 	int32_t reverbCompressorVolume;
 	int32_t reverbCompressorShape;
 	int32_t reverbCompressorAttack;
@@ -335,6 +377,12 @@ public:
 
 private:
 	bool fillModeActive;
+
+	// So compaction can move these arrays' memory - see GeneralMemoryAllocator::compactStep()
+	RelocatableArray relocatableSessionClips{sessionClips};
+	RelocatableArray relocatableArrangementOnlyClips{arrangementOnlyClips};
+	RelocatableArray relocatableBackedUpParamManagers{backedUpParamManagers};
+
 	void inputTickScalePotentiallyJustChanged(uint32_t oldScale);
 	int32_t readClipsFromFile(ClipArray* clipArray);
 	void addInstrumentToHibernationList(Instrument* instrument);
@@ -342,6 +390,29 @@ private:
 	void deleteAllBackedUpParamManagersWithClips();
 	void deleteAllOutputs(Output** prevPointer);
 	void setupClipIndexesForSaving();
+	bool addClipToDrumNoteRowIndex(Clip* clip);
+	bool buildAudioOutputNameIndex();
+
+	// One bit for each (channel, CC) any MIDIKnob in this Song is learned to - CC 128 being pitch bend - so incoming
+	// messages nothing has learned needn't be offered to every Output and Drum. Built the first time it's needed after
+	// learnedMIDIKnobsChanged(), which gets called whenever any knob gets learned, read or cloned. Knobs going away
+	// don't invalidate it: a stale bit just costs one unnecessary search.
+	uint32_t learnedMIDIKnobIndex[16][5];
+	bool learnedMIDIKnobIndexValid;
+	void buildLearnedMIDIKnobIndex();
+	void addToLearnedMIDIKnobIndex(ModControllableAudio* modControllable);
+	void addOutputsToLearnedMIDIKnobIndex(Output* firstOutputInList);
+
+	// For each channelOrZone, the Outputs whose MelodicInstrument input, or any of whose Drums' inputs, is set to it -
+	// so that channel messages, which during MPE playing come thick and fast, needn't be offered to every Output in
+	// turn. midiInputRoutingStart[c] is where channelOrZone c's Outputs begin in midiInputRouting. Built the first
+	// time it's needed after midiInputRoutingChanged(), which must be called whenever an Output joins or leaves the
+	// main list, or any Instrument or Drum's input gets learned or moved, since this holds pointers to them.
+	Output* midiInputRouting[kMaxNumMIDIInputRoutes];
+	uint8_t midiInputRoutingStart[kNumMIDIInputChannelsAndZones + 1];
+	bool midiInputRoutingValid;
+	bool midiInputRoutingOverflowed; // Then callers just go through every Output
+	void buildMIDIInputRouting();
 };
 
 extern Song* currentSong;
@@ -45,10 +45,14 @@
 #include "storage/storage_manager.h"
 #include "storage/wave_table/wave_table.h"
 #include "util/functions.h"
+#include "util/functions_quad.h"
 #include "util/lookuptables/lookuptables.h"
 #include "util/misc.h"
+#include <algorithm>
+#include <array>
 #include <new>
 #include <string.h>
+#include <utility>
 
 extern "C" {
 #include "RZA1/mtu/mtu.h"
@@ -121,6 +125,9 @@ bool Voice::noteOn(ModelStackWithVoice* modelStack, int32_t newNoteCodeBeforeArp
 	noteCodeAfterArpeggiation = newNoteCodeAfterArpeggiation;
 	orderSounded = lastSoundOrder++;
 	overrideAmplitudeEnvelopeReleaseRate = 0;
+	retriggerPending = false;
+	latencySource = Debug::noteLatency.getInputSource();
+	latencyInputTime = Debug::noteLatency.getInputTime();
 
 	if (newNoteCodeAfterArpeggiation >= 128) {
 		sourceValues[util::to_underlying(PatchSource::NOTE)] = 2147483647;
@@ -239,6 +246,10 @@ bool Voice::noteOn(ModelStackWithVoice* modelStack, int32_t newNoteCodeBeforeArp
 
 				if (sound->sources[s].oscType == OscType::SAMPLE) {
 
+					if (sound->sources[s].ranges.getNumElements() > 1) {
+						sound->sources[s].prefetchNeighbouringRanges(sound->sources[s].defaultRangeI);
+					}
+
 					if (sound->sources[s].repeatMode == SampleRepeatMode::STRETCH) {
 						guides[s].sequenceSyncLengthTicks = newSampleSyncLength;
 						guides[s].sequenceSyncStartedAtTick =
@@ -673,6 +684,95 @@ bool Voice::sampleZoneChanged(ModelStackWithVoice* modelStack, int32_t s, Marker
 // Before calling this, you must set the filterSetConfig's doLPF and doHPF to default values
 
 // Returns false if became inactive and needs unassigning
+// The last stage of Voice::render(): apply the overall osc amplitude, clipping and panning to the Voice's own buffer,
+// and sum it into the Sound's. Rather than the loop checking each of those on every sample, there's a specialisation
+// for every combination, and render() picks one from voiceOutputFunctions[] by the bits of its index.
+template <bool stereoOscBuffer, bool applyOverallAmplitude, bool clipping, bool panning, bool stereoSoundBuffer>
+static void renderVoiceOutput(Sound* sound, uint32_t* saturationWorkingValues, int32_t const* __restrict__ oscBuffer,
+                              int32_t* __restrict__ soundBuffer, int32_t numSamples, int32_t overallOscAmplitudeNow,
+                              int32_t overallOscAmplitudeIncrement, int32_t amplitudeL, int32_t amplitudeR) {
+
+	int32_t const* __restrict__ oscBufferPos = oscBuffer; // For traversal
+
+	if constexpr (stereoOscBuffer) {
+		// If we're here, we also know that the Sound's buffer is also stereo
+		int32_t const* const oscBufferEnd = oscBuffer + (numSamples << 1);
+		StereoSample* __restrict__ outputSample = (StereoSample*)soundBuffer;
+
+		do {
+			int32_t outputSampleL = *(oscBufferPos++);
+			int32_t outputSampleR = *(oscBufferPos++);
+
+			if constexpr (applyOverallAmplitude) {
+				overallOscAmplitudeNow += overallOscAmplitudeIncrement;
+				outputSampleL = multiply_32x32_rshift32_rounded(outputSampleL, overallOscAmplitudeNow) << 1;
+				outputSampleR = multiply_32x32_rshift32_rounded(outputSampleR, overallOscAmplitudeNow) << 1;
+			}
+
+			if constexpr (clipping) {
+				sound->saturate(&outputSampleL, &saturationWorkingValues[0]);
+				sound->saturate(&outputSampleR, &saturationWorkingValues[1]);
+			}
+
+			// Write to the output buffer, panning or not
+			if constexpr (panning) {
+				outputSample->addPannedStereo(outputSampleL, outputSampleR, amplitudeL, amplitudeR);
+			}
+			else {
+				outputSample->addStereo(outputSampleL, outputSampleR);
+			}
+
+			outputSample++;
+		} while (oscBufferPos != oscBufferEnd);
+	}
+
+	else {
+		int32_t const* const oscBufferEnd = oscBuffer + numSamples;
+		int32_t* __restrict__ outputSample = soundBuffer;
+
+		do {
+			int32_t output = *oscBufferPos;
+
+			if constexpr (applyOverallAmplitude) {
+				overallOscAmplitudeNow += overallOscAmplitudeIncrement;
+				output = multiply_32x32_rshift32_rounded(output, overallOscAmplitudeNow) << 1;
+			}
+
+			if constexpr (clipping) {
+				sound->saturate(&output, &saturationWorkingValues[0]);
+			}
+
+			if constexpr (stereoSoundBuffer) {
+				if constexpr (panning) {
+					((StereoSample*)outputSample)->addPannedMono(output, amplitudeL, amplitudeR);
+				}
+				else {
+					((StereoSample*)outputSample)->addMono(output);
+				}
+				outputSample += 2;
+			}
+			else {
+				*outputSample += output;
+				outputSample++;
+			}
+		} while (++oscBufferPos != oscBufferEnd);
+	}
+}
+
+using VoiceOutputFunction = void (*)(Sound*, uint32_t*, int32_t const*, int32_t*, int32_t, int32_t, int32_t, int32_t,
+                                     int32_t);
+
+// Index bits, from the top: stereo osc buffer, apply overall amplitude, clipping, panning, stereo Sound buffer. A
+// stereo osc buffer always goes to a stereo Sound buffer, and a mono Sound buffer can't be panned, so those bits are
+// dropped where they don't matter, to keep down the number of distinct instances
+template <size_t... i>
+constexpr std::array<VoiceOutputFunction, sizeof...(i)> makeVoiceOutputFunctions(std::index_sequence<i...>) {
+	return {&renderVoiceOutput<(bool)(i & 16), (bool)(i & 8), (bool)(i & 4), (bool)(i & 2) && (i & 17),
+	                           (bool)(i & 1) && !(i & 16)>...};
+}
+
+constexpr auto voiceOutputFunctions = makeVoiceOutputFunctions(std::make_index_sequence<32>());
+
 bool Voice::render(ModelStackWithVoice* modelStack, int32_t* soundBuffer, int32_t numSamples,
                    bool soundRenderingInStereo, bool applyingPanAtVoiceLevel, uint32_t sourcesChanged, bool doLPF,
                    bool doHPF, int32_t externalPitchAdjust) {
@@ -734,15 +834,10 @@ bool Voice::render(ModelStackWithVoice* modelStack, int32_t* soundBuffer, int32_
 
 				int32_t targetValue = combineExpressionValues(sound, i);
 
-				int32_t diff = (targetValue >> 8) - (sourceValues[i + util::to_underlying(PatchSource::X)] >> 8);
-
-				if (diff == 0) {
+				if (!ParamLPF::step(&sourceValues[i + util::to_underlying(PatchSource::X)], targetValue,
+				                    numSamples)) {
 					whichExpressionSourcesCurrentlySmoothing &= ~(1 << i);
 				}
-				else {
-					int32_t amountToAdd = diff * numSamples;
-					sourceValues[i + util::to_underlying(PatchSource::X)] += amountToAdd;
-				}
 			}
 		}
 	}
@@ -1100,8 +1195,9 @@ decidedWhichBufferRenderingInto:
 		sourceAmplitudesNow[s] = sourceAmplitudesLastTime[s];
 	}
 
-	int32_t amplitudeL, amplitudeR;
-	bool doPanning;
+	int32_t amplitudeL = 0;
+	int32_t amplitudeR = 0;
+	bool doPanning = false;
 
 	// If rendering directly into the Sound's buffer, set up for that.
 	// Have to modify amplitudes to get the volume right - factoring the "overall" amplitude, which will now not get used in its normal way, into
@@ -1145,10 +1241,12 @@ decidedWhichBufferRenderingInto:
 			int32_t noiseAmplitude = std::min(n, (int32_t)268435455) >> 2;
 
 			int32_t* __restrict__ thisSample = oscBuffer;
-			do {
+			for (; thisSample + 4 <= oscBufferEnd; thisSample += 4) {
+				vst1q_s32(thisSample, multiply_32x32_rshift32_quad(getNoise_quad(), noiseAmplitude));
+			}
+			for (; thisSample != oscBufferEnd; thisSample++) {
 				*thisSample = multiply_32x32_rshift32(getNoise(), noiseAmplitude);
-				thisSample++;
-			} while (thisSample != oscBufferEnd);
+			}
 
 			anythingInOscBuffer = true;
 		}
@@ -1273,8 +1371,14 @@ decidedWhichBufferRenderingInto:
 			didStereoTempBuffer = true;
 		}
 
+		// FM with every operator feeding back can have its unison parts rendered side by side in NEON lanes instead
+		bool renderedInLanes = synthMode == SynthMode::FM && sound->numUnison > 1
+		                       && renderFMUnisonLanes(sound, oscBuffer, numSamples, stereoUnison, overallPitchAdjust,
+		                                              sourceAmplitudes, sourceAmplitudesNow, sourceAmplitudeIncrements,
+		                                              modulatorsActive, modulatorAmplitudeIncrements);
+
 		// For each unison part
-		for (int32_t u = 0; u < sound->numUnison; u++) {
+		for (int32_t u = 0; !renderedInLanes && u < sound->numUnison; u++) {
 
 			int32_t unisonAmplitudeL, unisonAmplitudeR;
 			shouldDoPanning((stereoUnison ? sound->unisonPan[u] : 0), &unisonAmplitudeL, &unisonAmplitudeR);
@@ -1506,67 +1610,6 @@ skipUnisonPart : {}
 			}
 			// Filters
 			filterSet.renderLongStereo(oscBuffer, oscBufferEnd);
-
-			// No clipping
-			if (!sound->clippingAmount) {
-
-				int32_t const* __restrict__ oscBufferPos = oscBuffer; // For traversal
-				StereoSample* __restrict__ outputSample = (StereoSample*)soundBuffer;
-				int32_t overallOscAmplitudeNow = overallOscAmplitudeLastTime;
-
-				do {
-					int32_t outputSampleL = *(oscBufferPos++);
-					int32_t outputSampleR = *(oscBufferPos++);
-
-					overallOscAmplitudeNow += overallOscillatorAmplitudeIncrement;
-					if (synthMode != SynthMode::FM) {
-						outputSampleL = multiply_32x32_rshift32_rounded(outputSampleL, overallOscAmplitudeNow) << 1;
-						outputSampleR = multiply_32x32_rshift32_rounded(outputSampleR, overallOscAmplitudeNow) << 1;
-					}
-
-					// Write to the output buffer, panning or not
-					if (doPanning) {
-						outputSample->addPannedStereo(outputSampleL, outputSampleR, amplitudeL, amplitudeR);
-					}
-					else {
-						outputSample->addStereo(outputSampleL, outputSampleR);
-					}
-
-					outputSample++;
-				} while (oscBufferPos != oscBufferEnd);
-			}
-
-			// Yes clipping
-			else {
-
-				int32_t const* __restrict__ oscBufferPos = oscBuffer; // For traversal
-				StereoSample* __restrict__ outputSample = (StereoSample*)soundBuffer;
-				int32_t overallOscAmplitudeNow = overallOscAmplitudeLastTime;
-
-				do {
-					int32_t outputSampleL = *(oscBufferPos++);
-					int32_t outputSampleR = *(oscBufferPos++);
-
-					overallOscAmplitudeNow += overallOscillatorAmplitudeIncrement;
-					if (synthMode != SynthMode::FM) {
-						outputSampleL = multiply_32x32_rshift32_rounded(outputSampleL, overallOscAmplitudeNow) << 1;
-						outputSampleR = multiply_32x32_rshift32_rounded(outputSampleR, overallOscAmplitudeNow) << 1;
-					}
-
-					sound->saturate(&outputSampleL, &lastSaturationTanHWorkingValue[0]);
-					sound->saturate(&outputSampleR, &lastSaturationTanHWorkingValue[1]);
-
-					// Write to the output buffer, panning or not
-					if (doPanning) {
-						outputSample->addPannedStereo(outputSampleL, outputSampleR, amplitudeL, amplitudeR);
-					}
-					else {
-						outputSample->addStereo(outputSampleL, outputSampleR);
-					}
-
-					outputSample++;
-				} while (oscBufferPos != oscBufferEnd);
-			}
 		}
 		else {
 			/*
@@ -1589,69 +1632,23 @@ skipUnisonPart : {}
 			}
 
 			filterSet.renderLong(oscBuffer, oscBufferEnd, numSamples);
+		}
 
-			// No clipping
-			if (!sound->clippingAmount) {
-				int32_t const* __restrict__ oscBufferPos = oscBuffer; // For traversal
-				int32_t* __restrict__ outputSample = soundBuffer;
-				int32_t overallOscAmplitudeNow = overallOscAmplitudeLastTime;
-
-				do {
-					int32_t output = *oscBufferPos;
-
-					if (synthMode != SynthMode::FM) {
-						overallOscAmplitudeNow += overallOscillatorAmplitudeIncrement;
-						output = multiply_32x32_rshift32_rounded(output, overallOscAmplitudeNow) << 1;
-					}
-
-					if (soundRenderingInStereo) {
-						if (doPanning) {
-							((StereoSample*)outputSample)->addPannedMono(output, amplitudeL, amplitudeR);
-						}
-						else {
-							((StereoSample*)outputSample)->addMono(output);
-						}
-						outputSample += 2;
-					}
-					else {
-						*outputSample += output;
-						outputSample++;
-					}
-				} while (++oscBufferPos != oscBufferEnd);
-			}
-
-			// Yes clipping
-			else {
-				int32_t const* __restrict__ oscBufferPos = oscBuffer; // For traversal
-				int32_t* __restrict__ outputSample = soundBuffer;
-				int32_t overallOscAmplitudeNow = overallOscAmplitudeLastTime;
-
-				do {
-					int32_t output = *oscBufferPos;
-
-					if (synthMode != SynthMode::FM) {
-						overallOscAmplitudeNow += overallOscillatorAmplitudeIncrement;
-						output = multiply_32x32_rshift32_rounded(output, overallOscAmplitudeNow) << 1;
-					}
-
-					sound->saturate(&output, &lastSaturationTanHWorkingValue[0]);
+		// And output, through whichever specialisation of the loop suits this render
+		int32_t outputFunction = (didStereoTempBuffer << 4) | ((synthMode != SynthMode::FM) << 3)
+		                         | ((sound->clippingAmount != 0) << 2) | (doPanning << 1) | soundRenderingInStereo;
+		voiceOutputFunctions[outputFunction](sound, lastSaturationTanHWorkingValue, oscBuffer, soundBuffer, numSamples,
+		                                     overallOscAmplitudeLastTime, overallOscillatorAmplitudeIncrement,
+		                                     amplitudeL, amplitudeR);
+	}
 
-					if (soundRenderingInStereo) {
-						if (doPanning) {
-							((StereoSample*)outputSample)->addPannedMono(output, amplitudeL, amplitudeR);
-						}
-						else {
-							((StereoSample*)outputSample)->addMono(output);
-						}
-						outputSample += 2;
-					}
-					else {
-						*outputSample += output;
-						outputSample++;
-					}
-				} while (++oscBufferPos != oscBufferEnd);
-			}
-		}
+	// If rendering directly into the Sound's buffer, we can't tell our own output from anything else's, so go by amplitude
+	if (latencySource != Debug::LatencySource::NONE && overallOscAmplitude
+	    && (renderingDirectlyIntoSoundBuffer
+	        || std::any_of(oscBuffer, oscBuffer + (numSamples << didStereoTempBuffer),
+	                       [](int32_t sample) { return sample != 0; }))) {
+		Debug::noteLatency.voiceSounded(latencySource, latencyInputTime);
+		latencySource = Debug::LatencySource::NONE;
 	}
 
 renderingDone:
@@ -1665,6 +1662,11 @@ renderingDone:
 	}
 	overallOscAmplitudeLastTime = overallOscAmplitude;
 
+	// If a retrigger was waiting for this render to fade us out, we can now start again from the top
+	if (unassignVoiceAfter && retriggerPending) {
+		unassignVoiceAfter = !doPendingRetrigger(modelStack);
+	}
+
 	return !unassignVoiceAfter;
 }
 
@@ -1982,6 +1984,262 @@ void Voice::renderFMWithFeedbackAdd(int32_t* bufferStart, int32_t numSamples, in
 	}
 }
 
+// doFMNew() on each lane
+[[gnu::always_inline]] static inline int32x4_t doFMLanes(uint32x4_t carrierPhase, uint32x4_t phaseShift) {
+	uint32x4_t phaseSmall = vaddq_u32(vshrq_n_u32(carrierPhase, 8), phaseShift);
+	int32x4_t strength2 = vreinterpretq_s32_u32(vandq_u32(phaseSmall, vdupq_n_u32(65535)));
+
+	uint32_t whichValue[4];
+	vst1q_u32(whichValue, vandq_u32(vshrq_n_u32(phaseSmall, 16), vdupq_n_u32(255)));
+	uint32x4_t readValue = vdupq_n_u32(0);
+	readValue = vld1q_lane_u32((uint32_t const*)&sineWaveDiff[whichValue[0] << 1], readValue, 0);
+	readValue = vld1q_lane_u32((uint32_t const*)&sineWaveDiff[whichValue[1] << 1], readValue, 1);
+	readValue = vld1q_lane_u32((uint32_t const*)&sineWaveDiff[whichValue[2] << 1], readValue, 2);
+	readValue = vld1q_lane_u32((uint32_t const*)&sineWaveDiff[whichValue[3] << 1], readValue, 3);
+
+	int32x4_t value = vreinterpretq_s32_u32(vshlq_n_u32(readValue, 16));
+	int32x4_t diff = vshrq_n_s32(vreinterpretq_s32_u32(readValue), 16);
+	return vmlaq_s32(value, diff, strength2);
+}
+
+// signed_saturate<22>() of the feedback amount applied to the last output, as each operator does to feed itself back
+[[gnu::always_inline]] static inline uint32x4_t getFeedbackLanes(int32x4_t feedbackValue, int32_t feedbackAmount) {
+	int32x4_t feedback = multiply_32x32_rshift32_quad(feedbackValue, feedbackAmount);
+	feedback = vmaxq_s32(vminq_s32(feedback, vdupq_n_s32((1 << 21) - 1)), vdupq_n_s32(-(1 << 21)));
+	return vreinterpretq_u32_s32(feedback);
+}
+
+// Adds a vector's four lanes together
+[[gnu::always_inline]] static inline int32_t addLanes(int32x4_t value) {
+	int32x2_t sum = vadd_s32(vget_low_s32(value), vget_high_s32(value));
+	return vget_lane_s32(vpadd_s32(sum, sum), 0);
+}
+
+// FM where every operator feeds back on itself can't be vectorised along the buffer, since each sample depends on the
+// one before. The unison parts are independent of each other though, so this renders up to four of them at once, one
+// per lane, sample by sample - giving exactly what the per-part loop in render() would. Returns false, having changed
+// nothing, if the parts don't all render the same operators or any rendered operator has no feedback; the per-part
+// loop does those.
+bool Voice::renderFMUnisonLanes(Sound* sound, int32_t* oscBuffer, int32_t numSamples, bool stereoUnison,
+                                int32_t overallPitchAdjust, int32_t* sourceAmplitudes,
+                                int32_t const* sourceAmplitudesNow, int32_t const* sourceAmplitudeIncrements,
+                                bool* modulatorsActive, int32_t const* modulatorAmplitudeIncrements) {
+
+	int32_t numUnison = sound->numUnison;
+
+	// Work out each part's phase increments just like the per-part loop does. That also switches off any source or
+	// modulator whose pitch goes too high, for that part and all after it - so if that happens partway through, the
+	// parts aren't all rendered alike and we put everything back for the loop to deal with
+	int32_t sourceAmplitudesBefore[kNumSources];
+	bool modulatorsActiveBefore[kNumModulators];
+	memcpy(sourceAmplitudesBefore, sourceAmplitudes, sizeof(sourceAmplitudesBefore));
+	memcpy(modulatorsActiveBefore, modulatorsActive, sizeof(modulatorsActiveBefore));
+
+	uint32_t phaseIncrements[kMaxNumVoicesUnison][kNumSources];
+	uint32_t phaseIncrementsModulator[kMaxNumVoicesUnison][kNumModulators];
+	int32_t sourceAmplitudesForFirstPart[kNumSources];
+	bool modulatorsActiveForFirstPart[kNumModulators];
+
+	for (int32_t u = 0; u < numUnison; u++) {
+		for (int32_t s = 0; s < kNumSources; s++) {
+			phaseIncrements[u][s] = unisonParts[u].sources[s].phaseIncrementStoredValue;
+			if (overallPitchAdjust != 16777216 && !adjustPitch(&phaseIncrements[u][s], overallPitchAdjust)) {
+				sourceAmplitudes[s] = 0;
+			}
+			if (!adjustPitch(&phaseIncrements[u][s], paramFinalValues[Param::Local::OSC_A_PITCH_ADJUST + s])) {
+				sourceAmplitudes[s] = 0;
+			}
+		}
+
+		for (int32_t m = 0; m < kNumModulators; m++) {
+			phaseIncrementsModulator[u][m] = unisonParts[u].modulatorPhaseIncrement[m];
+			if (phaseIncrementsModulator[u][m] == 0xFFFFFFFF) {
+				modulatorsActive[m] = false;
+			}
+			if (overallPitchAdjust != 16777216 && modulatorsActive[m]
+			    && !adjustPitch(&phaseIncrementsModulator[u][m], overallPitchAdjust)) {
+				modulatorsActive[m] = false;
+			}
+			if (modulatorsActive[m]
+			    && !adjustPitch(&phaseIncrementsModulator[u][m],
+			                    paramFinalValues[Param::Local::MODULATOR_0_PITCH_ADJUST + m])) {
+				modulatorsActive[m] = false;
+			}
+		}
+
+		if (u == 0) {
+			memcpy(sourceAmplitudesForFirstPart, sourceAmplitudes, sizeof(sourceAmplitudesForFirstPart));
+			memcpy(modulatorsActiveForFirstPart, modulatorsActive, sizeof(modulatorsActiveForFirstPart));
+		}
+	}
+
+	// Which operators get rendered, following the same cases as render(). If mod1 would only be feeding an inactive
+	// mod0, neither gets rendered.
+	bool renderModulator0 = modulatorsActive[0];
+	bool renderModulator1 = modulatorsActive[1] && (renderModulator0 || !sound->modulator1ToModulator0);
+	bool modulator1ToModulator0 = renderModulator1 && sound->modulator1ToModulator0;
+	bool carriersModulated = renderModulator0 || (renderModulator1 && !modulator1ToModulator0);
+
+	int32_t modulatorFeedbackAmounts[kNumModulators];
+	int32_t carrierFeedbackAmounts[kNumSources];
+	bool allFeedingBack = true;
+	for (int32_t m = 0; m < kNumModulators; m++) {
+		modulatorFeedbackAmounts[m] = paramFinalValues[Param::Local::MODULATOR_0_FEEDBACK + m];
+		bool rendered = m ? renderModulator1 : renderModulator0;
+		if (rendered && !modulatorFeedbackAmounts[m]) {
+			allFeedingBack = false;
+		}
+	}
+	for (int32_t s = 0; s < kNumSources; s++) {
+		carrierFeedbackAmounts[s] = paramFinalValues[Param::Local::CARRIER_0_FEEDBACK + s];
+		if (sourceAmplitudes[s] && !carrierFeedbackAmounts[s]) {
+			allFeedingBack = false;
+		}
+	}
+
+	if (!allFeedingBack || memcmp(sourceAmplitudesForFirstPart, sourceAmplitudes, sizeof(sourceAmplitudesForFirstPart))
+	    || memcmp(modulatorsActiveForFirstPart, modulatorsActive, sizeof(modulatorsActiveForFirstPart))) {
+		memcpy(sourceAmplitudes, sourceAmplitudesBefore, sizeof(sourceAmplitudesBefore));
+		memcpy(modulatorsActive, modulatorsActiveBefore, sizeof(modulatorsActiveBefore));
+		return false;
+	}
+
+	for (int32_t firstPart = 0; firstPart < numUnison; firstPart += 4) {
+		int32_t numLanes = std::min<int32_t>(numUnison - firstPart, 4);
+
+		uint32_t modulatorPhase[kNumModulators][4] = {0};
+		uint32_t modulatorPhaseIncrement[kNumModulators][4] = {0};
+		int32_t modulatorFeedback[kNumModulators][4] = {0};
+		uint32_t carrierPhase[kNumSources][4] = {0};
+		uint32_t carrierPhaseIncrement[kNumSources][4] = {0};
+		int32_t carrierFeedback[kNumSources][4] = {0};
+		int32_t laneMask[4] = {0};
+		int32_t laneAmplitudeL[4] = {0};
+		int32_t laneAmplitudeR[4] = {0};
+
+		for (int32_t l = 0; l < numLanes; l++) {
+			VoiceUnisonPart* part = &unisonParts[firstPart + l];
+			for (int32_t m = 0; m < kNumModulators; m++) {
+				modulatorPhase[m][l] = part->modulatorPhase[m];
+				modulatorPhaseIncrement[m][l] = phaseIncrementsModulator[firstPart + l][m];
+				modulatorFeedback[m][l] = part->modulatorFeedback[m];
+			}
+			for (int32_t s = 0; s < kNumSources; s++) {
+				carrierPhase[s][l] = part->sources[s].oscPos;
+				carrierPhaseIncrement[s][l] = phaseIncrements[firstPart + l][s];
+				carrierFeedback[s][l] = part->sources[s].carrierFeedback;
+			}
+			laneMask[l] = -1;
+			if (stereoUnison) {
+				shouldDoPanning(sound->unisonPan[firstPart + l], &laneAmplitudeL[l], &laneAmplitudeR[l]);
+			}
+		}
+
+		uint32x4_t modulatorPhaseVector[kNumModulators];
+		uint32x4_t modulatorPhaseIncrementVector[kNumModulators];
+		int32x4_t modulatorFeedbackVector[kNumModulators];
+		int32_t modulatorAmplitudeNow[kNumModulators];
+		for (int32_t m = 0; m < kNumModulators; m++) {
+			modulatorPhaseVector[m] = vld1q_u32(modulatorPhase[m]);
+			modulatorPhaseIncrementVector[m] = vld1q_u32(modulatorPhaseIncrement[m]);
+			modulatorFeedbackVector[m] = vld1q_s32(modulatorFeedback[m]);
+			modulatorAmplitudeNow[m] = modulatorAmplitudeLastTime[m];
+		}
+		uint32x4_t carrierPhaseVector[kNumSources];
+		uint32x4_t carrierPhaseIncrementVector[kNumSources];
+		int32x4_t carrierFeedbackVector[kNumSources];
+		int32_t carrierAmplitudeNow[kNumSources];
+		for (int32_t s = 0; s < kNumSources; s++) {
+			carrierPhaseVector[s] = vld1q_u32(carrierPhase[s]);
+			carrierPhaseIncrementVector[s] = vld1q_u32(carrierPhaseIncrement[s]);
+			carrierFeedbackVector[s] = vld1q_s32(carrierFeedback[s]);
+			carrierAmplitudeNow[s] = sourceAmplitudesNow[s];
+		}
+		int32x4_t laneMaskVector = vld1q_s32(laneMask);
+		int32x4_t laneAmplitudeLVector = vld1q_s32(laneAmplitudeL);
+		int32x4_t laneAmplitudeRVector = vld1q_s32(laneAmplitudeR);
+
+		for (int32_t i = 0; i < numSamples; i++) {
+			int32x4_t modulation = vdupq_n_s32(0);
+			int32x4_t modulator1Output = vdupq_n_s32(0);
+
+			if (renderModulator1) {
+				uint32x4_t phaseShift = getFeedbackLanes(modulatorFeedbackVector[1], modulatorFeedbackAmounts[1]);
+				modulatorPhaseVector[1] = vaddq_u32(modulatorPhaseVector[1], modulatorPhaseIncrementVector[1]);
+				modulatorFeedbackVector[1] = doFMLanes(modulatorPhaseVector[1], phaseShift);
+				modulatorAmplitudeNow[1] += modulatorAmplitudeIncrements[1];
+				modulator1Output = multiply_32x32_rshift32_quad(modulatorFeedbackVector[1], modulatorAmplitudeNow[1]);
+				modulation = modulator1Output;
+			}
+
+			if (renderModulator0) {
+				uint32x4_t phaseShift = getFeedbackLanes(modulatorFeedbackVector[0], modulatorFeedbackAmounts[0]);
+				if (modulator1ToModulator0) {
+					phaseShift = vaddq_u32(phaseShift, vreinterpretq_u32_s32(modulator1Output));
+				}
+				modulatorPhaseVector[0] = vaddq_u32(modulatorPhaseVector[0], modulatorPhaseIncrementVector[0]);
+				modulatorFeedbackVector[0] = doFMLanes(modulatorPhaseVector[0], phaseShift);
+				modulatorAmplitudeNow[0] += modulatorAmplitudeIncrements[0];
+				if (renderModulator1 && !modulator1ToModulator0) {
+					modulation = multiply_accumulate_32x32_rshift32_rounded_quad(
+					    modulator1Output, modulatorFeedbackVector[0], vdupq_n_s32(modulatorAmplitudeNow[0]));
+				}
+				else {
+					modulation = multiply_32x32_rshift32_quad(modulatorFeedbackVector[0], modulatorAmplitudeNow[0]);
+				}
+			}
+
+			int32x4_t output = vdupq_n_s32(0);
+			for (int32_t s = 0; s < kNumSources; s++) {
+				if (!sourceAmplitudes[s]) {
+					continue;
+				}
+				uint32x4_t phaseShift = getFeedbackLanes(carrierFeedbackVector[s], carrierFeedbackAmounts[s]);
+				if (carriersModulated) {
+					phaseShift = vaddq_u32(phaseShift, vreinterpretq_u32_s32(modulation));
+				}
+				carrierPhaseVector[s] = vaddq_u32(carrierPhaseVector[s], carrierPhaseIncrementVector[s]);
+				carrierFeedbackVector[s] = doFMLanes(carrierPhaseVector[s], phaseShift);
+				carrierAmplitudeNow[s] += sourceAmplitudeIncrements[s];
+				output = vaddq_s32(output, multiply_32x32_rshift32_rounded_quad(carrierFeedbackVector[s],
+				                                                                carrierAmplitudeNow[s]));
+			}
+
+			if (stereoUnison) {
+				oscBuffer[i << 1] += addLanes(multiply_32x32_rshift32_quad(output, laneAmplitudeLVector)) << 2;
+				oscBuffer[(i << 1) + 1] += addLanes(multiply_32x32_rshift32_quad(output, laneAmplitudeRVector)) << 2;
+			}
+			else {
+				oscBuffer[i] += addLanes(vandq_s32(output, laneMaskVector));
+			}
+		}
+
+		for (int32_t m = 0; m < kNumModulators; m++) {
+			vst1q_u32(modulatorPhase[m], modulatorPhaseVector[m]);
+			vst1q_s32(modulatorFeedback[m], modulatorFeedbackVector[m]);
+		}
+		for (int32_t s = 0; s < kNumSources; s++) {
+			vst1q_u32(carrierPhase[s], carrierPhaseVector[s]);
+			vst1q_s32(carrierFeedback[s], carrierFeedbackVector[s]);
+		}
+
+		// Operators that weren't rendered haven't moved, so everything can just be written back
+		for (int32_t l = 0; l < numLanes; l++) {
+			VoiceUnisonPart* part = &unisonParts[firstPart + l];
+			for (int32_t m = 0; m < kNumModulators; m++) {
+				part->modulatorPhase[m] = modulatorPhase[m][l];
+				part->modulatorFeedback[m] = modulatorFeedback[m][l];
+			}
+			for (int32_t s = 0; s < kNumSources; s++) {
+				part->sources[s].oscPos = carrierPhase[s][l];
+				part->sources[s].carrierFeedback = carrierFeedback[s][l];
+			}
+		}
+	}
+
+	return true;
+}
+
 // This function renders all unison for a source/oscillator. Amplitude and the incrementing thereof is done independently for each unison, despite being the same for all
 // of them, and you might be wondering why this is. Yes in the case of an 8-unison sound it'd work out slightly better to apply amplitude to all unison together,
 // but here's why this just generally isn't all that advantageous:
@@ -2004,6 +2262,13 @@ void Voice::renderBasicSource(Sound* sound, ParamManagerForTimeline* paramManage
 
 	GeneralMemoryAllocator::get().checkStack("Voice::renderBasicSource");
 
+	// Plain waves for a whole unison stack can usually all be rendered in one pass
+	if (sound->numUnison > 1 && !doOscSync && !getOutAfterPhaseIncrements
+	    && renderUnisonLanes(sound, s, oscBuffer, numSamples, stereoBuffer, sourceAmplitude, overallPitchAdjust,
+	                         amplitudeIncrement, getPhaseIncrements)) {
+		return;
+	}
+
 	// For each unison part
 	for (int32_t u = 0; u < sound->numUnison; u++) {
 
@@ -2153,8 +2418,15 @@ pitchTooHigh:
 			// If pitch adjustment...
 			if (phaseIncrement != 16777216) {
 
-				// Work out what quality we're going to do that at
-				interpolationBufferSize = sound->sources[s].sampleControls.getInterpolationBufferSize(phaseIncrement);
+				// Work out what quality we're going to do that at. If the CPU's struggling, voices which are releasing or
+				// quiet get stepped down first - each halving of level below 1 << 28 adds 1
+				int32_t inaudibility = (envelopes[0].state >= EnvelopeStage::RELEASE) ? 4 : 0;
+				int32_t amplitudeMagnitude = getMagnitudeOld(sourceAmplitude);
+				if (amplitudeMagnitude < 29) {
+					inaudibility += std::min(29 - amplitudeMagnitude, 6_i32);
+				}
+				interpolationBufferSize =
+				    sound->sources[s].sampleControls.getInterpolationBufferSize(phaseIncrement, inaudibility);
 
 				// And if first render, and other conditions met, see if we can use cache.
 				// It may seem like it'd be a good idea to try and set this up on note-on, rather than here in the rendering routine, but I tried that and the fact is that
@@ -2244,6 +2516,12 @@ dontUseCache : {}
 			// (that is, combining the amplitude increments for the hop crossfades with the overall voice ones, and having multiple crossfading hops write directly
 			// to the osc buffer).
 
+			// Writing a cache which will be what every other voice playing this sample at its own pitch reads, so it gets
+			// done at full quality whatever the CPU load - otherwise writing it would just be abandoned
+			if (voiceSample->isWritingCacheAtOriginalRate()) {
+				interpolationBufferSize = kInterpolationMaxNumSamples;
+			}
+
 			bool stillActive = voiceSample->render(
 			    &guides[s], renderBuffer, numSamples, sample, numChannels, loopingType, phaseIncrement,
 			    timeStretchRatio, sourceAmplitude, amplitudeIncrement, interpolationBufferSize,
@@ -2727,6 +3005,383 @@ const int16_t* analogSawTables[] = {
     mysterySynthBSaw_53,   mysterySynthBSaw_39,   mysterySynthBSaw_27,  mysterySynthBSaw_19,  mysterySynthBSaw_13,
     mysterySynthBSaw_9,    mysterySynthBSaw_7,    mysterySynthBSaw_5,   mysterySynthBSaw_3,   mysterySynthBSaw_1};
 
+// Picks the anti-aliased table for a triangle too high in pitch to get away with the crude one
+static const int16_t* getTriangleTable(uint32_t phaseIncrement, int32_t* tableSizeMagnitude) {
+	// Size 7
+	if (phaseIncrement <= 429496729) {
+		*tableSizeMagnitude = 7;
+		if (phaseIncrement <= 102261126) {
+			return triangleWaveAntiAliasing21;
+		}
+		else if (phaseIncrement <= 143165576) {
+			return triangleWaveAntiAliasing15;
+		}
+		else if (phaseIncrement <= 238609294) {
+			return triangleWaveAntiAliasing9;
+		}
+		return triangleWaveAntiAliasing5;
+	}
+
+	// Size 6
+	*tableSizeMagnitude = 6;
+	if (phaseIncrement <= 715827882) {
+		return triangleWaveAntiAliasing3;
+	}
+	return triangleWaveAntiAliasing1;
+}
+
+// The unison renderer below gives each unison part a lane, four to a vector, so that a whole unison stack gets rendered
+// in one pass over the osc buffer rather than one pass per part. It only does the waves whose every sample can be
+// worked out from that part's phase alone - the crude ones, and the interpolated single-table ones. Every lane does
+// exactly the maths renderOsc() would have done for that part, so the output doesn't change, just the cost.
+
+enum class UnisonLaneWave {
+	CRUDE_SAW,
+	CRUDE_SQUARE,
+	CRUDE_TRIANGLE,
+	TABLE,
+};
+
+static_assert(kMaxNumVoicesUnison % 4 == 0, "Unison parts are rendered four lanes to a vector");
+constexpr int32_t kNumUnisonLaneVectors = kMaxNumVoicesUnison / 4;
+
+struct UnisonLanes {
+	int32_t numVectors;
+	uint32x4_t phase[kNumUnisonLaneVectors];
+	uint32x4_t phaseIncrement[kNumUnisonLaneVectors];
+	int32x4_t amplitudeL[kNumUnisonLaneVectors]; // For a mono buffer, this is just a mask of which lanes are in use
+	int32x4_t amplitudeR[kNumUnisonLaneVectors];
+
+	// Table waves only. The shifts are negative, for vshlq_u32(), as each lane may have a different size table
+	int16_t const* table[kMaxNumVoicesUnison];
+	int32x4_t whichValueShift[kNumUnisonLaneVectors];
+	int32x4_t strengthShift[kNumUnisonLaneVectors];
+};
+
+// One sample for each of a vector's four unison parts, with amplitude applied - the same values renderOsc() would
+// have summed into its buffer for those parts
+template <UnisonLaneWave wave>
+[[gnu::always_inline]] static inline int32x4_t getUnisonLaneValues(UnisonLanes const& lanes, int32_t v,
+                                                                   int32_t amplitudeNow, uint32_t pulseWidth) {
+	uint32x4_t phase = lanes.phase[v];
+
+	if constexpr (wave == UnisonLaneWave::CRUDE_SAW) {
+		return multiply_32x32_rshift32_rounded_quad(vreinterpretq_s32_u32(phase), amplitudeNow);
+	}
+
+	else if constexpr (wave == UnisonLaneWave::CRUDE_SQUARE) {
+		// getSquare()
+		int32x4_t value = vbslq_s32(vcgeq_u32(phase, vdupq_n_u32(pulseWidth)), vdupq_n_s32(-2147483648),
+		                            vdupq_n_s32(2147483647));
+		return multiply_32x32_rshift32_rounded_quad(value, amplitudeNow);
+	}
+
+	else if constexpr (wave == UnisonLaneWave::CRUDE_TRIANGLE) {
+		// getTriangleSmall()
+		uint32x4_t folded =
+		    vbslq_u32(vcgeq_u32(phase, vdupq_n_u32(2147483648u)), vsubq_u32(vdupq_n_u32(0), phase), phase);
+		int32x4_t value = vsubq_s32(vreinterpretq_s32_u32(folded), vdupq_n_s32(1073741824));
+		return multiply_32x32_rshift32_rounded_quad(value, amplitudeNow);
+	}
+
+	else {
+		// As waveRenderingFunctionGeneral(), but each lane reading from its own table
+		uint32x4_t whichValue = vshlq_u32(phase, lanes.whichValueShift[v]);
+		uint16x4_t strength2 = vshr_n_u16(vmovn_u32(vshlq_u32(phase, lanes.strengthShift[v])), 1);
+
+		int16_t const* const* table = &lanes.table[v * 4];
+		uint32x4_t readValue = vdupq_n_u32(0);
+		readValue = vld1q_lane_u32((uint32_t const*)&table[0][vgetq_lane_u32(whichValue, 0)], readValue, 0);
+		readValue = vld1q_lane_u32((uint32_t const*)&table[1][vgetq_lane_u32(whichValue, 1)], readValue, 1);
+		readValue = vld1q_lane_u32((uint32_t const*)&table[2][vgetq_lane_u32(whichValue, 2)], readValue, 2);
+		readValue = vld1q_lane_u32((uint32_t const*)&table[3][vgetq_lane_u32(whichValue, 3)], readValue, 3);
+
+		int16x4_t value1 = vreinterpret_s16_u16(vmovn_u32(readValue));
+		int16x4_t value2 = vreinterpret_s16_u16(vshrn_n_u32(readValue, 16));
+		int16x4_t difference = vsub_s16(value2, value1);
+		int32x4_t value = vqdmlal_s16(vshll_n_s16(value1, 16), difference, vreinterpret_s16_u16(strength2));
+		return vqdmulhq_n_s32(value, amplitudeNow);
+	}
+}
+
+// For waves other than tables, amplitude is incremented before each sample, as in renderCrudeSawWaveWithAmplitude().
+// For tables, it follows the per-lane pattern SETUP_FOR_APPLYING_AMPLITUDE_WITH_VECTORS() gives renderWave().
+template <UnisonLaneWave wave, bool stereo>
+static void renderUnisonLaneSamples(UnisonLanes& lanes, int32_t* __restrict__ oscBuffer, int32_t numSamples,
+                                    int32_t amplitude, int32_t amplitudeIncrement, uint32_t pulseWidth) {
+	int32_t tableAmplitudes[4];
+	if constexpr (wave == UnisonLaneWave::TABLE) {
+		for (int32_t i = 0; i < 4; i++) {
+			amplitude += amplitudeIncrement;
+			tableAmplitudes[i] = amplitude >> 1;
+		}
+	}
+
+	for (int32_t i = 0; i < numSamples; i++) {
+		int32_t amplitudeNow;
+		if constexpr (wave == UnisonLaneWave::TABLE) {
+			amplitudeNow = tableAmplitudes[i & 3];
+			if ((i & 3) == 3) {
+				for (int32_t j = 0; j < 4; j++) {
+					tableAmplitudes[j] += amplitudeIncrement << 1;
+				}
+			}
+		}
+		else {
+			amplitude += amplitudeIncrement;
+			amplitudeNow = amplitude;
+		}
+
+		int32x4_t sumL = vdupq_n_s32(0);
+		int32x4_t sumR = vdupq_n_s32(0);
+		for (int32_t v = 0; v < lanes.numVectors; v++) {
+			lanes.phase[v] = vaddq_u32(lanes.phase[v], lanes.phaseIncrement[v]);
+			int32x4_t value = getUnisonLaneValues<wave>(lanes, v, amplitudeNow, pulseWidth);
+
+			if constexpr (stereo) {
+				sumL = vaddq_s32(sumL, multiply_32x32_rshift32_quad(value, lanes.amplitudeL[v]));
+				sumR = vaddq_s32(sumR, multiply_32x32_rshift32_quad(value, lanes.amplitudeR[v]));
+			}
+			else {
+				sumL = vaddq_s32(sumL, vandq_s32(value, lanes.amplitudeL[v]));
+			}
+		}
+
+		// Only now, with all the parts summed across their lanes, does anything get written to the buffer
+		if constexpr (stereo) {
+			int32x2_t sum = vpadd_s32(vadd_s32(vget_low_s32(sumL), vget_high_s32(sumL)),
+			                          vadd_s32(vget_low_s32(sumR), vget_high_s32(sumR)));
+			vst1_s32(&oscBuffer[i << 1], vadd_s32(vld1_s32(&oscBuffer[i << 1]), vshl_n_s32(sum, 2)));
+		}
+		else {
+			int32x2_t sum = vadd_s32(vget_low_s32(sumL), vget_high_s32(sumL));
+			oscBuffer[i] += vget_lane_s32(vpadd_s32(sum, sum), 0);
+		}
+	}
+}
+
+template <bool stereo>
+static void renderUnisonLaneWave(UnisonLaneWave wave, UnisonLanes& lanes, int32_t* __restrict__ oscBuffer,
+                                 int32_t numSamples, int32_t amplitude, int32_t amplitudeIncrement,
+                                 uint32_t pulseWidth) {
+	switch (wave) {
+	case UnisonLaneWave::CRUDE_SAW:
+		renderUnisonLaneSamples<UnisonLaneWave::CRUDE_SAW, stereo>(lanes, oscBuffer, numSamples, amplitude,
+		                                                           amplitudeIncrement, pulseWidth);
+		break;
+	case UnisonLaneWave::CRUDE_SQUARE:
+		renderUnisonLaneSamples<UnisonLaneWave::CRUDE_SQUARE, stereo>(lanes, oscBuffer, numSamples, amplitude,
+		                                                              amplitudeIncrement, pulseWidth);
+		break;
+	case UnisonLaneWave::CRUDE_TRIANGLE:
+		renderUnisonLaneSamples<UnisonLaneWave::CRUDE_TRIANGLE, stereo>(lanes, oscBuffer, numSamples, amplitude,
+		                                                                amplitudeIncrement, pulseWidth);
+		break;
+	case UnisonLaneWave::TABLE:
+		renderUnisonLaneSamples<UnisonLaneWave::TABLE, stereo>(lanes, oscBuffer, numSamples, amplitude,
+		                                                       amplitudeIncrement, pulseWidth);
+		break;
+	}
+}
+
+// Renders all of a source's unison parts in one go, if they're all waves the lanes can do. Returns false, having
+// rendered nothing and touched no phases, if not - e.g. pulse width on the table waves, or parts straddling the
+// crude / anti-aliased switchover - in which case renderBasicSource() just does them one at a time as usual. Any
+// getPhaseIncrements filled in by then hold the same values that will get written again.
+bool Voice::renderUnisonLanes(Sound* sound, int32_t s, int32_t* oscBuffer, int32_t numSamples, bool stereoBuffer,
+                              int32_t sourceAmplitude, int32_t overallPitchAdjust, int32_t amplitudeIncrement,
+                              uint32_t* getPhaseIncrements) {
+
+	OscType type = sound->sources[s].oscType;
+	uint32_t pulseWidth = (uint32_t)lshiftAndSaturate<1>(paramFinalValues[Param::Local::OSC_A_PHASE_WIDTH + s]);
+
+	switch (type) {
+	case OscType::SINE:
+	case OscType::TRIANGLE:
+	case OscType::SAW:
+	case OscType::ANALOG_SAW_2:
+	case OscType::ANALOG_SQUARE:
+		// Pulse width on these means renderOsc() does it with osc sync
+		if (pulseWidth) {
+			return false;
+		}
+		break;
+
+	case OscType::SQUARE:
+		break;
+
+	default:
+		return false;
+	}
+
+	bool stereoUnison = sound->unisonStereoSpread && sound->numUnison > 1 && stereoBuffer;
+
+	UnisonLaneWave wave = UnisonLaneWave::TABLE;
+	int32_t laneParts[kMaxNumVoicesUnison];
+	uint32_t phaseIncrements[kMaxNumVoicesUnison];
+	int16_t const* tables[kMaxNumVoicesUnison];
+	int32_t tableSizeMagnitudes[kMaxNumVoicesUnison];
+	int32_t numLanes = 0;
+
+	for (int32_t u = 0; u < sound->numUnison; u++) {
+		VoiceUnisonPartSource* voiceUnisonPartSource = &unisonParts[u].sources[s];
+		if (!voiceUnisonPartSource->active) {
+			continue;
+		}
+
+		uint32_t phaseIncrement = voiceUnisonPartSource->phaseIncrementStoredValue;
+		if (!adjustPitch(&phaseIncrement, overallPitchAdjust)
+		    || !adjustPitch(&phaseIncrement, paramFinalValues[Param::Local::OSC_A_PITCH_ADJUST + s])) {
+			if (getPhaseIncrements) {
+				getPhaseIncrements[u] = 0;
+			}
+			continue;
+		}
+		if (getPhaseIncrements) {
+			getPhaseIncrements[u] = phaseIncrement;
+		}
+
+		// Make the same choice of wave that renderOsc() would for this part
+		UnisonLaneWave waveThisPart = UnisonLaneWave::TABLE;
+		int16_t const* table = nullptr;
+		int32_t tableSizeMagnitude = 16;
+
+		if (type == OscType::SINE) {
+			table = sineWaveSmall;
+			tableSizeMagnitude = 8;
+		}
+
+		else if (type == OscType::TRIANGLE) {
+			if (phaseIncrement < 69273666 || AudioEngine::cpuDireness >= 7) {
+				waveThisPart = UnisonLaneWave::CRUDE_TRIANGLE;
+			}
+			else {
+				table = getTriangleTable(phaseIncrement, &tableSizeMagnitude);
+			}
+		}
+
+		else {
+			uint32_t phaseIncrementForCalculations = phaseIncrement;
+			if (type == OscType::SQUARE && pulseWidth) {
+				phaseIncrementForCalculations = phaseIncrement * 0.6;
+			}
+
+			int32_t tableNumber;
+			getTableNumber(phaseIncrementForCalculations, &tableNumber, &tableSizeMagnitude);
+			bool crude = (tableNumber < AudioEngine::cpuDireness + 6);
+
+			if (type == OscType::SAW || (type == OscType::ANALOG_SAW_2 && tableNumber >= 8 && crude)) {
+				if (crude) {
+					waveThisPart = UnisonLaneWave::CRUDE_SAW;
+				}
+				else {
+					table = sawTables[tableNumber];
+				}
+			}
+			else if (type == OscType::SQUARE) {
+				if (crude) {
+					waveThisPart = UnisonLaneWave::CRUDE_SQUARE;
+				}
+				else if (pulseWidth) {
+					return false; // That's renderPulseWave()'s job
+				}
+				else {
+					table = squareTables[tableNumber];
+				}
+			}
+			else if (type == OscType::ANALOG_SAW_2) {
+				table = analogSawTables[tableNumber];
+			}
+			else {
+				table = analogSquareTables[tableNumber];
+			}
+		}
+
+		if (numLanes && waveThisPart != wave) {
+			return false;
+		}
+		wave = waveThisPart;
+
+		laneParts[numLanes] = u;
+		phaseIncrements[numLanes] = phaseIncrement;
+		tables[numLanes] = table;
+		tableSizeMagnitudes[numLanes] = tableSizeMagnitude;
+		numLanes++;
+	}
+
+	if (!numLanes) {
+		return true;
+	}
+
+	// From here on, we're committed. Fill the lanes, with any left over at the end sitting silent.
+	UnisonLanes lanes;
+	lanes.numVectors = (numLanes + 3) >> 2;
+	for (int32_t v = 0; v < lanes.numVectors; v++) {
+		uint32_t phase[4];
+		uint32_t phaseIncrement[4];
+		int32_t amplitudeL[4];
+		int32_t amplitudeR[4];
+		int32_t whichValueShift[4];
+		int32_t strengthShift[4];
+
+		for (int32_t i = 0; i < 4; i++) {
+			int32_t l = v * 4 + i;
+			int32_t lane = (l < numLanes) ? l : 0;
+
+			lanes.table[l] = tables[lane];
+			whichValueShift[i] = -(32 - tableSizeMagnitudes[lane]);
+			strengthShift[i] = -(32 - 16 - tableSizeMagnitudes[lane]);
+
+			if (l < numLanes) {
+				VoiceUnisonPartSource* voiceUnisonPartSource = &unisonParts[laneParts[l]].sources[s];
+				phase[i] = voiceUnisonPartSource->oscPos;
+				phaseIncrement[i] = phaseIncrements[l];
+				voiceUnisonPartSource->oscPos += phaseIncrements[l] * numSamples;
+
+				if (stereoBuffer) {
+					shouldDoPanning((stereoUnison ? sound->unisonPan[laneParts[l]] : 0), &amplitudeL[i],
+					                &amplitudeR[i]);
+				}
+				else {
+					amplitudeL[i] = -1;
+					amplitudeR[i] = -1;
+				}
+			}
+			else {
+				phase[i] = 0;
+				phaseIncrement[i] = 0;
+				amplitudeL[i] = 0;
+				amplitudeR[i] = 0;
+			}
+		}
+
+		lanes.phase[v] = vld1q_u32(phase);
+		lanes.phaseIncrement[v] = vld1q_u32(phaseIncrement);
+		lanes.amplitudeL[v] = vld1q_s32(amplitudeL);
+		lanes.amplitudeR[v] = vld1q_s32(amplitudeR);
+		lanes.whichValueShift[v] = vld1q_s32(whichValueShift);
+		lanes.strengthShift[v] = vld1q_s32(strengthShift);
+	}
+
+	// renderOsc()'s adjustments to amplitude and pulse width for these waves
+	int32_t amplitude = sourceAmplitude;
+	if (wave == UnisonLaneWave::CRUDE_TRIANGLE
+	    || (wave == UnisonLaneWave::TABLE && type != OscType::SINE && type != OscType::TRIANGLE)) {
+		amplitude <<= 1;
+		amplitudeIncrement <<= 1;
+	}
+	pulseWidth += 2147483648u;
+
+	if (stereoBuffer) {
+		renderUnisonLaneWave<true>(wave, lanes, oscBuffer, numSamples, amplitude, amplitudeIncrement, pulseWidth);
+	}
+	else {
+		renderUnisonLaneWave<false>(wave, lanes, oscBuffer, numSamples, amplitude, amplitudeIncrement, pulseWidth);
+	}
+
+	return true;
+}
+
 __attribute__((optimize("unroll-loops"))) void
 Voice::renderOsc(int32_t s, OscType type, int32_t amplitude, int32_t* bufferStart, int32_t* bufferEnd,
                  int32_t numSamples, uint32_t phaseIncrement, uint32_t pulseWidth, uint32_t* startPhase,
@@ -2927,34 +3582,7 @@ doSine:
 		}
 
 		else {
-
-			// Size 7
-			if (phaseIncrement <= 429496729) {
-				tableSizeMagnitude = 7;
-				if (phaseIncrement <= 102261126) {
-					table = triangleWaveAntiAliasing21;
-				}
-				else if (phaseIncrement <= 143165576) {
-					table = triangleWaveAntiAliasing15;
-				}
-				else if (phaseIncrement <= 238609294) {
-					table = triangleWaveAntiAliasing9;
-				}
-				else if (phaseIncrement <= 429496729) {
-					table = triangleWaveAntiAliasing5;
-				}
-			}
-
-			// Size 6
-			else {
-				tableSizeMagnitude = 6;
-				if (phaseIncrement <= 715827882) {
-					table = triangleWaveAntiAliasing3;
-				}
-				else {
-					table = triangleWaveAntiAliasing1;
-				}
-			}
+			table = getTriangleTable(phaseIncrement, &tableSizeMagnitude);
 			goto callRenderWave;
 		}
 	}
@@ -3208,6 +3836,42 @@ bool Voice::doFastRelease(uint32_t releaseIncrement) {
 	}
 }
 
+// For a same-note retrigger of a Voice playing only samples, which would otherwise be fast-released while a whole new
+// Voice got set up alongside it. Instead, fade this one out over just its next render, then have it restart itself from
+// there, keeping its VoiceSamples and the Clusters they've got - see doPendingRetrigger(). Only call if doneFirstRender.
+void Voice::retriggerAfterDeclick(int32_t newNoteCodeBeforeArpeggiation, uint8_t velocity, int32_t newFromMIDIChannel,
+                                  const int16_t* mpeValues) {
+	inputCharacteristics[util::to_underlying(MIDICharacteristic::NOTE)] = newNoteCodeBeforeArpeggiation;
+	inputCharacteristics[util::to_underlying(MIDICharacteristic::CHANNEL)] = newFromMIDIChannel;
+	retriggerVelocity = velocity;
+	memcpy(retriggerMPEValues, mpeValues, sizeof(retriggerMPEValues));
+	retriggerNoteOffReceived = false;
+
+	// If we're already waiting to retrigger, the declick is already underway
+	if (!retriggerPending) {
+		retriggerPending = true;
+		envelopes[0].unconditionalRelease(EnvelopeStage::FAST_RELEASE, 8388608); // Gets to the end in a single render
+	}
+}
+
+// Returns false if fail and we need to unassign
+bool Voice::doPendingRetrigger(ModelStackWithVoice* modelStack) {
+	bool noteOffReceived = retriggerNoteOffReceived;
+
+	// No need to re-randomize osc phases - there are only samples here. The envelopes get reset though, and with them the
+	// amplitudes we last rendered at, which the declick just took to 0 anyway
+	bool success = noteOn(modelStack, inputCharacteristics[util::to_underlying(MIDICharacteristic::NOTE)],
+	                      noteCodeAfterArpeggiation, retriggerVelocity, 0, 0, 0, true,
+	                      inputCharacteristics[util::to_underlying(MIDICharacteristic::CHANNEL)], retriggerMPEValues);
+
+	// A note-off which arrived while we were declicking is for the new note, so give it to that now
+	if (success && noteOffReceived) {
+		noteOff(modelStack);
+	}
+
+	return success;
+}
+
 bool Voice::hasReleaseStage() {
 	return (paramFinalValues[Param::Local::ENV_0_RELEASE] <= 18359);
 }
@@ -3216,21 +3880,107 @@ static_assert(kNumEnvelopeStages < 8, "Too many envelope stages");
 static_assert(kNumVoicePriorities < 4, "Too many priority options");
 
 // Higher numbers are lower priority. 1 is top priority. Will never return 0, because nextVoiceState starts at 1
+// Rough relative cost of rendering one Voice of this Sound, in units of about what one plain sine oscillator costs.
+// Only looks at the Sound's settings, so can be worked out before the Voice is set up. The numbers were arrived at by
+// comparing render times of single voices with each setting changed in isolation - they're just meant to put things in
+// the right order and ballpark.
+uint32_t Voice::estimateCost(Sound* sound) {
+	uint32_t costPerUnison = 0;
+
+	if (sound->synthMode == SynthMode::FM) {
+		costPerUnison += 2 * 3 + kNumModulators * 3; // Carriers and modulators are all sines, but with phase modulation
+	}
+	else {
+		for (int32_t s = 0; s < kNumSources; s++) {
+			Source* source = &sound->sources[s];
+			switch (source->oscType) {
+			case OscType::SINE:
+			case OscType::TRIANGLE:
+				costPerUnison += 1;
+				break;
+
+			case OscType::SQUARE:
+			case OscType::SAW:
+				costPerUnison += 2;
+				break;
+
+			case OscType::ANALOG_SQUARE:
+			case OscType::ANALOG_SAW_2:
+				costPerUnison += 3;
+				break;
+
+			case OscType::WAVETABLE:
+				costPerUnison += 5;
+				break;
+
+			case OscType::SAMPLE: {
+				uint32_t sampleCost = 3;
+				if (source->sampleControls.interpolationMode == InterpolationMode::SMOOTH) {
+					sampleCost += 5; // Windowed sinc vs linear
+				}
+				if (source->repeatMode == SampleRepeatMode::STRETCH
+				    || source->sampleControls.pitchAndSpeedAreIndependent) {
+					sampleCost += 8; // Time stretching means two play heads plus the crossfading
+				}
+				costPerUnison += sampleCost;
+				break;
+			}
+
+			default: // Live input
+				costPerUnison += 2;
+				break;
+			}
+		}
+
+		if (sound->synthMode == SynthMode::RINGMOD) {
+			costPerUnison += 1;
+		}
+		if (sound->oscillatorSync) {
+			costPerUnison += 2;
+		}
+	}
+
+	uint32_t cost = 4 + costPerUnison * sound->numUnison; // Envelopes, LFO, patching etc. only happen once per Voice
+
+	if (sound->lpfMode != FilterMode::OFF) {
+		cost += (sound->lpfMode <= kLastLadder) ? 4 : 3;
+	}
+	if (sound->hpfMode != FilterMode::OFF) {
+		cost += (sound->hpfMode == FilterMode::HPLADDER) ? 4 : 3;
+	}
+
+	return cost;
+}
+
+// Like getPriorityRating(), but among Voices which are otherwise equally good to cull (same manual priority, number of
+// Voices for their Sound, and envelope state), prefers the ones which will save us the most CPU.
+uint32_t Voice::getCullingRating() {
+	uint32_t rating = getPriorityRating();
+	uint32_t ageRating = rating & (0xFFFFFFFF >> 8);
+	uint32_t weighted = std::min<uint64_t>(((uint64_t)(ageRating >> 4) * estimatedCost), (0xFFFFFFFF >> 8));
+	return (rating & ~(0xFFFFFFFF >> 8)) | weighted;
+}
+
 uint32_t Voice::getPriorityRating() {
+	return getPriorityRatingForSound(assignedToSound)
+
+	       // Bits 24-26 - envelope state
+	       + ((uint32_t)envelopes[0].state << 24)
+
+	       // Bits  0-23 - time entered
+	       + ((uint32_t)(-envelopes[0].timeEnteredState) & (0xFFFFFFFF >> 8));
+}
+
+// The part of getPriorityRating() that's the same for all of a Sound's Voices - bits 27-31
+uint32_t Voice::getPriorityRatingForSound(Sound* sound) {
 	return
 	    // Bits 30-31 - manual priority setting
-	    ((uint32_t)(3 - util::to_underlying(assignedToSound->voicePriority)) << 30)
+	    ((uint32_t)(3 - util::to_underlying(sound->voicePriority)) << 30)
 
 	    // Bits 27-29 - how many voices that Sound has
 	    // - that one really does need to go above state, otherwise "once" samples can still cut out synth drones.
 	    // In a perfect world, culling for the purpose of "soliciting" a Voice would also count the new Voice being
 	    // solicited, preferring to cut out that same Sound's old, say, one Voice, than another Sound's only Voice
-	    + ((uint32_t)std::min(assignedToSound->numVoicesAssigned, 7_i32) << 27)
-
-	    // Bits 24-26 - envelope state
-	    + ((uint32_t)envelopes[0].state << 24)
-
-	    // Bits  0-23 - time entered
-	    + ((uint32_t)(-envelopes[0].timeEnteredState) & (0xFFFFFFFF >> 8));
+	    + ((uint32_t)std::min(sound->numVoicesAssigned, 7_i32) << 27);
 }
 #pragma GCC diagnostic pop
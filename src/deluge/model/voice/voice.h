@@ -19,6 +19,7 @@
 
 #include "definitions_cxx.hpp"
 #include "dsp/filter/filter_set.h"
+#include "io/debug/note_latency.h"
 #include "model/voice/voice_sample_playback_guide.h"
 #include "model/voice/voice_unison_part.h"
 #include "modulation/envelope.h"
@@ -28,39 +29,26 @@
 class StereoSample;
 class ModelStackWithVoice;
 using namespace deluge;
-class Voice final {
+// Aligned so that, in its VoiceSlab, each Voice starts on a cache line
+class alignas(CACHE_LINE_SIZE) Voice final {
 public:
 	Voice();
 
-	Patcher patcher;
-
-	// Stores all oscillator positions and stuff, for each Source within each Unison too
-	VoiceUnisonPart unisonParts[kMaxNumVoicesUnison];
-
-	// Stores overall info on each Source (basically just sample memory bounds), for the play-through associated with this Voice right now.
-	VoiceSamplePlaybackGuide guides[kNumSources];
+	// Everything render() goes through on every call comes first, so it's in as few cache lines as it can be. The Patcher
+	// reads sourceValues and writes paramFinalValues, so they're right after it
 
 	Sound* assignedToSound;
 
-	int32_t paramFinalValues[Param::Global::FIRST]; // This is just for the *local* params, specific to this Voice only
+	Patcher patcher;
 
 	// At the start of this list are local copies of the "global" ones. It's cheaper to copy them here than to pick and choose where the Patcher looks for them
 	int32_t sourceValues[kNumPatchSources];
 
-	int32_t localExpressionSourceValuesBeforeSmoothing[kNumExpressionDimensions];
+	int32_t paramFinalValues[Param::Global::FIRST]; // This is just for the *local* params, specific to this Voice only
 
 	Envelope envelopes[kNumEnvelopes];
 	LFO lfo;
 
-	dsp::filter::FilterSet filterSet;
-	int32_t inputCharacteristics[2]; // Contains what used to be called noteCodeBeforeArpeggiation, and fromMIDIChannel
-	int32_t noteCodeAfterArpeggiation;
-
-	uint32_t portaEnvelopePos;
-	int32_t portaEnvelopeMaxAmplitude;
-
-	uint32_t lastSaturationTanHWorkingValue[2];
-
 	int32_t overallOscAmplitudeLastTime;
 	int32_t sourceAmplitudesLastTime[kNumSources];
 	int32_t modulatorAmplitudeLastTime[kNumModulators];
@@ -68,15 +56,48 @@ public:
 
 	int32_t filterGainLastTime;
 
+	uint32_t lastSaturationTanHWorkingValue[2];
+
 	bool doneFirstRender;
 	bool previouslyIgnoredNoteOff;
 	uint8_t whichExpressionSourcesCurrentlySmoothing;
 	uint8_t whichExpressionSourcesFinalValueChanged;
 
+	dsp::filter::FilterSet filterSet;
+
+	// Stores all oscillator positions and stuff, for each Source within each Unison too. Only the first numUnison get
+	// rendered, so these come after everything that always does
+	VoiceUnisonPart unisonParts[kMaxNumVoicesUnison];
+
+	// Stores overall info on each Source (basically just sample memory bounds), for the play-through associated with this Voice right now.
+	VoiceSamplePlaybackGuide guides[kNumSources];
+
+	// The rest is only needed for expression and portamento, at note on / off, or by the AudioEngine's bookkeeping
+
+	int32_t localExpressionSourceValuesBeforeSmoothing[kNumExpressionDimensions];
+
+	int32_t inputCharacteristics[2]; // Contains what used to be called noteCodeBeforeArpeggiation, and fromMIDIChannel
+	int32_t noteCodeAfterArpeggiation;
+
+	uint32_t portaEnvelopePos;
+	int32_t portaEnvelopeMaxAmplitude;
+
 	uint32_t orderSounded;
 
 	int32_t overrideAmplitudeEnvelopeReleaseRate;
 
+	uint32_t estimatedCost; // Set when the Voice is solicited - see estimateCost()
+
+	// If this Voice was sounded by live input, when that was - until it first makes some sound. See NoteLatency
+	uint32_t latencyInputTime;
+	Debug::LatencySource latencySource;
+
+	// A same-note retrigger waiting for this Voice to finish declicking - see retriggerAfterDeclick()
+	bool retriggerPending;
+	bool retriggerNoteOffReceived;
+	uint8_t retriggerVelocity;
+	int16_t retriggerMPEValues[kNumExpressionDimensions];
+
 	Voice* nextUnassigned;
 
 	void setAsUnassigned(ModelStackWithVoice* modelStack, bool deletingSong = false);
@@ -91,12 +112,17 @@ public:
 	            uint32_t samplesLate, bool resetEnvelopes, int32_t fromMIDIChannel, const int16_t* mpeValues);
 	void noteOff(ModelStackWithVoice* modelStack, bool allowReleaseStage = true);
 	bool doFastRelease(uint32_t releaseIncrement = 4096);
+	void retriggerAfterDeclick(int32_t newNoteCodeBeforeArpeggiation, uint8_t velocity, int32_t newFromMIDIChannel,
+	                           const int16_t* mpeValues);
 	void randomizeOscPhases(Sound* sound);
 	void changeNoteCode(ModelStackWithVoice* modelStack, int32_t newNoteCodeBeforeArpeggiation,
 	                    int32_t newNoteCodeAfterArpeggiation, int32_t newInputMIDIChannel, const int16_t* newMPEValues);
 	bool hasReleaseStage();
 	void unassignStuff();
 	uint32_t getPriorityRating();
+	uint32_t getCullingRating();
+	static uint32_t getPriorityRatingForSound(Sound* sound);
+	static uint32_t estimateCost(Sound* sound);
 	void expressionEventImmediate(Sound* sound, int32_t voiceLevelValue, int32_t s);
 	void expressionEventSmooth(int32_t newValue, int32_t s);
 
@@ -112,6 +138,13 @@ private:
 	                       bool* unisonPartBecameInactive, int32_t overallPitchAdjust, bool doOscSync,
 	                       uint32_t* oscSyncPos, uint32_t* oscSyncPhaseIncrements, int32_t amplitudeIncrement,
 	                       uint32_t* getPhaseIncrements, bool getOutAfterPhaseIncrements, int32_t waveIndexIncrement);
+	bool renderUnisonLanes(Sound* sound, int32_t s, int32_t* oscBuffer, int32_t numSamples, bool stereoBuffer,
+	                       int32_t sourceAmplitude, int32_t overallPitchAdjust, int32_t amplitudeIncrement,
+	                       uint32_t* getPhaseIncrements);
+	bool renderFMUnisonLanes(Sound* sound, int32_t* oscBuffer, int32_t numSamples, bool stereoUnison,
+	                         int32_t overallPitchAdjust, int32_t* sourceAmplitudes, int32_t const* sourceAmplitudesNow,
+	                         int32_t const* sourceAmplitudeIncrements, bool* modulatorsActive,
+	                         int32_t const* modulatorAmplitudeIncrements);
 	bool adjustPitch(uint32_t* phaseIncrement, int32_t adjustment);
 
 	void renderSineWaveWithFeedback(int32_t* thisSample, int32_t numSamples, uint32_t* phase, int32_t amplitude,
@@ -124,6 +157,7 @@ private:
 	                             int32_t amplitude, uint32_t phaseIncrement, int32_t feedbackAmount,
 	                             int32_t* lastFeedbackValue, int32_t amplitudeIncrement);
 	bool areAllUnisonPartsInactive(ModelStackWithVoice* modelStackWithVoice);
+	bool doPendingRetrigger(ModelStackWithVoice* modelStack);
 	void setupPorta(Sound* sound);
 	int32_t combineExpressionValues(Sound* sound, int32_t whichExpressionDimension);
 };
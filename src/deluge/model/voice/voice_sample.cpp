@@ -355,6 +355,7 @@ bool VoiceSample::weShouldBeTimeStretchingNow(Sample* sample, SamplePlaybackGuid
 bool VoiceSample::stopReadingFromCache() {
 	// Have to check Cluster is loaded, because we chose not to check this before, cos we didn't know if we'd actually be reading from it
 	if (!clusters[0] || !clusters[0]->loaded) {
+		AudioEngine::voiceStats.numClusterUnderruns++;
 		return false; // If it's not loaded we're screwed - do instant unassign
 	}
 
@@ -401,6 +402,20 @@ bool VoiceSample::stopUsingCache(SamplePlaybackGuide* guide, Sample* sample, int
 static_assert(TimeStretch::kDefaultFirstHopLength >= SSI_TX_BUFFER_NUM_SAMPLES,
               "problems with crossfading out of cache into new timeStretcher");
 
+uint32_t lastCacheLeftForRatesTime = 0;
+
+// Stopping reading a cache means going back to time-stretching or interpolating live, which is costly to set up. When the
+// tempo moves, everything synced to it wants to do that in the same render - so just one gets to each render, and the
+// rest carry on with their caches for now, if they're not too far off
+static bool mayStopReadingCacheForRatesNow(SampleCache* cache, int32_t phaseIncrement, int32_t timeStretchRatio) {
+	if (lastCacheLeftForRatesTime == AudioEngine::audioSampleTimer
+	    && cache->ratesWithin(phaseIncrement, timeStretchRatio, kSampleCacheRateDeferMagnitude)) {
+		return false;
+	}
+	lastCacheLeftForRatesTime = AudioEngine::audioSampleTimer;
+	return true;
+}
+
 // Returning false means instant unassign
 bool VoiceSample::render(SamplePlaybackGuide* guide, int32_t* __restrict__ outputBuffer, int32_t numSamples,
                          Sample* sample, int32_t sampleSourceNumChannels, LoopType loopingType, int32_t phaseIncrement,
@@ -413,11 +428,21 @@ bool VoiceSample::render(SamplePlaybackGuide* guide, int32_t* __restrict__ outpu
 	// If there's a cache, check some stuff. Do this first, cos this can cause us to return
 	if (cache) {
 
+		// A cache being written has to be at exactly its rates. One being read can be a little way off them
+		bool ratesChanged;
+		if (writingToCache) {
+			ratesChanged = (phaseIncrement != cache->phaseIncrement || timeStretchRatio != cache->timeStretchRatio);
+		}
+		else {
+			ratesChanged = !cache->ratesWithin(phaseIncrement, timeStretchRatio, kSampleCacheRateToleranceMagnitude)
+			               && mayStopReadingCacheForRatesNow(cache, phaseIncrement, timeStretchRatio);
+		}
+
 		// If relevant params have changed since before, we have to stop using the cache which those params previously described
-		if (phaseIncrement != cache->phaseIncrement || timeStretchRatio != cache->timeStretchRatio
+		if (ratesChanged
 		    || (phaseIncrement != 16777216
 		        && (desiredInterpolationMode != InterpolationMode::SMOOTH
-		            || (interpolationBufferSize <= 2 && writingToCache)))) {
+		            || (interpolationBufferSize != kInterpolationMaxNumSamples && writingToCache)))) {
 
 			bool needToAvoidClick = (!writingToCache && cache->timeStretchRatio != 16777216);
 			SampleCache* oldCache = cache;
@@ -641,7 +666,7 @@ readCachedWindow:
 				return false;
 			}
 
-			// If linear interpolation, no cache writing (or anything) allowed
+			// If linear or reduced interpolation, no cache writing (or anything) allowed
 			if (interpolationBufferSize != kInterpolationMaxNumSamples) {
 				cache = NULL;
 			}
@@ -861,6 +886,7 @@ uncachedPlayback:
 			if (cachingBytesTilLoopEnd
 			    <= 0) { // Might be less than 0 if it was just changed... although the code that does that is suppose to also detect that we're past it and restart the loop...
 				Debug::println("Loop endpoint reached, writing cache");
+				cache->writingReachedEnd();
 				switchToReadingCacheFromWriting();
 				goto readCachedWindow;
 			}
@@ -869,6 +895,7 @@ uncachedPlayback:
 			int32_t cachingBytesTilWaveformEnd = cacheEndPointBytes - cache->writeBytePos;
 			if (cachingBytesTilWaveformEnd <= 0) { // Probably couldn't actually get below 0?
 				//Debug::println("waveform end reached, writing cache");
+				cache->writingReachedEnd();
 				return false;
 			}
 
@@ -1698,6 +1725,22 @@ void VoiceSample::switchToReadingCacheFromWriting() {
 	endTimeStretching();
 }
 
+// Whether a Sample that isn't at 44.1kHz is being played at about its original pitch - within a semitone - with no
+// time stretching. A cache of that is in effect a 44.1kHz copy of it, which every voice playing it that way can just
+// read, rather than resampling it themselves
+static bool isAtAboutOriginalRate(Sample* sample, int32_t phaseIncrement, int32_t timeStretchRatio) {
+	if (sample->sampleRate == kSampleRate || timeStretchRatio != 16777216) {
+		return false;
+	}
+	int32_t neutralPhaseIncrement = ((uint64_t)sample->sampleRate << 24) / kSampleRate;
+	return std::abs(phaseIncrement - neutralPhaseIncrement) < (neutralPhaseIncrement >> 4);
+}
+
+bool VoiceSample::isWritingCacheAtOriginalRate() {
+	return cache && writingToCache
+	       && isAtAboutOriginalRate(cache->sample, cache->phaseIncrement, cache->timeStretchRatio);
+}
+
 // If returns false, means everything's failed badly and must cut whole VoiceSource (instantUnassign)
 bool VoiceSample::possiblySetUpCache(SampleControls* sampleControls, SamplePlaybackGuide* guide, int32_t phaseIncrement,
                                      int32_t timeStretchRatio, int32_t priorityRating, LoopType loopingType) {
@@ -1712,14 +1755,18 @@ bool VoiceSample::possiblySetUpCache(SampleControls* sampleControls, SamplePlayb
 		return true;
 	}
 
-	bool mayCreate = (sampleControls->getInterpolationBufferSize(phaseIncrement) == kInterpolationMaxNumSamples);
-	cache = ((Sample*)guide->audioFileHolder->audioFile)
-	            ->getOrCreateCache((SampleHolder*)guide->audioFileHolder, phaseIncrement, timeStretchRatio,
-	                               guide->playDirection == -1, mayCreate, &writingToCache);
+	// Normally a cache only gets made when it can be written at full quality, which isn't while the CPU's struggling.
+	// But one at a sample's original rate is worth the one voice paying full price for, as it'll save all the rest
+	Sample* sample = (Sample*)guide->audioFileHolder->audioFile;
+	bool mayCreate = (sampleControls->getInterpolationBufferSize(phaseIncrement) == kInterpolationMaxNumSamples)
+	                 || isAtAboutOriginalRate(sample, phaseIncrement, timeStretchRatio);
+	cache = sample->getOrCreateCache((SampleHolder*)guide->audioFileHolder, phaseIncrement, timeStretchRatio,
+	                                 guide->playDirection == -1, mayCreate, &writingToCache);
 
 	if (cache) {
 		//Debug::println("cache gotten");
 		cacheBytePos = 0;
+		cache->considerRestoringFromCard();
 
 		setupCacheLoopPoints(guide, (Sample*)guide->audioFileHolder->audioFile, loopingType);
 		bool result = reassessReassessmentLocation(guide, (Sample*)guide->audioFileHolder->audioFile, priorityRating);
@@ -25,6 +25,7 @@
 #include "playback/playback_handler.h"
 #include "processing/engines/audio_engine.h"
 #include "processing/source.h"
+#include "storage/audio/audio_file_manager.h"
 #include "storage/multi_range/multisample_range.h"
 
 VoiceUnisonPartSource::VoiceUnisonPartSource() {
@@ -42,6 +43,8 @@ bool VoiceUnisonPartSource::noteOn(Voice* voice, Source* source, VoiceSamplePlay
 			return true; // We didn't succeed, but don't want to stop the whole Voice from sounding necessarily
 		}
 
+		Cluster* oldClusters[kNumClustersLoadedAhead] = {NULL};
+
 		if (!voiceSample) { // We might actually already have one, and just be restarting this voice
 			voiceSample = AudioEngine::solicitVoiceSample();
 			if (!voiceSample) {
@@ -49,17 +52,27 @@ bool VoiceUnisonPartSource::noteOn(Voice* voice, Source* source, VoiceSamplePlay
 			}
 		}
 		else {
-			//if we're restarting a voice we need to clear it's reasons,
-			//otherwise we'll increase now but only reduce by one at note off
-			//not quite thread safe - if the sample is shorter than 64k
-			//an allocation before setupClustersForInitialPlay could steal it
+			// If we're restarting a voice we need to clear its reasons, otherwise we'll increase now but only reduce by
+			// one at note off. But hang onto the Clusters themselves until the new ones are claimed below - for a
+			// retrigger of the same sample they're the very same ones, and this way they can't get stolen in between
+			memcpy(oldClusters, voiceSample->clusters, sizeof(oldClusters));
+			memset(voiceSample->clusters, 0, sizeof(voiceSample->clusters));
 			voiceSample->beenUnassigned();
 		}
 		voiceSample->noteOn(guide, samplesLate, voice->getPriorityRating());
-		if (samplesLate) {
-			return true; // We're finished in this case
+
+		bool success = true;
+		if (!samplesLate) { // Otherwise, the Clusters get set up at the late start
+			success =
+			    voiceSample->setupClusersForInitialPlay(guide, (Sample*)guide->audioFileHolder->audioFile, 0, false, 1);
+		}
+
+		for (int32_t l = 0; l < kNumClustersLoadedAhead; l++) {
+			if (oldClusters[l]) {
+				audioFileManager.removeReasonFromCluster(oldClusters[l], "E475");
+			}
 		}
-		return voiceSample->setupClusersForInitialPlay(guide, (Sample*)guide->audioFileHolder->audioFile, 0, false, 1);
+		return success;
 	}
 
 	if (synthMode != SynthMode::FM
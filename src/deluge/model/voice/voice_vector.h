@@ -35,4 +35,5 @@ public:
 	void checkVoiceExists(Voice* voice, Sound* sound, char const* errorCode);
 
 	inline Voice* getVoice(int32_t index) { return ((VoiceVectorElement*)getElementAddress(index))->voice; }
+	inline Sound* getSound(int32_t index) { return ((VoiceVectorElement*)getElementAddress(index))->sound; }
 };
@@ -50,6 +50,8 @@ ArpeggiatorForDrum::ArpeggiatorForDrum() {
 
 Arpeggiator::Arpeggiator() : notes(sizeof(ArpNote), 16, 0, 8, 8) {
 	notes.emptyingShouldFreeMemory = false;
+	stepsValid = false;
+	currentStep = kArpStepUnknown;
 }
 
 // Surely this shouldn't be quite necessary?
@@ -59,6 +61,7 @@ void ArpeggiatorForDrum::reset() {
 
 void Arpeggiator::reset() {
 	notes.empty();
+	stepsValid = false;
 }
 
 void ArpeggiatorForDrum::noteOn(ArpeggiatorSettings* settings, int32_t noteCode, int32_t velocity,
@@ -152,6 +155,8 @@ void Arpeggiator::noteOn(ArpeggiatorSettings* settings, int32_t noteCode, int32_
 		}
 	}
 
+	stepsValid = false;
+
 	arpNote = (ArpNote*)notes.getElementAddress(n);
 
 	arpNote->inputCharacteristics[util::to_underlying(MIDICharacteristic::NOTE)] = noteCode;
@@ -220,6 +225,7 @@ void Arpeggiator::noteOff(ArpeggiatorSettings* settings, int32_t noteCodePreArp,
 			}
 
 			notes.deleteAtIndex(n);
+			stepsValid = false;
 
 			if (whichNoteCurrentlyOnPostArp >= n) {
 				whichNoteCurrentlyOnPostArp--; // Beware - this could send it negative
@@ -318,6 +324,7 @@ void Arpeggiator::switchNoteOn(ArpeggiatorSettings* settings, ArpReturnInstructi
 		currentOctave = getRandom255() % settings->numOctaves;
 		currentDirection =
 		    1; // Must set a currentDirection here, even though RANDOM doesn't use it, in case user changes arp mode.
+		currentStep = kArpStepUnknown;
 	}
 
 	// Or not RANDOM
@@ -336,71 +343,33 @@ void Arpeggiator::switchNoteOn(ArpeggiatorSettings* settings, ArpReturnInstructi
 				currentOctave = 0;
 				currentDirection = 1;
 			}
+			currentStep = kArpStepUnknown;
 		}
 
 		// Otherwise, just carry on the sequence of arpeggiated notes
 		else {
-
-			whichNoteCurrentlyOnPostArp += currentDirection;
-
-			// If reached top of notes (so current direction must be up)
-			if (whichNoteCurrentlyOnPostArp >= notes.getNumElements()) {
-
-				// If at top octave
-				if ((int32_t)currentOctave >= settings->numOctaves - 1) {
-
-					if (settings->mode == ArpMode::UP) {
-						whichNoteCurrentlyOnPostArp -= notes.getNumElements();
-						currentOctave = 0;
-					}
-
-					else { // Up+down
-						currentDirection = -1;
-						whichNoteCurrentlyOnPostArp -= 2;
-						if (whichNoteCurrentlyOnPostArp < 0) {
-							whichNoteCurrentlyOnPostArp = 0;
-							if (currentOctave > 0) {
-								currentOctave--;
-							}
-						}
-					}
-				}
-
-				// Otherwise, just continue
-				else {
-					whichNoteCurrentlyOnPostArp -= notes.getNumElements();
-					currentOctave++;
-				}
+			if (!stepsValid || stepsMode != settings->mode || stepsNumOctaves != settings->numOctaves) {
+				buildSteps(settings);
+			}
+			if (currentStep == kArpStepUnknown) {
+				currentStep = findCurrentStep();
 			}
 
-			// Or, if reached bottom of notes (so current direction must be down)
-			if (whichNoteCurrentlyOnPostArp < 0) {
-
-				// If at bottom octave
-				if (currentOctave <= 0) {
-
-					if (settings->mode == ArpMode::DOWN) {
-						whichNoteCurrentlyOnPostArp += notes.getNumElements();
-						currentOctave = settings->numOctaves - 1;
-					}
-
-					else { // Up+down
-						currentDirection = 1;
-						whichNoteCurrentlyOnPostArp += 2;
-						if (whichNoteCurrentlyOnPostArp >= notes.getNumElements()) {
-							whichNoteCurrentlyOnPostArp = notes.getNumElements() - 1;
-							if (currentOctave < settings->numOctaves - 1) {
-								currentOctave++;
-							}
-						}
-					}
+			// Usually, we're somewhere on the precomputed sequence and can just move along it
+			if (currentStep != kArpStepUnknown) {
+				currentStep++;
+				if (currentStep >= numSteps) {
+					currentStep = stepsLoopStart;
 				}
+				whichNoteCurrentlyOnPostArp = steps[currentStep].whichNote;
+				currentOctave = steps[currentStep].octave;
+				currentDirection = steps[currentStep].direction;
+			}
 
-				// Otherwise, just continue
-				else {
-					whichNoteCurrentlyOnPostArp += notes.getNumElements();
-					currentOctave--;
-				}
+			// Or if we've been knocked off it, e.g. by the user changing mode part-way through, work it out the long
+			// way until we land back on it
+			else {
+				stepForward(settings);
 			}
 		}
 	}
@@ -422,6 +391,132 @@ void Arpeggiator::switchNoteOn(ArpeggiatorSettings* settings, ArpReturnInstructi
 	instruction->arpNoteOn = arpNote;
 }
 
+// Moves whichNoteCurrentlyOnPostArp, currentOctave and currentDirection on to the next step, for any mode but RANDOM
+void Arpeggiator::stepForward(ArpeggiatorSettings* settings) {
+	whichNoteCurrentlyOnPostArp += currentDirection;
+
+	// If reached top of notes (so current direction must be up)
+	if (whichNoteCurrentlyOnPostArp >= notes.getNumElements()) {
+
+		// If at top octave
+		if ((int32_t)currentOctave >= settings->numOctaves - 1) {
+
+			if (settings->mode == ArpMode::UP) {
+				whichNoteCurrentlyOnPostArp -= notes.getNumElements();
+				currentOctave = 0;
+			}
+
+			else { // Up+down
+				currentDirection = -1;
+				whichNoteCurrentlyOnPostArp -= 2;
+				if (whichNoteCurrentlyOnPostArp < 0) {
+					whichNoteCurrentlyOnPostArp = 0;
+					if (currentOctave > 0) {
+						currentOctave--;
+					}
+				}
+			}
+		}
+
+		// Otherwise, just continue
+		else {
+			whichNoteCurrentlyOnPostArp -= notes.getNumElements();
+			currentOctave++;
+		}
+	}
+
+	// Or, if reached bottom of notes (so current direction must be down)
+	if (whichNoteCurrentlyOnPostArp < 0) {
+
+		// If at bottom octave
+		if (currentOctave <= 0) {
+
+			if (settings->mode == ArpMode::DOWN) {
+				whichNoteCurrentlyOnPostArp += notes.getNumElements();
+				currentOctave = settings->numOctaves - 1;
+			}
+
+			else { // Up+down
+				currentDirection = 1;
+				whichNoteCurrentlyOnPostArp += 2;
+				if (whichNoteCurrentlyOnPostArp >= notes.getNumElements()) {
+					whichNoteCurrentlyOnPostArp = notes.getNumElements() - 1;
+					if (currentOctave < settings->numOctaves - 1) {
+						currentOctave++;
+					}
+				}
+			}
+		}
+
+		// Otherwise, just continue
+		else {
+			whichNoteCurrentlyOnPostArp += notes.getNumElements();
+			currentOctave--;
+		}
+	}
+}
+
+void Arpeggiator::buildSteps(ArpeggiatorSettings* settings) {
+	stepsValid = true;
+	stepsMode = settings->mode;
+	stepsNumOctaves = settings->numOctaves;
+	numSteps = 0;
+	stepsLoopStart = 0;
+	currentStep = kArpStepUnknown;
+
+	if (settings->mode == ArpMode::RANDOM || !notes.getNumElements() || notes.getNumElements() >= kArpStepUnknown) {
+		return;
+	}
+
+	// Run through the sequence with stepForward() from where the first note would start it, until it comes back round
+	// to somewhere it's already been
+	int16_t actualWhichNote = whichNoteCurrentlyOnPostArp;
+	int8_t actualOctave = currentOctave;
+	int8_t actualDirection = currentDirection;
+
+	if (settings->mode == ArpMode::DOWN) {
+		whichNoteCurrentlyOnPostArp = notes.getNumElements() - 1;
+		currentOctave = settings->numOctaves - 1;
+		currentDirection = -1;
+	}
+	else {
+		whichNoteCurrentlyOnPostArp = 0;
+		currentOctave = 0;
+		currentDirection = 1;
+	}
+
+	while (true) {
+		uint8_t seenAt = findCurrentStep();
+		if (seenAt != kArpStepUnknown) {
+			stepsLoopStart = seenAt;
+			break;
+		}
+		if (numSteps >= kMaxNumArpSteps) {
+			numSteps = 0; // Too long. Just do it the long way
+			break;
+		}
+		steps[numSteps].whichNote = whichNoteCurrentlyOnPostArp;
+		steps[numSteps].octave = currentOctave;
+		steps[numSteps].direction = currentDirection;
+		numSteps++;
+		stepForward(settings);
+	}
+
+	whichNoteCurrentlyOnPostArp = actualWhichNote;
+	currentOctave = actualOctave;
+	currentDirection = actualDirection;
+}
+
+uint8_t Arpeggiator::findCurrentStep() {
+	for (int32_t i = 0; i < numSteps; i++) {
+		if (steps[i].whichNote == whichNoteCurrentlyOnPostArp && steps[i].octave == currentOctave
+		    && steps[i].direction == currentDirection) {
+			return i;
+		}
+	}
+	return kArpStepUnknown;
+}
+
 bool Arpeggiator::hasAnyInputNotesActive() {
 	return notes.getNumElements();
 }
@@ -53,6 +53,16 @@ struct ArpNote {
 
 #define ARP_NOTE_NONE 32767
 
+// One step of a (non-random) Arpeggiator's sequence - which held note, which octave, and which way it's heading
+struct ArpStep {
+	uint8_t whichNote;
+	int8_t octave;
+	int8_t direction;
+};
+
+constexpr int32_t kMaxNumArpSteps = 64;
+constexpr uint8_t kArpStepUnknown = 255;
+
 class ArpReturnInstruction {
 public:
 	ArpReturnInstruction()
@@ -124,4 +134,22 @@ public:
 
 protected:
 	void switchNoteOn(ArpeggiatorSettings* settings, ArpReturnInstruction* instruction);
+
+private:
+	void stepForward(ArpeggiatorSettings* settings);
+	void buildSteps(ArpeggiatorSettings* settings);
+	uint8_t findCurrentStep();
+
+	// The sequence of steps for the current notes, mode and numOctaves, as stepForward() would go through them,
+	// starting from the first note. Once we're somewhere on it, each step is just an index increment, wrapping back to
+	// stepsLoopStart. Built when first needed after the notes change - they're all that invalidate it, since mode and
+	// numOctaves are checked against what it was built for. A sequence too long to fit leaves numSteps at 0, and
+	// stepForward() just gets used every time.
+	ArpStep steps[kMaxNumArpSteps];
+	uint8_t numSteps;
+	uint8_t stepsLoopStart;
+	uint8_t currentStep; // kArpStepUnknown if the current note / octave / direction isn't (known to be) in steps[]
+	bool stepsValid;
+	ArpMode stepsMode;
+	uint8_t stepsNumOctaves;
 };
@@ -39,6 +39,7 @@
 #include "processing/engines/audio_engine.h"
 #include "storage/storage_manager.h"
 #include "util/functions.h"
+#include <algorithm>
 #include <math.h>
 
 #define SAMPLES_TO_CLEAR_AFTER_RECORD 8820          // 200ms
@@ -50,6 +51,29 @@
 #define UNINTERPOLATED_NODE_CANCELS_OVERRIDING_AFTER_SAMPLES                                                           \
 	6630 // 150ms. Only seems to have an effect for MIDI, which is confusing me...
 
+// How far a thinned-out run of recorded nodes may stray from the values that were actually recorded - half the step
+// between two positions of the knob that recorded them, so the ramps left behind never pass a value the knob couldn't
+// have been set to
+constexpr float kLinearRunTolerance = (float)(1 << 24);
+
+// While knob moves are being recorded, each new node gets a chance to make the one before it redundant - see
+// deleteRedundantNodeInLinearRun(). Nodes there are deleted if the ramp around them would pass within
+// kLinearRunTolerance of them, but then so must it for the nodes deleted before them, back to where the run began. So
+// for each run, this keeps the range of slopes a ramp from its first node could have and still do that for all of them.
+// Only a few params get recorded at once, so there's only room for a few. A param that's lost its window can't know
+// what its current run's already had deleted, so that run is left as it is, and the next one starts afresh
+struct LinearRunWindow {
+	AutoParam const* param;
+	int32_t firstPos; // Of the run's first node, which must be unchanged for the window to still apply
+	int32_t firstValue;
+	float minSlope;
+	float maxSlope;
+};
+
+constexpr int32_t kNumLinearRunWindows = 4;
+static LinearRunWindow linearRunWindows[kNumLinearRunWindows];
+static int32_t nextLinearRunWindow = 0;
+
 AutoParam::AutoParam() {
 	init();
 	currentValue = 0;
@@ -59,6 +83,7 @@ AutoParam::AutoParam() {
 
 void AutoParam::init() {
 	nodes.init();
+	playbackNodeI = -1;
 }
 
 void AutoParam::cloneFrom(AutoParam* otherParam, bool copyAutomation) {
@@ -325,17 +350,18 @@ bool AutoParam::deleteRedundantNodeInLinearRun(int32_t lastNodeInRunI, int32_t e
 
 		if (middleNodeInRun->value == firstNodeInRun->value
 		    && (middleNodeInRun->value == lastNodeInRun->value || !middleNodeInRun->interpolated)) {
-removeMiddleNodeInRun:
+			// Not a ramp, so any window of slopes for the run no longer means anything
+			for (LinearRunWindow& window : linearRunWindows) {
+				if (window.param == this) {
+					window.firstPos = -1;
+				}
+			}
 			nodes.deleteAtIndex(middleNodeInRunI);
 			return true;
 		}
 
 		else if (middleNodeInRun->interpolated) {
 
-			//float timeFraction = (float)howFarAfter(middleNodeInRun->pos, firstNodeInRun->pos, clip) / howFarAfter(prevNode->pos, firstNodeInRun->pos, clip);
-			float valueFraction = (float)((middleNodeInRun->value >> 1) - (firstNodeInRun->value >> 1))
-			                      / ((lastNodeInRun->value >> 1) - (firstNodeInRun->value >> 1));
-
 			int32_t distanceFirstToLast = lastNodeInRun->pos - firstNodeInRun->pos;
 			if (distanceFirstToLast <= 0) {
 				distanceFirstToLast += effectiveLength;
@@ -346,11 +372,46 @@ removeMiddleNodeInRun:
 				distanceFirstToMiddle += effectiveLength;
 			}
 
-			// If nodes lay in a straight line (approximately)
-			if (round(valueFraction * distanceFirstToLast) == distanceFirstToMiddle) {
+			// Find this run's window of slopes, or start a new one if this is a new run
+			LinearRunWindow* window = NULL;
+			for (LinearRunWindow& thisWindow : linearRunWindows) {
+				if (thisWindow.param == this) {
+					window = &thisWindow;
+					break;
+				}
+			}
+			if (!window) {
+				window = &linearRunWindows[nextLinearRunWindow];
+				nextLinearRunWindow = (nextLinearRunWindow + 1) % kNumLinearRunWindows;
+				window->param = this;
+				window->firstPos = firstNodeInRun->pos;
+				window->firstValue = firstNodeInRun->value;
+				window->minSlope = INFINITY; // Empty, so nothing fits
+				window->maxSlope = -INFINITY;
+			}
+			else if (window->firstPos != firstNodeInRun->pos || window->firstValue != firstNodeInRun->value) {
+				window->firstPos = firstNodeInRun->pos;
+				window->firstValue = firstNodeInRun->value;
+				window->minSlope = -INFINITY;
+				window->maxSlope = INFINITY;
+			}
+
+			// The middle node can go if a ramp straight from the first to the last would pass close enough to it, and
+			// to all the ones that went before it
+			float middleRise = (float)middleNodeInRun->value - (float)firstNodeInRun->value;
+			float minSlope = std::max(window->minSlope, (middleRise - kLinearRunTolerance) / distanceFirstToMiddle);
+			float maxSlope = std::min(window->maxSlope, (middleRise + kLinearRunTolerance) / distanceFirstToMiddle);
+			float slope = ((float)lastNodeInRun->value - (float)firstNodeInRun->value) / distanceFirstToLast;
 
-				goto removeMiddleNodeInRun;
+			if (slope >= minSlope && slope <= maxSlope) {
+				window->minSlope = minSlope;
+				window->maxSlope = maxSlope;
+				nodes.deleteAtIndex(middleNodeInRunI);
+				return true;
 			}
+
+			// Otherwise, the middle node stays, and begins the next run
+			window->firstPos = -1;
 		}
 	}
 	return false;
@@ -399,15 +460,7 @@ int32_t AutoParam::processCurrentPos(ModelStackWithAutoParam const* modelStack,
 	int32_t effectiveLength = modelStack->getLoopLength();
 
 	// Find next node - here or further along in our direction
-	int32_t searchDirection = -(int32_t)reversed;
-	int32_t searchPos = currentPos + (int32_t)reversed;
-	int32_t iJustReached = nodes.search(searchPos, searchDirection);
-	if (iJustReached < 0) {
-		iJustReached += nodes.getNumElements();
-	}
-	else if (iJustReached >= nodes.getNumElements()) {
-		iJustReached = 0;
-	}
+	int32_t iJustReached = getPlaybackNodeIndex(currentPos, reversed);
 
 	ParamNode* nodeJustReached = nodes.getElement(iJustReached);
 	int32_t howFarUntilThisNode = nodeJustReached->pos - currentPos;
@@ -740,6 +793,68 @@ getOut:
 	return ticksTilNextNode;
 }
 
+// Returns the index of the node at currentPos, or the next one along in our direction. Nearly always, that's the same
+// node as last time, or the one after it, so we check those before resorting to a search. Checking rather than
+// trusting the cached index means edits to the nodes never leave us pointing at the wrong one.
+int32_t AutoParam::getPlaybackNodeIndex(int32_t currentPos, bool reversed) {
+	int32_t numNodes = nodes.getNumElements();
+
+	int32_t i = playbackNodeI;
+	if (i >= 0 && i < numNodes && playbackNodeIReversed == reversed) {
+		if (isPlaybackNodeIndex(i, currentPos, reversed)) {
+			return i;
+		}
+
+		// We've probably just gone past it
+		i += reversed ? -1 : 1;
+		if (i < 0) {
+			i += numNodes;
+		}
+		else if (i >= numNodes) {
+			i = 0;
+		}
+		if (isPlaybackNodeIndex(i, currentPos, reversed)) {
+			playbackNodeI = i;
+			return i;
+		}
+	}
+
+	int32_t searchDirection = -(int32_t)reversed;
+	int32_t searchPos = currentPos + (int32_t)reversed;
+	i = nodes.search(searchPos, searchDirection);
+	if (i < 0) {
+		i += numNodes;
+	}
+	else if (i >= numNodes) {
+		i = 0;
+	}
+
+	playbackNodeI = i;
+	playbackNodeIReversed = reversed;
+	return i;
+}
+
+// Whether nodes.search() would have given us i, in getPlaybackNodeIndex()
+bool AutoParam::isPlaybackNodeIndex(int32_t i, int32_t currentPos, bool reversed) {
+	int32_t numNodes = nodes.getNumElements();
+	int32_t pos = nodes.getElement(i)->pos;
+
+	if (reversed) {
+		// Last node at or before currentPos - or the last node of all, if there's none
+		if (i == numNodes - 1) {
+			return (pos <= currentPos || nodes.getElement(0)->pos > currentPos);
+		}
+		return (pos <= currentPos && nodes.getElement(i + 1)->pos > currentPos);
+	}
+	else {
+		// First node at or after currentPos - or the first node of all, if there's none
+		if (i == 0) {
+			return (pos >= currentPos || nodes.getElement(numNodes - 1)->pos < currentPos);
+		}
+		return (pos >= currentPos && nodes.getElement(i - 1)->pos < currentPos);
+	}
+}
+
 // You now much check before calling this that interpolation should happen at all
 void AutoParam::setupInterpolation(ParamNode* nextNodeInOurDirection, int32_t effectiveLength, int32_t currentPos,
                                    bool reversed) {
@@ -1334,6 +1449,7 @@ void AutoParam::setPlayPos(uint32_t pos, ModelStackWithAutoParam const* modelSta
 
 	valueIncrementPerHalfTick = 0; // We may calculate this, below
 	renewedOverridingAtTime = 0;
+	playbackNodeI = -1; // Search afresh next time we're processed
 	if (nodes.getNumElements()) {
 		int32_t oldValue = currentValue;
 		currentValue = getValueAtPos(pos, modelStack, reversed);
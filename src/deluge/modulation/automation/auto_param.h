@@ -116,12 +116,18 @@ public:
 	int32_t valueIncrementPerHalfTick;
 	uint32_t renewedOverridingAtTime; // If 0, it's off. If 1, it's latched until we hit some nodes / automation
 
+	// Playback cursor - index of the node processCurrentPos() last found. -1 means we'll have to search
+	int32_t playbackNodeI;
+	bool playbackNodeIReversed;
+
 	// "Latching" happens when you start recording values, but then stops if you arrive at any pre-existing values. So it only works in empty
 	// stretches of time.
 
 private:
 	bool deleteRedundantNodeInLinearRun(int32_t lastNodeInRunI, int32_t effectiveLength,
 	                                    bool mayLoopAroundBackToEnd = true);
+	int32_t getPlaybackNodeIndex(int32_t currentPos, bool reversed);
+	bool isPlaybackNodeIndex(int32_t i, int32_t currentPos, bool reversed);
 	void setupInterpolation(ParamNode* nextNode, int32_t effectiveLength, int32_t currentPos, bool reversed);
 	void homogenizeRegionTestSuccess(int32_t pos, int32_t regionEnd, int32_t startValue, bool interpolateStart,
 	                                 bool interpolateEnd);
@@ -81,6 +81,30 @@ int32_t LFO::render(int32_t numSamples, LFOType waveType, uint32_t phaseIncremen
 	return value;
 }
 
+// Fills output with one value per sample, exactly as calling render() with a numSamples of 1 that many times would
+void LFO::renderBlock(int32_t* output, int32_t numSamples, LFOType waveType, uint32_t phaseIncrement) {
+	switch (waveType) {
+	case LFOType::SINE:
+		for (int32_t i = 0; i < numSamples; i++) {
+			output[i] = getSine(phase);
+			phase += phaseIncrement;
+		}
+		break;
+
+	case LFOType::TRIANGLE:
+		for (int32_t i = 0; i < numSamples; i++) {
+			output[i] = getTriangle(phase);
+			phase += phaseIncrement;
+		}
+		break;
+
+	default:
+		for (int32_t i = 0; i < numSamples; i++) {
+			output[i] = render(1, waveType, phaseIncrement);
+		}
+	}
+}
+
 void LFO::tick(int32_t numSamples, uint32_t phaseIncrement) {
 	phase += phaseIncrement * numSamples;
 }
@@ -25,5 +25,6 @@ public:
 	uint32_t phase;
 	int32_t holdValue;
 	int32_t render(int32_t numSamples, LFOType waveType, uint32_t phaseIncrement);
+	void renderBlock(int32_t* output, int32_t numSamples, LFOType waveType, uint32_t phaseIncrement);
 	void tick(int32_t numSamples, uint32_t phaseIncrement);
 };
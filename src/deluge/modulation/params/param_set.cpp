@@ -451,10 +451,8 @@ void PatchedParamSet::notifyParamModifiedInSomeWay(ModelStackWithAutoParam const
 			ParamManager* paramManager = modelStack->paramManager;
 
 			char localModelStackMemory[MODEL_STACK_MAX_SIZE];
-			copyModelStack(localModelStackMemory, modelStack, sizeof(ModelStackWithThreeMainThings));
-
-			ModelStackWithParamCollection* modelStackWithParamCollection =
-			    paramManager->getPatchCableSet((ModelStackWithThreeMainThings*)localModelStackMemory);
+			ModelStackWithParamCollection* modelStackWithParamCollection = paramManager->getPatchCableSet(
+			    copyModelStack<ModelStackWithThreeMainThings>(localModelStackMemory, modelStack));
 
 			((PatchCableSet*)modelStackWithParamCollection->paramCollection)
 			    ->setupPatching(
@@ -66,11 +66,14 @@ inline void PatchCableSet::freeDestinationMemory(bool destructing) {
 	}
 }
 
+static uint32_t lastGeneration = 0;
+
 PatchCableSet::PatchCableSet(ParamCollectionSummary* summary) : ParamCollection(sizeof(PatchCableSet), summary) {
 	numUsablePatchCables = 0;
 	numPatchCables = 0;
 	destinations[GLOBALITY_LOCAL] = NULL;
 	destinations[GLOBALITY_GLOBAL] = NULL;
+	generation = ++lastGeneration;
 }
 
 PatchCableSet::~PatchCableSet() {
@@ -78,6 +81,9 @@ PatchCableSet::~PatchCableSet() {
 }
 
 bool PatchCableSet::isSourcePatchedToSomething(PatchSource s) {
+	if (patchingNeedsSetup) {
+		return isSourcePatchedToSomethingManuallyCheckCables(s);
+	}
 	uint32_t sourcesPatchedToSomething =
 	    sourcesPatchedToAnything[GLOBALITY_LOCAL] | sourcesPatchedToAnything[GLOBALITY_GLOBAL];
 	return sourcesPatchedToSomething & (1 << util::to_underlying(s));
@@ -95,6 +101,11 @@ bool PatchCableSet::isSourcePatchedToSomethingManuallyCheckCables(PatchSource s)
 }
 
 bool PatchCableSet::doesParamHaveSomethingPatchedToIt(int32_t p) {
+	if (patchingNeedsSetup) {
+		ParamDescriptor destinationParamDescriptor;
+		destinationParamDescriptor.setToHaveParamOnly(p);
+		return doesDestinationDescriptorHaveAnyCables(destinationParamDescriptor);
+	}
 	return getDestinationForParam(p);
 }
 
@@ -131,6 +142,9 @@ extern int32_t rangeFinalValues[];
 
 void PatchCableSet::setupPatching(ModelStackWithParamCollection const* modelStack) {
 
+	generation = ++lastGeneration;
+	patchingNeedsSetup = false;
+
 	// Deallocate any old memory
 	freeDestinationMemory(false);
 
@@ -335,6 +349,44 @@ goAgainWithoutIncrement:
 	}
 }
 
+// For when there's lots of patching to set up at once and much of it might never get used - like for every drum in
+// every Clip of a song that's just been loaded. The real setupPatching() then happens in Sound::ensurePatchingSetUp(),
+// the first time the Sound is played or edited with us, and until then, anything asking what's patched where gets
+// answered from the cables themselves, and Patchers treat us as having nothing patched.
+void PatchCableSet::setupPatchingLater(ModelStackWithParamCollection const* modelStack) {
+
+	generation = ++lastGeneration;
+	patchingNeedsSetup = true;
+
+	freeDestinationMemory(false);
+	numUsablePatchCables = 0;
+	sourcesPatchedToAnything[GLOBALITY_LOCAL] = 0;
+	sourcesPatchedToAnything[GLOBALITY_GLOBAL] = 0;
+
+	// Any automated cables still need to keep up with playback in the meantime. They all count for now, since we
+	// don't know yet which are usable
+	modelStack->summary->resetAutomationRecord(kNumUnsignedIntegersToRepPatchCables - 1);
+	modelStack->summary->resetInterpolationRecord(kNumUnsignedIntegersToRepPatchCables - 1);
+
+	for (int32_t c = 0; c < numPatchCables; c++) {
+		if (patchCables[c].param.isAutomated()) {
+			flagCable(modelStack->summary->whichParamsAreAutomated, c);
+
+			if (patchCables[c].param.valueIncrementPerHalfTick) {
+				flagCable(modelStack->summary->whichParamsAreInterpolating, c);
+			}
+		}
+	}
+}
+
+// For after something's changed which setupPatching() depends on. If it's been put off, it'll just take that into
+// account whenever it does happen
+void PatchCableSet::refreshPatching(ModelStackWithParamCollection const* modelStack) {
+	if (!patchingNeedsSetup) {
+		setupPatching(modelStack);
+	}
+}
+
 // Searches unusable ones too
 bool PatchCableSet::doesDestinationDescriptorHaveAnyCables(ParamDescriptor destinationParamDescriptor) {
 	for (int32_t c = 0; c < numPatchCables; c++) {
@@ -1011,9 +1063,7 @@ void PatchCableSet::notifyParamModifiedInSomeWay(ModelStackWithAutoParam const*
 				// Clone the ModelStack, since we only need the smaller amount of data that makes up a ModelStackWithParamCollection, and our call we make below
 				// could overwrite further-down fields of the ModelStack. Although I think in this case it actually doesn't - but best to be safe.
 				char localModelStackMemory[MODEL_STACK_MAX_SIZE];
-				copyModelStack(localModelStackMemory, modelStack, sizeof(ModelStackWithParamCollection));
-
-				deletePatchCable((ModelStackWithParamCollection*)localModelStackMemory, c);
+				deletePatchCable(copyModelStack<ModelStackWithParamCollection>(localModelStackMemory, modelStack), c);
 				haveRedoneSetup = true;
 			}
 		}
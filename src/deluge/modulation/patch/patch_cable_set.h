@@ -38,12 +38,17 @@ struct Destination {
 	uint8_t endCable;
 };
 
+// What PatchCable::rangeAdjustmentPointer points to for cables which have nothing patched to their range
+extern const int32_t neutralRangeAdjustmentValue;
+
 class PatchCableSet final : public ParamCollection {
 public:
 	PatchCableSet(ParamCollectionSummary* summary);
 	~PatchCableSet();
 
 	void setupPatching(ModelStackWithParamCollection const* modelStack);
+	void setupPatchingLater(ModelStackWithParamCollection const* modelStack);
+	void refreshPatching(ModelStackWithParamCollection const* modelStack);
 	bool doesDestinationDescriptorHaveAnyCables(ParamDescriptor destinationParamDescriptor);
 	uint8_t getPatchCableIndex(PatchSource from, ParamDescriptor destinationParamDescriptor,
 	                           ModelStackWithParamCollection const* modelStack = NULL, bool createIfNotFound = false);
@@ -103,12 +108,19 @@ public:
 
 	uint32_t sourcesPatchedToAnything[2]; // Only valid after setupPatching()
 
+	// If set, setupPatching() has been put off until the Sound is first played or edited - see setupPatchingLater()
+	bool patchingNeedsSetup = false;
+
 	PatchCable patchCables[kMaxNumPatchCables]; // TODO: store these in dynamic memory.
 	uint8_t numUsablePatchCables;
 	uint8_t numPatchCables;
 
 	Destination* destinations[2];
 
+	// Changes every time setupPatching() rebuilds the Destinations (and possibly reorders the cables), so a Patcher
+	// knows when the per-cable contributions it has cached no longer line up with patchCables[].
+	uint32_t generation;
+
 private:
 	static void dissectParamId(uint32_t paramId, ParamDescriptor* destinationParamDescriptor, PatchSource* s);
 	void swapCables(int32_t c1, int32_t c2);
@@ -100,6 +100,25 @@ void Patcher::performPatching(uint32_t sourcesChanged, Sound* sound, ParamManage
 		i++;
 	}
 
+	// Exp / hybrid Destinations just sum their cables, so we can keep each cable's contribution from last time and
+	// only redo the ones whose source changed. If the cached ones belong to some other cable setup though, every exp
+	// Destination has to be redone from scratch
+	uint32_t expSourcesChanged = sourcesChanged;
+	if (cableContributionsSet != patchCableSet || cableContributionsGeneration != patchCableSet->generation) {
+		cableContributionsSet = patchCableSet;
+		cableContributionsGeneration = patchCableSet->generation;
+		expSourcesChanged = 0xFFFFFFFF;
+	}
+
+	// A Voice can take its cables from global sources as its Sound has already worked them out for this render
+	GlobalSourceCables const* globalSourceCables = nullptr;
+	if (globality == GLOBALITY_LOCAL) {
+		GlobalSourceCables const* soundsOnes = &sound->voiceGlobalSourceCables;
+		if (soundsOnes->set == patchCableSet && soundsOnes->generation == patchCableSet->generation) {
+			globalSourceCables = soundsOnes;
+		}
+	}
+
 	int32_t* paramFinalValues = getParamFinalValuesPointer();
 
 	uint8_t params[std::max<int32_t>(Param::Global::FIRST, kNumParams - Param::Global::FIRST) + 1];
@@ -123,12 +142,13 @@ void Patcher::performPatching(uint32_t sourcesChanged, Sound* sound, ParamManage
 		}
 
 		for (; destination->sources; destination++) {
-			if (!(destination->sources & sourcesChanged)) {
+			if (!(destination->sources & expSourcesChanged)) {
 				continue;
 			}
 
 			int32_t p = destination->destinationParamDescriptor.getJustTheParam();
-			cableCombinations[numParamsPatched] = combineCablesExp(destination, p, sound, paramManager);
+			cableCombinations[numParamsPatched] =
+			    combineCablesExpIncremental(destination, p, expSourcesChanged, sound, paramManager, globalSourceCables);
 			params[numParamsPatched] = p;
 			numParamsPatched++;
 		}
@@ -170,6 +190,54 @@ void Patcher::performPatching(uint32_t sourcesChanged, Sound* sound, ParamManage
 	}
 }
 
+// For the Sound's own Patcher to call before its Voices render. Works out what each cable from a global source adds to
+// a Voice's exp / hybrid param, which is the same for all of them, so they can skip doing it themselves. Linear params
+// multiply their cables together in order, so those still get done in each Voice. As do cables with something patched
+// to their range, since that can differ between Voices.
+void Patcher::performGlobalSourcePatchingForVoices(uint32_t sourcesChanged, GlobalSourceCables* globalSourceCables,
+                                                   ParamManager* paramManager) {
+
+	PatchCableSet* patchCableSet = paramManager->getPatchCableSet();
+	Destination* destination = patchCableSet->destinations[GLOBALITY_LOCAL];
+	if (!destination) {
+		return;
+	}
+
+	constexpr uint32_t kGlobalSources = (1 << util::to_underlying(kFirstLocalSource)) - 1;
+	if (globalSourceCables->set != patchCableSet || globalSourceCables->generation != patchCableSet->generation) {
+		globalSourceCables->set = patchCableSet;
+		globalSourceCables->generation = patchCableSet->generation;
+		sourcesChanged = 0xFFFFFFFF;
+	}
+
+	sourcesChanged &= patchCableSet->sourcesPatchedToAnything[GLOBALITY_LOCAL] & kGlobalSources;
+	if (!sourcesChanged) {
+		return;
+	}
+
+	// Skip the range and linear Destinations. These are the Voices' params, not ours
+	uint32_t firstHybridParam = Param::Local::FIRST_HYBRID | 0xFFFFFF00;
+	for (; destination->destinationParamDescriptor.data < firstHybridParam; destination++) {}
+
+	for (; destination->sources; destination++) {
+		if (!(destination->sources & sourcesChanged)) {
+			continue;
+		}
+
+		int32_t p = destination->destinationParamDescriptor.getJustTheParam();
+		for (int32_t c = destination->firstCable; c < destination->endCable; c++) {
+			PatchCable* patchCable = &patchCableSet->patchCables[c];
+			if (((sourcesChanged >> util::to_underlying(patchCable->from)) & 1)
+			    && patchCable->rangeAdjustmentPointer == &neutralRangeAdjustmentValue) {
+				int32_t contribution = 0;
+				cableToExpParam(getSourceValue(patchCable->from), patchCableSet->getModifiedPatchCableAmount(c, p),
+				                &contribution, patchCable);
+				globalSourceCables->contributions[c] = contribution;
+			}
+		}
+	}
+}
+
 inline void Patcher::applyRangeAdjustment(int32_t* patchedValue, PatchCable* patchCable) {
 	int32_t small = multiply_32x32_rshift32(*patchedValue, *patchCable->rangeAdjustmentPointer);
 	*patchedValue = signed_saturate<32 - 5>(small) << 3; // Not sure if these limits are as wide as they could be...
@@ -300,6 +368,47 @@ inline int32_t Patcher::combineCablesExp(Destination const* destination, uint32_
 	return runningTotalCombination;
 }
 
+// As combineCablesExp(), but only working out afresh the contributions of cables whose source is in sourcesChanged,
+// and reusing the rest from cableContributions[]. The sum comes out the same either way, since it's just wrapping adds.
+// Cables with something patched to their range get redone every time, because rangeFinalValues[] is shared by all
+// Patchers. Any others from global sources are taken from globalSourceCables, if we've been given that.
+inline int32_t Patcher::combineCablesExpIncremental(Destination const* destination, uint32_t p,
+                                                    uint32_t sourcesChanged, Sound* sound, ParamManager* paramManager,
+                                                    GlobalSourceCables const* globalSourceCables) {
+
+	int32_t runningTotalCombination = 0;
+
+	PatchCableSet* patchCableSet = paramManager->getPatchCableSet();
+
+	for (int32_t c = destination->firstCable; c < destination->endCable; c++) {
+		PatchCable* patchCable = &patchCableSet->patchCables[c];
+		bool neutralRange = (patchCable->rangeAdjustmentPointer == &neutralRangeAdjustmentValue);
+		if (((sourcesChanged >> util::to_underlying(patchCable->from)) & 1) || !neutralRange) {
+			if (globalSourceCables && neutralRange && patchCable->from < kFirstLocalSource) {
+				cableContributions[c] = globalSourceCables->contributions[c];
+			}
+			else {
+				int32_t contribution = 0;
+				cableToExpParam(getSourceValue(patchCable->from), patchCableSet->getModifiedPatchCableAmount(c, p),
+				                &contribution, patchCable);
+				cableContributions[c] = contribution;
+			}
+		}
+		runningTotalCombination += cableContributions[c];
+	}
+
+	// Same wave index hack as in combineCablesExp()
+	if (p == Param::Local::OSC_A_WAVE_INDEX || p == Param::Local::OSC_B_WAVE_INDEX) {
+		runningTotalCombination <<= 1;
+	}
+
+	// Do the "preset value" (which we treat like a "cable" here)
+	cableToExpParamWithoutRangeAdjustment(sound->getSmoothedPatchedParamValue(p, paramManager), paramRanges[p],
+	                                      &runningTotalCombination);
+
+	return runningTotalCombination;
+}
+
 // NOTE: parameter preset values can't be bigger than 536870912, otherwise overflowing will occur
 
 void Patcher::performInitialPatching(Sound* sound, ParamManager* paramManager) {
@@ -331,7 +440,8 @@ void Patcher::performInitialPatching(Sound* sound, ParamManager* paramManager) {
 			paramFinalValues[p] = combineCablesExp(NULL, p, sound, paramManager);
 		}
 
-		Destination* destination = paramManager->getPatchCableSet()->destinations[patchableInfo->globality];
+		PatchCableSet* patchCableSet = paramManager->getPatchCableSet();
+		Destination* destination = patchCableSet->destinations[patchableInfo->globality];
 		if (destination) {
 
 			// First, "range" Destinations
@@ -349,10 +459,13 @@ void Patcher::performInitialPatching(Sound* sound, ParamManager* paramManager) {
 				int32_t p = destination->destinationParamDescriptor.getJustTheParam();
 				paramFinalValues[p] = combineCablesLinear(destination, p, sound, paramManager);
 			}
+			// This fills in every exp cable's contribution, so performPatching() can carry on from here
 			for (; destination->sources; destination++) {
 				int32_t p = destination->destinationParamDescriptor.getJustTheParam();
-				paramFinalValues[p] = combineCablesExp(destination, p, sound, paramManager);
+				paramFinalValues[p] = combineCablesExpIncremental(destination, p, 0xFFFFFFFF, sound, paramManager);
 			}
+			cableContributionsSet = patchCableSet;
+			cableContributionsGeneration = patchCableSet->generation;
 		}
 	}
 
@@ -43,11 +43,22 @@ struct PatchableInfo {
 	uint8_t globality;
 };
 
+// What each cable from a global source (which every Voice of a Sound sees the same value of) to a Voice's exp / hybrid
+// param adds to that param's sum. That's the same for all the Voices, so the Sound works it out once per render and the
+// Voices just take it from here. Only valid for set as of generation.
+struct GlobalSourceCables {
+	int32_t contributions[kMaxNumPatchCables];
+	PatchCableSet const* set = nullptr;
+	uint32_t generation = 0;
+};
+
 class Patcher {
 public:
 	Patcher(const PatchableInfo* newInfo);
 	void performInitialPatching(Sound* sound, ParamManager* paramManager);
 	void performPatching(uint32_t sourcesChanged, Sound* sound, ParamManagerForTimeline* paramManager);
+	void performGlobalSourcePatchingForVoices(uint32_t sourcesChanged, GlobalSourceCables* globalSourceCables,
+	                                          ParamManager* paramManager);
 	void recalculateFinalValueForParamWithNoCables(int32_t p, Sound* sound, ParamManagerForTimeline* paramManager);
 
 private:
@@ -55,6 +66,9 @@ private:
 	int32_t combineCablesLinearForRangeParam(Destination const* destination, ParamManager* paramManager);
 	int32_t combineCablesLinear(Destination const* destination, uint32_t p, Sound* sound, ParamManager* paramManager);
 	int32_t combineCablesExp(Destination const* destination, uint32_t p, Sound* sound, ParamManager* paramManager);
+	int32_t combineCablesExpIncremental(Destination const* destination, uint32_t p, uint32_t sourcesChanged,
+	                                    Sound* sound, ParamManager* paramManager,
+	                                    GlobalSourceCables const* globalSourceCables = nullptr);
 	void cableToLinearParamWithoutRangeAdjustment(int32_t sourceValue, int32_t cableStrength,
 	                                              int32_t* runningTotalCombination);
 	void cableToLinearParam(int32_t sourceValue, int32_t cableStrength, int32_t* runningTotalCombination,
@@ -67,4 +81,11 @@ private:
 	int32_t getSourceValue(PatchSource s);
 
 	const PatchableInfo* const patchableInfo;
+
+	// What each cable to an exp / hybrid param added to its Destination's sum last time, so that when only some of a
+	// Destination's sources change, only those cables have to be redone. Only valid for cableContributionsSet as of
+	// cableContributionsGeneration.
+	int32_t cableContributions[kMaxNumPatchCables];
+	PatchCableSet const* cableContributionsSet = nullptr;
+	uint32_t cableContributionsGeneration = 0;
 };
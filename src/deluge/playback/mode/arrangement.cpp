@@ -26,6 +26,7 @@
 #include "hid/matrix/matrix_driver.h"
 #include "io/debug/print.h"
 #include "io/midi/midi_engine.h"
+#include "model/clip/audio_clip.h"
 #include "model/clip/clip_instance.h"
 #include "model/clip/instrument_clip.h"
 #include "model/instrument/instrument.h"
@@ -444,6 +445,62 @@ void Arrangement::reversionDone() {
 	}
 }
 
+// The next ClipInstance on each row, if it starts within a couple of bars
+void Arrangement::prefetchUpcomingClips() {
+	if (!playbackHandler.isEitherClockActive()) {
+		return;
+	}
+
+	int32_t actualPos = getLivePos();
+	int32_t lookAhead = currentSong->getBarLength() * 2;
+
+	loadDeferredSamples(actualPos);
+
+	for (Output* output = currentSong->firstOutput; output; output = output->next) {
+		if (output->type != InstrumentType::AUDIO || !currentSong->isOutputActiveInArrangement(output)) {
+			continue;
+		}
+
+		int32_t i = output->clipInstances.search(actualPos + 1, GREATER_OR_EQUAL);
+		ClipInstance* clipInstance = output->clipInstances.getElement(i);
+		if (clipInstance && clipInstance->clip && clipInstance->pos - actualPos <= lookAhead) {
+			((AudioClip*)clipInstance->clip)->prefetchForLaunch();
+		}
+	}
+}
+
+// Reads the files Song::loadAllSamples() put off, for AudioClips whose ClipInstances are playing or coming up within
+// kArrangementSampleLoadAheadBars. One that's already meant to be playing gets resumed, so it only misses the time
+// its file took to be found
+void Arrangement::loadDeferredSamples(int32_t pos) {
+	int32_t loadUntil = pos + currentSong->getBarLength() * kArrangementSampleLoadAheadBars;
+
+	for (Output* output = currentSong->firstOutput; output; output = output->next) {
+		if (output->type != InstrumentType::AUDIO || !currentSong->isOutputActiveInArrangement(output)) {
+			continue;
+		}
+
+		for (int32_t i = std::max(output->clipInstances.search(pos + 1, LESS), 0_i32);
+		     i < output->clipInstances.getNumElements(); i++) {
+			ClipInstance* clipInstance = output->clipInstances.getElement(i);
+			if (clipInstance->pos >= loadUntil) {
+				break;
+			}
+			AudioClip* clip = (AudioClip*)clipInstance->clip;
+			if (!clip || !clip->sampleLoadDeferred) {
+				continue;
+			}
+
+			clip->loadDeferredSample();
+
+			if (playbackHandler.isEitherClockActive() && clipInstance->pos <= lastProcessedPos
+			    && clipInstance->pos + clipInstance->length > lastProcessedPos) {
+				resumeClipInstancePlayback(clipInstance);
+			}
+		}
+	}
+}
+
 bool Arrangement::isOutputAvailable(Output* output) {
 	if (!playbackHandler.playbackState || !output->activeClip) {
 		return true;
@@ -23,6 +23,10 @@ class ClipInstance;
 class Output;
 class Song;
 
+// With lazy sample loading, arrangement-only AudioClips further off than this get their files read only as the
+// play position approaches
+constexpr int32_t kArrangementSampleLoadAheadBars = 8;
+
 class Arrangement final : public PlaybackMode {
 public:
 	Arrangement();
@@ -40,6 +44,8 @@ public:
 	bool willClipContinuePlayingAtEnd(ModelStackWithTimelineCounter const* modelStack);
 	bool willClipLoopAtSomePoint(ModelStackWithTimelineCounter const* modelStack);
 	void reSyncClip(ModelStackWithTimelineCounter* modelStack, bool mustSetPosToSomething, bool mayResumeClip);
+	void prefetchUpcomingClips();
+	void loadDeferredSamples(int32_t pos);
 
 	// Clips remain "active" even after playback has stopped, or after they've finished playing but the next Clip for the Instrument / row hasn't started yet.
 	// It'll also become active if the user starts editing one
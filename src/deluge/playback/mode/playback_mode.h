@@ -54,6 +54,8 @@ public:
 	    ModelStackWithTimelineCounter const*
 	        modelStack) = 0; // This includes it "looping" in arranger before the Clip's full length due to that ClipInstance ending, and there being another instance of the same Clip right after.
 	virtual bool wantsToDoTempolessRecord(int32_t newPos) { return false; }
+	// Gets the card started on whatever's about to be played. Called regularly, whether playback's active or not
+	virtual void prefetchUpcomingClips() {}
 	virtual void
 	reSyncClip(ModelStackWithTimelineCounter* modelStack, bool mustSetPosToSomething = false,
 	           bool mayResumeClip = true) = 0; // Check playbackHandler.isEitherClockActive() before calling this.
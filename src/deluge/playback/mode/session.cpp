@@ -57,6 +57,7 @@ Session session{};
 
 Session::Session() {
 	cancelAllLaunchScheduling();
+	numLaunchScheduleEntries = 0;
 	lastSectionArmed = 255;
 }
 
@@ -676,6 +677,7 @@ void Session::scheduleLaunchTiming(int64_t atTickCount, int32_t numRepeatsUntil,
 
 void Session::scheduleFillEvent(Clip* clip, int64_t atTickCount) {
 	clip->fillEventAtTickCount = atTickCount;
+	addToLaunchSchedule(clip, atTickCount);
 	int32_t ticksTilFillEvent = atTickCount - playbackHandler.lastSwungTickActioned;
 	if (playbackHandler.swungTicksTilNextEvent > ticksTilFillEvent) {
 		playbackHandler.swungTicksTilNextEvent = ticksTilFillEvent;
@@ -683,6 +685,55 @@ void Session::scheduleFillEvent(Clip* clip, int64_t atTickCount) {
 	}
 }
 
+void Session::addToLaunchSchedule(Clip* clip, int64_t atTickCount) {
+
+	// If this Clip was already waiting, take its old entry out
+	for (int32_t i = 0; i < numLaunchScheduleEntries; i++) {
+		if (launchSchedule[i].clip == clip) {
+			numLaunchScheduleEntries--;
+			memmove(&launchSchedule[i], &launchSchedule[i + 1],
+			        (numLaunchScheduleEntries - i) * sizeof(LaunchScheduleEntry));
+			break;
+		}
+	}
+
+	int32_t i = numLaunchScheduleEntries;
+	while (i > 0 && launchSchedule[i - 1].atTickCount > atTickCount) {
+		i--;
+	}
+
+	// If full, the latest entry has to go - it'll get picked up again by rebuildLaunchSchedule() once there's room
+	if (numLaunchScheduleEntries == kMaxLaunchScheduleEntries) {
+		if (i == kMaxLaunchScheduleEntries) {
+			return;
+		}
+		numLaunchScheduleEntries--;
+	}
+
+	memmove(&launchSchedule[i + 1], &launchSchedule[i], (numLaunchScheduleEntries - i) * sizeof(LaunchScheduleEntry));
+	launchSchedule[i].atTickCount = atTickCount;
+	launchSchedule[i].clip = clip;
+	numLaunchScheduleEntries++;
+}
+
+// Call after anything that might have changed any Clip's fillEventAtTickCount, other than scheduleFillEvent()
+void Session::rebuildLaunchSchedule() {
+	numLaunchScheduleEntries = 0;
+
+	ClipArray* clipArray = &currentSong->sessionClips;
+traverseClips:
+	for (int32_t c = 0; c < clipArray->getNumElements(); c++) {
+		Clip* clip = clipArray->getClipAtIndex(c);
+		if (clip->fillEventAtTickCount > 0) {
+			addToLaunchSchedule(clip, clip->fillEventAtTickCount);
+		}
+	}
+	if (clipArray != &currentSong->arrangementOnlyClips) {
+		clipArray = &currentSong->arrangementOnlyClips;
+		goto traverseClips;
+	}
+}
+
 void Session::cancelAllLaunchScheduling() {
 	launchEventAtSwungTickCount = 0;
 }
@@ -1885,6 +1936,19 @@ bool Session::areAnyClipsArmed() {
 	return false;
 }
 
+// Anything armed to launch - including the next section, which gets armed as soon as the one before it launches - or
+// waiting on a fill
+void Session::prefetchUpcomingClips() {
+	for (int32_t l = 0; l < currentSong->sessionClips.getNumElements(); l++) {
+		Clip* clip = currentSong->sessionClips.getClipAtIndex(l);
+
+		if (clip->type == CLIP_TYPE_AUDIO && (clip->armState != ArmState::OFF || clip->fillEventAtTickCount > 0)
+		    && !currentSong->isClipActive(clip)) {
+			((AudioClip*)clip)->prefetchForLaunch();
+		}
+	}
+}
+
 // This is a little bit un-ideal, but after an undo or redo, this will be called, and it will tell every active Clip
 // to potentially expect a note or automation event - and to re-get all current automation values.
 // I wish we could easily just do this to the Clips that need it, but we don't store an easy list of just the Clips affected by each Action.
@@ -2017,6 +2081,8 @@ void Session::resetPlayPos(int32_t newPos, bool doingComplete, int32_t buttonPre
 		currentSong->paramManager.setPlayPos(arrangement.playbackStartedAtPos, modelStackWithThreeMainThings, false);
 	}
 
+	rebuildLaunchSchedule(); // We might have a whole new Song
+
 	int32_t distanceTilLaunchEvent = 0;
 
 	for (int32_t c = currentSong->sessionClips.getNumElements() - 1; c >= 0; c--) {
@@ -2082,7 +2148,6 @@ yeahNahItsOn:
 bool Session::considerLaunchEvent(int32_t numTicksBeingIncremented) {
 
 	bool swappedSong = false;
-	Clip* nextClipWithFillEvent = NULL;
 
 	char modelStackMemory[MODEL_STACK_MAX_SIZE];
 	ModelStack* modelStack = setupModelStackWithSong(modelStackMemory, currentSong);
@@ -2095,12 +2160,8 @@ traverseClips:
 	for (int32_t c = 0; c < clipArray->getNumElements(); c++) {
 		Clip* clip = clipArray->getClipAtIndex(c);
 
-		if (clip->fillEventAtTickCount > 0) {
-			if (!nextClipWithFillEvent || nextClipWithFillEvent->fillEventAtTickCount > clip->fillEventAtTickCount) {
-				nextClipWithFillEvent = clip;
-			}
-		}
-		else if (!currentSong->isClipActive(clip)) {
+		// Fill Clips waiting to launch get their pos incremented too, so they launch in sync
+		if (clip->fillEventAtTickCount <= 0 && !currentSong->isClipActive(clip)) {
 			continue;
 		}
 
@@ -2119,10 +2180,10 @@ traverseClips:
 
 	bool enforceSettingUpArming = false;
 
-	if (nextClipWithFillEvent && playbackHandler.lastSwungTickActioned >= nextClipWithFillEvent->fillEventAtTickCount) {
-		doLaunch(true);
+	if (numLaunchScheduleEntries && playbackHandler.lastSwungTickActioned >= launchSchedule[0].atTickCount) {
+		doLaunch(true); // Launches all fill Clips that are due, and clears their fillEventAtTickCount
+		rebuildLaunchSchedule();
 		armingChanged();
-		nextClipWithFillEvent->fillEventAtTickCount = 0;
 	}
 
 	// If launch event right now
@@ -2168,6 +2229,7 @@ traverseClips:
 
 				cancelAllLaunchScheduling();
 				doLaunch(false);
+				rebuildLaunchSchedule(); // Any fill Clips launched along with everything else
 				armingChanged();
 
 				// If playback was caused to end as part of that whole process, get out
@@ -2218,6 +2280,11 @@ void Session::doTickForward(int32_t posIncrement) {
 		playbackHandler.swungTicksTilNextEvent = std::min(ticksTilLaunchEvent, playbackHandler.swungTicksTilNextEvent);
 	}
 
+	if (numLaunchScheduleEntries) {
+		int32_t ticksTilNextFillEvent = launchSchedule[0].atTickCount - playbackHandler.lastSwungTickActioned;
+		playbackHandler.swungTicksTilNextEvent = std::min(ticksTilNextFillEvent, playbackHandler.swungTicksTilNextEvent);
+	}
+
 	char modelStackMemory[MODEL_STACK_MAX_SIZE];
 	ModelStack* modelStack = setupModelStackWithSong(modelStackMemory, currentSong);
 
@@ -2238,12 +2305,6 @@ traverseClips:
 	for (int32_t c = 0; c < clipArray->getNumElements(); c++) {
 		Clip* clip = clipArray->getClipAtIndex(c);
 
-		if (clip->fillEventAtTickCount > 0) {
-			int32_t ticksTilNextFillEvent = clip->fillEventAtTickCount - playbackHandler.lastSwungTickActioned;
-			playbackHandler.swungTicksTilNextEvent =
-			    std::min(ticksTilNextFillEvent, playbackHandler.swungTicksTilNextEvent);
-		}
-
 		if (!currentSong->isClipActive(clip)) {
 			continue;
 		}
@@ -24,6 +24,14 @@ class Clip;
 class ModelStackWithTimelineCounter;
 class ModelStack;
 
+// Fill Clips waiting to launch, soonest first, so the tick routine only has to look at the first one
+constexpr int32_t kMaxLaunchScheduleEntries = 32;
+
+struct LaunchScheduleEntry {
+	int64_t atTickCount;
+	Clip* clip; // Just for reference - it's the Clips' own fillEventAtTickCount which decide what launches
+};
+
 class Session final : public PlaybackMode {
 public:
 	Session();
@@ -63,6 +71,7 @@ public:
 	int32_t userWantsToArmNextSection(int32_t numRepetitions = -1);
 	int32_t getCurrentSection();
 	bool areAnyClipsArmed();
+	void prefetchUpcomingClips();
 	void unsoloClip(Clip* clip);
 	void soloClipRightNow(ModelStackWithTimelineCounter* modelStack);
 	bool deletingClipWhichCouldBeAbandonedOverdub(Clip* clip);
@@ -92,6 +101,9 @@ public:
 	int32_t currentArmedLaunchLengthForOneRepeat;
 	bool switchToArrangementAtLaunchEvent;
 
+	LaunchScheduleEntry launchSchedule[kMaxLaunchScheduleEntries];
+	int32_t numLaunchScheduleEntries;
+
 private:
 	bool giveClipOpportunityToBeginLinearRecording(Clip* clip, int32_t clipIndex, int32_t buttonPressLatency);
 	void armClipToStopAction(Clip* clip);
@@ -101,6 +113,8 @@ private:
 	void armClipsWithNothingToSyncTo(uint8_t section, Clip* clip);
 	void scheduleFillClip(Clip* clip);
 	void scheduleFillClips(uint8_t section);
+	void addToLaunchSchedule(Clip* clip, int64_t atTickCount);
+	void rebuildLaunchSchedule();
 };
 
 extern Session session;
@@ -58,7 +58,9 @@
 #include "processing/sound/sound_instrument.h"
 #include "storage/audio/audio_file_manager.h"
 #include "storage/flash_storage.h"
+#include "storage/performance_report.h"
 #include "storage/storage_manager.h"
+#include "util/container/spsc_queue.h"
 #include "util/functions.h"
 #include <math.h>
 #include <new>
@@ -99,12 +101,17 @@ PlaybackHandler::PlaybackHandler() {
 	recording = RECORDING_OFF;
 	countInEnabled = true;
 	timeLastMIDIStartOrContinueMessageSent = 0;
+	clockFollowerLocked = false;
+	clockFollowerBandwidthShift = 3;
 	currentVisualCountForCountIn = 0;
 }
 
-extern "C" uint32_t triggerClockRisingEdgeTimes[];
-extern "C" uint32_t triggerClockRisingEdgesReceived;
-extern "C" uint32_t triggerClockRisingEdgesProcessed;
+// Times (as SSI TX DMA positions) of rising edges seen on the trigger clock input, pushed by its ISR
+SPSCQueue<uint32_t, TRIGGER_CLOCK_INPUT_NUM_TIMES_STORED> triggerClockRisingEdgeTimes;
+
+extern "C" void triggerClockRisingEdgeReceived(uint32_t time) {
+	triggerClockRisingEdgeTimes.push(time);
+}
 
 // This function will be called repeatedly, at all times, to see if it's time to do a tick, and such
 void PlaybackHandler::routine() {
@@ -118,10 +125,8 @@ void PlaybackHandler::routine() {
 	}
 
 	// Check analog clock input
-	if (triggerClockRisingEdgesProcessed != triggerClockRisingEdgesReceived) {
-		uint32_t time =
-		    triggerClockRisingEdgeTimes[triggerClockRisingEdgesProcessed & (TRIGGER_CLOCK_INPUT_NUM_TIMES_STORED - 1)];
-		triggerClockRisingEdgesProcessed++;
+	uint32_t time;
+	if (triggerClockRisingEdgeTimes.pop(&time)) {
 		analogClockRisingEdge(time);
 	}
 
@@ -409,6 +414,8 @@ void PlaybackHandler::setupPlayback(int32_t newPlaybackState, int32_t playFromPo
 
 	playbackState = newPlaybackState;
 	cvEngine.playbackBegun(); // Call this *after* playbackState is set. If there's a count-in, nothing will happen
+	performanceReport.beginSession();
+	currentSong->seedClipProbabilities();
 
 	if (getRootUI() && getCurrentUI() == getRootUI()) {
 		getRootUI()->notifyPlaybackBegun();
@@ -446,6 +453,8 @@ void PlaybackHandler::setupPlayback(int32_t newPlaybackState, int32_t playFromPo
 }
 
 void PlaybackHandler::endPlayback() {
+	performanceReport.endSession();
+
 	if ((playbackState & PLAYBACK_CLOCK_INTERNAL_ACTIVE) && currentlySendingMIDIOutputClocks()) {
 		midiEngine.sendStop();
 	}
@@ -689,10 +698,17 @@ void PlaybackHandler::scheduleMIDIClockOutTickParamsKnown(uint32_t midiClockOutT
 	}
 }
 
-void PlaybackHandler::doMIDIClockOutTick() {
+// sendAtScheduledTime means hold the clock message back until the audio output reaches timeNextMIDIClockOutTick,
+// rather than sending it whenever the MIDI output buffers next get flushed
+void PlaybackHandler::doMIDIClockOutTick(bool sendAtScheduledTime) {
 	midiClockOutTickScheduled = false;
 	lastMIDIClockOutTickDone++;
-	midiEngine.sendClock(true);
+	if (sendAtScheduledTime) {
+		midiEngine.sendClockAtTime(timeNextMIDIClockOutTick, true);
+	}
+	else {
+		midiEngine.sendClock(true);
+	}
 }
 
 void PlaybackHandler::actionSwungTick() {
@@ -789,9 +805,9 @@ doMetronome:
 				uint32_t swungTicksPerQuarterNote = currentSong->getQuarterNoteLength();
 
 				if ((currentMetronomeTick % swungTicksPerQuarterNote) == 0) {
-					uint32_t phaseIncrement =
-					    ((currentMetronomeTick % (swungTicksPerQuarterNote << 2)) == 0) ? 128411753 : 50960238;
-					AudioEngine::metronome.trigger(phaseIncrement);
+					bool isFirstBeatOfBar = (currentMetronomeTick % (swungTicksPerQuarterNote << 2)) == 0;
+					AudioEngine::metronome.trigger(isFirstBeatOfBar ? MetronomeClick::ACCENTED
+					                                                : MetronomeClick::NORMAL);
 				}
 
 				int32_t ticksIntoCurrentBeep = currentMetronomeTick % swungTicksPerQuarterNote;
@@ -1146,7 +1162,7 @@ int32_t PlaybackHandler::getInternalTickTime(int64_t internalTickCount) {
 
 		float inputTickCount = (float)(internalTickCount * inputTicksPer) / internalTicksPer;
 
-		return (int32_t)timeLastInputTicks[0]
+		return (int32_t)clockFollowerInputTickTime
 		       + (int32_t)((inputTickCount - lastInputTickReceived) * (int32_t)timePerInputTickMovingAverage);
 	}
 }
@@ -1200,6 +1216,7 @@ void PlaybackHandler::doSongSwap(bool preservePlayPosition) {
 	}
 
 	// Swap stuff over
+	performanceReport.endSession();
 	AudioEngine::unassignAllVoices(true);
 	currentSong = preLoadedSong;
 	AudioEngine::mustUpdateReverbParamsBeforeNextRender = true;
@@ -1207,11 +1224,15 @@ void PlaybackHandler::doSongSwap(bool preservePlayPosition) {
 	loadSongUI.deletedPartsOfOldSong = false;
 
 	currentSong->sendAllMIDIPGMs();
+	runtimeFeatureSettings.setSongEngineProfile(
+	    static_cast<RuntimeFeatureStateEngineProfile>(currentSong->engineProfile));
 	AudioEngine::getReverbParamsFromSong(currentSong);
 	AudioEngine::getMasterCompressorParamsFromSong(currentSong);
 
 	// Some more "if we're playing" stuff - this needs to happen after currentSong is swapped over, because resyncInternalTicksToInputTicks() references it
 	if (isEitherClockActive()) {
+		performanceReport.beginSession();
+		currentSong->seedClipProbabilities();
 
 		// If beginning in arranger, not allowed to preserve play position (the caller never actually tries to do this anyway)
 		if (currentSong->lastClipInstanceEnteredStartPos != -1) {
@@ -1304,6 +1325,7 @@ void PlaybackHandler::setupPlaybackUsingExternalClock(bool switchingFromInternal
 	// start position, and when hearing these, well, this looks like infinite tempo.
 
 	numInputTickTimesCounted = 0;
+	clockFollowerLocked = false;
 
 	stickyCurrentTimePerInternalTickInverse = veryCurrentTimePerInternalTickInverse =
 	    currentSong->divideByTimePerTimerTick; // Sets defaults
@@ -1509,7 +1531,7 @@ void PlaybackHandler::scheduleSwungTickFromExternalClock() {
 		// has already passed, the swung tick will still get actioned on the next audio routine call. The key point is just that the below calculation
 		// must correctly deal with negative numbers.
 		scheduledSwungTickTime =
-		    timeLastInputTicks[0]
+		    clockFollowerInputTickTime
 		    + (int64_t)(inputTickFractionTimes50TimesInternalTicksPer * timePerInputTickMovingAverage)
 		          / (int32_t)(internalTicksPer * 50);
 	}
@@ -1663,6 +1685,8 @@ void PlaybackHandler::inputTick(bool fromTriggerClock, uint32_t time) {
 
 	timeLastInputTicks[0] = timeThisInputTick;
 
+	clockFollowerInputTick(timeThisInputTick);
+
 	// Schedule an upcoming swung tick. Can only do this after updating timeLastInputTicks[0], just above.
 	// TODO: would it be better, in the case where swungTickScheduled is already true, to go and adjust / re-schedule it now we have more information?
 	if (!swungTickScheduled) {
@@ -1684,6 +1708,38 @@ uint32_t PlaybackHandler::getTimePerInternalTickInverse(bool getStickyValue) {
 	}
 }
 
+// Call after timeLastInputTicks and timePerInputTickMovingAverage have been updated for the new input tick
+void PlaybackHandler::clockFollowerInputTick(uint32_t timeThisInputTick) {
+
+	if (clockFollowerLocked) {
+		uint32_t predictedTime = clockFollowerInputTickTime + (uint32_t)(clockFollowerTimePerInputTickBig >> 16);
+		int32_t error = timeThisInputTick - predictedTime;
+		int32_t absError = std::abs(error);
+
+		// Anything more than half a tick out isn't jitter - it's a tempo jump, or a burst of ticks like a DAW sends
+		// after "continue". Don't try to smooth that, just start again from here
+		if (!tempoMagnitudeMatchingActiveNow && absError < (int32_t)(clockFollowerTimePerInputTickBig >> 17)) {
+			clockFollowerInputTickTime = predictedTime + (error >> clockFollowerBandwidthShift);
+			clockFollowerTimePerInputTickBig += ((int64_t)error << 16) >> (clockFollowerBandwidthShift * 2 + 2);
+
+			clockFollowerAverageError += (absError - clockFollowerAverageError) >> 4;
+			clockFollowerMaxError = std::max(clockFollowerMaxError, absError);
+
+			// Everything tempo-dependent follows the smoothed period from here on, rather than the raw average
+			timePerInputTickMovingAverage = clockFollowerTimePerInputTickBig >> 16;
+			resetTimePerInternalTickMovingAverage();
+			return;
+		}
+	}
+
+	// (Re)lock, taking this tick as exact, and the raw moving average as the period - if we have one yet
+	clockFollowerInputTickTime = timeThisInputTick;
+	clockFollowerTimePerInputTickBig = (int64_t)timePerInputTickMovingAverage << 16;
+	clockFollowerLocked = (numInputTickTimesCounted >= 2);
+	clockFollowerAverageError = 0;
+	clockFollowerMaxError = 0;
+}
+
 void PlaybackHandler::resetTimePerInternalTickMovingAverage() {
 	// Only do this if no tempo-targeting (that'd be a disaster!!), and if some input ticks have actually been received
 	if (!tempoMagnitudeMatchingActiveNow && lastInputTickReceived > 0) {
@@ -2718,6 +2774,25 @@ void PlaybackHandler::pitchBendReceived(MIDIDevice* fromDevice, uint8_t channel,
 
 	dealingWithReceivedMIDIPitchBendRightNow = true;
 
+	// Only bother offering it to every Output's learned params if something's actually learned to it
+	bool mayBeLearned = !isMPE && currentSong->anyMIDIKnobLearnedTo(channel, 128);
+
+	// And if not, only the Outputs listening on this channel need it at all
+	if (!mayBeLearned) {
+		int32_t numOutputs;
+		Output** outputs = currentSong->getOutputsListeningToMIDIChannel(fromDevice, channel, &numOutputs);
+		if (outputs) {
+			for (int32_t i = 0; i < numOutputs; i++) {
+				ModelStackWithTimelineCounter* modelStackWithTimelineCounter =
+				    modelStack->addTimelineCounter(outputs[i]->activeClip);
+				outputs[i]->offerReceivedPitchBend(modelStackWithTimelineCounter, fromDevice, channel, data1, data2,
+				                                   doingMidiThru);
+			}
+			dealingWithReceivedMIDIPitchBendRightNow = false;
+			return;
+		}
+	}
+
 	// Go through all Outputs...
 	for (Output* thisOutput = currentSong->firstOutput; thisOutput; thisOutput = thisOutput->next) {
 
@@ -2726,7 +2801,7 @@ void PlaybackHandler::pitchBendReceived(MIDIDevice* fromDevice, uint8_t channel,
 
 		bool usedForParam = false;
 
-		if (!isMPE && modelStackWithTimelineCounter->timelineCounterIsSet()) { // Do we still need to check this?
+		if (mayBeLearned && modelStackWithTimelineCounter->timelineCounterIsSet()) { // Do we still need to check this?
 			// See if it's learned to a parameter
 			usedForParam = thisOutput->offerReceivedPitchBendToLearnedParams(
 			    fromDevice, channel, data1, data2,
@@ -2783,6 +2858,26 @@ void PlaybackHandler::midiCCReceived(MIDIDevice* fromDevice, uint8_t channel, ui
 	char modelStackMemory[MODEL_STACK_MAX_SIZE];
 	ModelStack* modelStack = setupModelStackWithSong(modelStackMemory, currentSong);
 
+	// Only bother offering it to every Output's learned params if something's actually learned to it
+	bool mayBeLearned = !isMPE && currentSong->anyMIDIKnobLearnedTo(channel, ccNumber);
+
+	// And if not, only the Outputs listening on this channel need it at all
+	if (!mayBeLearned) {
+		int32_t numOutputs;
+		Output** outputs = currentSong->getOutputsListeningToMIDIChannel(fromDevice, channel, &numOutputs);
+		if (outputs) {
+			for (int32_t i = 0; i < numOutputs; i++) {
+				if (outputs[i]->activeClip) {
+					ModelStackWithTimelineCounter* modelStackWithTimelineCounter =
+					    modelStack->addTimelineCounter(outputs[i]->activeClip);
+					outputs[i]->offerReceivedCC(modelStackWithTimelineCounter, fromDevice, channel, ccNumber, value,
+					                            doingMidiThru);
+				}
+			}
+			return;
+		}
+	}
+
 	// Go through all Outputs...
 	for (Output* thisOutput = currentSong->firstOutput; thisOutput; thisOutput = thisOutput->next) {
 
@@ -2792,7 +2887,7 @@ void PlaybackHandler::midiCCReceived(MIDIDevice* fromDevice, uint8_t channel, ui
 			ModelStackWithTimelineCounter* modelStackWithTimelineCounter =
 			    modelStack->addTimelineCounter(thisOutput->activeClip);
 
-			if (!isMPE) {
+			if (mayBeLearned) {
 				// See if it's learned to a parameter
 				thisOutput->offerReceivedCCToLearnedParams(
 				    fromDevice, channel, ccNumber, value,
@@ -2819,6 +2914,22 @@ void PlaybackHandler::aftertouchReceived(MIDIDevice* fromDevice, int32_t channel
 	char modelStackMemory[MODEL_STACK_MAX_SIZE];
 	ModelStack* modelStack = setupModelStackWithSong(modelStackMemory, currentSong);
 
+	// Channel pressure only needs offering to the Outputs listening on this channel. Not polyphonic aftertouch though,
+	// which Drums also accept on an MPE zone's master channel even when the device hasn't told us about the zone
+	if (noteCode == -1) {
+		int32_t numOutputs;
+		Output** outputs = currentSong->getOutputsListeningToMIDIChannel(fromDevice, channel, &numOutputs);
+		if (outputs) {
+			for (int32_t i = 0; i < numOutputs; i++) {
+				ModelStackWithTimelineCounter* modelStackWithTimelineCounter =
+				    modelStack->addTimelineCounter(outputs[i]->activeClip);
+				outputs[i]->offerReceivedAftertouch(modelStackWithTimelineCounter, fromDevice, channel, value,
+				                                    noteCode, doingMidiThru);
+			}
+			return;
+		}
+	}
+
 	// Go through all Instruments...
 	for (Output* thisOutput = currentSong->firstOutput; thisOutput; thisOutput = thisOutput->next) {
 
@@ -115,6 +115,19 @@ public:
 	uint32_t timePerInputTickMovingAverage; // 0 means that a default will be set the first time it's used
 	uint8_t numInputTickTimesCounted;
 
+	// Phase-locked loop following the input ticks, so jitter on them (e.g. USB clock from a DAW) doesn't go straight
+	// into our tick scheduling and tempo. Each input tick's arrival nudges the smoothed phase by 1/2^bandwidthShift of
+	// the error, and the period by 1/2^(2 * bandwidthShift + 2) of it - critically damped. Larger shift = smoother but
+	// slower to follow tempo changes
+	uint32_t clockFollowerInputTickTime; // Smoothed time of the most recent input tick
+	int64_t clockFollowerTimePerInputTickBig; // Smoothed period, << 16
+	bool clockFollowerLocked;
+	uint8_t clockFollowerBandwidthShift;
+	// Drift statistics, in samples: smoothed and worst absolute error between input ticks and the loop's prediction,
+	// since it last locked
+	int32_t clockFollowerAverageError;
+	int32_t clockFollowerMaxError;
+
 	bool tempoMagnitudeMatchingActiveNow;
 	//unsigned long timeFirstInputTick; // First tick received for current tally
 	unsigned long
@@ -171,7 +184,7 @@ public:
 	uint32_t getTimePerInternalTickInverse(bool getStickyValue = false);
 	void tapTempoButtonPress();
 	void doTriggerClockOutTick();
-	void doMIDIClockOutTick();
+	void doMIDIClockOutTick(bool sendAtScheduledTime = false);
 	void resyncAnalogOutTicksToInternalTicks();
 	void resyncMIDIClockOutTicksToInternalTicks();
 	void analogClockRisingEdge(uint32_t time);
@@ -228,6 +241,7 @@ private:
 	int32_t numInputTicksToSkip;
 
 	void resetTimePerInternalTickMovingAverage();
+	void clockFollowerInputTick(uint32_t timeThisInputTick);
 	void getCurrentTempoParams(int32_t* magnitude, int8_t* whichValue);
 	void displayTempoFromParams(int32_t magnitude, int8_t whichValue);
 	void displayTempoBPM(float tempoBPM);
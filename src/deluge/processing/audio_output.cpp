@@ -29,6 +29,7 @@
 #include "playback/mode/playback_mode.h"
 #include "playback/playback_handler.h"
 #include "processing/engines/audio_engine.h"
+#include "processing/engines/direct_monitor.h"
 #include "storage/storage_manager.h"
 #include "util/lookuptables/lookuptables.h"
 #include <new>
@@ -209,17 +210,22 @@ renderEnvelope:
 	}
 
 	if (echoing && modelStack->song->isOutputActiveInArrangement(this)) {
+		AudioInputChannel inputChannelNow = inputChannel;
+		if (inputChannelNow == AudioInputChannel::STEREO && !AudioEngine::renderInStereo) {
+			inputChannelNow = AudioInputChannel::NONE; // 0 means combine channels
+		}
+
+		// Or it might get mixed straight into the output, skipping our effects
+		if (directMonitor.addInput(inputChannelNow, amplitudeAtEnd)) {
+			return rendered;
+		}
+
 		rendered = true;
 		StereoSample* __restrict__ outputPos = bufferToTransferTo ? (StereoSample*)bufferToTransferTo : renderBuffer;
 		StereoSample const* const outputPosEnd = outputPos + numSamples;
 
 		int32_t const* __restrict__ inputReadPos = (int32_t const*)AudioEngine::i2sRXBufferPos;
 
-		AudioInputChannel inputChannelNow = inputChannel;
-		if (inputChannelNow == AudioInputChannel::STEREO && !AudioEngine::renderInStereo) {
-			inputChannelNow = AudioInputChannel::NONE; // 0 means combine channels
-		}
-
 		int32_t amplitudeIncrement = (amplitudeAtEnd - amplitudeAtStart) / numSamples;
 		int32_t amplitudeNow = amplitudeAtStart;
 
@@ -402,6 +408,10 @@ bool AudioOutput::setActiveClip(ModelStackWithTimelineCounter* modelStack, PgmCh
 	return clipChanged;
 }
 
+bool AudioOutput::hasInputToRender(bool isClipActive) {
+	return echoing || (isClipActive && activeClip && ((AudioClip*)activeClip)->voiceSample);
+}
+
 bool AudioOutput::isSkippingRendering() {
 	return !echoing && (!activeClip || !((AudioClip*)activeClip)->voiceSample);
 }
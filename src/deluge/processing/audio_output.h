@@ -86,4 +86,5 @@ protected:
 	Clip* createNewClipForArrangementRecording(ModelStack* modelStack);
 	bool wantsToBeginArrangementRecording();
 	bool willRenderAsOneChannelOnlyWhichWillNeedCopying();
+	bool hasInputToRender(bool isClipActive);
 };
@@ -17,7 +17,9 @@
 
 #include "processing/engines/audio_engine.h"
 #include "definitions_cxx.hpp"
+#include "dsp/delay/delay_buffer.h"
 #include "dsp/master_compressor/master_compressor.h"
+#include "dsp/reverb/fdn/fdn.h"
 #include "dsp/reverb/freeverb/revmodel.hpp"
 #include "dsp/timestretch/time_stretcher.h"
 #include "gui/context_menu/sample_browser/kit.h"
@@ -29,10 +31,14 @@
 #include "gui/ui_timer_manager.h"
 #include "gui/views/view.h"
 #include "hid/display/display.h"
+#include "io/debug/cpu_profiler.h"
+#include "io/debug/event_trace.h"
+#include "io/debug/note_latency.h"
 #include "io/debug/print.h"
 #include "io/midi/midi_engine.h"
 #include "memory/general_memory_allocator.h"
 #include "model/drum/kit.h"
+#include "model/settings/runtime_feature_settings.h"
 #include "model/sample/sample_recorder.h"
 #include "model/song/song.h"
 #include "model/voice/voice.h"
@@ -42,6 +48,8 @@
 #include "modulation/patch/patch_cable_set.h"
 #include "processing/audio_output.h"
 #include "processing/engines/cv_engine.h"
+#include "processing/engines/direct_monitor.h"
+#include "processing/engines/render_scratch.h"
 #include "processing/live/live_input_buffer.h"
 #include "processing/metronome/metronome.h"
 #include "processing/sound/sound_drum.h"
@@ -49,6 +57,7 @@
 #include "storage/audio/audio_file_manager.h"
 #include "storage/multi_range/multisample_range.h"
 #include "storage/storage_manager.h"
+#include "util/container/static_vector.hpp"
 #include "util/functions.h"
 #include "util/misc.h"
 #include <new>
@@ -98,6 +107,8 @@ int16_t zeroMPEValues[kNumExpressionDimensions] = {0, 0, 0};
 namespace AudioEngine {
 
 PLACE_INTERNAL_FRUNK revmodel reverb{};
+PLACE_SDRAM_BSS deluge::dsp::reverb::FDN fdnReverb{};
+ReverbModel reverbModel = ReverbModel::FREEVERB;
 PLACE_INTERNAL_FRUNK Compressor reverbCompressor{};
 int32_t reverbCompressorVolume;
 int32_t reverbCompressorShape;
@@ -126,6 +137,7 @@ SampleRecorder* firstRecorder = NULL;
 
 // Let's keep these grouped - the stuff we're gonna access regularly during audio rendering
 int32_t cpuDireness = 0;
+VoiceStats voiceStats{};
 uint32_t timeDirenessChanged;
 uint32_t timeThereWasLastSomeReverb = 0x8FFFFFFF;
 int32_t numSamplesLastTime;
@@ -135,6 +147,7 @@ bool renderInStereo = true;
 bool bypassCulling = false;
 bool audioRoutineLocked = false;
 uint32_t audioSampleTimer = 0;
+uint32_t timeMIDIGateOutputTimerDue = 0; // In audioSampleTimer terms
 uint32_t i2sTXBufferPos;
 uint32_t i2sRXBufferPos;
 
@@ -147,6 +160,14 @@ uint8_t numHopsEndedThisRoutineCall;
 
 int32_t reverbSendPostLPF = 0;
 
+// Reverb input and output levels below this are inaudible. Being a power of 2 lets us OR samples together to check them
+constexpr int32_t kReverbSilenceThreshold = 1 << 10;
+// Everything still circulating in the reverb has come out within this long - the longest comb plus the allpass chain
+constexpr uint32_t kReverbTailGateSamples =
+    combtuningR8 + allpasstuningR1 + allpasstuningR2 + allpasstuningR3 + allpasstuningR4;
+uint32_t reverbQuietSamples = 0;
+bool reverbTailGated = false; // Reverb has gone silent and been muted. It's skipped until something's sent to it again
+
 VoiceVector activeVoices{};
 
 LiveInputBuffer* liveInputBuffers[3];
@@ -173,7 +194,38 @@ VoiceSample* firstUnassignedVoiceSample = voiceSamples;
 TimeStretcher timeStretchers[kNumTimeStretchersStatic] = {};
 TimeStretcher* firstUnassignedTimeStretcher = timeStretchers;
 
-Voice* firstUnassignedVoice;
+// TimeStretcher buffers, in one size class per channel count, so starting a stretcher - which happens for lots of them
+// at once when a scene of synced AudioClips launches - doesn't need to search the allocator or chop up SDRAM
+int32_t timeStretcherBuffersMono[kNumTimeStretcherBuffersStatic][TimeStretch::kBufferSize];
+int32_t timeStretcherBuffersStereo[kNumTimeStretcherBuffersStatic][TimeStretch::kBufferSize * 2];
+deluge::static_vector<int32_t*, kNumTimeStretcherBuffersStatic> freeTimeStretcherBuffers[2];
+uint32_t numTimeStretcherBufferOverflows = 0; // How many times we've had to go to the general allocator
+
+// Stutter buffers, allocated at startup and then never given back, so beginning a stutter is just a handoff. Each is
+// big enough for any stutter rate, since DelayBuffer::init() never goes past DELAY_BUFFER_MAX_SIZE
+constexpr uint32_t kStutterBufferMaxSize = DELAY_BUFFER_MAX_SIZE + delaySpaceBetweenReadAndWrite;
+StereoSample* stutterBuffers[kNumStutterBuffersReserved] = {};
+deluge::static_vector<StereoSample*, kNumStutterBuffersReserved> freeStutterBuffers;
+
+// Voices come from slabs of kNumVoicesPerSlab, so a big chord or a kit hit on lots of rows only goes to the allocator
+// once, if at all, and they're recycled through firstUnassignedVoice. There's always room for at least kNumVoicesStatic.
+// Voices are cache-line aligned, so the slab is placed at the first aligned address in its allocation
+struct VoiceSlab {
+	VoiceSlab* next;
+	void* allocation;
+	Voice voices[kNumVoicesPerSlab];
+};
+VoiceSlab* firstVoiceSlab = nullptr;
+int32_t numVoiceSlabs = 0;
+uint32_t timeVoicePoolLastGrew = 0;
+Voice* firstUnassignedVoice = nullptr;
+
+// Sum of Voice::estimatedCost for all active Voices, and how much of that we think we can render before running out
+// of time. The budget is learned: each time we have to cull because we ran out of CPU, it gets set just below what was
+// playing at that moment, and it creeps back up while things are going fine.
+uint32_t activeVoiceCost = 0;
+constexpr uint32_t kVoiceCostBudgetUnlearned = 0x7FFFFFFF;
+uint32_t voiceCostBudget = kVoiceCostBudgetUnlearned;
 
 // You must set up dynamic memory allocation before calling this, because of its call to setupWithPatching()
 void init() {
@@ -203,6 +255,21 @@ void init() {
 		timeStretchers[i].nextUnassigned = (i == kNumTimeStretchersStatic - 1) ? NULL : &timeStretchers[i + 1];
 	}
 
+	for (int32_t i = 0; i < kNumTimeStretcherBuffersStatic; i++) {
+		freeTimeStretcherBuffers[0].push_back(timeStretcherBuffersMono[i]);
+		freeTimeStretcherBuffers[1].push_back(timeStretcherBuffersStereo[i]);
+	}
+
+	while (numVoiceSlabs * kNumVoicesPerSlab < kNumVoicesStatic && growVoicePool()) {}
+
+	for (int32_t i = 0; i < kNumStutterBuffersReserved; i++) {
+		stutterBuffers[i] = (StereoSample*)GeneralMemoryAllocator::get().alloc(
+		    kStutterBufferMaxSize * sizeof(StereoSample), NULL, false, false);
+		if (stutterBuffers[i]) {
+			freeStutterBuffers.push_back(stutterBuffers[i]);
+		}
+	}
+
 	i2sTXBufferPos = (uint32_t)getTxBufferStart();
 
 	i2sRXBufferPos = (uint32_t)getRxBufferStart()
@@ -219,6 +286,7 @@ void unassignAllVoices(bool deletingSong) {
 		disposeOfVoice(thisVoice);
 	}
 	activeVoices.empty();
+	activeVoiceCost = 0;
 
 	// Because we unfortunately don't have a master list of VoiceSamples or actively sounding AudioClips,
 	// we have to unassign all of those by going through all AudioOutputs.
@@ -247,15 +315,32 @@ Voice* cullVoice(bool saveVoice, bool justDoFastRelease) {
 
 	uint32_t bestRating = 0;
 	Voice* bestVoice = NULL;
-	for (int32_t v = 0; v < activeVoices.getNumElements(); v++) {
-		Voice* thisVoice = activeVoices.getVoice(v);
 
-		uint32_t ratingThisVoice = thisVoice->getPriorityRating();
+	// activeVoices is ordered by Sound, so each Sound's Voices are all together. The top bits of the rating come just
+	// from the Sound, so a Sound whose Voices couldn't beat the best so far gets skipped without looking at any of them
+	int32_t numVoices = activeVoices.getNumElements();
+	int32_t v = 0;
+	while (v < numVoices) {
+		Sound* sound = activeVoices.getSound(v);
+		int32_t end = v + 1;
+		while (end < numVoices && activeVoices.getSound(end) == sound) {
+			end++;
+		}
+
+		uint32_t bestPossibleRating = Voice::getPriorityRatingForSound(sound) | (0xFFFFFFFF >> 5);
+		if (bestPossibleRating > bestRating) {
+			for (; v < end; v++) {
+				Voice* thisVoice = activeVoices.getVoice(v);
+
+				uint32_t ratingThisVoice = thisVoice->getCullingRating();
 
-		if (ratingThisVoice > bestRating) {
-			bestRating = ratingThisVoice;
-			bestVoice = thisVoice;
+				if (ratingThisVoice > bestRating) {
+					bestRating = ratingThisVoice;
+					bestVoice = thisVoice;
+				}
+			}
 		}
+		v = end;
 	}
 
 	if (bestVoice) {
@@ -265,6 +350,7 @@ Voice* cullVoice(bool saveVoice, bool justDoFastRelease) {
 
 		if (justDoFastRelease) {
 			if (bestVoice->envelopes[0].state < EnvelopeStage::FAST_RELEASE) {
+				voiceStats.numFastReleaseCulls++;
 				bool stillGoing = bestVoice->doFastRelease(65536);
 
 				if (!stillGoing) {
@@ -286,6 +372,7 @@ Voice* cullVoice(bool saveVoice, bool justDoFastRelease) {
 		}
 
 		else {
+			voiceStats.numHardCulls++;
 			unassignVoice(bestVoice, bestVoice->assignedToSound, NULL, true, !saveVoice);
 		}
 	}
@@ -293,6 +380,7 @@ Voice* cullVoice(bool saveVoice, bool justDoFastRelease) {
 	// Or if no Voices to cull, try culling an AudioClip...
 	else {
 		if (currentSong && !justDoFastRelease) {
+			voiceStats.numAudioClipCulls++;
 			currentSong->cullAudioClipVoice();
 		}
 	}
@@ -304,11 +392,49 @@ int32_t getNumVoices() {
 	return activeVoices.getNumElements();
 }
 
+void VoiceStats::dump() const {
+	Debug::print("voices solicited ");
+	Debug::print(numSolicited);
+	Debug::print(" failed ");
+	Debug::print(numSolicitFailures);
+	Debug::print(" unassigned ");
+	Debug::print(numUnassigned);
+	Debug::print(" culls hard ");
+	Debug::print(numHardCulls);
+	Debug::print(" fast ");
+	Debug::print(numFastReleaseCulls);
+	Debug::print(" clip ");
+	Debug::print(numAudioClipCulls);
+	Debug::print(" vsample overflows ");
+	Debug::print(numVoiceSampleOverflows);
+	Debug::print(" failed ");
+	Debug::print(numVoiceSampleFailures);
+	Debug::print(" tstretch overflows ");
+	Debug::print(numTimeStretcherOverflows);
+	Debug::print(" failed ");
+	Debug::print(numTimeStretcherFailures);
+	Debug::print(" late clusters ");
+	Debug::print(numClusterUnderruns);
+	Debug::print(" max voices ");
+	Debug::print(maxVoicesInUse);
+	Debug::print(" pool ");
+	Debug::print(getVoicePoolSize());
+	Debug::print(" max ");
+	Debug::println(maxVoicePoolSize);
+}
+
+int32_t getVoiceBudgetPermille() {
+	if (voiceCostBudget == kVoiceCostBudgetUnlearned) {
+		return -1;
+	}
+	return ((uint64_t)activeVoiceCost * 1000) / std::max<uint32_t>(voiceCostBudget, 1);
+}
+
 void routineWithClusterLoading(bool mayProcessUserActionsBetween) {
 	logAction("AudioDriver::routineWithClusterLoading");
 
 	routineBeenCalled = false;
-	audioFileManager.loadAnyEnqueuedClusters(128, mayProcessUserActionsBetween);
+	audioFileManager.loadAnyEnqueuedClusters(128, mayProcessUserActionsBetween, true);
 	if (!routineBeenCalled) {
 		logAction("from routineWithClusterLoading()");
 		routine(); // -----------------------------------
@@ -333,11 +459,45 @@ extern uint16_t g_usb_usbmode;
 Debug::AverageDT aeCtr("audio", Debug::mS);
 Debug::AverageDT rvb("reverb", Debug::uS);
 
+static void armMIDIGateOutputTimer(int32_t samples) {
+	R_INTC_Enable(INTC_ID_TGIA[TIMER_MIDI_GATE_OUTPUT]);
+
+	// Set delay time. This is samples * 515616 / kSampleRate.
+	*TGRA[TIMER_MIDI_GATE_OUTPUT] = ((uint32_t)samples * 766245) >> 16;
+	enableTimer(TIMER_MIDI_GATE_OUTPUT);
+}
+
+// Called from the MIDI / gate output timer ISR. Sends any held-back MIDI that's now due, and if there's more still
+// waiting, sets the timer going again for that.
+void sendTimedMIDIOutputDue() {
+	if (!midiEngine.anythingInTimedOutputQueue()) {
+		return;
+	}
+
+	int32_t samplesTilNext;
+	if (midiEngine.sendTimedOutputDueBy(timeMIDIGateOutputTimerDue)) {
+		if (!midiEngine.anythingInTimedOutputQueue()) {
+			return;
+		}
+		samplesTilNext = std::max<int32_t>(midiEngine.getNextTimedOutputTime() - timeMIDIGateOutputTimerDue, 1);
+	}
+
+	// We interrupted something part-way through writing to the MIDI output buffers. Come back a moment later
+	else {
+		samplesTilNext = 1;
+	}
+
+	timeMIDIGateOutputTimerDue += samplesTilNext;
+	armMIDIGateOutputTimer(samplesTilNext);
+}
+
 void routine() {
 	aeCtr.note();
 	logAction("AudioDriver::routine");
 	if (audioRoutineLocked) {
 		logAction("AudioDriver::routine locked");
+		// This is where we'll get called from during a long render, so keep the monitoring going
+		directMonitor.routine();
 		return; // Prevents this from being called again from inside any e.g. memory allocation routines that get called from within this!
 	}
 
@@ -349,8 +509,10 @@ void routine() {
 		return;
 	}
 
+	TRACE_SCOPE(AUDIO_ROUTINE);
 	audioRoutineLocked = true;
 	routineBeenCalled = true;
+	Debug::cpuProfiler.beginRoutine();
 
 	playbackHandler.routine();
 
@@ -366,6 +528,8 @@ void routine() {
 		audioRoutineLocked = false;
 		return;
 	}
+	Debug::cpuProfiler.noteRenderLag(numSamples);
+	Debug::noteLatency.beginRender(SSI_TX_BUFFER_NUM_SAMPLES - numSamples);
 
 #if AUTOMATED_TESTER_ENABLED
 	AutomatedTester::possiblyDoSomething();
@@ -375,8 +539,8 @@ void routine() {
 	// We want any messages like "start" to go out before we send any clocks below, and also want to give them a head-start being sent and out of the way so the clock messages can
 	// be sent on-time
 	bool anythingInMidiOutputBufferNow = midiEngine.anythingInOutputBuffer();
-	bool anythingInGateOutputBufferNow =
-	    cvEngine.gateOutputPending || cvEngine.clockOutputPending; // Not asapGateOutputPending (RUN)
+	bool anythingInGateOutputBufferNow = cvEngine.gateOutputPending || cvEngine.clockOutputPending
+	                                     || cvEngine.cvOutputPending; // Not asapGateOutputPending (RUN)
 	if (anythingInMidiOutputBufferNow || anythingInGateOutputBufferNow) {
 
 		// We're only allowed to do this if the timer ISR isn't pending (i.e. we haven't enabled to timer to trigger it) - otherwise this will all get called soon anyway.
@@ -412,7 +576,7 @@ void routine() {
 	// }
 
 	// Consider direness and culling - before increasing the number of samples
-	int32_t numSamplesLimit = 40; //storageManager.devVarC;
+	int32_t numSamplesLimit = runtimeFeatureSettings.getCullSampleLimit(); // 40 unless an engine profile says otherwise
 	int32_t direnessThreshold = numSamplesLimit - 17;
 
 	if (smoothedSamples >= direnessThreshold) { // 20
@@ -430,6 +594,11 @@ void routine() {
 		if (!bypassCulling) {
 			int32_t numSamplesOverLimit = smoothedSamples - numSamplesLimit;
 
+			// Whatever was playing right now was too much, so don't let solicitVoice() take us back here
+			if (numSamplesOverLimit >= -6) {
+				voiceCostBudget = activeVoiceCost - (activeVoiceCost >> 4);
+			}
+
 			// If it's real dire, do a proper immediate cull
 			if (numSamplesOverLimit >= 10) {
 
@@ -484,6 +653,11 @@ void routine() {
 			cpuDireness--;
 			if (cpuDireness < 0) {
 				cpuDireness = 0;
+
+				// Things have been fine for a while, so allow a bit more than last time we had to cull
+				if (voiceCostBudget < kVoiceCostBudgetUnlearned) {
+					voiceCostBudget = std::min(voiceCostBudget + (voiceCostBudget >> 6) + 1, kVoiceCostBudgetUnlearned);
+				}
 			}
 			else {
 				//Debug::print("direness: ");
@@ -514,6 +688,14 @@ void routine() {
 		numSamples = (numSamples + 2) & ~3;
 	}
 
+	// Or, in fixed block mode, always render exactly one block, whatever space there is. If that's more than there's
+	// room for in the output buffer, doSomeOutputting() holds onto the rest and we don't render again until it's gone.
+	// If we're behind, we just get called again sooner. The stuff above still decides on culling from the real space.
+	int32_t renderBlockSize = runtimeFeatureSettings.get(RuntimeFeatureSettingType::RenderBlockSize);
+	if (renderBlockSize) {
+		numSamples = renderBlockSize;
+	}
+
 #endif
 
 	int32_t timeWithinWindowAtWhichMIDIOrGateOccurs = -1; // -1 means none
@@ -551,16 +733,18 @@ startAgain:
 			}
 
 			// Those could have outputted clock or other MIDI / gate
-			if (midiEngine.anythingInOutputBuffer() || cvEngine.clockOutputPending
-			    || cvEngine.gateOutputPending) { // Not asapGateOutputPending. That probably actually couldn't have been
-				                                 // generated by a actionSwungTick() anyway I think?
+			if (midiEngine.anythingInOutputBuffer() || cvEngine.clockOutputPending || cvEngine.gateOutputPending
+			    || cvEngine.cvOutputPending) { // Not asapGateOutputPending. That probably actually couldn't have
+				                               // been generated by a actionSwungTick() anyway I think?
 				timeWithinWindowAtWhichMIDIOrGateOccurs = 0;
 			}
 
 			goto startAgain;
 		}
 
-		// If the tick is during this window, shorten the window so we stop right at the tick
+		// If the tick is during this window, shorten the window so we stop right at the tick. This applies to fixed
+		// blocks too - we don't want to give up sample-accurate sequencing for them - so these are the one case where
+		// a block may come out shorter
 		if (timeTilNextTick < numSamples) {
 			numSamples = timeTilNextTick;
 		}
@@ -582,11 +766,14 @@ startAgain:
 		if (playbackHandler.midiClockOutTickScheduled) {
 			int32_t timeTilMIDIClockOutTick = playbackHandler.timeNextMIDIClockOutTick - audioSampleTimer;
 			if (timeTilMIDIClockOutTick < numSamples) {
-				playbackHandler.doMIDIClockOutTick();
+				// If it's due later in the window, have it held back and sent by the timer at exactly that point.
+				// Otherwise it'd go out along with any MIDI generated right at the start of the window, early.
+				bool sendAtScheduledTime = (timeTilMIDIClockOutTick > 0);
+				playbackHandler.doMIDIClockOutTick(sendAtScheduledTime);
 				playbackHandler.scheduleMIDIClockOutTick(); // Schedules another one
 
-				if (timeWithinWindowAtWhichMIDIOrGateOccurs == -1) {
-					timeWithinWindowAtWhichMIDIOrGateOccurs = timeTilMIDIClockOutTick;
+				if (!sendAtScheduledTime && timeWithinWindowAtWhichMIDIOrGateOccurs == -1) {
+					timeWithinWindowAtWhichMIDIOrGateOccurs = 0;
 				}
 			}
 		}
@@ -594,8 +781,15 @@ startAgain:
 
 	memset(&renderingBuffer, 0, numSamples * sizeof(StereoSample));
 
-	static int32_t reverbBuffer[SSI_TX_BUFFER_NUM_SAMPLES] __attribute__((aligned(CACHE_LINE_SIZE)));
-	memset(&reverbBuffer, 0, numSamples * sizeof(int32_t));
+	// Voices hand Clusters between each other all the time as they play through them, so only sort out which ones are
+	// really no longer wanted once they've all had their turn
+	audioFileManager.beginReasonBatch();
+
+	// The reverb send lasts the whole block, so it's first in the scratch space and never given back
+	renderScratch.reset();
+	directMonitor.beginRender();
+	int32_t* reverbBuffer = (int32_t*)renderScratch.acquire(SSI_TX_BUFFER_NUM_SAMPLES * sizeof(int32_t));
+	memset(reverbBuffer, 0, numSamples * sizeof(int32_t));
 
 #ifdef REPORT_CPU_USAGE
 	uint16_t startTime = MTU2.TCNT_0;
@@ -616,7 +810,9 @@ startAgain:
 			interruptsDisabled = true;
 		}
 
+		uint32_t songRenderStartTime = Debug::cpuProfiler.beginStage();
 		currentSong->renderAudio(renderingBuffer, numSamples, reverbBuffer, sideChainHitPending);
+		Debug::cpuProfiler.endStage(Debug::ProfileStage::SONG_RENDER, songRenderStartTime);
 
 		if (interruptsDisabled) {
 			__enable_irq();
@@ -650,6 +846,8 @@ startAgain:
 		mustUpdateReverbParamsBeforeNextRender = false;
 	}
 
+	uint32_t reverbStartTime = Debug::cpuProfiler.beginStage();
+
 	// Render the reverb compressor
 	int32_t compressorOutput = 0;
 	if (reverbCompressorVolumeInEffect != 0) {
@@ -667,6 +865,21 @@ startAgain:
 	// Stop reverb after 12 seconds of inactivity
 	bool reverbOn = ((uint32_t)(audioSampleTimer - timeThereWasLastSomeReverb) < kSampleRate * 12);
 
+	// Or if its tail has already died away, until it actually gets sent some sound again
+	if (reverbOn && reverbTailGated) {
+		int32_t sendActivity = 0;
+		for (int32_t i = 0; i < numSamples; i++) {
+			sendActivity |= reverbBuffer[i];
+		}
+		if (sendActivity) {
+			reverbTailGated = false;
+			reverbQuietSamples = 0;
+		}
+		else {
+			reverbOn = false;
+		}
+	}
+
 	if (reverbOn) {
 		// Patch that to reverb volume
 		int32_t positivePatchedValue =
@@ -684,6 +897,9 @@ startAgain:
 			reverbAmplitudeL = reverbAmplitudeR = reverbOutputVolume;
 		}
 
+		// Whether anything above kReverbSilenceThreshold went in or came out, for the tail gate
+		int32_t reverbActivity = 0;
+
 		// HPF on reverb send, cos if it has DC offset, the reverb magnifies that, and the sound farts out
 		{
 			int32_t* reverbSample = reverbBuffer;
@@ -692,28 +908,49 @@ startAgain:
 				int32_t distanceToGoL = *reverbSample - reverbSendPostLPF;
 				reverbSendPostLPF += distanceToGoL >> 11;
 				*reverbSample -= reverbSendPostLPF;
+				reverbActivity |= std::abs(*reverbSample);
+				*reverbSample >>= 1; // Halved on its way into the reverb
 
 				reverbSample++;
 			} while (reverbSample != reverbBufferEnd);
 		}
 
-		// Mix reverb into main render
-		int32_t* reverbSample = reverbBuffer;
-		StereoSample* outputSample = renderingBuffer;
-
-		StereoSample* outputBufferEnd = renderingBuffer + numSamples;
-
-		do {
-			int32_t reverbOutL;
-			int32_t reverbOutR;
-			reverb.process(*(reverbSample++) >> 1, &reverbOutL, &reverbOutR);
+		ScratchBuffer<int32_t> reverbOutputLBuffer(SSI_TX_BUFFER_NUM_SAMPLES);
+		ScratchBuffer<int32_t> reverbOutputRBuffer(SSI_TX_BUFFER_NUM_SAMPLES);
+		int32_t* reverbOutputL = reverbOutputLBuffer.get();
+		int32_t* reverbOutputR = reverbOutputRBuffer.get();
+		if (reverbModel == ReverbModel::FDN) {
+			fdnReverb.process(reverbBuffer, reverbOutputL, reverbOutputR, numSamples);
+		}
+		else {
+			reverb.process(reverbBuffer, reverbOutputL, reverbOutputR, numSamples);
+		}
 
-			outputSample->l += multiply_32x32_rshift32_rounded(reverbOutL, reverbAmplitudeL);
-			outputSample->r += multiply_32x32_rshift32_rounded(reverbOutR, reverbAmplitudeR);
+		// Mix reverb into main render
+		for (int32_t i = 0; i < numSamples; i++) {
+			renderingBuffer[i].l += multiply_32x32_rshift32_rounded(reverbOutputL[i], reverbAmplitudeL);
+			renderingBuffer[i].r += multiply_32x32_rshift32_rounded(reverbOutputR[i], reverbAmplitudeR);
+			reverbActivity |= std::abs(reverbOutputL[i]) | std::abs(reverbOutputR[i]);
+		}
 
-		} while (++outputSample != outputBufferEnd);
+		// If nothing's gone in or come out for long enough that whatever was circulating must have died away, zero
+		// the reverb's state and stop running it. Not if it's frozen though - then it's meant to keep going.
+		if (reverbActivity >= kReverbSilenceThreshold) {
+			reverbQuietSamples = 0;
+		}
+		else {
+			reverbQuietSamples += numSamples;
+			if (reverbQuietSamples >= kReverbTailGateSamples && reverb.getmode() < freezemode) {
+				reverb.mute();
+				fdnReverb.mute();
+				reverbSendPostLPF = 0;
+				reverbTailGated = true;
+			}
+		}
 	}
 
+	Debug::cpuProfiler.endStage(Debug::ProfileStage::REVERB, reverbStartTime);
+
 	// Previewing sample
 	if (getCurrentUI() == &sampleBrowser || getCurrentUI() == &gui::context_menu::sample_browser::kit
 	    || getCurrentUI() == &gui::context_menu::sample_browser::synth || getCurrentUI() == &slicer) {
@@ -757,9 +994,12 @@ startAgain:
 		}
 	}
 	logAction("mastercomp start");
+	uint32_t masterCompressorStartTime = Debug::cpuProfiler.beginStage();
 	mastercompressor.render(renderingBuffer, numSamples, masterVolumeAdjustmentL, masterVolumeAdjustmentR);
+	Debug::cpuProfiler.endStage(Debug::ProfileStage::MASTER_COMPRESSOR, masterCompressorStartTime);
 	masterVolumeAdjustmentL <<= 2;
 	masterVolumeAdjustmentR <<= 2;
+	directMonitor.endRender(masterVolumeAdjustmentL, masterVolumeAdjustmentR, AUDIO_OUTPUT_GAIN_DOUBLINGS);
 	logAction("mastercomp end");
 	metronome.render(renderingBuffer, numSamples);
 
@@ -800,7 +1040,9 @@ startAgain:
 	renderingBufferOutputPos = renderingBuffer;
 	renderingBufferOutputEnd = renderingBuffer + numSamples;
 
+	uint32_t outputStartTime = Debug::cpuProfiler.beginStage();
 	doSomeOutputting();
+	Debug::cpuProfiler.endStage(Debug::ProfileStage::SSI_OUTPUT, outputStartTime);
 
 	/*
     if (!getRandom255()) {
@@ -811,16 +1053,34 @@ startAgain:
     }
 */
 
-	bool anyGateOutputPending =
-	    cvEngine.gateOutputPending || cvEngine.clockOutputPending || cvEngine.asapGateOutputPending;
+	bool anyGateOutputPending = cvEngine.gateOutputPending || cvEngine.clockOutputPending
+	                            || cvEngine.asapGateOutputPending || cvEngine.cvOutputPending;
 
-	if ((midiEngine.anythingInOutputBuffer() || anyGateOutputPending) && !isTimerEnabled(TIMER_MIDI_GATE_OUTPUT)) {
+	bool anyTimedMIDIOutputPending = midiEngine.anythingInTimedOutputQueue();
+
+	if ((midiEngine.anythingInOutputBuffer() || anyGateOutputPending || anyTimedMIDIOutputPending)
+	    && !isTimerEnabled(TIMER_MIDI_GATE_OUTPUT)) {
+
+		// Held-back MIDI gets the timer too, if it's due before anything else. The timer ISR then re-arms itself for
+		// whatever's left in the queue after that
+		if (anyTimedMIDIOutputPending) {
+			int32_t timeWithinWindowOfTimedMIDI = midiEngine.getNextTimedOutputTime() - audioSampleTimer;
+			if (timeWithinWindowOfTimedMIDI < 0) {
+				timeWithinWindowOfTimedMIDI = 0;
+			}
+			if (timeWithinWindowAtWhichMIDIOrGateOccurs == -1
+			    || timeWithinWindowOfTimedMIDI < timeWithinWindowAtWhichMIDIOrGateOccurs) {
+				timeWithinWindowAtWhichMIDIOrGateOccurs = timeWithinWindowOfTimedMIDI;
+			}
+		}
 
 		// I don't think this actually could still get left at -1, but just in case...
 		if (timeWithinWindowAtWhichMIDIOrGateOccurs == -1) {
 			timeWithinWindowAtWhichMIDIOrGateOccurs = 0;
 		}
 
+		int32_t samplesTilMIDIOrGateUnadjusted;
+
 		uint32_t saddrAtEnd = (uint32_t)(getTxBufferCurrentPlace());
 		uint32_t saddrPosAtEnd = saddrAtEnd >> (2 + NUM_MONO_OUTPUT_CHANNELS_MAGNITUDE);
 		uint32_t saddrMovementSinceStart =
@@ -833,6 +1093,7 @@ startAgain:
 		if (!samplesTilMIDIOrGate) {
 			samplesTilMIDIOrGate = SSI_TX_BUFFER_NUM_SAMPLES;
 		}
+		samplesTilMIDIOrGateUnadjusted = samplesTilMIDIOrGate;
 
 		//samplesTilMIDI += 10; This gets the start of stuff perfectly lined up. About 10 for MIDI, 12 for gate
 
@@ -854,11 +1115,11 @@ startAgain:
 			}
 		}
 
-		R_INTC_Enable(INTC_ID_TGIA[TIMER_MIDI_GATE_OUTPUT]);
+		// Remember which point in the audio the timer will go off at, so held-back MIDI can be compared against it
+		timeMIDIGateOutputTimerDue = audioSampleTimer + timeWithinWindowAtWhichMIDIOrGateOccurs
+		                             + (samplesTilMIDIOrGate - samplesTilMIDIOrGateUnadjusted);
 
-		// Set delay time. This is samplesTilMIDIOrGate * 515616 / kSampleRate.
-		*TGRA[TIMER_MIDI_GATE_OUTPUT] = ((uint32_t)samplesTilMIDIOrGate * 766245) >> 16;
-		enableTimer(TIMER_MIDI_GATE_OUTPUT);
+		armMIDIGateOutputTimer(samplesTilMIDIOrGate);
 	}
 
 #if DO_AUDIO_LOG
@@ -884,9 +1145,13 @@ startAgain:
 	numAudioLogItems = 0;
 #endif
 
+	audioFileManager.endReasonBatch();
+
 	sideChainHitPending = 0;
 	audioSampleTimer += numSamples;
 
+	Debug::cpuProfiler.endRoutine(numSamples);
+
 	audioRoutineLocked = false;
 }
 
@@ -894,6 +1159,16 @@ int32_t getNumSamplesLeftToOutputFromPreviousRender() {
 	return ((uint32_t)renderingBufferOutputEnd - (uint32_t)renderingBufferOutputPos) >> 3;
 }
 
+// Roughly how much time, in cycles, other stuff can take before we need to get back to routine() to avoid the SSI
+// running out of samples - i.e. how long what's already in the TX buffer lasts, minus what the next render might cost,
+// going by what the last one took. Can be negative if we're already late.
+int32_t getCyclesUntilRenderDeadline() {
+	uint32_t saddrNow = (uint32_t)getTxBufferCurrentPlace();
+	int32_t numSamplesQueued = ((uint32_t)(i2sTXBufferPos - saddrNow) >> (2 + NUM_MONO_OUTPUT_CHANNELS_MAGNITUDE))
+	                           & (SSI_TX_BUFFER_NUM_SAMPLES - 1);
+	return (int32_t)(numSamplesQueued * Debug::kCyclesPerSample) - (int32_t)Debug::cpuProfiler.getLastRoutineCycles();
+}
+
 // Returns whether we got to the end
 bool doSomeOutputting() {
 
@@ -1002,6 +1277,8 @@ bool doSomeOutputting() {
 	renderingBufferOutputPos = renderingBufferOutputPosNow; // Write back from __restrict__ pointer to permanent pointer
 	i2sTXBufferPos = (uint32_t)i2sTXBufferPosNow;
 
+	directMonitor.routine();
+
 	if (numSamplesOutputted) {
 
 		i2sRXBufferPos += (numSamplesOutputted << (NUM_MONO_INPUT_CHANNELS_MAGNITUDE + 2));
@@ -1072,6 +1349,8 @@ void logAction(int32_t number) {
 }
 
 void updateReverbParams() {
+	// The FDN reverb takes its room size etc. from the main one, which is what the menus and presets set
+	fdnReverb.setParams(reverb.getroomsize(), reverb.getdamp(), reverb.getwidth());
 
 	// If reverb compressor on "auto" settings...
 	if (reverbCompressorVolume < 0) {
@@ -1182,6 +1461,9 @@ void getReverbParamsFromSong(Song* song) {
 	reverb.setdamp(song->reverbDamp);
 	reverb.setwidth(song->reverbWidth);
 	reverbPan = song->reverbPan;
+	reverbModel = song->reverbModel;
+	fdnReverb.setQuality(song->reverbQuality);
+	fdnReverb.setParams(reverb.getroomsize(), reverb.getdamp(), reverb.getwidth());
 	reverbCompressorVolume = song->reverbCompressorVolume;
 	reverbCompressorShape = song->reverbCompressorShape;
 	reverbCompressor.attack = song->reverbCompressorAttack;
@@ -1203,6 +1485,20 @@ Voice* solicitVoice(Sound* forSound) {
 
 	Voice* newVoice;
 
+	uint32_t newVoiceCost = Voice::estimateCost(forSound);
+	uint32_t predictedCost = activeVoiceCost + newVoiceCost;
+
+	// If we're predicting this will take us way over what we can render, free up a Voice to reuse straight away, the
+	// same as if we'd already run out of time. Or if it's just a bit over, do a soft cull so a Voice is fading out
+	// before we actually get there.
+	if (predictedCost > voiceCostBudget && activeVoices.getNumElements() && !bypassCulling) {
+		if (predictedCost > voiceCostBudget + (voiceCostBudget >> 2)) {
+			Debug::println("soliciting via predictive culling");
+			goto doCull;
+		}
+		cullVoice(false, true);
+	}
+
 	if (numSamplesLastTime >= 100 && activeVoices.getNumElements()) {
 
 		numSamplesLastTime -=
@@ -1212,24 +1508,19 @@ doCull:
 		newVoice = cullVoice(true);
 	}
 
-	else if (firstUnassignedVoice) {
-
-		newVoice = firstUnassignedVoice;
+	else if (firstUnassignedVoice || growVoicePool()) {
+		Voice* memory = firstUnassignedVoice;
 		firstUnassignedVoice = firstUnassignedVoice->nextUnassigned;
+		newVoice = new (memory) Voice();
 	}
 
-	else {
-		void* memory = GeneralMemoryAllocator::get().alloc(sizeof(Voice), NULL, false, true);
-		if (!memory) {
-			if (activeVoices.getNumElements()) {
-				goto doCull;
-			}
-			else {
-				return NULL;
-			}
-		}
+	else if (activeVoices.getNumElements()) {
+		goto doCull;
+	}
 
-		newVoice = new (memory) Voice();
+	else {
+		voiceStats.numSolicitFailures++;
+		return NULL;
 	}
 
 	newVoice->assignedToSound = forSound;
@@ -1242,8 +1533,16 @@ doCull:
 	if (i == -1) {
 		// if (ALPHA_OR_BETA_VERSION) display->freezeWithError("E193"); // No, having run out of RAM here isn't a reason to not continue.
 		disposeOfVoice(newVoice);
+		voiceStats.numSolicitFailures++;
 		return NULL;
 	}
+
+	voiceStats.numSolicited++;
+	voiceStats.maxVoicesInUse = std::max<uint32_t>(voiceStats.maxVoicesInUse, activeVoices.getNumElements());
+	voiceStats.maxVoicesInUseThisSession =
+	    std::max<uint32_t>(voiceStats.maxVoicesInUseThisSession, activeVoices.getNumElements());
+	newVoice->estimatedCost = newVoiceCost;
+	activeVoiceCost += newVoiceCost;
 	return newVoice;
 }
 
@@ -1255,6 +1554,9 @@ void unassignVoice(Voice* voice, Sound* sound, ModelStackWithSoundFlags* modelSt
 
 	activeVoices.checkVoiceExists(voice, sound, "E195");
 
+	activeVoiceCost -= voice->estimatedCost;
+	voiceStats.numUnassigned++;
+
 	voice->setAsUnassigned(modelStack->addVoice(voice));
 	if (removeFromVector) {
 		uint32_t keyWords[2];
@@ -1269,7 +1571,82 @@ void unassignVoice(Voice* voice, Sound* sound, ModelStackWithSoundFlags* modelSt
 }
 
 void disposeOfVoice(Voice* voice) {
-	delugeDealloc(voice);
+	voice->nextUnassigned = firstUnassignedVoice;
+	firstUnassignedVoice = voice;
+}
+
+// Adds a slab of Voices to the unassigned ones. Returns false if there wasn't the memory
+bool growVoicePool() {
+	void* allocation = GeneralMemoryAllocator::get().alloc(sizeof(VoiceSlab) + CACHE_LINE_SIZE - 1, NULL, false, true);
+	if (!allocation) {
+		return false;
+	}
+
+	void* memory = (void*)(((uint32_t)allocation + CACHE_LINE_SIZE - 1) & ~(uint32_t)(CACHE_LINE_SIZE - 1));
+	VoiceSlab* slab = new (memory) VoiceSlab();
+	slab->allocation = allocation;
+	slab->next = firstVoiceSlab;
+	firstVoiceSlab = slab;
+	numVoiceSlabs++;
+
+	// Backwards, so they get handed out in address order
+	for (int32_t v = kNumVoicesPerSlab - 1; v >= 0; v--) {
+		disposeOfVoice(&slab->voices[v]);
+	}
+
+	timeVoicePoolLastGrew = audioSampleTimer;
+	voiceStats.maxVoicePoolSize = std::max<uint32_t>(voiceStats.maxVoicePoolSize, numVoiceSlabs * kNumVoicesPerSlab);
+	return true;
+}
+
+// Gives back one slab if there'd still be room for kNumVoicesStatic without it, none of its Voices are in use, there'd
+// still be a slab's worth unassigned, and we haven't had to grow for a while - so a song that keeps going just over a
+// slab boundary doesn't have us allocating and freeing all the time
+void shrinkVoicePoolIfIdle() {
+	if ((numVoiceSlabs - 1) * kNumVoicesPerSlab < kNumVoicesStatic
+	    || audioSampleTimer - timeVoicePoolLastGrew < (uint32_t)(kVoicePoolShrinkDelaySeconds * kSampleRate)) {
+		return;
+	}
+
+	int32_t numUnassigned = 0;
+	for (Voice* voice = firstUnassignedVoice; voice; voice = voice->nextUnassigned) {
+		numUnassigned++;
+	}
+	if (numUnassigned < kNumVoicesPerSlab * 2) {
+		return;
+	}
+
+	for (VoiceSlab** prevPointer = &firstVoiceSlab; *prevPointer; prevPointer = &(*prevPointer)->next) {
+		VoiceSlab* slab = *prevPointer;
+		auto isInSlab = [slab](Voice* voice) {
+			return voice >= slab->voices && voice < slab->voices + kNumVoicesPerSlab;
+		};
+
+		int32_t numUnassignedInSlab = 0;
+		for (Voice* voice = firstUnassignedVoice; voice; voice = voice->nextUnassigned) {
+			numUnassignedInSlab += isInSlab(voice);
+		}
+		if (numUnassignedInSlab < kNumVoicesPerSlab) {
+			continue;
+		}
+
+		for (Voice** voicePointer = &firstUnassignedVoice; *voicePointer;) {
+			if (isInSlab(*voicePointer)) {
+				*voicePointer = (*voicePointer)->nextUnassigned;
+			}
+			else {
+				voicePointer = &(*voicePointer)->nextUnassigned;
+			}
+		}
+		*prevPointer = slab->next;
+		numVoiceSlabs--;
+		delugeDealloc(slab->allocation);
+		return;
+	}
+}
+
+int32_t getVoicePoolSize() {
+	return numVoiceSlabs * kNumVoicesPerSlab;
 }
 
 VoiceSample* solicitVoiceSample() {
@@ -1279,8 +1656,10 @@ VoiceSample* solicitVoiceSample() {
 		return toReturn;
 	}
 	else {
+		voiceStats.numVoiceSampleOverflows++;
 		void* memory = GeneralMemoryAllocator::get().alloc(sizeof(VoiceSample), NULL, false, true);
 		if (!memory) {
+			voiceStats.numVoiceSampleFailures++;
 			return NULL;
 		}
 
@@ -1307,8 +1686,10 @@ TimeStretcher* solicitTimeStretcher() {
 	}
 
 	else {
+		voiceStats.numTimeStretcherOverflows++;
 		void* memory = GeneralMemoryAllocator::get().alloc(sizeof(TimeStretcher), NULL, false, true);
 		if (!memory) {
+			voiceStats.numTimeStretcherFailures++;
 			return NULL;
 		}
 
@@ -1327,6 +1708,63 @@ void timeStretcherUnassigned(TimeStretcher* timeStretcher) {
 	}
 }
 
+// A mono request can be given a stereo buffer if the mono ones have run out
+int32_t* solicitTimeStretcherBuffer(int32_t numChannels) {
+	for (int32_t c = numChannels - 1; c < 2; c++) {
+		if (!freeTimeStretcherBuffers[c].empty()) {
+			int32_t* buffer = freeTimeStretcherBuffers[c].back();
+			freeTimeStretcherBuffers[c].pop_back();
+			return buffer;
+		}
+	}
+
+	numTimeStretcherBufferOverflows++;
+	return (int32_t*)GeneralMemoryAllocator::get().alloc(TimeStretch::kBufferSize * sizeof(int32_t) * numChannels,
+	                                                     NULL, false, true);
+}
+
+void timeStretcherBufferUnassigned(int32_t* buffer) {
+	if (buffer >= timeStretcherBuffersMono[0] && buffer < timeStretcherBuffersMono[kNumTimeStretcherBuffersStatic]) {
+		freeTimeStretcherBuffers[0].push_back(buffer);
+	}
+	else if (buffer >= timeStretcherBuffersStereo[0]
+	         && buffer < timeStretcherBuffersStereo[kNumTimeStretcherBuffersStatic]) {
+		freeTimeStretcherBuffers[1].push_back(buffer);
+	}
+	else {
+		delugeDealloc(buffer);
+	}
+}
+
+int32_t getNumTimeStretcherBuffersInUse(int32_t numChannels) {
+	return kNumTimeStretcherBuffersStatic - freeTimeStretcherBuffers[numChannels - 1].size();
+}
+
+uint32_t getNumTimeStretcherBufferOverflows() {
+	return numTimeStretcherBufferOverflows;
+}
+
+// Falls back to the general allocator if the reserved ones are all in use or didn't get allocated
+StereoSample* solicitStutterBuffer(uint32_t numSamples) {
+	if (numSamples <= kStutterBufferMaxSize && !freeStutterBuffers.empty()) {
+		StereoSample* buffer = freeStutterBuffers.back();
+		freeStutterBuffers.pop_back();
+		return buffer;
+	}
+
+	return (StereoSample*)GeneralMemoryAllocator::get().alloc(numSamples * sizeof(StereoSample), NULL, false, true);
+}
+
+void stutterBufferUnassigned(StereoSample* buffer) {
+	for (int32_t i = 0; i < kNumStutterBuffersReserved; i++) {
+		if (buffer == stutterBuffers[i]) {
+			freeStutterBuffers.push_back(buffer);
+			return;
+		}
+	}
+	delugeDealloc(buffer);
+}
+
 // TODO: delete unused ones
 LiveInputBuffer* getOrCreateLiveInputBuffer(OscType inputType, bool mayCreate) {
 	const auto idx = util::to_underlying(inputType) - util::to_underlying(OscType::INPUT_L);
@@ -1353,6 +1791,46 @@ LiveInputBuffer* getOrCreateLiveInputBuffer(OscType inputType, bool mayCreate) {
 
 bool createdNewRecorder;
 
+// How many completed clusters one recorder gets to write each time round, so one that's fallen behind can't hold all
+// the others up for long
+constexpr int32_t kMaxRecorderClustersPerTurn = 4;
+constexpr int32_t kMaxRecordersWritingAtOnce = 16;
+
+// Writes out the completed clusters of every SampleRecorder at once, going across the card in sector order rather than
+// in whatever order the recorders happen to be listed, so with several recording at the same time the card gets runs
+// of writes heading one way rather than being sent back and forth
+static void writeRecordersCompletedClusters() {
+	SampleRecorder* recorders[kMaxRecordersWritingAtOnce];
+	uint32_t sectors[kMaxRecordersWritingAtOnce];
+	int32_t numRecorders = 0;
+
+	for (SampleRecorder* recorder = firstRecorder; recorder && numRecorders < kMaxRecordersWritingAtOnce;
+	     recorder = recorder->next) {
+		if (!recorder->hasCompletedClustersToWrite()) {
+			continue;
+		}
+
+		// Insertion sort - there won't be many
+		uint32_t sector = recorder->getNextWriteSector();
+		int32_t i = numRecorders++;
+		while (i > 0 && sectors[i - 1] > sector) {
+			recorders[i] = recorders[i - 1];
+			sectors[i] = sectors[i - 1];
+			i--;
+		}
+		recorders[i] = recorder;
+		sectors[i] = sector;
+	}
+
+	// Recorders only get deleted from doRecorderCardRoutines(), so these all stay valid while the card's busy
+	for (int32_t i = 0; i < numRecorders; i++) {
+		int32_t error = recorders[i]->writeCompletedClusters(kMaxRecorderClustersPerTurn);
+		if (error) {
+			display->displayError(error);
+		}
+	}
+}
+
 void doRecorderCardRoutines() {
 
 	SampleRecorder** prevPointer = &firstRecorder;
@@ -1393,6 +1871,8 @@ void doRecorderCardRoutines() {
 	if (ALPHA_OR_BETA_VERSION && ENABLE_CLIP_CUTTING_DIAGNOSTICS && count >= 10 && !display->hasPopup()) {
 		display->displayPopup("MORE");
 	}
+
+	writeRecordersCompletedClusters();
 }
 
 void slowRoutine() {
@@ -1415,6 +1895,8 @@ void slowRoutine() {
 		}
 	}
 
+	shrinkVoicePoolIfIdle();
+
 	// Discard any LiveInputBuffers which aren't in use
 	for (int32_t i = 0; i < 3; i++) {
 		if (liveInputBuffers[i]) {
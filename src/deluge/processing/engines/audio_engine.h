@@ -42,6 +42,9 @@ class Metronome;
 class MasterCompressor;
 class ModelStackWithSoundFlags;
 class SoundDrum;
+namespace deluge::dsp::reverb {
+class FDN;
+}
 
 /*
  * ================== Audio rendering ==================
@@ -128,6 +131,8 @@ Voice* solicitVoice(Sound* forSound);
 void unassignVoice(Voice* voice, Sound* sound, ModelStackWithSoundFlags* modelStack = NULL,
                    bool removeFromVector = true, bool shouldDispose = true);
 void disposeOfVoice(Voice* voice);
+bool growVoicePool();
+void shrinkVoicePoolIfIdle();
 
 void songSwapAboutToHappen();
 void unassignAllVoices(bool deletingSong = false);
@@ -143,11 +148,21 @@ void voiceSampleUnassigned(VoiceSample* voiceSample);
 TimeStretcher* solicitTimeStretcher();
 void timeStretcherUnassigned(TimeStretcher* timeStretcher);
 
+int32_t* solicitTimeStretcherBuffer(int32_t numChannels);
+void timeStretcherBufferUnassigned(int32_t* buffer);
+int32_t getNumTimeStretcherBuffersInUse(int32_t numChannels);
+uint32_t getNumTimeStretcherBufferOverflows();
+
+StereoSample* solicitStutterBuffer(uint32_t numSamples);
+void stutterBufferUnassigned(StereoSample* buffer);
+
 LiveInputBuffer* getOrCreateLiveInputBuffer(OscType inputType, bool mayCreate);
 void slowRoutine();
+void sendTimedMIDIOutputDue();
 void doRecorderCardRoutines();
 
 int32_t getNumSamplesLeftToOutputFromPreviousRender();
+int32_t getCyclesUntilRenderDeadline();
 
 void registerSideChainHit(int32_t strength);
 
@@ -165,7 +180,38 @@ char* getEmptyLogEntry();
 void printLog();
 #endif
 
+// Counts, since startup, of what's happened to Voices and the things they borrow, so we can see which limits songs
+// actually run into. Each is just incremented where it happens, so they're always on. They wrap, so compare
+// differences rather than absolute values
+struct VoiceStats {
+	uint32_t numSolicited;       // Voices handed out by solicitVoice()
+	uint32_t numSolicitFailures; // ... and times it had nothing to hand out
+	uint32_t numUnassigned;
+	uint32_t numHardCulls;        // By cullVoice(), cut off on the spot
+	uint32_t numFastReleaseCulls; // By cullVoice(), given a fast release
+	uint32_t numAudioClipCulls;   // By cullVoice() when there were no Voices, so an AudioClip had to go instead
+	uint32_t numVoiceSampleOverflows; // The static VoiceSamples had run out, so one came from the allocator
+	uint32_t numVoiceSampleFailures;  // ... and that failed too
+	uint32_t numTimeStretcherOverflows;
+	uint32_t numTimeStretcherFailures;
+	uint32_t numClusterUnderruns; // A VoiceSample or AudioClip got to a Cluster which hadn't finished loading
+	// High-water marks, rather than counts
+	uint32_t maxVoicesInUse;
+	uint32_t maxVoicePoolSize; // Voices allocated, in use or not
+	uint32_t maxVoicesInUseThisSession; // Like maxVoicesInUse, but PerformanceReport restarts it with each play
+
+	[[nodiscard]] uint32_t getNumCulls() const { return numHardCulls + numFastReleaseCulls + numAudioClipCulls; }
+
+	/// Prints one line with all of them, to wherever debug output is going
+	void dump() const;
+};
+
 int32_t getNumVoices();
+// How many Voices there are allocated, whether in use or not
+int32_t getVoicePoolSize();
+// How much of the voice cost budget the active Voices are using, in tenths of a percent - so solicitVoice() starts
+// culling to make room at 1000. Or -1 if we've never had to cull, in which case there's no budget yet.
+int32_t getVoiceBudgetPermille();
 Voice* cullVoice(bool saveVoice = false, bool justDoFastRelease = false);
 
 bool doSomeOutputting();
@@ -181,6 +227,7 @@ extern bool bypassCulling;
 extern uint32_t i2sTXBufferPos;
 extern uint32_t i2sRXBufferPos;
 extern int32_t cpuDireness;
+extern VoiceStats voiceStats;
 extern InputMonitoringMode inputMonitoringMode;
 extern bool audioRoutineLocked;
 extern uint8_t numHopsEndedThisRoutineCall;
@@ -188,6 +235,8 @@ extern Compressor reverbCompressor;
 extern uint32_t timeThereWasLastSomeReverb;
 extern VoiceVector activeVoices;
 extern revmodel reverb;
+extern deluge::dsp::reverb::FDN fdnReverb;
+extern ReverbModel reverbModel;
 extern uint32_t nextVoiceState;
 extern SoundDrum* sampleForPreview;
 extern int32_t reverbCompressorVolume;
@@ -0,0 +1,352 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "processing/engines/bounce_engine.h"
+#include "definitions_cxx.hpp"
+#include "drivers/ssi/ssi.h"
+#include "io/debug/print.h"
+#include "memory/general_memory_allocator.h"
+#include "model/clip/audio_clip.h"
+#include "model/clip/instrument_clip.h"
+#include "model/model_stack.h"
+#include "model/note/note.h"
+#include "model/note/note_row.h"
+#include "model/song/song.h"
+#include "playback/playback_handler.h"
+#include "processing/audio_output.h"
+#include "processing/engines/audio_engine.h"
+#include "processing/sound/sound_instrument.h"
+#include "storage/audio/audio_file_manager.h"
+#include "storage/storage_manager.h"
+#include "util/d_string.h"
+#include "util/functions.h"
+#include <algorithm>
+#include <new>
+#include <string.h>
+
+extern "C" void routineForSD(void);
+
+namespace BounceEngine {
+
+constexpr int32_t kWaveHeaderSize = 44;
+constexpr int32_t kBytesPerFrame = 6; // 24-bit stereo
+constexpr int32_t kWriteBufferNumFrames = 1024;
+
+struct NoteEvent {
+	uint32_t time; // In samples from the start of the render
+	int16_t noteCode;
+	uint8_t velocity; // Or lift, for a note-off
+	bool on;
+};
+
+// Offs before ons at the same time, so a note which follows straight on from another of the same pitch still starts
+static bool noteEventIsEarlier(NoteEvent const& a, NoteEvent const& b) {
+	return (a.time != b.time) ? (a.time < b.time) : (!a.on && b.on);
+}
+
+static uint32_t ticksToSamples(int64_t ticks) {
+	return (uint64_t)(ticks * currentSong->timePerTimerTickBig) >> 32;
+}
+
+static void writeInt16(uint8_t** pos, uint16_t value) {
+	*(*pos)++ = value;
+	*(*pos)++ = value >> 8;
+}
+
+static void writeInt32(uint8_t** pos, uint32_t value) {
+	writeInt16(pos, value);
+	writeInt16(pos, value >> 16);
+}
+
+static void writeWaveHeader(uint8_t* buffer, uint32_t numFrames) {
+	uint32_t dataSize = numFrames * kBytesPerFrame;
+	uint8_t* pos = buffer;
+	writeInt32(&pos, 0x46464952); // "RIFF"
+	writeInt32(&pos, dataSize + kWaveHeaderSize - 8);
+	writeInt32(&pos, 0x45564157); // "WAVE"
+	writeInt32(&pos, 0x20746d66); // "fmt "
+	writeInt32(&pos, 16);
+	writeInt16(&pos, 0x0001); // PCM
+	writeInt16(&pos, 2);
+	writeInt32(&pos, kSampleRate);
+	writeInt32(&pos, kSampleRate * kBytesPerFrame);
+	writeInt16(&pos, kBytesPerFrame);
+	writeInt16(&pos, 24);
+	writeInt32(&pos, 0x61746164); // "data"
+	writeInt32(&pos, dataSize);
+}
+
+// Every note the clip would play over numLoops loops, each NoteRow repeating at its own length if it has one
+static int32_t gatherNoteEvents(InstrumentClip* clip, int32_t numLoops, NoteEvent** getEvents) {
+	int32_t totalTicks = clip->loopLength * numLoops;
+
+	int32_t numEvents = 0;
+	for (int32_t i = 0; i < clip->noteRows.getNumElements(); i++) {
+		NoteRow* noteRow = clip->noteRows.getElement(i);
+		if (noteRow->muted) {
+			continue;
+		}
+		int32_t rowLength = noteRow->loopLengthIfIndependent ? noteRow->loopLengthIfIndependent : clip->loopLength;
+		numEvents += noteRow->notes.getNumElements() * 2 * ((totalTicks + rowLength - 1) / rowLength);
+	}
+
+	NoteEvent* events = (NoteEvent*)GeneralMemoryAllocator::get().allocTemporary(
+	    std::max<int32_t>(numEvents, 1) * sizeof(NoteEvent));
+	if (!events) {
+		return -1;
+	}
+
+	numEvents = 0;
+	for (int32_t i = 0; i < clip->noteRows.getNumElements(); i++) {
+		NoteRow* noteRow = clip->noteRows.getElement(i);
+		if (noteRow->muted) {
+			continue;
+		}
+		int32_t rowLength = noteRow->loopLengthIfIndependent ? noteRow->loopLengthIfIndependent : clip->loopLength;
+
+		for (int32_t rowStart = 0; rowStart < totalTicks; rowStart += rowLength) {
+			for (int32_t n = 0; n < noteRow->notes.getNumElements(); n++) {
+				Note* note = noteRow->notes.getElement(n);
+				int32_t pos = rowStart + note->pos;
+				if (pos >= totalTicks) {
+					break;
+				}
+				events[numEvents++] = {ticksToSamples(pos), noteRow->y, (uint8_t)note->getVelocity(), true};
+				events[numEvents++] = {ticksToSamples(pos + note->getLength()), noteRow->y, (uint8_t)note->getLift(),
+				                       false};
+			}
+		}
+	}
+
+	std::sort(events, events + numEvents, noteEventIsEarlier);
+	*getEvents = events;
+	return numEvents;
+}
+
+bool canBounceClip(InstrumentClip* clip) {
+	return clip->output->type == InstrumentType::SYNTH && !clip->isArrangementOnlyClip()
+	       && ((SoundInstrument*)clip->output)->getArpSettings(clip)->mode == ArpMode::OFF;
+}
+
+int32_t bounceClip(InstrumentClip* clip, String* filePath) {
+	if (!canBounceClip(clip) || playbackHandler.isEitherClockActive()) {
+		return ERROR_UNSPECIFIED;
+	}
+
+	SoundInstrument* instrument = (SoundInstrument*)clip->output;
+
+	String tempFilePath;
+	uint32_t fileNumber;
+	int32_t error = audioFileManager.getUnusedAudioRecordingFilePath(filePath, &tempFilePath,
+	                                                                 AudioRecordingFolder::RESAMPLE, &fileNumber);
+	if (error) {
+		return error;
+	}
+
+	NoteEvent* events;
+	int32_t numEvents = gatherNoteEvents(clip, 2, &events);
+	if (numEvents < 0) {
+		return ERROR_INSUFFICIENT_RAM;
+	}
+
+	uint8_t* writeBuffer =
+	    (uint8_t*)GeneralMemoryAllocator::get().allocTemporary(kWriteBufferNumFrames * kBytesPerFrame);
+	if (!writeBuffer) {
+		delugeDealloc(events);
+		return ERROR_INSUFFICIENT_RAM;
+	}
+
+	FIL file;
+	error = storageManager.createFile(&file, filePath->get(), false);
+	if (error) {
+		delugeDealloc(writeBuffer);
+		delugeDealloc(events);
+		return error;
+	}
+
+	uint32_t loopSamples = ticksToSamples(clip->loopLength);
+	uint32_t totalSamples = loopSamples * 2;
+
+	writeWaveHeader(writeBuffer, loopSamples);
+	int32_t bytesInWriteBuffer = kWaveHeaderSize;
+
+	char modelStackMemory[MODEL_STACK_MAX_SIZE];
+	ModelStack* modelStack = setupModelStackWithSong(modelStackMemory, currentSong);
+	ModelStackWithTimelineCounter* modelStackWithTimelineCounter = modelStack->addTimelineCounter(clip);
+	instrument->setActiveClip(modelStackWithTimelineCounter, PgmChangeSend::NEVER);
+	ModelStackWithThreeMainThings* modelStackWithThreeMainThings =
+	    modelStackWithTimelineCounter->addOtherTwoThingsButNoNoteRow(instrument->toModControllable(),
+	                                                                 &clip->paramManager);
+
+	// From here the live engine doesn't render, as its voices are ours for now. Zero what the DMA's going to keep
+	// cycling through, so it's silence rather than a buzz
+	AudioEngine::routineWithClusterLoading();
+	AudioEngine::audioRoutineLocked = true;
+	memset(getTxBufferStart(), 0, (uint32_t)getTxBufferEnd() - (uint32_t)getTxBufferStart());
+	instrument->unassignAllVoices();
+
+	static StereoSample renderBuffer[SSI_TX_BUFFER_NUM_SAMPLES] __attribute__((aligned(CACHE_LINE_SIZE)));
+	static int32_t reverbBuffer[SSI_TX_BUFFER_NUM_SAMPLES] __attribute__((aligned(CACHE_LINE_SIZE)));
+
+	uint32_t time = 0;
+	int32_t e = 0;
+	while (time < totalSamples) {
+		for (; e < numEvents && events[e].time <= time; e++) {
+			instrument->sendNote(modelStackWithThreeMainThings, events[e].on, events[e].noteCode, nullptr,
+			                     MIDI_CHANNEL_NONE, events[e].velocity, 0, 0, 0);
+		}
+
+		// Nothing's in any hurry, so any sample data the voices need gets loaded before it's needed rather than
+		// being missed out
+		audioFileManager.loadAnyEnqueuedClusters();
+
+		uint32_t chunkEnd = std::min<uint32_t>(time + SSI_TX_BUFFER_NUM_SAMPLES, totalSamples);
+		if (time < loopSamples) {
+			chunkEnd = std::min(chunkEnd, loopSamples);
+		}
+		if (e < numEvents) {
+			chunkEnd = std::min(chunkEnd, events[e].time);
+		}
+		int32_t numSamples = chunkEnd - time;
+
+		memset(renderBuffer, 0, numSamples * sizeof(StereoSample));
+		memset(reverbBuffer, 0, numSamples * sizeof(int32_t));
+
+		// The song's reverb isn't part of the clip's own chain, so nothing's sent to it
+		instrument->renderOutput(modelStack, renderBuffer, renderBuffer + numSamples, numSamples, reverbBuffer, 0, 0,
+		                         false, true);
+
+		// Only the second loop gets kept. Same gain as resampling the mix
+		if (time >= loopSamples) {
+			for (int32_t i = 0; i < numSamples; i++) {
+				int32_t l = lshiftAndSaturate<5>(renderBuffer[i].l);
+				int32_t r = lshiftAndSaturate<5>(renderBuffer[i].r);
+				uint8_t* pos = &writeBuffer[bytesInWriteBuffer];
+				pos[0] = l >> 8;
+				pos[1] = l >> 16;
+				pos[2] = l >> 24;
+				pos[3] = r >> 8;
+				pos[4] = r >> 16;
+				pos[5] = r >> 24;
+				bytesInWriteBuffer += kBytesPerFrame;
+
+				if (bytesInWriteBuffer > (kWriteBufferNumFrames - 1) * kBytesPerFrame) {
+					UINT bytesWritten;
+					FRESULT result = f_write(&file, writeBuffer, bytesInWriteBuffer, &bytesWritten);
+					if (result != FR_OK || bytesWritten != bytesInWriteBuffer) {
+						error = ERROR_SD_CARD;
+						goto finished;
+					}
+					bytesInWriteBuffer = 0;
+					routineForSD(); // Keeps the loading animation going
+				}
+			}
+		}
+
+		time = chunkEnd;
+	}
+
+	if (bytesInWriteBuffer) {
+		UINT bytesWritten;
+		FRESULT result = f_write(&file, writeBuffer, bytesInWriteBuffer, &bytesWritten);
+		if (result != FR_OK || bytesWritten != bytesInWriteBuffer) {
+			error = ERROR_SD_CARD;
+		}
+	}
+
+finished:
+	// Anything still held, e.g. a note running on past the end, gets cut off with the tails
+	for (; e < numEvents; e++) {
+		if (!events[e].on) {
+			instrument->sendNote(modelStackWithThreeMainThings, false, events[e].noteCode, nullptr,
+			                     MIDI_CHANNEL_NONE, events[e].velocity, 0, 0, 0);
+		}
+	}
+	instrument->unassignAllVoices();
+	AudioEngine::audioRoutineLocked = false;
+
+	if (f_close(&file) != FR_OK && !error) {
+		error = ERROR_SD_CARD;
+	}
+	delugeDealloc(writeBuffer);
+	delugeDealloc(events);
+
+	if (error) {
+		f_unlink(filePath->get());
+	}
+	else {
+		Debug::print("bounced ");
+		Debug::println(filePath->get());
+	}
+	return error;
+}
+
+int32_t freezeClip(InstrumentClip* clip) {
+	int32_t clipIndex = currentSong->sessionClips.getIndexForClip(clip);
+	if (clipIndex < 0) {
+		return ERROR_UNSPECIFIED;
+	}
+
+	String filePath;
+	int32_t error = bounceClip(clip, &filePath);
+	if (error) {
+		return error;
+	}
+
+	void* clipMemory = GeneralMemoryAllocator::get().alloc(sizeof(AudioClip), NULL, false, true);
+	if (!clipMemory) {
+		return ERROR_INSUFFICIENT_RAM;
+	}
+
+	AudioOutput* newOutput = currentSong->createNewAudioOutput();
+	if (!newOutput) {
+		delugeDealloc(clipMemory);
+		return ERROR_INSUFFICIENT_RAM;
+	}
+	newOutput->colour = clip->output->colour;
+
+	AudioClip* newClip = new (clipMemory) AudioClip();
+	newClip->cloneFrom(clip);
+
+	char modelStackMemory[MODEL_STACK_MAX_SIZE];
+	ModelStackWithTimelineCounter* modelStack =
+	    setupModelStackWithSong(modelStackMemory, currentSong)->addTimelineCounter(newClip);
+	newClip->setOutput(modelStack, newOutput);
+
+	error = currentSong->sessionClips.insertClipAtIndex(newClip, clipIndex + 1);
+	if (error) {
+		newClip->~AudioClip();
+		delugeDealloc(clipMemory);
+		return error;
+	}
+	newOutput->setActiveClip(modelStack);
+
+	// The render's exactly one loop long at the current tempo, so it fits the same loopLength
+	newClip->sampleHolder.filePath.set(&filePath);
+	error = newClip->sampleHolder.loadFile(false, true, true);
+	if (error) {
+		return error; // Leaves an empty AudioClip, same as when browsing to a file fails
+	}
+
+	// The frozen one plays instead of the original from now on
+	clip->activeIfNoSolo = false;
+	clip->soloingInSessionMode = false;
+	clip->armState = ArmState::OFF;
+	return NO_ERROR;
+}
+
+} // namespace BounceEngine
@@ -0,0 +1,45 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstdint>
+
+class InstrumentClip;
+class String;
+
+/*
+ * Renders a synth clip to a WAV on the card offline - as fast as the CPU will go rather than in real time - for while
+ * playback's stopped. The live output is silenced while it happens. Only the clip's own Sound and its FX chain are
+ * rendered: the song's reverb, master FX and any sidechain from other clips are left out, as they are when resampling
+ * a single output. The notes are played straight from the clip's NoteRows, so there's no automation, arp or
+ * probability, and the Sound's params stay wherever they are now.
+ */
+namespace BounceEngine {
+
+/// Whether clip can be bounced at all - a synth clip in the session, with its arp off
+bool canBounceClip(InstrumentClip* clip);
+
+/// Writes one loop of the clip to a new file in SAMPLES/RESAMPLE, whose path gets put in filePath. The loop before it
+/// is rendered first but not kept, so anything which rings on over the loop point - releases, delay - is there at the
+/// start just as when it's looping
+int32_t bounceClip(InstrumentClip* clip, String* filePath);
+
+/// Bounces the clip, then puts an AudioClip of the render in the session just after it, and mutes the original
+/// instead. To unfreeze, delete the AudioClip and unmute the original - which is left exactly as it was
+int32_t freezeClip(InstrumentClip* clip);
+
+} // namespace BounceEngine
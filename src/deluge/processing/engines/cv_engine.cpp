@@ -41,6 +41,7 @@ CVEngine::CVEngine() {
 	gateOutputPending = false;
 	asapGateOutputPending = false;
 	clockOutputPending = false;
+	cvOutputPending = false;
 	minGateOffTime = 10;
 	clockState = false;
 	mostRecentSwitchOffTimeOfPendingNoteOn = 0;
@@ -90,8 +91,13 @@ void CVEngine::init() {
 	updateRunOutput();
 }
 
-// Gets called even for run and clock
+// Gets called even for run and clock. Any pending CV voltages go out first, in the same go, so that the pitch has
+// already settled by the time a gate switches on
 void CVEngine::updateGateOutputs() {
+	if (cvOutputPending) {
+		sendPendingVoltages();
+	}
+
 	if (gateOutputPending || clockOutputPending || asapGateOutputPending) {
 		for (int32_t g = 0; g < NUM_GATE_CHANNELS; g++) {
 			physicallySwitchGate(g);
@@ -117,6 +123,9 @@ void CVEngine::switchGateOn(int32_t channel, int32_t doInstantlyIfPossible) {
 	if (doInstantlyIfPossible) {
 		uint32_t timeSinceLastSwitchedOff = AudioEngine::audioSampleTimer - gateChannels[channel].timeLastSwitchedOff;
 		if (timeSinceLastSwitchedOff >= minGateOffTime * 441) {
+			if (channel < NUM_CV_CHANNELS && cvChannels[channel].voltagePending) {
+				sendPendingVoltages();
+			}
 			physicallySwitchGate(channel);
 			return;
 		}
@@ -167,7 +176,7 @@ void CVEngine::sendNote(bool on, uint8_t channel, int16_t note) {
 			voltage = calculateVoltage(note, channel);
 			voltage = std::min(voltage, (int32_t)65535);
 			voltage = std::max(voltage, (int32_t)0);
-			sendVoltageOut(channel, voltage);
+			queueVoltageOut(channel, voltage);
 		}
 
 		switchGateOn(channel);
@@ -189,6 +198,25 @@ void CVEngine::sendVoltageOut(uint8_t channel, uint16_t voltage) {
 	}
 }
 
+// Rather than going straight to the DAC, voltages wait to be sent along with any gate changes and MIDI by
+// updateGateOutputs(), when the MIDI / gate output timer goes off at the matching point in the audio. If the same
+// channel changes again before then, e.g. several pitch bends within one audio window, only the latest gets sent.
+void CVEngine::queueVoltageOut(uint8_t channel, uint16_t voltage) {
+	cvChannels[channel].pendingVoltage = voltage;
+	cvChannels[channel].voltagePending = true;
+	cvOutputPending = true;
+}
+
+void CVEngine::sendPendingVoltages() {
+	cvOutputPending = false;
+	for (int32_t c = 0; c < NUM_CV_CHANNELS; c++) {
+		if (cvChannels[c].voltagePending) {
+			cvChannels[c].voltagePending = false;
+			sendVoltageOut(c, cvChannels[c].pendingVoltage);
+		}
+	}
+}
+
 void CVEngine::physicallySwitchGate(int32_t channel) {
 	//setOutputState is inverted - sending true turns the gate off
 	int32_t on = gateChannels[channel].on == (gateChannels[channel].mode == GateType::S_TRIG);
@@ -219,7 +247,7 @@ void CVEngine::recalculateCVChannelVoltage(uint8_t channel) {
 
 	voltage = std::min(voltage, (int32_t)65535);
 	voltage = std::max(voltage, (int32_t)0);
-	sendVoltageOut(channel, voltage);
+	queueVoltageOut(channel, voltage);
 }
 
 // Represents 1V as 6552. So 10V is 65520.
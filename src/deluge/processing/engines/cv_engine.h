@@ -34,6 +34,7 @@ public:
 		transpose = 0;
 		cents = 0;
 		pitchBend = 0;
+		voltagePending = false;
 	}
 	int16_t noteCurrentlyPlaying;
 	uint8_t voltsPerOctave;
@@ -41,6 +42,8 @@ public:
 	int8_t cents;
 	int32_t
 	    pitchBend; // (1 << 23) represents one semitone. So full 32-bit range can be +-256 semitones. This is different to the equivalent calculation in Voice, which needs to get things into a number of octaves.
+	uint16_t pendingVoltage; // Latest value waiting to go to the DAC - any earlier ones it replaced never get sent
+	bool voltagePending;
 };
 
 class GateChannel {
@@ -85,6 +88,7 @@ public:
 	bool gateOutputPending;
 	bool asapGateOutputPending;
 	bool clockOutputPending;
+	bool cvOutputPending; // Set when either CV channel has a voltagePending
 
 	// When one or more note-on is pending, this is the latest time that one of them last switched off.
 	// But it seems I only use this very coarsely - more to see if we're still in the same audio frame than to measure time exactly.
@@ -99,6 +103,8 @@ public:
 
 private:
 	void recalculateCVChannelVoltage(uint8_t channel);
+	void queueVoltageOut(uint8_t channel, uint16_t voltage);
+	void sendPendingVoltages();
 	void switchGateOff(int32_t channel);
 	void switchGateOn(int32_t channel, int32_t doInstantlyIfPossible = false);
 };
@@ -0,0 +1,156 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "processing/engines/direct_monitor.h"
+#include "drivers/ssi/ssi.h"
+#include "model/settings/runtime_feature_settings.h"
+#include "processing/engines/audio_engine.h"
+#include "util/fixedpoint.h"
+#include "util/functions.h"
+#include <algorithm>
+#include <cstring>
+
+DirectMonitor directMonitor{};
+
+bool DirectMonitor::isEnabled() {
+	return runtimeFeatureSettings.get(RuntimeFeatureSettingType::DirectMonitoring) == RuntimeFeatureStateToggle::On;
+}
+
+void DirectMonitor::beginRender() {
+	rendering = isEnabled();
+	memset(pendingGains, 0, sizeof(pendingGains));
+}
+
+bool DirectMonitor::addInput(AudioInputChannel channel, int32_t amplitude) {
+	if (!rendering) {
+		return false;
+	}
+
+	switch (channel) {
+	case AudioInputChannel::LEFT:
+		pendingGains[0][0] += amplitude;
+		pendingGains[1][0] += amplitude;
+		break;
+
+	case AudioInputChannel::RIGHT:
+		pendingGains[0][1] += amplitude;
+		pendingGains[1][1] += amplitude;
+		break;
+
+	case AudioInputChannel::BALANCED:
+		for (int32_t o = 0; o < 2; o++) {
+			pendingGains[o][0] += amplitude >> 1;
+			pendingGains[o][1] -= amplitude >> 1;
+		}
+		break;
+
+	case AudioInputChannel::NONE: // Means combine channels
+		for (int32_t o = 0; o < 2; o++) {
+			pendingGains[o][0] += amplitude >> 1;
+			pendingGains[o][1] += amplitude >> 1;
+		}
+		break;
+
+	default: // STEREO
+		pendingGains[0][0] += amplitude;
+		pendingGains[1][1] += amplitude;
+	}
+	return true;
+}
+
+void DirectMonitor::endRender(int32_t masterVolumeAdjustmentL, int32_t masterVolumeAdjustmentR,
+                              int32_t outputGainDoublings) {
+	if (!rendering) {
+		// Turned off, or no render this time to say what's echoing
+		if (!isEnabled()) {
+			active = false;
+		}
+		return;
+	}
+	rendering = false;
+
+	// The render path takes the input up by amplitude >> 30, and the output stage by masterVolumeAdjustment >> 32
+	// and then outputGainDoublings
+	int32_t const masterVolumeAdjustments[2] = {masterVolumeAdjustmentL, masterVolumeAdjustmentR};
+	bool anythingEchoing = false;
+	for (int32_t o = 0; o < 2; o++) {
+		for (int32_t i = 0; i < 2; i++) {
+			int64_t amplitude = std::clamp<int64_t>(pendingGains[o][i], INT32_MIN, INT32_MAX);
+			int64_t gain = (amplitude * masterVolumeAdjustments[o]) >> (62 - 27 - outputGainDoublings);
+			gains[o][i] = std::clamp<int64_t>(gain, INT32_MIN, INT32_MAX);
+			anythingEchoing = anythingEchoing || gains[o][i];
+		}
+	}
+
+	if (!anythingEchoing) {
+		active = false;
+	}
+	else if (!active) {
+		active = true;
+		synced = false;
+		leadSamples = kMinLeadSamples;
+	}
+}
+
+void DirectMonitor::routine() {
+	if (!active) {
+		return;
+	}
+
+	int32_t* const txBuffer = getTxBufferStart();
+	int32_t const* const rxBuffer = getRxBufferStart();
+	uint32_t txNow = ((int32_t*)getTxBufferCurrentPlace() - txBuffer) >> NUM_MONO_OUTPUT_CHANNELS_MAGNITUDE;
+	uint32_t rxNow = ((int32_t const*)getRxBufferCurrentPlace() - rxBuffer) >> NUM_MONO_INPUT_CHANNELS_MAGNITUDE;
+
+	// How far ahead of the DMA the render's written. Same as AudioEngine::routine(), the write position being where
+	// the DMA is means the buffer's full
+	uint32_t txWritePos = ((int32_t*)AudioEngine::i2sTXBufferPos - txBuffer) >> NUM_MONO_OUTPUT_CHANNELS_MAGNITUDE;
+	uint32_t written = ((txWritePos - txNow - 1) & (SSI_TX_BUFFER_NUM_SAMPLES - 1)) + 1;
+
+	uint32_t ahead = (txPos - txNow) & (SSI_TX_BUFFER_NUM_SAMPLES - 1);
+	if (synced && (int32_t)ahead > leadSamples) {
+		// The DMA's got past what we'd mixed - we weren't called again soon enough, so we'll need to stay further ahead
+		leadSamples = std::min(leadSamples * 2, kMaxLeadSamples);
+		synced = false;
+	}
+
+	if (!synced) {
+		// The input's read a fixed distance behind where the RX DMA is now, and the TX and RX DMAs go in step, so it
+		// stays that far behind
+		txPos = (txNow + leadSamples) & (SSI_TX_BUFFER_NUM_SAMPLES - 1);
+		rxPos = (rxNow - kInputMargin) & (SSI_RX_BUFFER_NUM_SAMPLES - 1);
+		synced = true;
+		return;
+	}
+
+	// Only on top of what the render's already written, or it'll just write over it
+	int32_t numSamples = (int32_t)std::min<uint32_t>(leadSamples, written) - (int32_t)ahead;
+
+	for (int32_t s = 0; s < numSamples; s++) {
+		int32_t const* input = rxBuffer + (rxPos << NUM_MONO_INPUT_CHANNELS_MAGNITUDE);
+		int32_t* output = txBuffer + (txPos << NUM_MONO_OUTPUT_CHANNELS_MAGNITUDE);
+
+		for (int32_t o = 0; o < 2; o++) {
+			int32_t value =
+			    multiply_32x32_rshift32(input[0], gains[o][0]) + multiply_32x32_rshift32(input[1], gains[o][1]);
+			output[o] = add_saturation(output[o], lshiftAndSaturate<5>(value));
+		}
+
+		txPos = (txPos + 1) & (SSI_TX_BUFFER_NUM_SAMPLES - 1);
+		rxPos = (rxPos + 1) & (SSI_RX_BUFFER_NUM_SAMPLES - 1);
+	}
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "definitions_cxx.hpp"
+#include <cstdint>
+
+/*
+ * Mixes live input straight into the SSI TX buffer, just ahead of where the DMA's reading it out, for echoing
+ * AudioOutputs when the Direct Monitoring community feature is on. Normally their input gets read alongside where the
+ * render's writing to, which is a whole TX buffer (128 samples) plus a bit ahead of what's being heard - so that's how
+ * late the echo is. This way, only a gain gets applied - the AudioOutput's volume and the master volume - and none of
+ * the AudioOutput's or Song's effects, nor the master compressor.
+ *
+ * How far ahead of the DMA we mix is as little as we can get away with, going by how often routine() gets called. If
+ * the DMA ever overtakes us, we start again further ahead, which is a glitch in the monitored input, but only until
+ * the latency settles. It goes back to the shortest whenever there's nothing left echoing.
+ */
+class DirectMonitor {
+public:
+	static bool isEnabled();
+
+	// Around each render. In between, echoing AudioOutputs hand their input over with addInput() instead of rendering
+	// it, if that returns true
+	void beginRender();
+	bool addInput(AudioInputChannel channel, int32_t amplitude);
+	void endRender(int32_t masterVolumeAdjustmentL, int32_t masterVolumeAdjustmentR, int32_t outputGainDoublings);
+
+	// As often as possible - the more often it's called, the less latency there is
+	void routine();
+
+	[[nodiscard]] int32_t getLatencySamples() const { return active ? leadSamples + kInputMargin : 0; }
+
+private:
+	static constexpr int32_t kMinLeadSamples = 16;
+	static constexpr int32_t kMaxLeadSamples = SSI_TX_BUFFER_NUM_SAMPLES * 3 / 4;
+	// How far behind the RX DMA we read, in case it's a little out of step with the TX DMA
+	static constexpr int32_t kInputMargin = 8;
+
+	bool rendering = false;
+	bool active = false;
+	bool synced = false;
+	int32_t leadSamples = kMinLeadSamples;
+
+	// [output channel][input channel]. pendingGains are what echoing AudioOutputs add up to during a render, at their
+	// scale - 1 << 30 is unity. gains are those with the master volume too, to apply straight to the TX buffer - 1 << 27
+	// is unity there
+	int64_t pendingGains[2][2];
+	int32_t gains[2][2];
+
+	// Where we're up to in each buffer, in samples
+	uint32_t txPos;
+	uint32_t rxPos;
+};
+
+extern DirectMonitor directMonitor;
@@ -0,0 +1,57 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "processing/engines/engine_command_queue.h"
+#include "gui/ui/ui.h"
+#include "processing/engines/audio_engine.h"
+
+EngineCommandQueue engineCommandQueue{};
+
+void EngineCommandQueue::push(EngineCommand const& command) {
+	if (!queue.push(command)) {
+		// It'd take some turning to get here within one block, but rather than lose any, make room
+		apply();
+		queue.push(command);
+	}
+}
+
+void EngineCommandQueue::applyPending() {
+	if (queue.empty() || AudioEngine::audioSampleTimer == timeLastApplied) {
+		return;
+	}
+	apply();
+}
+
+void EngineCommandQueue::apply() {
+	timeLastApplied = AudioEngine::audioSampleTimer;
+
+	int32_t modEncoderOffsets[2] = {0, 0};
+	EngineCommand command;
+	while (queue.pop(&command)) {
+		switch (command.type) {
+		case EngineCommandType::MOD_ENCODER:
+			modEncoderOffsets[command.which] += command.value;
+			break;
+		}
+	}
+
+	for (int32_t e = 0; e < 2; e++) {
+		if (modEncoderOffsets[e]) {
+			getCurrentUI()->modEncoderAction(e, modEncoderOffsets[e]);
+		}
+	}
+}
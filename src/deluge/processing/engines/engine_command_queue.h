@@ -0,0 +1,51 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "util/container/spsc_queue.h"
+#include <cstdint>
+
+enum class EngineCommandType : uint8_t {
+	MOD_ENCODER, // which = the mod encoder, value = how far it turned
+};
+
+struct EngineCommand {
+	EngineCommandType type;
+	uint8_t which;
+	int32_t value;
+};
+
+// User actions which change what the audio render reads, held until the render's between blocks and then applied
+// together. Everything's on the one thread for now, so this is mostly about not doing the same work many times a block:
+// however many turns of a mod encoder come in while a block's being rendered, its param only gets changed once,
+// to where it ended up. Producer and consumer are kept to the two sides of an SPSCQueue, so input could one day be
+// pushed from an ISR.
+class EngineCommandQueue {
+public:
+	void push(EngineCommand const& command);
+
+	// Applies anything waiting, as long as a block has been rendered since last time
+	void applyPending();
+
+private:
+	void apply();
+
+	SPSCQueue<EngineCommand, 16> queue;
+	uint32_t timeLastApplied = 0;
+};
+
+extern EngineCommandQueue engineCommandQueue;
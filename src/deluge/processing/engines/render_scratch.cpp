@@ -0,0 +1,39 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "processing/engines/render_scratch.h"
+#include "hid/display/display.h"
+
+PLACE_INTERNAL_FRUNK uint8_t renderScratchMemory[kRenderScratchSize] __attribute__((aligned(CACHE_LINE_SIZE)));
+
+RenderScratch renderScratch{};
+
+void* RenderScratch::acquire(uint32_t size) {
+	size = (size + CACHE_LINE_SIZE - 1) & ~(uint32_t)(CACHE_LINE_SIZE - 1);
+	if (used + size > kRenderScratchSize) {
+		// Everything that uses this is accounted for in kRenderScratchSize, so this means something's been added that
+		// isn't
+		if (ALPHA_OR_BETA_VERSION) {
+			display->freezeWithError("E470");
+		}
+		return NULL;
+	}
+
+	void* address = &renderScratchMemory[used];
+	used += size;
+	return address;
+}
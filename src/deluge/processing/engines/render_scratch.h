@@ -0,0 +1,63 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "definitions_cxx.hpp"
+#include "dsp/stereo_sample.h"
+#include <cstdint>
+
+// The most that's ever in use at once: the reverb send, plus the two reverb outputs or a GroupBus's buffer and one
+// Output's effects buffer
+constexpr uint32_t kRenderScratchSize = SSI_TX_BUFFER_NUM_SAMPLES * (sizeof(int32_t) + sizeof(StereoSample) * 2);
+
+/*
+ * Working buffers for a render block, handed out from one block of internal RAM by bumping along it, and given back in
+ * the reverse order by going out of scope - see ScratchBuffer. Things that render one after another - each Output's
+ * effects, say - then all share the same space, instead of each having a static buffer of its own, and it's all in
+ * fast RAM. reset() at the start of each block means anything that didn't get given back isn't lost for good.
+ */
+class RenderScratch {
+public:
+	void reset() { used = 0; }
+	void* acquire(uint32_t size); // Cache-line aligned. NULL if there's not room
+	[[nodiscard]] uint32_t getMark() const { return used; }
+	void releaseTo(uint32_t mark) { used = mark; }
+
+private:
+	uint32_t used = 0;
+};
+
+extern RenderScratch renderScratch;
+
+// A buffer of numElements Ts from renderScratch, for as long as this object lives. Check get() isn't NULL
+template <typename T>
+class ScratchBuffer {
+public:
+	ScratchBuffer(int32_t numElements) : mark(renderScratch.getMark()) {
+		memory = (T*)renderScratch.acquire(numElements * sizeof(T));
+	}
+	~ScratchBuffer() { renderScratch.releaseTo(mark); }
+	ScratchBuffer(ScratchBuffer const&) = delete;
+	ScratchBuffer& operator=(ScratchBuffer const&) = delete;
+
+	[[nodiscard]] T* get() const { return memory; }
+
+private:
+	T* memory;
+	uint32_t mark;
+};
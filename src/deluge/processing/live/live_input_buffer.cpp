@@ -18,6 +18,7 @@
 #include "processing/live/live_input_buffer.h"
 #include "definitions_cxx.hpp"
 #include "dsp/stereo_sample.h"
+#include "model/settings/runtime_feature_settings.h"
 #include "processing/engines/audio_engine.h"
 #include "util/functions.h"
 #include <string.h>
@@ -26,9 +27,18 @@ extern "C" {
 #include "drivers/ssi/ssi.h"
 }
 
+namespace {
+constexpr int32_t kAnalysisBlockMagnitude = 3;
+constexpr int32_t kAnalysisBlockSize = 1 << kAnalysisBlockMagnitude;
+
+// 1 - (1 - 1/512)^8, i.e. what the per-sample LPF's 1/512 coefficient adds up to over a block of 8
+constexpr int32_t kAnalysisBlockLPFCoefficient = 66651900;
+} // namespace
+
 LiveInputBuffer::LiveInputBuffer() {
 	upToTime = 0;
 	numRawSamplesProcessed = 0;
+	angleBlockTotal = 0;
 }
 
 void LiveInputBuffer::giveInput(int32_t numSamples, uint32_t currentTime, OscType inputType) {
@@ -43,8 +53,14 @@ void LiveInputBuffer::giveInput(int32_t numSamples, uint32_t currentTime, OscTyp
 		lastSampleRead = 0;
 		lastAngle = 0;
 		memset(angleLPFMem, 0, sizeof(angleLPFMem));
+		angleBlockTotal = 0;
 	}
 
+	// The "eco" pitch shift setting runs the percussiveness analysis at block rate. This buffer is shared by every
+	// pitch shifter reading this input, so the analysis is only ever done once per input anyway
+	bool blockRateAnalysis =
+	    runtimeFeatureSettings.get(RuntimeFeatureSettingType::EcoPitchShift) == RuntimeFeatureStateToggle::On;
+
 	int32_t const* __restrict__ inputReadPos = (int32_t const*)AudioEngine::i2sRXBufferPos;
 
 	uint32_t endNumRawSamplesProcessed = numRawSamplesProcessed + numSamples;
@@ -73,28 +89,66 @@ void LiveInputBuffer::giveInput(int32_t numSamples, uint32_t currentTime, OscTyp
 			angle = -angle;
 		}
 
-		for (int32_t p = 0; p < kDifferenceLPFPoles; p++) {
-			int32_t distanceToGo = angle - angleLPFMem[p];
-			angleLPFMem[p] += multiply_32x32_rshift32_rounded(distanceToGo, 1 << 23); //distanceToGo >> 9;
+		if (blockRateAnalysis) {
+			angleBlockTotal += angle >> kAnalysisBlockMagnitude;
+
+			// Only feed the LPF at the end of each block, with its coefficient raised to cover the whole block
+			if ((numRawSamplesProcessed & (kAnalysisBlockSize - 1)) == kAnalysisBlockSize - 1) {
+				angle = angleBlockTotal;
+				angleBlockTotal = 0;
+				for (int32_t p = 0; p < kDifferenceLPFPoles; p++) {
+					int32_t distanceToGo = angle - angleLPFMem[p];
+					angleLPFMem[p] += multiply_32x32_rshift32_rounded(distanceToGo, kAnalysisBlockLPFCoefficient);
+
+					angle = angleLPFMem[p];
+				}
+			}
+
+			else if ((numRawSamplesProcessed & (kAnalysisBlockSize - 1)) == 0) {
+				angle = angleLPFMem[kDifferenceLPFPoles - 1];
 
-			angle = angleLPFMem[p];
+				if ((numRawSamplesProcessed & (kPercBufferReductionSize - 1)) == 0) {
+					// lastAngle is from a whole block ago, so scale the change back down to a per-sample one
+					int32_t difference = (angle - lastAngle) >> kAnalysisBlockMagnitude;
+					if (difference < 0) {
+						difference = -difference;
+					}
+
+					int32_t percussiveness = ((uint64_t)difference * 262144 / angle) >> 1;
+
+					percussiveness = getTanH<23>(percussiveness);
+
+					percBuffer[(numRawSamplesProcessed >> kPercBufferReductionMagnitude)
+					           & (kInputPercBufferSize - 1)] = percussiveness;
+				}
+				lastAngle = angle;
+			}
 		}
 
-		if ((numRawSamplesProcessed & (kPercBufferReductionSize - 1)) == 0) {
+		else {
+			for (int32_t p = 0; p < kDifferenceLPFPoles; p++) {
+				int32_t distanceToGo = angle - angleLPFMem[p];
+				angleLPFMem[p] += multiply_32x32_rshift32_rounded(distanceToGo, 1 << 23); //distanceToGo >> 9;
 
-			int32_t difference = angle - lastAngle;
-			if (difference < 0) {
-				difference = -difference;
+				angle = angleLPFMem[p];
 			}
 
-			int32_t percussiveness = ((uint64_t)difference * 262144 / angle) >> 1;
+			if ((numRawSamplesProcessed & (kPercBufferReductionSize - 1)) == 0) {
 
-			percussiveness = getTanH<23>(percussiveness);
+				int32_t difference = angle - lastAngle;
+				if (difference < 0) {
+					difference = -difference;
+				}
 
-			percBuffer[(numRawSamplesProcessed >> kPercBufferReductionMagnitude) & (kInputPercBufferSize - 1)] =
-			    percussiveness;
+				int32_t percussiveness = ((uint64_t)difference * 262144 / angle) >> 1;
+
+				percussiveness = getTanH<23>(percussiveness);
+
+				percBuffer[(numRawSamplesProcessed >> kPercBufferReductionMagnitude) & (kInputPercBufferSize - 1)] =
+				    percussiveness;
+			}
+			lastAngle = angle;
 		}
-		lastAngle = angle;
 
 		inputReadPos += NUM_MONO_INPUT_CHANNELS;
 		if (inputReadPos >= getRxBufferEnd()) {
@@ -34,6 +34,7 @@ public:
 	int32_t lastSampleRead;
 	int32_t lastAngle;
 	int32_t angleLPFMem[kDifferenceLPFPoles];
+	int32_t angleBlockTotal; // For the "eco" analysis, which only runs the LPF once per kAnalysisBlockSize samples
 
 	uint8_t percBuffer[kInputPercBufferSize];
 
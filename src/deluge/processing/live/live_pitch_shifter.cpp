@@ -22,6 +22,7 @@
 #include "io/debug/print.h"
 #include "memory/general_memory_allocator.h"
 #include "processing/engines/audio_engine.h"
+#include "model/settings/runtime_feature_settings.h"
 #include "processing/live/live_input_buffer.h"
 #include "storage/storage_manager.h"
 #include "util/functions.h"
@@ -29,6 +30,10 @@
 
 //#define MEASURE_HOP_END_PERFORMANCE 1
 
+// How many of the latest percussiveness values (each covering kPercBufferReductionSize samples) must all be below
+// percThresholdForCut for the "eco" setting to treat the input as steady
+constexpr int32_t kNumPercValuesForSteadyInput = 4;
+
 LivePitchShifter::LivePitchShifter(OscType newInputType, int32_t phaseIncrement) {
 	inputType = newInputType;
 	numChannels = (newInputType == OscType::INPUT_STEREO) ? 2 : 1;
@@ -431,6 +436,13 @@ void LivePitchShifter::hopEnd(int32_t phaseIncrement, LiveInputBuffer* liveInput
 	randomElement = storageManager.devVarG << 16;
 	*/
 
+	// With the "eco" setting on, if the input hasn't been percussive lately, the searches below wouldn't find a much
+	// better place for the new play head than a fixed distance back - so skip them, and just crossfade between the two
+	// play heads at the fixed hop length
+	bool fixedHop =
+	    runtimeFeatureSettings.get(RuntimeFeatureSettingType::EcoPitchShift) == RuntimeFeatureStateToggle::On
+	    && inputIsSteady(liveInputBuffer, numRawSamplesProcessedLatest);
+
 	// Collect info on those moving average for the now-older play-head, which we're going to fade out -
 	// so that we can then fine-tune the position of the new play-head to match it
 
@@ -457,6 +469,9 @@ void LivePitchShifter::hopEnd(int32_t phaseIncrement, LiveInputBuffer* liveInput
 	// If commenting out this next line, must make sure we still don't search back before we started writing to buffer
 	lengthPerMovingAverage = std::min(lengthPerMovingAverage,
 	                                  averagesEndOffsetFromHead >> 1); // / TimeStretch::Crossfade::kNumMovingAverages
+	if (fixedHop) {
+		lengthPerMovingAverage = 0; // Which skips the fine-tuning search
+	}
 
 	int32_t averagesStartOffsetFromHead =
 	    averagesEndOffsetFromHead - (lengthPerMovingAverage * TimeStretch::Crossfade::kNumMovingAverages);
@@ -505,7 +520,7 @@ void LivePitchShifter::hopEnd(int32_t phaseIncrement, LiveInputBuffer* liveInput
 			float bestAverage = 0;
 			int32_t bestHowFarBack = minSearch >> kPercBufferReductionMagnitude; // Pixellated
 
-			while (backEdge < (maxSearch >> kPercBufferReductionMagnitude)) {
+			while (!fixedHop && backEdge < (maxSearch >> kPercBufferReductionMagnitude)) {
 
 				while (howFarBackSearched < backEdge) {
 					howFarBackSearched++;
@@ -861,6 +876,20 @@ void LivePitchShifter::considerRepitchedBuffer(int32_t phaseIncrement) {
 #endif
 }
 
+bool LivePitchShifter::inputIsSteady(LiveInputBuffer* liveInputBuffer, uint64_t numRawSamplesProcessedLatest) {
+	if (!liveInputBuffer) {
+		return false;
+	}
+
+	uint32_t latestPercPos = (numRawSamplesProcessedLatest - 1) >> kPercBufferReductionMagnitude;
+	for (int32_t i = 0; i < kNumPercValuesForSteadyInput; i++) {
+		if (liveInputBuffer->percBuffer[(latestPercPos - i) & (kInputPercBufferSize - 1)] >= percThresholdForCut) {
+			return false;
+		}
+	}
+	return true;
+}
+
 bool LivePitchShifter::olderPlayHeadIsCurrentlySounding() {
 	return (crossfadeProgress < 16777216);
 }
@@ -59,5 +59,6 @@ private:
 	void hopEnd(int32_t phaseIncrement, LiveInputBuffer* liveInputBuffer, uint64_t numRawSamplesProcessed,
 	            uint64_t numRawSamplesProcessedLatest);
 	void considerRepitchedBuffer(int32_t phaseIncrement);
+	bool inputIsSteady(LiveInputBuffer* liveInputBuffer, uint64_t numRawSamplesProcessedLatest);
 	bool olderPlayHeadIsCurrentlySounding();
 };
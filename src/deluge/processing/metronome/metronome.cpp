@@ -17,44 +17,69 @@
 
 #include "processing/metronome/metronome.h"
 #include "dsp/stereo_sample.h"
+#include "processing/engines/audio_engine.h"
+#include <algorithm>
+
+// The clicks are a square wave, stored as int16 and shifted up this far to get back to full level
+constexpr int32_t kClickShift = 9;
+constexpr int16_t kClickLevel = 1 << (23 - kClickShift);
 
 Metronome::Metronome() {
-	sounding = false;
+	prerender(MetronomeClick::NORMAL, 50960238);
+	prerender(MetronomeClick::ACCENTED, 128411753);
 }
 
-void Metronome::trigger(uint32_t newPhaseIncrement) {
-	sounding = true;
-	phase = 0;
-	phaseIncrement = newPhaseIncrement;
-	timeSinceTrigger = 0;
+void Metronome::prerender(MetronomeClick click, uint32_t phaseIncrement) {
+	int16_t* output = clicks[static_cast<int32_t>(click)];
+	uint32_t phase = 0;
+	for (int32_t i = 0; i < kClickLength; i++) {
+		output[i] = (phase < 2147483648u) ? kClickLevel : -kClickLevel;
+		phase += phaseIncrement;
+	}
 }
 
-void Metronome::render(StereoSample* buffer, uint16_t numSamples) {
-	if (!sounding) {
-		return;
-	}
+void Metronome::trigger(MetronomeClick click) {
+	schedule(click, AudioEngine::audioSampleTimer);
+}
 
-	StereoSample* thisSample = buffer;
-	StereoSample* bufferEnd = buffer + numSamples;
-	do {
+void Metronome::schedule(MetronomeClick click, uint32_t time) {
+	pendingClick = clicks[static_cast<int32_t>(click)];
+	pendingTime = time;
+}
 
-		int32_t value;
-		if (phase < 2147483648u) {
-			value = 8388608;
-		}
-		else {
-			value = -8388608;
+void Metronome::render(StereoSample* buffer, uint16_t numSamples) {
+	int32_t numSamplesDone = 0;
+
+	if (pendingClick) {
+		int32_t timeTilPending = (int32_t)(pendingTime - AudioEngine::audioSampleTimer);
+		if (timeTilPending < numSamples) {
+			// Finish off whatever's sounding up to there, and cut over to the new one
+			numSamplesDone = std::max<int32_t>(timeTilPending, 0);
+			mixIn(buffer, numSamplesDone);
+			soundingClick = pendingClick;
+			position = 0;
+			pendingClick = nullptr;
 		}
+	}
 
-		phase += phaseIncrement;
+	mixIn(buffer + numSamplesDone, numSamples - numSamplesDone);
+}
 
-		thisSample->l += value;
-		thisSample->r += value;
+void Metronome::mixIn(StereoSample* buffer, int32_t numSamples) {
+	if (!soundingClick) {
+		return;
+	}
 
-	} while (++thisSample != bufferEnd);
+	int32_t numToMix = std::min(numSamples, kClickLength - position);
+	int16_t const* click = soundingClick + position;
+	for (int32_t i = 0; i < numToMix; i++) {
+		int32_t value = (int32_t)click[i] << kClickShift;
+		buffer[i].l += value;
+		buffer[i].r += value;
+	}
 
-	timeSinceTrigger += numSamples;
-	if (timeSinceTrigger > 1000) {
-		sounding = false;
+	position += numToMix;
+	if (position == kClickLength) {
+		soundingClick = nullptr;
 	}
 }
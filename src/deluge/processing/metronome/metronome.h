@@ -21,14 +21,37 @@
 
 class StereoSample;
 
+enum class MetronomeClick : uint8_t {
+	NORMAL,
+	ACCENTED, // The first beat of each bar
+	NUM,
+};
+
+// Both clicks get rendered once, up front, and are then just mixed in from there. Rather than only being able to start
+// at the top of a render window, a click can be scheduled for any sample, ahead of time
 class Metronome {
 public:
 	Metronome();
-	void trigger(uint32_t newPhaseIncrement);
+	// Sounds the click right at the start of the next render
+	void trigger(MetronomeClick click);
+	// Sounds the click at the given time, in AudioEngine::audioSampleTimer terms. There's only one pending at a time, so
+	// scheduling another before then replaces it. A time that's already passed sounds right away
+	void schedule(MetronomeClick click, uint32_t time);
 	void render(StereoSample* buffer, uint16_t numSamples);
 
-	uint32_t phase;
-	uint32_t phaseIncrement;
-	uint32_t timeSinceTrigger;
-	bool sounding;
+	bool isSounding() { return soundingClick != nullptr; }
+
+private:
+	static constexpr int32_t kClickLength = 1024;
+
+	void prerender(MetronomeClick click, uint32_t phaseIncrement);
+	void mixIn(StereoSample* buffer, int32_t numSamples);
+
+	int16_t clicks[static_cast<int32_t>(MetronomeClick::NUM)][kClickLength];
+
+	int16_t const* soundingClick = nullptr;
+	int32_t position = 0;
+
+	int16_t const* pendingClick = nullptr;
+	uint32_t pendingTime = 0;
 };
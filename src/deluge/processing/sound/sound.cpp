@@ -25,6 +25,7 @@
 #include "hid/display/display.h"
 #include "hid/led/indicator_leds.h"
 #include "hid/matrix/matrix_driver.h"
+#include "io/debug/cpu_profiler.h"
 #include "io/debug/print.h"
 #include "memory/general_memory_allocator.h"
 #include "model/action/action.h"
@@ -102,6 +103,7 @@ Sound::Sound() : patcher(&patchableInfoForSound) {
 	modFXType = ModFXType::NONE;
 
 	oscillatorSync = false;
+	paraphonic = false;
 
 	numUnison = 1;
 	unisonDetune = 8;
@@ -154,7 +156,7 @@ Sound::Sound() : patcher(&patchableInfoForSound) {
 	skippingRendering = true;
 	startSkippingRenderingAtTime = 0;
 
-	paramLPF.p = PARAM_LPF_OFF;
+	numParamLPFs = 0;
 
 	doneReadingFromFile();
 }
@@ -354,19 +356,10 @@ bool Sound::setModFXType(ModFXType newType) {
 				return false;
 			}
 		}
-		if (modFXGrainBuffer) {
-			delugeDealloc(modFXGrainBuffer);
-			modFXGrainBuffer = NULL;
-		}
+		releaseGrainBuffer();
 	}
 	else if (newType == ModFXType::GRAIN) {
-		if (!modFXGrainBuffer) {
-			modFXGrainBuffer = (StereoSample*)GeneralMemoryAllocator::get().alloc(
-			    kModFXGrainBufferSize * sizeof(StereoSample), NULL, false, true);
-			if (!modFXGrainBuffer) {
-				return false;
-			}
-		}
+		// The grain buffer gets claimed when we render
 		if (modFXBuffer) {
 			delugeDealloc(modFXBuffer);
 			modFXBuffer = NULL;
@@ -377,10 +370,7 @@ bool Sound::setModFXType(ModFXType newType) {
 			delugeDealloc(modFXBuffer);
 			modFXBuffer = NULL;
 		}
-		if (modFXGrainBuffer) {
-			delugeDealloc(modFXGrainBuffer);
-			modFXGrainBuffer = NULL;
-		}
+		releaseGrainBuffer();
 	}
 
 	modFXType = newType;
@@ -1164,6 +1154,11 @@ int32_t Sound::readTagFromFile(char const* tagName, ParamManagerForTimeline* par
 		storageManager.exitTag("voicePriority");
 	}
 
+	else if (!strcmp(tagName, "paraphonic")) {
+		setParaphonic(storageManager.readTagOrAttributeValueInt() != 0);
+		storageManager.exitTag("paraphonic");
+	}
+
 	else if (!strcmp(tagName, "reverbAmount")) {
 		ENSURE_PARAM_MANAGER_EXISTS
 		patchedParams->readParam(patchedParamsSummary, Param::Global::REVERB_AMOUNT, readAutomationUpToPos);
@@ -1377,10 +1372,27 @@ PatchCableAcceptance Sound::maySourcePatchToParam(PatchSource s, uint8_t p, Para
 	return PatchCableAcceptance::ALLOWED;
 }
 
+// If setting up our patching got put off - see PatchCableSet::setupPatchingLater() - this does it now. Call before
+// anything which needs it, like playing or editing us.
+void Sound::ensurePatchingSetUp(ModelStackWithThreeMainThings* modelStack) {
+	ParamManagerForTimeline* paramManager = (ParamManagerForTimeline*)modelStack->paramManager;
+	if (!paramManager->getPatchCableSet()->patchingNeedsSetup) {
+		return;
+	}
+
+	ModelStackWithParamCollection* modelStackWithParamCollection = paramManager->getPatchCableSet(modelStack);
+	((PatchCableSet*)modelStackWithParamCollection->paramCollection)->setupPatching(modelStackWithParamCollection);
+
+	// Our param values were worked out as if nothing was patched
+	patcher.performInitialPatching(this, paramManager);
+}
+
 void Sound::noteOn(ModelStackWithThreeMainThings* modelStack, ArpeggiatorBase* arpeggiator, int32_t noteCodePreArp,
                    int16_t const* mpeValues, uint32_t sampleSyncLength, int32_t ticksLate, uint32_t samplesLate,
                    int32_t velocity, int32_t fromMIDIChannel) {
 
+	ensurePatchingSetUp(modelStack);
+
 	ParamManagerForTimeline* paramManager = (ParamManagerForTimeline*)modelStack->paramManager;
 
 	ModelStackWithSoundFlags* modelStackWithSoundFlags = modelStack->addSoundFlags();
@@ -1427,6 +1439,8 @@ void Sound::noteOnPostArpeggiator(ModelStackWithSoundFlags* modelStack, int32_t
 
 	Voice* voiceForLegato = NULL;
 
+	Voice* voiceToRetrigger = NULL;
+
 	ParamManagerForTimeline* paramManager = (ParamManagerForTimeline*)modelStack->paramManager;
 
 	// If not polyphonic, stop any notes which are releasing, now
@@ -1469,7 +1483,19 @@ justUnassign:
 						}
 					}
 
-					if (thisVoice->envelopes[0].state != EnvelopeStage::FAST_RELEASE) {
+					// If it's the same note again, playing the very same samples, have the voice restart itself rather
+					// than fast-releasing it and setting up a whole new one alongside it
+					if (!voiceToRetrigger && thisVoice->noteCodeAfterArpeggiation == noteCodePostArp && !samplesLate
+					    && canRetriggerVoiceInPlace(thisVoice, paramManager)) {
+						voiceToRetrigger = thisVoice;
+					}
+
+					// Or if it was waiting to retrigger for an earlier note-on, it can just finish its declick now
+					else if (thisVoice->retriggerPending) {
+						thisVoice->retriggerPending = false;
+					}
+
+					else if (thisVoice->envelopes[0].state != EnvelopeStage::FAST_RELEASE) {
 						bool stillGoing = thisVoice->doFastRelease();
 
 						if (!stillGoing) {
@@ -1488,10 +1514,26 @@ justUnassign:
 	}
 
 	if (polyphonic == PolyphonyMode::LEGATO && voiceForLegato) {
+		if (voiceToRetrigger) {
+			voiceToRetrigger->doFastRelease();
+		}
 		ModelStackWithVoice* modelStackWithVoice = modelStack->addVoice(voiceForLegato);
 		voiceForLegato->changeNoteCode(modelStackWithVoice, noteCodePreArp, noteCodePostArp, fromMIDIChannel,
 		                               mpeValues);
 	}
+
+	else if (voiceToRetrigger) {
+		// Any voice we'd stripped for reuse isn't needed after all
+		if (voiceToReuse) {
+			AudioEngine::unassignVoice(voiceToReuse, this, modelStack);
+		}
+
+		if (sideChainSendLevel != 0) {
+			AudioEngine::registerSideChainHit(sideChainSendLevel);
+		}
+
+		voiceToRetrigger->retriggerAfterDeclick(noteCodePreArp, velocity, fromMIDIChannel, mpeValues);
+	}
 	else {
 
 		Voice* newVoice;
@@ -1545,6 +1587,51 @@ justUnassign:
 	lastNoteCode = noteCodePostArp; // Store for porta. We store that at both note-on and note-off.
 }
 
+// For a note-on we know is coming shortly - see NoteRow::prepareForUpcomingNote(). The Voice itself can't be set up
+// until the note's due, but the samples it'll play can be: this looks up the Range each sample Source will use (which
+// caches it for the note-on) and gets the Cluster after the ones held at its start on its way from the card
+void Sound::prepareForUpcomingNote(ParamManagerForTimeline* paramManager, int32_t noteCode) {
+	if (synthMode == SynthMode::FM) {
+		return;
+	}
+
+	for (int32_t s = 0; s < kNumSources; s++) {
+		Source* source = &sources[s];
+		if (source->oscType != OscType::SAMPLE || !source->ranges.getNumElements()
+		    || !isSourceActiveCurrently(s, paramManager)) {
+			continue;
+		}
+
+		int32_t rangeIndex = source->getRangeIndex(noteCode + transpose);
+		SampleHolder* holder = (SampleHolder*)source->ranges.getElement(rangeIndex)->getAudioFileHolder();
+		holder->prefetchClusterAfterStart(source->sampleControls.reversed);
+	}
+}
+
+// Whether a same-note retrigger can restart this Voice where it is (see Voice::retriggerAfterDeclick()) - that is, if it's
+// sounded already, and every active Source is a sample, not synced to the sequence, still mapped to the very Range the
+// Voice is playing. Caller has already checked that the Sources are all samples.
+bool Sound::canRetriggerVoiceInPlace(Voice* voice, ParamManagerForTimeline* paramManager) {
+	if (!voice->doneFirstRender) {
+		return false;
+	}
+
+	for (int32_t s = 0; s < kNumSources; s++) {
+		if (!isSourceActiveCurrently(s, paramManager)) {
+			continue;
+		}
+		if (sources[s].repeatMode == SampleRepeatMode::STRETCH) {
+			return false;
+		}
+		MultiRange* range = sources[s].getRange(voice->noteCodeAfterArpeggiation + transpose);
+		if (!range || range->getAudioFileHolder() != voice->guides[s].audioFileHolder) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
 void Sound::allNotesOff(ModelStackWithThreeMainThings* modelStack, ArpeggiatorBase* arpeggiator) {
 
 	arpeggiator->reset();
@@ -1571,6 +1658,15 @@ void Sound::noteOffPostArpeggiator(ModelStackWithSoundFlags* modelStack, int32_t
 	AudioEngine::activeVoices.getRangeForSound(this, ends);
 	for (int32_t v = ends[0]; v < ends[1]; v++) {
 		Voice* thisVoice = AudioEngine::activeVoices.getVoice(v);
+
+		// A voice still declicking for a retrigger hasn't started its new note yet - it'll take this note-off when it does
+		if (thisVoice->retriggerPending) {
+			if (thisVoice->noteCodeAfterArpeggiation == noteCode || noteCode == -32768) {
+				thisVoice->retriggerNoteOffReceived = true;
+			}
+			continue;
+		}
+
 		if ((thisVoice->noteCodeAfterArpeggiation == noteCode || noteCode == -32768)
 		    && thisVoice->envelopes[0].state < EnvelopeStage::RELEASE) { // Don't bother if it's already "releasing"
 
@@ -1894,14 +1990,7 @@ doCutModFXTail:
 						goto yupStartSkipping;
 					}
 
-					int32_t waitSamples =
-					    (modFXType == ModFXType::CHORUS || modFXType == ModFXType::CHORUS_STEREO)
-					        ? (20 * 44)
-					        : (90
-					           * 441); // 20 and 900 mS respectively. Lots is required for feeding-back flanger or phaser
-					if (modFXType == ModFXType::GRAIN)
-						waitSamples = 350 * 441;
-					startSkippingRenderingAtTime = AudioEngine::audioSampleTimer + waitSamples;
+					startSkippingRenderingAtTime = AudioEngine::audioSampleTimer + getModFXTailLength(modFXType);
 				}
 
 				// Or if already waiting, see if the wait is over yet
@@ -1955,14 +2044,21 @@ void Sound::getThingWithMostReverb(Sound** soundWithMostReverb, ParamManager** p
 void Sound::notifyValueChangeViaLPF(int32_t p, bool shouldDoParamLPF, ModelStackWithThreeMainThings const* modelStack,
                                     int32_t oldValue, int32_t newValue, bool fromAutomation) {
 
+	int32_t i;
+	for (i = 0; i < numParamLPFs; i++) {
+		if (paramLPFs[i].p == p) {
+			break;
+		}
+	}
+
 	if (skippingRendering) {
 		goto dontDoLPF;
 	}
 
 	if (!shouldDoParamLPF) {
 		// If param LPF was active for this param, stop it
-		if (paramLPF.p == p) {
-			paramLPF.p = PARAM_LPF_OFF;
+		if (i < numParamLPFs) {
+			removeParamLPF(i);
 		}
 		goto dontDoLPF;
 	}
@@ -1970,71 +2066,79 @@ void Sound::notifyValueChangeViaLPF(int32_t p, bool shouldDoParamLPF, ModelStack
 	// If doing param LPF
 	if (paramNeedsLPF(p, fromAutomation)) {
 
-		// If the param LPF was already busy...
-		if (paramLPF.p != PARAM_LPF_OFF) {
-			// If it was a different param, tell it to stop so that we can have it
-			if (paramLPF.p != p) {
-				char modelStackMemory[MODEL_STACK_MAX_SIZE];
-				copyModelStack(modelStackMemory, modelStack, sizeof(ModelStackWithThreeMainThings));
-				ModelStackWithThreeMainThings* modelStackCopy = (ModelStackWithThreeMainThings*)modelStackMemory;
+		// If it was already being smoothed, keep its current state - it's just going somewhere new now
+		if (i < numParamLPFs) {
+			return;
+		}
 
-				stopParamLPF(modelStackCopy->addSoundFlags());
-			}
+		// If they're all busy, the one that's been going longest has to finish right now so we can have it
+		if (numParamLPFs == kNumParamLPFs) {
+			char modelStackMemory[MODEL_STACK_MAX_SIZE];
+			ModelStackWithThreeMainThings* modelStackCopy =
+			    copyModelStack<ModelStackWithThreeMainThings>(modelStackMemory, modelStack);
 
-			// Otherwise, keep its current state, and just tell it it's going somewhere new
-			else {
-				goto changeWhereParamLPFGoing;
-			}
+			stopParamLPF(0, modelStackCopy->addSoundFlags());
 		}
 
-		paramLPF.currentValue = oldValue;
-
-changeWhereParamLPFGoing:
-		paramLPF.p = p;
+		paramLPFs[numParamLPFs].p = p;
+		paramLPFs[numParamLPFs].currentValue = oldValue;
+		numParamLPFs++;
 	}
 
 	// Or if not doing param LPF
 	else {
 dontDoLPF:
 		char modelStackMemory[MODEL_STACK_MAX_SIZE];
-		copyModelStack(modelStackMemory, modelStack, sizeof(ModelStackWithThreeMainThings));
-		ModelStackWithThreeMainThings* modelStackCopy = (ModelStackWithThreeMainThings*)modelStackMemory;
+		ModelStackWithThreeMainThings* modelStackCopy =
+		    copyModelStack<ModelStackWithThreeMainThings>(modelStackMemory, modelStack);
 
 		patchedParamPresetValueChanged(p, modelStackCopy->addSoundFlags(), oldValue, newValue);
 	}
 }
 
+// Each param being smoothed takes one step per render. Those with cables only mark their sources as changed, so
+// however many there are, the Patchers still only run once per render (or control-rate block) for all of them
 void Sound::doParamLPF(int32_t numSamples, ModelStackWithSoundFlags* modelStack) {
-	if (paramLPF.p == PARAM_LPF_OFF) {
-		return;
-	}
+	PatchedParamSet* patchedParams = modelStack->paramManager->getPatchedParamSet();
 
-	int32_t oldValue = paramLPF.currentValue;
+	// Backwards, so stopping one doesn't move any we haven't got to yet
+	for (int32_t i = numParamLPFs - 1; i >= 0; i--) {
+		ParamLPF* paramLPF = &paramLPFs[i];
+		int32_t oldValue = paramLPF->currentValue;
 
-	int32_t diff = (modelStack->paramManager->getPatchedParamSet()->getValue(paramLPF.p) >> 8) - (oldValue >> 8);
+		if (!ParamLPF::step(&paramLPF->currentValue, patchedParams->getValue(paramLPF->p), numSamples)) {
+			stopParamLPF(i, modelStack);
+		}
+		else {
+			patchedParamPresetValueChanged(paramLPF->p, modelStack, oldValue, paramLPF->currentValue);
+		}
+	}
+}
 
-	if (diff == 0) {
-		stopParamLPF(modelStack);
+void Sound::removeParamLPF(int32_t i) {
+	numParamLPFs--;
+	for (; i < numParamLPFs; i++) {
+		paramLPFs[i] = paramLPFs[i + 1];
 	}
-	else {
-		int32_t amountToAdd = diff * numSamples;
-		paramLPF.currentValue += amountToAdd;
-		//patchedParamPresetValueChanged(paramLPF.p, notifySound, oldValue, paramLPF.currentValue);
-		patchedParamPresetValueChanged(paramLPF.p, modelStack, oldValue, paramLPF.currentValue);
+}
+
+// Puts the param straight onto the value it was headed for
+void Sound::stopParamLPF(int32_t i, ModelStackWithSoundFlags* modelStack) {
+	ParamLPF paramLPF = paramLPFs[i];
+
+	// Must do this first, because the below call will involve the Sound calling us back for the current value
+	removeParamLPF(i);
+
+	if (modelStack) {
+		patchedParamPresetValueChanged(paramLPF.p, modelStack, paramLPF.currentValue,
+		                               modelStack->paramManager->getPatchedParamSet()->getValue(paramLPF.p));
 	}
 }
 
 // Unusually, modelStack may be supplied as NULL, because when unassigning all voices e.g. on song swap, we won't have it.
 void Sound::stopParamLPF(ModelStackWithSoundFlags* modelStack) {
-	bool wasActive = paramLPF.p != PARAM_LPF_OFF;
-	if (wasActive) {
-		int32_t p = paramLPF.p;
-		paramLPF.p =
-		    PARAM_LPF_OFF; // Must do this first, because the below call will involve the Sound calling us back for the current value
-		if (modelStack) {
-			patchedParamPresetValueChanged(p, modelStack, paramLPF.currentValue,
-			                               modelStack->paramManager->getPatchedParamSet()->getValue(p));
-		}
+	while (numParamLPFs) {
+		stopParamLPF(numParamLPFs - 1, modelStack);
 	}
 }
 
@@ -2046,6 +2150,10 @@ void Sound::render(ModelStackWithThreeMainThings* modelStack, StereoSample* outp
 		return;
 	}
 
+	Debug::ProfileScope profileScope(Debug::cpuProfiler, Debug::ProfileStage::SOUND_RENDER);
+
+	ensurePatchingSetUp(modelStack);
+
 	ParamManagerForTimeline* paramManager = (ParamManagerForTimeline*)modelStack->paramManager;
 
 	// Do global LFO
@@ -2078,6 +2186,7 @@ void Sound::render(ModelStackWithThreeMainThings* modelStack, StereoSample* outp
 	if (sourcesChanged) {
 		patcher.performPatching(sourcesChanged, this, paramManager);
 	}
+	patcher.performGlobalSourcePatchingForVoices(sourcesChanged, &voiceGlobalSourceCables, paramManager);
 
 	// Setup some reverb-related stuff
 	int32_t reverbSendAmount =
@@ -2087,9 +2196,9 @@ void Sound::render(ModelStackWithThreeMainThings* modelStack, StereoSample* outp
 
 	ModelStackWithSoundFlags* modelStackWithSoundFlags = modelStack->addSoundFlags();
 
-	// Arpeggiator
+	// Arpeggiator - nothing to do, not even working out its rate, if no notes are held
 	ArpeggiatorSettings* arpSettings = getArpSettings();
-	if (arpSettings && arpSettings->mode != ArpMode::OFF) {
+	if (arpSettings && arpSettings->mode != ArpMode::OFF && getArp()->hasAnyInputNotesActive()) {
 
 		UnpatchedParamSet* unpatchedParams = paramManager->getUnpatchedParamSet();
 		uint32_t gateThreshold = (uint32_t)unpatchedParams->getValue(Param::Unpatched::Sound::ARP_GATE) + 2147483648;
@@ -2129,6 +2238,8 @@ void Sound::render(ModelStackWithThreeMainThings* modelStack, StereoSample* outp
 	static int32_t soundBuffer[SSI_TX_BUFFER_NUM_SAMPLES * 2];
 	memset(soundBuffer, 0, (numSamples * sizeof(int32_t)) << renderingInStereo);
 
+	int32_t paraphonicFilterGain = 0;
+
 	if (numVoicesAssigned) {
 
 		// Very often, we'll just apply panning here at the Sound level rather than the Voice level
@@ -2149,12 +2260,28 @@ void Sound::render(ModelStackWithThreeMainThings* modelStack, StereoSample* outp
 		bool doHPF = (thisHasFilters
 		              && (paramManager->getPatchCableSet()->doesParamHaveSomethingPatchedToIt(Param::Local::HPF_FREQ)
 		                  || (hpfFreq != -2147483648) || (hpfMorph > -2147483648)));
+
+		// If paraphonic, the Voices don't filter, and we do it once, after, with the newest Voice's filter params
+		bool paraphonicFilter = paraphonic && (doLPF || doHPF);
+		bool voicesDoLPF = doLPF && !paraphonicFilter;
+		bool voicesDoHPF = doHPF && !paraphonicFilter;
+		Voice* newestVoice = NULL;
+		int32_t paraphonicFilterParams[kNumParaphonicFilterParams];
 		// Each voice will potentially alter the "sources changed" flags, so store a backup to restore between each voice
 		/*
 		bool backedUpSourcesChanged[FIRST_UNCHANGEABLE_SOURCE - Local::FIRST_SOURCE];
 		bool doneFirstVoice = false;
 		*/
 
+		// With a fixed control rate, each voice renders in blocks of that many samples, so its envelopes, LFOs and
+		// patching are worked out afresh for each one and its amplitude increments etc. ramp across each one. The
+		// sizes are multiples of 4, so the oscillator routines, which write whole NEON vectors, can't spill into the
+		// next block
+		int32_t controlBlockSize = runtimeFeatureSettings.get(RuntimeFeatureSettingType::ControlRate);
+		if (!controlBlockSize) {
+			controlBlockSize = numSamples;
+		}
+
 		int32_t ends[2];
 		AudioEngine::activeVoices.getRangeForSound(this, ends);
 		for (int32_t v = ends[0]; v < ends[1]; v++) {
@@ -2171,8 +2298,24 @@ void Sound::render(ModelStackWithThreeMainThings* modelStack, StereoSample* outp
 
 			ModelStackWithVoice* modelStackWithVoice = modelStackWithSoundFlags->addVoice(thisVoice);
 
-			bool stillGoing = thisVoice->render(modelStackWithVoice, soundBuffer, numSamples, renderingInStereo,
-			                                    applyingPanAtVoiceLevel, sourcesChanged, doLPF, doHPF, pitchAdjust);
+			bool stillGoing = true;
+			uint32_t sourcesChangedThisBlock = sourcesChanged;
+			for (int32_t offset = 0; stillGoing && offset < numSamples; offset += controlBlockSize) {
+				int32_t numSamplesThisBlock = std::min(controlBlockSize, numSamples - offset);
+				stillGoing = thisVoice->render(modelStackWithVoice, &soundBuffer[offset << renderingInStereo],
+				                               numSamplesThisBlock, renderingInStereo, applyingPanAtVoiceLevel,
+				                               sourcesChangedThisBlock, voicesDoLPF, voicesDoHPF, pitchAdjust);
+
+				// The Sound-level sources only changed at the start of the window
+				sourcesChangedThisBlock = 0;
+			}
+			if (paraphonicFilter && stillGoing
+			    && (!newestVoice || (int32_t)(thisVoice->orderSounded - newestVoice->orderSounded) > 0)) {
+				newestVoice = thisVoice;
+				for (int32_t p = 0; p < kNumParaphonicFilterParams; p++) {
+					paraphonicFilterParams[p] = thisVoice->paramFinalValues[kParaphonicFilterParams[p]];
+				}
+			}
 			if (!stillGoing) {
 				AudioEngine::activeVoices.checkVoiceExists(thisVoice, this, "E201");
 				AudioEngine::unassignVoice(thisVoice, this, modelStackWithSoundFlags);
@@ -2181,6 +2324,11 @@ void Sound::render(ModelStackWithThreeMainThings* modelStack, StereoSample* outp
 			}
 		}
 
+		if (newestVoice) {
+			paraphonicFilterGain = renderParaphonicFilter(soundBuffer, numSamples, renderingInStereo,
+			                                              paraphonicFilterParams, doLPF, doHPF);
+		}
+
 		// If just rendered in mono, double that up to stereo now
 		if (!renderingInStereo) {
 			// We know that nothing's patched to pan, so can read it in this very basic way.
@@ -2241,6 +2389,9 @@ void Sound::render(ModelStackWithThreeMainThings* modelStack, StereoSample* outp
 	}
 
 	int32_t postFXVolume = paramFinalValues[Param::Global::VOLUME_POST_FX - Param::Global::FIRST];
+	if (paraphonicFilterGain) {
+		postFXVolume = multiply_32x32_rshift32(postFXVolume, paraphonicFilterGain) << 5;
+	}
 	int32_t postReverbVolume = paramFinalValues[Param::Global::VOLUME_POST_REVERB_SEND - Param::Global::FIRST];
 
 	if (postReverbVolumeLastTime == -1) {
@@ -2274,6 +2425,33 @@ void Sound::render(ModelStackWithThreeMainThings* modelStack, StereoSample* outp
 	doParamLPF(numSamples, modelStackWithSoundFlags);
 }
 
+void Sound::setParaphonic(bool newParaphonic) {
+	if (newParaphonic != paraphonic) {
+		paraphonicFilterSet.reset();
+		paraphonic = newParaphonic;
+	}
+}
+
+// Filters all the Voices at once, in paraphonic mode. filterParams are the newest Voice's final values for
+// kParaphonicFilterParams. Returns the filter's gain, with 134217728 being what the Voices already applied themselves
+// with their own filters off, for the caller to apply on top of its post-FX volume
+int32_t Sound::renderParaphonicFilter(int32_t* soundBuffer, int32_t numSamples, bool renderingInStereo,
+                                      int32_t const* filterParams, bool doLPF, bool doHPF) {
+	// The FilterSet always takes off a fixed amount, even with no filters on, and the Voices already had that done
+	// to them, so start from its inverse
+	int32_t gain = paraphonicFilterSet.setConfig(filterParams[0], filterParams[1], doLPF, lpfMode, filterParams[2],
+	                                             filterParams[3], filterParams[4], doHPF, hpfMode, filterParams[5],
+	                                             167575800, filterRoute);
+
+	if (renderingInStereo) {
+		paraphonicFilterSet.renderLongStereo(soundBuffer, soundBuffer + (numSamples << 1));
+	}
+	else {
+		paraphonicFilterSet.renderLong(soundBuffer, soundBuffer + numSamples, numSamples);
+	}
+	return gain;
+}
+
 // This is virtual, and gets extended by drums!
 void Sound::setSkippingRendering(bool newSkipping) {
 	skippingRendering = newSkipping;
@@ -3113,6 +3291,7 @@ int32_t Sound::readSourceFromFile(int32_t s, ParamManagerForTimeline* paramManag
 			}
 
 			storageManager.readTagOrAttributeValueString(&range->getAudioFileHolder()->filePath);
+			range->getAudioFileHolder()->filePath.intern();
 
 			storageManager.exitTag("fileName");
 		}
@@ -3192,6 +3371,7 @@ int32_t Sound::readSourceFromFile(int32_t s, ParamManagerForTimeline* paramManag
 
 						if (!strcmp(tagName, "fileName")) {
 							storageManager.readTagOrAttributeValueString(&holder->filePath);
+							holder->filePath.intern();
 							storageManager.exitTag("fileName");
 						}
 						else if (!strcmp(tagName, "rangeTopNote")) {
@@ -3720,6 +3900,9 @@ void Sound::writeToFile(bool savingSong, ParamManager* paramManager, Arpeggiator
 
 	storageManager.writeAttribute("polyphonic", polyphonyModeToString(polyphonic));
 	storageManager.writeAttribute("voicePriority", util::to_underlying(voicePriority));
+	if (paraphonic) {
+		storageManager.writeAttribute("paraphonic", 1);
+	}
 
 	// Send level
 	if (sideChainSendLevel != 0) {
@@ -19,6 +19,7 @@
 
 #include "definitions_cxx.hpp"
 #include "dsp/compressor/compressor.h"
+#include "dsp/filter/filter_set.h"
 #include "model/mod_controllable/mod_controllable_audio.h"
 #include "modulation/arpeggiator.h"
 #include "modulation/knob.h"
@@ -42,11 +43,23 @@ class ModelStackWithSoundFlags;
 class ModelStackWithVoice;
 class ModelStackWithModControllable;
 
-#define PARAM_LPF_OFF (-1)
+// How many params can be getting smoothed at once - e.g. while several are being automated, or a few knobs turned
+constexpr int32_t kNumParamLPFs = 4;
 
 struct ParamLPF {
-	int32_t p; // PARAM_LPF_OFF means none
+	int32_t p;
 	int32_t currentValue;
+
+	// Moves value towards target, by a straight ramp across numSamples covering a fixed fraction of the way. Returns
+	// false, without moving it, once it's as close as that's going to get it. Also used for Voices' MPE smoothing.
+	static inline bool step(int32_t* value, int32_t target, int32_t numSamples) {
+		int32_t diff = (target >> 8) - (*value >> 8);
+		if (diff == 0) {
+			return false;
+		}
+		*value += diff * numSamples;
+		return true;
+	}
 };
 
 #define NUM_MOD_SOURCE_SELECTION_BUTTONS 2
@@ -62,13 +75,22 @@ struct ParamLPF {
  * or as just a Drum - one of the many items in a Kit, normally associated with a row of notes.
  */
 
+// The params which get set up from the newest Voice, for paraphonic filtering, in the order setConfig() takes them
+constexpr int32_t kNumParaphonicFilterParams = 6;
+constexpr int32_t kParaphonicFilterParams[kNumParaphonicFilterParams] = {
+    Param::Local::LPF_FREQ, Param::Local::LPF_RESONANCE, Param::Local::LPF_MORPH,
+    Param::Local::HPF_FREQ, Param::Local::HPF_RESONANCE, Param::Local::HPF_MORPH,
+};
+
 class Sound : public ModControllableAudio {
 public:
 	Sound();
 
 	Patcher patcher;
 
-	ParamLPF paramLPF;
+	// The params currently being smoothed, oldest first
+	ParamLPF paramLPFs[kNumParamLPFs];
+	int32_t numParamLPFs;
 
 	Source sources[kNumSources];
 
@@ -77,6 +99,7 @@ public:
 	int32_t globalSourceValues[util::to_underlying(kFirstLocalSource)];
 
 	uint32_t sourcesChanged; // Applies from first source up to FIRST_UNCHANGEABLE_SOURCE
+	GlobalSourceCables voiceGlobalSourceCables;
 
 	LFO globalLFO;
 	LFOType lfoGlobalWaveType;
@@ -113,6 +136,12 @@ public:
 
 	bool oscillatorSync;
 
+	// When paraphonic, the Voices leave their filtering to paraphonicFilterSet, which gets run once over all of them
+	// summed, set up from whichever Voice sounded most recently - see renderParaphonicFilter()
+	bool paraphonic;
+	deluge::dsp::filter::FilterSet paraphonicFilterSet;
+	void setParaphonic(bool newParaphonic);
+
 	VoicePriority voicePriority;
 
 	bool skippingRendering;
@@ -167,6 +196,8 @@ public:
 	               uint8_t midiChannel, Song* song) final;
 
 	bool hasFilters();
+	int32_t renderParaphonicFilter(int32_t* soundBuffer, int32_t numSamples, bool renderingInStereo,
+	                               int32_t const* filterParams, bool doLPF, bool doHPF);
 
 	void sampleZoneChanged(MarkerType markerType, int32_t s, ModelStackWithSoundFlags* modelStack);
 	void setNumUnison(int32_t newNum, ModelStackWithSoundFlags* modelStack);
@@ -184,6 +215,7 @@ public:
 	bool isSourceActiveEverDisregardingMissingSample(int32_t s, ParamManager* paramManager);
 	bool isSourceActiveEver(int32_t s, ParamManager* paramManager);
 	bool isNoiseActiveEver(ParamManagerForTimeline* paramManager);
+	void prepareForUpcomingNote(ParamManagerForTimeline* paramManager, int32_t noteCode);
 	void noteOn(ModelStackWithThreeMainThings* modelStack, ArpeggiatorBase* arpeggiator, int32_t noteCode,
 	            int16_t const* mpeValues, uint32_t sampleSyncLength = 0, int32_t ticksLate = 0,
 	            uint32_t samplesLate = 0, int32_t velocity = 64, int32_t fromMIDIChannel = 16);
@@ -226,6 +258,7 @@ public:
 	bool allowsVeryLateNoteStart(InstrumentClip* clip, ParamManagerForTimeline* paramManager);
 	void fastReleaseAllVoices(ModelStackWithSoundFlags* modelStack);
 	void recalculatePatchingToParam(uint8_t p, ParamManagerForTimeline* paramManager);
+	void ensurePatchingSetUp(ModelStackWithThreeMainThings* modelStack);
 	void doneReadingFromFile();
 	virtual void setupPatchingForAllParamManagers(Song* song) {}
 	void compensateVolumeForResonance(ModelStackWithThreeMainThings* modelStack);
@@ -242,12 +275,12 @@ public:
 
 	inline int32_t getSmoothedPatchedParamValue(int32_t p,
 	                                            ParamManager* paramManager) { // Yup, inlining this helped a tiny bit.
-		if (paramLPF.p == p) {
-			return paramLPF.currentValue;
-		}
-		else {
-			return paramManager->getPatchedParamSet()->getValue(p);
+		for (int32_t i = 0; i < numParamLPFs; i++) {
+			if (paramLPFs[i].p == p) {
+				return paramLPFs[i].currentValue;
+			}
 		}
+		return paramManager->getPatchedParamSet()->getValue(p);
 	}
 
 	void notifyValueChangeViaLPF(int32_t p, bool shouldDoParamLPF, ModelStackWithThreeMainThings const* modelStack,
@@ -285,10 +318,13 @@ private:
 	void writeSourceToFile(int32_t s, char const* tagName);
 	int32_t readSourceFromFile(int32_t s, ParamManagerForTimeline* paramManager, int32_t readAutomationUpToPos);
 	void stopSkippingRendering(ArpeggiatorSettings* arpSettings);
+	bool canRetriggerVoiceInPlace(Voice* voice, ParamManagerForTimeline* paramManager);
 	void startSkippingRendering(ModelStackWithSoundFlags* modelStack);
 	void getArpBackInTimeAfterSkippingRendering(ArpeggiatorSettings* arpSettings);
 	void doParamLPF(int32_t numSamples, ModelStackWithSoundFlags* modelStack);
 	void stopParamLPF(ModelStackWithSoundFlags* modelStack);
+	void stopParamLPF(int32_t i, ModelStackWithSoundFlags* modelStack);
+	void removeParamLPF(int32_t i);
 	bool renderingVoicesInStereo(ModelStackWithSoundFlags* modelStack);
 	void setupDefaultExpressionPatching(ParamManager* paramManager);
 	void pushSwitchActionOnEncoderForParam(int32_t p, bool on, ModelStackWithThreeMainThings* modelStack);
@@ -53,6 +53,7 @@ Drum* SoundDrum::clone() {
 bool SoundDrum::readTagFromFile(char const* tagName) {
 	if (!strcmp(tagName, "name")) {
 		storageManager.readTagOrAttributeValueString(&name);
+		name.intern();
 		storageManager.exitTag("name");
 	}
 
@@ -214,7 +214,7 @@ ModControllable* SoundInstrument::toModControllable() {
 	return this;
 }
 
-void SoundInstrument::setupPatching(ModelStackWithTimelineCounter* modelStack) {
+void SoundInstrument::setupPatching(ModelStackWithTimelineCounter* modelStack, bool putOff) {
 
 	InstrumentClip* clip = (InstrumentClip*)modelStack->getTimelineCounterAllowNull();
 	ParamManagerForTimeline* paramManager;
@@ -237,7 +237,12 @@ void SoundInstrument::setupPatching(ModelStackWithTimelineCounter* modelStack) {
 
 	PatchCableSet* patchCableSet = (PatchCableSet*)modelStackWithParamCollection->paramCollection;
 
-	patchCableSet->setupPatching(modelStackWithParamCollection);
+	if (putOff) {
+		patchCableSet->setupPatchingLater(modelStackWithParamCollection);
+	}
+	else {
+		patchCableSet->setupPatching(modelStackWithParamCollection);
+	}
 }
 
 bool SoundInstrument::setActiveClip(ModelStackWithTimelineCounter* modelStack, PgmChangeSend maySendMIDIPGMs) {
@@ -53,7 +53,7 @@ public:
 	ModControllable* toModControllable();
 	bool setActiveClip(ModelStackWithTimelineCounter* modelStack, PgmChangeSend maySendMIDIPGMs);
 	void setupPatchingForAllParamManagers(Song* song);
-	void setupPatching(ModelStackWithTimelineCounter* modelStack);
+	void setupPatching(ModelStackWithTimelineCounter* modelStack, bool putOff = false);
 
 	void deleteBackedUpParamManagers(Song* song);
 	void polyphonicExpressionEventOnChannelOrNote(int32_t newValue, int32_t whichExpressionDimension,
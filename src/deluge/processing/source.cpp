@@ -47,6 +47,7 @@ Source::Source() {
 	timeStretchAmount = 0;
 
 	defaultRangeI = -1;
+	memset(rangeIndexForNote, 0, sizeof(rangeIndexForNote));
 }
 
 Source::~Source() {
@@ -148,10 +149,7 @@ MultiRange* Source::getRange(int32_t note) {
 		return NULL;
 	}
 	else {
-		defaultRangeI = ranges.search(note, GREATER_OR_EQUAL);
-		if (defaultRangeI == ranges.getNumElements()) {
-			defaultRangeI--;
-		}
+		defaultRangeI = searchRangeIndex(note);
 		return ranges.getElement(defaultRangeI);
 	}
 }
@@ -161,11 +159,46 @@ int32_t Source::getRangeIndex(int32_t note) {
 		return 0;
 	}
 	else {
-		int32_t e = ranges.search(note, GREATER_OR_EQUAL);
-		if (e == ranges.getNumElements()) {
-			e--;
+		return searchRangeIndex(note);
+	}
+}
+
+// Only for when there's more than one range. Each range covers the notes from just above the previous one's top note
+// up to its own, and the last one carries on upwards from there
+int32_t Source::searchRangeIndex(int32_t note) {
+	int32_t numRanges = ranges.getNumElements();
+	bool cacheable = (note >= 0 && note < 128 && numRanges <= 256);
+
+	if (cacheable) {
+		int32_t e = rangeIndexForNote[note];
+		if (e < numRanges && (e == numRanges - 1 || ranges.getKeyAtIndex(e) >= note)
+		    && (e == 0 || ranges.getKeyAtIndex(e - 1) < note)) {
+			return e;
+		}
+	}
+
+	int32_t e = ranges.search(note, GREATER_OR_EQUAL);
+	if (e == numRanges) {
+		e--;
+	}
+	if (cacheable) {
+		rangeIndexForNote[note] = e;
+	}
+	return e;
+}
+
+// A note landing in one range makes it fairly likely the next few will land in the ones either side
+void Source::prefetchNeighbouringRanges(int32_t rangeIndex) {
+	if (oscType != OscType::SAMPLE) {
+		return;
+	}
+
+	for (int32_t e = rangeIndex - 1; e <= rangeIndex + 1; e += 2) {
+		if (e < 0 || e >= ranges.getNumElements()) {
+			continue;
 		}
-		return e;
+		SampleHolder* holder = (SampleHolder*)ranges.getElement(e)->getAudioFileHolder();
+		holder->prefetchClusterAfterStart(sampleControls.reversed);
 	}
 }
 
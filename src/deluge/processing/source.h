@@ -49,6 +49,10 @@ public:
 
 	int16_t defaultRangeI; // -1 means none yet
 
+	// Which range each note last resolved to. Checked against the ranges' top notes before use, so it never needs
+	// invalidating when the ranges change - a stale entry just gets searched for again
+	uint8_t rangeIndexForNote[128];
+
 	bool renderInStereo(Sound* s, SampleHolder* sampleHolder = NULL);
 	void setCents(int32_t newCents);
 	void recalculateFineTuner();
@@ -59,6 +63,7 @@ public:
 	int32_t getRangeIndex(int32_t note);
 	MultiRange* getRange(int32_t note);
 	MultiRange* getOrCreateFirstRange();
+	void prefetchNeighbouringRanges(int32_t rangeIndex);
 	bool hasAtLeastOneAudioFileLoaded();
 	void doneReadingFromFile(Sound* sound);
 	bool hasAnyLoopEndPoint();
@@ -66,4 +71,5 @@ public:
 
 private:
 	void destructAllMultiRanges();
+	int32_t searchRangeIndex(int32_t note);
 };
@@ -0,0 +1,159 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "scheduler/task_scheduler.h"
+#include "io/debug/print.h"
+#include "processing/engines/audio_engine.h"
+#include <algorithm>
+
+TaskScheduler taskScheduler{};
+
+bool TaskScheduler::addTask(TaskHandler handler, char const* name, uint8_t priority, uint32_t minInterval,
+                            uint32_t deadline) {
+	if (numTasks >= kMaxNumTasks) {
+		return false;
+	}
+	tasks[numTasks++] = {
+	    .handler = handler,
+	    .name = name,
+	    .priority = priority,
+	    .minInterval = minInterval,
+	    .deadline = deadline,
+	};
+	return true;
+}
+
+bool TaskScheduler::addOneOffTask(TaskHandler handler, char const* name, uint8_t priority, uint32_t delay) {
+	if (numTasks >= kMaxNumTasks) {
+		return false;
+	}
+	// Made to look as if it last ran just now, so it's held back for the delay like any task would be for its interval
+	tasks[numTasks++] = {
+	    .handler = handler,
+	    .name = name,
+	    .priority = priority,
+	    .minInterval = delay,
+	    .deadline = UINT32_MAX,
+	    .lastRunTime = AudioEngine::audioSampleTimer,
+	    .hasRun = true,
+	    .oneOff = true,
+	};
+	return true;
+}
+
+void TaskScheduler::removeTask(int32_t t) {
+	// Keep the rest in order, as that decides between tasks of equal priority
+	for (int32_t i = t; i < numTasks - 1; i++) {
+		tasks[i] = tasks[i + 1];
+	}
+	numTasks--;
+}
+
+TaskScheduler::Task* TaskScheduler::chooseNextTask() {
+	uint32_t timeNow = AudioEngine::audioSampleTimer;
+	Task* best = nullptr;
+	bool bestIsLate = false;
+	uint32_t bestLateness = 0;
+
+	for (int32_t t = 0; t < numTasks; t++) {
+		Task& task = tasks[t];
+		if (task.ranThisPass) {
+			continue;
+		}
+
+		uint32_t timeSinceRun = timeNow - task.lastRunTime;
+		if (task.hasRun && timeSinceRun < task.minInterval) {
+			continue;
+		}
+
+		// The latest of the late tasks goes first, or failing any of those, the highest priority one
+		if (task.hasRun && timeSinceRun > task.deadline) {
+			uint32_t lateness = timeSinceRun - task.deadline;
+			if (!bestIsLate || lateness > bestLateness) {
+				best = &task;
+				bestIsLate = true;
+				bestLateness = lateness;
+			}
+		}
+		else if (!bestIsLate && (!best || task.priority < best->priority)) {
+			best = &task;
+		}
+	}
+	return best;
+}
+
+void TaskScheduler::runTask(Task& task) {
+	uint32_t timeNow = AudioEngine::audioSampleTimer;
+	if (task.hasRun) {
+		uint32_t gap = timeNow - task.lastRunTime;
+		task.longestGap = std::max(task.longestGap, gap);
+		if (gap > task.deadline) {
+			task.numLate++;
+		}
+	}
+	task.lastRunTime = timeNow;
+	task.hasRun = true;
+	task.ranThisPass = true;
+
+	uint32_t startCycles = Debug::readCycleCounter();
+	task.handler();
+	uint32_t cycles = Debug::readCycleCounter() - startCycles;
+
+	task.numRuns++;
+	task.totalCycles += cycles;
+	task.longestCycles = std::max(task.longestCycles, cycles);
+}
+
+void TaskScheduler::run() {
+	while (true) {
+		AudioEngine::routineWithClusterLoading(true); // -----------------------------------
+
+		Task* task = chooseNextTask();
+		if (task) {
+			runTask(*task);
+			if (task->oneOff) {
+				removeTask(task - tasks);
+			}
+		}
+
+		// Nothing left that's due, so that's the end of this pass
+		else {
+			for (int32_t t = 0; t < numTasks; t++) {
+				tasks[t].ranThisPass = false;
+			}
+		}
+	}
+}
+
+void TaskScheduler::dumpStats() {
+	// e.g. "task inputs runs 81234 mean 12 max 1830 late 3 gap 4410", times in microseconds except the gap in samples
+	for (int32_t t = 0; t < numTasks; t++) {
+		Task const& task = tasks[t];
+		Debug::print("task ");
+		Debug::print(task.name);
+		Debug::print(" runs ");
+		Debug::print((int32_t)task.numRuns);
+		Debug::print(" mean ");
+		Debug::print(task.numRuns ? (int32_t)(task.totalCycles / task.numRuns / Debug::uS) : 0);
+		Debug::print(" max ");
+		Debug::print((int32_t)(task.longestCycles / Debug::uS));
+		Debug::print(" late ");
+		Debug::print((int32_t)task.numLate);
+		Debug::print(" gap ");
+		Debug::println((int32_t)task.longestGap);
+	}
+}
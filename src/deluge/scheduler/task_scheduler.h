@@ -0,0 +1,87 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "definitions_cxx.hpp"
+#include <cstdint>
+
+/*
+ * The main loop, as a list of tasks rather than a fixed sequence of calls. The audio routine, the one thing with a hard
+ * deadline, isn't a task - it gets called between every task, whatever they are. Then in each pass of the loop, every
+ * task that's due runs once, in priority order, except that one which has been kept waiting past its deadline jumps the
+ * queue. Each task's run times, and how often and how badly it's missed its deadline, are kept track of, for dumping
+ * with debug sysex command 8.
+ *
+ * This is purely cooperative - a task runs until it returns. Anything which waits on the card still gets the audio
+ * routine and some of the UI called from within that wait by routineForSD(), which has its own lock against re-entry.
+ */
+
+using TaskHandler = void (*)();
+
+constexpr int32_t kMaxNumTasks = 24;
+
+constexpr uint32_t msToSamples(uint32_t ms) {
+	return ms * kSampleRate / 1000;
+}
+
+class TaskScheduler {
+public:
+	/// Lower priority numbers run first. A task won't be run again until minInterval samples after it last was, and if
+	/// it's been left for longer than deadline samples, it's late and goes ahead of everything else. Returns false if
+	/// there's no room for it
+	bool addTask(TaskHandler handler, char const* name, uint8_t priority, uint32_t minInterval, uint32_t deadline);
+
+	/// A task which only runs the once, delay samples from now or as soon after as its priority lets it, then goes away.
+	/// For things which needn't hold up startup. Returns false if there's no room for it
+	bool addOneOffTask(TaskHandler handler, char const* name, uint8_t priority, uint32_t delay);
+
+	/// Runs the main loop. Never returns
+	[[noreturn]] void run();
+
+	/// Prints each task's run count, mean and longest run time, and how many times it was late
+	void dumpStats();
+
+private:
+	struct Task {
+		TaskHandler handler;
+		char const* name;
+		uint8_t priority;
+		uint32_t minInterval;
+		uint32_t deadline;
+
+		uint32_t lastRunTime;
+		bool hasRun;
+		bool ranThisPass;
+		bool oneOff;
+
+		uint32_t numRuns;
+		uint32_t numLate;
+		uint32_t longestGap;    // In samples, between the starts of two runs
+		uint32_t longestCycles; // Run time
+		uint64_t totalCycles;
+	};
+
+	Task* chooseNextTask();
+	void runTask(Task& task);
+	void removeTask(int32_t t);
+
+	Task tasks[kMaxNumTasks];
+	int32_t numTasks = 0;
+};
+
+extern TaskScheduler taskScheduler;
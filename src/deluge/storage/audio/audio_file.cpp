@@ -23,6 +23,8 @@
 #include "model/sample/sample.h"
 #include "storage/audio/audio_file_manager.h"
 #include "storage/audio/audio_file_reader.h"
+#include "storage/folder_index.h"
+#include "storage/storage_manager.h"
 #include "storage/wave_table/wave_table.h"
 #include "util/functions.h"
 #include <string.h>
@@ -259,6 +261,24 @@ doSetupWaveTable:
 				break;
 			}
 
+			// Our own recordings' normalisation, which SampleRecorder leaves to be done as each Cluster loads rather than
+			// rewriting the whole file - "dlgn"
+			case charsToIntegerConstant('d', 'l', 'g', 'n'): {
+				if (type == AudioFileType::SAMPLE && byteDepth == 3 && rawDataFormat == RAW_DATA_FINE) {
+					uint32_t lshiftAmount;
+					error = reader->readBytes((char*)&lshiftAmount, 4);
+					if (error) {
+						break;
+					}
+
+					if (lshiftAmount && lshiftAmount < 24) {
+						((Sample*)this)->rawDataFormat = RAW_DATA_LSHIFTED_24;
+						((Sample*)this)->rawDataLShift = lshiftAmount;
+					}
+				}
+				break;
+			}
+
 			// Serum wavetable chunk - "clm "
 			case charsToIntegerConstant('c', 'l', 'm', ' '): {
 				char data[7];
@@ -549,3 +569,169 @@ void AudioFile::steal(char const* errorCode) {
 int32_t AudioFile::getAppropriateQueue() {
 	return STEALABLE_QUEUE_NO_SONG_AUDIO_FILE_OBJECTS;
 }
+
+// Sidecar files - perc caches, peak pyramids and the like - live next to their AudioFile, named "." + its filename + an
+// extension. Layout, all little-endian:
+//   header: magic, uint16 version, uint16 AudioFile's file date, uint16 its file time, uint16 reserved,
+//           uint32 its file size, uint32 number of data bytes
+//   then the data
+constexpr int32_t kSidecarFileHeaderSize = 20;
+
+int32_t AudioFile::getSidecarFilePath(String* sidecarFilePath, char const* extension) {
+	char const* path = filePath.get();
+	char const* slashPos = strrchr(path, '/');
+	if (!slashPos) {
+		return ERROR_UNSPECIFIED;
+	}
+
+	int32_t error = sidecarFilePath->set(path, slashPos + 1 - path);
+	if (error) {
+		return error;
+	}
+	error = sidecarFilePath->concatenate(".");
+	if (error) {
+		return error;
+	}
+	error = sidecarFilePath->concatenate(slashPos + 1);
+	if (error) {
+		return error;
+	}
+	return sidecarFilePath->concatenate(extension);
+}
+
+// Returns whether there was a file which was still valid for this AudioFile, and its contents are now in data
+bool AudioFile::readSidecarFile(char const* sidecarFilePath, uint32_t magic, uint16_t version, uint8_t* data,
+                                int32_t dataSize) {
+	FIL file;
+	if (!openSidecarFile(&file, sidecarFilePath, magic, version, dataSize)) {
+		return false;
+	}
+
+	bool success = readSidecarData(&file, data, dataSize);
+	f_close(&file);
+	if (success) {
+		Debug::print("loaded from card: ");
+		Debug::println(sidecarFilePath);
+	}
+	return success;
+}
+
+// If this fails, e.g. because the card is write-protected, that's fine - the work just gets done again next time
+void AudioFile::writeSidecarFile(char const* sidecarFilePath, uint32_t magic, uint16_t version, uint8_t const* data,
+                                 int32_t dataSize) {
+	FIL file;
+	if (createSidecarFile(&file, sidecarFilePath, magic, version, dataSize)) {
+		finishWritingSidecarFile(&file, sidecarFilePath, writeSidecarData(&file, data, dataSize));
+	}
+}
+
+// Returns whether there's a file which is still valid for this AudioFile, left open and ready for its data to be read.
+// The caller closes it
+bool AudioFile::openSidecarFile(FIL* file, char const* sidecarFilePath, uint32_t magic, uint16_t version,
+                                int32_t dataSize) {
+	FRESULT result = f_stat(filePath.get(), &staticFNO);
+	if (result != FR_OK) {
+		return false;
+	}
+
+	result = f_open(file, sidecarFilePath, FA_READ);
+	if (result != FR_OK) {
+		return false;
+	}
+
+	char* buffer = storageManager.fileClusterBuffer;
+	UINT bytesRead;
+	result = f_read(file, buffer, kSidecarFileHeaderSize, &bytesRead);
+	if (result == FR_OK && bytesRead == kSidecarFileHeaderSize) {
+		uint32_t storedMagic, fileSize, storedDataSize;
+		uint16_t storedVersion, date, time;
+		memcpy(&storedMagic, &buffer[0], 4);
+		memcpy(&storedVersion, &buffer[4], 2);
+		memcpy(&date, &buffer[6], 2);
+		memcpy(&time, &buffer[8], 2);
+		memcpy(&fileSize, &buffer[12], 4);
+		memcpy(&storedDataSize, &buffer[16], 4);
+		if (storedMagic == magic && storedVersion == version && date == staticFNO.fdate && time == staticFNO.ftime
+		    && fileSize == staticFNO.fsize && storedDataSize == (uint32_t)dataSize) {
+			return true;
+		}
+	}
+
+	f_close(file);
+	return false;
+}
+
+bool AudioFile::readSidecarData(FIL* file, uint8_t* data, int32_t dataSize) {
+	char* buffer = storageManager.fileClusterBuffer;
+	for (int32_t bytesDone = 0; bytesDone < dataSize;) {
+		int32_t bytesNow = std::min<int32_t>(dataSize - bytesDone, audioFileManager.clusterSize);
+		UINT bytesRead;
+		FRESULT result = f_read(file, buffer, bytesNow, &bytesRead);
+		if (result != FR_OK || bytesRead != bytesNow) {
+			return false;
+		}
+		memcpy(&data[bytesDone], buffer, bytesNow);
+		bytesDone += bytesNow;
+	}
+	return true;
+}
+
+// Returns whether it's now open, with its header written, for the data to be written with writeSidecarData(). The
+// caller finishes with finishWritingSidecarFile()
+bool AudioFile::createSidecarFile(FIL* file, char const* sidecarFilePath, uint32_t magic, uint16_t version,
+                                  int32_t dataSize) {
+	FRESULT result = f_stat(filePath.get(), &staticFNO);
+	if (result != FR_OK) {
+		return false;
+	}
+
+	result = f_open(file, sidecarFilePath, FA_CREATE_ALWAYS | FA_WRITE);
+	if (result != FR_OK) {
+		return false;
+	}
+	FolderIndex::folderChanged(sidecarFilePath);
+
+	char* buffer = storageManager.fileClusterBuffer;
+	uint16_t reserved = 0;
+	uint32_t fileSize = staticFNO.fsize;
+	uint32_t storedDataSize = dataSize;
+	memcpy(&buffer[0], &magic, 4);
+	memcpy(&buffer[4], &version, 2);
+	memcpy(&buffer[6], &staticFNO.fdate, 2);
+	memcpy(&buffer[8], &staticFNO.ftime, 2);
+	memcpy(&buffer[10], &reserved, 2);
+	memcpy(&buffer[12], &fileSize, 4);
+	memcpy(&buffer[16], &storedDataSize, 4);
+
+	UINT bytesWritten;
+	result = f_write(file, buffer, kSidecarFileHeaderSize, &bytesWritten);
+	if (result != FR_OK || bytesWritten != kSidecarFileHeaderSize) {
+		finishWritingSidecarFile(file, sidecarFilePath, false);
+		return false;
+	}
+	return true;
+}
+
+bool AudioFile::writeSidecarData(FIL* file, uint8_t const* data, int32_t dataSize) {
+	char* buffer = storageManager.fileClusterBuffer;
+	for (int32_t bytesDone = 0; bytesDone < dataSize;) {
+		int32_t bytesNow = std::min<int32_t>(dataSize - bytesDone, audioFileManager.clusterSize);
+		memcpy(buffer, &data[bytesDone], bytesNow);
+		UINT bytesWritten;
+		FRESULT result = f_write(file, buffer, bytesNow, &bytesWritten);
+		if (result != FR_OK || bytesWritten != bytesNow) {
+			return false;
+		}
+		bytesDone += bytesNow;
+	}
+	return true;
+}
+
+void AudioFile::finishWritingSidecarFile(FIL* file, char const* sidecarFilePath, bool succeeded) {
+	if (f_close(file) != FR_OK) {
+		succeeded = false;
+	}
+	if (!succeeded) {
+		f_unlink(sidecarFilePath); // Don't leave a half-written one
+	}
+}
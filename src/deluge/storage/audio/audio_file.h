@@ -18,6 +18,7 @@
 #pragma once
 
 #include "definitions_cxx.hpp"
+#include "fatfs/ff.h"
 #include "memory/stealable.h"
 #include "util/d_string.h"
 
@@ -50,4 +51,16 @@ public:
 protected:
 	virtual void numReasonsIncreasedFromZero() {}
 	virtual void numReasonsDecreasedToZero(char const* errorCode) {}
+
+	int32_t getSidecarFilePath(String* sidecarFilePath, char const* extension);
+	bool readSidecarFile(char const* sidecarFilePath, uint32_t magic, uint16_t version, uint8_t* data, int32_t dataSize);
+	void writeSidecarFile(char const* sidecarFilePath, uint32_t magic, uint16_t version, uint8_t const* data,
+	                      int32_t dataSize);
+
+	// For data that isn't all in one place - it's read and written in as many pieces as suits, between these
+	bool openSidecarFile(FIL* file, char const* sidecarFilePath, uint32_t magic, uint16_t version, int32_t dataSize);
+	bool readSidecarData(FIL* file, uint8_t* data, int32_t dataSize);
+	bool createSidecarFile(FIL* file, char const* sidecarFilePath, uint32_t magic, uint16_t version, int32_t dataSize);
+	bool writeSidecarData(FIL* file, uint8_t const* data, int32_t dataSize);
+	void finishWritingSidecarFile(FIL* file, char const* sidecarFilePath, bool succeeded);
 };
@@ -20,10 +20,12 @@
 #include "extern.h"
 #include "gui/l10n/l10n.h"
 #include "hid/display/display.h"
+#include "io/debug/event_trace.h"
 #include "io/debug/print.h"
 #include "io/midi/midi_device_manager.h"
 #include "memory/general_memory_allocator.h"
 #include "model/action/action_logger.h"
+#include "model/settings/runtime_feature_settings.h"
 #include "model/sample/sample.h"
 #include "model/sample/sample_cache.h"
 #include "model/sample/sample_reader.h"
@@ -36,6 +38,8 @@
 #include "storage/wave_table/wave_table_reader.h"
 #include "util/functions.h"
 #include "util/misc.h"
+#include "util/pack.h"
+#include "util/sample_codec.h"
 #include <new>
 #include <string.h>
 
@@ -53,6 +57,8 @@ LBA_t clst2sect(           /* !=0:Sector number, 0:Failed (invalid cluster#) */
 );
 
 DRESULT disk_read_without_streaming_first(BYTE pdrv, BYTE* buff, DWORD sector, UINT count);
+DRESULT disk_read_scattered_without_streaming_first(BYTE pdrv, BYTE* const* buffs, UINT sectorsPerBuff, DWORD sector,
+                                                    UINT count);
 
 extern uint8_t currentlyAccessingCard;
 }
@@ -61,7 +67,13 @@ char const* const audioRecordingFolderNames[] = {"SAMPLES/CLIPS", "SAMPLES/RECOR
 
 AudioFileManager audioFileManager{};
 
-AudioFileManager::AudioFileManager() {
+struct SampleContentElement {
+	uint32_t fileSize;
+	uint32_t firstClusterCRC;
+	Sample* sample;
+};
+
+AudioFileManager::AudioFileManager() : samplesByContent(sizeof(SampleContentElement), 2) {
 	cardDisabled = false;
 	alternateLoadDirStatus = AlternateLoadDirStatus::NONE_SET;
 	thingTypeBeingLoaded = ThingType::NONE;
@@ -75,6 +87,20 @@ AudioFileManager::AudioFileManager() {
 void AudioFileManager::init() {
 
 	clusterBeingLoaded = NULL;
+	numClustersLoadingAlongside = 0;
+	numSamplesAwaitingPercCacheAnalysis = 0;
+	numSamplesAwaitingPeakPyramidBuild = 0;
+	numSampleCachesAwaitingCardAccess = 0;
+	numSamplesAwaitingTranscode = 0;
+	numPrefetchingClusters = 0;
+	numClustersReleasedInBatch = 0;
+	batchingReasons = false;
+	compressedBlockBuffer = NULL;
+	averageClusterLoadCycles = 2 * Debug::mS; // Just a starting guess, til we've measured some
+
+	GeneralMemoryAllocator::get().registerRelocatable(&relocatableAudioFiles);
+	GeneralMemoryAllocator::get().registerRelocatable(&relocatableSamplesByContent);
+	longestClusterLoadCycles = 0;
 
 	int32_t error = storageManager.initSD();
 	if (!error) {
@@ -95,8 +121,10 @@ void AudioFileManager::init() {
 
 	clusterSizeAtBoot = clusterSize;
 
-	void* temp = GeneralMemoryAllocator::get().alloc(clusterSizeAtBoot + CACHE_LINE_SIZE * 2, NULL, false, false);
+	// Two Clusters' worth, so while writing a file one can be filled while the other is flushed to the card
+	void* temp = GeneralMemoryAllocator::get().alloc(clusterSizeAtBoot * 2 + CACHE_LINE_SIZE * 2, NULL, false, false);
 	storageManager.fileClusterBuffer = (char*)temp + CACHE_LINE_SIZE;
+	storageManager.fileFlushBuffer = storageManager.fileClusterBuffer + clusterSizeAtBoot;
 
 	clusterObjectSize = sizeof(Cluster) + clusterSize;
 }
@@ -180,6 +208,18 @@ clusterSizeChangedButItsOk:
 						filePath = thisAudioFile->filePath.get();
 					}
 
+					// If it was loaded from its transcode, that's what has to be unchanged. And if the original's
+					// changed since, its transcode won't be found any more, which is just as it should be
+					char transcodeFilePath[kTranscodeFilePathMaxLength];
+					if (((Sample*)thisAudioFile)->loadedFromTranscode) {
+						if (!getTranscodeFilePath(filePath, transcodeFilePath,
+						                          ((Sample*)thisAudioFile)->compressedBlocks)) {
+							((Sample*)thisAudioFile)->markAsUnloadable();
+							continue;
+						}
+						filePath = transcodeFilePath;
+					}
+
 					FRESULT result = f_open(&fileSystemStuff.currentFile, filePath, FA_READ);
 					if (result != FR_OK) {
 						Debug::println("couldn't open file");
@@ -363,6 +403,16 @@ bool AudioFileManager::tryToDeleteAudioFileFromMemoryIfItExists(char const* file
 	return true; // We're fine - it got deleted
 }
 
+uint32_t AudioFileManager::getRAMSpareFromCurrentSong() {
+	MemoryRegionTelemetry telemetry;
+	GeneralMemoryAllocator::get().regions[MEMORY_REGION_SDRAM].getTelemetry(&telemetry);
+	uint32_t spare = telemetry.freeBytes;
+	for (int32_t q = 0; q < STEALABLE_QUEUE_CURRENT_SONG_SAMPLE_DATA; q++) {
+		spare += telemetry.stealableBytes[q];
+	}
+	return spare;
+}
+
 void AudioFileManager::deleteUnusedAudioFileFromMemoryIndexUnknown(AudioFile* audioFile) {
 	int32_t i = audioFiles.searchForExactObject(audioFile);
 	if (i < 0) {
@@ -437,7 +487,8 @@ int32_t AudioFileManager::setupAlternateAudioFilePath(String* newPath, int32_t d
 
 AudioFile* AudioFileManager::getAudioFileFromFilename(String* filePath, bool mayReadCard, uint8_t* error,
                                                       FilePointer* suppliedFilePointer, AudioFileType type,
-                                                      bool makeWaveTableWorkAtAllCosts) {
+                                                      bool makeWaveTableWorkAtAllCosts,
+                                                      bool mayShareSampleWithSameContent) {
 
 	*error = NO_ERROR;
 
@@ -710,6 +761,32 @@ notFound:
 		}
 	}
 
+	// If a file's been compressed before, load that in its place. Or if a file in a non-native format has been
+	// transcoded before, load that - it's a WAV file like any other, just one needing no conversion as each Cluster
+	// loads. Only done for files at their regular path though
+	bool loadingTranscode = false;
+	bool loadingCompressed = false;
+	CompressedSampleHeader compressedHeader;
+	char compressedFilePath[kTranscodeFilePathMaxLength];
+	if (type == AudioFileType::SAMPLE && usingAlternateLocation.isEmpty() && isCompressionEnabled()
+	    && getTranscodeFilePath(filePath->get(), compressedFilePath, true)
+	    && readCompressedHeader(compressedFilePath, &compressedHeader, &effectiveFilePointer)) {
+		loadingTranscode = true;
+		loadingCompressed = true;
+	}
+	else if (usingAlternateLocation.isEmpty() && isTranscodingEnabled()) {
+		char transcodeFilePath[kTranscodeFilePathMaxLength];
+		if (getTranscodeFilePath(filePath->get(), transcodeFilePath)) {
+			FIL transcodeFile;
+			if (f_open(&transcodeFile, transcodeFilePath, FA_READ) == FR_OK) {
+				effectiveFilePointer.sclust = transcodeFile.obj.sclust;
+				effectiveFilePointer.objsize = transcodeFile.obj.objsize;
+				f_close(&transcodeFile);
+				loadingTranscode = true;
+			}
+		}
+	}
+
 	// 0-byte files not allowed.
 	if (!effectiveFilePointer.objsize) {
 		*error = ERROR_FILE_CORRUPTED;
@@ -724,7 +801,11 @@ cantLoadFile:
 		goto cantLoadFile;
 	}
 
-	uint32_t numClusters = ((effectiveFilePointer.objsize - 1) >> clusterSizeMagnitude) + 1;
+	// A compressed transcode's Clusters are those of the file it was made from
+	uint32_t fileSize = loadingCompressed
+	                        ? compressedHeader.audioDataStartPosBytes + compressedHeader.audioDataLengthBytes
+	                        : effectiveFilePointer.objsize;
+	uint32_t numClusters = ((fileSize - 1) >> clusterSizeMagnitude) + 1;
 
 	int32_t memorySizeNeeded = (type == AudioFileType::SAMPLE) ? sizeof(Sample) : sizeof(WaveTable);
 
@@ -759,6 +840,7 @@ ramError:
 	}
 
 	audioFile->filePath.set(filePath);
+	audioFile->filePath.intern();
 	audioFile->loadedFromAlternatePath.set(&usingAlternateLocation);
 
 	reader->currentClusterIndex = -1;
@@ -766,10 +848,20 @@ ramError:
 	reader->fileSize = effectiveFilePointer.objsize;
 	reader->byteIndexWithinCluster = clusterSize;
 
+	// A compressed transcode has no RIFF headers to read - it's all in the one we've already got
+	if (loadingCompressed) {
+		((SampleReader*)reader)->currentCluster = NULL;
+		*error = setUpCompressedSample((Sample*)audioFile, &compressedHeader, compressedFilePath,
+		                               effectiveFilePointer.sclust);
+		goto ensureSafeThenCheckError;
+	}
+
 	// If Sample, we go directly to god-mode and get the cluster addresses.
 	if (type == AudioFileType::SAMPLE) {
 
-		// Store the address of each of the file's clusters.
+		// Store the address of each of the file's clusters. This is our equivalent of FatFS's "fast seek" cluster link
+		// map, only with one entry per cluster rather than per run: it's walked just this once, and from then on
+		// loadCluster() can go straight to any cluster's sectors no matter how far into the file it is.
 		uint32_t currentClusterIndex = 0;
 		uint32_t currentSDCluster =
 		    effectiveFilePointer.sclust; // Start with first cluster, whose address we already got.
@@ -786,11 +878,22 @@ ramError:
 
 			currentSDCluster = get_fat_from_fs(&fileSystemStuff.fileSystem, currentSDCluster);
 
-			if (currentSDCluster == 0xFFFFFFFF || currentSDCluster < 2) {
+			// If the chain stops short of the file's length, the remaining clusters would be left with a sector address
+			// of 0, and loading them later would read whatever's at the start of the card as audio. So don't load it.
+			if (currentSDCluster == 0xFFFFFFFF) {
+				*error = ERROR_SD_CARD;
+				break;
+			}
+			if (currentSDCluster < 2 || currentSDCluster >= fileSystemStuff.fileSystem.n_fatent) {
+				*error = ERROR_FILE_CORRUPTED;
 				break;
 			}
 		}
 
+		if (*error) {
+			goto audioFileError;
+		}
+
 		//if (!suppliedFilePointer) f_close(&fileSystemStuff.currentFile);
 
 		((SampleReader*)reader)->currentCluster = NULL;
@@ -838,18 +941,287 @@ audioFileError:
 		return NULL;
 	}
 
+	// If the very same file's already loaded from another path, use that instead. Done before finalizeAfterLoad(), so
+	// the first Cluster's CRC is always of its data as it was before any conversion
+	if (type == AudioFileType::SAMPLE && mayShareSampleWithSameContent) {
+		Sample* sameSample = findSampleWithSameContent((Sample*)audioFile, fileSize);
+		if (sameSample) {
+			audioFile->~AudioFile();
+			delugeDealloc(audioFileMemory);
+			return sameSample;
+		}
+	}
+
 	*error = audioFiles.insertElement(audioFile);
 	if (*error) {
 		goto audioFileError;
 	}
 
-	audioFile->finalizeAfterLoad(effectiveFilePointer.objsize);
+	if (type == AudioFileType::SAMPLE && ((Sample*)audioFile)->contentFileSize) {
+		addSampleToContentIndex((Sample*)audioFile);
+	}
+
+	audioFile->finalizeAfterLoad(fileSize);
+
+	if (type == AudioFileType::SAMPLE) {
+		Sample* sample = (Sample*)audioFile;
+		sample->loadedFromTranscode = loadingTranscode;
+
+		// Otherwise, have it compressed - or if it wasn't native, transcoded - in the background, ready for the next
+		// time it loads
+		if (!loadingCompressed && usingAlternateLocation.isEmpty()
+		    && ((isCompressionEnabled() && sample->mayBeCompressed())
+		        || (sample->rawDataFormat && !loadingTranscode && isTranscodingEnabled()))) {
+			sample->transcodeRequested = requestTranscode(sample);
+		}
+	}
 
 	audioFile->removeReason("E399");
 
 	return audioFile;
 }
 
+// Reads the header of a compressed transcode, if there's one at filePath that's any use on this card, and gets
+// filePointer pointing at its file. Returns false if not
+bool AudioFileManager::readCompressedHeader(char const* filePath, CompressedSampleHeader* header,
+                                            FilePointer* filePointer) {
+	FIL file;
+	if (f_open(&file, filePath, FA_READ) != FR_OK) {
+		return false;
+	}
+	UINT bytesRead;
+	FRESULT result = f_read(&file, header, sizeof(CompressedSampleHeader), &bytesRead);
+	f_close(&file);
+
+	if (result != FR_OK || bytesRead != sizeof(CompressedSampleHeader) || header->magic != kCompressedSampleMagic
+	    || header->version != kCompressedSampleVersion || header->clusterSize != clusterSize
+	    || (header->numChannels != 1 && header->numChannels != 2) || header->byteDepth < 2 || header->byteDepth > 3
+	    || !header->audioDataLengthBytes
+	    || header->numBlocks
+	           != ((header->audioDataStartPosBytes + header->audioDataLengthBytes - 1) >> clusterSizeMagnitude) + 1) {
+		return false;
+	}
+
+	// Blocks get decoded from here. If there's no room for it, the file it was made from will just have to do
+	if (!compressedBlockBuffer) {
+		compressedBlockBuffer = (uint8_t*)GeneralMemoryAllocator::get().alloc(clusterSizeAtBoot, NULL, false, true);
+		if (!compressedBlockBuffer) {
+			return false;
+		}
+	}
+
+	filePointer->sclust = file.obj.sclust;
+	filePointer->objsize = file.obj.objsize;
+	return true;
+}
+
+// Sets up a Sample from a compressed transcode's header, in place of the RIFF headers of the file it was made from,
+// and works out where on the card each of its Clusters' blocks is. Returns error
+int32_t AudioFileManager::setUpCompressedSample(Sample* sample, CompressedSampleHeader* header,
+                                                char const* compressedFilePath, uint32_t firstSDCluster) {
+	sample->numChannels = header->numChannels;
+	sample->byteDepth = header->byteDepth;
+	sample->sampleRate = header->sampleRate;
+	sample->audioDataStartPosBytes = header->audioDataStartPosBytes;
+	sample->audioDataLengthBytes = header->audioDataLengthBytes;
+	sample->fileLoopStartSamples = header->fileLoopStartSamples;
+	sample->fileLoopEndSamples = header->fileLoopEndSamples;
+	sample->midiNoteFromFile = header->midiNoteFromFile;
+	sample->waveTableCycleSize = header->waveTableCycleSize;
+	sample->fileExplicitlySpecifiesSelfAsWaveTable = header->fileExplicitlySpecifiesSelfAsWaveTable;
+	if (header->rawDataLShift) {
+		sample->rawDataFormat = RAW_DATA_LSHIFTED_24;
+		sample->rawDataLShift = header->rawDataLShift;
+	}
+
+	// Just for checking the file's still the same after the card's been out - see cardReinserted()
+	sample->clusters.getElement(0)->sdAddress = clst2sect(&fileSystemStuff.fileSystem, firstSDCluster);
+
+	int32_t numBlocks = header->numBlocks;
+	sample->compressedBlocks =
+	    (CompressedBlock*)GeneralMemoryAllocator::get().alloc(numBlocks * sizeof(CompressedBlock), NULL, false, true);
+	if (!sample->compressedBlocks) {
+		return ERROR_INSUFFICIENT_RAM;
+	}
+
+	FIL file;
+	if (f_open(&file, compressedFilePath, FA_READ) != FR_OK) {
+		return ERROR_FILE_UNREADABLE;
+	}
+
+	int32_t error = NO_ERROR;
+	uint32_t sectorsPerCluster = clusterSize >> 9;
+	uint32_t sdCluster = firstSDCluster;
+	uint32_t fileClusterIndex = 0;
+	uint32_t prevEndSector = 0;
+
+	// Each block's table entry, and the one after it, where it ends. Read a bit at a time
+	uint32_t entries[64];
+	int32_t numEntriesRead = 0;
+	int32_t entryIndex = 0;
+	uint32_t entry = 0;
+
+	// Moves on to the file's next cluster on the card
+	auto nextSDCluster = [&]() {
+		sdCluster = get_fat_from_fs(&fileSystemStuff.fileSystem, sdCluster);
+		fileClusterIndex++;
+		if (sdCluster == 0xFFFFFFFF) {
+			error = ERROR_SD_CARD;
+		}
+		else if (sdCluster < 2 || sdCluster >= fileSystemStuff.fileSystem.n_fatent) {
+			error = ERROR_FILE_CORRUPTED;
+		}
+	};
+
+	for (int32_t b = -1; b < numBlocks; b++) {
+		if (entryIndex == numEntriesRead) {
+			UINT numBytes = std::min<int32_t>(numBlocks - b, 64) * sizeof(uint32_t);
+			UINT bytesRead;
+			if (f_read(&file, entries, numBytes, &bytesRead) != FR_OK || bytesRead != numBytes) {
+				error = ERROR_FILE_UNREADABLE;
+				break;
+			}
+			numEntriesRead = numBytes / sizeof(uint32_t);
+			entryIndex = 0;
+		}
+		uint32_t prevEntry = entry;
+		entry = entries[entryIndex++];
+		if (b < 0) {
+			continue;
+		}
+
+		// Blocks come one after the other, and none's bigger than a Cluster
+		uint32_t startSector = prevEntry & ~kCompressedBlockVerbatim;
+		uint32_t endSector = entry & ~kCompressedBlockVerbatim;
+		if (startSector < prevEndSector || endSector <= startSector || endSector - startSector > sectorsPerCluster
+		    || ((uint64_t)endSector << 9) > file.obj.objsize) {
+			error = ERROR_FILE_CORRUPTED;
+			break;
+		}
+		prevEndSector = endSector;
+
+		while (fileClusterIndex < startSector / sectorsPerCluster && !error) {
+			nextSDCluster();
+		}
+		if (error) {
+			break;
+		}
+
+		CompressedBlock* block = &sample->compressedBlocks[b];
+		uint32_t sectorWithinCluster = startSector & (sectorsPerCluster - 1);
+		block->sdAddress = clst2sect(&fileSystemStuff.fileSystem, sdCluster) + sectorWithinCluster;
+		block->numSectors = endSector - startSector;
+		block->numSectorsBeforeBreak = std::min<uint32_t>(block->numSectors, sectorsPerCluster - sectorWithinCluster);
+		block->sdAddressAfterBreak = 0;
+		block->verbatim = prevEntry & kCompressedBlockVerbatim;
+
+		if (block->numSectorsBeforeBreak < block->numSectors) {
+			nextSDCluster();
+			if (error) {
+				break;
+			}
+			block->sdAddressAfterBreak = clst2sect(&fileSystemStuff.fileSystem, sdCluster);
+		}
+	}
+
+	f_close(&file);
+	return error;
+}
+
+// CRC of all of the file that's in one of a Sample's Clusters, loading it if need be. Returns false if it couldn't be
+static bool getClusterCRC(Sample* sample, int32_t clusterIndex, uint32_t* crc, char const* errorCode) {
+	uint8_t error = NO_ERROR;
+	Cluster* cluster = sample->clusters.getElement(clusterIndex)
+	                       ->getCluster(sample, clusterIndex, CLUSTER_LOAD_IMMEDIATELY, 0xFFFFFFFF, &error);
+	if (!cluster) {
+		return false;
+	}
+	uint32_t bytesBefore = clusterIndex << audioFileManager.clusterSizeMagnitude;
+	uint32_t numBytes = std::min<uint32_t>(sample->contentFileSize - bytesBefore, audioFileManager.clusterSize);
+	*crc = get_crc((uint8_t*)cluster->data, numBytes);
+	audioFileManager.removeReasonFromCluster(cluster, errorCode);
+	return true;
+}
+
+// The last Cluster's CRC only gets worked out once a Sample's first one matches another's, so a file that differs
+// from another only after its first Cluster - say, after the same stretch of silence - isn't taken for it
+static bool getLastClusterCRC(Sample* sample) {
+	if (!sample->contentLastClusterCRCKnown) {
+		int32_t lastClusterIndex = (sample->contentFileSize - 1) >> audioFileManager.clusterSizeMagnitude;
+		if (!getClusterCRC(sample, lastClusterIndex, &sample->contentLastClusterCRC, "E462")) {
+			return false;
+		}
+		sample->contentLastClusterCRCKnown = true;
+	}
+	return true;
+}
+
+// Looks for an already loaded Sample whose file is the same as the one newSample has just been read from. Either way,
+// newSample is left with what's needed to add it to samplesByContent, if its contentFileSize has been set
+Sample* AudioFileManager::findSampleWithSameContent(Sample* newSample, uint32_t fileSize) {
+	newSample->contentFileSize = fileSize;
+	if (!getClusterCRC(newSample, 0, &newSample->contentFirstClusterCRC, "E461")) {
+		newSample->contentFileSize = 0;
+		return NULL;
+	}
+
+	uint32_t keyWords[2] = {fileSize, newSample->contentFirstClusterCRC};
+	int32_t i = samplesByContent.searchMultiWordExact(keyWords);
+	if (i == -1) {
+		return NULL;
+	}
+
+	Sample* sample = ((SampleContentElement*)samplesByContent.getElementAddress(i))->sample;
+	if (sample->unloadable || sample->unplayable) {
+		return NULL;
+	}
+
+	if (fileSize > clusterSize) {
+		if (!getLastClusterCRC(sample) || !getLastClusterCRC(newSample)
+		    || sample->contentLastClusterCRC != newSample->contentLastClusterCRC) {
+			return NULL;
+		}
+	}
+
+	Debug::print("same content as: ");
+	Debug::println(sample->filePath.get());
+	return sample;
+}
+
+void AudioFileManager::addSampleToContentIndex(Sample* sample) {
+	uint32_t keyWords[2] = {sample->contentFileSize, sample->contentFirstClusterCRC};
+	int32_t i = samplesByContent.searchMultiWordExact(keyWords);
+
+	// If there's one there already, it couldn't be shared - it's unloadable, or only started the same - so we take its
+	// place
+	if (i != -1) {
+		SampleContentElement* element = (SampleContentElement*)samplesByContent.getElementAddress(i);
+		element->sample->inContentIndex = false;
+		element->sample = sample;
+	}
+	else {
+		i = samplesByContent.insertAtKeyMultiWord(keyWords);
+		if (i == -1) {
+			return; // No RAM. It just can't be shared
+		}
+		SampleContentElement* element = (SampleContentElement*)samplesByContent.getElementAddress(i);
+		element->fileSize = sample->contentFileSize;
+		element->firstClusterCRC = sample->contentFirstClusterCRC;
+		element->sample = sample;
+	}
+	sample->inContentIndex = true;
+}
+
+// For when a Sample is being deleted
+void AudioFileManager::removeSampleFromContentIndex(Sample* sample) {
+	uint32_t keyWords[2] = {sample->contentFileSize, sample->contentFirstClusterCRC};
+	int32_t i = samplesByContent.searchMultiWordExact(keyWords);
+	if (i != -1 && ((SampleContentElement*)samplesByContent.getElementAddress(i))->sample == sample) {
+		samplesByContent.deleteAtIndex(i);
+	}
+	sample->inContentIndex = false;
+}
+
 void AudioFileManager::testQueue() {
 
 	/*
@@ -902,12 +1274,43 @@ Cluster* AudioFileManager::allocateCluster(ClusterType type, bool shouldAddReaso
 }
 
 void AudioFileManager::deallocateCluster(Cluster* cluster) {
+	if (cluster->releasePending) {
+		for (int32_t i = 0; i < numClustersReleasedInBatch; i++) {
+			if (clustersReleasedInBatch[i] == cluster) {
+				clustersReleasedInBatch[i] = clustersReleasedInBatch[--numClustersReleasedInBatch];
+				break;
+			}
+		}
+	}
 	cluster->~Cluster(); // Removes reasons, and / or from stealable list
 	delugeDealloc(cluster);
 }
 
 #define REPORT_LOAD_TIME 0
 
+// Returns how many sectors of the card the Cluster's data takes up - fewer than a whole Cluster's worth if it's the last
+// one and we know where the audio data ends, or 0 if it's beyond the end altogether (which shouldn't really happen)
+int32_t AudioFileManager::getNumSectorsToLoad(Cluster* cluster) {
+	Sample* sample = cluster->sample;
+	int32_t numSectors = clusterSize >> 9;
+
+	// If this is the last Cluster, and we do know what the audio data length is...
+	if (sample->audioDataLengthBytes && sample->audioDataLengthBytes != 0x8FFFFFFFFFFFFFFF) {
+		uint32_t audioDataEndPosBytes = sample->audioDataLengthBytes + sample->audioDataStartPosBytes;
+		uint32_t startByteThisCluster = cluster->clusterIndex << clusterSizeMagnitude;
+		int32_t bytesToRead = audioDataEndPosBytes - startByteThisCluster;
+		if (bytesToRead <= 0) {
+			return 0;
+		}
+		if (bytesToRead < clusterSize) {
+			numSectors = ((bytesToRead - 1) >> 9) + 1;
+		}
+		// Otherwise, just leave it at the normal number of sectors
+	}
+
+	return numSectors;
+}
+
 bool AudioFileManager::loadCluster(Cluster* cluster, int32_t minNumReasonsAfter) {
 
 	if (currentlyAccessingCard) {
@@ -952,23 +1355,10 @@ getOutEarly:
 		return false;
 	}
 
-	int32_t clusterIndex = cluster->clusterIndex;
-
-	int32_t numSectors = clusterSize >> 9;
-
-	// If this is the last Cluster, and we do know what the audio data length is...
-	if (sample->audioDataLengthBytes && sample->audioDataLengthBytes != 0x8FFFFFFFFFFFFFFF) {
-		uint32_t audioDataEndPosBytes = sample->audioDataLengthBytes + sample->audioDataStartPosBytes;
-		uint32_t startByteThisCluster = clusterIndex << clusterSizeMagnitude;
-		int32_t bytesToRead = audioDataEndPosBytes - startByteThisCluster;
-		if (bytesToRead <= 0) {
-			Debug::println("fail thing"); // Shouldn't really still happen
-			goto getOutEarly;
-		}
-		if (bytesToRead < clusterSize) {
-			numSectors = ((bytesToRead - 1) >> 9) + 1;
-		}
-		// Otherwise, just leave it at the normal number of sectors
+	int32_t numSectors = getNumSectorsToLoad(cluster);
+	if (!numSectors) {
+		Debug::println("fail thing"); // Shouldn't really still happen
+		goto getOutEarly;
 	}
 
 #if ALPHA_OR_BETA_VERSION
@@ -994,8 +1384,28 @@ getOutEarly:
 	}
 #endif
 
-	DRESULT result = disk_read_without_streaming_first(
-	    SD_PORT, (BYTE*)cluster->data, sample->clusters.getElement(cluster->clusterIndex)->sdAddress, numSectors);
+	DRESULT result;
+	if (sample->compressedBlocks) {
+		result = loadCompressedCluster(cluster) ? RES_OK : RES_ERROR;
+	}
+	else if (!numClustersLoadingAlongside) {
+		result = disk_read_without_streaming_first(
+		    SD_PORT, (BYTE*)cluster->data, sample->clusters.getElement(cluster->clusterIndex)->sdAddress, numSectors);
+	}
+
+	// Or if there are more Clusters straight after this one on the card, read the lot. Only the last one can be partial
+	else {
+		BYTE* buffers[kMaxClustersPerRead];
+		buffers[0] = (BYTE*)cluster->data;
+		for (int32_t i = 0; i < numClustersLoadingAlongside; i++) {
+			buffers[i + 1] = (BYTE*)clustersLoadingAlongside[i]->data;
+		}
+		numSectors = numClustersLoadingAlongside * (clusterSize >> 9)
+		             + getNumSectorsToLoad(clustersLoadingAlongside[numClustersLoadingAlongside - 1]);
+		result = disk_read_scattered_without_streaming_first(
+		    SD_PORT, buffers, clusterSize >> 9, sample->clusters.getElement(cluster->clusterIndex)->sdAddress,
+		    numSectors);
+	}
 
 #if REPORT_LOAD_TIME
 	uint16_t endTime = MTU2.TCNT_0;
@@ -1024,7 +1434,7 @@ getOutEarly:
 		goto getOutEarly;
 	}
 
-	cluster->convertDataIfNecessary();
+	finishLoadingCluster(cluster);
 
 #if ALPHA_OR_BETA_VERSION
 	if (cluster->numReasonsToBeLoaded < minNumReasonsAfter + 1) {
@@ -1032,6 +1442,29 @@ getOutEarly:
 	}
 #endif
 
+	clusterBeingLoaded = NULL;
+	removeReasonFromCluster(cluster, "E034");
+
+#if ALPHA_OR_BETA_VERSION
+	if (cluster->numReasonsToBeLoaded < minNumReasonsAfter) {
+		display->freezeWithError("i037");
+	}
+	if (cluster->sample->clusters.getElement(cluster->clusterIndex)->cluster != cluster) {
+		display->freezeWithError("E438");
+	}
+#endif
+
+	return true;
+}
+
+// Once a Cluster's data has been read from the card, converts it if need be, and sorts out the few bytes that
+// overhang into the Clusters either side of it.
+void AudioFileManager::finishLoadingCluster(Cluster* cluster) {
+	Sample* sample = cluster->sample;
+	int32_t clusterIndex = cluster->clusterIndex;
+
+	cluster->convertDataIfNecessary();
+
 	int32_t misalignment = sample->audioDataStartPosBytes & 0b11;
 
 	// Give extra bytes to previous Cluster
@@ -1043,8 +1476,8 @@ getOutEarly:
 			// We first copy our first 7 bytes from here to the end of the prev Cluster...
 			memcpy(&prevCluster->data[clusterSize], cluster->data, 7);
 
-			// If 24-bit wrong-endian data...
-			if (sample->rawDataFormat == RAW_DATA_ENDIANNESS_WRONG_24) {
+			// If 24-bit data needing conversion...
+			if (sample->rawDataIs24Bit()) {
 
 				// If we hadn't previously written the "extra" bytes to the end of the prev Cluster and converted them, do so now...
 				if (!prevCluster->extraBytesAtEndConverted) {
@@ -1055,11 +1488,7 @@ getOutEarly:
 
 						// There'll be one word in there which hasn't yet been converted. Do it now. (We've probably just copied over the next one and a bit, which already was converted)
 						int32_t startPos = clusterSize - bytesUnconvertedBeforeCluster;
-						uint8_t* thisNumber = (uint8_t*)&prevCluster->data[startPos];
-
-						uint8_t temp = thisNumber[0];
-						thisNumber[0] = thisNumber[2];
-						thisNumber[2] = temp;
+						sample->convertOne24BitValue((uint8_t*)&prevCluster->data[startPos]);
 
 						// And now, copy 2 bytes back to this Cluster (that's the maximum that the float could have been overhanging the boundary)
 						memcpy(cluster->data, &prevCluster->data[clusterSize], 2);
@@ -1101,8 +1530,8 @@ getOutEarly:
 
 		if (nextCluster && nextCluster->loaded) {
 
-			// If 24-bit wrong-endian data...
-			if (sample->rawDataFormat == RAW_DATA_ENDIANNESS_WRONG_24) {
+			// If 24-bit data needing conversion...
+			if (sample->rawDataIs24Bit()) {
 
 				uint32_t bytesBeforeStartOfNextCluster =
 				    (clusterIndex + 1) * clusterSize - sample->audioDataStartPosBytes;
@@ -1126,11 +1555,8 @@ getOutEarly:
 					}
 
 					// There'll be one word in there which hasn't yet been converted. Do it now. (We've probably just copied over the next one and a bit, which already was converted)
-					uint8_t* thisNumber = (uint8_t*)&cluster->data[clusterSize - bytesUnconvertedBeforeNextCluster];
-
-					uint8_t temp = thisNumber[0];
-					thisNumber[0] = thisNumber[2];
-					thisNumber[2] = temp;
+					sample->convertOne24BitValue(
+					    (uint8_t*)&cluster->data[clusterSize - bytesUnconvertedBeforeNextCluster]);
 
 					// If we had't previously converted the first couple of bytes of the next Cluster, do so now...
 					if (!nextCluster->extraBytesAtStartConverted) {
@@ -1204,24 +1630,289 @@ copy7ToMe:
 	}
 
 	cluster->loaded = true;
+}
 
-	clusterBeingLoaded = NULL;
-	removeReasonFromCluster(cluster, "E034");
-
-#if ALPHA_OR_BETA_VERSION
-	if (cluster->numReasonsToBeLoaded < minNumReasonsAfter) {
-		display->freezeWithError("i037");
+// Reads a Cluster's block of its Sample's compressed transcode, and decodes it into the Cluster. Returns false if the
+// card couldn't be read
+bool AudioFileManager::loadCompressedCluster(Cluster* cluster) {
+	Sample* sample = cluster->sample;
+	CompressedBlock* block = &sample->compressedBlocks[cluster->clusterIndex];
+
+	// One that wouldn't compress can go straight into the Cluster
+	uint8_t* destination = block->verbatim ? (uint8_t*)cluster->data : compressedBlockBuffer;
+	DRESULT result =
+	    disk_read_without_streaming_first(SD_PORT, destination, block->sdAddress, block->numSectorsBeforeBreak);
+	if (result == RES_OK && block->numSectorsBeforeBreak < block->numSectors) {
+		result = disk_read_without_streaming_first(SD_PORT, destination + (block->numSectorsBeforeBreak << 9),
+		                                           block->sdAddressAfterBreak,
+		                                           block->numSectors - block->numSectorsBeforeBreak);
+	}
+	if (result != RES_OK) {
+		return false;
 	}
-	if (cluster->sample->clusters.getElement(cluster->clusterIndex)->cluster != cluster) {
-		display->freezeWithError("E438");
+	if (block->verbatim) {
+		return true;
 	}
-#endif
 
+	uint32_t firstFrame, endFrame;
+	sample->getFramesTouchingCluster(cluster->clusterIndex, &firstFrame, &endFrame);
+	int32_t bytesPerFrame = sample->byteDepth * sample->numChannels;
+	int32_t skipBytes = (cluster->clusterIndex << clusterSizeMagnitude)
+	                    - (sample->audioDataStartPosBytes + firstFrame * bytesPerFrame);
+
+	if (!decodeSampleBlock(compressedBlockBuffer, block->numSectors << 9, endFrame - firstFrame, sample->numChannels,
+	                       sample->byteDepth, (uint8_t*)cluster->data, skipBytes, clusterSize)) {
+		// Only if the file's been damaged somehow. Trying again would just get the same, so have silence
+		Debug::println("compressed block corrupt");
+		memset(cluster->data, 0, clusterSize);
+	}
 	return true;
 }
 
+// Takes any Clusters that come straight after this one both in its Sample and on the card, and are also waiting to be
+// loaded, out of the loading queue so loadCluster() reads them all at once
+void AudioFileManager::grabClustersToLoadAlongside(Cluster* cluster) {
+	numClustersLoadingAlongside = 0;
+
+	Sample* sample = cluster->sample;
+	if (sample->compressedBlocks) {
+		return; // Each block's read and decoded on its own
+	}
+
+	int32_t sectorsPerCluster = clusterSize >> 9;
+	int32_t clusterIndex = cluster->clusterIndex;
+	uint32_t sdAddress = sample->clusters.getElement(clusterIndex)->sdAddress;
+	Cluster* prevCluster = cluster;
+
+	while (numClustersLoadingAlongside < kMaxClustersPerRead - 1) {
+		// Only the last Cluster of a run may be partial
+		if (getNumSectorsToLoad(prevCluster) < sectorsPerCluster) {
+			break;
+		}
+
+		clusterIndex++;
+		sdAddress += sectorsPerCluster;
+		if (clusterIndex >= sample->clusters.getNumElements()) {
+			break;
+		}
+
+		SampleCluster* sampleCluster = sample->clusters.getElement(clusterIndex);
+		Cluster* nextCluster = sampleCluster->cluster;
+		if (sampleCluster->sdAddress != sdAddress || !nextCluster || nextCluster->loaded
+		    || !getNumSectorsToLoad(nextCluster) || !loadingQueue.removeIfPresent(nextCluster)) {
+			break;
+		}
+
+		addReasonToCluster(nextCluster); // So it can't be deallocated while its data is arriving
+		clustersLoadingAlongside[numClustersLoadingAlongside++] = nextCluster;
+		prevCluster = nextCluster;
+	}
+}
+
+// If the read worked, the Clusters that got loaded alongside clusterBeingLoaded get finished off. Otherwise, they go
+// back in the queue.
+void AudioFileManager::finishClustersLoadedAlongside(bool success) {
+	for (int32_t i = 0; i < numClustersLoadingAlongside; i++) {
+		Cluster* cluster = clustersLoadingAlongside[i];
+		if (success) {
+			finishLoadingCluster(cluster);
+		}
+		else {
+			enqueueCluster(cluster); // TODO: If that fails, it'll just get awkwardly forgotten about
+		}
+		removeReasonFromCluster(cluster, "E452");
+	}
+	numClustersLoadingAlongside = 0;
+}
+
+bool AudioFileManager::isClusterBeingLoaded(Cluster* cluster) {
+	if (cluster == clusterBeingLoaded) {
+		return true;
+	}
+	for (int32_t i = 0; i < numClustersLoadingAlongside; i++) {
+		if (cluster == clustersLoadingAlongside[i]) {
+			return true;
+		}
+	}
+	return false;
+}
+
 // Only needs calling a couple times per second. Must be called outside of the audio / SD-reading routine
 // Call this repeatedly so SD card is re-initialized on re-insert before we actually urgently need audio from it
+// Called from the audio routine, when a Sample is first time-stretched. Returns false if there wasn't room to queue it
+bool AudioFileManager::requestPercCacheAnalysis(Sample* sample) {
+	if (numSamplesAwaitingPercCacheAnalysis >= kMaxSamplesAwaitingPercCacheAnalysis) {
+		return false;
+	}
+	samplesAwaitingPercCacheAnalysis[numSamplesAwaitingPercCacheAnalysis++] = sample;
+	return true;
+}
+
+// For when a Sample is being deleted
+void AudioFileManager::cancelPercCacheAnalysis(Sample* sample) {
+	for (int32_t i = 0; i < numSamplesAwaitingPercCacheAnalysis; i++) {
+		if (samplesAwaitingPercCacheAnalysis[i] == sample) {
+			numSamplesAwaitingPercCacheAnalysis--;
+			memmove(&samplesAwaitingPercCacheAnalysis[i], &samplesAwaitingPercCacheAnalysis[i + 1],
+			        (numSamplesAwaitingPercCacheAnalysis - i) * sizeof(Sample*));
+			return;
+		}
+	}
+}
+
+// Called when WaveformRenderer first wants to draw a Sample zoomed out. Returns false if there wasn't room to queue it
+bool AudioFileManager::requestPeakPyramidBuild(Sample* sample) {
+	if (numSamplesAwaitingPeakPyramidBuild >= kMaxSamplesAwaitingPeakPyramidBuild) {
+		return false;
+	}
+	samplesAwaitingPeakPyramidBuild[numSamplesAwaitingPeakPyramidBuild++] = sample;
+	return true;
+}
+
+// For when a Sample is being deleted
+void AudioFileManager::cancelPeakPyramidBuild(Sample* sample) {
+	for (int32_t i = 0; i < numSamplesAwaitingPeakPyramidBuild; i++) {
+		if (samplesAwaitingPeakPyramidBuild[i] == sample) {
+			numSamplesAwaitingPeakPyramidBuild--;
+			memmove(&samplesAwaitingPeakPyramidBuild[i], &samplesAwaitingPeakPyramidBuild[i + 1],
+			        (numSamplesAwaitingPeakPyramidBuild - i) * sizeof(Sample*));
+			return;
+		}
+	}
+}
+
+// Called from the audio routine. Returns false if there wasn't room to queue it
+bool AudioFileManager::requestSampleCacheCardAccess(SampleCache* cache) {
+	if (numSampleCachesAwaitingCardAccess >= kMaxSampleCachesAwaitingCardAccess) {
+		return false;
+	}
+	sampleCachesAwaitingCardAccess[numSampleCachesAwaitingCardAccess++] = cache;
+	return true;
+}
+
+// For when a SampleCache is being deleted
+void AudioFileManager::cancelSampleCacheCardAccess(SampleCache* cache) {
+	for (int32_t i = 0; i < numSampleCachesAwaitingCardAccess; i++) {
+		if (sampleCachesAwaitingCardAccess[i] == cache) {
+			numSampleCachesAwaitingCardAccess--;
+			memmove(&sampleCachesAwaitingCardAccess[i], &sampleCachesAwaitingCardAccess[i + 1],
+			        (numSampleCachesAwaitingCardAccess - i) * sizeof(SampleCache*));
+			return;
+		}
+	}
+}
+
+// Called when a Sample in a non-native format has loaded. Returns false if there wasn't room to queue it
+bool AudioFileManager::requestTranscode(Sample* sample) {
+	if (numSamplesAwaitingTranscode >= kMaxSamplesAwaitingTranscode) {
+		return false;
+	}
+	samplesAwaitingTranscode[numSamplesAwaitingTranscode++] = sample;
+	return true;
+}
+
+// For when a Sample is being deleted
+void AudioFileManager::cancelTranscode(Sample* sample) {
+	for (int32_t i = 0; i < numSamplesAwaitingTranscode; i++) {
+		if (samplesAwaitingTranscode[i] == sample) {
+			numSamplesAwaitingTranscode--;
+			memmove(&samplesAwaitingTranscode[i], &samplesAwaitingTranscode[i + 1],
+			        (numSamplesAwaitingTranscode - i) * sizeof(Sample*));
+			return;
+		}
+	}
+}
+
+// Gets a Cluster enqueued for loading ahead of anything actually needing it - e.g. the next one along in a
+// multisample's neighbouring ranges, whose first Clusters are already held, so if the next note lands there it's
+// likely to find it ready. The reason we add gets dropped again once it's loaded, leaving it just sitting in a
+// stealable queue, or when we've got too many on the go, so a burst of notes can't pin lots of memory
+void AudioFileManager::prefetchCluster(Sample* sample, int32_t clusterIndex) {
+	if (cardEjected || clusterIndex < 0 || clusterIndex >= sample->clusters.getNumElements()) {
+		return;
+	}
+
+	SampleCluster* sampleCluster = sample->clusters.getElement(clusterIndex);
+	if (sampleCluster->cluster) {
+		return; // Already loaded, or on its way
+	}
+
+	if (numPrefetchingClusters == kMaxPrefetchingClusters) {
+		Cluster* oldest = prefetchingClusters[0];
+		numPrefetchingClusters--;
+		memmove(&prefetchingClusters[0], &prefetchingClusters[1], numPrefetchingClusters * sizeof(Cluster*));
+		removeReasonFromCluster(oldest, "E463");
+	}
+
+	// Lowest priority, so anything a Voice is actually waiting on gets loaded first
+	Cluster* cluster = sampleCluster->getCluster(sample, clusterIndex, CLUSTER_ENQUEUE, 0xFFFFFFFF);
+	if (cluster) {
+		prefetchingClusters[numPrefetchingClusters++] = cluster;
+	}
+}
+
+void AudioFileManager::releaseLoadedPrefetches() {
+	for (int32_t i = 0; i < numPrefetchingClusters;) {
+		Cluster* cluster = prefetchingClusters[i];
+		if (!cluster->loaded) {
+			i++;
+			continue;
+		}
+		numPrefetchingClusters--;
+		memmove(&prefetchingClusters[i], &prefetchingClusters[i + 1], (numPrefetchingClusters - i) * sizeof(Cluster*));
+		removeReasonFromCluster(cluster, "E463");
+	}
+}
+
+// Must be called before the Sample's Clusters go, as it still holds reasons on some of them
+void AudioFileManager::cancelPrefetches(Sample* sample) {
+	for (int32_t i = 0; i < numPrefetchingClusters;) {
+		Cluster* cluster = prefetchingClusters[i];
+		if (cluster->sample != sample) {
+			i++;
+			continue;
+		}
+		numPrefetchingClusters--;
+		memmove(&prefetchingClusters[i], &prefetchingClusters[i + 1], (numPrefetchingClusters - i) * sizeof(Cluster*));
+		removeReasonFromCluster(cluster, "E463");
+	}
+}
+
+bool AudioFileManager::isCompressionEnabled() {
+	return runtimeFeatureSettings.get(RuntimeFeatureSettingType::CompressSamples) == RuntimeFeatureStateToggle::On;
+}
+
+bool AudioFileManager::isTranscodingEnabled() {
+	return runtimeFeatureSettings.get(RuntimeFeatureSettingType::TranscodeSamples) == RuntimeFeatureStateToggle::On;
+}
+
+// Transcodes are named from a CRC of the original file's path, then its size, date and time - so once the original's
+// been changed, its old transcode just never gets found again. Returns false if the original isn't there
+bool AudioFileManager::getTranscodeFilePath(char const* filePath, char* transcodeFilePath, bool compressed) {
+	FRESULT result = f_stat(filePath, &staticFNO);
+	if (result != FR_OK) {
+		return false;
+	}
+
+	strcpy(transcodeFilePath, kTranscodeFolder);
+	char* pos = transcodeFilePath + strlen(kTranscodeFolder);
+	*(pos++) = '/';
+
+	uint32_t keyWords[3];
+	keyWords[0] = get_crc((uint8_t*)filePath, strlen(filePath));
+	keyWords[1] = staticFNO.fsize;
+	keyWords[2] = ((uint32_t)staticFNO.fdate << 16) | staticFNO.ftime;
+	for (int32_t i = 0; i < 3; i++) {
+		intToHex(keyWords[i], pos);
+		pos += 8;
+		if (i < 2) {
+			*(pos++) = '_';
+		}
+	}
+	strcpy(pos, compressed ? ".DLC" : ".WAV");
+	return true;
+}
+
 void AudioFileManager::slowRoutine() {
 
 	// If we know the card's been ejected...
@@ -1241,6 +1932,42 @@ void AudioFileManager::slowRoutine() {
 		}
 	}
 
+	// Do the next perc cache analysis, if any. Those can read the whole Sample, so do one at a time
+	if (numSamplesAwaitingPercCacheAnalysis && !cardEjected && !currentlyAccessingCard) {
+		Sample* sample = samplesAwaitingPercCacheAnalysis[0];
+		numSamplesAwaitingPercCacheAnalysis--;
+		memmove(&samplesAwaitingPercCacheAnalysis[0], &samplesAwaitingPercCacheAnalysis[1],
+		        numSamplesAwaitingPercCacheAnalysis * sizeof(Sample*));
+		sample->analysePercCache();
+	}
+
+	// Or build the next peak pyramid, if any - another whole-Sample read
+	else if (numSamplesAwaitingPeakPyramidBuild && !cardEjected && !currentlyAccessingCard) {
+		Sample* sample = samplesAwaitingPeakPyramidBuild[0];
+		numSamplesAwaitingPeakPyramidBuild--;
+		memmove(&samplesAwaitingPeakPyramidBuild[0], &samplesAwaitingPeakPyramidBuild[1],
+		        numSamplesAwaitingPeakPyramidBuild * sizeof(Sample*));
+		sample->buildPeakPyramid();
+	}
+
+	// Or save or restore the next SampleCache, if any
+	else if (numSampleCachesAwaitingCardAccess && !cardEjected && !currentlyAccessingCard) {
+		SampleCache* cache = sampleCachesAwaitingCardAccess[0];
+		numSampleCachesAwaitingCardAccess--;
+		memmove(&sampleCachesAwaitingCardAccess[0], &sampleCachesAwaitingCardAccess[1],
+		        numSampleCachesAwaitingCardAccess * sizeof(SampleCache*));
+		cache->doCardAccess();
+	}
+
+	// Or write the next transcode, if any - yet another whole-Sample read
+	else if (numSamplesAwaitingTranscode && !cardEjected && !currentlyAccessingCard) {
+		Sample* sample = samplesAwaitingTranscode[0];
+		numSamplesAwaitingTranscode--;
+		memmove(&samplesAwaitingTranscode[0], &samplesAwaitingTranscode[1],
+		        numSamplesAwaitingTranscode * sizeof(Sample*));
+		sample->writeTranscode();
+	}
+
 	// NOTE: (Kate) There was dead code here referencing things that no longer
 	// exist (NUM_LOADED_SAMPLE_CHUNK_ALLOCATION_QUEUES, availableClusterQueues)
 	// It has been removed.
@@ -1254,7 +1981,12 @@ void AudioFileManager::slowRoutine() {
 uint16_t timeLastFinish;
 #endif
 
-void AudioFileManager::loadAnyEnqueuedClusters(int32_t maxNum, bool mayProcessUserActionsBetween) {
+// If stopBeforeRenderDeadline, we'll only keep loading while it looks like there's time to do so before the audio
+// routine must be called again. At least one Cluster always gets loaded though, so we still make progress.
+void AudioFileManager::loadAnyEnqueuedClusters(int32_t maxNum, bool mayProcessUserActionsBetween,
+                                               bool stopBeforeRenderDeadline) {
+
+	releaseLoadedPrefetches();
 
 	if (currentlyAccessingCard) {
 		return;
@@ -1300,6 +2032,11 @@ performActionsAndGetOut:
 			playbackHandler.slowRoutine();
 		}
 
+		if (stopBeforeRenderDeadline && count
+		    && AudioEngine::getCyclesUntilRenderDeadline() < (int32_t)averageClusterLoadCycles) {
+			break;
+		}
+
 		Cluster* cluster = loadingQueue.grabHead();
 		if (!cluster) {
 			break;
@@ -1312,10 +2049,26 @@ performActionsAndGetOut:
 			display->freezeWithError("E235"); // Cos Chris F got an E205
 		}
 
+		uint32_t loadStartTime = Debug::readCycleCounter();
+		TRACE_BEGIN(CLUSTER_LOAD);
+
+		grabClustersToLoadAlongside(cluster);
+		int32_t numClustersThisRead = numClustersLoadingAlongside + 1;
+
 		allowSomeUserActionsEvenWhenInCardRoutine = true; // Sorry!!
 		bool success = loadCluster(cluster);
 		allowSomeUserActionsEvenWhenInCardRoutine = false;
 
+		finishClustersLoadedAlongside(success);
+		TRACE_END(CLUSTER_LOAD, numClustersThisRead);
+
+		// This is per read rather than per Cluster, as that's what the check above needs to know
+		uint32_t loadTime = Debug::readCycleCounter() - loadStartTime;
+		averageClusterLoadCycles = averageClusterLoadCycles - (averageClusterLoadCycles >> 3) + (loadTime >> 3);
+		if (loadTime > longestClusterLoadCycles) {
+			longestClusterLoadCycles = loadTime;
+		}
+
 		// If that didn't work, presumably because the SD card got ejected...
 		if (!success) {
 			Debug::println("load Cluster fail");
@@ -1338,7 +2091,7 @@ performActionsAndGetOut:
 			}
 		}
 
-		count++;
+		count += numClustersThisRead;
 		if (count >= maxNum) {
 			break; // Keep things sane?
 		}
@@ -1349,13 +2102,19 @@ performActionsAndGetOut:
 #endif
 }
 
+// For when a Voice is about to run out of loaded Clusters - gets this one to the front of the queue
+void AudioFileManager::prioritizeCluster(Cluster* cluster) {
+	loadingQueue.raisePriority(cluster, 0);
+}
+
 // Currently there's no risk of trying to enqueue a cluster multiple times, because this function only gets called after it's freshly allocated
 int32_t AudioFileManager::enqueueCluster(Cluster* cluster, uint32_t priorityRating) {
 	return loadingQueue.add(cluster, priorityRating);
 }
 
 void AudioFileManager::addReasonToCluster(Cluster* cluster) {
-	// If it's going to cease to be zero, it's become unavailable
+	// If it's going to cease to be zero, it's become unavailable. If it's only waiting in the batch, it's not in any
+	// queue, and endReasonBatch() will see it's wanted again
 	if (cluster->numReasonsToBeLoaded == 0) {
 		cluster->remove();
 		//*cluster->getAnyReasonsPointer() = reasonType;
@@ -1364,6 +2123,41 @@ void AudioFileManager::addReasonToCluster(Cluster* cluster) {
 	cluster->numReasonsToBeLoaded++;
 }
 
+void AudioFileManager::beginReasonBatch() {
+	batchingReasons = true;
+}
+
+void AudioFileManager::endReasonBatch() {
+	batchingReasons = false;
+
+	for (int32_t i = 0; i < numClustersReleasedInBatch; i++) {
+		Cluster* cluster = clustersReleasedInBatch[i];
+		cluster->releasePending = false;
+		if (cluster->numReasonsToBeLoaded == 0) {
+			releaseCluster(cluster);
+		}
+	}
+	numClustersReleasedInBatch = 0;
+}
+
+// For once a Cluster has no reasons left
+void AudioFileManager::releaseCluster(Cluster* cluster) {
+	// If it's still in the load queue, remove it from there. (We know that it isn't in the process of being loaded right now
+	// because that would have added a "reason", so we wouldn't be here.)
+	if (loadingQueue.removeIfPresent(cluster)) {
+
+		// Tell its Cluster to forget it exists
+		cluster->sample->clusters.getElement(cluster->clusterIndex)->cluster = NULL;
+
+		deallocateCluster(cluster); // It contains nothing, so completely recycle it
+	}
+
+	else {
+		GeneralMemoryAllocator::get().putStealableInAppropriateQueue(
+		    cluster); // It contains data we may want at some future point, so file it away
+	}
+}
+
 void AudioFileManager::removeReasonFromCluster(Cluster* cluster, char const* errorCode) {
 	cluster->numReasonsToBeLoaded--;
 
@@ -1379,19 +2173,15 @@ void AudioFileManager::removeReasonFromCluster(Cluster* cluster, char const* err
 			display->freezeWithError("E364");
 		}
 
-		// If it's still in the load queue, remove it from there. (We know that it isn't in the process of being loaded right now
-		// because that would have added a "reason", so we wouldn't be here.)
-		if (loadingQueue.removeIfPresent(cluster)) {
-
-			// Tell its Cluster to forget it exists
-			cluster->sample->clusters.getElement(cluster->clusterIndex)->cluster = NULL;
-
-			deallocateCluster(cluster); // It contains nothing, so completely recycle it
-		}
-
-		else {
-			GeneralMemoryAllocator::get().putStealableInAppropriateQueue(
-			    cluster); // It contains data we may want at some future point, so file it away
+		// Unless it's still waiting in the batch from having gone to zero earlier in this same render
+		if (!cluster->releasePending) {
+			if (batchingReasons && numClustersReleasedInBatch < kMaxClustersReleasedPerBatch) {
+				cluster->releasePending = true;
+				clustersReleasedInBatch[numClustersReleasedInBatch++] = cluster;
+			}
+			else {
+				releaseCluster(cluster);
+			}
 		}
 
 		//*cluster->getAnyReasonsPointer() = ANY_REASONS_NO;
@@ -1412,10 +2202,7 @@ void AudioFileManager::removeReasonFromCluster(Cluster* cluster, char const* err
 }
 
 bool AudioFileManager::loadingQueueHasAnyLowestPriorityElements() {
-	int32_t numElements = loadingQueue.getNumElements();
-	return (numElements
-	        && ((PriorityQueueElement*)audioFileManager.loadingQueue.getElementAddress(numElements - 1))->priorityRating
-	               == 0xFFFFFFFF);
+	return loadingQueue.getNumElementsWithLowestPriority();
 }
 
 // Caller must also set alternateAudioFileLoadPath.
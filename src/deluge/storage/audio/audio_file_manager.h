@@ -17,8 +17,10 @@
 
 #pragma once
 #include "definitions_cxx.hpp"
+#include "memory/relocatable.h"
 #include "storage/audio/audio_file_vector.h"
 #include "storage/cluster/cluster_priority_queue.h"
+#include "util/container/array/ordered_resizeable_array_with_multi_word_key.h"
 #include "util/container/list/bidirectional_linked_list.h"
 #include <cstdint>
 #include <stdint.h>
@@ -33,6 +35,55 @@ class SampleCache;
 class String;
 class SampleRecorder;
 
+// The most Clusters which will be loaded with one command to the card, if they sit one after the other on it
+constexpr int32_t kMaxClustersPerRead = 4;
+
+// Any more first-time time-stretched Samples than this at once just get their perc caches filled during playback
+constexpr int32_t kMaxSamplesAwaitingPercCacheAnalysis = 8;
+constexpr int32_t kMaxSamplesAwaitingPeakPyramidBuild = 8;
+
+// Any more SampleCaches than this wanting saving to or restoring from the card at once just have to ask again later
+constexpr int32_t kMaxSampleCachesAwaitingCardAccess = 8;
+
+// Any more non-native Samples than this waiting to be transcoded at once just get transcoded the next time they load
+constexpr int32_t kMaxSamplesAwaitingTranscode = 8;
+constexpr int32_t kMaxPrefetchingClusters = 16;
+
+// How many Clusters can lose their last reason during one render before the rest just get filed away there and then
+constexpr int32_t kMaxClustersReleasedPerBatch = 64;
+
+// Where native copies of Samples in non-native formats get kept, when that's switched on
+constexpr char const* kTranscodeFolder = "/.SAMPLE_TRANSCODES";
+constexpr int32_t kTranscodeFilePathMaxLength = 64;
+
+// At the start of a compressed transcode - see Sample::writeCompressedTranscode(). Then comes a table of numBlocks + 1
+// sector numbers from the start of the file: where each block starts, and lastly where the file ends. A block holds
+// everything in one Cluster's worth of the WAV file it was made from, laid out as that was, with the audio data
+// starting at audioDataStartPosBytes - which is also how it ends up in the Cluster once decoded. The top bit of a
+// block's sector number is set if the block couldn't be made any smaller, and is just that PCM as it was.
+struct CompressedSampleHeader {
+	uint32_t magic;
+	uint16_t version;
+	uint8_t numChannels;
+	uint8_t byteDepth;
+	uint32_t sampleRate;
+	uint32_t clusterSize; // Has to match the card's, or the blocks won't line up with the Clusters
+	uint32_t audioDataStartPosBytes;
+	uint32_t audioDataLengthBytes;
+	uint32_t fileLoopStartSamples;
+	uint32_t fileLoopEndSamples;
+	float midiNoteFromFile;
+	uint32_t waveTableCycleSize;
+	uint8_t fileExplicitlySpecifiesSelfAsWaveTable;
+	uint8_t rawDataLShift; // For our own recordings, still to be normalised as they load, like from their WAV file
+	uint16_t reserved;
+	uint32_t numBlocks;
+};
+
+constexpr uint32_t kCompressedSampleMagic = 0x53434C44; // "DLCS"
+constexpr uint16_t kCompressedSampleVersion = 1;
+constexpr uint32_t kCompressedBlockVerbatim = 0x80000000;
+
 enum class AlternateLoadDirStatus {
 	NONE_SET,
 	NOT_FOUND,
@@ -49,7 +100,9 @@ enum class AlternateLoadDirStatus {
  * The Deluge deals in these Clusters, whatever size they may be for the card, which makes
  * sense because one Cluster always exists in one physical place on the SD card (or any disk),
  * so may be easily loaded in one operation by DMA. Whereas consecutive clusters making up an
- * (audio) file are often placed in completely different physical locations.
+ * (audio) file are often placed in completely different physical locations. When they're not though, and several
+ * consecutive Clusters of a file are waiting to be loaded, they all get read with one command to the card, with the
+ * DMA sending each Cluster's worth of data into its own Cluster in RAM.
  *
  * For a Sample associated with a Sound or AudioClip, the Deluge keeps the first two Clusters of that file
  * (from its set start-point and subject to reversing) permanently loaded in RAM, so playback of the
@@ -80,17 +133,26 @@ public:
 
 	void init();
 	AudioFile* getAudioFileFromFilename(String* fileName, bool mayReadCard, uint8_t* error, FilePointer* filePointer,
-	                                    AudioFileType type, bool makeWaveTableWorkAtAllCosts = false);
+	                                    AudioFileType type, bool makeWaveTableWorkAtAllCosts = false,
+	                                    bool mayShareSampleWithSameContent = true);
 	Cluster* allocateCluster(ClusterType type = ClusterType::Sample, bool shouldAddReasons = true,
 	                         void* dontStealFromThing = NULL);
 	int32_t enqueueCluster(Cluster* cluster, uint32_t priorityRating = 0xFFFFFFFF);
 	bool loadCluster(Cluster* cluster, int32_t minNumReasonsAfter = 0);
-	void loadAnyEnqueuedClusters(int32_t maxNum = 128, bool mayProcessUserActionsBetween = false);
+	void loadAnyEnqueuedClusters(int32_t maxNum = 128, bool mayProcessUserActionsBetween = false,
+	                             bool stopBeforeRenderDeadline = false);
+	void prioritizeCluster(Cluster* cluster);
 	void addReasonToCluster(Cluster* cluster);
 	void removeReasonFromCluster(Cluster* cluster, char const* errorCode);
+	void beginReasonBatch();
+	void endReasonBatch();
+	bool isClusterBeingLoaded(Cluster* cluster);
 	void testQueue();
 
 	bool ensureEnoughMemoryForOneMoreAudioFile();
+	/// SDRAM that could be had without touching the current song's sample data - free space, plus whatever's only cached
+	/// for no song in particular. Walks the whole region, so not for the audio routine
+	uint32_t getRAMSpareFromCurrentSong();
 
 	void slowRoutine();
 	void deallocateCluster(Cluster* cluster);
@@ -104,6 +166,20 @@ public:
 	void deleteUnusedAudioFileFromMemoryIndexUnknown(AudioFile* audioFile);
 	bool tryToDeleteAudioFileFromMemoryIfItExists(char const* filePath);
 
+	bool requestPercCacheAnalysis(Sample* sample);
+	void cancelPercCacheAnalysis(Sample* sample);
+	bool requestPeakPyramidBuild(Sample* sample);
+	void cancelPeakPyramidBuild(Sample* sample);
+	bool requestSampleCacheCardAccess(SampleCache* cache);
+	void cancelSampleCacheCardAccess(SampleCache* cache);
+	bool requestTranscode(Sample* sample);
+	void cancelTranscode(Sample* sample);
+	bool getTranscodeFilePath(char const* filePath, char* transcodeFilePath, bool compressed = false);
+	bool isCompressionEnabled();
+	void removeSampleFromContentIndex(Sample* sample);
+	void prefetchCluster(Sample* sample, int32_t clusterIndex);
+	void cancelPrefetches(Sample* sample);
+
 	void thingBeginningLoading(ThingType newThingType);
 	void thingFinishedLoading();
 
@@ -119,20 +195,80 @@ public:
 	bool cardDisabled;
 
 	Cluster* clusterBeingLoaded;
+	uint32_t averageClusterLoadCycles; // Includes any audio rendering done while waiting for the card
+	uint32_t longestClusterLoadCycles; // Likewise. Only ever goes up - whoever's watching it resets it
 	int32_t
 	    minNumReasonsForClusterBeingLoaded; // Only valid when clusterBeingLoaded is set. And this exists for bug hunting only.
 
+	// Further Clusters of the same Sample, straight after clusterBeingLoaded, getting read with the same command.
+	// Each has an extra "reason" while it's in here.
+	Cluster* clustersLoadingAlongside[kMaxClustersPerRead - 1];
+	int32_t numClustersLoadingAlongside;
+
 	String alternateAudioFileLoadPath;
 	AlternateLoadDirStatus alternateLoadDirStatus;
 	ThingType thingTypeBeingLoaded;
 	DIR alternateLoadDir;
 
+	// Samples waiting for Sample::analysePercCache() to be called on them from slowRoutine()
+	Sample* samplesAwaitingPercCacheAnalysis[kMaxSamplesAwaitingPercCacheAnalysis];
+	int32_t numSamplesAwaitingPercCacheAnalysis;
+
+	// Samples waiting for Sample::buildPeakPyramid() to be called on them from slowRoutine()
+	Sample* samplesAwaitingPeakPyramidBuild[kMaxSamplesAwaitingPeakPyramidBuild];
+	int32_t numSamplesAwaitingPeakPyramidBuild;
+
+	// SampleCaches waiting for SampleCache::doCardAccess() to be called on them from slowRoutine()
+	SampleCache* sampleCachesAwaitingCardAccess[kMaxSampleCachesAwaitingCardAccess];
+	int32_t numSampleCachesAwaitingCardAccess;
+
+	// Samples waiting for Sample::writeTranscode() to be called on them from slowRoutine()
+	Sample* samplesAwaitingTranscode[kMaxSamplesAwaitingTranscode];
+	int32_t numSamplesAwaitingTranscode;
+
+	// Clusters enqueued by prefetchCluster(), each with a "reason" held until it's loaded, oldest first
+	Cluster* prefetchingClusters[kMaxPrefetchingClusters];
+	int32_t numPrefetchingClusters;
+
+	// Clusters which lost their last reason since beginReasonBatch(). Voices crossing into a new Cluster very often take
+	// it from right where another has just left it, so rather than putting each in a stealable queue only to take it
+	// straight back out again, they wait here til endReasonBatch(), and only then get filed away if still unwanted
+	Cluster* clustersReleasedInBatch[kMaxClustersReleasedPerBatch];
+	int32_t numClustersReleasedInBatch;
+	bool batchingReasons;
+
+	// Where blocks of compressed transcodes get read to, to be decoded into their Clusters. Allocated the first time one
+	// loads
+	uint8_t* compressedBlockBuffer;
+
+	// Samples loaded from the card, keyed by file size and a CRC of their first Cluster, so the same file found at a
+	// different path - e.g. a sample pack copied into several folders - can share the one already loaded. Elements are
+	// SampleContentElements, in the .cpp
+	OrderedResizeableArrayWithMultiWordKey samplesByContent;
+
 	int32_t highestUsedAudioRecordingNumber[kNumAudioRecordingFolders];
 	bool highestUsedAudioRecordingNumberNeedsReChecking[kNumAudioRecordingFolders];
 
 private:
+	// So compaction can move these arrays' memory - see GeneralMemoryAllocator::compactStep()
+	RelocatableArray relocatableAudioFiles{audioFiles};
+	RelocatableArray relocatableSamplesByContent{samplesByContent};
+
 	void setClusterSize(uint32_t newSize);
 	void cardReinserted();
+	bool isTranscodingEnabled();
+	Sample* findSampleWithSameContent(Sample* newSample, uint32_t fileSize);
+	void addSampleToContentIndex(Sample* sample);
+	void releaseLoadedPrefetches();
+	void releaseCluster(Cluster* cluster);
+	int32_t getNumSectorsToLoad(Cluster* cluster);
+	void grabClustersToLoadAlongside(Cluster* cluster);
+	void finishClustersLoadedAlongside(bool success);
+	void finishLoadingCluster(Cluster* cluster);
+	bool readCompressedHeader(char const* filePath, CompressedSampleHeader* header, FilePointer* filePointer);
+	int32_t setUpCompressedSample(Sample* sample, CompressedSampleHeader* header, char const* compressedFilePath,
+	                              uint32_t firstSDCluster);
+	bool loadCompressedCluster(Cluster* cluster);
 	int32_t readBytes(char* buffer, int32_t num, int32_t* byteIndexWithinCluster, Cluster** currentCluster,
 	                  uint32_t* currentClusterIndex, uint32_t fileSize, Sample* sample);
 	int32_t loadAiff(Sample* newSample, uint32_t fileSize, Cluster** currentCluster, uint32_t* currentClusterIndex);
@@ -0,0 +1,99 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "storage/card_benchmark.h"
+#include "definitions_cxx.hpp"
+#include "fatfs/diskio.h"
+#include "io/debug/print.h"
+#include "memory/general_memory_allocator.h"
+#include "storage/audio/audio_file_manager.h"
+#include "storage/storage_manager.h"
+#include <algorithm>
+
+extern "C" {
+#include "RZA1/sdhi/inc/sdif.h"
+}
+
+constexpr int32_t kNumBenchmarkReads = 64;
+
+// What streaming one stereo 16-bit Sample takes
+constexpr uint32_t kBytesPerSecondPerVoice = kSampleRate * 2 * 2;
+
+bool runCardBenchmark(CardBenchmarkResult* result) {
+	if (audioFileManager.cardEjected || audioFileManager.cardDisabled) {
+		return false;
+	}
+
+	FATFS& fileSystem = fileSystemStuff.fileSystem;
+	uint32_t numClusters = fileSystem.n_fatent - 2;
+	uint32_t sectorsPerCluster = std::min<uint32_t>(fileSystem.csize, audioFileManager.clusterSize >> 9);
+	if (!numClusters || !sectorsPerCluster) {
+		return false;
+	}
+
+	void* buffer = GeneralMemoryAllocator::get().alloc(sectorsPerCluster << 9);
+	if (!buffer) {
+		return false;
+	}
+
+	// The same clusters every time, so one card can be compared with another fairly
+	uint32_t seed = 1;
+	uint32_t readTimes[kNumBenchmarkReads];
+	int32_t numReads = 0;
+	for (int32_t r = 0; r < kNumBenchmarkReads; r++) {
+		seed = seed * 1664525 + 1013904223;
+		uint32_t cluster = ((uint64_t)seed * numClusters) >> 32;
+		LBA_t sector = fileSystem.database + cluster * fileSystem.csize;
+
+		uint32_t startTime = Debug::readCycleCounter();
+		DRESULT readResult = disk_read(0, (BYTE*)buffer, sector, sectorsPerCluster);
+		uint32_t readTime = Debug::readCycleCounter() - startTime;
+		if (readResult != RES_OK) {
+			break;
+		}
+		readTimes[numReads++] = readTime / Debug::uS;
+	}
+
+	GeneralMemoryAllocator::get().dealloc(buffer);
+
+	if (!numReads) {
+		return false;
+	}
+
+	std::sort(readTimes, readTimes + numReads);
+	result->medianMicroseconds = readTimes[numReads >> 1];
+	result->p95Microseconds = readTimes[(numReads * 95) / 100];
+	result->worstMicroseconds = readTimes[numReads - 1];
+
+	// Each voice needs a cluster's worth of audio every (cluster size / bytes per second), and the card can deliver
+	// one cluster per p95 read time
+	uint32_t p95Microseconds = std::max<uint32_t>(result->p95Microseconds, 1);
+	uint64_t bytesPerSecond = ((uint64_t)(sectorsPerCluster << 9) * 1000000) / p95Microseconds;
+	result->numVoices = bytesPerSecond / kBytesPerSecondPerVoice;
+
+	// Read back afterwards, so a clock slowed down by CRC errors during the reads above shows up
+	uint8_t cardType;
+	uint8_t speedMode = 0;
+	uint8_t capacity;
+	sd_get_type(SD_PORT, &cardType, &speedMode, &capacity);
+	result->highSpeed = speedMode & SD_SPEED_MODE_HIGH;
+	unsigned long busClockKHz = 0;
+	sd_get_clock(SD_PORT, &busClockKHz);
+	result->busClockKHz = busClockKHz;
+
+	return true;
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+struct CardBenchmarkResult {
+	uint32_t medianMicroseconds;
+	uint32_t p95Microseconds;
+	uint32_t worstMicroseconds;
+	int32_t numVoices; // Stereo 16-bit Samples the card could keep streaming, going by its p95 read time
+	uint32_t busClockKHz; // What the SD clock ended up at, after any slowing down for CRC errors
+	bool highSpeed;       // Whether the card accepted the switch to high speed mode when mounted
+};
+
+/// Rates the card for streaming, by reading whole clusters from all over it - the pattern lots of voices streaming
+/// from different Samples at once makes - and timing each read. Only reads, so it's harmless, but it takes a
+/// second or two. Returns false if there's no card, or no memory to read into.
+bool runCardBenchmark(CardBenchmarkResult* result);
@@ -23,6 +23,7 @@
 #include "processing/engines/audio_engine.h"
 #include "storage/audio/audio_file_manager.h"
 #include "util/functions.h"
+#include "util/functions_quad.h"
 #include <string.h>
 
 Cluster::Cluster() {
@@ -32,8 +33,10 @@ Cluster::Cluster() {
 	extraBytesAtStartConverted = false;
 	extraBytesAtEndConverted = false;
 	loaded = false;
+	releasePending = false;
 	numReasonsHeldBySampleRecorder = 0;
 	numReasonsToBeLoaded = 0;
+	queueIndex = -1;
 	// type is not set here, set it yourself (can't remember exact reason...)
 }
 
@@ -55,11 +58,11 @@ void Cluster::convertDataIfNecessary() {
 		}
 
 		// Special case for 24-bit with its uneven number of bytes
-		if (sample->rawDataFormat == RAW_DATA_ENDIANNESS_WRONG_24) {
-			char* pos;
+		if (sample->rawDataIs24Bit()) {
+			uint8_t* pos;
 
 			if (clusterIndex == startCluster) {
-				pos = &data[startPos & (audioFileManager.clusterSize - 1)];
+				pos = (uint8_t*)&data[startPos & (audioFileManager.clusterSize - 1)];
 			}
 			else {
 				uint32_t bytesBeforeStartOfCluster =
@@ -68,31 +71,26 @@ void Cluster::convertDataIfNecessary() {
 				if (bytesThatWillBeEatingIntoAnother3Byte == 0) {
 					bytesThatWillBeEatingIntoAnother3Byte = 3;
 				}
-				pos = &data[3 - bytesThatWillBeEatingIntoAnother3Byte];
+				pos = (uint8_t*)&data[3 - bytesThatWillBeEatingIntoAnother3Byte];
 			}
 
-			char const* endPos;
+			uint8_t const* endPos;
 			if (clusterIndex == sample->getFirstClusterIndexWithNoAudioData() - 1) {
 				uint32_t endAtBytePos = sample->audioDataStartPosBytes + sample->audioDataLengthBytes;
 				uint32_t endAtPosWithinCluster = endAtBytePos & (audioFileManager.clusterSize - 1);
-				endPos = &data[endAtPosWithinCluster];
+				endPos = (uint8_t*)&data[endAtPosWithinCluster];
 			}
 			else {
-				endPos = &data[audioFileManager.clusterSize - 2];
+				endPos = (uint8_t*)&data[audioFileManager.clusterSize - 2];
 			}
 
 			while (true) {
-				char const* endPosNow = pos + 1024; // Every this many bytes, we'll pause and do an audio routine
+				uint8_t const* endPosNow = pos + 1024; // Every this many bytes, we'll pause and do an audio routine
 				if (endPosNow > endPos) {
 					endPosNow = endPos;
 				}
 
-				while (pos < endPosNow) {
-					uint8_t temp = pos[0];
-					pos[0] = pos[2];
-					pos[2] = temp;
-					pos += 3;
-				}
+				pos = sample->convert24BitData(pos, endPosNow);
 
 				if (pos >= endPos) {
 					break;
@@ -126,14 +124,22 @@ void Cluster::convertDataIfNecessary() {
 
 			//uint16_t startTime = MTU2.TCNT_0;
 
-			for (; pos < endPos; pos++) {
+			while (pos < endPos) {
+				int32_t* endPosNow = pos + 256; // Every this many values, we'll pause and do an audio routine
+				if (endPosNow > endPos) {
+					endPosNow = endPos;
+				}
+
+				// Counted in bytes, as pos and endPos needn't share an alignment. Any value that endPos lands part way
+				// into gets done, as ever
+				int32_t numValues = ((char*)endPosNow - (char*)pos + 3) >> 2;
+				sample->convertData(pos, numValues);
+				pos += numValues;
 
-				if (!((uint32_t)pos & 0b1111111100)) {
+				if (pos < endPos) {
 					AudioEngine::logAction("from convert-data");
 					AudioEngine::routine(); // ----------------------------------------------------
 				}
-
-				sample->convertOneData(pos);
 			}
 
 			/*
@@ -176,6 +182,21 @@ int32_t Cluster::getAppropriateQueue() {
 	return q;
 }
 
+uint32_t Cluster::getReloadCost() {
+	// Caches have to be re-rendered from the original audio - which means reading that back in too, then resampling or
+	// analysing it all over again
+	if (type == ClusterType::PERC_CACHE_FORWARDS || type == ClusterType::PERC_CACHE_REVERSED || sampleCache) {
+		return 4;
+	}
+
+	// Data that wasn't in our native format has to be converted again after it's read
+	if (sample && sample->rawDataFormat) {
+		return 2;
+	}
+
+	return 1;
+}
+
 void Cluster::steal(char const* errorCode) {
 
 	// Ok, we're now gonna decide what to do according to the actual "type" field for this Cluster.
@@ -216,7 +237,7 @@ void Cluster::steal(char const* errorCode) {
 }
 
 bool Cluster::mayBeStolen(void* thingNotToStealFrom) {
-	if (numReasonsToBeLoaded) {
+	if (numReasonsToBeLoaded || releasePending) {
 		return false;
 	}
 
@@ -34,6 +34,7 @@ public:
 	bool mayBeStolen(void* thingNotToStealFrom);
 	void steal(char const* errorCode);
 	int32_t getAppropriateQueue();
+	uint32_t getReloadCost() override;
 
 	ClusterType type;
 	int8_t numReasonsHeldBySampleRecorder;
@@ -45,6 +46,8 @@ public:
 	SampleCache* sampleCache;
 	char firstThreeBytesPreDataConversion[3];
 	bool loaded;
+	bool releasePending; // Lost its last reason mid-render, and is waiting on AudioFileManager::endReasonBatch()
+	int32_t queueIndex; // Where we are in audioFileManager.loadingQueue, or -1 if not in it
 
 	char dummy[CACHE_LINE_SIZE];
 
@@ -18,55 +18,137 @@
 #include "storage/cluster/cluster_priority_queue.h"
 #include "definitions_cxx.hpp"
 #include "io/debug/print.h"
+#include "storage/cluster/cluster.h"
 
-class Cluster;
+ClusterPriorityQueue::ClusterPriorityQueue() : ResizeableArray(sizeof(PriorityQueueElement), 32, 31) {
+	nextSequence = 0;
+	numElementsWithLowestPriority = 0;
+}
+
+// Puts the element at i, and tells its Cluster it's there
+void ClusterPriorityQueue::placeElement(PriorityQueueElement const* element, int32_t i) {
+	*getElement(i) = *element;
+	element->cluster->queueIndex = i;
+}
+
+void ClusterPriorityQueue::siftUp(int32_t i) {
+	PriorityQueueElement moving = *getElement(i);
+	while (i) {
+		int32_t parent = (i - 1) >> 1;
+		PriorityQueueElement* parentElement = getElement(parent);
+		if (!comesBefore(&moving, parentElement)) {
+			break;
+		}
+		placeElement(parentElement, i);
+		i = parent;
+	}
+	placeElement(&moving, i);
+}
 
-ClusterPriorityQueue::ClusterPriorityQueue()
-    : OrderedResizeableArrayWith32bitKey(sizeof(PriorityQueueElement), 32, 31) {
+void ClusterPriorityQueue::siftDown(int32_t i) {
+	PriorityQueueElement moving = *getElement(i);
+	while (true) {
+		int32_t child = (i << 1) + 1;
+		if (child >= numElements) {
+			break;
+		}
+		if (child + 1 < numElements && comesBefore(getElement(child + 1), getElement(child))) {
+			child++;
+		}
+		PriorityQueueElement* childElement = getElement(child);
+		if (!comesBefore(childElement, &moving)) {
+			break;
+		}
+		placeElement(childElement, i);
+		i = child;
+	}
+	placeElement(&moving, i);
 }
 
 // Returns error
 int32_t ClusterPriorityQueue::add(Cluster* cluster, uint32_t priorityRating) {
-	int32_t i = insertAtKey((int32_t)cluster);
-	if (i == -1) {
+	int32_t i = numElements;
+	int32_t error = insertAtIndex(i);
+	if (error) {
 		return ERROR_INSUFFICIENT_RAM;
 	}
 
-	PriorityQueueElement* element = (PriorityQueueElement*)getElementAddress(i);
+	PriorityQueueElement* element = getElement(i);
 	element->priorityRating = priorityRating;
+	element->sequence = nextSequence++;
 	element->cluster = cluster;
+	if (priorityRating == 0xFFFFFFFF) {
+		numElementsWithLowestPriority++;
+	}
+
+	siftUp(i);
 	return NO_ERROR;
 }
 
+// Fills the gap with the last element, which then goes up or down to wherever it belongs
+void ClusterPriorityQueue::removeAtIndex(int32_t i) {
+	PriorityQueueElement* element = getElement(i);
+	if (element->priorityRating == 0xFFFFFFFF) {
+		numElementsWithLowestPriority--;
+	}
+	element->cluster->queueIndex = -1;
+
+	int32_t last = numElements - 1;
+	if (i != last) {
+		PriorityQueueElement* lastElement = getElement(last);
+		bool goesUp = comesBefore(lastElement, element);
+		placeElement(lastElement, i);
+		deleteAtIndex(last);
+		if (goesUp) {
+			siftUp(i);
+		}
+		else {
+			siftDown(i);
+		}
+	}
+	else {
+		deleteAtIndex(last);
+	}
+}
+
 Cluster* ClusterPriorityQueue::grabHead() {
 	if (!numElements) {
 		return NULL;
 	}
-	Cluster* toReturn = ((PriorityQueueElement*)getElementAddress(0))->cluster;
-	deleteAtIndex(0);
+	Cluster* toReturn = getElement(0)->cluster;
+	removeAtIndex(0);
 	return toReturn;
 }
 
 // Returns whether it was present
 bool ClusterPriorityQueue::removeIfPresent(Cluster* cluster) {
-	for (int32_t i = 0; i < numElements; i++) {
-		PriorityQueueElement* element = (PriorityQueueElement*)getElementAddress(i);
-		if (element->cluster == cluster) {
-			deleteAtIndex(i);
-			return true;
-		}
+	if (!checkPresent(cluster)) {
+		return false;
 	}
-
-	return false;
+	removeAtIndex(cluster->queueIndex);
+	return true;
 }
 
-bool ClusterPriorityQueue::checkPresent(Cluster* cluster) {
-	for (int32_t i = 0; i < numElements; i++) {
-		PriorityQueueElement* element = (PriorityQueueElement*)getElementAddress(i);
-		if (element->cluster == cluster) {
-			return true;
+// If the Cluster is in the queue with a worse rating than the one given, move it up to that one. Returns whether it was
+// present
+bool ClusterPriorityQueue::raisePriority(Cluster* cluster, uint32_t priorityRating) {
+	if (!checkPresent(cluster)) {
+		return false;
+	}
+
+	int32_t i = cluster->queueIndex;
+	PriorityQueueElement* element = getElement(i);
+	if (element->priorityRating > priorityRating) {
+		if (element->priorityRating == 0xFFFFFFFF) {
+			numElementsWithLowestPriority--;
 		}
+		element->priorityRating = priorityRating;
+		siftUp(i);
 	}
+	return true;
+}
 
-	return false;
+bool ClusterPriorityQueue::checkPresent(Cluster* cluster) {
+	int32_t i = cluster->queueIndex;
+	return (i >= 0 && i < numElements && getElement(i)->cluster == cluster);
 }
@@ -17,16 +17,20 @@
 
 #pragma once
 
-#include "util/container/array/ordered_resizeable_array.h"
+#include "util/container/array/resizeable_array.h"
 
 class Cluster;
 
 struct PriorityQueueElement {
 	uint32_t priorityRating;
+	uint32_t sequence; // When it was added, so that of those with equal ratings, the newest comes out first
 	Cluster* cluster;
 };
 
-class ClusterPriorityQueue final : public OrderedResizeableArrayWith32bitKey {
+/// Clusters waiting to be loaded. Lowest priority rating gets loaded first.
+/// A binary min-heap, with each Cluster remembering where it is in it, so adding, taking the head, removing and raising
+/// priority are all O(log n) - with 60+ voices streaming, there can be hundreds of these, getting added all the time
+class ClusterPriorityQueue final : public ResizeableArray {
 public:
 	ClusterPriorityQueue();
 
@@ -34,4 +38,22 @@ public:
 	Cluster* grabHead();
 	bool removeIfPresent(Cluster* cluster);
 	bool checkPresent(Cluster* cluster);
+	bool raisePriority(Cluster* cluster, uint32_t priorityRating);
+
+	/// How many are waiting with the worst possible rating, 0xFFFFFFFF - meaning they only want loading because a song is
+	inline int32_t getNumElementsWithLowestPriority() { return numElementsWithLowestPriority; }
+
+private:
+	inline PriorityQueueElement* getElement(int32_t i) { return (PriorityQueueElement*)getElementAddress(i); }
+	static inline bool comesBefore(PriorityQueueElement const* a, PriorityQueueElement const* b) {
+		return a->priorityRating < b->priorityRating
+		       || (a->priorityRating == b->priorityRating && (int32_t)(a->sequence - b->sequence) > 0);
+	}
+	void placeElement(PriorityQueueElement const* element, int32_t i);
+	void siftUp(int32_t i);
+	void siftDown(int32_t i);
+	void removeAtIndex(int32_t i);
+
+	uint32_t nextSequence;
+	int32_t numElementsWithLowestPriority;
 };
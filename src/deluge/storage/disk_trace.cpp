@@ -0,0 +1,99 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "storage/disk_trace.h"
+
+#if ENABLE_DISK_TRACE && !defined(IN_UNIT_TESTS)
+
+#include "RTT/SEGGER_RTT.h"
+#include "io/debug/print.h"
+#include "processing/engines/audio_engine.h"
+#include <algorithm>
+
+namespace DiskTrace {
+
+// Must be a power of 2. Card commands are far rarer than allocations, so this lasts a good while between drains
+constexpr uint32_t kNumEntries = 512;
+
+constexpr uint32_t kRTTBufferSize = 256 * sizeof(DiskTraceEntry);
+
+constexpr unsigned kRTTChannel = 2;
+
+DiskTraceEntry entries[kNumEntries];
+uint32_t numWritten = 0; // Both these just keep counting up, and get wrapped when used as indexes
+uint32_t numDrained = 0;
+uint32_t numLost = 0;
+
+char rttBuffer[kRTTBufferSize];
+bool rttConfigured = false;
+
+// Sends as many whole entries as RTT has room for. Ones it can't fit stay in the ring for next time.
+void drain() {
+	if (!rttConfigured) {
+		SEGGER_RTT_ConfigUpBuffer(kRTTChannel, "DiskTrace", rttBuffer, kRTTBufferSize, SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+		rttConfigured = true;
+	}
+
+	uint32_t numCanSend = SEGGER_RTT_GetAvailWriteSpace(kRTTChannel) / sizeof(DiskTraceEntry);
+
+	if (numLost && numCanSend) {
+		DiskTraceEntry lostEntry = {};
+		lostEntry.time = AudioEngine::audioSampleTimer;
+		lostEntry.count = std::min<uint32_t>(numLost, 0xFFFF);
+		lostEntry.event = DISK_TRACE_LOST;
+		SEGGER_RTT_Write(kRTTChannel, &lostEntry, sizeof(lostEntry));
+		numLost = 0;
+		numCanSend--;
+	}
+
+	while (numCanSend && numDrained != numWritten) {
+		// Up to the end of the ring, or of what's been written, whichever comes first
+		uint32_t startIndex = numDrained & (kNumEntries - 1);
+		uint32_t numHere = std::min({numWritten - numDrained, kNumEntries - startIndex, numCanSend});
+		SEGGER_RTT_Write(kRTTChannel, &entries[startIndex], numHere * sizeof(DiskTraceEntry));
+		numDrained += numHere;
+		numCanSend -= numHere;
+	}
+}
+
+} // namespace DiskTrace
+
+using namespace DiskTrace;
+
+extern "C" uint32_t diskTraceBegin(void) {
+	return Debug::readCycleCounter();
+}
+
+extern "C" void diskTraceEnd(uint8_t event, uint32_t sector, uint32_t count, uint32_t startTime, uint8_t result) {
+	uint32_t cycles = Debug::readCycleCounter() - startTime;
+
+	if (numWritten - numDrained >= kNumEntries) {
+		numLost++;
+		return;
+	}
+
+	DiskTraceEntry& entry = entries[numWritten & (kNumEntries - 1)];
+	entry.time = AudioEngine::audioSampleTimer;
+	entry.sector = sector;
+	entry.cycles = cycles;
+	entry.count = count;
+	entry.event = event;
+	entry.result = result;
+	numWritten++;
+}
+
+#endif
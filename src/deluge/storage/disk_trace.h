@@ -0,0 +1,65 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * A record of every read and write diskio.c makes to the SD card, with how long the card took, for getting to the
+ * bottom of cards which stream badly. Only built in with ENABLE_DISK_TRACE (which needs RTT). Like the allocation
+ * trace, entries go into a fixed ring buffer which the main loop drains, as raw DiskTraceEntrys, out over RTT -
+ * up-channel 2 for this one. contrib/debug/disk_trace.py gives the latency distribution of a capture, and can replay
+ * the same pattern of reads against another card. C-compatible, as diskio.c is C.
+ */
+
+enum DiskTraceEvent {
+	DISK_TRACE_READ,
+	DISK_TRACE_WRITE,
+	DISK_TRACE_LOST, // count is how many entries got dropped
+};
+
+struct DiskTraceEntry {
+	uint32_t time;   // In audio samples, when the command finished
+	uint32_t sector;
+	uint32_t cycles; // How long the card took, at 400MHz
+	uint16_t count;  // In sectors
+	uint8_t event;   // A DiskTraceEvent
+	uint8_t result;  // What the SD driver returned - 0 for success
+};
+
+#ifdef __cplusplus
+static_assert(sizeof(DiskTraceEntry) == 16, "disk_trace.py relies on this layout");
+#endif
+
+#if ENABLE_DISK_TRACE && !defined(IN_UNIT_TESTS)
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Call diskTraceBegin() just before the command goes to the card, and diskTraceEnd() with what it gave back after
+uint32_t diskTraceBegin(void);
+void diskTraceEnd(uint8_t event, uint32_t sector, uint32_t count, uint32_t startTime, uint8_t result);
+
+#ifdef __cplusplus
+}
+
+namespace DiskTrace {
+void drain();
+} // namespace DiskTrace
+#endif
+#endif
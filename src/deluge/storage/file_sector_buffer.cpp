@@ -0,0 +1,42 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/file_sector_buffer.h"
+#include "memory/general_memory_allocator.h"
+
+void FileSectorBuffer::attach(FIL* file) {
+#if FF_FS_TINY && FF_FS_PRIVATE_BUF
+	// Whatever had the last one must be long closed by now
+	release();
+
+	buffer = (BYTE*)GeneralMemoryAllocator::get().allocNonAudio(FF_MAX_SS);
+	if (!buffer) {
+		return;
+	}
+
+	if (f_setbuf(file, buffer) != FR_OK) {
+		release();
+	}
+#endif
+}
+
+void FileSectorBuffer::release() {
+	if (buffer) {
+		GeneralMemoryAllocator::get().deallocNonAudio(buffer);
+		buffer = nullptr;
+	}
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+extern "C" {
+#include "fatfs/ff.h"
+}
+
+// With FF_FS_TINY, every open file does its partial-sector reads and writes through the volume's one sector window, so
+// two files being streamed at once - a recording being written while a song's XML is saved, say - keep pushing each
+// other's sector out of it, and writing it back and reading it in again. This gives one file a sector buffer of its
+// own, from the non-audio region, for just as long as it's open.
+class FileSectorBuffer {
+public:
+	~FileSectorBuffer() { release(); }
+
+	// Call straight after opening the file. If there's no RAM to spare, the file just carries on sharing the window
+	void attach(FIL* file);
+
+	// Call once the file's closed - or has been given up on, since a card error can mean it never gets closed
+	void release();
+
+private:
+	BYTE* buffer = nullptr;
+};
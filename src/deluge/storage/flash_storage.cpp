@@ -133,6 +133,127 @@ uint8_t defaultBendRange[2] = {
 SessionLayoutType defaultSessionLayout;
 KeyboardLayoutType defaultKeyboardLayout;
 
+/* The settings live in one 4KB sector of the flash chip. Its first page holds the whole image above, as it always has,
+so older firmware still reads something sensible. The rest of the sector is a journal: saving only appends a record for
+each byte that's changed since the last save, and it's only once the journal's full that the sector gets erased and the
+whole image written afresh. It's the erase which is slow - tens of ms, with the audio kept going by the SPIBSC wait
+routines - whereas programming a few records takes well under one.
+*/
+
+constexpr uint32_t kSettingsSectorAddress = 0x80000 - 0x1000;
+constexpr uint32_t kSettingsSectorSize = 0x1000;
+constexpr uint32_t kSettingsImageSize = 256;
+constexpr uint32_t kFlashPageSize = 256;
+
+struct JournalRecord {
+	uint8_t marker;
+	uint8_t offset;
+	uint8_t value;
+	uint8_t check; // So a record half-programmed when the power went gets ignored
+};
+
+constexpr uint8_t kJournalRecordMarker = 0x5A;
+constexpr int32_t kMaxNumJournalRecords = (kSettingsSectorSize - kSettingsImageSize) / sizeof(JournalRecord);
+
+// How long the settings have to be left alone after a requestWriteSettings() before they're actually saved
+constexpr uint32_t kSettingsQuietTime = 2 * kSampleRate;
+
+uint8_t savedImage[kSettingsImageSize]; // What the flash holds, with the journal applied
+bool savedImageKnown = false;           // If not, the next save erases and starts afresh
+int32_t numJournalRecords;
+
+bool settingsWritePending = false;
+uint32_t timeSettingsWriteRequested;
+
+static uint8_t getJournalCheck(uint8_t offset, uint8_t value) {
+	return ~(kJournalRecordMarker ^ offset ^ value);
+}
+
+static uint32_t getJournalRecordAddress(int32_t r) {
+	return kSettingsSectorAddress + kSettingsImageSize + r * sizeof(JournalRecord);
+}
+
+// Applies the journal to the image in buffer, and notes where the next record will go
+static void replayJournal(uint8_t* buffer) {
+	JournalRecord page[kFlashPageSize / sizeof(JournalRecord)];
+
+	numJournalRecords = 0;
+	while (numJournalRecords < kMaxNumJournalRecords) {
+		R_SFLASH_ByteRead(getJournalRecordAddress(numJournalRecords), (uint8_t*)page, kFlashPageSize, SPIBSC_CH,
+		                  SPIBSC_CMNCR_BSZ_SINGLE, SPIBSC_1BIT, SPIBSC_OUTPUT_ADDR_24);
+
+		for (JournalRecord const& record : page) {
+			if (record.marker == 0xFF && record.offset == 0xFF && record.value == 0xFF && record.check == 0xFF) {
+				return; // Still erased, so this is the end
+			}
+			if (record.marker == kJournalRecordMarker
+			    && record.check == getJournalCheck(record.offset, record.value)) {
+				buffer[record.offset] = record.value;
+			}
+			// A bad one still takes up its space - it can't be programmed over
+			numJournalRecords++;
+		}
+	}
+}
+
+static void eraseAndWriteImage(uint8_t* image) {
+	R_SFLASH_EraseSector(kSettingsSectorAddress, SPIBSC_CH, SPIBSC_CMNCR_BSZ_SINGLE, 1, SPIBSC_OUTPUT_ADDR_24);
+	R_SFLASH_ByteProgram(kSettingsSectorAddress, image, kSettingsImageSize, SPIBSC_CH, SPIBSC_CMNCR_BSZ_SINGLE,
+	                     SPIBSC_1BIT, SPIBSC_OUTPUT_ADDR_24);
+	numJournalRecords = 0;
+}
+
+static void appendToJournal(uint8_t const* image) {
+	JournalRecord page[kFlashPageSize / sizeof(JournalRecord)];
+	int32_t numInPage = 0;
+	uint32_t pageAddress = getJournalRecordAddress(numJournalRecords);
+
+	for (int32_t i = 0; i < kSettingsImageSize; i++) {
+		if (image[i] == savedImage[i]) {
+			continue;
+		}
+		page[numInPage++] = {kJournalRecordMarker, (uint8_t)i, image[i], getJournalCheck(i, image[i])};
+		numJournalRecords++;
+
+		// A page program wraps round to the start of its page rather than carrying on into the next, so each one has to
+		// stop at the end of one
+		uint32_t nextAddress = getJournalRecordAddress(numJournalRecords);
+		if (!(nextAddress & (kFlashPageSize - 1))) {
+			R_SFLASH_ByteProgram(pageAddress, (uint8_t*)page, numInPage * sizeof(JournalRecord), SPIBSC_CH,
+			                     SPIBSC_CMNCR_BSZ_SINGLE, SPIBSC_1BIT, SPIBSC_OUTPUT_ADDR_24);
+			numInPage = 0;
+			pageAddress = nextAddress;
+		}
+	}
+
+	if (numInPage) {
+		R_SFLASH_ByteProgram(pageAddress, (uint8_t*)page, numInPage * sizeof(JournalRecord), SPIBSC_CH,
+		                     SPIBSC_CMNCR_BSZ_SINGLE, SPIBSC_1BIT, SPIBSC_OUTPUT_ADDR_24);
+	}
+}
+
+static void saveImage(uint8_t* image) {
+	int32_t numChanged = 0;
+	if (savedImageKnown) {
+		for (int32_t i = 0; i < kSettingsImageSize; i++) {
+			numChanged += (image[i] != savedImage[i]);
+		}
+		if (!numChanged) {
+			return;
+		}
+	}
+
+	if (savedImageKnown && numJournalRecords + numChanged <= kMaxNumJournalRecords) {
+		appendToJournal(image);
+	}
+	else {
+		eraseAndWriteImage(image);
+	}
+
+	memcpy(savedImage, image, kSettingsImageSize);
+	savedImageKnown = true;
+}
+
 void resetSettings() {
 
 	cvEngine.setCVVoltsPerOctave(0, 100);
@@ -203,8 +324,8 @@ void resetSettings() {
 
 void readSettings() {
 	uint8_t* buffer = (uint8_t*)miscStringBuffer;
-	R_SFLASH_ByteRead(0x80000 - 0x1000, buffer, 256, SPIBSC_CH, SPIBSC_CMNCR_BSZ_SINGLE, SPIBSC_1BIT,
-	                  SPIBSC_OUTPUT_ADDR_24);
+	R_SFLASH_ByteRead(kSettingsSectorAddress, buffer, kSettingsImageSize, SPIBSC_CH, SPIBSC_CMNCR_BSZ_SINGLE,
+	                  SPIBSC_1BIT, SPIBSC_OUTPUT_ADDR_24);
 
 	settingsBeenRead = true;
 
@@ -216,6 +337,11 @@ void readSettings() {
 		return;
 	}
 
+	replayJournal(buffer);
+	memcpy(savedImage, buffer, kSettingsImageSize);
+	savedImageKnown = true;
+	previouslySavedByFirmwareVersion = buffer[0];
+
 	ramSize = buffer[2];
 
 	cvEngine.setCVVoltsPerOctave(0, buffer[12]);
@@ -495,9 +621,20 @@ void writeSettings() {
 	buffer[117] = util::to_underlying(defaultSessionLayout);
 	buffer[118] = util::to_underlying(defaultKeyboardLayout);
 
-	R_SFLASH_EraseSector(0x80000 - 0x1000, SPIBSC_CH, SPIBSC_CMNCR_BSZ_SINGLE, 1, SPIBSC_OUTPUT_ADDR_24);
-	R_SFLASH_ByteProgram(0x80000 - 0x1000, buffer, 256, SPIBSC_CH, SPIBSC_CMNCR_BSZ_SINGLE, SPIBSC_1BIT,
-	                     SPIBSC_OUTPUT_ADDR_24);
+	settingsWritePending = false;
+	saveImage(buffer);
+}
+
+void requestWriteSettings() {
+	settingsWritePending = true;
+	timeSettingsWriteRequested = AudioEngine::audioSampleTimer;
+}
+
+void routine() {
+	if (settingsWritePending
+	    && (uint32_t)(AudioEngine::audioSampleTimer - timeSettingsWriteRequested) >= kSettingsQuietTime) {
+		writeSettings();
+	}
 }
 
 } // namespace FlashStorage
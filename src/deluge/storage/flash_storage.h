@@ -44,4 +44,8 @@ void readSettings();
 void writeSettings();
 void resetSettings();
 
+/// Saves the settings once they've been left alone for a couple of seconds, so a run of tweaks only gets saved the once
+void requestWriteSettings();
+void routine();
+
 } // namespace FlashStorage
@@ -0,0 +1,475 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "storage/folder_index.h"
+#include "definitions_cxx.hpp"
+#include "io/debug/print.h"
+#include "memory/general_memory_allocator.h"
+#include "processing/engines/audio_engine.h"
+#include "storage/audio/audio_file_manager.h"
+#include "storage/storage_manager.h"
+#include "util/container/array/c_string_array.h"
+#include "util/functions.h"
+#include <string.h>
+
+FolderIndex folderIndex{};
+
+// File layout, all little-endian:
+//   header: 'DIDX', uint16 version, uint16 folder date, uint16 folder time, uint16 flags
+//   each entry: uint32 sclust, uint32 objsize, uint8 flags, uint8 name length, then the name and a 0 terminator
+//   end: an entry header with a name length of 0
+//   if sorted: uint32 offset from the start of the file of each entry, then uint32 number of entries
+constexpr uint32_t kFolderIndexMagic = 0x58444944; // "DIDX"
+constexpr uint16_t kFolderIndexVersion = 2;
+constexpr int32_t kHeaderSize = 12;
+constexpr int32_t kEntryHeaderSize = 10;
+constexpr uint8_t kEntryFlagIsFolder = 1;
+constexpr uint16_t kIndexFlagSorted = 1;
+constexpr uint16_t kIndexFlagNoteNames = 2; // Sorted with shouldInterpretNoteNames set
+
+// Once we're jumping about, there's no point reading a whole cluster to get at each entry
+constexpr int32_t kSeekReadSize = 512;
+
+int32_t FolderIndex::getIndexPath(String* indexPath, char const* folderPath, int32_t folderPathLength) {
+	int32_t error = indexPath->set(folderPath, folderPathLength);
+	if (error) {
+		return error;
+	}
+	error = indexPath->concatenate("/" FOLDER_INDEX_FILENAME);
+	return error;
+}
+
+bool FolderIndex::openForReading(char const* folderPath) {
+	readFailed = false;
+
+	// The root can't be stat()ed, so we've got no date to check an index against
+	if (!*folderPath) {
+		return false;
+	}
+
+	FRESULT result = f_stat(folderPath, &staticFNO);
+	if (result != FR_OK) {
+		return false;
+	}
+
+	String indexPath;
+	if (getIndexPath(&indexPath, folderPath, strlen(folderPath))) {
+		return false;
+	}
+
+	result = f_open(&indexFile, indexPath.get(), FA_READ);
+	if (result != FR_OK) {
+		return false;
+	}
+	reading = true;
+
+	bufferPos = 0;
+	bufferEnd = 0;
+	readSize = audioFileManager.clusterSize;
+	numEntries = 0;
+	nextEntryIndex = 0;
+
+	uint32_t magic;
+	uint16_t version, date, time;
+	if (!readBytes(&magic, 4) || !readBytes(&version, 2) || !readBytes(&date, 2) || !readBytes(&time, 2)
+	    || !readBytes(&flags, 2) || magic != kFolderIndexMagic || version != kFolderIndexVersion
+	    || date != staticFNO.fdate || time != staticFNO.ftime) {
+		finishReading();
+		return false;
+	}
+
+	return true;
+}
+
+// Call straight after openForReading()
+bool FolderIndex::isSortedFor(bool interpretNoteNames) {
+	if (!(flags & kIndexFlagSorted) || (bool)(flags & kIndexFlagNoteNames) != interpretNoteNames) {
+		return false;
+	}
+
+	// The number of entries is right at the end, after the table of where they start
+	uint32_t size = f_size(&indexFile);
+	uint32_t count;
+	UINT bytesRead;
+	if (size < kHeaderSize + kEntryHeaderSize + 4 || f_lseek(&indexFile, size - 4) != FR_OK
+	    || f_read(&indexFile, &count, 4, &bytesRead) != FR_OK || bytesRead != 4
+	    || count > (size - kHeaderSize - kEntryHeaderSize - 4) >> 2) {
+		// Carry on from the start of the entries, as if nothing happened
+		bufferPos = 0;
+		bufferEnd = 0;
+		f_lseek(&indexFile, kHeaderSize);
+		return false;
+	}
+
+	numEntries = count;
+	entryTableStart = size - 4 - (count << 2);
+	return seekToEntry(0);
+}
+
+bool FolderIndex::seekToEntry(int32_t i) {
+	uint32_t entryStart;
+	if (i >= numEntries) {
+		i = numEntries;
+		entryStart = entryTableStart - kEntryHeaderSize; // The end marker
+	}
+	else {
+		UINT bytesRead;
+		if (f_lseek(&indexFile, entryTableStart + (i << 2)) != FR_OK
+		    || f_read(&indexFile, &entryStart, 4, &bytesRead) != FR_OK || bytesRead != 4) {
+			goto failed;
+		}
+	}
+
+	if (f_lseek(&indexFile, entryStart) != FR_OK) {
+failed:
+		readFailed = true;
+		finishReading();
+		return false;
+	}
+
+	bufferPos = 0;
+	bufferEnd = 0;
+	readSize = kSeekReadSize;
+	nextEntryIndex = i;
+	return true;
+}
+
+int32_t FolderIndex::findEntry(char const* name) {
+	int32_t rangeBegin = 0;
+	int32_t rangeEnd = numEntries;
+
+	while (rangeBegin != rangeEnd) {
+		int32_t proposedIndex = rangeBegin + ((rangeEnd - rangeBegin) >> 1);
+
+		bool isFolder;
+		FilePointer filePointer;
+		if (!seekToEntry(proposedIndex)) {
+			return -1;
+		}
+		char const* nameHere = readEntry(&isFolder, &filePointer);
+		if (!nameHere) {
+			return -1;
+		}
+
+		if (strcmpspecial(nameHere, name) < 0) {
+			rangeBegin = proposedIndex + 1;
+		}
+		else {
+			rangeEnd = proposedIndex;
+		}
+	}
+
+	return rangeBegin;
+}
+
+char const* FolderIndex::readEntry(bool* isFolder, FilePointer* filePointer) {
+	uint32_t sclust, objsize;
+	uint8_t entryFlags, nameLength;
+	if (!readBytes(&sclust, 4) || !readBytes(&objsize, 4) || !readBytes(&entryFlags, 1)
+	    || !readBytes(&nameLength, 1)) {
+		goto failed;
+	}
+
+	// End marker
+	if (!nameLength) {
+		finishReading();
+		return NULL;
+	}
+
+	if (!readBytes(entryName, nameLength + 1) || entryName[nameLength]) {
+		goto failed;
+	}
+
+	filePointer->sclust = sclust;
+	filePointer->objsize = objsize;
+	*isFolder = entryFlags & kEntryFlagIsFolder;
+	nextEntryIndex++;
+	return entryName;
+
+failed:
+	// Including if the file ended before the end marker - so it wasn't finished being written
+	Debug::println("folder index unreadable");
+	readFailed = true;
+	finishReading();
+	return NULL;
+}
+
+void FolderIndex::finishReading() {
+	if (reading) {
+		f_close(&indexFile);
+		reading = false;
+	}
+}
+
+bool FolderIndex::readBytes(void* dest, int32_t numBytes) {
+	while (numBytes) {
+		if (bufferPos == bufferEnd) {
+			UINT bytesRead;
+			FRESULT result =
+			    f_read(&indexFile, storageManager.fileClusterBuffer, readSize, &bytesRead);
+			if (result != FR_OK || !bytesRead) {
+				return false;
+			}
+			bufferPos = 0;
+			bufferEnd = bytesRead;
+		}
+
+		int32_t numBytesNow = std::min<int32_t>(numBytes, bufferEnd - bufferPos);
+		memcpy(dest, &storageManager.fileClusterBuffer[bufferPos], numBytesNow);
+		dest = (char*)dest + numBytesNow;
+		bufferPos += numBytesNow;
+		numBytes -= numBytesNow;
+	}
+	return true;
+}
+
+void FolderIndex::beginWriting(char const* folderPath, bool newAlwaysIndex) {
+	writing = false;
+	fileCreated = false;
+	alwaysIndex = newAlwaysIndex;
+
+	if (!*folderPath) {
+		return;
+	}
+
+	FRESULT result = f_stat(folderPath, &staticFNO);
+	if (result != FR_OK) {
+		return;
+	}
+
+	if (getIndexPath(&indexPath, folderPath, strlen(folderPath))) {
+		return;
+	}
+
+	writing = true;
+	bufferPos = 0;
+
+	uint32_t magic = kFolderIndexMagic;
+	uint16_t version = kFolderIndexVersion;
+	uint16_t unsortedFlags = 0;
+	writeBytes(&magic, 4);
+	writeBytes(&version, 2);
+	writeBytes(&staticFNO.fdate, 2);
+	writeBytes(&staticFNO.ftime, 2);
+	writeBytes(&unsortedFlags, 2);
+}
+
+void FolderIndex::writeEntry(char const* name, bool isFolder, FilePointer* filePointer) {
+	if (!writing) {
+		return;
+	}
+
+	int32_t nameLength = strlen(name);
+	if (!nameLength || nameLength > 255) { // Shouldn't happen
+		discard();
+		return;
+	}
+
+	uint8_t entryFlags = isFolder ? kEntryFlagIsFolder : 0;
+	uint8_t nameLengthByte = nameLength;
+	writeBytes(&filePointer->sclust, 4);
+	writeBytes(&filePointer->objsize, 4);
+	writeBytes(&entryFlags, 1);
+	writeBytes(&nameLengthByte, 1);
+	writeBytes(name, nameLength + 1);
+}
+
+void FolderIndex::writeBytes(void const* source, int32_t numBytes) {
+	while (numBytes && writing) {
+		if (bufferPos == audioFileManager.clusterSize) {
+			if (!flushWriteBuffer()) {
+				discard();
+				return;
+			}
+		}
+
+		int32_t numBytesNow = std::min<int32_t>(numBytes, audioFileManager.clusterSize - bufferPos);
+		memcpy(&storageManager.fileClusterBuffer[bufferPos], source, numBytesNow);
+		source = (char const*)source + numBytesNow;
+		bufferPos += numBytesNow;
+		numBytes -= numBytesNow;
+	}
+}
+
+// The file only gets created the first time we flush the buffer - normally once it's full
+bool FolderIndex::flushWriteBuffer() {
+	if (!fileCreated) {
+		FRESULT result = f_open(&indexFile, indexPath.get(), FA_CREATE_ALWAYS | FA_WRITE);
+		if (result != FR_OK) {
+			return false; // E.g. card is write protected. Not a problem - we just don't get an index
+		}
+		fileCreated = true;
+	}
+
+	UINT bytesWritten;
+	FRESULT result = f_write(&indexFile, storageManager.fileClusterBuffer, bufferPos, &bytesWritten);
+	if (result != FR_OK || bytesWritten != bufferPos) {
+		return false;
+	}
+	bufferPos = 0;
+	return true;
+}
+
+void FolderIndex::finishWriting(bool scanCompleted) {
+	if (!writing) {
+		return;
+	}
+
+	if (!scanCompleted || (!fileCreated && !alwaysIndex)) {
+		discard();
+		return;
+	}
+
+	uint8_t endMarker[kEntryHeaderSize] = {0};
+	writeBytes(endMarker, kEntryHeaderSize);
+	if (!writing) {
+		return; // Already discarded
+	}
+
+	if (!flushWriteBuffer() || f_close(&indexFile) != FR_OK) {
+		discard();
+		return;
+	}
+
+	writing = false;
+	fileCreated = false;
+
+	sort();
+}
+
+// Reads the whole index back in and writes it out again in order, followed by where each entry now starts. This
+// only happens when a folder's been scanned, so it's worth the one big sort to not have to sort bits of it again every
+// time the Browser moves about in it. If there's not the RAM, or anything goes wrong, the index stays unsorted, and
+// still works as one.
+void FolderIndex::sort() {
+	FRESULT result = f_open(&indexFile, indexPath.get(), FA_READ);
+	if (result != FR_OK) {
+		return;
+	}
+
+	uint32_t size = f_size(&indexFile);
+	char* contents = (char*)GeneralMemoryAllocator::get().alloc(size);
+	if (!contents) {
+		f_close(&indexFile);
+		return;
+	}
+
+	UINT bytesRead;
+	result = f_read(&indexFile, contents, size, &bytesRead);
+	f_close(&indexFile);
+	if (result == FR_OK && bytesRead == size) {
+		writeSorted(contents, size);
+	}
+
+	GeneralMemoryAllocator::get().dealloc(contents);
+}
+
+void FolderIndex::writeSorted(char const* contents, uint32_t size) {
+	// Each element is the entry's name, which is what gets sorted on, then where the entry starts in contents
+	CStringArray entries(sizeof(char const*) + sizeof(uint32_t));
+
+	uint32_t pos = kHeaderSize;
+	while (true) {
+		if (pos + kEntryHeaderSize > size) {
+			return;
+		}
+		uint8_t nameLength = contents[pos + kEntryHeaderSize - 1];
+		if (!nameLength) {
+			break;
+		}
+		if (pos + kEntryHeaderSize + nameLength + 1 > size) {
+			return;
+		}
+
+		int32_t i = entries.getNumElements();
+		if (entries.insertAtIndex(i)) {
+			return;
+		}
+		char const** element = (char const**)entries.getElementAddress(i);
+		*element = &contents[pos + kEntryHeaderSize];
+		*(uint32_t*)(element + 1) = pos;
+		pos += kEntryHeaderSize + nameLength + 1;
+
+		if (!(i & 255)) {
+			AudioEngine::routineWithClusterLoading();
+		}
+	}
+
+	entries.sortForStrings();
+	AudioEngine::routineWithClusterLoading();
+
+	writing = true;
+	bufferPos = 0;
+
+	// Same header as before, but saying we're sorted
+	uint16_t sortedFlags = kIndexFlagSorted | (shouldInterpretNoteNames ? kIndexFlagNoteNames : 0);
+	writeBytes(contents, kHeaderSize - 2);
+	writeBytes(&sortedFlags, 2);
+
+	uint32_t newPos = kHeaderSize;
+	for (int32_t i = 0; i < entries.getNumElements(); i++) {
+		char const** element = (char const**)entries.getElementAddress(i);
+		uint32_t* entryStart = (uint32_t*)(element + 1);
+		uint32_t entrySize = kEntryHeaderSize + (uint8_t)contents[*entryStart + kEntryHeaderSize - 1] + 1;
+		writeBytes(&contents[*entryStart], entrySize);
+		*entryStart = newPos; // Now it's where it starts in the new file
+		newPos += entrySize;
+	}
+
+	uint8_t endMarker[kEntryHeaderSize] = {0};
+	writeBytes(endMarker, kEntryHeaderSize);
+
+	for (int32_t i = 0; i < entries.getNumElements(); i++) {
+		char const** element = (char const**)entries.getElementAddress(i);
+		writeBytes(element + 1, 4);
+	}
+	uint32_t numEntriesWritten = entries.getNumElements();
+	writeBytes(&numEntriesWritten, 4);
+
+	if (!writing) {
+		return; // Already discarded
+	}
+	if (!flushWriteBuffer() || f_close(&indexFile) != FR_OK) {
+		discard();
+		return;
+	}
+
+	writing = false;
+	fileCreated = false;
+}
+
+void FolderIndex::discard() {
+	writing = false;
+	if (fileCreated) {
+		f_close(&indexFile);
+		f_unlink(indexPath.get());
+		fileCreated = false;
+	}
+}
+
+void FolderIndex::folderChanged(char const* filePath) {
+	char const* slashPos = strrchr(filePath, '/');
+	if (!slashPos || slashPos == filePath) {
+		return; // In the root, which never gets an index
+	}
+
+	String path;
+	if (getIndexPath(&path, filePath, slashPos - filePath)) {
+		return;
+	}
+	f_unlink(path.get()); // Will usually fail because there's no index. No problem
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "util/d_string.h"
+#include <cstdint>
+
+extern "C" {
+#include "fatfs/ff.h"
+}
+
+#define FOLDER_INDEX_FILENAME ".deluge_index"
+
+/// A listing of a big folder, saved to the card inside that folder. It holds every entry's name, whether it's a folder,
+/// and its FilePointer. Reading it back takes a few long reads, where f_readdir() would go through the directory table
+/// one sector at a time and piece each long filename together from several entries.
+///
+/// An index is only trusted while the folder's modification date and time match the ones recorded when it was written.
+/// FatFs doesn't update those when *we* change the folder, so anything here that creates, deletes or renames a file
+/// must call folderChanged() too.
+///
+/// Once the scan's been written, the index gets rewritten in strcmpspecial() order with a table of where each entry
+/// starts, so a Browser can look up where it is in the folder and read just the entries around that, rather than the
+/// whole listing.
+///
+/// Only one index is read or written at a time, using storageManager.fileClusterBuffer, so it mustn't be used while a
+/// file is being read or written through the StorageManager.
+class FolderIndex {
+public:
+	/// Returns true if there's a valid index for this folder. If so, call readEntry() until it returns NULL.
+	bool openForReading(char const* folderPath);
+	/// Returns the entry's name, or NULL once there are no more. If that was because of an error, readFailed gets set
+	/// and everything read so far should be discarded.
+	char const* readEntry(bool* isFolder, FilePointer* filePointer);
+	/// Call when done reading, whether or not readEntry() got to the end.
+	void finishReading();
+
+	/// Whether the open index is sorted the way strcmpspecial() would sort it with shouldInterpretNoteNames set as given.
+	/// If so, the following can be used to move around in it.
+	bool isSortedFor(bool interpretNoteNames);
+	int32_t getNumEntries() { return numEntries; }
+	/// Makes entry i the next one readEntry() returns. i may be getNumEntries(), to be at the end.
+	bool seekToEntry(int32_t i);
+	/// Returns the number of the first entry not before name, or -1 if reading failed, in which case readFailed is set.
+	/// You must set shouldInterpretNoteNames and octaveStartsFromA before calling this.
+	int32_t findEntry(char const* name);
+	/// The number of the entry readEntry() will return next.
+	int32_t getNextEntryIndex() { return nextEntryIndex; }
+
+	/// Call before scanning the folder with f_readdir(), then pass each entry to writeEntry(), then call
+	/// finishWriting(). Unless alwaysIndex, no file gets created unless the listing grows past one buffer's worth -
+	/// small folders are quick enough to scan once. Preset folders get rescanned on every step through their presets
+	/// though, so those are always worth it.
+	void beginWriting(char const* folderPath, bool alwaysIndex = false);
+	void writeEntry(char const* name, bool isFolder, FilePointer* filePointer);
+	/// Pass false if the scan didn't get to the end of the folder, and any partial index will be deleted. The index gets
+	/// sorted using strcmpspecial(), so you must set shouldInterpretNoteNames and octaveStartsFromA before calling this.
+	void finishWriting(bool scanCompleted);
+
+	/// Call after creating, deleting or renaming anything at filePath, so the index of the folder it's in gets thrown
+	/// away.
+	static void folderChanged(char const* filePath);
+
+	bool readFailed;
+
+private:
+	static int32_t getIndexPath(String* indexPath, char const* folderPath, int32_t folderPathLength);
+	bool readBytes(void* dest, int32_t numBytes);
+	void writeBytes(void const* source, int32_t numBytes);
+	bool flushWriteBuffer();
+	void discard();
+	void sort();
+	void writeSorted(char const* contents, uint32_t size);
+
+	FIL indexFile;
+	String indexPath; // Of the index being written
+	bool reading;      // Whether indexFile is open for reading
+	bool writing;      // Whether we still intend to write an index
+	bool fileCreated;  // Whether indexFile has actually been created yet
+	bool alwaysIndex;
+	int32_t bufferPos; // Position in storageManager.fileClusterBuffer
+	int32_t bufferEnd; // When reading, how much of the buffer is valid
+	int32_t readSize;  // How much to read at a time - less once we're seeking about
+	uint16_t flags;
+	int32_t numEntries;         // Only valid if sorted
+	uint32_t entryTableStart;   // Only valid if sorted
+	int32_t nextEntryIndex;
+	char entryName[FF_MAX_LFN + 1];
+};
+
+extern FolderIndex folderIndex;
@@ -0,0 +1,229 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/performance_report.h"
+#include "io/debug/cpu_profiler.h"
+#include "io/debug/print.h"
+#include "memory/general_memory_allocator.h"
+#include "model/output.h"
+#include "model/settings/runtime_feature_settings.h"
+#include "model/song/song.h"
+#include "playback/playback_handler.h"
+#include "processing/engines/audio_engine.h"
+#include "storage/folder_index.h"
+#include "util/functions.h"
+#include <algorithm>
+#include <string.h>
+
+extern "C" {
+#include "fatfs/ff.h"
+}
+
+PerformanceReport performanceReport{};
+
+constexpr int32_t kMaxOutputNameLength = 40;
+
+static char* append(char* pos, char const* string) {
+	strcpy(pos, string);
+	return pos + strlen(pos);
+}
+
+static char* appendNumber(char* pos, int32_t number) {
+	intToString(number, pos);
+	return pos + strlen(pos);
+}
+
+// e.g. "87.3%"
+static char* appendPercent(char* pos, int32_t permille) {
+	pos = appendNumber(pos, permille / 10);
+	*(pos++) = '.';
+	pos = appendNumber(pos, permille % 10);
+	return append(pos, "%");
+}
+
+bool PerformanceReport::getPath(Song* song, char* path) {
+	char const* dir = song->dirPath.get();
+	char const* name = song->name.get();
+	// A song that's never been saved has nowhere for its report to go
+	if (!*name || strlen(dir) + strlen(name) + 10 >= sizeof(PerformanceReport::path)) {
+		return false;
+	}
+	strcpy(path, dir);
+	strcat(path, "/");
+	strcat(path, name);
+	strcat(path, " PERF.TXT");
+	return true;
+}
+
+void PerformanceReport::beginSession() {
+	if (runtimeFeatureSettings.get(RuntimeFeatureSettingType::PerformanceReports) != RuntimeFeatureStateToggle::On
+	    || !currentSong) {
+		return;
+	}
+
+	for (Output* output = currentSong->firstOutput; output; output = output->next) {
+		output->renderCycles = 0;
+	}
+	AudioEngine::voiceStats.maxVoicesInUseThisSession = AudioEngine::getNumVoices();
+
+	startTime = AudioEngine::audioSampleTimer;
+	numCullsAtStart = AudioEngine::voiceStats.getNumCulls();
+	numLateClustersAtStart = AudioEngine::voiceStats.numClusterUnderruns;
+	numUnderrunsAtStart = Debug::cpuProfiler.getNumUnderruns();
+	peakLoadPermille = 0;
+	totalLoadPermille = 0;
+	numLoadSamples = 0;
+	peakBytesInUse = 0;
+	active = true;
+}
+
+void PerformanceReport::sample() {
+	int32_t loadPermille = Debug::cpuProfiler.getLoadPermille(Debug::ProfileStage::TOTAL);
+	peakLoadPermille = std::max(peakLoadPermille, loadPermille);
+	totalLoadPermille += loadPermille;
+	numLoadSamples++;
+
+	// What's neither free nor able to be stolen back - sample data that's just cached doesn't count
+	MemoryRegion& region = GeneralMemoryAllocator::get().regions[MEMORY_REGION_SDRAM];
+	MemoryRegionTelemetry telemetry;
+	region.getTelemetry(&telemetry);
+	uint32_t bytesInUse = (region.end - region.start) - telemetry.freeBytes;
+	for (int32_t q = 0; q < NUM_STEALABLE_QUEUES; q++) {
+		bytesInUse -= telemetry.stealableBytes[q];
+	}
+	peakBytesInUse = std::max(peakBytesInUse, bytesInUse);
+}
+
+void PerformanceReport::endSession() {
+	if (!active) {
+		return;
+	}
+	active = false;
+
+	uint32_t numSamples = AudioEngine::audioSampleTimer - startTime;
+	// Anything shorter than a load window has nothing to say, and is probably just the user checking something
+	if (!numLoadSamples || !getPath(currentSong, path)) {
+		return;
+	}
+
+	// e.g.
+	//   song SONG001
+	//   played 30m 34s
+	//   engine live
+	//   load peak 87.3% mean 54.1%
+	//   voices max 43 culled 12
+	//   late clusters 3 xruns 0
+	//   memory peak 21480KB
+	//   slowest outputs
+	//   SYNTH 3 12.3%
+	char* pos = append(text, "song ");
+	pos = append(pos, currentSong->name.get());
+	pos = append(pos, "\nplayed ");
+	uint32_t numSeconds = numSamples / kSampleRate;
+	pos = appendNumber(pos, numSeconds / 60);
+	pos = append(pos, "m ");
+	pos = appendNumber(pos, numSeconds % 60);
+	pos = append(pos, "s\nengine ");
+	pos = append(pos,
+	             RuntimeFeatureSettings::getEngineProfileName(runtimeFeatureSettings.getActiveEngineProfile()).data());
+	pos = append(pos, "\nload peak ");
+	pos = appendPercent(pos, peakLoadPermille);
+	pos = append(pos, " mean ");
+	pos = appendPercent(pos, totalLoadPermille / numLoadSamples);
+	pos = append(pos, "\nvoices max ");
+	pos = appendNumber(pos, AudioEngine::voiceStats.maxVoicesInUseThisSession);
+	pos = append(pos, " culled ");
+	pos = appendNumber(pos, AudioEngine::voiceStats.getNumCulls() - numCullsAtStart);
+	pos = append(pos, "\nlate clusters ");
+	pos = appendNumber(pos, AudioEngine::voiceStats.numClusterUnderruns - numLateClustersAtStart);
+	pos = append(pos, " xruns ");
+	pos = appendNumber(pos, Debug::cpuProfiler.getNumUnderruns() - numUnderrunsAtStart);
+	pos = append(pos, "\nmemory peak ");
+	pos = appendNumber(pos, peakBytesInUse >> 10);
+	pos = append(pos, "KB\nslowest outputs\n");
+
+	// Each output's share of the real-time budget, slowest first
+	uint64_t sessionCycles = (uint64_t)numSamples * Debug::kCyclesPerSample;
+	Output* listed[kNumPerformanceReportOutputs] = {nullptr};
+	for (int32_t i = 0; i < kNumPerformanceReportOutputs; i++) {
+		Output* slowest = nullptr;
+		for (Output* output = currentSong->firstOutput; output; output = output->next) {
+			if (output->renderCycles && (!slowest || output->renderCycles > slowest->renderCycles)
+			    && std::find(listed, listed + i, output) == listed + i) {
+				slowest = output;
+			}
+		}
+		if (!slowest) {
+			break;
+		}
+		listed[i] = slowest;
+
+		char const* name = slowest->name.get();
+		if (!*name) {
+			name = slowest->getXMLTag();
+		}
+		int32_t nameLength = std::min<int32_t>(strlen(name), kMaxOutputNameLength);
+		memcpy(pos, name, nameLength);
+		pos += nameLength;
+		*(pos++) = ' ';
+		pos = appendPercent(pos, (int32_t)(slowest->renderCycles * 1000 / sessionCycles));
+		*(pos++) = '\n';
+	}
+
+	textLength = pos - text;
+}
+
+void PerformanceReport::routine() {
+	if (active && playbackHandler.isEitherClockActive()) {
+		sample();
+	}
+	if (textLength) {
+		write();
+	}
+}
+
+void PerformanceReport::write() {
+	FIL file;
+	if (f_open(&file, path, FA_CREATE_ALWAYS | FA_WRITE) == FR_OK) {
+		UINT bytesWritten;
+		f_write(&file, text, textLength, &bytesWritten);
+		f_close(&file);
+		FolderIndex::folderChanged(path);
+	}
+	else {
+		Debug::print("couldn't write ");
+		Debug::println(path);
+	}
+	textLength = 0;
+}
+
+bool PerformanceReport::read(Song* song, char* buffer, int32_t bufferSize) {
+	char reportPath[sizeof(PerformanceReport::path)];
+	if (!getPath(song, reportPath)) {
+		return false;
+	}
+
+	FIL file;
+	if (f_open(&file, reportPath, FA_READ) != FR_OK) {
+		return false;
+	}
+	UINT bytesRead = 0;
+	FRESULT result = f_read(&file, buffer, bufferSize - 1, &bytesRead);
+	f_close(&file);
+	buffer[bytesRead] = 0;
+	return (result == FR_OK && bytesRead);
+}
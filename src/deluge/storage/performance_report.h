@@ -0,0 +1,74 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+class Song;
+
+/*
+ * With the Performance Reports community setting on, each stretch of playback - from play to stop, or to a song swap -
+ * gets summed up in a text file next to the song's own, called e.g. SONGS/SONG001 PERF.TXT: how long it played, the
+ * engine profile it ended on, its peak and mean render load, the most voices it had going, how many got culled, how
+ * often samples or the audio output ran late, the most memory it had in use that couldn't just be given back, and which
+ * outputs took longest to render. So songs can be checked for how hard they pushed things once the show's over. Each
+ * stretch replaces the last one's report. SETTINGS > PERF REPORT shows the current song's.
+ *
+ * Load and memory are sampled once a second from the main loop - so a peak is the worst one-second window, not the
+ * worst single render - while voices, culls and the rest are counted where they happen.
+ */
+
+constexpr int32_t kMaxPerformanceReportSize = 1024;
+constexpr int32_t kNumPerformanceReportOutputs = 5; // The slowest this many get listed
+
+class PerformanceReport {
+public:
+	/// Call once playback's started, or the song's been swapped during it
+	void beginSession();
+
+	/// Call when playback stops, or currentSong's about to be swapped out, while it's still currentSong
+	void endSession();
+
+	/// Call about once a second from the main loop. Samples load and memory while playing, and writes any report
+	/// that's finished
+	void routine();
+
+	/// Reads the song's report off the card into buffer, null-terminated. Returns false if there isn't one
+	static bool read(Song* song, char* buffer, int32_t bufferSize);
+
+private:
+	void sample();
+	void write();
+	static bool getPath(Song* song, char* path);
+
+	bool active = false;
+	uint32_t startTime;        // In audioSampleTimer terms
+	uint32_t numCullsAtStart;  // These four are all counted since startup, so we keep where they were when we began
+	uint32_t numLateClustersAtStart;
+	uint32_t numUnderrunsAtStart;
+	int32_t peakLoadPermille;
+	uint32_t totalLoadPermille;
+	uint32_t numLoadSamples;
+	uint32_t peakBytesInUse;
+
+	char text[kMaxPerformanceReportSize]; // A finished report, waiting for routine() to write it
+	char path[256];
+	int32_t textLength = 0;
+};
+
+extern PerformanceReport performanceReport;
@@ -0,0 +1,366 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/session_snapshot.h"
+#include "definitions_cxx.hpp"
+#include "gui/ui/browser/browser.h"
+#include "gui/ui/load/load_song_ui.h"
+#include "io/debug/print.h"
+#include "memory/general_memory_allocator.h"
+#include "model/sample/sample.h"
+#include "model/settings/runtime_feature_settings.h"
+#include "playback/playback_handler.h"
+#include "storage/audio/audio_file_manager.h"
+#include "storage/cluster/cluster.h"
+#include "storage/folder_index.h"
+#include "storage/storage_manager.h"
+#include <algorithm>
+#include <string.h>
+
+extern "C" {
+#include "fatfs/ff.h"
+}
+
+SessionSnapshot sessionSnapshot{};
+
+// Layout, all little-endian:
+//   header: 'DSNP', uint16 version, uint16 song path length, uint16 song file date, uint16 song file time,
+//           uint32 song file size, uint32 number of Samples, uint32 number of Clusters
+//   then the song's path
+//   then for each Sample: uint16 path length, uint16 number of Clusters, the path, then each Cluster's index
+// The magic number only gets written once everything else has, so a half-written snapshot never gets used.
+constexpr uint32_t kSessionSnapshotMagic = 0x504E5344; // "DSNP"
+constexpr uint16_t kSessionSnapshotVersion = 1;
+constexpr int32_t kSessionSnapshotHeaderSize = 24;
+constexpr int32_t kSessionSnapshotMaxPathLength = 255;
+
+// Not much point remembering more than there'd be room for, or taking forever to read it all back in
+constexpr int32_t kMaxNumSnapshotClusters = 2048;
+constexpr uint32_t kMaxWarmListSize = 64 * 1024;
+
+constexpr int32_t kNumClustersPerWarm = 4;
+
+// Warming stops rather than take any more from this, so it never pushes out anything the song's actually using
+constexpr uint32_t kWarmingRAMFloor = 4 * 1024 * 1024;
+
+static bool writeAll(FIL* file, void const* data, UINT length) {
+	UINT bytesWritten;
+	return f_write(file, data, length, &bytesWritten) == FR_OK && bytesWritten == length;
+}
+
+static bool readAll(FIL* file, void* data, UINT length) {
+	UINT bytesRead;
+	return f_read(file, data, length, &bytesRead) == FR_OK && bytesRead == length;
+}
+
+void SessionSnapshot::write(char const* songFilePath) {
+	if (runtimeFeatureSettings.get(RuntimeFeatureSettingType::ResumeLastSong) != RuntimeFeatureStateToggle::On) {
+		return;
+	}
+
+	uint16_t songPathLength = strlen(songFilePath);
+	if (songPathLength > kSessionSnapshotMaxPathLength || f_stat(songFilePath, &staticFNO) != FR_OK) {
+		return;
+	}
+
+	FIL file;
+	if (f_open(&file, kSessionSnapshotPath, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK) {
+		return;
+	}
+
+	char header[kSessionSnapshotHeaderSize] = {};
+	uint32_t numSamples = 0;
+	int32_t numClusters = 0;
+
+	// The header gets filled in at the end
+	if (!writeAll(&file, header, kSessionSnapshotHeaderSize) || !writeAll(&file, songFilePath, songPathLength)) {
+		goto fail;
+	}
+
+	for (int32_t e = 0; e < audioFileManager.audioFiles.getNumElements(); e++) {
+		AudioFile* audioFile = (AudioFile*)audioFileManager.audioFiles.getElement(e);
+
+		// Only the current song's Samples, and not any recording that hasn't got its real file yet
+		if (audioFile->type != AudioFileType::SAMPLE || !audioFile->numReasonsToBeLoaded) {
+			continue;
+		}
+		Sample* sample = (Sample*)audioFile;
+		if (sample->unloadable || !sample->tempFilePathForRecording.isEmpty()
+		    || sample->filePath.getLength() > kSessionSnapshotMaxPathLength) {
+			continue;
+		}
+
+		uint16_t sampleNumClusters = 0;
+		int32_t numSampleClusters = sample->clusters.getNumElements();
+		for (int32_t c = 0; c < numSampleClusters && numClusters + sampleNumClusters < kMaxNumSnapshotClusters; c++) {
+			Cluster* cluster = sample->clusters.getElement(c)->cluster;
+			if (cluster && cluster->loaded) {
+				sampleNumClusters++;
+			}
+		}
+		if (!sampleNumClusters) {
+			continue;
+		}
+
+		uint16_t entryHeader[2] = {(uint16_t)sample->filePath.getLength(), sampleNumClusters};
+		if (!writeAll(&file, entryHeader, sizeof(entryHeader))
+		    || !writeAll(&file, sample->filePath.get(), entryHeader[0])) {
+			goto fail;
+		}
+
+		// The audio routine could steal one while we're writing, so just stop at as many as we counted
+		uint32_t indexes[64];
+		int32_t numIndexes = 0;
+		int32_t numWritten = 0;
+		for (int32_t c = 0; c < numSampleClusters && numWritten + numIndexes < sampleNumClusters; c++) {
+			Cluster* cluster = sample->clusters.getElement(c)->cluster;
+			if (cluster && cluster->loaded) {
+				indexes[numIndexes++] = c;
+				if (numIndexes == 64) {
+					if (!writeAll(&file, indexes, sizeof(indexes))) {
+						goto fail;
+					}
+					numWritten += numIndexes;
+					numIndexes = 0;
+				}
+			}
+		}
+		if (numIndexes && !writeAll(&file, indexes, numIndexes * sizeof(uint32_t))) {
+			goto fail;
+		}
+		numWritten += numIndexes;
+
+		// Pad out with Cluster 0 if some went missing meanwhile - reading it again does no harm
+		while (numWritten < sampleNumClusters) {
+			uint32_t zero = 0;
+			if (!writeAll(&file, &zero, sizeof(zero))) {
+				goto fail;
+			}
+			numWritten++;
+		}
+
+		numSamples++;
+		numClusters += sampleNumClusters;
+	}
+
+	{
+		uint16_t date = staticFNO.fdate;
+		uint16_t time = staticFNO.ftime;
+		uint32_t size = staticFNO.fsize;
+		memcpy(&header[0], &kSessionSnapshotMagic, 4);
+		memcpy(&header[4], &kSessionSnapshotVersion, 2);
+		memcpy(&header[6], &songPathLength, 2);
+		memcpy(&header[8], &date, 2);
+		memcpy(&header[10], &time, 2);
+		memcpy(&header[12], &size, 4);
+		memcpy(&header[16], &numSamples, 4);
+		memcpy(&header[20], &numClusters, 4);
+	}
+	if (f_lseek(&file, 0) != FR_OK || !writeAll(&file, header, kSessionSnapshotHeaderSize)) {
+		goto fail;
+	}
+
+	f_close(&file);
+	FolderIndex::folderChanged(kSessionSnapshotPath);
+	Debug::print("session snapshot clusters: ");
+	Debug::println(numClusters);
+	return;
+
+fail:
+	f_close(&file);
+	f_unlink(kSessionSnapshotPath);
+	FolderIndex::folderChanged(kSessionSnapshotPath);
+}
+
+bool SessionSnapshot::resume() {
+	if (runtimeFeatureSettings.get(RuntimeFeatureSettingType::ResumeLastSong) != RuntimeFeatureStateToggle::On) {
+		return false;
+	}
+
+	// If the user's already got going, leave them to it
+	if (currentUIMode != UI_MODE_NONE || playbackHandler.isEitherClockActive()) {
+		return false;
+	}
+
+	FIL file;
+	if (f_open(&file, kSessionSnapshotPath, FA_READ) != FR_OK) {
+		return false;
+	}
+
+	char header[kSessionSnapshotHeaderSize];
+	char songFilePath[kSessionSnapshotMaxPathLength + 1];
+	uint32_t magic, songFileSize;
+	uint16_t version, songPathLength, songFileDate, songFileTime;
+
+	if (!readAll(&file, header, kSessionSnapshotHeaderSize)) {
+		goto fail;
+	}
+	memcpy(&magic, &header[0], 4);
+	memcpy(&version, &header[4], 2);
+	memcpy(&songPathLength, &header[6], 2);
+	memcpy(&songFileDate, &header[8], 2);
+	memcpy(&songFileTime, &header[10], 2);
+	memcpy(&songFileSize, &header[12], 4);
+	if (magic != kSessionSnapshotMagic || version != kSessionSnapshotVersion
+	    || songPathLength > kSessionSnapshotMaxPathLength || !readAll(&file, songFilePath, songPathLength)) {
+		goto fail;
+	}
+	songFilePath[songPathLength] = 0;
+
+	// If the song's been saved since without the snapshot (e.g. with the setting off), it's not what we remember
+	if (f_stat(songFilePath, &staticFNO) != FR_OK || staticFNO.fdate != songFileDate
+	    || staticFNO.ftime != songFileTime || staticFNO.fsize != songFileSize) {
+		goto fail;
+	}
+
+	// Anything past what we'll take just doesn't get warmed. warmRoutine() stops at the first incomplete entry
+	warmListSize = std::min<uint32_t>(f_size(&file) - f_tell(&file), kMaxWarmListSize);
+	if (warmListSize) {
+		warmList = (char*)GeneralMemoryAllocator::get().alloc(warmListSize, NULL, false, false);
+		if (warmList && !readAll(&file, warmList, warmListSize)) {
+			finishWarming();
+		}
+	}
+	f_close(&file);
+
+	{
+		FilePointer filePointer;
+		char const* slash = strrchr(songFilePath, '/');
+		char const* filename = slash ? slash + 1 : songFilePath;
+		char const* dot = strrchr(filename, '.');
+		String filenameWithoutExtension;
+
+		if (!storageManager.fileExists(songFilePath, &filePointer)
+		    || Browser::currentDir.set(songFilePath, slash ? slash - songFilePath : 0)
+		    || filenameWithoutExtension.set(filename, dot ? dot - filename : -1)) {
+			finishWarming();
+			return false;
+		}
+		QwertyUI::enteredText.set(&filenameWithoutExtension);
+
+		Debug::print("resuming ");
+		Debug::println(songFilePath);
+		if (!loadSongUI.performLoadFromFile(&filePointer, &filenameWithoutExtension)) {
+			finishWarming();
+			return false;
+		}
+	}
+
+	warmPos = 0;
+	warmRound = 0;
+	anyThisRound = false;
+	return true;
+
+fail:
+	f_close(&file);
+	return false;
+}
+
+bool SessionSnapshot::warmRoutine() {
+	if (!warmList) {
+		return false;
+	}
+
+	// Anything in the loading queue is wanted for playing right now, so comes first
+	if (audioFileManager.loadingQueue.getNumElements()) {
+		return true;
+	}
+
+	if (audioFileManager.getRAMSpareFromCurrentSong() < kWarmingRAMFloor) {
+		finishWarming();
+		return false;
+	}
+
+	int32_t numDone = 0;
+	while (numDone < kNumClustersPerWarm) {
+
+		// At the end of the list, go round again for each Sample's next Cluster - unless none had one this time
+		uint16_t entryHeader[2];
+		uint32_t entrySize = 0;
+		if (warmPos + sizeof(entryHeader) <= warmListSize) {
+			memcpy(entryHeader, &warmList[warmPos], sizeof(entryHeader));
+			entrySize = sizeof(entryHeader) + entryHeader[0] + entryHeader[1] * sizeof(uint32_t);
+		}
+		if (!entrySize || warmPos + entrySize > warmListSize) {
+			if (!anyThisRound) {
+				finishWarming();
+				return false;
+			}
+			warmPos = 0;
+			warmRound++;
+			anyThisRound = false;
+			continue;
+		}
+
+		char const* entry = &warmList[warmPos];
+		warmPos += entrySize;
+		if (warmRound >= entryHeader[1]) {
+			continue;
+		}
+		anyThisRound = true;
+		numDone++;
+
+		char path[kSessionSnapshotMaxPathLength + 1];
+		memcpy(path, &entry[sizeof(entryHeader)], entryHeader[0]);
+		path[entryHeader[0]] = 0;
+		uint32_t clusterIndex;
+		memcpy(&clusterIndex, &entry[sizeof(entryHeader) + entryHeader[0] + warmRound * sizeof(uint32_t)],
+		       sizeof(uint32_t));
+
+		// A WaveTable could have the same path, so it's either this one or the next
+		bool foundExact;
+		int32_t i = audioFileManager.audioFiles.search(path, GREATER_OR_EQUAL, &foundExact);
+		if (!foundExact) {
+			continue;
+		}
+		AudioFile* audioFile = (AudioFile*)audioFileManager.audioFiles.getElement(i);
+		if (audioFile->type != AudioFileType::SAMPLE && i + 1 < audioFileManager.audioFiles.getNumElements()) {
+			audioFile = (AudioFile*)audioFileManager.audioFiles.getElement(i + 1);
+			if (strcmp(audioFile->filePath.get(), path)) {
+				continue;
+			}
+		}
+		if (audioFile->type != AudioFileType::SAMPLE) {
+			continue;
+		}
+		Sample* sample = (Sample*)audioFile;
+		if (clusterIndex >= sample->clusters.getNumElements()) {
+			continue;
+		}
+
+		// Once loaded, our reason comes straight off again, leaving it cached in the current song's stealable queue
+		uint8_t error;
+		Cluster* cluster = sample->clusters.getElement(clusterIndex)
+		                       ->getCluster(sample, clusterIndex, CLUSTER_LOAD_IMMEDIATELY, 0xFFFFFFFF, &error);
+		if (!cluster) {
+			if (error == ERROR_INSUFFICIENT_RAM) {
+				finishWarming();
+				return false;
+			}
+			continue;
+		}
+		audioFileManager.removeReasonFromCluster(cluster, "E459");
+	}
+	return true;
+}
+
+void SessionSnapshot::finishWarming() {
+	if (warmList) {
+		delugeDealloc(warmList);
+		warmList = nullptr;
+	}
+}
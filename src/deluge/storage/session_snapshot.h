@@ -0,0 +1,59 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/*
+ * With the Resume Last Song community setting on, saving a song also writes kSessionSnapshotPath, saying where the song
+ * was saved and which Clusters of its Samples were in RAM at the time. At startup, that song gets loaded again, and then
+ * those Clusters get read back in from the main loop, a few at a time - the first of them for every Sample, then the
+ * second, and so on, since the starts are what's needed soonest. So after a power cut mid-show, the Deluge comes back
+ * with the song it was playing, without anyone having to find it in the browser, and with less waiting on the card once
+ * it's playing again.
+ *
+ * The song itself still gets read from its XML file - the snapshot just says which one it is, and gets ignored if that
+ * file's been changed since.
+ */
+
+constexpr char const* kSessionSnapshotPath = "/.SESSION_SNAPSHOT";
+
+class SessionSnapshot {
+public:
+	/// Call once a song's been saved to songFilePath. Does nothing unless the community setting's on
+	void write(char const* songFilePath);
+
+	/// Call once at startup, after the community settings have been read. Returns true if the snapshot's song got
+	/// loaded, in which case call warmRoutine() until it returns false
+	bool resume();
+
+	/// Reads in a few more of the snapshot's Clusters, unless the card's busy with ones that are actually wanted right
+	/// now. Returns false once it's done - which it also is if RAM gets short
+	bool warmRoutine();
+
+private:
+	void finishWarming();
+
+	char* warmList = nullptr; // The snapshot's Sample entries, just as they are on the card
+	uint32_t warmListSize;
+	uint32_t warmPos;  // Where the next Sample entry in warmList starts
+	int32_t warmRound; // Which of each Sample's Clusters we're up to
+	bool anyThisRound; // Whether any Sample had that many
+};
+
+extern SessionSnapshot sessionSnapshot;
@@ -24,6 +24,7 @@
 #include "gui/ui_timer_manager.h"
 #include "hid/buttons.h"
 #include "hid/display/display.h"
+#include "hid/encoders.h"
 #include "hid/led/pad_leds.h"
 #include "hid/matrix/matrix_driver.h"
 #include "io/debug/print.h"
@@ -47,6 +48,7 @@
 #include "processing/sound/sound_instrument.h"
 #include "storage/audio/audio_file_manager.h"
 #include "storage/cluster/cluster.h"
+#include "storage/folder_index.h"
 #include "util/functions.h"
 #include <new>
 #include <string.h>
@@ -77,6 +79,11 @@ struct FileSystemStuff fileSystemStuff;
 
 StorageManager::StorageManager() {
 	fileClusterBuffer = NULL;
+	fileFlushBuffer = NULL;
+	fileFlushBufferPos = 0;
+	fileFlushBufferEndPos = 0;
+	xmlReadAborted = false;
+	readingXMLFile = false;
 
 	devVarA = 150;
 	devVarB = 8;
@@ -182,738 +189,50 @@ void StorageManager::printIndents() {
 	}
 }
 
-char stringBuffer[kFilenameBufferSize] __attribute__((aligned(CACHE_LINE_SIZE)));
-
-#define BETWEEN_TAGS 0
-#define IN_TAG_NAME 1
-#define IN_TAG_PAST_NAME 2
-#define IN_ATTRIBUTE_NAME 3
-#define PAST_ATTRIBUTE_NAME 4
-#define PAST_EQUALS_SIGN 5
-#define IN_ATTRIBUTE_VALUE 6
-
-// Only call this if IN_TAG_NAME
-// TODO: this is very sub-optimal and still calls readCharXML()
-char const* StorageManager::readTagName() {
-
-	if (false) {
-skipToNextTag:
-		skipUntilChar('>');
-		skipUntilChar('<');
-	}
-
-	char thisChar;
-	int32_t charPos = 0;
-
-	while (readCharXML(&thisChar)) {
-		switch (thisChar) {
-		case '/':
-			goto skipPastRest;
-
-		case ' ':
-		case '\r':
-		case '\n':
-		case '\t':
-			xmlArea = IN_TAG_PAST_NAME;
-			goto getOut;
-
-		case '?':
-			goto skipToNextTag;
-
-		case '>':
-			xmlArea = BETWEEN_TAGS;
-			goto getOut;
-
-		default:
-			if (!charPos) {
-				tagDepthFile++;
-			}
-
-			// Store this character, if space in our un-ideal buffer
-			if (charPos < kFilenameBufferSize - 1) {
-				stringBuffer[charPos++] = thisChar;
-			}
-		}
-	}
-
-getOut:
-	xmlReadDone();
-
-	if (false) {
-skipPastRest:
-		tagDepthFile--;
-		skipUntilChar('>');
-		xmlArea = BETWEEN_TAGS;
-	}
-
-	stringBuffer[charPos] = 0;
-	return stringBuffer;
-}
-
-// Only call when IN_TAG_PAST_NAME
-char const* StorageManager::readNextAttributeName() {
-
-	char thisChar;
-	int32_t charPos = 0;
-
-	while (readCharXML(&thisChar)) {
-		switch (thisChar) {
-		case ' ':
-		case '\r':
-		case '\n':
-		case '\t':
-			break;
-
-		case '/':
-			tagDepthFile--;
-			skipUntilChar('>');
-			// No break
-
-		case '>':
-			xmlArea = BETWEEN_TAGS;
-			// No break
-
-		case '<': // This is an error - there definitely shouldn't be a '<' inside a tag! TODO: make way to return error
-			goto noMoreAttributes;
-
-		default:
-			goto doReadName;
-		}
-	}
-
-noMoreAttributes:
-	return "";
-
-	// Here, we're in IN_ATTRIBUTE_NAME, and we're not allowed to leave this while loop until our xmlArea changes to something else
-	// - or there's an error or file-end, in which case we'll return error below
-doReadName:
-	xmlArea = IN_ATTRIBUTE_NAME;
-	tagDepthFile++;
-	fileBufferCurrentPos--; // This means we don't need to call readXMLFileClusterIfNecessary()
-
-	bool haveReachedNameEnd = false;
-
-	// This is basically copied and tweaked from readUntilChar()
-	do {
-		int32_t bufferPosAtStart = fileBufferCurrentPos;
-		while (fileBufferCurrentPos < currentReadBufferEndPos) {
-			char thisChar = fileClusterBuffer[fileBufferCurrentPos];
-
-			switch (thisChar) {
-			case ' ':
-			case '\r':
-			case '\n':
-			case '\t':
-				xmlArea = PAST_ATTRIBUTE_NAME;
-				goto reachedNameEnd;
-
-			case '=':
-				xmlArea = PAST_EQUALS_SIGN;
-				goto reachedNameEnd;
-
-			// If we get a close-tag name, it means we saw some sorta attribute name with no value, which isn't allowed, so treat it as invalid
-			case '>':
-				xmlArea = BETWEEN_TAGS;
-				goto noMoreAttributes;
-
-				// TODO: a '/' should get us outta here too...
-			}
-
-			fileBufferCurrentPos++;
-		}
-
-		if (false) {
-reachedNameEnd:
-			xmlReadDone();
-			haveReachedNameEnd = true;
-			// If possible, just return a pointer to the chars within the existing buffer
-			if (!charPos && fileBufferCurrentPos < currentReadBufferEndPos) {
-				fileClusterBuffer[fileBufferCurrentPos] = 0; // NULL end of the string we're returning
-				fileBufferCurrentPos++;                      // Gets us past the endChar
-				return &fileClusterBuffer[bufferPosAtStart];
-			}
-		}
-
-		int32_t numCharsHere = fileBufferCurrentPos - bufferPosAtStart;
-		int32_t numCharsToCopy = std::min<int32_t>(numCharsHere, kFilenameBufferSize - 1 - charPos);
-
-		if (numCharsToCopy > 0) {
-			memcpy(&stringBuffer[charPos], &fileClusterBuffer[bufferPosAtStart], numCharsToCopy);
-
-			charPos += numCharsToCopy;
-		}
-
-		if (haveReachedNameEnd) {
-			stringBuffer[charPos] = 0;
-			fileBufferCurrentPos++; // Gets us past the endChar
-			return stringBuffer;
-		}
-
-	} while (fileBufferCurrentPos == currentReadBufferEndPos && readXMLFileClusterIfNecessary());
-
-	// If here, file ended
-	return "";
-}
-
-char charAtEndOfValue;
-
-char const* StorageManager::readNextTagOrAttributeName() {
-
-	char const* toReturn;
-	int32_t tagDepthStart = tagDepthFile;
-
-	switch (xmlArea) {
-
-	default:
-#if ALPHA_OR_BETA_VERSION
-		display->freezeWithError(
-		    "E365"); // Can happen with invalid files, though I'm implementing error checks whenever a user alerts me to a scenario. Fraser got this, Nov 2021.
-#else
-		__builtin_unreachable();
-#endif
-		break;
-
-	case IN_ATTRIBUTE_VALUE: // Could have been left here during a char-at-a-time read
-		skipUntilChar(charAtEndOfValue);
-		xmlArea = IN_TAG_PAST_NAME;
-		// No break
-
-	case IN_TAG_PAST_NAME:
-		toReturn = readNextAttributeName();
-		// If depth has changed, this means we met a /> and must get out
-		if (*toReturn || tagDepthFile != tagDepthStart) {
-			break;
-		}
-		// No break
-
-	case BETWEEN_TAGS:
-		skipUntilChar('<');
-		xmlArea = IN_TAG_NAME;
-		// No break
-
-	case IN_TAG_NAME:
-		toReturn = readTagName();
-	}
-
-	if (*toReturn) {
-		/*
-    	for (int32_t t = 0; t < tagDepthCaller; t++) {
-    		Debug::print("\t");
-    	}
-    	Debug::println(toReturn);
-		*/
-		tagDepthCaller++;
-		AudioEngine::logAction(toReturn);
-	}
-
-	return toReturn;
-}
-
-// Only call if PAST_ATTRIBUTE_NAME or PAST_EQUALS_SIGN
-// Returns the quote character that opens the value - or 0 if fail
-bool StorageManager::getIntoAttributeValue() {
-
-	char thisChar;
-
-	switch (xmlArea) {
-	case PAST_ATTRIBUTE_NAME:
-		while (readCharXML(&thisChar)) {
-			switch (thisChar) {
-			case ' ':
-			case '\r':
-			case '\n':
-			case '\t':
-				break;
-
-			case '=':
-				xmlArea = PAST_EQUALS_SIGN;
-				goto pastEqualsSign;
-
-			default:
-				return false; // There shouldn't be any other characters. If there are, that's an error
-			}
-		}
-
-		break;
-
-	case PAST_EQUALS_SIGN:
-pastEqualsSign:
-		while (readCharXML(&thisChar)) {
-			switch (thisChar) {
-			case ' ':
-			case '\r':
-			case '\n':
-			case '\t':
-				break;
-
-			case '"':
-			case '\'':
-				goto inAttributeValue;
-
-			default:
-				return false; // There shouldn't be any other characters. If there are, that's an error
-			}
-		}
-		break;
-	}
-
-	if (false) {
-inAttributeValue:
-		xmlArea = IN_ATTRIBUTE_VALUE;
-		tagDepthFile--;
-		charAtEndOfValue = thisChar;
-		return true;
-	}
-
-	return false; // Fail
-}
-
-// Only call if PAST_ATTRIBUTE_NAME or PAST_EQUALS_SIGN
-char const* StorageManager::readAttributeValue() {
-
-	if (!getIntoAttributeValue()) {
-		return "";
-	}
-	xmlArea = IN_TAG_PAST_NAME; // How it'll be after this next call
-	return readUntilChar(charAtEndOfValue);
-}
-
-// Only call if PAST_ATTRIBUTE_NAME or PAST_EQUALS_SIGN
-int32_t StorageManager::readAttributeValueInt() {
-
-	if (!getIntoAttributeValue()) {
-		return 0;
-	}
-	xmlArea = IN_TAG_PAST_NAME; // How it'll be after this next call
-	return readIntUntilChar(charAtEndOfValue);
-}
-
-// Only call if PAST_ATTRIBUTE_NAME or PAST_EQUALS_SIGN
-int32_t StorageManager::readAttributeValueString(String* string) {
-
-	if (!getIntoAttributeValue()) {
-		string->clear();
-		return NO_ERROR;
-	}
-	else {
-		int32_t error = readStringUntilChar(string, charAtEndOfValue);
-		if (!error) {
-			xmlArea = IN_TAG_PAST_NAME;
-		}
-		return error;
-	}
-}
+// How long reading goes on between turns for the audio routine and UI. Tags take wildly different times to read - a
+// long run of note data against a single attribute, say - so this goes by time rather than a count of them
+constexpr uint32_t kXMLReadSliceCycles = 200 * Debug::uS;
 
 void StorageManager::xmlReadDone() {
-	xmlReadCount++; // Increment first, cos we don't want to call SD routine immediately when it's 0
-
-	if (!(xmlReadCount & 63)) { // 511 bad. 255 almost fine. 127 almost always fine
-		AudioEngine::routineWithClusterLoading();
-
-		uiTimerManager.routine();
-
-		if (display->haveOLED()) {
-			oledRoutine();
-		}
-		PIC::flush();
-	}
-}
-
-void StorageManager::skipUntilChar(char endChar) {
-
-	readXMLFileClusterIfNecessary(); // Does this need to be here? Originally I didn't have it...
-
-	do {
-		while (fileBufferCurrentPos < currentReadBufferEndPos && fileClusterBuffer[fileBufferCurrentPos] != endChar) {
-			fileBufferCurrentPos++;
-		}
-
-	} while (fileBufferCurrentPos == currentReadBufferEndPos && readXMLFileClusterIfNecessary());
-
-	fileBufferCurrentPos++; // Gets us past the endChar
-
-	xmlReadDone();
-}
-
-// Returns memory error. If error, caller must deal with the fact that the end-character hasn't been reached
-int32_t StorageManager::readStringUntilChar(String* string, char endChar) {
-
-	int32_t newStringPos = 0;
-
-	do {
-		int32_t bufferPosNow = fileBufferCurrentPos;
-		while (bufferPosNow < currentReadBufferEndPos && fileClusterBuffer[bufferPosNow] != endChar) {
-			bufferPosNow++;
-		}
-
-		int32_t numCharsHere = bufferPosNow - fileBufferCurrentPos;
-
-		if (numCharsHere) {
-			int32_t error =
-			    string->concatenateAtPos(&fileClusterBuffer[fileBufferCurrentPos], newStringPos, numCharsHere);
-
-			fileBufferCurrentPos = bufferPosNow;
-
-			if (error) {
-				return error;
-			}
-
-			newStringPos += numCharsHere;
-		}
-
-	} while (fileBufferCurrentPos == currentReadBufferEndPos && readXMLFileClusterIfNecessary());
-
-	fileBufferCurrentPos++; // Gets us past the endChar
-
-	xmlReadDone();
-	return NO_ERROR;
-}
-
-char const* StorageManager::readUntilChar(char endChar) {
-	int32_t charPos = 0;
-
-	do {
-		int32_t bufferPosAtStart = fileBufferCurrentPos;
-		while (fileBufferCurrentPos < currentReadBufferEndPos && fileClusterBuffer[fileBufferCurrentPos] != endChar) {
-			fileBufferCurrentPos++;
-		}
-
-		// If possible, just return a pointer to the chars within the existing buffer
-		if (!charPos && fileBufferCurrentPos < currentReadBufferEndPos) {
-			fileClusterBuffer[fileBufferCurrentPos] = 0;
-
-			fileBufferCurrentPos++; // Gets us past the endChar
-			return &fileClusterBuffer[bufferPosAtStart];
-		}
-
-		int32_t numCharsHere = fileBufferCurrentPos - bufferPosAtStart;
-		int32_t numCharsToCopy = std::min<int32_t>(numCharsHere, kFilenameBufferSize - 1 - charPos);
-
-		if (numCharsToCopy > 0) {
-			memcpy(&stringBuffer[charPos], &fileClusterBuffer[bufferPosAtStart], numCharsToCopy);
-
-			charPos += numCharsToCopy;
-		}
-
-	} while (fileBufferCurrentPos == currentReadBufferEndPos && readXMLFileClusterIfNecessary());
-
-	fileBufferCurrentPos++; // Gets us past the endChar
-
-	xmlReadDone();
-
-	stringBuffer[charPos] = 0;
-	return stringBuffer;
-}
-
-// Unlike readUntilChar(), above, does not put a null character at the end of the returned "string". And, has a preset number of chars.
-// And, returns NULL when nothing more to return.
-// numChars must be <= FILENAME_BUFFER_SIZE
-char const* StorageManager::readNextCharsOfTagOrAttributeValue(int32_t numChars) {
-
-	int32_t charPos = 0;
-
-	do {
-		int32_t bufferPosAtStart = fileBufferCurrentPos;
-		int32_t bufferPosAtEnd = bufferPosAtStart + numChars - charPos;
-
-		int32_t currentReadBufferEndPosNow = std::min<int32_t>(currentReadBufferEndPos, bufferPosAtEnd);
-
-		while (fileBufferCurrentPos < currentReadBufferEndPosNow) {
-			if (fileClusterBuffer[fileBufferCurrentPos] == charAtEndOfValue) {
-				goto reachedEndCharEarly;
-			}
-			fileBufferCurrentPos++;
-		}
-
-		int32_t numCharsHere = fileBufferCurrentPos - bufferPosAtStart;
-
-		// If we were able to just read the whole thing in one go, just return a pointer to the chars within the existing buffer
-		if (numCharsHere == numChars) {
-			xmlReadDone();
-			return &fileClusterBuffer[bufferPosAtStart];
-		}
-
-		// Otherwise, so long as we read something, add it to our buffer we're putting the output in
-		if (numCharsHere > 0) {
-			memcpy(&stringBuffer[charPos], &fileClusterBuffer[bufferPosAtStart], numCharsHere);
-
-			charPos += numCharsHere;
-
-			// And if we've now got all the chars we needed, return
-			if (charPos == numChars) {
-				xmlReadDone();
-				return stringBuffer;
-			}
-		}
-
-	} while (fileBufferCurrentPos == currentReadBufferEndPos && readXMLFileClusterIfNecessary());
-
-	// If we're here, the file ended
-	return NULL;
-
-	// And, additional bit we jump to when end-char reached
-reachedEndCharEarly:
-	fileBufferCurrentPos++; // Gets us past the endChar
-	if (charAtEndOfValue == '<') {
-		xmlArea = IN_TAG_NAME;
-	}
-	else {
-		xmlArea = IN_TAG_PAST_NAME; // Could be ' or "
-	}
-	return NULL;
-}
-
-// This is almost never called now - TODO: get rid
-char StorageManager::readNextCharOfTagOrAttributeValue() {
-
-	char thisChar;
-	if (!readCharXML(&thisChar)) {
-		return 0;
-	}
-	if (thisChar == charAtEndOfValue) {
-		if (charAtEndOfValue == '<') {
-			xmlArea = IN_TAG_NAME;
-		}
-		else {
-			xmlArea = IN_TAG_PAST_NAME; // Could be ' or "
-		}
-		xmlReadDone();
-		return 0;
-	}
-	return thisChar;
-}
-
-// Will always skip up until the end-char, even if it doesn't like the contents it sees
-int32_t StorageManager::readIntUntilChar(char endChar) {
-	uint32_t number = 0;
-	char thisChar;
-
-	if (!readCharXML(&thisChar)) {
-		return 0;
-	}
-
-	bool isNegative = (thisChar == '-');
-	if (!isNegative) {
-		goto readDigit;
-	}
-
-	while (readCharXML(&thisChar)) {
-readDigit:
-		if (!(thisChar >= '0' && thisChar <= '9')) {
-			goto getOut;
-		}
-		number *= 10;
-		number += (thisChar - '0');
-	}
-
-	if (false) {
-getOut:
-		if (thisChar != endChar) {
-			skipUntilChar(endChar);
-		}
-	}
-
-	if (isNegative) {
-		if (number >= 2147483648) {
-			return -2147483648;
-		}
-		else {
-			return -(int32_t)number;
-		}
-	}
-	else {
-		return number;
-	}
-}
-
-char const* StorageManager::readTagOrAttributeValue() {
-
-	switch (xmlArea) {
-
-	case BETWEEN_TAGS:
-		xmlArea = IN_TAG_NAME; // How it'll be after this call
-		return readUntilChar('<');
-
-	case PAST_ATTRIBUTE_NAME:
-	case PAST_EQUALS_SIGN:
-		return readAttributeValue();
-
-	case IN_TAG_PAST_NAME: // Could happen if trying to read a value but instead of a value there are multiple more contents, like attributes etc. Obviously not "meant" to happen, but we need to cope.
-		return "";
-
-	default:
-		display->freezeWithError("BBBB");
-		__builtin_unreachable();
-	}
-}
-
-int32_t StorageManager::readTagOrAttributeValueInt() {
-
-	switch (xmlArea) {
-
-	case BETWEEN_TAGS:
-		xmlArea = IN_TAG_NAME; // How it'll be after this call
-		return readIntUntilChar('<');
-
-	case PAST_ATTRIBUTE_NAME:
-	case PAST_EQUALS_SIGN:
-		return readAttributeValueInt();
-
-	case IN_TAG_PAST_NAME: // Could happen if trying to read a value but instead of a value there are multiple more contents, like attributes etc. Obviously not "meant" to happen, but we need to cope.
-		return 0;
-
-	default:
-		display->freezeWithError("BBBB");
-		__builtin_unreachable();
-	}
-}
-
-// This isn't super optimal, like the int32_t version is, but only rarely used
-int32_t StorageManager::readTagOrAttributeValueHex(int32_t errorValue) {
-	char const* string = readTagOrAttributeValue();
-	if (string[0] != '0' || string[1] != 'x') {
-		return errorValue;
-	}
-	return hexToInt(&string[2]);
-}
-
-// Returns memory error
-int32_t StorageManager::readTagOrAttributeValueString(String* string) {
-
-	int32_t error;
-
-	switch (xmlArea) {
-	case BETWEEN_TAGS:
-		error = readStringUntilChar(string, '<');
-		if (!error) {
-			xmlArea = IN_TAG_NAME;
-		}
-		return error;
-
-	case PAST_ATTRIBUTE_NAME:
-	case PAST_EQUALS_SIGN:
-		return readAttributeValueString(string);
-
-	case IN_TAG_PAST_NAME: // Could happen if trying to read a value but instead of a value there are multiple more contents, like attributes etc. Obviously not "meant" to happen, but we need to cope.
-		return ERROR_FILE_CORRUPTED;
-
-	default:
-		if (ALPHA_OR_BETA_VERSION) {
-			display->freezeWithError("BBBB");
-		}
-		__builtin_unreachable();
+	if (Debug::readCycleCounter() - xmlSliceStartTime < kXMLReadSliceCycles) {
+		return;
 	}
-}
-
-int32_t StorageManager::getNumCharsRemainingInValue() {
-
-	int32_t pos = fileBufferCurrentPos;
-	while (pos < currentReadBufferEndPos && fileClusterBuffer[pos] != charAtEndOfValue) {
-		pos++;
-	}
-
-	return pos - fileBufferCurrentPos;
-}
-
-// Returns whether we're all good to go
-bool StorageManager::prepareToReadTagOrAttributeValueOneCharAtATime() {
-	switch (xmlArea) {
-
-	case BETWEEN_TAGS:
-		//xmlArea = IN_TAG_NAME; // How it'll be after reading all chars
-		charAtEndOfValue = '<';
-		return true;
 
-	case PAST_ATTRIBUTE_NAME:
-	case PAST_EQUALS_SIGN:
-		return getIntoAttributeValue();
-
-	default:
-		if (ALPHA_OR_BETA_VERSION) {
-			display->freezeWithError("CCCC");
-		}
-		__builtin_unreachable();
-	}
-}
+	AudioEngine::routineWithClusterLoading();
 
-// Returns whether successful loading took place
-bool StorageManager::readXMLFileClusterIfNecessary() {
+	uiTimerManager.routine();
 
-	// Load next Cluster if necessary
-	if (fileBufferCurrentPos >= audioFileManager.clusterSize) {
-		xmlReadCount = 0;
-		bool result = readXMLFileCluster();
-		if (!result) {
-			xmlReachedEnd = true;
-		}
-		return result;
+	if (display->haveOLED()) {
+		oledRoutine();
 	}
+	PIC::flush();
 
-	// Watch out for end of file
-	if (fileBufferCurrentPos >= currentReadBufferEndPos) {
+	// If the user's already moved on in the browser, stop here. Whatever's reading sees the file end, and then
+	// closeFile() says it failed
+	Encoders::readEncoders();
+	if (shouldAbortLoading()) {
+		xmlReadAborted = true;
 		xmlReachedEnd = true;
 	}
 
-	return false;
+	xmlSliceStartTime = Debug::readCycleCounter();
 }
 
-uint32_t StorageManager::readCharXML(char* thisChar) {
-
-	bool stillGoing = readXMLFileClusterIfNecessary();
-	if (xmlReachedEnd) {
+int32_t StorageManager::getXMLReadProgressPermille() {
+	if (!readingXMLFile) {
+		return -1;
+	}
+	uint32_t fileSize = fileSystemStuff.currentFile.obj.objsize;
+	if (!fileSize) {
 		return 0;
 	}
 
-	*thisChar = fileClusterBuffer[fileBufferCurrentPos];
-
-	fileBufferCurrentPos++;
-
-	return 1;
-}
-
-void StorageManager::exitTag(char const* exitTagName) {
-
-	while (tagDepthFile >= tagDepthCaller) {
-
-		if (xmlReachedEnd) {
-			return;
-		}
-
-		switch (xmlArea) {
-
-		case IN_ATTRIBUTE_VALUE: // Could get left in here after a char-at-a-time read
-			skipUntilChar(charAtEndOfValue);
-			xmlArea = IN_TAG_PAST_NAME;
-			// No break
-
-		case IN_TAG_PAST_NAME:
-			readNextAttributeName();
-			break;
-
-		case PAST_ATTRIBUTE_NAME:
-		case PAST_EQUALS_SIGN:
-			readAttributeValue();
-			break;
-
-		case BETWEEN_TAGS:
-			skipUntilChar('<');
-			xmlArea = IN_TAG_NAME;
-			// Got to next tag start
-			// No break
-
-		case IN_TAG_NAME:
-			readTagName();
-			break;
-
-		default:
-			if (ALPHA_OR_BETA_VERSION) {
-				display->freezeWithError("AAAA"); // Really shouldn't be possible anymore, I feel fairly certain...
-			}
-			__builtin_unreachable();
-		}
+	// The file pointer's at the end of the cluster we've got in the buffer, so go back by what's left of that
+	uint32_t pos = fileSystemStuff.currentFile.fptr;
+	if (fileBufferCurrentPos < (int32_t)currentReadBufferEndPos) {
+		pos -= currentReadBufferEndPos - fileBufferCurrentPos;
 	}
-
-	tagDepthCaller--;
+	return (int32_t)(((uint64_t)std::min(pos, fileSize) * 1000) / fileSize);
 }
 
 void StorageManager::readMidiCommand(uint8_t* channel, uint8_t* note) {
@@ -954,6 +273,9 @@ int32_t StorageManager::createFile(FIL* file, char const* filePath, bool mayOver
 		return error;
 	}
 
+	// Whatever happens, the listing of the folder it's going in is about to change
+	FolderIndex::folderChanged(filePath);
+
 	bool triedCreatingFolder = false;
 
 	BYTE mode = FA_WRITE;
@@ -1000,6 +322,7 @@ cutFolderPathAndTryCreating:
 			// Try making the folder
 			result = f_mkdir(folderPath.get());
 			if (result == FR_OK) {
+				FolderIndex::folderChanged(folderPath.get());
 				goto tryAgain;
 			}
 			else if (result
@@ -1031,10 +354,13 @@ int32_t StorageManager::createXMLFile(char const* filePath, bool mayOverwrite) {
 	if (error) {
 		return error;
 	}
+	currentFileSectorBuffer.attach(&fileSystemStuff.currentFile);
 
 	fileBufferCurrentPos = 0;
 	fileTotalBytesWritten = 0;
 	fileAccessFailedDuring = false;
+	fileFlushBufferPos = 0;
+	fileFlushBufferEndPos = 0;
 
 	write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
 
@@ -1072,31 +398,45 @@ bool StorageManager::fileExists(char const* pathName, FilePointer* fp) {
 	return true;
 }
 
-// TODO: this is really inefficient
+// Writing is double-buffered: when fileClusterBuffer fills up, it swaps with fileFlushBuffer, and the full one is then
+// written to the card a slice at a time, in between bits of the audio and UI routines, while we carry on filling the
+// other. Only if we fill that one too before the flush is done do we have to wait for it.
 void StorageManager::write(char const* output) {
 
-	while (*output) {
+	int32_t numCharsLeft = strlen(output);
+
+	while (numCharsLeft) {
 
 		if (fileBufferCurrentPos == audioFileManager.clusterSize) {
 
 			if (!fileAccessFailedDuring) {
-				int32_t error = writeBufferToFile();
+				int32_t error = flushSomeOfBufferToFile(audioFileManager.clusterSize);
 				if (error) {
 					fileAccessFailedDuring = true;
 					return;
 				}
+				swapBuffersAndStartFlushing();
 			}
 
 			fileBufferCurrentPos = 0;
 		}
 
-		fileClusterBuffer[fileBufferCurrentPos] = *output;
+		// Copy as much as we can in one go - up to the end of the buffer, or the next point where the audio routine is due
+		int32_t numCharsNow = std::min<int32_t>(numCharsLeft, audioFileManager.clusterSize - fileBufferCurrentPos);
+		numCharsNow = std::min<int32_t>(numCharsNow, 256 - (fileBufferCurrentPos & 0b11111111));
+		memcpy(&fileClusterBuffer[fileBufferCurrentPos], output, numCharsNow);
 
-		output++;
-		fileBufferCurrentPos++;
+		output += numCharsNow;
+		numCharsLeft -= numCharsNow;
+		fileBufferCurrentPos += numCharsNow;
 
 		// Ensure we do some of the audio routine once in a while
 		if (!(fileBufferCurrentPos & 0b11111111)) {
+			if (!fileAccessFailedDuring && flushSomeOfBufferToFile(kFileFlushSliceSize)) {
+				fileAccessFailedDuring = true;
+				return;
+			}
+
 			AudioEngine::logAction("writeCharXML");
 
 			AudioEngine::routineWithClusterLoading();
@@ -1123,17 +463,51 @@ int32_t StorageManager::writeBufferToFile() {
 	return NO_ERROR;
 }
 
+void StorageManager::swapBuffersAndStartFlushing() {
+	char* fullBuffer = fileClusterBuffer;
+	fileClusterBuffer = fileFlushBuffer;
+	fileFlushBuffer = fullBuffer;
+	fileFlushBufferPos = 0;
+	fileFlushBufferEndPos = fileBufferCurrentPos;
+}
+
+// Writes up to maxNumBytes more of fileFlushBuffer to the card. Slices are whole sectors, so FatFs can write them
+// straight from our buffer rather than going through its sector window.
+int32_t StorageManager::flushSomeOfBufferToFile(int32_t maxNumBytes) {
+	int32_t numBytes = std::min<int32_t>(maxNumBytes, fileFlushBufferEndPos - fileFlushBufferPos);
+	if (numBytes <= 0) {
+		return NO_ERROR;
+	}
+
+	UINT bytesWritten;
+	FRESULT result =
+	    f_write(&fileSystemStuff.currentFile, &fileFlushBuffer[fileFlushBufferPos], numBytes, &bytesWritten);
+	if (result != FR_OK || bytesWritten != numBytes) {
+		return ERROR_SD_CARD;
+	}
+
+	fileFlushBufferPos += numBytes;
+	fileTotalBytesWritten += numBytes;
+
+	return NO_ERROR;
+}
+
 // Returns false if some error, including error while writing
 int32_t StorageManager::closeFileAfterWriting(char const* path, char const* beginningString, char const* endString) {
 	if (fileAccessFailedDuring) {
 		return ERROR_WRITE_FAIL; // Calling f_close if this is false might be dangerous - if access has failed, we don't want it to flush any data to the card or anything
 	}
-	int32_t error = writeBufferToFile();
+	int32_t error = flushSomeOfBufferToFile(audioFileManager.clusterSize);
+	if (error) {
+		return ERROR_WRITE_FAIL;
+	}
+	error = writeBufferToFile();
 	if (error) {
 		return ERROR_WRITE_FAIL;
 	}
 
 	FRESULT result = f_close(&fileSystemStuff.currentFile);
+	currentFileSectorBuffer.release();
 	if (result) {
 		return ERROR_WRITE_FAIL;
 	}
@@ -1207,16 +581,12 @@ int32_t StorageManager::openXMLFile(FilePointer* filePointer, char const* firstT
 
 	openFilePointer(filePointer);
 
-	// Prep to read first Cluster shortly
-	fileBufferCurrentPos = audioFileManager.clusterSize;
-	currentReadBufferEndPos = audioFileManager.clusterSize;
+	beginReadingXML(audioFileManager.clusterSize);
 
 	firmwareVersionOfFileBeingRead = FIRMWARE_OLD;
 
-	tagDepthFile = 0;
-	tagDepthCaller = 0;
-	xmlReachedEnd = false;
-	xmlArea = BETWEEN_TAGS;
+	xmlSliceStartTime = Debug::readCycleCounter();
+	readingXMLFile = true;
 
 	char const* tagName;
 
@@ -1228,12 +598,15 @@ int32_t StorageManager::openXMLFile(FilePointer* filePointer, char const* firstT
 
 		int32_t result = tryReadingFirmwareTagFromFile(tagName, ignoreIncorrectFirmware);
 		if (result && result != RESULT_TAG_UNUSED) {
+			readingXMLFile = false;
 			return result;
 		}
 		exitTag(tagName);
 	}
 
 	f_close(&fileSystemStuff.currentFile);
+	currentFileSectorBuffer.release();
+	readingXMLFile = false;
 	return ERROR_FILE_CORRUPTED;
 }
 
@@ -1250,6 +623,7 @@ int32_t StorageManager::tryReadingFirmwareTagFromFile(char const* tagName, bool
 		int32_t earliestFirmware = stringToFirmwareVersion(firmwareVersionString);
 		if (earliestFirmware > kCurrentFirmwareVersion && !ignoreIncorrectFirmware) {
 			f_close(&fileSystemStuff.currentFile);
+			currentFileSectorBuffer.release();
 			return ERROR_FILE_FIRMWARE_VERSION_TOO_NEW;
 		}
 	}
@@ -1261,34 +635,16 @@ int32_t StorageManager::tryReadingFirmwareTagFromFile(char const* tagName, bool
 	return NO_ERROR;
 }
 
-bool StorageManager::readXMLFileCluster() {
-
-	AudioEngine::logAction("readXMLFileCluster");
-
-	FRESULT result = f_read(&fileSystemStuff.currentFile, (UINT*)fileClusterBuffer, audioFileManager.clusterSize,
-	                        &currentReadBufferEndPos);
-	if (result) {
-		fileAccessFailedDuring = true;
-		return false;
-	}
-
-	// If error or we reached end of file
-	if (!currentReadBufferEndPos) {
-		return false;
-	}
-
-	fileBufferCurrentPos = 0;
-
-	return true;
-}
-
 // Returns false if some error, including error while writing
 bool StorageManager::closeFile() {
+	readingXMLFile = false;
 	if (fileAccessFailedDuring) {
+		currentFileSectorBuffer.release();
 		return false; // Calling f_close if this is false might be dangerous - if access has failed, we don't want it to flush any data to the card or anything
 	}
 	FRESULT result = f_close(&fileSystemStuff.currentFile);
-	return (result == FR_OK);
+	currentFileSectorBuffer.release();
+	return (result == FR_OK) && !xmlReadAborted;
 }
 
 void StorageManager::writeFirmwareVersion() {
@@ -1349,8 +705,12 @@ void StorageManager::openFilePointer(FilePointer* fp) {
 	fileSystemStuff.currentFile.err = 0;        /* Clear error flag */
 	fileSystemStuff.currentFile.sect = 0;       /* Invalidate current data sector */
 	fileSystemStuff.currentFile.fptr = 0;       /* Set file pointer top of the file */
+#if FF_FS_TINY && FF_FS_PRIVATE_BUF
+	fileSystemStuff.currentFile.buf = 0; /* Shares the window until given a buffer of its own */
+#endif
 
 	fileAccessFailedDuring = false;
+	currentFileSectorBuffer.attach(&fileSystemStuff.currentFile);
 }
 
 int32_t StorageManager::openInstrumentFile(InstrumentType instrumentType, FilePointer* filePointer) {
@@ -1393,7 +753,10 @@ int32_t StorageManager::loadInstrumentFromFile(Song* song, InstrumentClip* clip,
 		return ERROR_INSUFFICIENT_RAM;
 	}
 
-	error = newInstrument->readFromFile(song, clip, 0);
+	{
+		ArenaScope arenaScope(loadArena, kLoadArenaSize);
+		error = newInstrument->readFromFile(song, clip, 0);
+	}
 
 	bool fileSuccess = closeFile();
 
@@ -1401,7 +764,7 @@ int32_t StorageManager::loadInstrumentFromFile(Song* song, InstrumentClip* clip,
 	if (error || !fileSuccess) {
 
 		if (!fileSuccess) {
-			error = ERROR_SD_CARD;
+			error = xmlReadAborted ? ERROR_ABORTED_BY_USER : ERROR_SD_CARD;
 		}
 
 deleteInstrumentAndGetOut:
@@ -1488,15 +851,14 @@ int32_t StorageManager::loadSynthToDrum(Song* song, InstrumentClip* clip, bool m
 	// If that somehow didn't work...
 	if (error || !fileSuccess) {
 
+		if (!fileSuccess) {
+			error = xmlReadAborted ? ERROR_ABORTED_BY_USER : ERROR_SD_CARD;
+		}
+
 		void* toDealloc = static_cast<void*>(newDrum);
 		newDrum->~Drum();
 		GeneralMemoryAllocator::get().dealloc(toDealloc);
 		return error;
-
-		if (!fileSuccess) {
-			error = ERROR_SD_CARD;
-			return error;
-		}
 	}
 	//these have to get cleared, otherwise we keep creating drums that aren't attached to note rows
 	if (*getInstrument) {
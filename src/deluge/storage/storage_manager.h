@@ -18,6 +18,7 @@
 #pragma once
 
 #include "definitions_cxx.hpp"
+#include "storage/file_sector_buffer.h"
 #include <cstdint>
 
 extern "C" {
@@ -26,6 +27,10 @@ extern "C" {
 
 extern void deleteOldSongBeforeLoadingNew();
 
+// How much of the previous buffer gets written to the card each time write() stops to let the audio routine run.
+// A whole number of sectors, and small enough that a 32kB buffer is flushed well before the next one fills
+constexpr int32_t kFileFlushSliceSize = 2048;
+
 struct FileSystemStuff {
 	FATFS fileSystem; /* File system object */
 	FIL currentFile;  /* File object */
@@ -87,6 +92,9 @@ public:
 	bool checkSDPresent();
 	bool checkSDInitialized();
 	bool readXMLFileCluster();
+	/// Sets the XML reading up for the start of the file that's just been opened, whose first cluster gets read in
+	/// when it's first needed
+	void beginReadingXML(uint32_t clusterSize);
 	int32_t getNumCharsRemainingInValue();
 	Instrument* createNewInstrument(InstrumentType newInstrumentType, ParamManager* getParamManager = NULL);
 	int32_t loadInstrumentFromFile(Song* song, InstrumentClip* clip, InstrumentType instrumentType,
@@ -112,11 +120,15 @@ public:
 	SyncLevel readAbsoluteSyncLevelFromFile(Song* song);
 	void writeAbsoluteSyncLevelToFile(Song* song, char const* name, SyncLevel internalValue, bool onNewLine = true);
 
+	/// How far through the XML file being read we are, in tenths of a percent, or -1 if there isn't one being read
+	int32_t getXMLReadProgressPermille();
+
 	bool fileAccessFailedDuring;
 
 	int32_t firmwareVersionOfFileBeingRead;
 
 	char* fileClusterBuffer;
+	char* fileFlushBuffer; // While writing, the previous full buffer, which gets flushed to the card a slice at a time
 	UINT currentReadBufferEndPos;
 	int32_t fileBufferCurrentPos;
 
@@ -135,12 +147,17 @@ private:
 
 	uint8_t xmlArea;
 	bool xmlReachedEnd;
+	uint32_t xmlClusterSize; // How much of the file each readXMLFileCluster() reads
 	int32_t tagDepthCaller; // How deeply indented in XML the main Deluge classes think we are, as data being read.
 	int32_t
 	    tagDepthFile; // Will temporarily be different to the above as unwanted / unused XML tags parsed on the way to finding next useful data.
-	int32_t xmlReadCount;
+	uint32_t xmlSliceStartTime; // In cycles, when reading last stopped to let the audio routine and UI have a turn
+	bool xmlReadAborted;        // The user's moved on, so the file's being treated as though it ended here
+	bool readingXMLFile;
+	FileSectorBuffer currentFileSectorBuffer; // While an XML file is open, being read or written
 
 	void skipUntilChar(char endChar);
+	void skipUntilTagDepthBelow(int32_t depth);
 	char const* readTagName();
 	char const* readNextAttributeName();
 	char const* readUntilChar(char endChar);
@@ -155,6 +172,11 @@ private:
 	void xmlReadDone();
 
 	int32_t writeBufferToFile();
+	void swapBuffersAndStartFlushing();
+	int32_t flushSomeOfBufferToFile(int32_t maxNumBytes);
+
+	int32_t fileFlushBufferPos;
+	int32_t fileFlushBufferEndPos;
 };
 
 extern StorageManager storageManager;
@@ -0,0 +1,888 @@
+/*
+ * Copyright © 2014-2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// StorageManager's XML reading. This is kept apart from the rest of it, which needs most of the firmware, so that the
+// host benchmarks can build it too and run it against files served from memory - see tests/benchmarks.cpp. Anything
+// else it needs - xmlReadDone(), which lets the audio routine and UI have their turns - stays in storage_manager.cpp.
+
+#include "definitions_cxx.hpp"
+#include "hid/display/display.h"
+#include "processing/engines/audio_engine.h"
+#include "storage/storage_manager.h"
+#include "util/d_string.h"
+#include "util/functions.h"
+#include <algorithm>
+#include <string.h>
+
+extern "C" {
+#include "fatfs/ff.h"
+}
+
+char stringBuffer[kFilenameBufferSize] __attribute__((aligned(CACHE_LINE_SIZE)));
+
+#define BETWEEN_TAGS 0
+#define IN_TAG_NAME 1
+#define IN_TAG_PAST_NAME 2
+#define IN_ATTRIBUTE_NAME 3
+#define PAST_ATTRIBUTE_NAME 4
+#define PAST_EQUALS_SIGN 5
+#define IN_ATTRIBUTE_VALUE 6
+
+void StorageManager::beginReadingXML(uint32_t clusterSize) {
+	xmlClusterSize = clusterSize;
+
+	// Prep to read first Cluster shortly
+	fileBufferCurrentPos = clusterSize;
+	currentReadBufferEndPos = clusterSize;
+
+	tagDepthFile = 0;
+	tagDepthCaller = 0;
+	xmlReachedEnd = false;
+	xmlReadAborted = false;
+	xmlArea = BETWEEN_TAGS;
+}
+
+// Only call this if IN_TAG_NAME.
+// Scans the name in place, and if it's all within the current cluster of the file, returns a pointer straight into the
+// buffer. Only a name straddling two clusters gets copied into stringBuffer.
+char const* StorageManager::readTagName() {
+
+	int32_t charPos;
+
+	if (false) {
+skipToNextTag:
+		skipUntilChar('>');
+		skipUntilChar('<');
+	}
+
+	charPos = 0;
+
+	do {
+		int32_t bufferPosAtStart = fileBufferCurrentPos;
+		char endChar = 0;
+		while (fileBufferCurrentPos < currentReadBufferEndPos) {
+			char thisChar = fileClusterBuffer[fileBufferCurrentPos];
+			if (thisChar == '/' || thisChar == '>' || thisChar == '?' || thisChar == ' ' || thisChar == '\r'
+			    || thisChar == '\n' || thisChar == '\t') {
+				endChar = thisChar;
+				break;
+			}
+			fileBufferCurrentPos++;
+		}
+
+		int32_t numCharsHere = fileBufferCurrentPos - bufferPosAtStart;
+		if (numCharsHere && !charPos) {
+			tagDepthFile++;
+		}
+
+		if (endChar) {
+			fileBufferCurrentPos++; // Gets us past the endChar
+
+			if (endChar == '?') {
+				goto skipToNextTag;
+			}
+
+			// If the name's all here, and nothing's going to read another cluster in over it, just return it in place
+			if (!charPos && endChar != '/') {
+				fileClusterBuffer[fileBufferCurrentPos - 1] = 0; // NULL end of the string we're returning
+				xmlArea = (endChar == '>') ? BETWEEN_TAGS : IN_TAG_PAST_NAME;
+				xmlReadDone();
+				return &fileClusterBuffer[bufferPosAtStart];
+			}
+		}
+
+		int32_t numCharsToCopy = std::min<int32_t>(numCharsHere, kFilenameBufferSize - 1 - charPos);
+		if (numCharsToCopy > 0) {
+			memcpy(&stringBuffer[charPos], &fileClusterBuffer[bufferPosAtStart], numCharsToCopy);
+			charPos += numCharsToCopy;
+		}
+
+		if (endChar) {
+			stringBuffer[charPos] = 0;
+			if (endChar == '/') {
+				tagDepthFile--;
+				skipUntilChar('>');
+				xmlArea = BETWEEN_TAGS;
+			}
+			else {
+				xmlArea = (endChar == '>') ? BETWEEN_TAGS : IN_TAG_PAST_NAME;
+				xmlReadDone();
+			}
+			return stringBuffer;
+		}
+
+	} while (fileBufferCurrentPos == currentReadBufferEndPos && readXMLFileClusterIfNecessary());
+
+	// If here, file ended
+	xmlReadDone();
+	stringBuffer[charPos] = 0;
+	return stringBuffer;
+}
+
+// Only call when IN_TAG_PAST_NAME
+char const* StorageManager::readNextAttributeName() {
+
+	char thisChar;
+	int32_t charPos = 0;
+
+	while (readCharXML(&thisChar)) {
+		switch (thisChar) {
+		case ' ':
+		case '\r':
+		case '\n':
+		case '\t':
+			break;
+
+		case '/':
+			tagDepthFile--;
+			skipUntilChar('>');
+			// No break
+
+		case '>':
+			xmlArea = BETWEEN_TAGS;
+			// No break
+
+		case '<': // This is an error - there definitely shouldn't be a '<' inside a tag! TODO: make way to return error
+			goto noMoreAttributes;
+
+		default:
+			goto doReadName;
+		}
+	}
+
+noMoreAttributes:
+	return "";
+
+	// Here, we're in IN_ATTRIBUTE_NAME, and we're not allowed to leave this while loop until our xmlArea changes to something else
+	// - or there's an error or file-end, in which case we'll return error below
+doReadName:
+	xmlArea = IN_ATTRIBUTE_NAME;
+	tagDepthFile++;
+	fileBufferCurrentPos--; // This means we don't need to call readXMLFileClusterIfNecessary()
+
+	bool haveReachedNameEnd = false;
+
+	// This is basically copied and tweaked from readUntilChar()
+	do {
+		int32_t bufferPosAtStart = fileBufferCurrentPos;
+		while (fileBufferCurrentPos < currentReadBufferEndPos) {
+			char thisChar = fileClusterBuffer[fileBufferCurrentPos];
+
+			switch (thisChar) {
+			case ' ':
+			case '\r':
+			case '\n':
+			case '\t':
+				xmlArea = PAST_ATTRIBUTE_NAME;
+				goto reachedNameEnd;
+
+			case '=':
+				xmlArea = PAST_EQUALS_SIGN;
+				goto reachedNameEnd;
+
+			// If we get a close-tag name, it means we saw some sorta attribute name with no value, which isn't allowed, so treat it as invalid
+			case '>':
+				xmlArea = BETWEEN_TAGS;
+				goto noMoreAttributes;
+
+				// TODO: a '/' should get us outta here too...
+			}
+
+			fileBufferCurrentPos++;
+		}
+
+		if (false) {
+reachedNameEnd:
+			xmlReadDone();
+			haveReachedNameEnd = true;
+			// If possible, just return a pointer to the chars within the existing buffer
+			if (!charPos && fileBufferCurrentPos < currentReadBufferEndPos) {
+				fileClusterBuffer[fileBufferCurrentPos] = 0; // NULL end of the string we're returning
+				fileBufferCurrentPos++;                      // Gets us past the endChar
+				return &fileClusterBuffer[bufferPosAtStart];
+			}
+		}
+
+		int32_t numCharsHere = fileBufferCurrentPos - bufferPosAtStart;
+		int32_t numCharsToCopy = std::min<int32_t>(numCharsHere, kFilenameBufferSize - 1 - charPos);
+
+		if (numCharsToCopy > 0) {
+			memcpy(&stringBuffer[charPos], &fileClusterBuffer[bufferPosAtStart], numCharsToCopy);
+
+			charPos += numCharsToCopy;
+		}
+
+		if (haveReachedNameEnd) {
+			stringBuffer[charPos] = 0;
+			fileBufferCurrentPos++; // Gets us past the endChar
+			return stringBuffer;
+		}
+
+	} while (fileBufferCurrentPos == currentReadBufferEndPos && readXMLFileClusterIfNecessary());
+
+	// If here, file ended
+	return "";
+}
+
+char charAtEndOfValue;
+
+char const* StorageManager::readNextTagOrAttributeName() {
+
+	char const* toReturn;
+	int32_t tagDepthStart = tagDepthFile;
+
+	switch (xmlArea) {
+
+	default:
+#if ALPHA_OR_BETA_VERSION
+		display->freezeWithError(
+		    "E365"); // Can happen with invalid files, though I'm implementing error checks whenever a user alerts me to a scenario. Fraser got this, Nov 2021.
+#else
+		__builtin_unreachable();
+#endif
+		break;
+
+	case IN_ATTRIBUTE_VALUE: // Could have been left here during a char-at-a-time read
+		skipUntilChar(charAtEndOfValue);
+		xmlArea = IN_TAG_PAST_NAME;
+		// No break
+
+	case IN_TAG_PAST_NAME:
+		toReturn = readNextAttributeName();
+		// If depth has changed, this means we met a /> and must get out
+		if (*toReturn || tagDepthFile != tagDepthStart) {
+			break;
+		}
+		// No break
+
+	case BETWEEN_TAGS:
+		skipUntilChar('<');
+		xmlArea = IN_TAG_NAME;
+		// No break
+
+	case IN_TAG_NAME:
+		toReturn = readTagName();
+	}
+
+	if (*toReturn) {
+		/*
+    	for (int32_t t = 0; t < tagDepthCaller; t++) {
+    		Debug::print("\t");
+    	}
+    	Debug::println(toReturn);
+		*/
+		tagDepthCaller++;
+		AudioEngine::logAction(toReturn);
+	}
+
+	return toReturn;
+}
+
+// Only call if PAST_ATTRIBUTE_NAME or PAST_EQUALS_SIGN
+// Returns the quote character that opens the value - or 0 if fail
+bool StorageManager::getIntoAttributeValue() {
+
+	char thisChar;
+
+	switch (xmlArea) {
+	case PAST_ATTRIBUTE_NAME:
+		while (readCharXML(&thisChar)) {
+			switch (thisChar) {
+			case ' ':
+			case '\r':
+			case '\n':
+			case '\t':
+				break;
+
+			case '=':
+				xmlArea = PAST_EQUALS_SIGN;
+				goto pastEqualsSign;
+
+			default:
+				return false; // There shouldn't be any other characters. If there are, that's an error
+			}
+		}
+
+		break;
+
+	case PAST_EQUALS_SIGN:
+pastEqualsSign:
+		while (readCharXML(&thisChar)) {
+			switch (thisChar) {
+			case ' ':
+			case '\r':
+			case '\n':
+			case '\t':
+				break;
+
+			case '"':
+			case '\'':
+				goto inAttributeValue;
+
+			default:
+				return false; // There shouldn't be any other characters. If there are, that's an error
+			}
+		}
+		break;
+	}
+
+	if (false) {
+inAttributeValue:
+		xmlArea = IN_ATTRIBUTE_VALUE;
+		tagDepthFile--;
+		charAtEndOfValue = thisChar;
+		return true;
+	}
+
+	return false; // Fail
+}
+
+// Only call if PAST_ATTRIBUTE_NAME or PAST_EQUALS_SIGN
+char const* StorageManager::readAttributeValue() {
+
+	if (!getIntoAttributeValue()) {
+		return "";
+	}
+	xmlArea = IN_TAG_PAST_NAME; // How it'll be after this next call
+	return readUntilChar(charAtEndOfValue);
+}
+
+// Only call if PAST_ATTRIBUTE_NAME or PAST_EQUALS_SIGN
+int32_t StorageManager::readAttributeValueInt() {
+
+	if (!getIntoAttributeValue()) {
+		return 0;
+	}
+	xmlArea = IN_TAG_PAST_NAME; // How it'll be after this next call
+	return readIntUntilChar(charAtEndOfValue);
+}
+
+// Only call if PAST_ATTRIBUTE_NAME or PAST_EQUALS_SIGN
+int32_t StorageManager::readAttributeValueString(String* string) {
+
+	if (!getIntoAttributeValue()) {
+		string->clear();
+		return NO_ERROR;
+	}
+	else {
+		int32_t error = readStringUntilChar(string, charAtEndOfValue);
+		if (!error) {
+			xmlArea = IN_TAG_PAST_NAME;
+		}
+		return error;
+	}
+}
+
+void StorageManager::skipUntilChar(char endChar) {
+
+	readXMLFileClusterIfNecessary(); // Does this need to be here? Originally I didn't have it...
+
+	do {
+		if (fileBufferCurrentPos < currentReadBufferEndPos) {
+			char const* found = (char const*)memchr(&fileClusterBuffer[fileBufferCurrentPos], endChar,
+			                                        currentReadBufferEndPos - fileBufferCurrentPos);
+			fileBufferCurrentPos = found ? (found - fileClusterBuffer) : currentReadBufferEndPos;
+		}
+
+	} while (fileBufferCurrentPos == currentReadBufferEndPos && readXMLFileClusterIfNecessary());
+
+	fileBufferCurrentPos++; // Gets us past the endChar
+
+	xmlReadDone();
+}
+
+// Skips everything until tagDepthFile drops below depth, which is how exitTag() gets past whole tags it doesn't care
+// about. Rather than reading each name and value like readTagName() and readNextAttributeName() would, it just scans
+// for the few characters that can change the depth, and jumps over quoted values without looking inside them.
+// Only call if BETWEEN_TAGS, IN_TAG_NAME or IN_TAG_PAST_NAME.
+void StorageManager::skipUntilTagDepthBelow(int32_t depth) {
+
+	while (tagDepthFile >= depth) {
+
+		if (fileBufferCurrentPos >= currentReadBufferEndPos && !readXMLFileClusterIfNecessary()) {
+			return; // File ended
+		}
+
+		switch (xmlArea) {
+
+		case BETWEEN_TAGS:
+			skipUntilChar('<');
+			xmlArea = IN_TAG_NAME;
+			break;
+
+		case IN_TAG_NAME: {
+			// Just the first char tells us what sort of tag it is - the rest of the name gets skipped like attributes
+			char thisChar = fileClusterBuffer[fileBufferCurrentPos++];
+			switch (thisChar) {
+			case '/':
+				tagDepthFile--;
+				// No break
+
+			case '?':
+				skipUntilChar('>');
+				// No break
+
+			case '>':
+				xmlArea = BETWEEN_TAGS;
+				break;
+
+			case ' ':
+			case '\r':
+			case '\n':
+			case '\t':
+				xmlArea = IN_TAG_PAST_NAME;
+				break;
+
+			default:
+				tagDepthFile++;
+				xmlArea = IN_TAG_PAST_NAME;
+			}
+			break;
+		}
+
+		case IN_TAG_PAST_NAME:
+			while (fileBufferCurrentPos < currentReadBufferEndPos) {
+				char thisChar = fileClusterBuffer[fileBufferCurrentPos++];
+				switch (thisChar) {
+				case '"':
+				case '\'':
+					skipUntilChar(thisChar);
+					goto haveSkippedSomething;
+
+				case '/':
+					tagDepthFile--;
+					skipUntilChar('>');
+					// No break
+
+				case '>':
+					xmlArea = BETWEEN_TAGS;
+					goto haveSkippedSomething;
+				}
+			}
+haveSkippedSomething:
+			break;
+
+		default:
+			return;
+		}
+	}
+}
+
+// Returns memory error. If error, caller must deal with the fact that the end-character hasn't been reached
+int32_t StorageManager::readStringUntilChar(String* string, char endChar) {
+
+	int32_t newStringPos = 0;
+
+	do {
+		int32_t bufferPosNow = fileBufferCurrentPos;
+		while (bufferPosNow < currentReadBufferEndPos && fileClusterBuffer[bufferPosNow] != endChar) {
+			bufferPosNow++;
+		}
+
+		int32_t numCharsHere = bufferPosNow - fileBufferCurrentPos;
+
+		if (numCharsHere) {
+			int32_t error =
+			    string->concatenateAtPos(&fileClusterBuffer[fileBufferCurrentPos], newStringPos, numCharsHere);
+
+			fileBufferCurrentPos = bufferPosNow;
+
+			if (error) {
+				return error;
+			}
+
+			newStringPos += numCharsHere;
+		}
+
+	} while (fileBufferCurrentPos == currentReadBufferEndPos && readXMLFileClusterIfNecessary());
+
+	fileBufferCurrentPos++; // Gets us past the endChar
+
+	xmlReadDone();
+	return NO_ERROR;
+}
+
+char const* StorageManager::readUntilChar(char endChar) {
+	int32_t charPos = 0;
+
+	do {
+		int32_t bufferPosAtStart = fileBufferCurrentPos;
+		while (fileBufferCurrentPos < currentReadBufferEndPos && fileClusterBuffer[fileBufferCurrentPos] != endChar) {
+			fileBufferCurrentPos++;
+		}
+
+		// If possible, just return a pointer to the chars within the existing buffer
+		if (!charPos && fileBufferCurrentPos < currentReadBufferEndPos) {
+			fileClusterBuffer[fileBufferCurrentPos] = 0;
+
+			fileBufferCurrentPos++; // Gets us past the endChar
+			return &fileClusterBuffer[bufferPosAtStart];
+		}
+
+		int32_t numCharsHere = fileBufferCurrentPos - bufferPosAtStart;
+		int32_t numCharsToCopy = std::min<int32_t>(numCharsHere, kFilenameBufferSize - 1 - charPos);
+
+		if (numCharsToCopy > 0) {
+			memcpy(&stringBuffer[charPos], &fileClusterBuffer[bufferPosAtStart], numCharsToCopy);
+
+			charPos += numCharsToCopy;
+		}
+
+	} while (fileBufferCurrentPos == currentReadBufferEndPos && readXMLFileClusterIfNecessary());
+
+	fileBufferCurrentPos++; // Gets us past the endChar
+
+	xmlReadDone();
+
+	stringBuffer[charPos] = 0;
+	return stringBuffer;
+}
+
+// Unlike readUntilChar(), above, does not put a null character at the end of the returned "string". And, has a preset number of chars.
+// And, returns NULL when nothing more to return.
+// numChars must be <= FILENAME_BUFFER_SIZE
+char const* StorageManager::readNextCharsOfTagOrAttributeValue(int32_t numChars) {
+
+	int32_t charPos = 0;
+
+	do {
+		int32_t bufferPosAtStart = fileBufferCurrentPos;
+		int32_t bufferPosAtEnd = bufferPosAtStart + numChars - charPos;
+
+		int32_t currentReadBufferEndPosNow = std::min<int32_t>(currentReadBufferEndPos, bufferPosAtEnd);
+
+		while (fileBufferCurrentPos < currentReadBufferEndPosNow) {
+			if (fileClusterBuffer[fileBufferCurrentPos] == charAtEndOfValue) {
+				goto reachedEndCharEarly;
+			}
+			fileBufferCurrentPos++;
+		}
+
+		int32_t numCharsHere = fileBufferCurrentPos - bufferPosAtStart;
+
+		// If we were able to just read the whole thing in one go, just return a pointer to the chars within the existing buffer
+		if (numCharsHere == numChars) {
+			xmlReadDone();
+			return &fileClusterBuffer[bufferPosAtStart];
+		}
+
+		// Otherwise, so long as we read something, add it to our buffer we're putting the output in
+		if (numCharsHere > 0) {
+			memcpy(&stringBuffer[charPos], &fileClusterBuffer[bufferPosAtStart], numCharsHere);
+
+			charPos += numCharsHere;
+
+			// And if we've now got all the chars we needed, return
+			if (charPos == numChars) {
+				xmlReadDone();
+				return stringBuffer;
+			}
+		}
+
+	} while (fileBufferCurrentPos == currentReadBufferEndPos && readXMLFileClusterIfNecessary());
+
+	// If we're here, the file ended
+	return NULL;
+
+	// And, additional bit we jump to when end-char reached
+reachedEndCharEarly:
+	fileBufferCurrentPos++; // Gets us past the endChar
+	if (charAtEndOfValue == '<') {
+		xmlArea = IN_TAG_NAME;
+	}
+	else {
+		xmlArea = IN_TAG_PAST_NAME; // Could be ' or "
+	}
+	return NULL;
+}
+
+// This is almost never called now - TODO: get rid
+char StorageManager::readNextCharOfTagOrAttributeValue() {
+
+	char thisChar;
+	if (!readCharXML(&thisChar)) {
+		return 0;
+	}
+	if (thisChar == charAtEndOfValue) {
+		if (charAtEndOfValue == '<') {
+			xmlArea = IN_TAG_NAME;
+		}
+		else {
+			xmlArea = IN_TAG_PAST_NAME; // Could be ' or "
+		}
+		xmlReadDone();
+		return 0;
+	}
+	return thisChar;
+}
+
+// Will always skip up until the end-char, even if it doesn't like the contents it sees
+int32_t StorageManager::readIntUntilChar(char endChar) {
+	uint32_t number = 0;
+	char thisChar;
+
+	if (!readCharXML(&thisChar)) {
+		return 0;
+	}
+
+	bool isNegative = (thisChar == '-');
+	if (!isNegative) {
+		goto readDigit;
+	}
+
+	while (true) {
+		// The digits are nearly always all in the buffer already, so take them straight from there
+		if (fileBufferCurrentPos < currentReadBufferEndPos) {
+			thisChar = fileClusterBuffer[fileBufferCurrentPos++];
+		}
+		else if (!readCharXML(&thisChar)) {
+			break;
+		}
+readDigit:
+		if (!(thisChar >= '0' && thisChar <= '9')) {
+			goto getOut;
+		}
+		number *= 10;
+		number += (thisChar - '0');
+	}
+
+	if (false) {
+getOut:
+		if (thisChar != endChar) {
+			skipUntilChar(endChar);
+		}
+	}
+
+	if (isNegative) {
+		if (number >= 2147483648) {
+			return -2147483648;
+		}
+		else {
+			return -(int32_t)number;
+		}
+	}
+	else {
+		return number;
+	}
+}
+
+char const* StorageManager::readTagOrAttributeValue() {
+
+	switch (xmlArea) {
+
+	case BETWEEN_TAGS:
+		xmlArea = IN_TAG_NAME; // How it'll be after this call
+		return readUntilChar('<');
+
+	case PAST_ATTRIBUTE_NAME:
+	case PAST_EQUALS_SIGN:
+		return readAttributeValue();
+
+	case IN_TAG_PAST_NAME: // Could happen if trying to read a value but instead of a value there are multiple more contents, like attributes etc. Obviously not "meant" to happen, but we need to cope.
+		return "";
+
+	default:
+		display->freezeWithError("BBBB");
+		__builtin_unreachable();
+	}
+}
+
+int32_t StorageManager::readTagOrAttributeValueInt() {
+
+	switch (xmlArea) {
+
+	case BETWEEN_TAGS:
+		xmlArea = IN_TAG_NAME; // How it'll be after this call
+		return readIntUntilChar('<');
+
+	case PAST_ATTRIBUTE_NAME:
+	case PAST_EQUALS_SIGN:
+		return readAttributeValueInt();
+
+	case IN_TAG_PAST_NAME: // Could happen if trying to read a value but instead of a value there are multiple more contents, like attributes etc. Obviously not "meant" to happen, but we need to cope.
+		return 0;
+
+	default:
+		display->freezeWithError("BBBB");
+		__builtin_unreachable();
+	}
+}
+
+// This isn't super optimal, like the int32_t version is, but only rarely used
+int32_t StorageManager::readTagOrAttributeValueHex(int32_t errorValue) {
+	char const* string = readTagOrAttributeValue();
+	if (string[0] != '0' || string[1] != 'x') {
+		return errorValue;
+	}
+	return hexToInt(&string[2]);
+}
+
+// Returns memory error
+int32_t StorageManager::readTagOrAttributeValueString(String* string) {
+
+	int32_t error;
+
+	switch (xmlArea) {
+	case BETWEEN_TAGS:
+		error = readStringUntilChar(string, '<');
+		if (!error) {
+			xmlArea = IN_TAG_NAME;
+		}
+		return error;
+
+	case PAST_ATTRIBUTE_NAME:
+	case PAST_EQUALS_SIGN:
+		return readAttributeValueString(string);
+
+	case IN_TAG_PAST_NAME: // Could happen if trying to read a value but instead of a value there are multiple more contents, like attributes etc. Obviously not "meant" to happen, but we need to cope.
+		return ERROR_FILE_CORRUPTED;
+
+	default:
+		if (ALPHA_OR_BETA_VERSION) {
+			display->freezeWithError("BBBB");
+		}
+		__builtin_unreachable();
+	}
+}
+
+int32_t StorageManager::getNumCharsRemainingInValue() {
+
+	int32_t pos = fileBufferCurrentPos;
+	while (pos < currentReadBufferEndPos && fileClusterBuffer[pos] != charAtEndOfValue) {
+		pos++;
+	}
+
+	return pos - fileBufferCurrentPos;
+}
+
+// Returns whether we're all good to go
+bool StorageManager::prepareToReadTagOrAttributeValueOneCharAtATime() {
+	switch (xmlArea) {
+
+	case BETWEEN_TAGS:
+		//xmlArea = IN_TAG_NAME; // How it'll be after reading all chars
+		charAtEndOfValue = '<';
+		return true;
+
+	case PAST_ATTRIBUTE_NAME:
+	case PAST_EQUALS_SIGN:
+		return getIntoAttributeValue();
+
+	default:
+		if (ALPHA_OR_BETA_VERSION) {
+			display->freezeWithError("CCCC");
+		}
+		__builtin_unreachable();
+	}
+}
+
+// Returns whether successful loading took place
+bool StorageManager::readXMLFileClusterIfNecessary() {
+
+	if (xmlReadAborted) {
+		xmlReachedEnd = true;
+		return false;
+	}
+
+	// Load next Cluster if necessary
+	if (fileBufferCurrentPos >= xmlClusterSize) {
+		bool result = readXMLFileCluster();
+		if (!result) {
+			xmlReachedEnd = true;
+		}
+		return result;
+	}
+
+	// Watch out for end of file
+	if (fileBufferCurrentPos >= currentReadBufferEndPos) {
+		xmlReachedEnd = true;
+	}
+
+	return false;
+}
+
+uint32_t StorageManager::readCharXML(char* thisChar) {
+
+	bool stillGoing = readXMLFileClusterIfNecessary();
+	if (xmlReachedEnd) {
+		return 0;
+	}
+
+	*thisChar = fileClusterBuffer[fileBufferCurrentPos];
+
+	fileBufferCurrentPos++;
+
+	return 1;
+}
+
+void StorageManager::exitTag(char const* exitTagName) {
+
+	while (tagDepthFile >= tagDepthCaller) {
+
+		if (xmlReachedEnd) {
+			return;
+		}
+
+		switch (xmlArea) {
+
+		case PAST_ATTRIBUTE_NAME:
+		case PAST_EQUALS_SIGN:
+			readAttributeValue();
+			break;
+
+		case IN_ATTRIBUTE_VALUE: // Could get left in here after a char-at-a-time read
+			skipUntilChar(charAtEndOfValue);
+			xmlArea = IN_TAG_PAST_NAME;
+			// No break
+
+		case IN_TAG_PAST_NAME:
+		case BETWEEN_TAGS:
+		case IN_TAG_NAME:
+			skipUntilTagDepthBelow(tagDepthCaller);
+			break;
+
+		default:
+			if (ALPHA_OR_BETA_VERSION) {
+				display->freezeWithError("AAAA"); // Really shouldn't be possible anymore, I feel fairly certain...
+			}
+			__builtin_unreachable();
+		}
+	}
+
+	tagDepthCaller--;
+}
+
+bool StorageManager::readXMLFileCluster() {
+
+	AudioEngine::logAction("readXMLFileCluster");
+
+	FRESULT result = f_read(&fileSystemStuff.currentFile, (UINT*)fileClusterBuffer, xmlClusterSize,
+	                        &currentReadBufferEndPos);
+	if (result) {
+		fileAccessFailedDuring = true;
+		return false;
+	}
+
+	// If error or we reached end of file
+	if (!currentReadBufferEndPos) {
+		return false;
+	}
+
+	fileBufferCurrentPos = 0;
+
+	return true;
+}
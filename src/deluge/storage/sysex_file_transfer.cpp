@@ -0,0 +1,370 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/sysex_file_transfer.h"
+#include "io/midi/midi_device.h"
+#include "memory/general_memory_allocator.h"
+#include "storage/folder_index.h"
+#include "util/pack.h"
+#include <cstring>
+
+extern "C" {
+#include "fatfs/ff.h"
+}
+
+namespace SysexFileTransfer {
+
+namespace {
+
+constexpr int32_t kHeaderSize = 7; // F0 7D 04 command seq0 seq1 seq2
+constexpr int32_t kChunkSizeWithCRC = kChunkSize + 4;
+constexpr int32_t kPackedChunkSizeWithCRC = (kChunkSizeWithCRC + 6) / 7 * 8;
+constexpr int32_t kBufferSize = kChunkSize * 8; // Each of the two
+
+enum class TransferState : uint8_t {
+	IDLE,
+	OPEN_PENDING, // Waiting for slowRoutine() to open the file
+	WRITING,
+	READING,
+	CLOSE_PENDING, // Waiting for slowRoutine() to write what's left and close the file
+	ABORT_PENDING,
+};
+
+// The sysex handler can run in the middle of slowRoutine()'s card access, via the audio routine - though never
+// anywhere else in it. So the handler only ever fills the buffer that isn't full, and only slowRoutine() empties full
+// ones
+volatile TransferState state = TransferState::IDLE;
+bool openingForWrite;
+MIDIDevice* transferDevice;
+FIL file;
+char path[256];
+
+uint8_t* buffers[2]; // Both in one allocation, only while writing
+int32_t bufferFill[2];
+volatile bool bufferFull[2];
+int32_t fillingBuffer;
+uint32_t nextChunkNum;
+bool cardFailed;
+
+uint32_t readRequests[kWindowSize];
+volatile int32_t numReadRequests;
+
+uint8_t replyBuffer[kHeaderSize + 1 + kPackedChunkSizeWithCRC + 1];
+
+uint32_t readSeq(uint8_t* data) {
+	return data[4] | (data[5] << 7) | (data[6] << 14);
+}
+
+// payload gets 7-bit packed
+void sendReply(Command command, uint32_t seq, Status status, uint8_t* payload = nullptr, int32_t payloadLength = 0) {
+	if (!transferDevice) {
+		return;
+	}
+	uint8_t* reply = replyBuffer;
+	reply[0] = 0xF0;
+	reply[1] = 0x7D;
+	reply[2] = 0x04;
+	reply[3] = 0x40 | (uint8_t)command;
+	reply[4] = seq & 0x7F;
+	reply[5] = (seq >> 7) & 0x7F;
+	reply[6] = (seq >> 14) & 0x7F;
+	reply[7] = (uint8_t)status;
+	int32_t len = kHeaderSize + 1;
+	if (payloadLength) {
+		len += pack_8bit_to_7bit(reply + len, sizeof(replyBuffer) - len - 1, payload, payloadLength);
+	}
+	reply[len++] = 0xF7;
+	transferDevice->sendSysex(reply, len);
+}
+
+void freeBuffers() {
+	if (buffers[0]) {
+		delugeDealloc(buffers[0]);
+		buffers[0] = nullptr;
+		buffers[1] = nullptr;
+	}
+}
+
+void writeChunkReceived(uint8_t* data, int32_t len) {
+	uint32_t seq = readSeq(data);
+
+	if (state != TransferState::WRITING) {
+		sendReply(Command::WRITE_CHUNK, seq, (state == TransferState::OPEN_PENDING) ? Status::BUSY : Status::NOT_OPEN);
+		return;
+	}
+	if (cardFailed) {
+		sendReply(Command::WRITE_CHUNK, seq, Status::CARD_ERROR);
+		return;
+	}
+
+	// Already got that one - our acknowledgement must have gone missing
+	if (seq < nextChunkNum) {
+		sendReply(Command::WRITE_CHUNK, seq, Status::OK);
+		return;
+	}
+	if (seq > nextChunkNum) {
+		sendReply(Command::WRITE_CHUNK, nextChunkNum, Status::OUT_OF_ORDER);
+		return;
+	}
+
+	uint8_t chunk[kChunkSizeWithCRC];
+	int32_t chunkLength = unpack_7bit_to_8bit(chunk, sizeof(chunk), data + kHeaderSize, len - kHeaderSize - 1) - 4;
+	if (chunkLength <= 0) {
+		sendReply(Command::WRITE_CHUNK, seq, Status::BAD_CRC);
+		return;
+	}
+	uint32_t crc;
+	memcpy(&crc, chunk + chunkLength, 4);
+	if (get_crc(chunk, chunkLength) != crc) {
+		sendReply(Command::WRITE_CHUNK, seq, Status::BAD_CRC);
+		return;
+	}
+
+	if (bufferFill[fillingBuffer] + chunkLength > kBufferSize) {
+		int32_t otherBuffer = 1 - fillingBuffer;
+		if (bufferFull[otherBuffer]) {
+			sendReply(Command::WRITE_CHUNK, seq, Status::BUSY); // Card can't keep up. Host will resend
+			return;
+		}
+		bufferFull[fillingBuffer] = true;
+		fillingBuffer = otherBuffer;
+	}
+
+	memcpy(buffers[fillingBuffer] + bufferFill[fillingBuffer], chunk, chunkLength);
+	bufferFill[fillingBuffer] += chunkLength;
+	nextChunkNum++;
+	sendReply(Command::WRITE_CHUNK, seq, Status::OK);
+}
+
+void openReceived(MIDIDevice* device, uint8_t* data, int32_t len, bool forWrite) {
+	if (state != TransferState::IDLE) {
+		if (device == transferDevice) {
+			sendReply(forWrite ? Command::OPEN_WRITE : Command::OPEN_READ, 0, Status::BUSY);
+		}
+		return;
+	}
+
+	int32_t pathLength = len - kHeaderSize - 1;
+	if (pathLength <= 0 || pathLength >= sizeof(path)) {
+		return;
+	}
+	memcpy(path, data + kHeaderSize, pathLength);
+	path[pathLength] = 0;
+
+	transferDevice = device;
+	openingForWrite = forWrite;
+	state = TransferState::OPEN_PENDING;
+}
+
+// Returns whether it all went ok
+bool writeFullBuffers() {
+	// The one not being filled is always the older
+	for (int32_t i = 0; i < 2; i++) {
+		int32_t b = (fillingBuffer + 1 + i) & 1;
+		if (!bufferFull[b]) {
+			continue;
+		}
+		UINT bytesWritten;
+		FRESULT result = f_write(&file, buffers[b], bufferFill[b], &bytesWritten);
+		if (result != FR_OK || bytesWritten != bufferFill[b]) {
+			return false;
+		}
+		bufferFill[b] = 0;
+		bufferFull[b] = false;
+	}
+	return true;
+}
+
+void doOpen() {
+	if (openingForWrite) {
+		buffers[0] = (uint8_t*)GeneralMemoryAllocator::get().alloc(kBufferSize * 2, NULL, false, true);
+		if (!buffers[0]) {
+			state = TransferState::IDLE;
+			sendReply(Command::OPEN_WRITE, 0, Status::BUSY);
+			return;
+		}
+		buffers[1] = buffers[0] + kBufferSize;
+
+		if (f_open(&file, path, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK) {
+			freeBuffers();
+			state = TransferState::IDLE;
+			sendReply(Command::OPEN_WRITE, 0, Status::CARD_ERROR);
+			return;
+		}
+		FolderIndex::folderChanged(path);
+
+		bufferFill[0] = bufferFill[1] = 0;
+		bufferFull[0] = bufferFull[1] = false;
+		fillingBuffer = 0;
+		nextChunkNum = 0;
+		cardFailed = false;
+		state = TransferState::WRITING;
+		sendReply(Command::OPEN_WRITE, 0, Status::OK);
+	}
+	else {
+		if (f_open(&file, path, FA_READ) != FR_OK) {
+			state = TransferState::IDLE;
+			sendReply(Command::OPEN_READ, 0, Status::CARD_ERROR);
+			return;
+		}
+		numReadRequests = 0;
+		state = TransferState::READING;
+		uint32_t fileSize = f_size(&file);
+		sendReply(Command::OPEN_READ, 0, Status::OK, (uint8_t*)&fileSize, 4);
+	}
+}
+
+void doClose() {
+	if (openingForWrite) {
+		// Whatever's in the buffer being filled goes last
+		bufferFull[fillingBuffer] = (bufferFill[fillingBuffer] > 0);
+		bool success = !cardFailed && writeFullBuffers();
+		success = (f_close(&file) == FR_OK) && success;
+		freeBuffers();
+		state = TransferState::IDLE;
+		sendReply(Command::CLOSE, 0, success ? Status::OK : Status::CARD_ERROR);
+	}
+	else {
+		f_close(&file);
+		state = TransferState::IDLE;
+		sendReply(Command::CLOSE, 0, Status::OK);
+	}
+}
+
+void doAbort() {
+	f_close(&file);
+	if (openingForWrite) {
+		freeBuffers();
+		f_unlink(path); // Don't leave a partial file looking like the real thing
+	}
+	state = TransferState::IDLE;
+	sendReply(Command::ABORT, 0, Status::OK);
+}
+
+void serveReadRequest(uint32_t chunkNum) {
+	uint8_t chunk[kChunkSizeWithCRC];
+	UINT bytesRead = 0;
+	if (f_lseek(&file, chunkNum * kChunkSize) != FR_OK || f_read(&file, chunk, kChunkSize, &bytesRead) != FR_OK) {
+		sendReply(Command::READ_CHUNK, chunkNum, Status::CARD_ERROR);
+		return;
+	}
+	if (!bytesRead) {
+		sendReply(Command::READ_CHUNK, chunkNum, Status::END_OF_FILE);
+		return;
+	}
+	uint32_t crc = get_crc(chunk, bytesRead);
+	memcpy(chunk + bytesRead, &crc, 4);
+	sendReply(Command::READ_CHUNK, chunkNum, Status::OK, chunk, bytesRead + 4);
+}
+
+} // namespace
+
+void sysexReceived(MIDIDevice* device, uint8_t* data, int32_t len) {
+	if (len < kHeaderSize + 1) {
+		return;
+	}
+
+	Command command = (Command)data[3];
+
+	// Once a transfer's going, no one else gets to butt in
+	if (command != Command::OPEN_WRITE && command != Command::OPEN_READ && device != transferDevice) {
+		return;
+	}
+
+	switch (command) {
+	case Command::OPEN_WRITE:
+		openReceived(device, data, len, true);
+		break;
+
+	case Command::OPEN_READ:
+		openReceived(device, data, len, false);
+		break;
+
+	case Command::WRITE_CHUNK:
+		writeChunkReceived(data, len);
+		break;
+
+	case Command::READ_CHUNK:
+		if (state != TransferState::READING) {
+			sendReply(command, readSeq(data), Status::NOT_OPEN);
+		}
+		else if (numReadRequests >= kWindowSize) {
+			sendReply(command, readSeq(data), Status::BUSY);
+		}
+		else {
+			readRequests[numReadRequests] = readSeq(data);
+			numReadRequests = numReadRequests + 1;
+		}
+		break;
+
+	case Command::CLOSE:
+		if (state == TransferState::WRITING || state == TransferState::READING) {
+			state = TransferState::CLOSE_PENDING;
+		}
+		else {
+			sendReply(command, 0, Status::NOT_OPEN);
+		}
+		break;
+
+	case Command::ABORT:
+		if (state == TransferState::WRITING || state == TransferState::READING) {
+			state = TransferState::ABORT_PENDING;
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+void slowRoutine() {
+	switch (state) {
+	case TransferState::OPEN_PENDING:
+		doOpen();
+		break;
+
+	case TransferState::WRITING:
+		if (!cardFailed && !writeFullBuffers()) {
+			cardFailed = true; // Reported on the next chunk, and at CLOSE
+		}
+		break;
+
+	case TransferState::READING:
+		// More requests can arrive during each f_read(), so take them one at a time from the front
+		while (numReadRequests) {
+			serveReadRequest(readRequests[0]);
+			for (int32_t i = 1; i < numReadRequests; i++) {
+				readRequests[i - 1] = readRequests[i];
+			}
+			numReadRequests = numReadRequests - 1;
+		}
+		break;
+
+	case TransferState::CLOSE_PENDING:
+		doClose();
+		break;
+
+	case TransferState::ABORT_PENDING:
+		doAbort();
+		break;
+
+	default:
+		break;
+	}
+}
+
+} // namespace SysexFileTransfer
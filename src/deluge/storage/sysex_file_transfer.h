@@ -0,0 +1,68 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+class MIDIDevice;
+
+// Moving whole files on and off the card over sysex, one at a time.
+//
+// Every message is F0 7D 04 <command> <seq0> <seq1> <seq2> [payload] F7, with a 21-bit sequence number, lowest 7 bits
+// first - enough to number the chunks of a 1GB file. Replies use the same command with bit 6 set, then a status byte,
+// then any payload. File data is sent in chunks of up to kChunkSize bytes, each followed by its CRC32 (as from
+// get_crc()), and the whole lot 7-bit packed.
+//
+// Writing: OPEN_WRITE with the path as plain ASCII. Then WRITE_CHUNKs numbered from 0 - the host may have up to
+// kWindowSize of those unacknowledged at once. Each gets acknowledged once it's safely in RAM, or refused with a status
+// saying why, in which case the host goes back and resends from that chunk. Then CLOSE, acknowledged once everything's
+// actually on the card.
+//
+// Reading: OPEN_READ, whose acknowledgement carries the file size, packed. Then READ_CHUNK with the chunk number, up to
+// kWindowSize at once, each answered with the chunk, or EOF status once past the end.
+//
+// Nothing touches the card from within the sysex handler, which can be running in the audio routine. That all happens
+// in slowRoutine(), with incoming data double-buffered so one buffer can fill while the other's being written.
+namespace SysexFileTransfer {
+
+constexpr int32_t kChunkSize = 512;
+constexpr int32_t kWindowSize = 4;
+
+enum class Command : uint8_t {
+	OPEN_WRITE = 0,
+	WRITE_CHUNK = 1,
+	CLOSE = 2,
+	OPEN_READ = 3,
+	READ_CHUNK = 4,
+	ABORT = 5,
+};
+
+enum class Status : uint8_t {
+	OK = 0,
+	BUSY = 1,         // Try again in a moment
+	BAD_CRC = 2,      // Resend it
+	OUT_OF_ORDER = 3, // The sequence number in the reply is the chunk we're expecting next
+	CARD_ERROR = 4,
+	NOT_OPEN = 5,
+	END_OF_FILE = 6,
+};
+
+void sysexReceived(MIDIDevice* device, uint8_t* data, int32_t len);
+void slowRoutine();
+
+} // namespace SysexFileTransfer
@@ -289,6 +289,26 @@ gotError2:
 
 	AudioEngine::logAction("bands set up");
 	AudioEngine::routineWithClusterLoading();
+
+	// If all that's been worked out before and kept on the card, it can just be read back in
+	String bandsFilePath;
+	bool useFile = (!sample || sample->tempFilePathForRecording.isEmpty())
+	               && !getSidecarFilePath(&bandsFilePath, ".bands");
+	if (useFile) {
+		if (readBandsFile(bandsFilePath.get(), rawFileCycleSize)) {
+			setUpCycleTransitions();
+			return NO_ERROR;
+		}
+
+		// That went through storageManager.fileClusterBuffer, which is where the reader had its data
+		if (reader) {
+			error = reader->rereadCurrentCluster();
+			if (error) {
+				goto gotError2;
+			}
+		}
+	}
+
 	AudioEngine::logAction("allocating working memory");
 
 	// Create the temporary memory where we'll store the 32-bit int32_t version of the current cycle being read, to perform the FFT on.
@@ -720,14 +740,7 @@ transformBandToTimeDomain:
 		audioFileManager.removeReasonFromCluster(cluster, "E385");
 	}
 
-	if (numCycles > 1) {
-		int32_t numCycleTransitions = numCycles - 1;
-
-		numCycleTransitionsNextPowerOf2Magnitude = getMagnitudeOld(numCycleTransitions);
-		numCycleTransitionsNextPowerOf2 = 1 << numCycleTransitionsNextPowerOf2Magnitude;
-
-		waveIndexMultiplier = numCycleTransitions << (31 - numCycleTransitionsNextPowerOf2Magnitude);
-	}
+	setUpCycleTransitions();
 
 	// Dispose of temp memory
 	delugeDealloc(currentCycleInt32);
@@ -791,100 +804,241 @@ transformBandToTimeDomain:
 		}
 	}
 
+	if (useFile) {
+		writeBandsFile(bandsFilePath.get(), rawFileCycleSize);
+	}
+
 	return NO_ERROR;
 }
 
-__attribute__((optimize("unroll-loops"))) void
-WaveTable::doRenderingLoopSingleCycle(int32_t* __restrict__ thisSample, int32_t const* bufferEnd,
-                                      WaveTableBand* __restrict__ bandHere, uint32_t phase, uint32_t phaseIncrement,
-                                      const int16_t* __restrict__ kernel) {
+void WaveTable::setUpCycleTransitions() {
+	if (numCycles > 1) {
+		int32_t numCycleTransitions = numCycles - 1;
 
-	int32_t bandCycleSizeMagnitude = bandHere->cycleSizeMagnitude;
-	int16_t const* __restrict__ table = bandHere->dataAccessAddress;
+		numCycleTransitionsNextPowerOf2Magnitude = getMagnitudeOld(numCycleTransitions);
+		numCycleTransitionsNextPowerOf2 = 1 << numCycleTransitionsNextPowerOf2Magnitude;
 
-	do {
-		phase += phaseIncrement;
+		waveIndexMultiplier = numCycleTransitions << (31 - numCycleTransitionsNextPowerOf2Magnitude);
+	}
+}
 
-		// Work out the location of the waveform data in memory
-		int32_t whichValueCentral = (phase >> (32 - bandCycleSizeMagnitude));
-		uint32_t whichValue = whichValueCentral - (kInterpolationMaxNumSamples >> 1);
-		int32_t whichValueStored[2];
+// Band files are sidecar files (see AudioFile::getSidecarFilePath()) ending ".bands", so setup() needn't do all its
+// FFTs again each time the WaveTable's loaded - including after it's been stolen. Their data is a BandsFileParams,
+// then each band's data in turn, as in memory, with every cycle and the duplicate samples at the end of each
+constexpr uint32_t kBandsFileMagic = 0x444e4244; // "DBND"
+constexpr uint16_t kBandsFileVersion = 1;
 
-		for (int32_t i = 0; i < (kInterpolationMaxNumSamples >> 3); i++) {
-			whichValue = whichValue & ((1 << bandCycleSizeMagnitude) - 1);
-			whichValueStored[i] = whichValue;
-			whichValue += 8;
+struct BandsFileParams {
+	uint32_t rawFileCycleSize;
+	uint32_t numCycles;
+	uint32_t numBands;
+};
+
+int32_t WaveTable::getBandsFileDataSize() {
+	int32_t dataSize = sizeof(BandsFileParams);
+	for (int32_t b = 0; b < bands.getNumElements(); b++) {
+		WaveTableBand* band = (WaveTableBand*)bands.getElementAddress(b);
+		dataSize += numCycles * (band->cycleSizeNoDuplicates + WAVETABLE_NUM_DUPLICATE_SAMPLES_AT_END_OF_CYCLE)
+		            * sizeof(int16_t);
+	}
+	return dataSize;
+}
+
+// Fills in the bands, just as allocated by setup(), from the file if there's one that matches them. Returns whether it
+// did
+bool WaveTable::readBandsFile(char const* bandsFilePath, int32_t rawFileCycleSize) {
+	FIL file;
+	if (!openSidecarFile(&file, bandsFilePath, kBandsFileMagic, kBandsFileVersion, getBandsFileDataSize())) {
+		return false;
+	}
+
+	BandsFileParams params;
+	bool success = readSidecarData(&file, (uint8_t*)&params, sizeof(params))
+	               && params.rawFileCycleSize == rawFileCycleSize && params.numCycles == numCycles
+	               && params.numBands == bands.getNumElements();
+
+	for (int32_t b = 0; success && b < bands.getNumElements(); b++) {
+		WaveTableBand* band = (WaveTableBand*)bands.getElementAddress(b);
+		uint8_t* data = (uint8_t*)band->dataAccessAddress;
+		int32_t bandSize = numCycles * (band->cycleSizeNoDuplicates + WAVETABLE_NUM_DUPLICATE_SAMPLES_AT_END_OF_CYCLE)
+		                   * sizeof(int16_t);
+
+		for (int32_t bytesDone = 0; success && bytesDone < bandSize;) {
+			AudioEngine::routineWithClusterLoading();
+			int32_t bytesNow = std::min<int32_t>(bandSize - bytesDone, audioFileManager.clusterSize);
+			success = readSidecarData(&file, &data[bytesDone], bytesNow);
+			bytesDone += bytesNow;
+		}
+
+		band->fromCycleNumber = 0;
+		band->toCycleNumber = numCycles;
+	}
+
+	f_close(&file);
+	return success;
+}
+
+// Only once setup() has finished with the reader, as this writes through storageManager.fileClusterBuffer too
+void WaveTable::writeBandsFile(char const* bandsFilePath, int32_t rawFileCycleSize) {
+
+	// Bands that have been trimmed, or that are missing because there wasn't the RAM for them, wouldn't be fit for
+	// reuse
+	if (bands.getNumElements() < 1) {
+		return;
+	}
+	for (int32_t b = 0; b < bands.getNumElements(); b++) {
+		WaveTableBand* band = (WaveTableBand*)bands.getElementAddress(b);
+		if (band->fromCycleNumber != 0 || band->toCycleNumber != numCycles
+		    || band->cycleSizeNoDuplicates != (((WaveTableBand*)bands.getElementAddress(0))->cycleSizeNoDuplicates >> b)) {
+			return;
 		}
+	}
+
+	FIL file;
+	if (!createSidecarFile(&file, bandsFilePath, kBandsFileMagic, kBandsFileVersion, getBandsFileDataSize())) {
+		return;
+	}
 
-		// Grab the actual waveform data from memory
-		int16x8x2_t interpolationBuffer;
-		for (int32_t i = 0; i < (kInterpolationMaxNumSamples >> 3); i++) {
-			interpolationBuffer.val[i] = vld1q_s16(&table[whichValueStored[i]]);
+	BandsFileParams params = {(uint32_t)rawFileCycleSize, (uint32_t)numCycles, (uint32_t)bands.getNumElements()};
+	bool success = writeSidecarData(&file, (uint8_t const*)&params, sizeof(params));
+
+	for (int32_t b = 0; success && b < bands.getNumElements(); b++) {
+		WaveTableBand* band = (WaveTableBand*)bands.getElementAddress(b);
+		uint8_t const* data = (uint8_t const*)band->dataAccessAddress;
+		int32_t bandSize = numCycles * (band->cycleSizeNoDuplicates + WAVETABLE_NUM_DUPLICATE_SAMPLES_AT_END_OF_CYCLE)
+		                   * sizeof(int16_t);
+
+		for (int32_t bytesDone = 0; success && bytesDone < bandSize;) {
+			AudioEngine::routineWithClusterLoading();
+			int32_t bytesNow = std::min<int32_t>(bandSize - bytesDone, audioFileManager.clusterSize);
+			success = writeSidecarData(&file, &data[bytesDone], bytesNow);
+			bytesDone += bytesNow;
 		}
+	}
+
+	finishWritingSidecarFile(&file, bandsFilePath, success);
+}
 
 // Get the windowed sinc kernel that we need for this individual audio-sample
 #define numBitsInWindowedSyncTableSize 8
 #define rshiftAmount ((32 + kInterpolationMaxNumSamplesMagnitude) - 16 - numBitsInWindowedSyncTableSize + 1)
 
-		uint32_t rshifted =
-		    ((uint32_t)-phase)
-		    >> (rshiftAmount
-		        - bandCycleSizeMagnitude); // Warning - rshiftAmount is 13, so bandCycleSizeMagnitude better not be bigger than that!
-		int16_t strength2 = rshifted & 32767;
+// Works out where in the cycle the waveform data for one sample is, and the windowed sinc kernel to apply to it
+[[gnu::always_inline]] static inline void getWhichValuesAndKernel(uint32_t phase, int32_t bandCycleSizeMagnitude,
+                                                                  const int16_t* __restrict__ kernel,
+                                                                  int32_t* whichValueStored,
+                                                                  int16x8_t* kernelVector) {
+	int32_t whichValueCentral = (phase >> (32 - bandCycleSizeMagnitude));
+	uint32_t whichValue = whichValueCentral - (kInterpolationMaxNumSamples >> 1);
+
+	for (int32_t i = 0; i < (kInterpolationMaxNumSamples >> 3); i++) {
+		whichValue = whichValue & ((1 << bandCycleSizeMagnitude) - 1);
+		whichValueStored[i] = whichValue;
+		whichValue += 8;
+	}
+
+	uint32_t rshifted =
+	    ((uint32_t)-phase)
+	    >> (rshiftAmount
+	        - bandCycleSizeMagnitude); // Warning - rshiftAmount is 13, so bandCycleSizeMagnitude better not be bigger than that!
+	int16_t strength2 = rshifted & 32767;
 
-		int32_t windowedSincTableLineOffsetBytes =
-		    ((uint32_t)-phase)
-		    >> (32 + kInterpolationMaxNumSamplesMagnitude - numBitsInWindowedSyncTableSize - 5
-		        - bandCycleSizeMagnitude); // The -5 is for 32 bytes (16 samples) per line in the windowed sinc table.
-		windowedSincTableLineOffsetBytes &= 0b111100000;
-		int16_t const* __restrict__ sincKernelReadPos =
-		    (int16_t const*)((uint32_t)&kernel[0] + windowedSincTableLineOffsetBytes);
+	int32_t windowedSincTableLineOffsetBytes =
+	    ((uint32_t)-phase)
+	    >> (32 + kInterpolationMaxNumSamplesMagnitude - numBitsInWindowedSyncTableSize - 5
+	        - bandCycleSizeMagnitude); // The -5 is for 32 bytes (16 samples) per line in the windowed sinc table.
+	windowedSincTableLineOffsetBytes &= 0b111100000;
+	int16_t const* __restrict__ sincKernelReadPos =
+	    (int16_t const*)((uint32_t)&kernel[0] + windowedSincTableLineOffsetBytes);
 
-		int16x8_t kernelVector[kInterpolationMaxNumSamples >> 3];
+	/*
+	int16x8x4_t windowedSincReadValues = vld4q_s16(sincKernelReadPos); // Insanely, I could not get this to work. Tried reading 2 values, too. I just get some noise from final output.
 
-		/*
-		int16x8x4_t windowedSincReadValues = vld4q_s16(sincKernelReadPos); // Insanely, I could not get this to work. Tried reading 2 values, too. I just get some noise from final output.
+	for (int32_t i = 0; i < (kInterpolationMaxNumSamples >> 3); i++) {
+		int16x8_t difference = vsubq_s16(windowedSincReadValues.val[i + 2], windowedSincReadValues.val[i]);
+		int16x8_t multipliedDifference = vqdmulhq_n_s16(difference, strength2);
+		kernelVector[i] = vaddq_s16(windowedSincReadValues.val[i], multipliedDifference);
+	}
+	*/
 
-		for (int32_t i = 0; i < (kInterpolationMaxNumSamples >> 3); i++) {
-			int16x8_t difference = vsubq_s16(windowedSincReadValues.val[i + 2], windowedSincReadValues.val[i]);
-			int16x8_t multipliedDifference = vqdmulhq_n_s16(difference, strength2);
-			kernelVector[i] = vaddq_s16(windowedSincReadValues.val[i], multipliedDifference);
-		}
-		*/
+	for (int32_t i = 0; i < (kInterpolationMaxNumSamples >> 3); i++) {
+		int16x8_t value1 = vld1q_s16(sincKernelReadPos + (i << 3));
+		int16x8_t value2 = vld1q_s16(sincKernelReadPos + 16 + (i << 3));
 
-		for (int32_t i = 0; i < (kInterpolationMaxNumSamples >> 3); i++) {
-			int16x8_t value1 = vld1q_s16(sincKernelReadPos + (i << 3));
-			int16x8_t value2 = vld1q_s16(sincKernelReadPos + 16 + (i << 3));
+		int16x8_t difference = vsubq_s16(value2, value1);
+		int16x8_t multipliedDifference = vqdmulhq_n_s16(difference, strength2);
+		kernelVector[i] = vaddq_s16(value1, multipliedDifference);
+	}
+}
 
-			int16x8_t difference = vsubq_s16(value2, value1);
-			int16x8_t multipliedDifference = vqdmulhq_n_s16(difference, strength2);
-			kernelVector[i] = vaddq_s16(value1, multipliedDifference);
+// Applies the windowed sinc kernel to the waveform data, giving 4 values which still need adding together
+[[gnu::always_inline]] static inline int32x4_t applyKernel(int16_t const* __restrict__ table,
+                                                           int32_t const* whichValueStored,
+                                                           int16x8_t const* kernelVector) {
+	int32x4_t multiplied;
+	for (int32_t i = 0; i < (kInterpolationMaxNumSamples >> 3); i++) {
+		int16x8_t interpolationBuffer = vld1q_s16(&table[whichValueStored[i]]);
+
+		if (i == 0) {
+			multiplied = vmull_s16(vget_low_s16(kernelVector[i]), vget_low_s16(interpolationBuffer));
+		}
+		else {
+			multiplied = vmlal_s16(multiplied, vget_low_s16(kernelVector[i]), vget_low_s16(interpolationBuffer));
 		}
 
-		// Apply the windowed sinc kernel to the waveform data
-		int32x4_t multiplied;
-		for (int32_t i = 0; i < (kInterpolationMaxNumSamples >> 3); i++) {
+		multiplied = vmlal_s16(multiplied, vget_high_s16(kernelVector[i]), vget_high_s16(interpolationBuffer));
+	}
+	return multiplied;
+}
 
-			if (i == 0) {
-				multiplied = vmull_s16(vget_low_s16(kernelVector[i]), vget_low_s16(interpolationBuffer.val[i]));
-			}
-			else {
-				multiplied =
-				    vmlal_s16(multiplied, vget_low_s16(kernelVector[i]), vget_low_s16(interpolationBuffer.val[i]));
-			}
+// Adds up each of 4 samples' applyKernel() results, giving all 4 finished samples in one vector
+[[gnu::always_inline]] static inline int32x4_t addUpKernelResults(int32x4_t const* multiplied) {
+	int32x2_t twosies[4];
+	for (int32_t s = 0; s < 4; s++) {
+		twosies[s] = vadd_s32(vget_high_s32(multiplied[s]), vget_low_s32(multiplied[s]));
+	}
+	return vcombine_s32(vpadd_s32(twosies[0], twosies[1]), vpadd_s32(twosies[2], twosies[3]));
+}
 
-			multiplied =
-			    vmlal_s16(multiplied, vget_high_s16(kernelVector[i]), vget_high_s16(interpolationBuffer.val[i]));
-		}
+// Or for just one sample
+[[gnu::always_inline]] static inline int32_t addUpKernelResult(int32x4_t multiplied) {
+	int32x2_t twosies = vadd_s32(vget_high_s32(multiplied), vget_low_s32(multiplied));
+	int32x2_t onesie = vpadd_s32(twosies, twosies);
+	return vget_lane_s32(onesie, 0);
+}
+
+// Both of these render 4 samples at a time for as long as they can, and then any left over one at a time. The kernel
+// still has to be done separately for each sample, but adding up its results and crossfading between cycles gets done
+// for all 4 together.
+__attribute__((optimize("unroll-loops"))) void
+WaveTable::doRenderingLoopSingleCycle(int32_t* __restrict__ thisSample, int32_t const* bufferEnd,
+                                      WaveTableBand* __restrict__ bandHere, uint32_t phase, uint32_t phaseIncrement,
+                                      const int16_t* __restrict__ kernel) {
+
+	int32_t bandCycleSizeMagnitude = bandHere->cycleSizeMagnitude;
+	int16_t const* __restrict__ table = bandHere->dataAccessAddress;
 
-		int32x2_t twosies = vadd_s32(vget_high_s32(multiplied), vget_low_s32(multiplied));
-		int32x2_t onesie = vpadd_s32(twosies, twosies);
+	int32_t whichValueStored[kInterpolationMaxNumSamples >> 3];
+	int16x8_t kernelVector[kInterpolationMaxNumSamples >> 3];
 
-		int32_t singleCycleFinalValue = vget_lane_s32(onesie, 0);
+	while (bufferEnd - thisSample >= 4) {
+		int32x4_t multiplied[4];
+		for (int32_t s = 0; s < 4; s++) {
+			phase += phaseIncrement;
+			getWhichValuesAndKernel(phase, bandCycleSizeMagnitude, kernel, whichValueStored, kernelVector);
+			multiplied[s] = applyKernel(table, whichValueStored, kernelVector);
+		}
 
-		*thisSample = singleCycleFinalValue;
+		vst1q_s32(thisSample, addUpKernelResults(multiplied));
+		thisSample += 4;
+	}
 
-	} while (++thisSample != bufferEnd);
+	while (thisSample != bufferEnd) {
+		phase += phaseIncrement;
+		getWhichValuesAndKernel(phase, bandCycleSizeMagnitude, kernel, whichValueStored, kernelVector);
+		*thisSample = addUpKernelResult(applyKernel(table, whichValueStored, kernelVector));
+		thisSample++;
+	}
 }
 
 #define NUM_BITS_IN_WAVE_INDEX_SCALED_INPUT 30
@@ -902,93 +1056,54 @@ WaveTable::doRenderingLoop(int32_t* __restrict__ thisSample, int32_t const* buff
 	int16_t const* __restrict__ table1 = &bandData[firstCycleNumber * bandCycleSizeWithDuplicates];
 	int16_t const* __restrict__ table2 = table1 + bandCycleSizeWithDuplicates;
 
-	do {
-		phase += phaseIncrement;
-
-		// Work out the location of the waveform data in memory
-		int32_t whichValueCentral = (phase >> (32 - bandCycleSizeMagnitude));
-		uint32_t whichValue = whichValueCentral - (kInterpolationMaxNumSamples >> 1);
-		int32_t whichValueStored[2];
-
-		for (int32_t i = 0; i < kInterpolationMaxNumSamples >> 3; i++) {
-			whichValue = whichValue & ((1 << bandCycleSizeMagnitude) - 1);
-			whichValueStored[i] = whichValue;
-			whichValue += 8;
-		}
-
-		// Grab the actual waveform data from memory, for both cycles that we need for this sample
-		int16x8x2_t interpolationBuffer[2];
-		for (int32_t i = 0; i < kInterpolationMaxNumSamples >> 3; i++) {
-			interpolationBuffer[0].val[i] = vld1q_s16(&table1[whichValueStored[i]]);
-		}
-		for (int32_t i = 0; i < kInterpolationMaxNumSamples >> 3; i++) {
-			interpolationBuffer[1].val[i] = vld1q_s16(&table2[whichValueStored[i]]);
-		}
-
-// Get the windowed sinc kernel that we need for this individual audio-sample
-#define numBitsInWindowedSyncTableSize 8
-#define rshiftAmount ((32 + kInterpolationMaxNumSamplesMagnitude) - 16 - numBitsInWindowedSyncTableSize + 1)
-
-		uint32_t rshifted =
-		    ((uint32_t)-phase)
-		    >> (rshiftAmount
-		        - bandCycleSizeMagnitude); // Warning - rshiftAmount is 13, so bandCycleSizeMagnitude better not be bigger than that!
-		int16_t strength2 = rshifted & 32767;
-
-		int32_t windowedSincTableLineOffsetBytes =
-		    ((uint32_t)-phase)
-		    >> (32 + kInterpolationMaxNumSamplesMagnitude - numBitsInWindowedSyncTableSize - 5
-		        - bandCycleSizeMagnitude); // The -5 is for 32 bytes (16 samples) per line in the windowed sinc table.
-		windowedSincTableLineOffsetBytes &= 0b111100000;
-		int16_t const* __restrict__ sincKernelReadPos =
-		    (int16_t const*)((uint32_t)&kernel[0] + windowedSincTableLineOffsetBytes);
-
-		int16x8_t kernelVector[kInterpolationMaxNumSamples >> 3];
-
-		/*
-		int16x8x4_t windowedSincReadValues = vld4q_s16(sincKernelReadPos); // Insanely, I could not get this to work. Tried reading 2 values, too. I just get some noise from final output.
+	int32_t whichValueStored[kInterpolationMaxNumSamples >> 3];
+	int16x8_t kernelVector[kInterpolationMaxNumSamples >> 3];
 
-		for (int32_t i = 0; i < (kInterpolationMaxNumSamples >> 3); i++) {
-			int16x8_t difference = vsubq_s16(windowedSincReadValues.val[i + 2], windowedSincReadValues.val[i]);
-			int16x8_t multipliedDifference = vqdmulhq_n_s16(difference, strength2);
-			kernelVector[i] = vaddq_s16(windowedSincReadValues.val[i], multipliedDifference);
-		}
-		*/
-
-		for (int32_t i = 0; i < (kInterpolationMaxNumSamples >> 3); i++) {
-			int16x8_t value1 = vld1q_s16(sincKernelReadPos + (i << 3));
-			int16x8_t value2 = vld1q_s16(sincKernelReadPos + 16 + (i << 3));
-
-			int16x8_t difference = vsubq_s16(value2, value1);
-			int16x8_t multipliedDifference = vqdmulhq_n_s16(difference, strength2);
-			kernelVector[i] = vaddq_s16(value1, multipliedDifference);
-		}
-
-		// Apply the windowed sinc kernel to the waveform data
-		int32x2_t twosies[2];
-		for (int32_t c = 0; c < 2; c++) {
-			int32x4_t multiplied;
-			for (int32_t i = 0; i < (kInterpolationMaxNumSamples >> 3); i++) {
-
-				if (i == 0) {
-					multiplied = vmull_s16(vget_low_s16(kernelVector[i]), vget_low_s16(interpolationBuffer[c].val[i]));
-				}
-				else {
-					multiplied = vmlal_s16(multiplied, vget_low_s16(kernelVector[i]),
-					                       vget_low_s16(interpolationBuffer[c].val[i]));
-				}
+	if (bufferEnd - thisSample >= 4) {
+		uint32x4_t crossCycleStrength2Vector = {crossCycleStrength2, crossCycleStrength2 + crossCycleStrength2Increment,
+		                                        crossCycleStrength2 + crossCycleStrength2Increment * 2,
+		                                        crossCycleStrength2 + crossCycleStrength2Increment * 3};
+		uint32x4_t crossCycleStrength2IncrementVector = vdupq_n_u32(crossCycleStrength2Increment * 4);
 
-				multiplied =
-				    vmlal_s16(multiplied, vget_high_s16(kernelVector[i]), vget_high_s16(interpolationBuffer[c].val[i]));
+		do {
+			// One value for each cycle, for each of the 4 samples
+			int32x4_t multiplied[2][4];
+			for (int32_t s = 0; s < 4; s++) {
+				phase += phaseIncrement;
+				getWhichValuesAndKernel(phase, bandCycleSizeMagnitude, kernel, whichValueStored, kernelVector);
+				multiplied[0][s] = applyKernel(table1, whichValueStored, kernelVector);
+				multiplied[1][s] = applyKernel(table2, whichValueStored, kernelVector);
 			}
+			int32x4_t value1 = addUpKernelResults(multiplied[0]);
+			int32x4_t difference = vsubq_s32(addUpKernelResults(multiplied[1]), value1);
+
+			// Linearly interpolate between the cycles - multiply_accumulate_32x32_rshift32_rounded() in each lane. Have
+			// to make value1 a magnitude smaller, because the difference is getting a magnitude smaller as a
+			// multiplication like this always does.
+			value1 = vshrq_n_s32(value1, 1);
+			int32x4_t strength = vreinterpretq_s32_u32(vshrq_n_u32(crossCycleStrength2Vector, 1));
+			int32x2_t waveTableFinalValueLow = vrshrn_n_s64(
+			    vmlal_s32(vshll_n_s32(vget_low_s32(value1), 32), vget_low_s32(difference), vget_low_s32(strength)), 32);
+			int32x2_t waveTableFinalValueHigh = vrshrn_n_s64(
+			    vmlal_s32(vshll_n_s32(vget_high_s32(value1), 32), vget_high_s32(difference), vget_high_s32(strength)),
+			    32);
+
+			vst1q_s32(thisSample, vcombine_s32(waveTableFinalValueLow, waveTableFinalValueHigh));
+
+			crossCycleStrength2Vector = vaddq_u32(crossCycleStrength2Vector, crossCycleStrength2IncrementVector);
+			thisSample += 4;
+		} while (bufferEnd - thisSample >= 4);
+
+		crossCycleStrength2 = vgetq_lane_u32(crossCycleStrength2Vector, 0);
+	}
 
-			twosies[c] = vadd_s32(vget_high_s32(multiplied), vget_low_s32(multiplied));
-		}
+	while (thisSample != bufferEnd) {
+		phase += phaseIncrement;
+		getWhichValuesAndKernel(phase, bandCycleSizeMagnitude, kernel, whichValueStored, kernelVector);
 
 		// We now have one value for each cycle, so linearly interpolate between those.
-		int32x2_t onesie = vpadd_s32(twosies[0], twosies[1]);
-		int32_t value1 = vget_lane_s32(onesie, 0);
-		int32_t difference = vget_lane_s32(onesie, 1) - value1;
+		int32_t value1 = addUpKernelResult(applyKernel(table1, whichValueStored, kernelVector));
+		int32_t difference = addUpKernelResult(applyKernel(table2, whichValueStored, kernelVector)) - value1;
 
 		int32_t waveTableFinalValue = multiply_accumulate_32x32_rshift32_rounded(
 		    value1 >> 1, difference,
@@ -998,8 +1113,8 @@ WaveTable::doRenderingLoop(int32_t* __restrict__ thisSample, int32_t const* buff
 		*thisSample = waveTableFinalValue;
 
 		crossCycleStrength2 += crossCycleStrength2Increment;
-
-	} while (++thisSample != bufferEnd);
+		thisSample++;
+	}
 }
 
 const int16_t* getKernel(int32_t phaseIncrement, int32_t bandMaxPhaseIncrement) {
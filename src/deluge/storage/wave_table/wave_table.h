@@ -67,6 +67,11 @@ protected:
 	void numReasonsDecreasedToZero(char const* errorCode);
 
 private:
+	void setUpCycleTransitions();
+	int32_t getBandsFileDataSize();
+	bool readBandsFile(char const* bandsFilePath, int32_t rawFileCycleSize);
+	void writeBandsFile(char const* bandsFilePath, int32_t rawFileCycleSize);
+
 	void doRenderingLoop(int32_t* __restrict__ thisSample, int32_t const* bufferEnd, int32_t firstCycleNumber,
 	                     WaveTableBand* __restrict__ bandHere, uint32_t phase, uint32_t phaseIncrement,
 	                     uint32_t waveIndexScaled, int32_t waveIndexIncrementScaled,
@@ -17,6 +17,7 @@
 
 #include "storage/wave_table/wave_table_band_data.h"
 #include "hid/display/display.h"
+#include "memory/general_memory_allocator.h"
 #include "storage/audio/audio_file_manager.h"
 #include "storage/wave_table/wave_table.h"
 
@@ -46,6 +47,13 @@ void WaveTableBandData::steal(char const* errorCode) {
 	audioFileManager.deleteUnusedAudioFileFromMemoryIndexUnknown(waveTable);
 }
 
+// Stealing any band deletes the whole WaveTable, so getting it back means reading the whole file in again and
+// regenerating every band. Each band is half the size of the one above, so they add up to about twice the biggest.
+uint32_t WaveTableBandData::getReloadCost() {
+	uint32_t size = GeneralMemoryAllocator::get().getAllocatedSize(this);
+	return ((size << 1) >> audioFileManager.clusterSizeMagnitude) + 1;
+}
+
 int32_t WaveTableBandData::getAppropriateQueue() {
 	return STEALABLE_QUEUE_NO_SONG_WAVETABLE_BAND_DATA;
 }
@@ -28,6 +28,7 @@ public:
 	bool mayBeStolen(void* thingNotToStealFrom = nullptr);
 	void steal(char const* errorCode);
 	int32_t getAppropriateQueue();
+	uint32_t getReloadCost() override;
 
 	WaveTable* waveTable;
 };
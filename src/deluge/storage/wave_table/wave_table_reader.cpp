@@ -51,3 +51,16 @@ int32_t WaveTableReader::readNewCluster() {
 		return NO_ERROR;
 	}
 }
+
+// For when something else has used storageManager.fileClusterBuffer in the meantime
+int32_t WaveTableReader::rereadCurrentCluster() {
+	if (currentClusterIndex < 0) {
+		return NO_ERROR; // Nothing read yet
+	}
+
+	FRESULT result = f_lseek(&fileSystemStuff.currentFile, currentClusterIndex * audioFileManager.clusterSize);
+	if (result) {
+		return ERROR_SD_CARD;
+	}
+	return readNewCluster();
+}
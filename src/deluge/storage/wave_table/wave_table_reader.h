@@ -24,4 +24,5 @@ public:
 	WaveTableReader();
 	int32_t readBytesPassedErrorChecking(char* outputBuffer, int32_t num);
 	int32_t readNewCluster();
+	int32_t rereadCurrentCluster();
 };
@@ -19,10 +19,18 @@
 
 #include "testing/automated_tester.h"
 #include "definitions_cxx.hpp"
+#include "fatfs/ff.h"
 #include "hid/encoders.h"
+#include "io/debug/cpu_profiler.h"
+#include "io/midi/midi_device.h"
+#include "io/midi/midi_device_manager.h"
+#include "playback/playback_handler.h"
 #include "processing/engines/audio_engine.h"
+#include "storage/audio/audio_file_manager.h"
+#include "storage/folder_index.h"
 #include "util/functions.h"
 #include <new>
+#include <string.h>
 
 extern "C" {
 #include "drivers/uart/uart.h"
@@ -58,7 +66,7 @@ public:
 class PlayButtonTestAction final : public TestAction {
 public:
 	TestState* perform() {
-		AutomatedTester::doMomentaryButtonPress(playButtonX, playButtonY);
+		AutomatedTester::doMomentaryButtonPress(playButtonCoord.x, playButtonCoord.y);
 		return NULL;
 	}
 	int32_t getTimeBetween() { return 1 * kSampleRate; }
@@ -86,7 +94,7 @@ void init() {
 }
 
 void turnSelectEncoder(int32_t offset) {
-	Encoders::encoders[ENCODER_THIS_CPU_SELECT].detentPos += offset;
+	Encoders::encoders[ENCODER_SELECT].detentPos += offset;
 }
 
 void doMomentaryButtonPress(int32_t x, int32_t y) {
@@ -96,7 +104,16 @@ void doMomentaryButtonPress(int32_t x, int32_t y) {
 	uartInsertFakeChar(UART_ITEM_PIC, value);
 }
 
+#if AUTOMATED_TESTER_SCRIPTED
+void recordRoutine();
+#endif
+
 void possiblyDoSomething() {
+#if AUTOMATED_TESTER_SCRIPTED
+	recordRoutine();
+	return;
+#endif
+
 	uint32_t timeNow = AudioEngine::audioSampleTimer;
 	uint32_t timeSinceLast = timeNow - timeLastCall;
 	if (!timeSinceLast)
@@ -122,6 +139,218 @@ void possiblyDoSomething() {
 
 	timeLastCall = timeNow;
 }
+
+#if AUTOMATED_TESTER_SCRIPTED
+
+// Scripted performance mode. Load the song to test with and start playback - the script below then gets played out,
+// timed from that moment, and once it's finished a line per second of how the CPU coped gets written to
+// kPerformanceLogPath. Run the same song and script on two firmware builds, and the logs can be compared directly.
+// Notes go in as if on MIDI channel 1 of the DIN port, so whatever's learned to, or following, that gets played.
+
+enum class ScriptedEventType : uint8_t {
+	BUTTON,         // a, b: x, y
+	SELECT_ENCODER, // a: offset
+	NOTE_ON,        // a: note, b: velocity
+	NOTE_OFF,       // a: note
+	END,
+};
+
+struct ScriptedEvent {
+	uint32_t time; // In samples, from when playback started
+	ScriptedEventType type;
+	int8_t a;
+	int8_t b;
+};
+
+constexpr uint32_t seconds(float s) {
+	return s * kSampleRate;
+}
+
+// Polyphony piles up to 12 held notes, the preset changes under them, then it all happens again with shorter notes
+const ScriptedEvent script[] = {
+    {seconds(2), ScriptedEventType::NOTE_ON, 48, 100},  {seconds(2), ScriptedEventType::NOTE_ON, 52, 100},
+    {seconds(2), ScriptedEventType::NOTE_ON, 55, 100},  {seconds(2), ScriptedEventType::NOTE_ON, 59, 100},
+    {seconds(6), ScriptedEventType::NOTE_ON, 60, 90},   {seconds(6), ScriptedEventType::NOTE_ON, 64, 90},
+    {seconds(6), ScriptedEventType::NOTE_ON, 67, 90},   {seconds(6), ScriptedEventType::NOTE_ON, 71, 90},
+    {seconds(10), ScriptedEventType::NOTE_ON, 72, 80},  {seconds(10), ScriptedEventType::NOTE_ON, 76, 80},
+    {seconds(10), ScriptedEventType::NOTE_ON, 79, 80},  {seconds(10), ScriptedEventType::NOTE_ON, 83, 80},
+    {seconds(14), ScriptedEventType::SELECT_ENCODER, 1, 0},
+    {seconds(20), ScriptedEventType::NOTE_OFF, 48, 0},  {seconds(20), ScriptedEventType::NOTE_OFF, 52, 0},
+    {seconds(20), ScriptedEventType::NOTE_OFF, 55, 0},  {seconds(20), ScriptedEventType::NOTE_OFF, 59, 0},
+    {seconds(20), ScriptedEventType::NOTE_OFF, 60, 0},  {seconds(20), ScriptedEventType::NOTE_OFF, 64, 0},
+    {seconds(20), ScriptedEventType::NOTE_OFF, 67, 0},  {seconds(20), ScriptedEventType::NOTE_OFF, 71, 0},
+    {seconds(20), ScriptedEventType::NOTE_OFF, 72, 0},  {seconds(20), ScriptedEventType::NOTE_OFF, 76, 0},
+    {seconds(20), ScriptedEventType::NOTE_OFF, 79, 0},  {seconds(20), ScriptedEventType::NOTE_OFF, 83, 0},
+    {seconds(22), ScriptedEventType::NOTE_ON, 36, 127}, {seconds(22.25), ScriptedEventType::NOTE_OFF, 36, 0},
+    {seconds(22.5), ScriptedEventType::NOTE_ON, 43, 127}, {seconds(22.75), ScriptedEventType::NOTE_OFF, 43, 0},
+    {seconds(23), ScriptedEventType::NOTE_ON, 48, 127}, {seconds(23.25), ScriptedEventType::NOTE_OFF, 48, 0},
+    {seconds(23.5), ScriptedEventType::NOTE_ON, 55, 127}, {seconds(23.75), ScriptedEventType::NOTE_OFF, 55, 0},
+    {seconds(26), ScriptedEventType::SELECT_ENCODER, -1, 0},
+    {seconds(30), ScriptedEventType::BUTTON, playButtonCoord.x, playButtonCoord.y},
+    {seconds(32), ScriptedEventType::END, 0, 0},
+};
+
+constexpr char const* kPerformanceLogPath = "PERFLOG.CSV";
+constexpr int32_t kMaxLogLines = 600; // Ten minutes' worth
+
+struct PerformanceLogLine {
+	uint32_t time;
+	uint32_t longestRoutineCycles;
+	uint32_t averageClusterLoadCycles;
+	uint32_t longestClusterLoadCycles;
+	uint16_t loadPermille;
+	uint16_t numVoiceCulls;
+	int8_t peakDireness;
+};
+
+PerformanceLogLine logLines[kMaxLogLines];
+int32_t numLogLines = 0;
+
+enum class ScriptState : uint8_t {
+	WAITING_FOR_PLAYBACK,
+	RUNNING,
+	FINISHED, // Log still to be written
+	DONE,
+};
+
+ScriptState scriptState = ScriptState::WAITING_FOR_PLAYBACK;
+uint32_t scriptStartTime;
+int32_t nextEventIndex;
+
+// What's been seen so far in this line's second
+PerformanceLogLine currentLine;
+uint32_t lineStartTime;
+uint32_t numVoiceCullsAtLineStart;
+
+void startLine(uint32_t timeNow) {
+	memset(&currentLine, 0, sizeof(currentLine));
+	lineStartTime = timeNow;
+	numVoiceCullsAtLineStart = AudioEngine::voiceStats.getNumCulls();
+	audioFileManager.longestClusterLoadCycles = 0;
+}
+
+// Called at the start of every audio routine - so the routine it reads the length of is the one before
+void recordRoutine() {
+	if (scriptState != ScriptState::RUNNING) {
+		return;
+	}
+
+	uint32_t timeNow = AudioEngine::audioSampleTimer;
+	currentLine.longestRoutineCycles =
+	    std::max(currentLine.longestRoutineCycles, Debug::cpuProfiler.getLastRoutineCycles());
+	currentLine.peakDireness = std::max<int8_t>(currentLine.peakDireness, AudioEngine::cpuDireness);
+
+	if (timeNow - lineStartTime >= kSampleRate) {
+		if (numLogLines < kMaxLogLines) {
+			currentLine.time = lineStartTime - scriptStartTime;
+			currentLine.loadPermille = Debug::cpuProfiler.getLoadPermille(Debug::ProfileStage::TOTAL);
+			currentLine.numVoiceCulls = AudioEngine::voiceStats.getNumCulls() - numVoiceCullsAtLineStart;
+			currentLine.averageClusterLoadCycles = audioFileManager.averageClusterLoadCycles;
+			currentLine.longestClusterLoadCycles = audioFileManager.longestClusterLoadCycles;
+			logLines[numLogLines++] = currentLine;
+		}
+		startLine(timeNow);
+	}
+}
+
+void doScriptedEvent(ScriptedEvent const& event) {
+	switch (event.type) {
+	case ScriptedEventType::BUTTON:
+		doMomentaryButtonPress(event.a, event.b);
+		break;
+
+	case ScriptedEventType::SELECT_ENCODER:
+		turnSelectEncoder(event.a);
+		break;
+
+	case ScriptedEventType::NOTE_ON:
+	case ScriptedEventType::NOTE_OFF: {
+		bool on = (event.type == ScriptedEventType::NOTE_ON);
+		bool doingMidiThru = false;
+		playbackHandler.noteMessageReceived(&MIDIDeviceManager::dinMIDIPorts, on, 0, event.a,
+		                                    on ? event.b : kDefaultLiftValue, &doingMidiThru);
+		break;
+	}
+
+	case ScriptedEventType::END:
+		scriptState = ScriptState::FINISHED;
+		break;
+	}
+}
+
+// Appends a number and then a separator
+char* appendToLine(char* pos, int32_t number, char separator) {
+	intToString(number, pos);
+	pos += strlen(pos);
+	*(pos++) = separator;
+	return pos;
+}
+
+void writeLog() {
+	FIL file;
+	if (f_open(&file, kPerformanceLogPath, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK) {
+		return;
+	}
+	FolderIndex::folderChanged(kPerformanceLogPath);
+
+	char const* header = "seconds,load_permille,longest_routine_cycles,peak_direness,voice_culls,"
+	                     "average_cluster_load_cycles,longest_cluster_load_cycles\n";
+	UINT bytesWritten;
+	f_write(&file, header, strlen(header), &bytesWritten);
+
+	char buffer[128];
+	for (int32_t l = 0; l < numLogLines; l++) {
+		PerformanceLogLine const& line = logLines[l];
+		char* pos = buffer;
+		pos = appendToLine(pos, line.time / kSampleRate, ',');
+		pos = appendToLine(pos, line.loadPermille, ',');
+		pos = appendToLine(pos, line.longestRoutineCycles, ',');
+		pos = appendToLine(pos, line.peakDireness, ',');
+		pos = appendToLine(pos, line.numVoiceCulls, ',');
+		pos = appendToLine(pos, line.averageClusterLoadCycles, ',');
+		pos = appendToLine(pos, line.longestClusterLoadCycles, '\n');
+		if (f_write(&file, buffer, pos - buffer, &bytesWritten) != FR_OK) {
+			break;
+		}
+	}
+
+	f_close(&file);
+}
+
+void slowRoutine() {
+	switch (scriptState) {
+	case ScriptState::WAITING_FOR_PLAYBACK:
+		if (playbackHandler.isEitherClockActive()) {
+			scriptStartTime = AudioEngine::audioSampleTimer;
+			nextEventIndex = 0;
+			numLogLines = 0;
+			startLine(scriptStartTime);
+			scriptState = ScriptState::RUNNING;
+		}
+		break;
+
+	case ScriptState::RUNNING: {
+		uint32_t timeSinceStart = AudioEngine::audioSampleTimer - scriptStartTime;
+		while (scriptState == ScriptState::RUNNING && script[nextEventIndex].time <= timeSinceStart) {
+			doScriptedEvent(script[nextEventIndex++]);
+		}
+		break;
+	}
+
+	case ScriptState::FINISHED:
+		writeLog();
+		scriptState = ScriptState::DONE;
+		break;
+
+	default:
+		break;
+	}
+}
+
+#else
+void slowRoutine() {
+}
+#endif
 } // namespace AutomatedTester
 
 #endif
@@ -23,5 +23,6 @@ void init();
 void turnSelectEncoder(int32_t offset);
 void doMomentaryButtonPress(int32_t x, int32_t y);
 void possiblyDoSomething();
+void slowRoutine(); // Main loop only - it may write to the card
 
 } // namespace AutomatedTester
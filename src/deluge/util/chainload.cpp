@@ -18,6 +18,7 @@
 #include "chainload.h"
 #include "RZA1/mtu/mtu.h"
 #include "definitions_cxx.hpp"
+#include "util/lz4.h"
 
 static void chainloader(uint32_t code_start, uint32_t code_size, uint32_t code_exec, char* buf) {
 	int32_t loop_num = (((uint32_t)code_size + 3) / (sizeof(uint32_t)));
@@ -58,3 +59,23 @@ void chainload_from_buf(uint8_t* buffer, int buf_size) {
 	auto ptr = (void (*)(uint32_t, uint32_t, uint32_t, char*))funcbuf;
 	ptr(user_code_start, code_size, user_code_exec, (char*)buffer);
 }
+
+// Decompresses a compressed image into image_buffer, then runs it as above. Only returns if that didn't work
+void chainload_from_compressed_buf(uint8_t* buffer, int buf_size, uint8_t* image_buffer, int image_buf_size) {
+	if (buf_size < COMPRESSED_HEADER_SIZE || *(uint32_t*)(buffer + OFF_COMPRESSED_MAGIC) != COMPRESSED_IMAGE_MAGIC) {
+		return;
+	}
+
+	int32_t compressed_size = *(uint32_t*)(buffer + OFF_COMPRESSED_SIZE);
+	int32_t decompressed_size = *(uint32_t*)(buffer + OFF_DECOMPRESSED_SIZE);
+	if (compressed_size > buf_size - COMPRESSED_HEADER_SIZE || decompressed_size > image_buf_size) {
+		return;
+	}
+
+	int32_t got = lz4_decompress_block(image_buffer, image_buf_size, buffer + COMPRESSED_HEADER_SIZE, compressed_size);
+	if (got != decompressed_size) {
+		return;
+	}
+
+	chainload_from_buf(image_buffer, decompressed_size);
+}
@@ -5,4 +5,14 @@
 #define OFF_USER_CODE_EXECUTE 0x28
 #define OFF_USER_SIGNATURE 0x2c
 
+// A compressed image, as made by scripts/util/compress_firmware.py, keeps the three words above where they are, but has
+// COMPRESSED_IMAGE_MAGIC in place of the signature, then the lengths of the LZ4 block following the header and of the
+// image it decompresses to
+#define OFF_COMPRESSED_MAGIC 0x2c
+#define OFF_COMPRESSED_SIZE 0x30
+#define OFF_DECOMPRESSED_SIZE 0x34
+#define COMPRESSED_HEADER_SIZE 0x40
+#define COMPRESSED_IMAGE_MAGIC 0x345a4c44 // "DLZ4"
+
 void chainload_from_buf(uint8_t* buffer, int buf_size);
+void chainload_from_compressed_buf(uint8_t* buffer, int buf_size, uint8_t* image_buffer, int image_buf_size);
@@ -17,12 +17,13 @@
 
 #pragma once
 
-#include "util/container/array/resizeable_array.h"
+#include "util/container/array/chunked_array.h"
+#include <cstddef>
 #include <cstdint>
 
-class CStringArray : public ResizeableArray {
+class CStringArray : public ChunkedArray {
 public:
-	CStringArray(int32_t newElementSize) : ResizeableArray(newElementSize) {}
+	CStringArray(int32_t newElementSize) : ChunkedArray(newElementSize) {}
 	void sortForStrings();
 	int32_t search(char const* searchString, bool* foundExact = NULL);
 
@@ -0,0 +1,288 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "util/container/array/chunked_array.h"
+#include "definitions_cxx.hpp"
+#include "hid/display/display.h"
+#include "memory/general_memory_allocator.h"
+#include <algorithm>
+#include <string.h>
+
+ChunkedArray::ChunkedArray(int32_t newElementSize, int32_t newNumElementsPerChunk)
+    : elementSize(newElementSize), numElementsPerChunk(newNumElementsPerChunk) {
+	numElements = 0;
+	chunks = NULL;
+	numChunks = 0;
+	chunkListSize = 0;
+	lastChunkIndex = 0;
+}
+
+ChunkedArray::~ChunkedArray() {
+	empty();
+}
+
+void ChunkedArray::empty() {
+	for (int32_t c = 0; c < numChunks; c++) {
+		delugeDealloc(chunks[c].memory);
+	}
+	if (chunks) {
+		delugeDealloc(chunks);
+	}
+	chunks = NULL;
+	numChunks = 0;
+	chunkListSize = 0;
+	lastChunkIndex = 0;
+	numElements = 0;
+}
+
+// index must be one that exists. Chunks are never left empty, so each one's firstIndex is bigger than the last one's
+int32_t ChunkedArray::getChunkIndex(int32_t index) {
+	Chunk* chunk = &chunks[lastChunkIndex];
+	if (index >= chunk->firstIndex) {
+		if (index < chunk->firstIndex + chunk->numElements) {
+			return lastChunkIndex;
+		}
+
+		// Going through in order, it'll be in the next one
+		if (lastChunkIndex + 1 < numChunks) {
+			chunk++;
+			if (index < chunk->firstIndex + chunk->numElements) {
+				return ++lastChunkIndex;
+			}
+		}
+	}
+
+	// Find the last chunk starting at or before index
+	int32_t rangeBegin = 0;
+	int32_t rangeEnd = numChunks - 1;
+	while (rangeBegin != rangeEnd) {
+		int32_t proposed = (rangeBegin + rangeEnd + 1) >> 1;
+		if (chunks[proposed].firstIndex <= index) {
+			rangeBegin = proposed;
+		}
+		else {
+			rangeEnd = proposed - 1;
+		}
+	}
+	lastChunkIndex = rangeBegin;
+	return rangeBegin;
+}
+
+void* ChunkedArray::getElementAddress(int32_t index) {
+	if (index < 0 || index >= numElements) {
+		return NULL;
+	}
+	int32_t c = getChunkIndex(index);
+	return getAddressInChunk(&chunks[c], index - chunks[c].firstIndex);
+}
+
+bool ChunkedArray::ensureChunkListSize(int32_t newNumChunks) {
+	if (newNumChunks <= chunkListSize) {
+		return true;
+	}
+
+	int32_t newListSize = std::max(newNumChunks, chunkListSize * 2);
+	newListSize = std::max<int32_t>(newListSize, 8);
+	Chunk* newChunks = (Chunk*)GeneralMemoryAllocator::get().alloc(newListSize * sizeof(Chunk), NULL, false, true);
+	if (!newChunks) {
+		return false;
+	}
+
+	if (chunks) {
+		memcpy(newChunks, chunks, numChunks * sizeof(Chunk));
+		delugeDealloc(chunks);
+	}
+	chunks = newChunks;
+	chunkListSize = newListSize;
+	return true;
+}
+
+// There must already be room in the list for them. Their numElements get set afterwards, and firstIndex by renumberFrom()
+void ChunkedArray::insertChunks(int32_t c, void** memories, int32_t num) {
+	memmove(&chunks[c + num], &chunks[c], (numChunks - c) * sizeof(Chunk));
+	for (int32_t i = 0; i < num; i++) {
+		chunks[c + i].memory = memories[i];
+		chunks[c + i].numElements = 0;
+	}
+	numChunks += num;
+	lastChunkIndex = 0;
+}
+
+void ChunkedArray::deleteChunk(int32_t c) {
+	delugeDealloc(chunks[c].memory);
+	memmove(&chunks[c], &chunks[c + 1], (numChunks - c - 1) * sizeof(Chunk));
+	numChunks--;
+	lastChunkIndex = 0;
+}
+
+void ChunkedArray::renumberFrom(int32_t c) {
+	int32_t index = c ? (chunks[c - 1].firstIndex + chunks[c - 1].numElements) : 0;
+	for (; c < numChunks; c++) {
+		chunks[c].firstIndex = index;
+		index += chunks[c].numElements;
+	}
+}
+
+// Only merges if that leaves room to spare, so an insert straight after doesn't just split them again
+void ChunkedArray::tryMergingWithNext(int32_t c) {
+	if (c < 0 || c + 1 >= numChunks) {
+		return;
+	}
+	Chunk* chunk = &chunks[c];
+	Chunk* nextChunk = &chunks[c + 1];
+	if (chunk->numElements + nextChunk->numElements > (numElementsPerChunk * 3) >> 2) {
+		return;
+	}
+
+	memcpy(getAddressInChunk(chunk, chunk->numElements), nextChunk->memory, nextChunk->numElements * elementSize);
+	chunk->numElements += nextChunk->numElements;
+	deleteChunk(c + 1);
+}
+
+// Returns error code. The new elements are left uninitialized. If there's not enough memory, nothing changes
+int32_t ChunkedArray::insertAtIndex(int32_t i, int32_t numToInsert) {
+	if (ALPHA_OR_BETA_VERSION && (i < 0 || i > numElements || numToInsert < 1)) {
+		display->freezeWithError("E468");
+	}
+
+	// Find the chunk, and the place in it, where they go. On the very end, that's the end of the last chunk
+	int32_t c = 0;
+	int32_t offset = 0;
+	if (numChunks) {
+		if (i == numElements) {
+			c = numChunks - 1;
+			offset = chunks[c].numElements;
+		}
+		else {
+			c = getChunkIndex(i);
+			offset = i - chunks[c].firstIndex;
+		}
+
+		// If they fit in that chunk, easy
+		Chunk* chunk = &chunks[c];
+		if (chunk->numElements + numToInsert <= numElementsPerChunk) {
+			memmove(getAddressInChunk(chunk, offset + numToInsert), getAddressInChunk(chunk, offset),
+			        (chunk->numElements - offset) * elementSize);
+			chunk->numElements += numToInsert;
+			numElements += numToInsert;
+			renumberFrom(c + 1);
+			return NO_ERROR;
+		}
+	}
+
+	// Otherwise, whatever's after the insertion point goes off into a chunk of its own, then the new elements fill the
+	// rest of this chunk and as many new ones after it as they need
+	int32_t numAfter = numChunks ? (chunks[c].numElements - offset) : 0;
+	int32_t numToInsertHere = numChunks ? std::min(numToInsert, numElementsPerChunk - offset) : 0;
+	int32_t numInNewChunks = numToInsert - numToInsertHere;
+	int32_t numNewChunksForInserting = (numInNewChunks + numElementsPerChunk - 1) / numElementsPerChunk;
+	int32_t numNewChunks = numNewChunksForInserting + (numAfter ? 1 : 0);
+
+	// Get all the memory first, so running out leaves things as they were
+	if (!ensureChunkListSize(numChunks + numNewChunks)) {
+		return ERROR_INSUFFICIENT_RAM;
+	}
+	void* newMemories[numNewChunks];
+	for (int32_t n = 0; n < numNewChunks; n++) {
+		newMemories[n] = GeneralMemoryAllocator::get().alloc(numElementsPerChunk * elementSize, NULL, false, true);
+		if (!newMemories[n]) {
+			while (n--) {
+				delugeDealloc(newMemories[n]);
+			}
+			return ERROR_INSUFFICIENT_RAM;
+		}
+	}
+
+	int32_t firstNewChunk = numChunks ? (c + 1) : 0;
+	insertChunks(firstNewChunk, newMemories, numNewChunks);
+
+	if (numAfter) {
+		Chunk* chunk = &chunks[c];
+		Chunk* tailChunk = &chunks[firstNewChunk + numNewChunksForInserting];
+		memcpy(tailChunk->memory, getAddressInChunk(chunk, offset), numAfter * elementSize);
+		tailChunk->numElements = numAfter;
+		chunk->numElements = offset;
+	}
+
+	if (numToInsertHere) {
+		chunks[c].numElements += numToInsertHere;
+	}
+
+	for (int32_t n = 0; n < numNewChunksForInserting; n++) {
+		int32_t numHere = std::min(numInNewChunks, numElementsPerChunk);
+		chunks[firstNewChunk + n].numElements = numHere;
+		numInNewChunks -= numHere;
+	}
+
+	numElements += numToInsert;
+	renumberFrom(c);
+	return NO_ERROR;
+}
+
+void ChunkedArray::deleteAtIndex(int32_t i, int32_t numToDelete) {
+	if (ALPHA_OR_BETA_VERSION && (i < 0 || numToDelete < 1 || i + numToDelete > numElements)) {
+		display->freezeWithError("E469");
+	}
+
+	int32_t firstChunk = getChunkIndex(i);
+	int32_t c = firstChunk;
+	int32_t offset = i - chunks[c].firstIndex;
+	int32_t numLeft = numToDelete;
+
+	while (numLeft) {
+		Chunk* chunk = &chunks[c];
+		int32_t numHere = std::min(numLeft, chunk->numElements - offset);
+		memmove(getAddressInChunk(chunk, offset), getAddressInChunk(chunk, offset + numHere),
+		        (chunk->numElements - offset - numHere) * elementSize);
+		chunk->numElements -= numHere;
+		numLeft -= numHere;
+
+		// Emptied chunks go. The next one then takes its place
+		if (!chunk->numElements) {
+			deleteChunk(c);
+		}
+		else {
+			c++;
+		}
+		offset = 0;
+	}
+
+	numElements -= numToDelete;
+
+	// What's left either side of the gap might now fit together in one chunk
+	tryMergingWithNext(firstChunk);
+	tryMergingWithNext(firstChunk - 1);
+	renumberFrom(std::max<int32_t>(firstChunk - 1, 0));
+
+	if (!numChunks) {
+		empty();
+	}
+}
+
+void ChunkedArray::swapElements(int32_t i1, int32_t i2) {
+	char workingMemory[elementSize];
+	void* address1 = getElementAddress(i1);
+	void* address2 = getElementAddress(i2);
+
+	memcpy(workingMemory, address1, elementSize);
+	memcpy(address1, address2, elementSize);
+	memcpy(address2, workingMemory, elementSize);
+}
+
+uint32_t ChunkedArray::getMemoryUsage() {
+	return numChunks * numElementsPerChunk * elementSize + chunkListSize * sizeof(Chunk);
+}
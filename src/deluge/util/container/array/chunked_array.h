@@ -0,0 +1,74 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/*
+ * Like ResizeableArray, but the elements are kept in a list of fixed-size chunks instead of one allocation. Inserting
+ * or deleting only moves elements around within one chunk, and getting bigger only ever needs one more chunk - never a
+ * bigger allocation that the memory might be too fragmented to give us - so it suits arrays that can get really long.
+ *
+ * Chunks get split when something's inserted into a full one, and merged with a neighbour when deletes leave them both
+ * small enough. getElementAddress() remembers which chunk it last found, so going through in order doesn't search.
+ * As with ResizeableArray, addresses are only good until the next insert or delete. Asking for the address of an
+ * element that isn't there gives NULL.
+ */
+class ChunkedArray {
+public:
+	ChunkedArray(int32_t newElementSize, int32_t newNumElementsPerChunk = 64);
+	~ChunkedArray();
+	void empty();
+	int32_t insertAtIndex(int32_t i, int32_t numToInsert = 1);
+	void deleteAtIndex(int32_t i, int32_t numToDelete = 1);
+	void swapElements(int32_t i1, int32_t i2);
+	void* getElementAddress(int32_t index);
+
+	[[gnu::always_inline]] inline int32_t getNumElements() { return numElements; }
+
+	uint32_t getMemoryUsage(); // In bytes, including any empty spaces
+
+	const uint32_t elementSize;
+
+protected:
+	int32_t numElements;
+
+private:
+	struct Chunk {
+		void* memory;
+		int32_t firstIndex; // Of the whole array
+		int32_t numElements;
+	};
+
+	int32_t getChunkIndex(int32_t index);
+	inline void* getAddressInChunk(Chunk* chunk, int32_t offset) {
+		return (char*)chunk->memory + offset * elementSize;
+	}
+	bool ensureChunkListSize(int32_t newNumChunks);
+	void insertChunks(int32_t c, void** memories, int32_t num);
+	void deleteChunk(int32_t c);
+	void tryMergingWithNext(int32_t c);
+	void renumberFrom(int32_t c);
+
+	Chunk* chunks;
+	int32_t numChunks;
+	int32_t chunkListSize; // How many Chunks there's room for in chunks
+	int32_t lastChunkIndex; // Where getElementAddress() last found something
+
+	const int32_t numElementsPerChunk;
+};
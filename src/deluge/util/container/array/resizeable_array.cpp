@@ -107,7 +107,10 @@ void ResizeableArray::empty() {
 	LOCK_EXIT
 }
 
-// Returns error
+// Returns error.
+// Note that the clone gets its own copy of the elements straight away, rather than sharing them copy-on-write: callers
+// modify elements in place through getElementAddress() / getElement() (including from the audio routine), so there'd
+// be nowhere reliable to un-share the memory - and un-sharing could fail for lack of RAM at a point where it mustn't.
 int32_t ResizeableArray::beenCloned() {
 
 	LOCK_ENTRY
@@ -891,6 +894,25 @@ void ResizeableArray::setStaticMemory(void* newMemory, int32_t newMemorySize) {
 	setMemory(newMemory, newMemorySize);
 }
 
+// Static memory isn't the allocator's to move, and nor is anything we're in the middle of working on
+void* ResizeableArray::getRelocatableMemory() {
+#if RESIZEABLE_ARRAY_DO_LOCKS
+	if (lock) {
+		return NULL;
+	}
+#endif
+	if (staticMemoryAllocationSize || !memory) {
+		return NULL;
+	}
+	return memoryAllocationStart;
+}
+
+void ResizeableArray::memoryRelocated(void* newMemoryAllocationStart) {
+	int32_t distance = (uint32_t)newMemoryAllocationStart - (uint32_t)memoryAllocationStart;
+	memory = (char* __restrict__)memory + distance;
+	memoryAllocationStart = newMemoryAllocationStart;
+}
+
 // Returns error code
 int32_t ResizeableArray::insertAtIndex(int32_t i, int32_t numToInsert, void* thingNotToStealFrom) {
 
@@ -43,6 +43,10 @@ public:
 	void setMemory(void* newMemory, int32_t newMemorySize);
 	void setStaticMemory(void* newMemory, int32_t newMemorySize);
 
+	// For compaction - see RelocatableArray
+	void* getRelocatableMemory();
+	void memoryRelocated(void* newMemoryAllocationStart);
+
 	void moveElementsLeft(int32_t oldStartIndex, int32_t oldStopIndex, int32_t distance);
 	void moveElementsRight(int32_t oldStartIndex, int32_t oldStopIndex, int32_t distance);
 
@@ -55,6 +59,8 @@ public:
 
 	[[gnu::always_inline]] inline int32_t getNumElements() { return numElements; }
 
+	inline uint32_t getMemoryUsage() { return memorySize * elementSize; } // In bytes, including any empty spaces
+
 	uint32_t elementSize;
 	bool emptyingShouldFreeMemory;
 	uint32_t staticMemoryAllocationSize;
@@ -0,0 +1,320 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "memory/fallback_allocator.h"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace deluge {
+
+// Default hash for HashMap - integers, enums and pointers, run through MurmurHash3's finaliser so keys which are all
+// multiples of something (like pointers to objects) still spread over the buckets
+template <typename K>
+struct HashMapHash {
+	static_assert(std::is_integral_v<K> || std::is_enum_v<K> || std::is_pointer_v<K>,
+	              "HashMap needs a hash function for this key type");
+
+	uint32_t operator()(K key) const {
+		uint64_t value;
+		if constexpr (std::is_pointer_v<K>) {
+			value = (uintptr_t)key;
+		}
+		else {
+			value = (uint64_t)key;
+		}
+		uint32_t hash = (uint32_t)value ^ (uint32_t)(value >> 32);
+		hash ^= hash >> 16;
+		hash *= 0x85ebca6b;
+		hash ^= hash >> 13;
+		hash *= 0xc2b2ae35;
+		hash ^= hash >> 16;
+		return hash;
+	}
+};
+
+/**
+ * Open-addressing hash map with the keys and values stored right in the buckets. Robin Hood probing keeps every key
+ * close to where it hashes to, so lookups - hits or misses - only ever look at a few neighbouring buckets.
+ *
+ * Growing doesn't rehash everything in one go: the new bucket array gets allocated, and then each insert() or erase()
+ * moves a few buckets' worth across from the old one, with find() looking in both until that's done. So an insert that
+ * happens to cross the load limit in the middle of the audio routine costs one allocation rather than a pass over the
+ * whole table.
+ *
+ * Keys and values get moved around with plain copies, so must be trivially copyable - pointers, ints, small structs.
+ * Pointers returned by find() and insert() are only good until the next insert() or erase().
+ * Allocation failure doesn't throw - insert() just returns nullptr.
+ */
+template <typename K, typename V, typename Hash = HashMapHash<K>, typename KeyEqual = std::equal_to<K>,
+          typename Alloc = memory::fallback_allocator<V>>
+class HashMap {
+	static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>,
+	              "HashMap moves its keys and values with plain copies");
+
+public:
+	HashMap() = default;
+	HashMap(HashMap const&) = delete;
+	HashMap& operator=(HashMap const&) = delete;
+	~HashMap() { clear(); }
+
+	[[nodiscard]] int32_t size() const { return numElements + numOldElements; }
+	[[nodiscard]] bool empty() const { return !size(); }
+
+	V* find(K const& key) {
+		uint32_t hash = Hash{}(key);
+		Slot* slot = findInTable(slots, numBuckets, key, hash);
+		if (!slot && oldSlots) {
+			slot = findInTable(oldSlots, oldNumBuckets, key, hash);
+		}
+		return slot ? &slot->value : nullptr;
+	}
+
+	bool contains(K const& key) { return find(key) != nullptr; }
+
+	/// If the key's already there, its value is left alone and that's what's returned, with alreadyPresent set.
+	/// Returns nullptr if there wasn't the memory
+	V* insert(K const& key, V const& value, bool* alreadyPresent = nullptr) {
+		if (V* existing = find(key)) {
+			if (alreadyPresent) {
+				*alreadyPresent = true;
+			}
+			return existing;
+		}
+		if (alreadyPresent) {
+			*alreadyPresent = false;
+		}
+
+		if (numElements + 1 > (numBuckets >> 3) * kMaxLoadEighths) {
+			grow();
+		}
+		// If growing failed, we can still fill right up, just with longer probes
+		if (numElements + 1 >= numBuckets) {
+			return nullptr;
+		}
+
+		migrateSome();
+		numElements++;
+		return &insertIntoTable(slots, numBuckets, Slot{key, value, 0}, Hash{}(key))->value;
+	}
+
+	/// Returns whether it was there
+	bool erase(K const& key) {
+		uint32_t hash = Hash{}(key);
+		bool found = false;
+		if (Slot* slot = findInTable(slots, numBuckets, key, hash)) {
+			eraseFromTable(slot);
+			numElements--;
+			found = true;
+		}
+		// Old slots just get marked, because shifting them back could move them behind where we've migrated up to
+		else if (oldSlots && (slot = findInTable(oldSlots, oldNumBuckets, key, hash))) {
+			slot->distance |= kDeletedFlag;
+			numOldElements--;
+			found = true;
+		}
+		if (oldSlots) {
+			migrateSome();
+		}
+		return found;
+	}
+
+	void clear() {
+		freeSlots(slots, numBuckets);
+		freeSlots(oldSlots, oldNumBuckets);
+		slots = nullptr;
+		oldSlots = nullptr;
+		numBuckets = 0;
+		oldNumBuckets = 0;
+		numElements = 0;
+		numOldElements = 0;
+		migratedUpTo = 0;
+	}
+
+	/// Calls function(key, value) for each element, in no particular order. Mustn't insert or erase
+	template <typename F>
+	void forEach(F&& function) {
+		forEachInTable(slots, numBuckets, function);
+		forEachInTable(oldSlots, oldNumBuckets, function);
+	}
+
+private:
+	struct Slot {
+		K key;
+		V value;
+		uint16_t distance; // 1 + how far it is from the bucket it hashes to, or 0 if this bucket's empty
+	};
+
+	using SlotAllocator = typename std::allocator_traits<Alloc>::template rebind_alloc<Slot>;
+
+	static constexpr int32_t kInitialNumBuckets = 16;
+	static constexpr int32_t kMaxLoadEighths = 7;
+	// Each insert or erase while growing moves this many old buckets across. It has to be enough that the old ones are
+	// all gone before the new ones fill up - which they'd only do after numBuckets / 2 more inserts
+	static constexpr int32_t kBucketsToMigratePerOperation = 8;
+	// In the old slots, for ones which have been erased or migrated but have to stay put for the probes past them
+	static constexpr uint16_t kDeletedFlag = 0x8000;
+
+	Slot* slots = nullptr;
+	int32_t numBuckets = 0; // Always a power of 2
+	int32_t numElements = 0;
+
+	// While growing, what's left of the previous slots
+	Slot* oldSlots = nullptr;
+	int32_t oldNumBuckets = 0;
+	int32_t numOldElements = 0;
+	int32_t migratedUpTo = 0;
+
+	static Slot* findInTable(Slot* table, int32_t tableNumBuckets, K const& key, uint32_t hash) {
+		if (!table) {
+			return nullptr;
+		}
+		int32_t mask = tableNumBuckets - 1;
+		int32_t b = hash & mask;
+		for (uint16_t distance = 1;; distance++) {
+			Slot* slot = &table[b];
+			// Robin Hood means that if we get to something closer to home than we'd be, ours isn't here
+			if ((slot->distance & ~kDeletedFlag) < distance) {
+				return nullptr;
+			}
+			if (!(slot->distance & kDeletedFlag) && KeyEqual{}(slot->key, key)) {
+				return slot;
+			}
+			b = (b + 1) & mask;
+		}
+	}
+
+	// The key mustn't be there already, and there must be an empty bucket. Returns where it ended up
+	static Slot* insertIntoTable(Slot* table, int32_t tableNumBuckets, Slot toPlace, uint32_t hash) {
+		int32_t mask = tableNumBuckets - 1;
+		int32_t b = hash & mask;
+		Slot* placed = nullptr;
+		toPlace.distance = 1;
+		while (true) {
+			Slot* slot = &table[b];
+			if (!slot->distance) {
+				*slot = toPlace;
+				return placed ? placed : slot;
+			}
+			// Take from the rich - whichever's nearer its home bucket moves on
+			if (slot->distance < toPlace.distance) {
+				std::swap(*slot, toPlace);
+				if (!placed) {
+					placed = slot;
+				}
+			}
+			toPlace.distance++;
+			b = (b + 1) & mask;
+		}
+	}
+
+	// Shifts back whatever comes after it, so nothing's left further from home than it has to be
+	void eraseFromTable(Slot* slot) {
+		int32_t mask = numBuckets - 1;
+		int32_t b = slot - slots;
+		while (true) {
+			int32_t next = (b + 1) & mask;
+			if (slots[next].distance <= 1) {
+				break;
+			}
+			slots[b] = slots[next];
+			slots[b].distance--;
+			b = next;
+		}
+		slots[b].distance = 0;
+	}
+
+	void grow() {
+		// Can't start again while still growing from last time. This won't normally happen, but get it over with
+		while (oldSlots) {
+			migrateSome();
+		}
+
+		int32_t newNumBuckets = numBuckets ? numBuckets * 2 : kInitialNumBuckets;
+		Slot* newSlots = allocateSlots(newNumBuckets);
+		if (!newSlots) {
+			return;
+		}
+
+		oldSlots = slots;
+		oldNumBuckets = numBuckets;
+		numOldElements = numElements;
+		migratedUpTo = 0;
+
+		slots = newSlots;
+		numBuckets = newNumBuckets;
+		numElements = 0;
+	}
+
+	void migrateSome() {
+		if (!oldSlots) {
+			return;
+		}
+
+		int32_t end = std::min(migratedUpTo + kBucketsToMigratePerOperation, oldNumBuckets);
+		for (; migratedUpTo < end; migratedUpTo++) {
+			Slot* slot = &oldSlots[migratedUpTo];
+			if (slot->distance && !(slot->distance & kDeletedFlag)) {
+				insertIntoTable(slots, numBuckets, *slot, Hash{}(slot->key));
+				slot->distance |= kDeletedFlag;
+				numElements++;
+				numOldElements--;
+			}
+		}
+
+		if (migratedUpTo == oldNumBuckets) {
+			freeSlots(oldSlots, oldNumBuckets);
+			oldSlots = nullptr;
+			oldNumBuckets = 0;
+			numOldElements = 0;
+		}
+	}
+
+	template <typename F>
+	static void forEachInTable(Slot* table, int32_t tableNumBuckets, F& function) {
+		for (int32_t b = 0; b < tableNumBuckets; b++) {
+			if (table[b].distance && !(table[b].distance & kDeletedFlag)) {
+				function(table[b].key, table[b].value);
+			}
+		}
+	}
+
+	static Slot* allocateSlots(int32_t num) {
+		SlotAllocator allocator;
+		Slot* newSlots = std::allocator_traits<SlotAllocator>::allocate(allocator, num);
+		if (newSlots) {
+			for (int32_t b = 0; b < num; b++) {
+				newSlots[b].distance = 0;
+			}
+		}
+		return newSlots;
+	}
+
+	static void freeSlots(Slot* table, int32_t num) {
+		if (table) {
+			SlotAllocator allocator;
+			std::allocator_traits<SlotAllocator>::deallocate(allocator, table, num);
+		}
+	}
+};
+
+} // namespace deluge
@@ -345,6 +345,45 @@ bool OpenAddressingHashTableWith32bitKey::doesKeyIndicateEmptyBucket(uint32_t ke
 	return (key == (uint32_t)0xFFFFFFFF);
 }
 
+// 32-bit key and 32-bit value
+OpenAddressingHashTableWith32bitKeyAnd32bitValue::OpenAddressingHashTableWith32bitKeyAnd32bitValue() {
+	elementSize = sizeof(uint32_t) * 2;
+}
+
+uint32_t OpenAddressingHashTableWith32bitKeyAnd32bitValue::getKeyFromAddress(void* address) {
+	return *(uint32_t*)address;
+}
+
+void OpenAddressingHashTableWith32bitKeyAnd32bitValue::setKeyAtAddress(uint32_t key, void* address) {
+	*(uint32_t*)address = key;
+}
+
+bool OpenAddressingHashTableWith32bitKeyAnd32bitValue::doesKeyIndicateEmptyBucket(uint32_t key) {
+	return (key == (uint32_t)0xFFFFFFFF);
+}
+
+// If the key is already present, its value is left as it was. Returns false if there wasn't enough RAM
+bool OpenAddressingHashTableWith32bitKeyAnd32bitValue::insertValueIfNotAlreadyPresent(uint32_t key, uint32_t value) {
+	bool alreadyPresent = false;
+	uint32_t* address = (uint32_t*)insert(key, &alreadyPresent);
+	if (!address) {
+		return false;
+	}
+	if (!alreadyPresent) {
+		address[1] = value;
+	}
+	return true;
+}
+
+// Returns NULL if the key isn't present
+uint32_t* OpenAddressingHashTableWith32bitKeyAnd32bitValue::lookupValue(uint32_t key) {
+	uint32_t* address = (uint32_t*)lookup(key);
+	if (!address) {
+		return NULL;
+	}
+	return &address[1];
+}
+
 // 16-bit key
 OpenAddressingHashTableWith16bitKey::OpenAddressingHashTableWith16bitKey() {
 	elementSize = sizeof(uint16_t);
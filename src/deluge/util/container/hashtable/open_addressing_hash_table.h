@@ -56,6 +56,18 @@ public:
 	bool doesKeyIndicateEmptyBucket(uint32_t key);
 };
 
+// Each element is a 32-bit key followed by a 32-bit value, e.g. a pointer
+class OpenAddressingHashTableWith32bitKeyAnd32bitValue final : public OpenAddressingHashTable {
+public:
+	OpenAddressingHashTableWith32bitKeyAnd32bitValue();
+	uint32_t getKeyFromAddress(void* address);
+	void setKeyAtAddress(uint32_t key, void* address);
+	bool doesKeyIndicateEmptyBucket(uint32_t key);
+
+	bool insertValueIfNotAlreadyPresent(uint32_t key, uint32_t value);
+	uint32_t* lookupValue(uint32_t key);
+};
+
 class OpenAddressingHashTableWith16bitKey final : public OpenAddressingHashTable {
 public:
 	OpenAddressingHashTableWith16bitKey();
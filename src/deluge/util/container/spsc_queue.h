@@ -0,0 +1,69 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Fixed-size ring queue for handing items from exactly one producer to exactly one consumer, where one of the two is
+// an ISR - e.g. an interrupt pushing input timestamps for the main loop to pop, or the other way round. Neither side
+// ever blocks or needs interrupts disabled. Each position is only ever written by one side, and the fences stop the
+// compiler moving an item's contents across the position update which publishes or frees it. We're single-core, so
+// that's all the ordering needed.
+template <typename T, uint32_t kCapacity>
+class SPSCQueue {
+	static_assert(kCapacity && !(kCapacity & (kCapacity - 1)), "SPSCQueue capacity must be a power of two");
+
+public:
+	// Producer side. Returns false, leaving the queue untouched, if it's full
+	bool push(T const& item) {
+		if (full()) {
+			return false;
+		}
+		items[writePos & (kCapacity - 1)] = item;
+		std::atomic_signal_fence(std::memory_order_release);
+		writePos = writePos + 1;
+		return true;
+	}
+
+	// Consumer side. Only valid if !empty()
+	T& front() { return items[readPos & (kCapacity - 1)]; }
+
+	void pop() {
+		std::atomic_signal_fence(std::memory_order_release);
+		readPos = readPos + 1;
+	}
+
+	bool pop(T* item) {
+		if (empty()) {
+			return false;
+		}
+		std::atomic_signal_fence(std::memory_order_acquire);
+		*item = front();
+		pop();
+		return true;
+	}
+
+	bool empty() const { return writePos == readPos; }
+	bool full() const { return size() >= kCapacity; }
+	uint32_t size() const { return writePos - readPos; }
+
+private:
+	T items[kCapacity];
+	volatile uint32_t writePos = 0;
+	volatile uint32_t readPos = 0;
+};
@@ -60,6 +60,7 @@
 #include <functional>  // for less and equal_to
 #include <iterator>    // for reverse_iterator and iterator traits
 #include <limits>      // for numeric_limits
+#include <span>        // for span views
 #include <stdexcept>   // for length_error
 #include <type_traits> // for aligned_storage and all meta-functions
 
@@ -531,6 +532,10 @@ public:
 
 	using base_t::data;
 
+	/// View of the elements, for passing to code that doesn't need to know the capacity
+	constexpr std::span<value_type> span() noexcept { return {data(), size()}; }
+	constexpr std::span<value_type const> span() const noexcept { return {data(), size()}; }
+
 	///@} // Data access
 
 	/// \name Iterators
@@ -635,6 +640,18 @@ public:
 		emplace_back(std::forward<U>(value));
 	}
 
+	/// Appends \p value at the end of the vector if there's room, returning whether there was. For code that has to
+	/// carry on without it rather than overflow, e.g. in the audio render path.
+	template <typename U>
+	requires std::constructible_from<T, U> && std::assignable_from<reference, U&&>
+	constexpr bool try_push_back(U&& value) noexcept(noexcept(emplace_back(std::forward<U>(value)))) {
+		if (full()) {
+			return false;
+		}
+		emplace_back(std::forward<U>(value));
+		return true;
+	}
+
 	/// Appends a default constructed `T` at the end of the vector.
 
 	void push_back() noexcept(
@@ -759,6 +776,19 @@ public:
 		return p;
 	}
 
+	/// Removes the element at \p position by moving the last element into its place, instead of shifting along
+	/// everything after it - for when the order doesn't matter. Returns an iterator to what's now at \p position.
+	constexpr iterator erase_unordered(const_iterator position) noexcept requires std::movable<value_type> {
+		assert_iterator_in_range(position);
+		SV_EXPECT(position != end() && "tried to erase end()");
+		iterator p = begin() + (position - begin());
+		if (p != end() - 1) {
+			*p = std::move(back());
+		}
+		pop_back();
+		return p;
+	}
+
 	constexpr void
 	swap(static_vector& other) noexcept(std::is_nothrow_swappable_v<T>) requires std::assignable_from<T&, T&&> {
 		static_vector tmp = move(other);
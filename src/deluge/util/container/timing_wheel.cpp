@@ -0,0 +1,199 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "util/container/timing_wheel.h"
+
+TimingWheel::TimingWheel(int32_t newTickMagnitude) {
+	for (int32_t l = 0; l < kTimingWheelNumLevels; l++) {
+		for (int32_t s = 0; s < kTimingWheelNumSlots; s++) {
+			slots[l][s] = nullptr;
+		}
+		occupiedSlots[l] = 0;
+	}
+	expired = nullptr;
+	currentTick = 0;
+	timeOfNextTick = 0;
+	tickMagnitude = newTickMagnitude;
+}
+
+void TimingWheel::schedule(TimingWheelEntry* entry, uint32_t now, int32_t delay) {
+	unlink(entry);
+
+	// Round up to a whole tick, so nothing gets called back early
+	int32_t timeAfterNextTick = now + delay - timeOfNextTick;
+	uint32_t ticksAway = 0;
+	if (timeAfterNextTick > 0) {
+		ticksAway = ((uint32_t)timeAfterNextTick + (1 << tickMagnitude) - 1) >> tickMagnitude;
+	}
+	entry->expiryTick = currentTick + ticksAway;
+	insert(entry);
+}
+
+void TimingWheel::scheduleAlongside(TimingWheelEntry* entry, TimingWheelEntry* other) {
+	if (entry == other) {
+		return;
+	}
+	unlink(entry);
+	entry->expiryTick = (other->isScheduled() && other->level >= 0) ? other->expiryTick : currentTick;
+	insert(entry);
+}
+
+void TimingWheel::unschedule(TimingWheelEntry* entry) {
+	unlink(entry);
+}
+
+bool TimingWheel::isEmpty() {
+	for (int32_t l = 0; l < kTimingWheelNumLevels; l++) {
+		if (occupiedSlots[l]) {
+			return false;
+		}
+	}
+	return !expired;
+}
+
+void TimingWheel::insert(TimingWheelEntry* entry) {
+	int32_t ticksAway = entry->expiryTick - currentTick;
+	if (ticksAway < 0) {
+		entry->expiryTick = currentTick;
+		ticksAway = 0;
+	}
+
+	int32_t level = 0;
+	while (level < kTimingWheelNumLevels - 1 && ticksAway >= (1 << ((level + 1) * kTimingWheelSlotsMagnitude))) {
+		level++;
+	}
+
+	// Further off than the whole wheel goes? Park it as far along as we can - it'll get put back in from there
+	uint32_t tickForSlot = entry->expiryTick;
+	constexpr int32_t kWheelSpan = 1 << (kTimingWheelNumLevels * kTimingWheelSlotsMagnitude);
+	if (ticksAway >= kWheelSpan) {
+		tickForSlot = currentTick + kWheelSpan - 1;
+	}
+	int32_t slot = (tickForSlot >> (level * kTimingWheelSlotsMagnitude)) & (kTimingWheelNumSlots - 1);
+
+	entry->level = level;
+	entry->slot = slot;
+	entry->next = slots[level][slot];
+	if (entry->next) {
+		entry->next->prevNext = &entry->next;
+	}
+	entry->prevNext = &slots[level][slot];
+	slots[level][slot] = entry;
+	occupiedSlots[level] |= (uint64_t)1 << slot;
+}
+
+void TimingWheel::unlink(TimingWheelEntry* entry) {
+	if (!entry->prevNext) {
+		return;
+	}
+
+	*entry->prevNext = entry->next;
+	if (entry->next) {
+		entry->next->prevNext = entry->prevNext;
+	}
+	if (entry->level >= 0 && !slots[entry->level][entry->slot]) {
+		occupiedSlots[entry->level] &= ~((uint64_t)1 << entry->slot);
+	}
+	entry->next = nullptr;
+	entry->prevNext = nullptr;
+}
+
+// Moves everything in this level's current slot down to wherever it now belongs. Returns that slot's index, so the
+// caller knows whether the next level up has wrapped round too
+int32_t TimingWheel::cascade(int32_t level) {
+	int32_t slot = (currentTick >> (level * kTimingWheelSlotsMagnitude)) & (kTimingWheelNumSlots - 1);
+
+	TimingWheelEntry* entry = slots[level][slot];
+	slots[level][slot] = nullptr;
+	occupiedSlots[level] &= ~((uint64_t)1 << slot);
+
+	while (entry) {
+		TimingWheelEntry* next = entry->next;
+		entry->next = nullptr;
+		entry->prevNext = nullptr;
+		insert(entry);
+		entry = next;
+	}
+
+	return slot;
+}
+
+void TimingWheel::advance(uint32_t now) {
+	while ((int32_t)(now - timeOfNextTick) >= 0) {
+		uint32_t ticksDue = ((now - timeOfNextTick) >> tickMagnitude) + 1;
+
+		// Nothing scheduled at all? Then there's nothing to move down either, so we can just jump ahead
+		if (isEmpty()) {
+			currentTick += ticksDue;
+			timeOfNextTick += ticksDue << tickMagnitude;
+			return;
+		}
+
+		int32_t slot = currentTick & (kTimingWheelNumSlots - 1);
+		if (!slot) {
+			for (int32_t level = 1; level < kTimingWheelNumLevels; level++) {
+				if (cascade(level)) {
+					break;
+				}
+			}
+		}
+
+		uint32_t ticksToMove;
+		if (occupiedSlots[0] & ((uint64_t)1 << slot)) {
+			// Put this slot's entries at the front of the expired ones, marking them as such
+			TimingWheelEntry* first = slots[0][slot];
+			slots[0][slot] = nullptr;
+			occupiedSlots[0] &= ~((uint64_t)1 << slot);
+
+			TimingWheelEntry* last = first;
+			while (true) {
+				last->level = -1;
+				if (!last->next) {
+					break;
+				}
+				last = last->next;
+			}
+			last->next = expired;
+			if (expired) {
+				expired->prevNext = &last->next;
+			}
+			first->prevNext = &expired;
+			expired = first;
+
+			ticksToMove = 1;
+		}
+		else {
+			// Skip to the next occupied slot, or to where this level wraps round and things need moving down
+			uint64_t slotsAhead = occupiedSlots[0] >> slot;
+			ticksToMove = slotsAhead ? __builtin_ctzll(slotsAhead) : (kTimingWheelNumSlots - slot);
+			if (ticksToMove > ticksDue) {
+				ticksToMove = ticksDue;
+			}
+		}
+
+		currentTick += ticksToMove;
+		timeOfNextTick += ticksToMove << tickMagnitude;
+
+		// A callback might schedule or unschedule anything, including what's still waiting here, so take them one at a
+		// time from the front
+		while (expired) {
+			TimingWheelEntry* entry = expired;
+			unlink(entry);
+			entry->callback(entry);
+		}
+	}
+}
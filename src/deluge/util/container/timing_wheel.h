@@ -0,0 +1,85 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstdint>
+
+constexpr int32_t kTimingWheelSlotsMagnitude = 6;
+constexpr int32_t kTimingWheelNumSlots = 1 << kTimingWheelSlotsMagnitude;
+constexpr int32_t kTimingWheelNumLevels = 4;
+
+// Something which can be scheduled on a TimingWheel. Belongs to whoever schedules it - the wheel only links it in, so it
+// must be unscheduled before it's destroyed. The callback gets called with the entry already unscheduled, so it's free
+// to schedule it again.
+class TimingWheelEntry {
+public:
+	TimingWheelEntry(void (*newCallback)(TimingWheelEntry* entry) = nullptr) { callback = newCallback; }
+
+	bool isScheduled() { return (prevNext != nullptr); }
+
+	void (*callback)(TimingWheelEntry* entry);
+	uint32_t expiryTick;
+
+private:
+	TimingWheelEntry* next = nullptr;
+	TimingWheelEntry** prevNext = nullptr;
+	int8_t level; // -1 means it's expired and waiting in line to be called back
+	uint8_t slot;
+
+	friend class TimingWheel;
+};
+
+// Hierarchical timing wheel, as in the classic Varghese & Lauck scheme (and older Linux kernels). Each level has
+// kTimingWheelNumSlots slots, each covering kTimingWheelNumSlots times the time of one of the level below's. Entries go
+// in the lowest level whose span reaches their expiry, and get moved down a level each time the level below wraps
+// round to their slot. So scheduling and unscheduling are O(1), and each entry gets moved at most
+// kTimingWheelNumLevels - 1 times before it expires. Runs of empty slots on the bottom level get skipped over
+// wholesale.
+//
+// Time is whatever the caller counts in - it just has to be a wrapping uint32_t. A tick is (1 << tickMagnitude) of
+// those, and that's the resolution callbacks happen at. Anything further off than the whole wheel spans gets parked in
+// the top level's furthest slot and goes round again.
+class TimingWheel {
+public:
+	TimingWheel(int32_t newTickMagnitude);
+
+	// Schedules entry to be called back at or just after now + delay. Reschedules it if it already was scheduled
+	void schedule(TimingWheelEntry* entry, uint32_t now, int32_t delay);
+
+	// Schedules entry for the same tick as another, or for the next tick if that one's not scheduled
+	void scheduleAlongside(TimingWheelEntry* entry, TimingWheelEntry* other);
+
+	void unschedule(TimingWheelEntry* entry);
+
+	// Calls back every entry which has become due by now
+	void advance(uint32_t now);
+
+	bool isEmpty();
+
+private:
+	void insert(TimingWheelEntry* entry);
+	void unlink(TimingWheelEntry* entry);
+	int32_t cascade(int32_t level);
+
+	TimingWheelEntry* slots[kTimingWheelNumLevels][kTimingWheelNumSlots];
+	uint64_t occupiedSlots[kTimingWheelNumLevels]; // One bit per slot
+	TimingWheelEntry* expired;                     // Due, and waiting to be called back
+
+	uint32_t currentTick;    // The next tick to be processed
+	uint32_t timeOfNextTick; // When currentTick becomes due
+	int32_t tickMagnitude;
+};
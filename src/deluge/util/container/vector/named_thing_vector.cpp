@@ -16,6 +16,8 @@
  */
 
 #include "util/container/vector/named_thing_vector.h"
+#include <algorithm>
+#include <ctype.h>
 #include <new>
 #include <string.h>
 
@@ -28,18 +30,42 @@ NamedThingVector::NamedThingVector(int32_t newStringOffset)
     : ResizeableArray(sizeof(NamedThingVectorElement)), stringOffset(newStringOffset) {
 }
 
+// Compares like strcasecmp(), but starting from character numAlreadyMatching, which the caller already knows the two
+// strings match up to. Puts how many characters they match up to (ignoring case) in numMatching
+static int32_t compareCaseInsensitiveFrom(char const* first, char const* second, int32_t numAlreadyMatching,
+                                          int32_t* numMatching) {
+	int32_t i = numAlreadyMatching;
+	while (true) {
+		int32_t firstChar = tolower((unsigned char)first[i]);
+		int32_t secondChar = tolower((unsigned char)second[i]);
+		if (firstChar != secondChar || !firstChar) {
+			*numMatching = i;
+			return firstChar - secondChar;
+		}
+		i++;
+	}
+}
+
 int32_t NamedThingVector::search(char const* searchString, int32_t comparison, bool* foundExact) {
 
 	int32_t rangeBegin = 0;
 	int32_t rangeEnd = numElements;
 	int32_t proposedIndex;
 
+	// How many characters searchString is known to share with the elements either side of the range. Everything in the
+	// range, being in order between those two, shares at least the lesser of those too, so comparisons can skip that
+	// much - which for file paths, all starting with the same folders, is most of them
+	int32_t numMatchingBelowRange = 0;
+	int32_t numMatchingAboveRange = 0;
+
 	while (rangeBegin != rangeEnd) {
 		int32_t rangeSize = rangeEnd - rangeBegin;
 		proposedIndex = rangeBegin + (rangeSize >> 1);
 
 		NamedThingVectorElement* element = getMemory(proposedIndex);
-		int32_t result = strcasecmp(element->name.get(), searchString);
+		int32_t numMatching;
+		int32_t result = compareCaseInsensitiveFrom(element->name.get(), searchString,
+		                                            std::min(numMatchingBelowRange, numMatchingAboveRange), &numMatching);
 
 		if (!result) {
 			if (foundExact) {
@@ -49,9 +75,11 @@ int32_t NamedThingVector::search(char const* searchString, int32_t comparison, b
 		}
 		else if (result < 0) {
 			rangeBegin = proposedIndex + 1;
+			numMatchingBelowRange = numMatching;
 		}
 		else {
 			rangeEnd = proposedIndex;
+			numMatchingAboveRange = numMatching;
 		}
 	}
 
@@ -19,6 +19,8 @@
 #include "definitions_cxx.hpp"
 #include "hid/display/display.h"
 #include "memory/general_memory_allocator.h"
+#include "memory/slab_allocator.h"
+#include "util/container/hashtable/hash_map.h"
 #include "util/functions.h"
 #include <string.h>
 
@@ -28,6 +30,25 @@ extern "C" {
 
 const char nothing = 0;
 
+// The memory of each interned String, keyed by the hash of its chars. Where two different strings have the same hash,
+// the second just doesn't get interned
+deluge::HashMap<uint32_t, char*> internedStrings;
+
+// FNV-1a
+static uint32_t getHash(char const* chars) {
+	uint32_t hash = 2166136261u;
+	for (; *chars; chars++) {
+		hash = (hash ^ (uint8_t)*chars) * 16777619u;
+	}
+	return hash;
+}
+
+// Short Strings come out of slabs, whose header doesn't say how big they are
+static uint32_t getAllocatedSize(void* address) {
+	return SlabAllocator::isSlabAllocation(address) ? SlabAllocator::getAllocatedSize(address)
+	                                                : GeneralMemoryAllocator::get().getAllocatedSize(address);
+}
+
 String::String() {
 	stringMemory = NULL;
 }
@@ -37,22 +58,35 @@ String::~String() {
 }
 
 int32_t String::getNumReasons() {
-	return *(int32_t*)(stringMemory - 4);
+	return *(uint32_t*)(stringMemory - 4) & ~kInternedFlag;
 }
 
 void String::setNumReasons(int32_t newNum) {
-	*(int32_t*)(stringMemory - 4) = newNum;
+	*(uint32_t*)(stringMemory - 4) = (*(uint32_t*)(stringMemory - 4) & kInternedFlag) | newNum;
+}
+
+// For memory that's just become ours alone - not shared, and not interned
+void String::setUpReasons() {
+	*(uint32_t*)(stringMemory - 4) = 1;
+}
+
+// Gives up our reason for the memory, deallocating it if it was the last one. Leaves stringMemory as it was
+void String::release() {
+	int32_t numReasons = getNumReasons();
+	if (numReasons > 1) {
+		setNumReasons(numReasons - 1);
+	}
+	else {
+		if (isInterned()) {
+			internedStrings.erase(getHash(stringMemory));
+		}
+		delugeDealloc(stringMemory - 4);
+	}
 }
 
 void String::clear(bool destructing) {
 	if (stringMemory) {
-		int32_t numReasons = getNumReasons();
-		if (numReasons > 1) {
-			setNumReasons(numReasons - 1);
-		}
-		else {
-			delugeDealloc(stringMemory - 4);
-		}
+		release();
 
 		if (!destructing) {
 			stringMemory = NULL;
@@ -78,15 +112,14 @@ int32_t String::set(char const* newChars, int32_t newLength) {
 	if (stringMemory) {
 
 		{
-			// If it's shared with another object, can't use it
-			int32_t numReasons = getNumReasons();
-			if (numReasons > 1) {
+			// If it's shared with another object, or interned, can't use it
+			if (isShared()) {
 				goto clearAndAllocateNew;
 			}
 
 			// If we're here, the memory is exclusively ours (1 reason)
 
-			int32_t allocatedSize = GeneralMemoryAllocator::get().getAllocatedSize(stringMemory - 4);
+			int32_t allocatedSize = getAllocatedSize(stringMemory - 4);
 
 			int32_t extraMemoryNeeded = newLength + 1 + 4 - allocatedSize;
 
@@ -95,7 +128,8 @@ int32_t String::set(char const* newChars, int32_t newLength) {
 				goto doCopy;
 			}
 
-			else {
+			// Slabs can't be extended
+			else if (!SlabAllocator::isSlabAllocation(stringMemory - 4)) {
 				// Try extending
 				uint32_t amountExtendedLeft, amountExtendedRight;
 				GeneralMemoryAllocator::get().extend(stringMemory - 4, extraMemoryNeeded, extraMemoryNeeded,
@@ -116,7 +150,7 @@ clearAndAllocateNew:
 	}
 
 	{
-		void* newMemory = GeneralMemoryAllocator::get().allocNonAudio(newLength + 1 + 4);
+		void* newMemory = GeneralMemoryAllocator::get().allocNonAudioSmall(newLength + 1 + 4);
 		if (!newMemory) {
 			return ERROR_INSUFFICIENT_RAM;
 		}
@@ -126,7 +160,7 @@ clearAndAllocateNew:
 doCopy:
 	memcpy(stringMemory, newChars, newLength);
 	stringMemory[newLength] = 0;
-	setNumReasons(1);
+	setUpReasons();
 	return NO_ERROR;
 }
 
@@ -170,22 +204,18 @@ int32_t String::shorten(int32_t newLength) {
 	}
 	else {
 
-		int32_t oldNumReasons = getNumReasons();
-
-		// If reasons, we have to do a clone
-		if (oldNumReasons > 1) {
-			void* newMemory = GeneralMemoryAllocator::get().allocNonAudio(newLength + 1 + 4);
+		// If other reasons, or interned, we have to do a clone
+		if (isShared()) {
+			void* newMemory = GeneralMemoryAllocator::get().allocNonAudioSmall(newLength + 1 + 4);
 			if (!newMemory) {
 				return ERROR_INSUFFICIENT_RAM;
 			}
 
-			setNumReasons(oldNumReasons - 1); // Reduce reasons on old memory
-
 			char* newStringMemory = (char*)newMemory + 4;
 			memcpy(newStringMemory, stringMemory, newLength); // The ending 0 will get set below
+			release();
 			stringMemory = newStringMemory;
-
-			setNumReasons(1); // Set num reasons on new memory
+			setUpReasons();
 		}
 
 		stringMemory[newLength] = 0;
@@ -220,28 +250,29 @@ int32_t String::concatenateAtPos(char const* newChars, int32_t pos, int32_t newC
 		return shorten(pos);
 	}
 
-	int32_t oldNumReasons = getNumReasons();
-
 	int32_t requiredSize = pos + newCharsLength + 4 + 1;
 	int32_t extraBytesNeeded;
-	bool deallocateAfter = true;
 
-	// If additional reasons, we definitely have to allocate afresh
-	if (oldNumReasons > 1) {
-		deallocateAfter = false;
-		setNumReasons(oldNumReasons - 1);
+	// If additional reasons, or interned, we definitely have to allocate afresh
+	if (isShared()) {
 		goto allocateNewMemory;
 	}
 
-	extraBytesNeeded = requiredSize - GeneralMemoryAllocator::get().getAllocatedSize(stringMemory - 4);
+	extraBytesNeeded = requiredSize - getAllocatedSize(stringMemory - 4);
 
 	// If not enough memory allocated...
 	if (extraBytesNeeded > 0) {
 
-		// See if we can extend
+		// See if we can extend. Slabs can't be
 		uint32_t amountExtendedLeft, amountExtendedRight;
-		GeneralMemoryAllocator::get().extend(stringMemory - 4, extraBytesNeeded, extraBytesNeeded, &amountExtendedLeft,
-		                                     &amountExtendedRight);
+		if (SlabAllocator::isSlabAllocation(stringMemory - 4)) {
+			amountExtendedLeft = 0;
+			amountExtendedRight = 0;
+		}
+		else {
+			GeneralMemoryAllocator::get().extend(stringMemory - 4, extraBytesNeeded, extraBytesNeeded,
+			                                     &amountExtendedLeft, &amountExtendedRight);
+		}
 
 		// If that worked...
 		if (amountExtendedLeft || amountExtendedRight) {
@@ -257,7 +288,7 @@ int32_t String::concatenateAtPos(char const* newChars, int32_t pos, int32_t newC
 		// Otherwise, gotta allocate brand new memory
 		else {
 allocateNewMemory:
-			void* newMemory = GeneralMemoryAllocator::get().allocNonAudio(requiredSize);
+			void* newMemory = GeneralMemoryAllocator::get().allocNonAudioSmall(requiredSize);
 			if (!newMemory) {
 				return ERROR_INSUFFICIENT_RAM;
 			}
@@ -267,11 +298,9 @@ allocateNewMemory:
 			// Copy the bit we want to keep of the old memory
 			memcpy(newStringMemory, stringMemory, pos);
 
-			if (deallocateAfter) {
-				delugeDealloc(stringMemory - 4);
-			}
+			release();
 			stringMemory = newStringMemory;
-			setNumReasons(1);
+			setUpReasons();
 		}
 	}
 	memcpy(&stringMemory[pos], newChars, newCharsLength);
@@ -294,14 +323,13 @@ int32_t String::setInt(int32_t number, int32_t minNumDigits) {
 
 int32_t String::setChar(char newChar, int32_t pos) {
 
-	// If any additional reasons, we gotta clone the memory first
-	int32_t oldNumReasons = getNumReasons();
-	if (oldNumReasons > 1) {
+	// If any additional reasons, or interned, we gotta clone the memory first
+	if (isShared()) {
 
 		int32_t length = getLength();
 
 		int32_t requiredSize = length + 4 + 1;
-		void* newMemory = GeneralMemoryAllocator::get().allocNonAudio(requiredSize);
+		void* newMemory = GeneralMemoryAllocator::get().allocNonAudioSmall(requiredSize);
 		if (!newMemory) {
 			return ERROR_INSUFFICIENT_RAM;
 		}
@@ -310,9 +338,9 @@ int32_t String::setChar(char newChar, int32_t pos) {
 
 		// Copy the old memory
 		memcpy(newStringMemory, stringMemory, length + 1); // Copies 0 at end, too
-		setNumReasons(oldNumReasons - 1);                  // Reduce reasons on old memory
+		release();
 		stringMemory = newStringMemory;
-		setNumReasons(1); // Set reasons on new memory
+		setUpReasons();
 	}
 
 	stringMemory[pos] = newChar;
@@ -326,3 +354,29 @@ bool String::equals(char const* otherChars) {
 bool String::equalsCaseIrrespective(char const* otherChars) {
 	return !strcasecmp(get(), otherChars);
 }
+
+// Makes this share its memory with the interned String that has the same chars, if there is one - so repeated names
+// like sample paths only take up the room once, and equals() between interned Strings is just a pointer compare. If
+// there isn't one, this becomes it. Anything that changes an interned String gets it a copy of its own first, like any
+// other shared String. Can't fail - if there's no RAM for the table, we just don't get interned.
+void String::intern() {
+	if (!stringMemory || isInterned()) {
+		return;
+	}
+
+	uint32_t hash = getHash(stringMemory);
+	char** internedMemory = internedStrings.find(hash);
+	if (internedMemory) {
+		char* internedChars = *internedMemory;
+		if (!strcmp(internedChars, stringMemory)) {
+			clear();
+			stringMemory = internedChars;
+			beenCloned();
+		}
+		return;
+	}
+
+	if (internedStrings.insert(hash, stringMemory)) {
+		*(uint32_t*)(stringMemory - 4) |= kInternedFlag;
+	}
+}
@@ -40,12 +40,15 @@ public:
 	int32_t concatenate(char const* newChars);
 	bool equals(char const* otherChars);
 	bool equalsCaseIrrespective(char const* otherChars);
+	void intern();
 
 	inline bool equals(String* otherString) {
 		if (stringMemory == otherString->stringMemory)
 			return true; // Works if both lengths are 0, too
 		if (!stringMemory || !otherString->stringMemory)
 			return false; // If just one is empty, then not equal
+		if (isInterned() && otherString->isInterned())
+			return false; // There's only ever one interned copy of any given chars
 		return equals(otherString->get());
 	}
 
@@ -67,8 +70,15 @@ public:
 	inline bool isEmpty() { return !stringMemory; }
 
 private:
+	// Top bit of the reasons count, for memory which is in the interned string table
+	static constexpr uint32_t kInternedFlag = 1u << 31;
+
 	int32_t getNumReasons();
 	void setNumReasons(int32_t newNum);
+	void setUpReasons();
+	void release();
+	inline bool isInterned() { return *(uint32_t*)(stringMemory - 4) & kInternedFlag; }
+	inline bool isShared() { return *(uint32_t*)(stringMemory - 4) != 1; } // More than one reason, or interned
 
 	char* stringMemory;
 };
@@ -42,11 +42,8 @@ const uint8_t modButtonY[8] = {0, 1, 2, 3, 0, 1, 2, 3};
 const uint8_t modLedX[8] = {1, 1, 1, 1, 2, 2, 2, 2};
 const uint8_t modLedY[8] = {0, 1, 2, 3, 0, 1, 2, 3};
 
-int32_t paramRanges[kNumParams];
-int32_t paramNeutralValues[kNumParams];
-
 // This is just the range of the user-defined "preset" value, it doesn't apply to the outcome of patch cables
-int32_t getParamRange(int32_t p) {
+constexpr int32_t getParamRange(int32_t p) {
 	switch (p) {
 	case Param::Local::ENV_0_ATTACK:
 	case Param::Local::ENV_1_ATTACK:
@@ -72,7 +69,7 @@ int32_t getParamRange(int32_t p) {
 	}
 }
 
-int32_t getParamNeutralValue(int32_t p) {
+constexpr int32_t getParamNeutralValue(int32_t p) {
 	switch (p) {
 	case Param::Local::OSC_A_VOLUME:
 	case Param::Local::OSC_B_VOLUME:
@@ -149,17 +146,19 @@ int32_t getParamNeutralValue(int32_t p) {
 	}
 }
 
-void functionsInit() {
-
-	for (int32_t p = 0; p < kNumParams; p++) {
-		paramRanges[p] = getParamRange(p);
-	}
-
+template <int32_t (*getValue)(int32_t)>
+constexpr std::array<int32_t, kNumParams> makeParamTable() {
+	std::array<int32_t, kNumParams> table{};
 	for (int32_t p = 0; p < kNumParams; p++) {
-		paramNeutralValues[p] = getParamNeutralValue(p);
+		table[p] = getValue(p);
 	}
+	return table;
 }
 
+// Constant-initialized, so these go in read-only data rather than being filled in at boot
+constexpr std::array<int32_t, kNumParams> paramRanges = makeParamTable<getParamRange>();
+constexpr std::array<int32_t, kNumParams> paramNeutralValues = makeParamTable<getParamNeutralValue>();
+
 int32_t getFinalParameterValueHybrid(int32_t paramNeutralValue, int32_t patchedValue) {
 	// Allows for max output values of +- 1073741824, which the panning code understands as the full range from left to right
 	int32_t preLimits = (paramNeutralValue >> 2) + (patchedValue >> 1);
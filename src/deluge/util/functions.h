@@ -21,6 +21,7 @@
 #include "fatfs/ff.h"
 #include "util/fixedpoint.h"
 #include "util/lookuptables/lookuptables.h"
+#include <array>
 #include <cmath>
 #include <cstdint>
 #include <cstring>
@@ -37,10 +38,9 @@ extern const uint8_t modButtonY[];
 
 extern uint8_t subModeToReturnTo;
 
-extern int32_t paramRanges[];
-extern int32_t paramNeutralValues[];
-
-void functionsInit();
+// Worked out at compile time, from getParamRange() and getParamNeutralValue() in functions.cpp
+extern const std::array<int32_t, kNumParams> paramRanges;
+extern const std::array<int32_t, kNumParams> paramNeutralValues;
 
 static inline void intToString(int32_t number, char* buffer) {
 	intToString(number, buffer, 1);
@@ -0,0 +1,196 @@
+/*
+ * Copyright © 2023 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "arm_neon.h"
+#include "util/functions.h"
+#include "util/lookuptables/lookuptables.h"
+#include <cstdint>
+
+/*
+ * Versions of the per-sample helpers in util/functions.h which work on four values at once, in the lanes of an
+ * int32x4_t. Each lane gives exactly what the scalar helper would for that value - so the error bound against the
+ * scalar versions is zero, and a DSP loop can switch to these without a change in sound. The scalar versions' own
+ * accuracy (mostly set by their 256-entry lookup tables) carries over unchanged. tests/functions_quad_tests.cpp checks
+ * this.
+ *
+ * Table lookups still read each lane's two table values separately, as NEON has no gather; the win is in doing the
+ * index, interpolation and saturation maths for all four lanes together.
+ */
+
+/// multiply_32x32_rshift32() on each lane
+[[gnu::always_inline]] inline int32x4_t multiply_32x32_rshift32_quad(int32x4_t a, int32x4_t b) {
+	return vcombine_s32(vshrn_n_s64(vmull_s32(vget_low_s32(a), vget_low_s32(b)), 32),
+	                    vshrn_n_s64(vmull_s32(vget_high_s32(a), vget_high_s32(b)), 32));
+}
+[[gnu::always_inline]] inline int32x4_t multiply_32x32_rshift32_quad(int32x4_t a, q31_t b) {
+	return vcombine_s32(vshrn_n_s64(vmull_n_s32(vget_low_s32(a), b), 32),
+	                    vshrn_n_s64(vmull_n_s32(vget_high_s32(a), b), 32));
+}
+
+/// multiply_32x32_rshift32_rounded() on each lane
+[[gnu::always_inline]] inline int32x4_t multiply_32x32_rshift32_rounded_quad(int32x4_t a, int32x4_t b) {
+	return vcombine_s32(vrshrn_n_s64(vmull_s32(vget_low_s32(a), vget_low_s32(b)), 32),
+	                    vrshrn_n_s64(vmull_s32(vget_high_s32(a), vget_high_s32(b)), 32));
+}
+[[gnu::always_inline]] inline int32x4_t multiply_32x32_rshift32_rounded_quad(int32x4_t a, q31_t b) {
+	return vcombine_s32(vrshrn_n_s64(vmull_n_s32(vget_low_s32(a), b), 32),
+	                    vrshrn_n_s64(vmull_n_s32(vget_high_s32(a), b), 32));
+}
+
+/// multiply_accumulate_32x32_rshift32_rounded() on each lane. smmlar rounds the product on its own before adding, so
+/// this is just the rounded multiply plus sum
+[[gnu::always_inline]] inline int32x4_t multiply_accumulate_32x32_rshift32_rounded_quad(int32x4_t sum, int32x4_t a,
+                                                                                        int32x4_t b) {
+	return vaddq_s32(sum, multiply_32x32_rshift32_rounded_quad(a, b));
+}
+
+/// lshiftAndSaturateUnknown() on each lane, with its own shift for each - which, as there, must be from 1 to 31.
+/// vqshl saturates the positive side to 2147483647, where the scalar version's ssat-then-shift leaves the bottom lshift
+/// bits clear, so those get masked off
+[[gnu::always_inline]] inline int32x4_t lshiftAndSaturateUnknown_quad(int32x4_t val, int32x4_t lshift) {
+	return vandq_s32(vqshlq_s32(val, lshift), vshlq_s32(vdupq_n_s32(-1), lshift));
+}
+
+/// increaseMagnitudeAndSaturate() on each lane. magnitude must be from -31 to 31
+[[gnu::always_inline]] inline int32x4_t increaseMagnitudeAndSaturate_quad(int32x4_t number, int32x4_t magnitude) {
+	// A negative shift is a plain arithmetic right shift for vqshl, and leaves the mask all ones
+	return vandq_s32(vqshlq_s32(number, magnitude), vshlq_s32(vdupq_n_s32(-1), vmaxq_s32(magnitude, vdupq_n_s32(0))));
+}
+
+/// Looks up each lane's table[whichValue] and table[whichValue + 1]
+template <typename T>
+[[gnu::always_inline]] inline void gatherTablePairs_quad(uint32x4_t whichValue, T const* table, int32x4_t* value1,
+                                                         int32x4_t* value2) {
+	int32_t values1[4];
+	int32_t values2[4];
+	uint32_t which[4];
+	vst1q_u32(which, whichValue);
+	for (int32_t i = 0; i < 4; i++) {
+		values1[i] = table[which[i]];
+		values2[i] = table[which[i] + 1];
+	}
+	*value1 = vld1q_s32(values1);
+	*value2 = vld1q_s32(values2);
+}
+
+/// interpolateTableSigned() on each lane. As there, input must not have any extra bits set than numBitsInInput
+/// specifies
+[[gnu::always_inline]] inline int32x4_t interpolateTableSigned_quad(uint32x4_t input, int32_t numBitsInInput,
+                                                                    const int16_t* table,
+                                                                    int32_t numBitsInTableSize = 8) {
+	uint32x4_t whichValue = vshlq_u32(input, vdupq_n_s32(numBitsInTableSize - numBitsInInput));
+	// vshl takes care of both directions the scalar version might shift in
+	uint32x4_t shifted = vshlq_u32(input, vdupq_n_s32(16 + numBitsInTableSize - numBitsInInput));
+	int32x4_t strength2 = vreinterpretq_s32_u32(vandq_u32(shifted, vdupq_n_u32(65535)));
+	int32x4_t strength1 = vsubq_s32(vdupq_n_s32(65536), strength2);
+
+	int32x4_t value1;
+	int32x4_t value2;
+	gatherTablePairs_quad(whichValue, table, &value1, &value2);
+	return vmlaq_s32(vmulq_s32(value1, strength1), value2, strength2);
+}
+
+/// interpolateTable() on each lane, for the unsigned tables. Same input requirement as above
+[[gnu::always_inline]] inline int32x4_t interpolateTable_quad(uint32x4_t input, int32_t numBitsInInput,
+                                                              const uint16_t* table, int32_t numBitsInTableSize = 8) {
+	uint32x4_t whichValue = vshlq_u32(input, vdupq_n_s32(numBitsInTableSize - numBitsInInput));
+	uint32x4_t shifted = vshlq_u32(input, vdupq_n_s32(15 + numBitsInTableSize - numBitsInInput));
+	int32x4_t strength2 = vreinterpretq_s32_u32(vandq_u32(shifted, vdupq_n_u32(32767)));
+	int32x4_t strength1 = vsubq_s32(vdupq_n_s32(32768), strength2);
+
+	int32x4_t value1;
+	int32x4_t value2;
+	gatherTablePairs_quad(whichValue, table, &value1, &value2);
+	return vmlaq_s32(vmulq_s32(value1, strength1), value2, strength2);
+}
+
+/// getSine() on each lane
+[[gnu::always_inline]] inline int32x4_t getSine_quad(uint32x4_t phase, uint8_t numBitsInInput = 32) {
+	return interpolateTableSigned_quad(phase, numBitsInInput, sineWaveSmall, 8);
+}
+
+/// getTanHUnknown() on each lane, all with the same saturationAmount
+[[gnu::always_inline]] inline int32x4_t getTanHUnknown_quad(int32x4_t input, uint32_t saturationAmount) {
+	if (saturationAmount) {
+		input = lshiftAndSaturateUnknown_quad(input, vdupq_n_s32(saturationAmount));
+	}
+	uint32x4_t workingValue = vaddq_u32(vreinterpretq_u32_s32(input), vdupq_n_u32(2147483648u));
+
+	int32x4_t tanH = interpolateTableSigned_quad(workingValue, 32, tanHSmall, 8);
+	return vshlq_s32(tanH, vdupq_n_s32(-(int32_t)(saturationAmount + 2)));
+}
+
+/// getExp() on each lane. As with the scalar version, (adjustment >> 26) + 2 must stay within
+/// increaseMagnitudeAndSaturate()'s range
+[[gnu::always_inline]] inline int32x4_t getExp_quad(int32x4_t presetValue, int32x4_t adjustment) {
+	int32x4_t magnitudeIncrease = vaddq_s32(vshrq_n_s32(adjustment, 26), vdupq_n_s32(2));
+
+	// Do "fine" adjustment - change less than one doubling
+	uint32x4_t fine = vandq_u32(vreinterpretq_u32_s32(adjustment), vdupq_n_u32(67108863));
+	int32x4_t adjustedPresetValue =
+	    multiply_32x32_rshift32_quad(presetValue, interpolateTable_quad(fine, 26, expTableSmall));
+
+	return increaseMagnitudeAndSaturate_quad(adjustedPresetValue, magnitudeIncrease);
+}
+
+/// getNoise() four times, one per lane in order. CONG is a linear congruential generator, so advancing it by one to
+/// four steps is just another multiply and add each - the lanes can all be worked out from the current jcong at once,
+/// and the sequence is identical to calling getNoise() four times
+[[gnu::always_inline]] inline int32x4_t getNoise_quad() {
+	static constexpr uint32_t multipliers[4] = {69069u, 475559465u, 2801775573u, 1790562961u};
+	static constexpr uint32_t increments[4] = {1234567u, 3667164066u, 249762113u, 2231956628u};
+
+	uint32x4_t noise = vmlaq_n_u32(vld1q_u32(increments), vld1q_u32(multipliers), jcong);
+	jcong = vgetq_lane_u32(noise, 3);
+	return vreinterpretq_s32_u32(noise);
+}
+
+/// swapEndianness32() on each lane
+[[gnu::always_inline]] inline uint32x4_t swapEndianness32_quad(uint32x4_t input) {
+	return vreinterpretq_u32_u8(vrev32q_u8(vreinterpretq_u8_u32(input)));
+}
+
+/// swapEndianness2x16() on each lane
+[[gnu::always_inline]] inline uint32x4_t swapEndianness2x16_quad(uint32x4_t input) {
+	return vreinterpretq_u32_u8(vrev16q_u8(vreinterpretq_u8_u32(input)));
+}
+
+/// convertFloatToIntAtMemoryLocation() on each lane, from the float's raw bits. Converting to fixed point truncates
+/// toward zero just like the scalar version's shift-then-negate does, so below a magnitude of 1 the two agree. From 1
+/// up - infinities and NaNs included - the scalar version gives +/-2147483647, which the conversion wouldn't (it
+/// saturates negatives to -2147483648, and takes NaNs to 0), so those lanes get picked out and set to that
+[[gnu::always_inline]] inline int32x4_t convertFloatToInt_quad(uint32x4_t input) {
+	int32x4_t converted = vcvtq_n_s32_f32(vreinterpretq_f32_u32(input), 31);
+
+	uint32x4_t isOneOrMore = vcgeq_u32(vandq_u32(input, vdupq_n_u32(0x7F800000)), vdupq_n_u32(0x3F800000));
+	int32x4_t sign = vshrq_n_s32(vreinterpretq_s32_u32(input), 31); // -1 if negative, else 0
+	int32x4_t saturated = vsubq_s32(veorq_s32(vdupq_n_s32(2147483647), sign), sign);
+
+	return vbslq_s32(isOneOrMore, saturated, converted);
+}
+
+/// Reverses the byte order of each of sixteen consecutive 3-byte values starting at pos, which needn't be aligned.
+/// vld3 deinterleaves them into one register per byte position, so it's just a matter of swapping the first and last
+[[gnu::always_inline]] inline void swapEndianness24_x16(uint8_t* pos) {
+	uint8x16x3_t bytes = vld3q_u8(pos);
+	uint8x16_t firstBytes = bytes.val[0];
+	bytes.val[0] = bytes.val[2];
+	bytes.val[2] = firstBytes;
+	vst3q_u8(pos, bytes);
+}
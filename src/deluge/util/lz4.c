@@ -0,0 +1,77 @@
+#include "lz4.h"
+#include <string.h>
+
+// Decodes a bare LZ4 block - no frame around it. See the "LZ4 Block Format Description" in the LZ4 repository; the
+// compressor that goes with this is scripts/util/compress_firmware.py.
+// Returns the number of bytes written to dst, or -1 if src is malformed or wouldn't fit
+int32_t lz4_decompress_block(uint8_t* dst, int32_t dst_size, const uint8_t* src, int32_t src_len) {
+	int32_t s = 0;
+	int32_t d = 0;
+
+	while (s < src_len) {
+		uint8_t token = src[s++];
+
+		int32_t num_literals = token >> 4;
+		if (num_literals == 15) {
+			uint8_t extra;
+			do {
+				if (s >= src_len) {
+					return -1;
+				}
+				extra = src[s++];
+				num_literals += extra;
+			} while (extra == 255);
+		}
+
+		if (num_literals > src_len - s || num_literals > dst_size - d) {
+			return -1;
+		}
+		memcpy(dst + d, src + s, num_literals);
+		s += num_literals;
+		d += num_literals;
+
+		// The last sequence is just literals
+		if (s == src_len) {
+			break;
+		}
+
+		if (src_len - s < 2) {
+			return -1;
+		}
+		int32_t offset = src[s] | (src[s + 1] << 8);
+		s += 2;
+		if (offset == 0 || offset > d) {
+			return -1;
+		}
+
+		int32_t match_length = (token & 15) + 4;
+		if ((token & 15) == 15) {
+			uint8_t extra;
+			do {
+				if (s >= src_len) {
+					return -1;
+				}
+				extra = src[s++];
+				match_length += extra;
+			} while (extra == 255);
+		}
+
+		if (match_length > dst_size - d) {
+			return -1;
+		}
+
+		// Matches may overlap what they're writing - that's how runs get encoded - so those have to go a byte at a time
+		uint8_t* match = dst + d - offset;
+		if (offset >= match_length) {
+			memcpy(dst + d, match, match_length);
+		}
+		else {
+			for (int32_t i = 0; i < match_length; i++) {
+				dst[d + i] = match[i];
+			}
+		}
+		d += match_length;
+	}
+
+	return d;
+}
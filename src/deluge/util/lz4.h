@@ -0,0 +1,11 @@
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int32_t lz4_decompress_block(uint8_t* dst, int32_t dst_size, const uint8_t* src, int32_t src_len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,435 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "util/sample_codec.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// The encoder picks Rice parameters big enough that no quotient's longer than this, so the decoder can always get a
+// whole unary code out of one refill of its cache
+constexpr uint32_t kMaxRiceQuotient = 31;
+constexpr int32_t kMaxRiceParam = 30;
+constexpr int32_t kRiceParamBits = 5;
+constexpr int32_t kOrderBits = 3;
+
+inline int32_t readValue(uint8_t const* pos, int32_t byteDepth) {
+	if (byteDepth == 2) {
+		return (int16_t)(pos[0] | (pos[1] << 8));
+	}
+	return (int32_t)(((uint32_t)pos[0] << 8) | ((uint32_t)pos[1] << 16) | ((uint32_t)pos[2] << 24)) >> 8;
+}
+
+inline void writeValue(uint8_t* pos, int32_t value, int32_t byteDepth) {
+	pos[0] = value;
+	pos[1] = value >> 8;
+	if (byteDepth == 3) {
+		pos[2] = value >> 16;
+	}
+}
+
+// history[0] is the most recent value
+inline int32_t predict(int32_t order, int32_t const* history) {
+	switch (order) {
+	case 0:
+		return 0;
+	case 1:
+		return history[0];
+	case 2:
+		return 2 * history[0] - history[1];
+	case 3:
+		return 3 * history[0] - 3 * history[1] + history[2];
+	default:
+		return 4 * history[0] - 6 * history[1] + 4 * history[2] - history[3];
+	}
+}
+
+inline void pushHistory(int32_t* history, int32_t value) {
+	history[3] = history[2];
+	history[2] = history[1];
+	history[1] = history[0];
+	history[0] = value;
+}
+
+inline uint32_t zigzag(int32_t value) {
+	return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+inline int32_t signExtend(uint32_t value, int32_t numBits) {
+	return (int32_t)(value << (32 - numBits)) >> (32 - numBits);
+}
+
+// The signals a channel can be coded as
+enum Signal { LEFT, RIGHT, SIDE, NUM_SIGNALS };
+
+inline int32_t getSignal(uint8_t const* pcm, int32_t frame, Signal signal, int32_t numChannels, int32_t byteDepth) {
+	uint8_t const* pos = pcm + frame * numChannels * byteDepth;
+	switch (signal) {
+	case LEFT:
+		return readValue(pos, byteDepth);
+	case RIGHT:
+		return readValue(pos + byteDepth, byteDepth);
+	default:
+		return readValue(pos, byteDepth) - readValue(pos + byteDepth, byteDepth);
+	}
+}
+
+class BitWriter {
+public:
+	BitWriter(uint8_t* newPos, uint8_t* newEnd) : pos(newPos), end(newEnd) {}
+
+	// Up to 32 bits
+	void put(uint32_t value, int32_t numBits) {
+		if (!numBits) {
+			return;
+		}
+		cache = (cache << numBits) | (value & (0xFFFFFFFF >> (32 - numBits)));
+		bitsInCache += numBits;
+		while (bitsInCache >= 8) {
+			bitsInCache -= 8;
+			if (pos == end) {
+				overflowed = true;
+				continue;
+			}
+			*(pos++) = cache >> bitsInCache;
+		}
+	}
+
+	// The quotient in unary - as that many 0s, then a 1 - and then the remainder
+	void putRice(uint32_t value, int32_t k) {
+		put(1, (value >> k) + 1);
+		put(value, k);
+	}
+
+	void padToByte() {
+		if (bitsInCache) {
+			put(0, 8 - bitsInCache);
+		}
+	}
+
+	uint8_t* pos;
+	uint8_t* end;
+	uint64_t cache = 0;
+	int32_t bitsInCache = 0;
+	bool overflowed = false;
+};
+
+class BitReader {
+public:
+	BitReader(uint8_t const* newPos, uint8_t const* newEnd) : pos(newPos), end(newEnd) {}
+
+	// Leaves more than 32 bits in the cache. The next bit's always the top one. Thanks to the padding, a good block
+	// never needs reading past its end - if a bad one does, it just gets 0s
+	inline void refill() {
+		if (bitsInCache <= 32) {
+			if (pos + 4 <= end) {
+				uint32_t word;
+				memcpy(&word, pos, 4);
+				pos += 4;
+				cache |= (uint64_t)__builtin_bswap32(word) << (32 - bitsInCache);
+			}
+			else {
+				corrupt = true;
+			}
+			bitsInCache += 32;
+		}
+	}
+
+	// 1 to 32 bits
+	inline uint32_t get(int32_t numBits) {
+		refill();
+		uint32_t value = cache >> (64 - numBits);
+		cache <<= numBits;
+		bitsInCache -= numBits;
+		return value;
+	}
+
+	inline int32_t getRice(int32_t k) {
+		refill();
+		uint32_t quotient = cache ? __builtin_clzll(cache) : 64;
+		if (quotient > kMaxRiceQuotient) {
+			corrupt = true;
+			quotient = 0;
+		}
+		cache <<= quotient + 1;
+		bitsInCache -= quotient + 1;
+		uint32_t value = quotient << k;
+		if (k) {
+			value |= get(k);
+		}
+		return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+	}
+
+	uint8_t const* pos;
+	uint8_t const* end;
+	uint64_t cache = 0;
+	int32_t bitsInCache = 0;
+	bool corrupt = false;
+};
+
+// The smallest parameter that keeps every quotient short enough, or else the best one near log2 of the mean, which is
+// where the best one always is
+int32_t chooseRiceParam(uint32_t const* values, int32_t numValues) {
+	if (!numValues) {
+		return 0;
+	}
+
+	uint32_t maxValue = 0;
+	uint64_t sum = 0;
+	for (int32_t i = 0; i < numValues; i++) {
+		maxValue = std::max(maxValue, values[i]);
+		sum += values[i];
+	}
+
+	int32_t minK = 0;
+	while ((maxValue >> minK) > kMaxRiceQuotient) {
+		minK++;
+	}
+
+	uint64_t mean = sum / numValues;
+	int32_t estimate = 0;
+	while ((mean >> estimate) > 1) {
+		estimate++;
+	}
+
+	int32_t bestK = minK;
+	uint64_t bestNumBits = UINT64_MAX;
+	for (int32_t k = std::max(minK, estimate - 1); k <= std::min(kMaxRiceParam, std::max(minK, estimate + 1)); k++) {
+		uint64_t numBits = (uint64_t)numValues * (k + 1);
+		for (int32_t i = 0; i < numValues; i++) {
+			numBits += values[i] >> k;
+		}
+		if (numBits < bestNumBits) {
+			bestNumBits = numBits;
+			bestK = k;
+		}
+	}
+	return bestK;
+}
+
+// Turns residuals back into values, in place. Any before start are values already - the warm-up at the start of a
+// block - and just go into the history
+template <int32_t order>
+void reconstruct(int32_t* values, int32_t start, int32_t end, int32_t* savedHistory) {
+	int32_t history[kSampleCodecMaxOrder];
+	memcpy(history, savedHistory, sizeof(history));
+	for (int32_t i = 0; i < start; i++) {
+		pushHistory(history, values[i]);
+	}
+	for (int32_t i = start; i < end; i++) {
+		int32_t value = values[i] + predict(order, history);
+		values[i] = value;
+		pushHistory(history, value);
+	}
+	memcpy(savedHistory, history, sizeof(history));
+}
+
+} // namespace
+
+uint32_t encodeSampleBlock(uint8_t const* pcm, int32_t numFrames, int32_t numChannels, int32_t byteDepth, uint8_t* out,
+                           uint32_t maxOutBytes) {
+
+	// For each signal, the total size of the residuals each predictor would leave - a good enough guide to which'll
+	// code smallest
+	int32_t numSignals = (numChannels == 2) ? NUM_SIGNALS : 1;
+	uint64_t totals[NUM_SIGNALS][kSampleCodecMaxOrder + 1] = {};
+	for (int32_t f = kSampleCodecMaxOrder; f < numFrames; f++) {
+		for (int32_t s = 0; s < numSignals; s++) {
+			int32_t history[kSampleCodecMaxOrder];
+			for (int32_t i = 0; i < kSampleCodecMaxOrder; i++) {
+				history[i] = getSignal(pcm, f - 1 - i, (Signal)s, numChannels, byteDepth);
+			}
+			int32_t value = getSignal(pcm, f, (Signal)s, numChannels, byteDepth);
+			for (int32_t order = 0; order <= kSampleCodecMaxOrder; order++) {
+				totals[s][order] += std::abs(value - predict(order, history));
+			}
+		}
+	}
+
+	int32_t bestOrders[NUM_SIGNALS];
+	uint64_t bestTotals[NUM_SIGNALS];
+	for (int32_t s = 0; s < numSignals; s++) {
+		bestOrders[s] = 0;
+		for (int32_t order = 1; order <= kSampleCodecMaxOrder; order++) {
+			if (totals[s][order] < totals[s][bestOrders[s]]) {
+				bestOrders[s] = order;
+			}
+		}
+		bestTotals[s] = totals[s][bestOrders[s]];
+	}
+
+	Signal signals[2] = {LEFT, RIGHT};
+	int32_t orders[2];
+	BitWriter writer(out, out + maxOutBytes);
+
+	if (numChannels == 2) {
+		bool sideCoded = bestTotals[SIDE] < bestTotals[RIGHT];
+		if (sideCoded) {
+			signals[1] = SIDE;
+		}
+		writer.put(sideCoded, 1);
+	}
+
+	for (int32_t c = 0; c < numChannels; c++) {
+		orders[c] = std::min(bestOrders[signals[c]], numFrames);
+		writer.put(orders[c], kOrderBits);
+	}
+
+	// One more bit than the PCM, for the side channel
+	int32_t warmUpBits = byteDepth * 8 + 1;
+	for (int32_t c = 0; c < numChannels; c++) {
+		for (int32_t f = 0; f < orders[c]; f++) {
+			writer.put(getSignal(pcm, f, signals[c], numChannels, byteDepth), warmUpBits);
+		}
+	}
+
+	uint32_t residuals[kSampleCodecPartitionFrames];
+	for (int32_t partitionStart = 0; partitionStart < numFrames; partitionStart += kSampleCodecPartitionFrames) {
+		int32_t partitionEnd = std::min(partitionStart + kSampleCodecPartitionFrames, numFrames);
+
+		for (int32_t c = 0; c < numChannels; c++) {
+			int32_t start = std::max(partitionStart, orders[c]);
+			int32_t numResiduals = 0;
+			for (int32_t f = start; f < partitionEnd; f++) {
+				int32_t history[kSampleCodecMaxOrder];
+				for (int32_t i = 0; i < orders[c]; i++) {
+					history[i] = getSignal(pcm, f - 1 - i, signals[c], numChannels, byteDepth);
+				}
+				int32_t value = getSignal(pcm, f, signals[c], numChannels, byteDepth);
+				residuals[numResiduals++] = zigzag(value - predict(orders[c], history));
+			}
+
+			int32_t k = chooseRiceParam(residuals, numResiduals);
+			writer.put(k, kRiceParamBits);
+			for (int32_t i = 0; i < numResiduals; i++) {
+				writer.putRice(residuals[i], k);
+			}
+		}
+
+		if (writer.overflowed) {
+			return 0;
+		}
+	}
+
+	writer.padToByte();
+	for (int32_t i = 0; i < kSampleCodecPaddingBytes; i++) {
+		writer.put(0, 8);
+	}
+
+	if (writer.overflowed) {
+		return 0;
+	}
+	return writer.pos - out;
+}
+
+bool decodeSampleBlock(uint8_t const* in, uint32_t inBytes, int32_t numFrames, int32_t numChannels, int32_t byteDepth,
+                       uint8_t* out, int32_t skipBytes, int32_t maxOutBytes) {
+	BitReader reader(in, in + inBytes);
+
+	bool sideCoded = (numChannels == 2) && reader.get(1);
+
+	int32_t orders[2];
+	for (int32_t c = 0; c < numChannels; c++) {
+		orders[c] = reader.get(kOrderBits);
+		if (orders[c] > kSampleCodecMaxOrder || orders[c] > numFrames) {
+			return false;
+		}
+	}
+
+	// The warm-up values go straight into the first partition's
+	int32_t values[2][kSampleCodecPartitionFrames];
+	int32_t warmUpBits = byteDepth * 8 + 1;
+	for (int32_t c = 0; c < numChannels; c++) {
+		for (int32_t f = 0; f < orders[c]; f++) {
+			values[c][f] = signExtend(reader.get(warmUpBits), warmUpBits);
+		}
+	}
+
+	int32_t history[2][kSampleCodecMaxOrder] = {};
+	int32_t bytesPerFrame = numChannels * byteDepth;
+	int32_t outPos = -skipBytes;
+
+	for (int32_t partitionStart = 0; partitionStart < numFrames; partitionStart += kSampleCodecPartitionFrames) {
+		int32_t numFramesNow = std::min(kSampleCodecPartitionFrames, numFrames - partitionStart);
+
+		for (int32_t c = 0; c < numChannels; c++) {
+			int32_t start = std::max(orders[c] - partitionStart, 0);
+			int32_t k = reader.get(kRiceParamBits);
+			if (k > kMaxRiceParam) {
+				return false;
+			}
+
+			int32_t* channelValues = values[c];
+			for (int32_t i = start; i < numFramesNow; i++) {
+				channelValues[i] = reader.getRice(k);
+			}
+
+			switch (orders[c]) {
+			case 0:
+				reconstruct<0>(channelValues, start, numFramesNow, history[c]);
+				break;
+			case 1:
+				reconstruct<1>(channelValues, start, numFramesNow, history[c]);
+				break;
+			case 2:
+				reconstruct<2>(channelValues, start, numFramesNow, history[c]);
+				break;
+			case 3:
+				reconstruct<3>(channelValues, start, numFramesNow, history[c]);
+				break;
+			default:
+				reconstruct<4>(channelValues, start, numFramesNow, history[c]);
+				break;
+			}
+		}
+
+		if (reader.corrupt) {
+			return false;
+		}
+
+		if (sideCoded) {
+			for (int32_t i = 0; i < numFramesNow; i++) {
+				values[1][i] = values[0][i] - values[1][i];
+			}
+		}
+
+		for (int32_t i = 0; i < numFramesNow; i++, outPos += bytesPerFrame) {
+			if (outPos >= 0 && outPos + bytesPerFrame <= maxOutBytes) {
+				for (int32_t c = 0; c < numChannels; c++) {
+					writeValue(out + outPos + c * byteDepth, values[c][i], byteDepth);
+				}
+			}
+
+			// A frame hanging off either end gets written a byte at a time, as far as it's inside
+			else if (outPos + bytesPerFrame > 0 && outPos < maxOutBytes) {
+				uint8_t frame[2 * 3];
+				for (int32_t c = 0; c < numChannels; c++) {
+					writeValue(&frame[c * byteDepth], values[c][i], byteDepth);
+				}
+				for (int32_t b = 0; b < bytesPerFrame; b++) {
+					if (outPos + b >= 0 && outPos + b < maxOutBytes) {
+						out[outPos + b] = frame[b];
+					}
+				}
+			}
+		}
+	}
+
+	return true;
+}
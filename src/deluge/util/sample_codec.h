@@ -0,0 +1,46 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+// Lossless compression of 16 or 24-bit PCM, a block at a time, for samples' compressed transcodes - see
+// Sample::writeCompressedTranscode(). Much as in FLAC: each channel gets one of the fixed polynomial predictors of
+// order 0 to 4, a stereo block can code the side channel in place of the right, and residuals are Rice coded, with a
+// fresh Rice parameter for each partition of kSampleCodecPartitionFrames frames. Every block stands alone, so any one
+// can be decoded without those before it, and decoding is all integer adds and shifts.
+//
+// Nothing records how many frames a block holds - the caller has to know, as it does from which Cluster the block's
+// for.
+
+constexpr int32_t kSampleCodecMaxOrder = 4;
+constexpr int32_t kSampleCodecPartitionFrames = 128;
+
+// The decoder may read this far beyond a block's last bit, so the encoder leaves this much padding at the end of each
+constexpr int32_t kSampleCodecPaddingBytes = 8;
+
+// Encodes numFrames frames of interleaved, little-endian PCM. Returns how many bytes it took, or 0 if that would have
+// been more than maxOutBytes
+uint32_t encodeSampleBlock(uint8_t const* pcm, int32_t numFrames, int32_t numChannels, int32_t byteDepth, uint8_t* out,
+                           uint32_t maxOutBytes);
+
+// Decodes a block back to the interleaved PCM it was made from. That PCM's taken to start skipBytes before out, and
+// only the part of it that lands between out and out + maxOutBytes gets written - so a block can cover frames hanging
+// off either end of a Cluster. Returns false if the block turned out to be corrupt
+bool decodeSampleBlock(uint8_t const* in, uint32_t inBytes, int32_t numFrames, int32_t numChannels, int32_t byteDepth,
+                       uint8_t* out, int32_t skipBytes, int32_t maxOutBytes);
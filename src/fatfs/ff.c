@@ -61,6 +61,20 @@
 #define FA_DIRTY	0x80	/* FIL.buf[] needs to be written-back */
 
 
+/* Whether a file has a private sector buffer (FIL.buf[]). Every file does at the normal configuration, and at the
+/  tiny configuration only those given one with f_setbuf(), if FF_FS_PRIVATE_BUF is enabled */
+#if !FF_FS_TINY
+#define FF_FIL_BUF		1
+#define HAS_FIL_BUF(fp)	1
+#elif FF_FS_PRIVATE_BUF
+#define FF_FIL_BUF		1
+#define HAS_FIL_BUF(fp)	((fp)->buf != 0)
+#else
+#define FF_FIL_BUF		0
+#define HAS_FIL_BUF(fp)	0
+#endif
+
+
 /* Additional file attribute bits for internal use */
 #define AM_VOL		0x08	/* Volume label */
 #define AM_LFN		0x0F	/* LFN entry */
@@ -3844,6 +3858,9 @@ FRESULT f_open (
 			fp->err = 0;		/* Clear error flag */
 			fp->sect = 0;		/* Invalidate current data sector */
 			fp->fptr = 0;		/* Set file pointer top of the file */
+#if FF_FS_TINY && FF_FS_PRIVATE_BUF
+			fp->buf = 0;		/* Shares the window until f_setbuf() gives it a buffer of its own */
+#endif
 #if !FF_FS_READONLY
 #if !FF_FS_TINY
 			memset(fp->buf, 0, sizeof fp->buf);	/* Clear sector buffer */
@@ -3944,40 +3961,52 @@ FRESULT f_read (
 				}
 				if (disk_read(fs->pdrv, rbuff, sect, cc) != RES_OK) ABORT(fs, FR_DISK_ERR);
 #if !FF_FS_READONLY && FF_FS_MINIMIZE <= 2		/* Replace one of the read sectors with cached data if it contains a dirty sector */
+#if FF_FIL_BUF
+				if (HAS_FIL_BUF(fp)) {
+					if ((fp->flag & FA_DIRTY) && fp->sect - sect < cc) {
+						memcpy(rbuff + ((fp->sect - sect) * SS(fs)), fp->buf, SS(fs));
+					}
+				} else
+#endif
+				{
 #if FF_FS_TINY
-				if (fs->wflag && fs->winsect - sect < cc) {
-					memcpy(rbuff + ((fs->winsect - sect) * SS(fs)), fs->win, SS(fs));
-				}
-#else
-				if ((fp->flag & FA_DIRTY) && fp->sect - sect < cc) {
-					memcpy(rbuff + ((fp->sect - sect) * SS(fs)), fp->buf, SS(fs));
-				}
+					if (fs->wflag && fs->winsect - sect < cc) {
+						memcpy(rbuff + ((fs->winsect - sect) * SS(fs)), fs->win, SS(fs));
+					}
 #endif
+				}
 #endif
 				rcnt = SS(fs) * cc;				/* Number of bytes transferred */
 				continue;
 			}
-#if !FF_FS_TINY
-			if (fp->sect != sect) {			/* Load data sector if not in cache */
+#if FF_FIL_BUF
+			if (HAS_FIL_BUF(fp)) {
+				if (fp->sect != sect) {			/* Load data sector if not in cache */
 #if !FF_FS_READONLY
-				if (fp->flag & FA_DIRTY) {		/* Write-back dirty sector cache */
-					if (disk_write(fs->pdrv, fp->buf, fp->sect, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);
-					fp->flag &= (BYTE)~FA_DIRTY;
-				}
+					if (fp->flag & FA_DIRTY) {		/* Write-back dirty sector cache */
+						if (disk_write(fs->pdrv, fp->buf, fp->sect, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);
+						fp->flag &= (BYTE)~FA_DIRTY;
+					}
 #endif
-				if (disk_read(fs->pdrv, fp->buf, sect, 1) != RES_OK)	ABORT(fs, FR_DISK_ERR);	/* Fill sector cache */
+					if (disk_read(fs->pdrv, fp->buf, sect, 1) != RES_OK)	ABORT(fs, FR_DISK_ERR);	/* Fill sector cache */
+				}
 			}
 #endif
 			fp->sect = sect;
 		}
 		rcnt = SS(fs) - (UINT)fp->fptr % SS(fs);	/* Number of bytes remains in the sector */
 		if (rcnt > btr) rcnt = btr;					/* Clip it by btr if needed */
+#if FF_FIL_BUF
+		if (HAS_FIL_BUF(fp)) {
+			memcpy(rbuff, fp->buf + fp->fptr % SS(fs), rcnt);	/* Extract partial sector */
+		} else
+#endif
+		{
 #if FF_FS_TINY
-		if (move_window(fs, fp->sect) != FR_OK) ABORT(fs, FR_DISK_ERR);	/* Move sector window */
-		memcpy(rbuff, fs->win + fp->fptr % SS(fs), rcnt);	/* Extract partial sector */
-#else
-		memcpy(rbuff, fp->buf + fp->fptr % SS(fs), rcnt);	/* Extract partial sector */
+			if (move_window(fs, fp->sect) != FR_OK) ABORT(fs, FR_DISK_ERR);	/* Move sector window */
+			memcpy(rbuff, fs->win + fp->fptr % SS(fs), rcnt);	/* Extract partial sector */
 #endif
+		}
 	}
 
 	LEAVE_FF(fs, FR_OK);
@@ -4041,14 +4070,19 @@ FRESULT f_write (
 				fp->clust = clst;			/* Update current cluster */
 				if (fp->obj.sclust == 0) fp->obj.sclust = clst;	/* Set start cluster if the first write */
 			}
+#if FF_FIL_BUF
+			if (HAS_FIL_BUF(fp)) {
+				if (fp->flag & FA_DIRTY) {		/* Write-back sector cache */
+					if (disk_write(fs->pdrv, fp->buf, fp->sect, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);
+					fp->flag &= (BYTE)~FA_DIRTY;
+				}
+			} else
+#endif
+			{
 #if FF_FS_TINY
-			if (fs->winsect == fp->sect && sync_window(fs) != FR_OK) ABORT(fs, FR_DISK_ERR);	/* Write-back sector cache */
-#else
-			if (fp->flag & FA_DIRTY) {		/* Write-back sector cache */
-				if (disk_write(fs->pdrv, fp->buf, fp->sect, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);
-				fp->flag &= (BYTE)~FA_DIRTY;
-			}
+				if (fs->winsect == fp->sect && sync_window(fs) != FR_OK) ABORT(fs, FR_DISK_ERR);	/* Write-back sector cache */
 #endif
+			}
 			sect = clst2sect(fs, fp->clust);	/* Get current sector */
 			if (sect == 0) ABORT(fs, FR_INT_ERR);
 			sect += csect;
@@ -4059,45 +4093,60 @@ FRESULT f_write (
 				}
 				if (disk_write(fs->pdrv, wbuff, sect, cc) != RES_OK) ABORT(fs, FR_DISK_ERR);
 #if FF_FS_MINIMIZE <= 2
+#if FF_FIL_BUF
+				if (HAS_FIL_BUF(fp)) {
+					if (fp->sect - sect < cc) { /* Refill sector cache if it gets invalidated by the direct write */
+						memcpy(fp->buf, wbuff + ((fp->sect - sect) * SS(fs)), SS(fs));
+						fp->flag &= (BYTE)~FA_DIRTY;
+					}
+				} else
+#endif
+				{
 #if FF_FS_TINY
-				if (fs->winsect - sect < cc) {	/* Refill sector cache if it gets invalidated by the direct write */
-					memcpy(fs->win, wbuff + ((fs->winsect - sect) * SS(fs)), SS(fs));
-					fs->wflag = 0;
-				}
-#else
-				if (fp->sect - sect < cc) { /* Refill sector cache if it gets invalidated by the direct write */
-					memcpy(fp->buf, wbuff + ((fp->sect - sect) * SS(fs)), SS(fs));
-					fp->flag &= (BYTE)~FA_DIRTY;
-				}
+					if (fs->winsect - sect < cc) {	/* Refill sector cache if it gets invalidated by the direct write */
+						memcpy(fs->win, wbuff + ((fs->winsect - sect) * SS(fs)), SS(fs));
+						fs->wflag = 0;
+					}
 #endif
+				}
 #endif
 				wcnt = SS(fs) * cc;		/* Number of bytes transferred */
 				continue;
 			}
+#if FF_FIL_BUF
+			if (HAS_FIL_BUF(fp)) {
+				if (fp->sect != sect && 		/* Fill sector cache with file data */
+					fp->fptr < fp->obj.objsize &&
+					disk_read(fs->pdrv, fp->buf, sect, 1) != RES_OK) {
+						ABORT(fs, FR_DISK_ERR);
+				}
+			} else
+#endif
+			{
 #if FF_FS_TINY
-			if (fp->fptr >= fp->obj.objsize) {	/* Avoid silly cache filling on the growing edge */
-				if (sync_window(fs) != FR_OK) ABORT(fs, FR_DISK_ERR);
-				fs->winsect = sect;
-			}
-#else
-			if (fp->sect != sect && 		/* Fill sector cache with file data */
-				fp->fptr < fp->obj.objsize &&
-				disk_read(fs->pdrv, fp->buf, sect, 1) != RES_OK) {
-					ABORT(fs, FR_DISK_ERR);
-			}
+				if (fp->fptr >= fp->obj.objsize) {	/* Avoid silly cache filling on the growing edge */
+					if (sync_window(fs) != FR_OK) ABORT(fs, FR_DISK_ERR);
+					fs->winsect = sect;
+				}
 #endif
+			}
 			fp->sect = sect;
 		}
 		wcnt = SS(fs) - (UINT)fp->fptr % SS(fs);	/* Number of bytes remains in the sector */
 		if (wcnt > btw) wcnt = btw;					/* Clip it by btw if needed */
+#if FF_FIL_BUF
+		if (HAS_FIL_BUF(fp)) {
+			memcpy(fp->buf + fp->fptr % SS(fs), wbuff, wcnt);	/* Fit data to the sector */
+			fp->flag |= FA_DIRTY;
+		} else
+#endif
+		{
 #if FF_FS_TINY
-		if (move_window(fs, fp->sect) != FR_OK) ABORT(fs, FR_DISK_ERR);	/* Move sector window */
-		memcpy(fs->win + fp->fptr % SS(fs), wbuff, wcnt);	/* Fit data to the sector */
-		fs->wflag = 1;
-#else
-		memcpy(fp->buf + fp->fptr % SS(fs), wbuff, wcnt);	/* Fit data to the sector */
-		fp->flag |= FA_DIRTY;
+			if (move_window(fs, fp->sect) != FR_OK) ABORT(fs, FR_DISK_ERR);	/* Move sector window */
+			memcpy(fs->win + fp->fptr % SS(fs), wbuff, wcnt);	/* Fit data to the sector */
+			fs->wflag = 1;
 #endif
+		}
 	}
 
 	fp->flag |= FA_MODIFIED;				/* Set file change flag */
@@ -4125,10 +4174,12 @@ FRESULT f_sync (
 	res = validate(&fp->obj, &fs);	/* Check validity of the file object */
 	if (res == FR_OK) {
 		if (fp->flag & FA_MODIFIED) {	/* Is there any change to the file? */
-#if !FF_FS_TINY
-			if (fp->flag & FA_DIRTY) {	/* Write-back cached data if needed */
-				if (disk_write(fs->pdrv, fp->buf, fp->sect, 1) != RES_OK) LEAVE_FF(fs, FR_DISK_ERR);
-				fp->flag &= (BYTE)~FA_DIRTY;
+#if FF_FIL_BUF
+			if (HAS_FIL_BUF(fp)) {
+				if (fp->flag & FA_DIRTY) {	/* Write-back cached data if needed */
+					if (disk_write(fs->pdrv, fp->buf, fp->sect, 1) != RES_OK) LEAVE_FF(fs, FR_DISK_ERR);
+					fp->flag &= (BYTE)~FA_DIRTY;
+				}
 			}
 #endif
 			/* Update the directory entry */
@@ -4224,6 +4275,53 @@ FRESULT f_close (
 
 
 
+#if FF_FS_TINY && FF_FS_PRIVATE_BUF
+/*-----------------------------------------------------------------------*/
+/* Give a File its Own Sector Buffer, or Take it Back                    */
+/*-----------------------------------------------------------------------*/
+
+FRESULT f_setbuf (
+	FIL* fp,	/* Open file */
+	BYTE* buf	/* FF_MAX_SS bytes for the file's sole use until it is closed or this is called again (0:Share the window) */
+)
+{
+	FRESULT res;
+	FATFS *fs;
+
+
+	res = validate(&fp->obj, &fs);	/* Check validity of the file object */
+	if (res != FR_OK || (res = (FRESULT)fp->err) != FR_OK) LEAVE_FF(fs, res);
+	if (buf == fp->buf) LEAVE_FF(fs, FR_OK);
+
+	if (fp->buf) {	/* Hand the current sector back to the window */
+#if !FF_FS_READONLY
+		if (fp->flag & FA_DIRTY) {
+			if (disk_write(fs->pdrv, fp->buf, fp->sect, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);
+			fp->flag &= (BYTE)~FA_DIRTY;
+		}
+#endif
+		fp->buf = 0;
+		/* The window may still have a copy of one of our sectors from before, since overwritten */
+		if (sync_window(fs) != FR_OK) ABORT(fs, FR_DISK_ERR);
+		fs->winsect = (LBA_t)0 - 1;
+	}
+
+	if (buf) {	/* Take the current sector out of the window, with anything written to it there */
+		if (fp->sect != 0) {
+			if (move_window(fs, fp->sect) != FR_OK) ABORT(fs, FR_DISK_ERR);
+			memcpy(buf, fs->win, SS(fs));
+		}
+		if (sync_window(fs) != FR_OK) ABORT(fs, FR_DISK_ERR);
+		fp->buf = buf;
+	}
+
+	LEAVE_FF(fs, FR_OK);
+}
+#endif
+
+
+
+
 #if FF_FS_RPATH >= 1
 /*-----------------------------------------------------------------------*/
 /* Change Current Directory or Current Drive, Get Current Directory      */
@@ -4469,14 +4567,16 @@ FRESULT f_lseek (
 				if (dsc == 0) ABORT(fs, FR_INT_ERR);
 				dsc += (DWORD)((ofs - 1) / SS(fs)) & (fs->csize - 1);
 				if (fp->fptr % SS(fs) && dsc != fp->sect) {	/* Refill sector cache if needed */
-#if !FF_FS_TINY
+#if FF_FIL_BUF
+					if (HAS_FIL_BUF(fp)) {
 #if !FF_FS_READONLY
-					if (fp->flag & FA_DIRTY) {		/* Write-back dirty sector cache */
-						if (disk_write(fs->pdrv, fp->buf, fp->sect, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);
-						fp->flag &= (BYTE)~FA_DIRTY;
-					}
+						if (fp->flag & FA_DIRTY) {		/* Write-back dirty sector cache */
+							if (disk_write(fs->pdrv, fp->buf, fp->sect, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);
+							fp->flag &= (BYTE)~FA_DIRTY;
+						}
 #endif
-					if (disk_read(fs->pdrv, fp->buf, dsc, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);	/* Load current sector */
+						if (disk_read(fs->pdrv, fp->buf, dsc, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);	/* Load current sector */
+					}
 #endif
 					fp->sect = dsc;
 				}
@@ -4549,14 +4649,16 @@ FRESULT f_lseek (
 			fp->flag |= FA_MODIFIED;
 		}
 		if (fp->fptr % SS(fs) && nsect != fp->sect) {	/* Fill sector cache if needed */
-#if !FF_FS_TINY
+#if FF_FIL_BUF
+			if (HAS_FIL_BUF(fp)) {
 #if !FF_FS_READONLY
-			if (fp->flag & FA_DIRTY) {			/* Write-back dirty sector cache */
-				if (disk_write(fs->pdrv, fp->buf, fp->sect, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);
-				fp->flag &= (BYTE)~FA_DIRTY;
-			}
+				if (fp->flag & FA_DIRTY) {			/* Write-back dirty sector cache */
+					if (disk_write(fs->pdrv, fp->buf, fp->sect, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);
+					fp->flag &= (BYTE)~FA_DIRTY;
+				}
 #endif
-			if (disk_read(fs->pdrv, fp->buf, nsect, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);	/* Fill sector cache */
+				if (disk_read(fs->pdrv, fp->buf, nsect, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);	/* Fill sector cache */
+			}
 #endif
 			fp->sect = nsect;
 		}
@@ -4948,12 +5050,14 @@ FRESULT f_truncate (
 		}
 		fp->obj.objsize = fp->fptr;	/* Set file size to current read/write point */
 		fp->flag |= FA_MODIFIED;
-#if !FF_FS_TINY
-		if (res == FR_OK && (fp->flag & FA_DIRTY)) {
-			if (disk_write(fs->pdrv, fp->buf, fp->sect, 1) != RES_OK) {
-				res = FR_DISK_ERR;
-			} else {
-				fp->flag &= (BYTE)~FA_DIRTY;
+#if FF_FIL_BUF
+		if (HAS_FIL_BUF(fp)) {
+			if (res == FR_OK && (fp->flag & FA_DIRTY)) {
+				if (disk_write(fs->pdrv, fp->buf, fp->sect, 1) != RES_OK) {
+					res = FR_DISK_ERR;
+				} else {
+					fp->flag &= (BYTE)~FA_DIRTY;
+				}
 			}
 		}
 #endif
@@ -5719,21 +5823,26 @@ FRESULT f_forward (
 		sect = clst2sect(fs, fp->clust);			/* Get current data sector */
 		if (sect == 0) ABORT(fs, FR_INT_ERR);
 		sect += csect;
-#if FF_FS_TINY
-		if (move_window(fs, sect) != FR_OK) ABORT(fs, FR_DISK_ERR);	/* Move sector window to the file data */
-		dbuf = fs->win;
-#else
-		if (fp->sect != sect) {		/* Fill sector cache with file data */
+#if FF_FIL_BUF
+		if (HAS_FIL_BUF(fp)) {
+			if (fp->sect != sect) {		/* Fill sector cache with file data */
 #if !FF_FS_READONLY
-			if (fp->flag & FA_DIRTY) {		/* Write-back dirty sector cache */
-				if (disk_write(fs->pdrv, fp->buf, fp->sect, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);
-				fp->flag &= (BYTE)~FA_DIRTY;
+				if (fp->flag & FA_DIRTY) {		/* Write-back dirty sector cache */
+					if (disk_write(fs->pdrv, fp->buf, fp->sect, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);
+					fp->flag &= (BYTE)~FA_DIRTY;
+				}
+#endif
+				if (disk_read(fs->pdrv, fp->buf, sect, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);
 			}
+			dbuf = fp->buf;
+		} else
 #endif
-			if (disk_read(fs->pdrv, fp->buf, sect, 1) != RES_OK) ABORT(fs, FR_DISK_ERR);
-		}
-		dbuf = fp->buf;
+		{
+#if FF_FS_TINY
+			if (move_window(fs, sect) != FR_OK) ABORT(fs, FR_DISK_ERR);	/* Move sector window to the file data */
+			dbuf = fs->win;
 #endif
+		}
 		fp->sect = sect;
 		rcnt = SS(fs) - (UINT)fp->fptr % SS(fs);	/* Number of bytes remains in the sector */
 		if (rcnt > btf) rcnt = btf;					/* Clip it by btr if needed */
@@ -38,7 +38,7 @@
 /* This option switches fast seek function. (0:Disable or 1:Enable) */
 
 
-#define FF_USE_EXPAND	0
+#define FF_USE_EXPAND	1
 /* This option switches f_expand function. (0:Disable or 1:Enable) */
 
 
@@ -231,6 +231,13 @@
 /  buffer in the filesystem object (FATFS) is used for the file data transfer. */
 
 
+#define FF_FS_PRIVATE_BUF	1
+/* This option lets individual files have a private sector buffer at the tiny configuration, which f_setbuf()
+/  gives them after they're opened. (0:Disable or 1:Enable)
+/  A file streamed while other files are also being accessed then doesn't have to share the window with them, and
+/  have its sector flushed and read back in every time one of them moves it. */
+
+
 #define FF_FS_EXFAT		0
 /* This option switches support for exFAT filesystem. (0:Disable or 1:Enable)
 /  To enable exFAT, also LFN needs to be enabled. (FF_USE_LFN >= 1)
@@ -40,11 +40,6 @@ static void midiAndGateOutputTimerInterrupt(uint32_t int_sense) {
 	timerGoneOff();
 }
 
-uint32_t triggerClockRisingEdgeTimes[TRIGGER_CLOCK_INPUT_NUM_TIMES_STORED];
-
-uint32_t triggerClockRisingEdgesReceived = 0;
-uint32_t triggerClockRisingEdgesProcessed = 0;
-
 static void clearIRQInterrupt(int irqNumber) {
 	uint16_t flagRead = INTC.IRQRR.WORD;
 	if (flagRead & (1 << irqNumber)) {
@@ -57,11 +52,10 @@ static void int_irq6(uint32_t sense) {
 
 	R_INTC_Disable(IRQ_INTERRUPT_0 + 6);
 
-	triggerClockRisingEdgeTimes[triggerClockRisingEdgesReceived & (TRIGGER_CLOCK_INPUT_NUM_TIMES_STORED - 1)] =
-	    DMACnNonVolatile(SSI_TX_DMA_CHANNEL).CRSA_n; // Reading this not as volatile works fine
+	triggerClockRisingEdgeReceived(
+	    DMACnNonVolatile(SSI_TX_DMA_CHANNEL).CRSA_n); // Reading this not as volatile works fine
 
 	//uartPrintln("int");
-	triggerClockRisingEdgesReceived++;
 
 	clearIRQInterrupt(6);
 
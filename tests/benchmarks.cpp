@@ -0,0 +1,763 @@
+// Host benchmarks for the parts of the firmware which build off-device. Everything runs from a fixed seed so that
+// numbers from before and after a change can be compared directly. Run with an optional repeat count:
+//   ./RunBenchmarks [repeats]
+// Each line gives the best time of all the repeats, which filters out most of the scheduling noise.
+//
+// After those come allocation trace replays, which put a MemoryRegion through some realistic patterns and report
+// alloc and free latency percentiles, how fragmented the region got and how many steals there were. To replay a
+// trace from somewhere else instead:
+//   ./RunBenchmarks --trace <file>
+// The file has one operation per line:
+//   a <id> <size>   allocate
+//   s <id> <size>   allocate something stealable
+//   f <id>          free whatever was allocated as <id> - skipped if it got stolen in the meantime
+// ids are below kMaxTraceIds, and may be reused once freed. Or, to replay a capture of the allocation trace that
+// ENABLE_ALLOCATION_TRACE builds stream out over RTT channel 1:
+//   ./RunBenchmarks --rtt-trace <file>
+// Everything there goes into the one region, and slab and temporary allocations are left out, as they don't come
+// from a MemoryRegion directly.
+//
+// Last come XML reads of each file in tests/xml_corpus, through StorageManager's actual reading code with a mock FatFS
+// serving the file from memory, giving throughput, how many allocations were made and the most memory they held at
+// once. Each file gets read all the way through, every tag and attribute, in the way the firmware's own readers go
+// about it - see readWholeTag() - and then again just for its first few attributes, with exitTag() skipping the rest,
+// like a browser preview would. Song::readFromFile() itself needs too much of the firmware to build here. To read
+// some other file instead:
+//   ./RunBenchmarks --xml <file>
+//
+// With --results <file> as well (first), every figure also gets written to that file as one "<metric> <value>" line,
+// for `dbt bench` to check against tests/benchmark_budget.json.
+
+#include "memory/allocation_trace.h"
+#include "memory/general_memory_allocator.h"
+#include "memory/memory_region.h"
+#include "memory/slab_allocator.h"
+#include "storage/storage_manager.h"
+#include "util/container/timing_wheel.h"
+#include "util/functions.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Mock FatFS, and what StorageManager's XML reading needs from the rest of it. The file being "read" is just held in
+// memory, and f_read() copies it out a cluster at a time, as the card would
+
+constexpr uint32_t kMockClusterSize = 32768;
+
+struct FileSystemStuff fileSystemStuff;
+StorageManager storageManager{};
+
+std::string mockFileContents;
+uint32_t mockFilePos;
+int32_t numMockFileReads;
+
+extern "C" FRESULT f_read(FIL* fp, void* buff, UINT btr, UINT* br) {
+	*br = std::min<uint32_t>(btr, mockFileContents.size() - mockFilePos);
+	memcpy(buff, &mockFileContents[mockFilePos], *br);
+	mockFilePos += *br;
+	numMockFileReads++;
+	return FR_OK;
+}
+
+StorageManager::StorageManager() {
+	fileClusterBuffer = (char*)malloc(kMockClusterSize);
+	fileFlushBuffer = NULL;
+	xmlReadAborted = false;
+	readingXMLFile = false;
+}
+
+// On the device this is where the audio routine and UI get their turns
+void StorageManager::xmlReadDone() {
+}
+
+// Nothing ever gets attached, as there's no actual file
+void FileSectorBuffer::release() {
+}
+
+// Every allocation made through new, so the XML reads can say how many they made and how much they held at once
+
+uint32_t numHeapAllocations;
+uint64_t heapBytesInUse;
+uint64_t peakHeapBytesInUse;
+
+constexpr size_t kHeapHeaderSize = 16; // Keeps what's returned as aligned as malloc() made it
+
+void* operator new(size_t size) {
+	void* address = malloc(size + kHeapHeaderSize);
+	if (!address) {
+		throw std::bad_alloc();
+	}
+	*(size_t*)address = size;
+	numHeapAllocations++;
+	heapBytesInUse += size;
+	peakHeapBytesInUse = std::max(peakHeapBytesInUse, heapBytesInUse);
+	return (char*)address + kHeapHeaderSize;
+}
+
+void operator delete(void* address) noexcept {
+	if (!address) {
+		return;
+	}
+	void* block = (char*)address - kHeapHeaderSize;
+	heapBytesInUse -= *(size_t*)block;
+	free(block);
+}
+
+void operator delete(void* address, size_t size) noexcept {
+	operator delete(address);
+}
+
+namespace {
+
+constexpr int32_t kMemSize = 10000000;
+constexpr int32_t kEmptySpacesSize = 1024 * 64;
+constexpr int32_t kNumAllocations = 2000;
+
+uint8_t* rawMem;
+uint8_t* emptySpacesMemory;
+MemoryRegion memreg;
+SlabAllocator slabs;
+
+FILE* resultsFile = NULL;
+
+// e.g. "replay.song_load.peak_bytes 1234567"
+void recordResult(char const* group, char const* name, char const* metric, double value) {
+	if (resultsFile) {
+		fprintf(resultsFile, "%s.%s.%s %.2f\n", group, name, metric, value);
+	}
+}
+
+void setupMemory() {
+	memset(rawMem, 0, kMemSize);
+	memset(emptySpacesMemory, 0, kEmptySpacesSize);
+	memreg.setup(emptySpacesMemory, kEmptySpacesSize, (uint32_t)rawMem, (uint32_t)rawMem + kMemSize);
+	slabs.setup(&memreg);
+}
+
+// Returns the number of operations done, which the time gets divided by
+int64_t benchRegionAllocAndFree() {
+	void* allocations[kNumAllocations] = {0};
+	int64_t numOps = 0;
+	for (int32_t pass = 0; pass < 50; pass++) {
+		for (int32_t i = 0; i < kNumAllocations; i++) {
+			if (!allocations[i]) {
+				allocations[i] = memreg.alloc(16 + rand() % 4096, NULL, false, NULL, false);
+				numOps++;
+			}
+			else if (rand() & 1) {
+				memreg.dealloc(allocations[i]);
+				allocations[i] = NULL;
+				numOps++;
+			}
+		}
+	}
+	for (int32_t i = 0; i < kNumAllocations; i++) {
+		if (allocations[i]) {
+			memreg.dealloc(allocations[i]);
+			numOps++;
+		}
+	}
+	return numOps;
+}
+
+int64_t benchSlabAllocAndFree() {
+	void* allocations[kNumAllocations] = {0};
+	int64_t numOps = 0;
+	for (int32_t pass = 0; pass < 50; pass++) {
+		for (int32_t i = 0; i < kNumAllocations; i++) {
+			if (!allocations[i]) {
+				allocations[i] = slabs.alloc(1 + rand() % kMaxSlabObjectSize);
+				numOps++;
+			}
+			else if (rand() & 1) {
+				slabs.dealloc(allocations[i]);
+				allocations[i] = NULL;
+				numOps++;
+			}
+		}
+	}
+	for (int32_t i = 0; i < kNumAllocations; i++) {
+		if (allocations[i]) {
+			slabs.dealloc(allocations[i]);
+			numOps++;
+		}
+	}
+	return numOps;
+}
+
+int64_t numTimerCallbacks;
+
+void timerCallback(TimingWheelEntry* entry) {
+	numTimerCallbacks++;
+}
+
+// Roughly what UITimerManager sees: a handful of timers, constantly being rescheduled, with time checked far more
+// often than anything falls due
+int64_t benchTimingWheel() {
+	TimingWheel wheel(4);
+	TimingWheelEntry entries[32];
+	for (int32_t i = 0; i < 32; i++) {
+		entries[i].callback = timerCallback;
+	}
+	numTimerCallbacks = 0;
+	uint32_t now = 0;
+	for (int32_t i = 0; i < 200000; i++) {
+		if (!(rand() & 7)) {
+			wheel.schedule(&entries[rand() & 31], now, rand() % 20000);
+		}
+		now += rand() & 63;
+		wheel.advance(now);
+	}
+	for (int32_t i = 0; i < 32; i++) {
+		wheel.unschedule(&entries[i]);
+	}
+	return 200000;
+}
+
+volatile int32_t sink;
+
+int64_t benchSine() {
+	int32_t total = 0;
+	uint32_t phase = 0;
+	for (int32_t i = 0; i < 1000000; i++) {
+		total += getSine(phase) >> 8;
+		phase += 0x01234567;
+	}
+	sink = total;
+	return 1000000;
+}
+
+int64_t benchQuickLog() {
+	int32_t total = 0;
+	uint32_t input = 1;
+	for (int32_t i = 0; i < 1000000; i++) {
+		total += quickLog(input);
+		input = input * 1664525 + 1013904223;
+	}
+	sink = total;
+	return 1000000;
+}
+
+struct Benchmark {
+	char const* name;
+	char const* key; // For the results file
+	int64_t (*run)();
+	bool needsMemory;
+};
+
+const Benchmark benchmarks[] = {
+    {"MemoryRegion alloc/dealloc", "region_alloc", benchRegionAllocAndFree, true},
+    {"SlabAllocator alloc/dealloc", "slab_alloc", benchSlabAllocAndFree, true},
+    {"TimingWheel schedule/advance", "timing_wheel", benchTimingWheel, false},
+    {"getSine", "get_sine", benchSine, false},
+    {"quickLog", "quick_log", benchQuickLog, false},
+};
+
+// Allocation trace replay
+
+constexpr int32_t kMaxTraceIds = 65536;
+constexpr int32_t kFragmentationSampleInterval = 256;
+
+struct TraceOp {
+	char type; // 'a', 's' or 'f', as in the file format
+	uint32_t id;
+	uint32_t size;
+};
+
+void* liveAllocations[kMaxTraceIds];
+bool liveAllocationIsStealable[kMaxTraceIds];
+uint32_t liveAllocationSizes[kMaxTraceIds];
+uint64_t bytesInUse;
+
+class BenchStealable : public Stealable {
+public:
+	bool mayBeStolen(void* thingNotToStealFrom) { return true; }
+	void steal(char const* errorCode) {
+		liveAllocations[id] = NULL;
+		bytesInUse -= liveAllocationSizes[id];
+	}
+	int32_t getAppropriateQueue() { return 0; }
+	uint32_t id;
+};
+
+// Loading a song: lots of objects of all sizes, a few big param and note arrays, and a bit of freeing as things get
+// resized
+std::vector<TraceOp> makeSongLoadTrace() {
+	std::vector<TraceOp> trace;
+	uint32_t nextId = 0;
+	for (int32_t i = 0; i < 20000 && nextId < kMaxTraceIds; i++) {
+		uint32_t size = (rand() % 50) ? 16 + rand() % 1024 : 16384 + rand() % 65536;
+		trace.push_back({'a', nextId++, size});
+		if (!(rand() % 8)) {
+			trace.push_back({'f', (uint32_t)(rand() % nextId), 0});
+		}
+	}
+	return trace;
+}
+
+// Editing with undo: each action records a handful of smallish consequences, and the oldest action's get thrown
+// away once there are enough
+std::vector<TraceOp> makeUndoEditingTrace() {
+	constexpr int32_t kNumActionsKept = 100;
+	constexpr int32_t kMaxConsequences = 8;
+	std::vector<TraceOp> trace;
+	int32_t numConsequences[kNumActionsKept] = {0};
+	for (int32_t action = 0; action < 5000; action++) {
+		int32_t slot = action % kNumActionsKept;
+		for (int32_t c = 0; c < numConsequences[slot]; c++) {
+			trace.push_back({'f', (uint32_t)(slot * kMaxConsequences + c), 0});
+		}
+		numConsequences[slot] = 1 + rand() % kMaxConsequences;
+		for (int32_t c = 0; c < numConsequences[slot]; c++) {
+			trace.push_back({'a', (uint32_t)(slot * kMaxConsequences + c), 32 + (uint32_t)(rand() % 480)});
+		}
+	}
+	return trace;
+}
+
+// Streaming Samples: far more clusters than fit get loaded, so older ones have to be stolen, while the odd
+// non-stealable thing comes and goes in between
+std::vector<TraceOp> makeClusterChurnTrace() {
+	constexpr uint32_t kClusterSize = 32768;
+	constexpr int32_t kNumOtherIds = 256;
+	std::vector<TraceOp> trace;
+	uint32_t nextClusterId = kNumOtherIds;
+	for (int32_t i = 0; i < 4000; i++) {
+		trace.push_back({'s', nextClusterId, kClusterSize});
+		if (++nextClusterId == kMaxTraceIds) {
+			nextClusterId = kNumOtherIds;
+		}
+		// Sometimes a cluster gets let go of before it's stolen
+		if (!(rand() % 4) && nextClusterId > kNumOtherIds + 16) {
+			trace.push_back({'f', nextClusterId - 1 - rand() % 16, 0});
+		}
+		uint32_t otherId = rand() % kNumOtherIds;
+		trace.push_back({'f', otherId, 0});
+		trace.push_back({'a', otherId, 64 + (uint32_t)(rand() % 4096)});
+	}
+	return trace;
+}
+
+bool readTraceFile(char const* path, std::vector<TraceOp>& trace) {
+	FILE* file = fopen(path, "r");
+	if (!file) {
+		return false;
+	}
+	char type;
+	uint32_t id;
+	uint32_t size;
+	char line[64];
+	while (fgets(line, sizeof(line), file)) {
+		size = 0;
+		if (sscanf(line, " %c %u %u", &type, &id, &size) >= 2 && id < kMaxTraceIds
+		    && (type == 'a' || type == 's' || type == 'f')) {
+			trace.push_back({type, id, size});
+		}
+	}
+	fclose(file);
+	return true;
+}
+
+bool readRTTTraceFile(char const* path, std::vector<TraceOp>& trace) {
+	FILE* file = fopen(path, "rb");
+	if (!file) {
+		return false;
+	}
+
+	// The device talks in addresses. Give each live one an id, and reuse ids once they're freed
+	std::unordered_map<uint32_t, uint32_t> idsByAddress;
+	std::vector<uint32_t> freeIds;
+	for (uint32_t id = kMaxTraceIds; id--;) {
+		freeIds.push_back(id);
+	}
+
+	AllocationTraceEntry entry;
+	while (fread(&entry, sizeof(entry), 1, file) == 1) {
+		switch (entry.event) {
+		case AllocationTraceEvent::ALLOC: {
+			AllocationTag tag = static_cast<AllocationTag>(entry.tag);
+			if (tag == AllocationTag::SLAB || tag == AllocationTag::TEMPORARY || freeIds.empty()
+			    || idsByAddress.count(entry.address)) {
+				break;
+			}
+			uint32_t id = freeIds.back();
+			freeIds.pop_back();
+			idsByAddress[entry.address] = id;
+			trace.push_back({(tag == AllocationTag::STEALABLE) ? 's' : 'a', id, entry.size});
+			break;
+		}
+
+		// Something stolen on the device is gone just the same as if it had been freed - unless the replay's
+		// already stolen it itself
+		case AllocationTraceEvent::DEALLOC:
+		case AllocationTraceEvent::STEAL: {
+			auto found = idsByAddress.find(entry.address);
+			if (found == idsByAddress.end()) {
+				break;
+			}
+			trace.push_back({'f', found->second, 0});
+			freeIds.push_back(found->second);
+			idsByAddress.erase(found);
+			break;
+		}
+
+		default: // Extending and shortening aren't replayed
+			break;
+		}
+	}
+	fclose(file);
+	return true;
+}
+
+void printPercentiles(char const* traceKey, char const* name, std::vector<uint32_t>& latencies) {
+	if (latencies.empty()) {
+		return;
+	}
+	std::sort(latencies.begin(), latencies.end());
+	auto percentile = [&](int32_t p) { return latencies[(latencies.size() - 1) * p / 100]; };
+	printf("  %-6s n %8zu  p50 %6u  p90 %6u  p99 %6u  max %8u ns\n", name, latencies.size(), percentile(50),
+	       percentile(90), percentile(99), latencies.back());
+
+	char metric[32];
+	snprintf(metric, sizeof(metric), "%s_p99_ns", name);
+	recordResult("replay", traceKey, metric, percentile(99));
+}
+
+void replayTrace(char const* name, char const* key, std::vector<TraceOp> const& trace) {
+	setupMemory();
+	memset(liveAllocations, 0, sizeof(liveAllocations));
+	bytesInUse = 0;
+	uint64_t peakBytesInUse = 0;
+
+	std::vector<uint32_t> allocLatencies;
+	std::vector<uint32_t> freeLatencies;
+	int32_t numFailedAllocs = 0;
+	int32_t worstFragmentationPermille = 0;
+	int32_t mostFreeSpaces = 0;
+	MemoryRegionTelemetry telemetry;
+
+	for (size_t i = 0; i < trace.size(); i++) {
+		TraceOp const& op = trace[i];
+		void*& allocation = liveAllocations[op.id];
+
+		if (op.type == 'f' || allocation) {
+			if (allocation) {
+				auto start = std::chrono::steady_clock::now();
+				if (liveAllocationIsStealable[op.id]) {
+					((BenchStealable*)allocation)->~BenchStealable();
+				}
+				memreg.dealloc(allocation);
+				bytesInUse -= liveAllocationSizes[op.id];
+				freeLatencies.push_back(
+				    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+				        .count());
+				allocation = NULL;
+			}
+			if (op.type == 'f') {
+				continue;
+			}
+		}
+
+		bool stealable = (op.type == 's');
+		liveAllocationIsStealable[op.id] = stealable;
+		auto start = std::chrono::steady_clock::now();
+		allocation = memreg.alloc(op.size, NULL, stealable, NULL, false);
+		if (allocation && stealable) {
+			BenchStealable* newStealable = new (allocation) BenchStealable();
+			newStealable->id = op.id;
+			memreg.cache_manager().QueueForReclamation(0, newStealable);
+		}
+		allocLatencies.push_back(
+		    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+		if (!allocation) {
+			numFailedAllocs++;
+		}
+		else {
+			liveAllocationSizes[op.id] = op.size;
+			bytesInUse += op.size;
+			peakBytesInUse = std::max(peakBytesInUse, bytesInUse);
+		}
+
+		// How much of the free space is unusable for anything as big as the largest free run? Walks lists, so
+		// kept out of the timing
+		if (!(i % kFragmentationSampleInterval)) {
+			memreg.getTelemetry(&telemetry);
+			if (telemetry.freeBytes) {
+				int32_t fragmentationPermille =
+				    1000 - (int32_t)(((uint64_t)telemetry.largestFreeRun * 1000) / telemetry.freeBytes);
+				worstFragmentationPermille = std::max(worstFragmentationPermille, fragmentationPermille);
+			}
+			mostFreeSpaces = std::max(mostFreeSpaces, telemetry.numFreeSpaces);
+		}
+	}
+
+	memreg.getTelemetry(&telemetry);
+	printf("%s: %zu ops\n", name, trace.size());
+	printPercentiles(key, "alloc", allocLatencies);
+	printPercentiles(key, "free", freeLatencies);
+	printf("  fragmentation worst %d.%d%%  free spaces most %d, at end %d  steals %u  failed allocs %d  peak %llu bytes\n",
+	       worstFragmentationPermille / 10, worstFragmentationPermille % 10, mostFreeSpaces, telemetry.numFreeSpaces,
+	       telemetry.numSteals, numFailedAllocs, (unsigned long long)peakBytesInUse);
+
+	recordResult("replay", key, "fragmentation_permille", worstFragmentationPermille);
+	recordResult("replay", key, "free_spaces", mostFreeSpaces);
+	recordResult("replay", key, "steals", telemetry.numSteals);
+	recordResult("replay", key, "failed_allocs", numFailedAllocs);
+	recordResult("replay", key, "peak_bytes", peakBytesInUse);
+}
+
+// XML reading
+
+// Tags which hold more tags or attributes, rather than a value of their own. Not "section", which is also a clip's
+// attribute - a song's sections just get skipped past
+char const* const kXMLContainerTags[] = {
+    "song", "sound", "kit", "instruments", "soundSources", "sessionClips", "instrumentClip", "audioClip", "noteRows",
+    "noteRow", "osc1", "osc2", "lfo1", "lfo2", "envelope1", "envelope2", "modKnobs", "modKnob", "patchCables",
+    "patchCable", "defaultParams", "sampleRanges", "sampleRange", "zone", "sections", "reverb", "compressor",
+    "modeNotes", "delay", "arpeggiator", "soundParams", "kitParams", "equalizer", "unison", "modulator1", "modulator2",
+    "songParams", "midiKnobs", "midiKnob", "masterCompressor",
+};
+
+// Values which the firmware reads with readTagOrAttributeValueInt(). The rest - mostly hex param values - get read as
+// strings, like readTagOrAttributeValueHex() does
+char const* const kXMLIntTags[] = {
+    "transpose", "cents", "retrigPhase", "startSamplePos", "endSamplePos", "startLoopPos", "endLoopPos", "loopMode",
+    "reversed", "timeStretchEnable", "timeStretchAmount", "voicePriority", "isPlaying", "isSoloing",
+    "isArmedForRecording", "length", "colourOffset", "section", "inKeyMode", "yScroll", "yScrollKeyboard", "y",
+    "drumIndex", "id", "numRepeats", "modeNote", "roomSize", "dampening", "width", "attack", "release", "volume",
+    "shape", "syncLevel", "num", "detune", "pingPong", "analog", "xScroll", "xZoom", "rootNote", "swingAmount",
+    "timePerTimerTick", "timerTickFraction", "inputTickMagnitude", "affectEntire", "activeModFunction",
+    "selectedDrumIndex",
+};
+
+bool isOneOf(char const* tagName, char const* const* names, size_t numNames) {
+	for (size_t i = 0; i < numNames; i++) {
+		if (!strcmp(tagName, names[i])) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Like NoteRow::readFromFile() does with note data: a chunk of hex at a time, each decoded
+void readNoteData(int32_t noteHexLength) {
+	if (!storageManager.prepareToReadTagOrAttributeValueOneCharAtATime()) {
+		return;
+	}
+	char const* firstChars = storageManager.readNextCharsOfTagOrAttributeValue(2);
+	if (!firstChars || firstChars[0] != '0' || firstChars[1] != 'x') {
+		return;
+	}
+	int32_t total = 0;
+	while (char const* hexChars = storageManager.readNextCharsOfTagOrAttributeValue(noteHexLength)) {
+		total += hexToIntFixedLength(hexChars, 8);
+		total += hexToIntFixedLength(&hexChars[8], 8);
+		total += hexToIntFixedLength(&hexChars[16], 2);
+	}
+	sink = total;
+}
+
+// Reads every tag and attribute in the one we're in, going into all the ones which hold more
+void readWholeTag() {
+	char const* tagName;
+	while (*(tagName = storageManager.readNextTagOrAttributeName())) {
+		if (isOneOf(tagName, kXMLContainerTags, std::size(kXMLContainerTags))) {
+			readWholeTag();
+		}
+		else if (!strcmp(tagName, "noteData")) {
+			readNoteData(20);
+		}
+		else if (!strcmp(tagName, "noteDataWithLift")) {
+			readNoteData(22);
+		}
+		else if (isOneOf(tagName, kXMLIntTags, std::size(kXMLIntTags))) {
+			sink = storageManager.readTagOrAttributeValueInt();
+		}
+		else {
+			sink = *storageManager.readTagOrAttributeValue();
+		}
+		storageManager.exitTag(tagName);
+	}
+}
+
+// Just the first few attributes of the top-level tag, then exitTag() skips everything else
+void readFirstFewAttributes() {
+	char const* tagName;
+	for (int32_t i = 0; i < 4 && *(tagName = storageManager.readNextTagOrAttributeName()); i++) {
+		sink = *storageManager.readTagOrAttributeValue();
+		storageManager.exitTag(tagName);
+	}
+}
+
+void readXMLFile(void (*readTopLevelTag)()) {
+	mockFilePos = 0;
+	storageManager.beginReadingXML(kMockClusterSize);
+	char const* tagName;
+	while (*(tagName = storageManager.readNextTagOrAttributeName())) {
+		readTopLevelTag();
+		storageManager.exitTag(tagName);
+	}
+}
+
+void benchmarkXMLRead(char const* name, char const* key, char const* what, void (*readTopLevelTag)(),
+                      int32_t repeats) {
+	double bestSeconds = 0;
+	for (int32_t r = 0; r < repeats; r++) {
+		numHeapAllocations = 0;
+		numMockFileReads = 0;
+		uint64_t heapBytesAtStart = heapBytesInUse;
+		peakHeapBytesInUse = heapBytesInUse;
+
+		auto start = std::chrono::steady_clock::now();
+		readXMLFile(readTopLevelTag);
+		auto end = std::chrono::steady_clock::now();
+
+		double seconds = std::chrono::duration<double>(end - start).count();
+		if (!r || seconds < bestSeconds) {
+			bestSeconds = seconds;
+		}
+		peakHeapBytesInUse -= heapBytesAtStart;
+	}
+
+	double bytesPerSecond = mockFileContents.size() / bestSeconds;
+	printf("%-24s %-8s %10zu %12.2f %8u %10llu %8d\n", name, what, mockFileContents.size(), bytesPerSecond / 1000000,
+	       numHeapAllocations, (unsigned long long)peakHeapBytesInUse, numMockFileReads);
+
+	// Into the results file as time per byte instead, since `dbt bench` takes lower to be better for everything
+	std::string fullKey = std::string(key) + "_" + what;
+	recordResult("xml", fullKey.c_str(), "ns_per_byte", 1000000000 / bytesPerSecond);
+	recordResult("xml", fullKey.c_str(), "allocations", numHeapAllocations);
+	recordResult("xml", fullKey.c_str(), "peak_bytes", peakHeapBytesInUse);
+}
+
+bool readWholeFile(char const* path, std::string& contents) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+	contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	return true;
+}
+
+void printXMLHeading() {
+	printf("%-24s %-8s %10s %12s %8s %10s %8s\n", "xml", "read", "bytes", "MB/s", "allocs", "peak", "clusters");
+}
+
+bool benchmarkXMLFile(char const* path, char const* name, char const* key, int32_t repeats) {
+	if (!readWholeFile(path, mockFileContents)) {
+		printf("couldn't read %s\n", path);
+		return false;
+	}
+	benchmarkXMLRead(name, key, "whole", readWholeTag, repeats);
+	benchmarkXMLRead(name, key, "preview", readFirstFewAttributes, repeats);
+	return true;
+}
+
+struct XMLCorpusFile {
+	char const* fileName;
+	char const* key;
+};
+
+// Smallest to biggest: a synth preset, a kit preset, and a song with 8 synths, 2 kits and 64 clips of notes
+const XMLCorpusFile xmlCorpus[] = {
+    {"SYNT000.XML", "synth"},
+    {"KIT000.XML", "kit"},
+    {"SONG000.XML", "song"},
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+	rawMem = (uint8_t*)malloc(kMemSize);
+	emptySpacesMemory = (uint8_t*)malloc(kEmptySpacesSize);
+
+	if (argc > 2 && !strcmp(argv[1], "--results")) {
+		resultsFile = fopen(argv[2], "w");
+		if (!resultsFile) {
+			printf("couldn't write %s\n", argv[2]);
+			return 1;
+		}
+		argc -= 2;
+		argv += 2;
+	}
+
+	if (argc > 2 && !strcmp(argv[1], "--trace")) {
+		std::vector<TraceOp> trace;
+		if (!readTraceFile(argv[2], trace)) {
+			printf("couldn't read %s\n", argv[2]);
+			return 1;
+		}
+		replayTrace(argv[2], "file", trace);
+		return 0;
+	}
+
+	if (argc > 2 && !strcmp(argv[1], "--rtt-trace")) {
+		std::vector<TraceOp> trace;
+		if (!readRTTTraceFile(argv[2], trace)) {
+			printf("couldn't read %s\n", argv[2]);
+			return 1;
+		}
+		replayTrace(argv[2], "rtt", trace);
+		return 0;
+	}
+
+	if (argc > 2 && !strcmp(argv[1], "--xml")) {
+		printXMLHeading();
+		return benchmarkXMLFile(argv[2], argv[2], "file", 5) ? 0 : 1;
+	}
+
+	int32_t repeats = (argc > 1) ? atoi(argv[1]) : 5;
+	if (repeats < 1) {
+		repeats = 1;
+	}
+
+	printf("%-32s %12s %12s\n", "benchmark", "ops", "ns/op");
+	for (Benchmark const& benchmark : benchmarks) {
+		double bestNsPerOp = 0;
+		int64_t numOps = 0;
+		for (int32_t r = 0; r < repeats; r++) {
+			if (benchmark.needsMemory) {
+				setupMemory();
+			}
+			srand(1);
+			auto start = std::chrono::steady_clock::now();
+			numOps = benchmark.run();
+			auto end = std::chrono::steady_clock::now();
+			double nsPerOp = std::chrono::duration<double, std::nano>(end - start).count() / numOps;
+			if (!r || nsPerOp < bestNsPerOp) {
+				bestNsPerOp = nsPerOp;
+			}
+		}
+		printf("%-32s %12lld %12.2f\n", benchmark.name, (long long)numOps, bestNsPerOp);
+		recordResult("host", benchmark.key, "ns_per_op", bestNsPerOp);
+	}
+
+	printf("\n");
+	srand(1);
+	replayTrace("song load", "song_load", makeSongLoadTrace());
+	replayTrace("undo editing", "undo_editing", makeUndoEditingTrace());
+	replayTrace("cluster churn", "cluster_churn", makeClusterChurnTrace());
+
+	printf("\n");
+	printXMLHeading();
+	for (XMLCorpusFile const& corpusFile : xmlCorpus) {
+		std::string path = std::string(XML_CORPUS_DIR "/") + corpusFile.fileName;
+		benchmarkXMLFile(path.c_str(), corpusFile.fileName, corpusFile.key, repeats);
+	}
+
+	if (resultsFile) {
+		fclose(resultsFile);
+	}
+
+	free(emptySpacesMemory);
+	free(rawMem);
+	return 0;
+}
@@ -0,0 +1,209 @@
+#include "CppUTest/TestHarness.h"
+#include "util/functions.h"
+#include "util/lookuptables/lookuptables.h"
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+
+// The quad versions need NEON, so these only build when the tests are compiled for an Arm target
+#if defined(__ARM_NEON)
+#include "util/functions_quad.h"
+
+#define NUM_TEST_VECTORS 100000
+
+namespace {
+
+// Random values, with a mix of small, large and negative ones so the saturating paths get hit too
+int32_t getRandomTestValue() {
+	uint32_t value = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+	switch (rand() & 3) {
+	case 0:
+		return (int32_t)(value >> (rand() & 31));
+	case 1:
+		return (int32_t)value >> (rand() & 31);
+	default:
+		return (int32_t)value;
+	}
+}
+
+void fillTestVector(int32_t* values) {
+	for (int32_t i = 0; i < 4; i++) {
+		values[i] = getRandomTestValue();
+	}
+}
+
+bool lanesMatch(int32x4_t vector, int32_t const* expected) {
+	int32_t lanes[4];
+	vst1q_s32(lanes, vector);
+	for (int32_t i = 0; i < 4; i++) {
+		if (lanes[i] != expected[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+TEST_GROUP(FunctionsQuad){};
+
+TEST(FunctionsQuad, multiply) {
+	for (int32_t t = 0; t < NUM_TEST_VECTORS; t++) {
+		int32_t a[4], b[4], sum[4], expected[4];
+		fillTestVector(a);
+		fillTestVector(b);
+		fillTestVector(sum);
+
+		for (int32_t i = 0; i < 4; i++) {
+			expected[i] = multiply_32x32_rshift32(a[i], b[i]);
+		}
+		CHECK(lanesMatch(multiply_32x32_rshift32_quad(vld1q_s32(a), vld1q_s32(b)), expected));
+
+		for (int32_t i = 0; i < 4; i++) {
+			expected[i] = multiply_32x32_rshift32_rounded(a[i], b[0]);
+		}
+		CHECK(lanesMatch(multiply_32x32_rshift32_rounded_quad(vld1q_s32(a), b[0]), expected));
+
+		for (int32_t i = 0; i < 4; i++) {
+			expected[i] = multiply_accumulate_32x32_rshift32_rounded(sum[i], a[i], b[i]);
+		}
+		CHECK(lanesMatch(multiply_accumulate_32x32_rshift32_rounded_quad(vld1q_s32(sum), vld1q_s32(a), vld1q_s32(b)),
+		                 expected));
+	}
+}
+
+TEST(FunctionsQuad, saturate) {
+	for (int32_t t = 0; t < NUM_TEST_VECTORS; t++) {
+		int32_t a[4], shifts[4], magnitudes[4], expected[4];
+		fillTestVector(a);
+		for (int32_t i = 0; i < 4; i++) {
+			shifts[i] = 1 + rand() % 31;
+			magnitudes[i] = rand() % 63 - 31;
+		}
+
+		for (int32_t i = 0; i < 4; i++) {
+			expected[i] = lshiftAndSaturateUnknown(a[i], shifts[i]);
+		}
+		CHECK(lanesMatch(lshiftAndSaturateUnknown_quad(vld1q_s32(a), vld1q_s32(shifts)), expected));
+
+		for (int32_t i = 0; i < 4; i++) {
+			expected[i] = increaseMagnitudeAndSaturate(a[i], magnitudes[i]);
+		}
+		CHECK(lanesMatch(increaseMagnitudeAndSaturate_quad(vld1q_s32(a), vld1q_s32(magnitudes)), expected));
+	}
+}
+
+TEST(FunctionsQuad, sine) {
+	for (int32_t t = 0; t < NUM_TEST_VECTORS; t++) {
+		uint32_t phases[4];
+		int32_t expected[4];
+		int32_t numBitsInInput = 24 + rand() % 9;
+		for (int32_t i = 0; i < 4; i++) {
+			phases[i] = (uint32_t)getRandomTestValue() >> (32 - numBitsInInput);
+			expected[i] = getSine(phases[i], numBitsInInput);
+		}
+		CHECK(lanesMatch(getSine_quad(vld1q_u32(phases), numBitsInInput), expected));
+	}
+}
+
+TEST(FunctionsQuad, tanH) {
+	for (int32_t t = 0; t < NUM_TEST_VECTORS; t++) {
+		int32_t a[4], expected[4];
+		fillTestVector(a);
+		uint32_t saturationAmount = rand() % 8;
+		for (int32_t i = 0; i < 4; i++) {
+			expected[i] = getTanHUnknown(a[i], saturationAmount);
+		}
+		CHECK(lanesMatch(getTanHUnknown_quad(vld1q_s32(a), saturationAmount), expected));
+	}
+}
+
+TEST(FunctionsQuad, exp) {
+	for (int32_t t = 0; t < NUM_TEST_VECTORS; t++) {
+		int32_t presetValues[4], adjustments[4], expected[4];
+		fillTestVector(presetValues);
+		for (int32_t i = 0; i < 4; i++) {
+			// Keep (adjustment >> 26) + 2 within increaseMagnitudeAndSaturate()'s range
+			adjustments[i] = getRandomTestValue() >> 1;
+			expected[i] = getExp(presetValues[i], adjustments[i]);
+		}
+		CHECK(lanesMatch(getExp_quad(vld1q_s32(presetValues), vld1q_s32(adjustments)), expected));
+	}
+}
+
+TEST(FunctionsQuad, interpolateTable) {
+	for (int32_t t = 0; t < NUM_TEST_VECTORS; t++) {
+		uint32_t inputs[4];
+		int32_t expected[4];
+		for (int32_t i = 0; i < 4; i++) {
+			inputs[i] = (uint32_t)getRandomTestValue() >> 6;
+			expected[i] = interpolateTable(inputs[i], 26, expTableSmall);
+		}
+		CHECK(lanesMatch(interpolateTable_quad(vld1q_u32(inputs), 26, expTableSmall), expected));
+	}
+}
+
+TEST(FunctionsQuad, noise) {
+	for (int32_t t = 0; t < NUM_TEST_VECTORS; t++) {
+		uint32_t seed = (uint32_t)getRandomTestValue();
+		int32_t expected[4];
+		jcong = seed;
+		for (int32_t i = 0; i < 4; i++) {
+			expected[i] = getNoise();
+		}
+		uint32_t expectedSeed = jcong;
+
+		jcong = seed;
+		CHECK(lanesMatch(getNoise_quad(), expected));
+		CHECK_EQUAL(expectedSeed, jcong);
+	}
+}
+
+TEST(FunctionsQuad, swapEndianness) {
+	for (int32_t t = 0; t < NUM_TEST_VECTORS; t++) {
+		int32_t a[4], expected[4];
+		fillTestVector(a);
+		uint32x4_t input = vreinterpretq_u32_s32(vld1q_s32(a));
+
+		for (int32_t i = 0; i < 4; i++) {
+			expected[i] = swapEndianness32(a[i]);
+		}
+		CHECK(lanesMatch(vreinterpretq_s32_u32(swapEndianness32_quad(input)), expected));
+
+		for (int32_t i = 0; i < 4; i++) {
+			expected[i] = swapEndianness2x16(a[i]);
+		}
+		CHECK(lanesMatch(vreinterpretq_s32_u32(swapEndianness2x16_quad(input)), expected));
+	}
+
+	// And the 24-bit one, off an odd alignment
+	uint8_t bytes[49];
+	uint8_t expected[49];
+	for (int32_t i = 0; i < 49; i++) {
+		bytes[i] = rand();
+	}
+	memcpy(expected, bytes, sizeof(bytes));
+	for (int32_t i = 1; i < 49; i += 3) {
+		std::swap(expected[i], expected[i + 2]);
+	}
+	swapEndianness24_x16(&bytes[1]);
+	CHECK(!memcmp(bytes, expected, sizeof(bytes)));
+}
+
+TEST(FunctionsQuad, convertFloatToInt) {
+	for (int32_t t = 0; t < NUM_TEST_VECTORS; t++) {
+		uint32_t floats[4];
+		int32_t expected[4];
+		for (int32_t i = 0; i < 4; i++) {
+			// Exponents from where the scalar version's shift is 31 up to well past 1, plus the odd infinity or NaN
+			uint32_t exponent = (rand() % 50) ? 96 + rand() % 40 : 255;
+			floats[i] = ((uint32_t)getRandomTestValue() & 0x807FFFFF) | (exponent << 23);
+			uint32_t scalar = floats[i];
+			convertFloatToIntAtMemoryLocation(&scalar);
+			expected[i] = scalar;
+		}
+		CHECK(lanesMatch(convertFloatToInt_quad(vld1q_u32(floats)), expected));
+	}
+}
+
+#endif
@@ -0,0 +1,112 @@
+#include "CppUTest/TestHarness.h"
+#include "util/container/hashtable/hash_map.h"
+#include <memory>
+
+// The firmware's allocators aren't there on the host, so these use std::allocator
+
+namespace {
+
+using IntMap = deluge::HashMap<uint32_t, int32_t, deluge::HashMapHash<uint32_t>, std::equal_to<uint32_t>,
+                               std::allocator<int32_t>>;
+
+// Cheap pseudo-random sequence, so the test's the same every time
+uint32_t nextRandom(uint32_t& state) {
+	state = state * 1664525 + 1013904223;
+	return state >> 8;
+}
+
+TEST_GROUP(HashMapTests){};
+
+TEST(HashMapTests, insertFindErase) {
+	IntMap map;
+	CHECK(map.empty());
+	POINTERS_EQUAL(nullptr, map.find(5));
+
+	bool alreadyPresent;
+	int32_t* value = map.insert(5, 50, &alreadyPresent);
+	CHECK(value);
+	CHECK(!alreadyPresent);
+	CHECK_EQUAL(50, *value);
+
+	// A second insert leaves the first value alone
+	value = map.insert(5, 60, &alreadyPresent);
+	CHECK(alreadyPresent);
+	CHECK_EQUAL(50, *value);
+	CHECK_EQUAL(1, map.size());
+
+	CHECK(map.erase(5));
+	CHECK(!map.erase(5));
+	POINTERS_EQUAL(nullptr, map.find(5));
+	CHECK(map.empty());
+}
+
+// Lots of growing, with lookups and erases happening while the old buckets are still being migrated, checked against
+// a plain array of what should be there
+TEST(HashMapTests, matchesReferenceThroughGrowth) {
+	constexpr int32_t kNumKeys = 2000;
+	int32_t expected[kNumKeys];
+	bool present[kNumKeys] = {};
+	int32_t numPresent = 0;
+
+	IntMap map;
+	uint32_t randomState = 1;
+	for (int32_t i = 0; i < 100000; i++) {
+		uint32_t key = nextRandom(randomState) % kNumKeys;
+		if (nextRandom(randomState) % 3) {
+			bool alreadyPresent;
+			int32_t* value = map.insert(key, i, &alreadyPresent);
+			CHECK(value);
+			CHECK_EQUAL(present[key], alreadyPresent);
+			if (!present[key]) {
+				present[key] = true;
+				expected[key] = i;
+				numPresent++;
+			}
+			CHECK_EQUAL(expected[key], *value);
+		}
+		else {
+			CHECK_EQUAL(present[key], map.erase(key));
+			if (present[key]) {
+				present[key] = false;
+				numPresent--;
+			}
+		}
+		CHECK_EQUAL(numPresent, map.size());
+
+		if (!(i % 997)) {
+			for (uint32_t k = 0; k < kNumKeys; k++) {
+				int32_t* value = map.find(k);
+				CHECK_EQUAL(present[k], value != nullptr);
+				if (value) {
+					CHECK_EQUAL(expected[k], *value);
+				}
+			}
+		}
+	}
+
+	int32_t numVisited = 0;
+	map.forEach([&](uint32_t key, int32_t value) {
+		CHECK(present[key]);
+		CHECK_EQUAL(expected[key], value);
+		numVisited++;
+	});
+	CHECK_EQUAL(numPresent, numVisited);
+}
+
+TEST(HashMapTests, pointerKeys) {
+	static int32_t things[1000];
+	deluge::HashMap<int32_t*, int32_t, deluge::HashMapHash<int32_t*>, std::equal_to<int32_t*>,
+	                std::allocator<int32_t>>
+	    map;
+	for (int32_t i = 0; i < 1000; i++) {
+		CHECK(map.insert(&things[i], i));
+	}
+	for (int32_t i = 0; i < 1000; i++) {
+		CHECK_EQUAL(i, *map.find(&things[i]));
+	}
+	map.clear();
+	CHECK(map.empty());
+	POINTERS_EQUAL(nullptr, map.find(&things[0]));
+}
+
+} // namespace
@@ -2,6 +2,7 @@
 #include "CppUTestExt/MockSupport.h"
 #include "memory/general_memory_allocator.h"
 #include "memory/memory_region.h"
+#include "memory/slab_allocator.h"
 #include "util/functions.h"
 #include <iostream>
 #include <stdlib.h>
@@ -279,4 +280,126 @@ TEST(MemoryAllocation, RandomAllocFragmentation) {
 	//std::cout << (float(averageSize / numRepeats) / float(mem_size)) << std::endl;
 	CHECK(averageSize / numRepeats > 0.64 * mem_size);
 };
+
+TEST(MemoryAllocation, telemetry) {
+	void* testAllocations[10];
+	for (int i = 0; i < 10; i++) {
+		testAllocations[i] = memreg.alloc(1000, NULL, false, NULL, false);
+	}
+	// Every other one, so none of the holes get merged
+	for (int i = 0; i < 10; i += 2) {
+		memreg.dealloc(testAllocations[i]);
+	}
+	void* testalloc = memreg.alloc(2000, NULL, true, NULL, false);
+	StealableTest* stealable = new (testalloc) StealableTest();
+	memreg.cache_manager().QueueForReclamation(1, stealable);
+
+	MemoryRegionTelemetry telemetry;
+	memreg.getTelemetry(&telemetry);
+
+	// The five holes, plus everything after the allocations
+	CHECK_EQUAL(6, telemetry.numFreeSpaces);
+	CHECK_EQUAL(5, telemetry.freeSpaceHistogram[2]);
+	CHECK_EQUAL(1, telemetry.freeSpaceHistogram[kNumFreeSpaceSizeBuckets - 1]);
+	CHECK(telemetry.largestFreeRun > mem_size - 15000);
+	CHECK(telemetry.freeBytes > telemetry.largestFreeRun + 5 * 1000);
+	CHECK_EQUAL(0, telemetry.stealableBytes[0]);
+	CHECK_EQUAL(1, telemetry.numStealables[1]);
+	CHECK_EQUAL(2008, telemetry.stealableBytes[1]);
+	CHECK_EQUAL(0, telemetry.numSteals);
+};
+
+TEST(MemoryAllocation, slideLeft) {
+	void* testAllocations[5];
+	for (int i = 0; i < 5; i++) {
+		testAllocations[i] = memreg.alloc(1000, NULL, false, NULL, false);
+	}
+	testWritingMemory(testAllocations[2], 1000);
+	memreg.dealloc(testAllocations[1]);
+	memreg.dealloc(testAllocations[3]);
+
+	// Too big to move, or nowhere to move to
+	CHECK(memreg.slideLeft(testAllocations[2], 500) == NULL);
+	CHECK(memreg.slideLeft(testAllocations[0], 1000) == NULL);
+
+	void* moved = memreg.slideLeft(testAllocations[2], 1000);
+	CHECK(moved == testAllocations[1]);
+	CHECK(testAllocationStructure(moved, 1000, SPACE_HEADER_ALLOCATED));
+	CHECK(testReadingMemory(moved, 1000));
+
+	// The two holes are now one, straight after it
+	MemoryRegionTelemetry telemetry;
+	memreg.getTelemetry(&telemetry);
+	CHECK_EQUAL(2, telemetry.numFreeSpaces);
+	void* testalloc = memreg.alloc(2008, NULL, false, NULL, false);
+	CHECK(testalloc == (char*)moved + 1008);
+	CHECK(testAllocationStructure(testAllocations[4], 1000, SPACE_HEADER_ALLOCATED));
+};
+
+TEST_GROUP(SlabAllocation) {
+	MemoryRegion memreg;
+	SlabAllocator slabs;
+	uint32_t empty_spaze_size = sizeof(EmptySpaceRecord) * 512;
+	void* emptySpacesMemory = malloc(empty_spaze_size);
+	int32_t mem_size = MEM_SIZE;
+	void* raw_mem = malloc(mem_size);
+	void setup() {
+		memset(raw_mem, 0, mem_size);
+		memset(emptySpacesMemory, 0, empty_spaze_size);
+		memreg.setup(emptySpacesMemory, empty_spaze_size, (uint32_t)raw_mem, (uint32_t)raw_mem + mem_size);
+		slabs.setup(&memreg);
+	}
+};
+
+TEST(SlabAllocation, allocSmall) {
+	void* testalloc = slabs.alloc(20);
+	CHECK(testalloc != NULL);
+	CHECK(SlabAllocator::isSlabAllocation(testalloc));
+	CHECK(slabs.getNumSlabs(1) == 1);
+	slabs.dealloc(testalloc);
+};
+
+TEST(SlabAllocation, tooBig) {
+	CHECK(slabs.alloc(kMaxSlabObjectSize + 1) == NULL);
+};
+
+TEST(SlabAllocation, regionAllocationsAreNotSlab) {
+	void* testalloc = memreg.alloc(100, NULL, false, NULL, false);
+	CHECK(!SlabAllocator::isSlabAllocation(testalloc));
+};
+
+TEST(SlabAllocation, randomAllocAndFree) {
+	srand(1);
+	int expectedAllocations = 2000;
+	void* testAllocations[expectedAllocations] = {0};
+	uint32_t testSizes[expectedAllocations] = {0};
+	for (int j = 0; j < 50; j++) {
+		for (int i = 0; i < expectedAllocations; i++) {
+			if (!testAllocations[i]) {
+				uint32_t size = 1 + rand() % kMaxSlabObjectSize;
+				void* testalloc = slabs.alloc(size);
+				CHECK(testalloc != NULL);
+				testWritingMemory(testalloc, size);
+				testAllocations[i] = testalloc;
+				testSizes[i] = size;
+			}
+			else if (rand() % 2) {
+				CHECK(testReadingMemory(testAllocations[i], testSizes[i]));
+				slabs.dealloc(testAllocations[i]);
+				testAllocations[i] = nullptr;
+			}
+		}
+	}
+	for (int i = 0; i < expectedAllocations; i++) {
+		if (testAllocations[i]) {
+			CHECK(testReadingMemory(testAllocations[i], testSizes[i]));
+			slabs.dealloc(testAllocations[i]);
+		}
+	}
+
+	// Once everything's freed, each size class should have kept at most one slab
+	for (int c = 0; c < kNumSlabSizeClasses; c++) {
+		CHECK(slabs.getNumSlabs(c) <= 1);
+	}
+};
 } // namespace
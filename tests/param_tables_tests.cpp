@@ -0,0 +1,94 @@
+#include "CppUTest/TestHarness.h"
+#include "util/functions.h"
+
+// paramRanges and paramNeutralValues used to be filled in at boot by functionsInit(). They're now worked out at compile
+// time, and these are the values they've always had, so any change to them shows up here rather than as a song that
+// sounds different
+
+namespace {
+
+struct ParamValue {
+	int32_t param;
+	int32_t value;
+};
+
+// Everything not listed has the default
+int32_t lookUp(ParamValue const* values, int32_t numValues, int32_t param, int32_t defaultValue) {
+	for (int32_t i = 0; i < numValues; i++) {
+		if (values[i].param == param) {
+			return values[i].value;
+		}
+	}
+	return defaultValue;
+}
+
+ParamValue const expectedRanges[] = {
+    {Param::Local::ENV_0_ATTACK, 805306368},
+    {Param::Local::ENV_1_ATTACK, 805306368},
+    {Param::Global::DELAY_RATE, 536870912},
+    {Param::Local::PITCH_ADJUST, 536870912},
+    {Param::Local::OSC_A_PITCH_ADJUST, 536870912},
+    {Param::Local::OSC_B_PITCH_ADJUST, 536870912},
+    {Param::Local::MODULATOR_0_PITCH_ADJUST, 536870912},
+    {Param::Local::MODULATOR_1_PITCH_ADJUST, 536870912},
+    {Param::Local::LPF_FREQ, 751619276},
+};
+
+ParamValue const expectedNeutralValues[] = {
+    {Param::Local::OSC_A_VOLUME, 134217728},
+    {Param::Local::OSC_B_VOLUME, 134217728},
+    {Param::Global::VOLUME_POST_REVERB_SEND, 134217728},
+    {Param::Local::NOISE_VOLUME, 134217728},
+    {Param::Global::REVERB_AMOUNT, 134217728},
+    {Param::Global::VOLUME_POST_FX, 134217728},
+    {Param::Local::VOLUME, 134217728},
+    {Param::Local::MODULATOR_0_VOLUME, 33554432},
+    {Param::Local::MODULATOR_1_VOLUME, 33554432},
+    {Param::Local::LPF_FREQ, 2000000},
+    {Param::Local::HPF_FREQ, 2672947},
+    {Param::Global::LFO_FREQ, 121739},
+    {Param::Local::LFO_LOCAL_FREQ, 121739},
+    {Param::Global::MOD_FX_RATE, 121739},
+    {Param::Local::LPF_RESONANCE, 268435450},
+    {Param::Local::HPF_RESONANCE, 268435450},
+    {Param::Local::LPF_MORPH, 268435450},
+    {Param::Local::HPF_MORPH, 268435450},
+    {Param::Local::FOLD, 268435450},
+    {Param::Local::ENV_0_ATTACK, 4096},
+    {Param::Local::ENV_1_ATTACK, 4096},
+    {Param::Local::ENV_0_RELEASE, 71680},
+    {Param::Local::ENV_1_RELEASE, 71680},
+    {Param::Local::ENV_0_DECAY, 35840},
+    {Param::Local::ENV_1_DECAY, 35840},
+    {Param::Local::ENV_0_SUSTAIN, 1073741824},
+    {Param::Local::ENV_1_SUSTAIN, 1073741824},
+    {Param::Global::DELAY_FEEDBACK, 1073741824},
+    {Param::Local::MODULATOR_0_FEEDBACK, 5931642},
+    {Param::Local::MODULATOR_1_FEEDBACK, 5931642},
+    {Param::Local::CARRIER_0_FEEDBACK, 5931642},
+    {Param::Local::CARRIER_1_FEEDBACK, 5931642},
+    {Param::Global::DELAY_RATE, 16777216},
+    {Param::Global::ARP_RATE, 16777216},
+    {Param::Local::PITCH_ADJUST, 16777216},
+    {Param::Local::OSC_A_PITCH_ADJUST, 16777216},
+    {Param::Local::OSC_B_PITCH_ADJUST, 16777216},
+    {Param::Local::MODULATOR_0_PITCH_ADJUST, 16777216},
+    {Param::Local::MODULATOR_1_PITCH_ADJUST, 16777216},
+    {Param::Global::MOD_FX_DEPTH, 526133494},
+};
+
+} // namespace
+
+TEST_GROUP(ParamTables){};
+
+TEST(ParamTables, ranges) {
+	for (int32_t p = 0; p < kNumParams; p++) {
+		LONGS_EQUAL(lookUp(expectedRanges, std::size(expectedRanges), p, 1073741824), paramRanges[p]);
+	}
+}
+
+TEST(ParamTables, neutralValues) {
+	for (int32_t p = 0; p < kNumParams; p++) {
+		LONGS_EQUAL(lookUp(expectedNeutralValues, std::size(expectedNeutralValues), p, 0), paramNeutralValues[p]);
+	}
+}
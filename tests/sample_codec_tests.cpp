@@ -0,0 +1,104 @@
+#include "CppUTest/TestHarness.h"
+#include "util/sample_codec.h"
+#include <cmath>
+#include <string.h>
+#include <vector>
+
+namespace {
+
+// Cheap pseudo-random sequence, so the test's the same every time
+uint32_t nextRandom(uint32_t& state) {
+	state = state * 1664525 + 1013904223;
+	return state >> 8;
+}
+
+// Something like music - a couple of sines with a bit of noise - or, if noisy, full scale noise which won't compress
+std::vector<uint8_t> makePCM(int32_t numFrames, int32_t numChannels, int32_t byteDepth, bool noisy, uint32_t seed) {
+	std::vector<uint8_t> pcm(numFrames * numChannels * byteDepth);
+	int32_t maxValue = (1 << (byteDepth * 8 - 1)) - 1;
+	for (int32_t f = 0; f < numFrames; f++) {
+		for (int32_t c = 0; c < numChannels; c++) {
+			int32_t value;
+			if (noisy) {
+				value = (int32_t)(nextRandom(seed) << 8) >> (32 - byteDepth * 8);
+			}
+			else {
+				value = (int32_t)(maxValue * (0.5 * sin(f * 0.01 + c) + 0.3 * sin(f * 0.13)))
+				        + (int32_t)(nextRandom(seed) & 63) - 32;
+			}
+			for (int32_t b = 0; b < byteDepth; b++) {
+				pcm[(f * numChannels + c) * byteDepth + b] = value >> (b * 8);
+			}
+		}
+	}
+	return pcm;
+}
+
+TEST_GROUP(SampleCodecTests){};
+
+TEST(SampleCodecTests, roundTrip) {
+	for (int32_t numChannels = 1; numChannels <= 2; numChannels++) {
+		for (int32_t byteDepth = 2; byteDepth <= 3; byteDepth++) {
+			for (int32_t noisy = 0; noisy < 2; noisy++) {
+				int32_t numFrames = 5000;
+				std::vector<uint8_t> pcm = makePCM(numFrames, numChannels, byteDepth, noisy, numChannels + byteDepth);
+				std::vector<uint8_t> encoded(pcm.size() * 2);
+				uint32_t numBytes = encodeSampleBlock(pcm.data(), numFrames, numChannels, byteDepth, encoded.data(),
+				                                      encoded.size());
+				CHECK(numBytes);
+				if (!noisy) {
+					CHECK(numBytes < pcm.size() * 3 / 4);
+				}
+
+				std::vector<uint8_t> decoded(pcm.size());
+				CHECK(decodeSampleBlock(encoded.data(), numBytes, numFrames, numChannels, byteDepth, decoded.data(), 0,
+				                        decoded.size()));
+				CHECK(decoded == pcm);
+			}
+		}
+	}
+}
+
+// Blocks cover frames hanging off the ends of a Cluster, and only what's inside it gets written
+TEST(SampleCodecTests, partialFramesAtEnds) {
+	int32_t numFrames = 1000;
+	std::vector<uint8_t> pcm = makePCM(numFrames, 2, 3, false, 1);
+	std::vector<uint8_t> encoded(pcm.size() * 2);
+	uint32_t numBytes = encodeSampleBlock(pcm.data(), numFrames, 2, 3, encoded.data(), encoded.size());
+	CHECK(numBytes);
+
+	int32_t skipBytes = 4;
+	int32_t maxOutBytes = pcm.size() - skipBytes - 5;
+	std::vector<uint8_t> decoded(maxOutBytes + 1, 0xAA);
+	CHECK(decodeSampleBlock(encoded.data(), numBytes, numFrames, 2, 3, decoded.data(), skipBytes, maxOutBytes));
+	CHECK(!memcmp(decoded.data(), &pcm[skipBytes], maxOutBytes));
+	CHECK_EQUAL(0xAA, decoded[maxOutBytes]);
+}
+
+TEST(SampleCodecTests, tinyBlocksAndNoRoom) {
+	for (int32_t numFrames = 1; numFrames <= 5; numFrames++) {
+		std::vector<uint8_t> pcm = makePCM(numFrames, 2, 2, true, numFrames);
+		uint8_t encoded[64];
+		uint32_t numBytes = encodeSampleBlock(pcm.data(), numFrames, 2, 2, encoded, sizeof(encoded));
+		CHECK(numBytes);
+		std::vector<uint8_t> decoded(pcm.size());
+		CHECK(decodeSampleBlock(encoded, numBytes, numFrames, 2, 2, decoded.data(), 0, decoded.size()));
+		CHECK(decoded == pcm);
+	}
+
+	std::vector<uint8_t> pcm = makePCM(1000, 1, 2, true, 1);
+	uint8_t encoded[64];
+	CHECK_EQUAL(0, encodeSampleBlock(pcm.data(), 1000, 1, 2, encoded, sizeof(encoded)));
+}
+
+// A block cut short has to be caught, not read past
+TEST(SampleCodecTests, truncatedBlock) {
+	int32_t numFrames = 2000;
+	std::vector<uint8_t> pcm = makePCM(numFrames, 1, 2, false, 1);
+	std::vector<uint8_t> encoded(pcm.size() * 2);
+	uint32_t numBytes = encodeSampleBlock(pcm.data(), numFrames, 1, 2, encoded.data(), encoded.size());
+	std::vector<uint8_t> decoded(pcm.size());
+	CHECK(!decodeSampleBlock(encoded.data(), numBytes / 2, numFrames, 1, 2, decoded.data(), 0, decoded.size()));
+}
+
+} // namespace